@@ -24,6 +24,7 @@
 #include "gtx/matrix_decompose.hpp"
 
 #include "core.h"
+#include "coreSettings.h"
 #include "scene/scene.h"
 #include "scene/components.h"
 
@@ -264,6 +265,73 @@ namespace LucreApp
 
         // shadow map debug window
         ImGui::Checkbox("show shadow map", &m_ShowDebugShadowMap);
+
+        // render statistics, GPU times are averaged over the last frames
+        if (ImGui::CollapsingHeader("render statistics"))
+        {
+            auto& statistics = Engine::m_Engine->GetRenderer()->GetRenderStatistics();
+            ImGui::Text("draw calls: %u, instances: %u, triangles: %llu", statistics.m_DrawCalls, statistics.m_Instances,
+                        static_cast<unsigned long long>(statistics.m_Triangles));
+            ImGui::Text("render queue: %u binds saved, %u draws merged", statistics.m_BindsSaved,
+                        statistics.m_MergedDraws);
+            // compare the bloom row of the pass timings below
+            ImGui::Checkbox("compute bloom", &CoreSettings::m_ComputeBloom);
+            // objects hidden in the previous frame are culled before the geometry pass
+            ImGui::Checkbox("occlusion culling", &CoreSettings::m_OcclusionCulling);
+            ImGui::Text("culling: %u tested, %u frustum culled, %u occluded, %u rescued", statistics.m_CullingObjects,
+                        statistics.m_FrustumCulled, statistics.m_OcclusionCulled, statistics.m_OcclusionRescued);
+            // coarser meshes by projected error, compare the triangle count above
+            ImGui::Checkbox("mesh lod", &CoreSettings::m_MeshLod);
+            ImGui::SameLine();
+            ImGui::SliderInt("error (pixels)", &CoreSettings::m_LodErrorPixels, 1, 16);
+            // baked billboards for distant instances, crossfaded with the mesh
+            ImGui::Checkbox("impostors", &CoreSettings::m_Impostors);
+            ImGui::SameLine();
+            ImGui::SliderInt("distance (m)", &CoreSettings::m_ImpostorDistance, 25, 1000);
+            ImGui::Text("impostors: %u instances without a mesh, %u baked models", statistics.m_ImpostorInstances,
+                        statistics.m_ImpostorModels);
+            // animated models are skinned once per frame, the shadow and geometry passes draw the result
+            ImGui::Text("skinning: %u models, %u vertices, %u unchanged", statistics.m_SkinnedModels,
+                        statistics.m_SkinnedVertices, statistics.m_SkinningSkipped);
+            // the 3D pass renders at a fraction of the output resolution when the GPU misses the target
+            ImGui::Checkbox("dynamic resolution", &CoreSettings::m_DynamicResolution);
+            ImGui::SameLine();
+            ImGui::SliderInt("target (ms)", &CoreSettings::m_TargetFrameTimeMs, 4, 50);
+            ImGui::SliderInt("min render scale (%)", &CoreSettings::m_MinRenderScale, 25, 100);
+            ImGui::Text("render scale: %.0f%%, gpu frame %.3f ms", statistics.m_RenderScale * 100.0f,
+                        statistics.m_GpuFrameTimeMs);
+            float gpuFrameTime = 0.0f;
+            for (uint pass = 0; pass < RenderStatistics::NUMBER_OF_PASSES; ++pass)
+            {
+                ImGui::Text("%-16s gpu %7.3f ms   cpu %7.3f ms", RenderStatistics::PASS_NAMES[pass],
+                            statistics.m_GpuTimeAverageMs[pass], statistics.m_CpuTimeMs[pass]);
+                gpuFrameTime += statistics.m_GpuTimeAverageMs[pass];
+            }
+            if (statistics.m_GpuTimingsValid)
+            {
+                ImGui::Text("%-16s gpu %7.3f ms", "total", gpuFrameTime);
+            }
+            else
+            {
+                ImGui::Text("GPU timestamps not available");
+            }
+
+            auto textureCache = Engine::m_Engine->m_TextureCache.GetStatistics();
+            ImGui::Text("texture cache: %zu textures, %.1f MB", textureCache.m_Entries,
+                        static_cast<float>(textureCache.m_MemoryBytes) / (1024.0f * 1024.0f));
+            ImGui::Text("hits: %llu, misses: %llu, evictions: %llu", static_cast<unsigned long long>(textureCache.m_Hits),
+                        static_cast<unsigned long long>(textureCache.m_Misses),
+                        static_cast<unsigned long long>(textureCache.m_Evictions));
+            auto assetRegistry = Engine::m_Engine->m_AssetRegistry.GetStatistics();
+            ImGui::Text("asset registry: %zu meshes (%zu in use), %.1f MB", assetRegistry.m_Entries,
+                        assetRegistry.m_EntriesInUse, static_cast<float>(assetRegistry.m_MemoryBytes) / (1024.0f * 1024.0f));
+            ImGui::Text("texture streaming: %u textures, %.1f / %.1f MB, %u uploads, %.1f MB this frame",
+                        statistics.m_StreamedTextures,
+                        static_cast<float>(statistics.m_StreamingResidentBytes) / (1024.0f * 1024.0f),
+                        static_cast<float>(statistics.m_StreamingBudgetBytes) / (1024.0f * 1024.0f),
+                        statistics.m_StreamingJobs,
+                        static_cast<float>(statistics.m_StreamingUploadBytes) / (1024.0f * 1024.0f));
+        }
     }
 
     ImGuizmo::OPERATION ImGUI::GetGuizmoMode()
@@ -31,22 +31,26 @@ namespace LucreApp
 
     std::string AppSettings::m_LastGamePath;
     std::string AppSettings::m_SearchDirGames;
+    int AppSettings::m_SceneResidencyBudgetMB;
 
     void AppSettings::InitDefaults()
     {
         m_LastGamePath = Engine::m_Engine->GetHomeDirectory();
         m_SearchDirGames = Engine::m_Engine->GetHomeDirectory();
+        m_SceneResidencyBudgetMB = 3072;
     }
 
     void AppSettings::RegisterSettings()
     {
         m_SettingsManager->PushSetting<std::string>("LastGamePath", &m_LastGamePath);
         m_SettingsManager->PushSetting<std::string>("SearchDirGames", &m_SearchDirGames);
+        m_SettingsManager->PushSetting<int>("SceneResidencyBudgetMB", &m_SceneResidencyBudgetMB);
     }
 
     void AppSettings::PrintSettings() const
     {
         LOG_APP_INFO("AppSettings: key '{0}', value is {1}", "LastGamePath", m_LastGamePath);
         LOG_APP_INFO("AppSettings: key '{0}', value is {1}", "SearchDirGames", m_SearchDirGames);
+        LOG_APP_INFO("AppSettings: key '{0}', value is {1}", "SceneResidencyBudgetMB", m_SceneResidencyBudgetMB);
     }
 } // namespace LucreApp
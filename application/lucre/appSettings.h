@@ -41,6 +41,7 @@ namespace LucreApp
 
         static std::string m_LastGamePath;
         static std::string m_SearchDirGames;
+        static int m_SceneResidencyBudgetMB; // loaded and preloaded scenes, 0: unlimited
 
     private:
         SettingsManager* m_SettingsManager;
@@ -21,10 +21,13 @@
    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
 #include <thread>
+#include <algorithm>
+#include <filesystem>
 
 #include "gameState.h"
 
 #include "core.h"
+#include "appSettings.h"
 #include "scenes/beachScene.h"
 #include "scenes/cutScene.h"
 #include "scenes/dessertScene.h"
@@ -42,23 +45,81 @@ namespace LucreApp
 
     GameState::GameState()
         : m_State{State::SPLASH}, m_NextState{State::SPLASH}, m_LastState{State::SPLASH}, m_UserInputEnabled{false},
-          m_DeleteScene{State::NULL_STATE}, m_LoadingState{State::NULL_STATE}
+          m_DeleteScene{State::NULL_STATE}, m_LoadingState{State::NULL_STATE}, m_BenchmarkState{State::NULL_STATE}
     {
         memset(m_StateLoaded, false, static_cast<int>(State::MAX_STATES) * sizeof(bool));
     }
 
     void GameState::Start()
     {
+        // likely scene changes, their successors are preloaded in the background
+        struct Transition
+        {
+            State m_From;
+            State m_To;
+            float m_Likelihood;
+        };
+        std::initializer_list<Transition> transitions = {
+            {State::MAIN, State::ISLAND_2, 0.4f},     {State::MAIN, State::VOLCANO, 0.3f},
+            {State::MAIN, State::BEACH, 0.2f},        {State::MAIN, State::TERRAIN, 0.1f},
+            {State::ISLAND_2, State::VOLCANO, 0.5f},  {State::ISLAND_2, State::MAIN, 0.3f},
+            {State::ISLAND_2, State::BEACH, 0.2f},    {State::VOLCANO, State::ISLAND_2, 0.5f},
+            {State::VOLCANO, State::MAIN, 0.3f},      {State::VOLCANO, State::BEACH, 0.2f},
+            {State::BEACH, State::ISLAND_2, 0.4f},    {State::BEACH, State::VOLCANO, 0.3f},
+            {State::BEACH, State::MAIN, 0.3f},        {State::TERRAIN, State::MAIN, 0.6f},
+            {State::TERRAIN, State::ISLAND_2, 0.4f},  {State::NIGHT, State::MAIN, 1.0f},
+            {State::DESSERT, State::MAIN, 1.0f}};
+        for (auto& transition : transitions)
+        {
+            m_Residency.AddTransition(static_cast<uint>(transition.m_From), static_cast<uint>(transition.m_To),
+                                      transition.m_Likelihood);
+        }
+        m_Residency.SetBudget(static_cast<size_t>(std::max(AppSettings::m_SceneResidencyBudgetMB, 0)) * 1024 * 1024);
+
         // the splash, cutscene, and settings scene are loaded upfront
         Load(State::SPLASH);
         Load(State::CUTSCENE);
         Load(State::SETTINGS);
 
         SetState(State::SPLASH);
-        SetNextState(State::TERRAIN);
+
+        auto& benchmark = Engine::m_Engine->m_Benchmark;
+        if (benchmark.IsEnabled())
+        {
+            m_BenchmarkState = SceneDescriptionToState(benchmark.GetSettings().m_SceneDescription);
+            if (m_BenchmarkState == State::NULL_STATE)
+            {
+                LOG_APP_CRITICAL("GameState::Start: no game level for benchmark scene {0}",
+                                 benchmark.GetSettings().m_SceneDescription);
+                m_BenchmarkState = State::TERRAIN;
+            }
+            SetNextState(m_BenchmarkState);
+        }
+        else
+        {
+            SetNextState(State::TERRAIN);
+        }
     }
 
-    void GameState::Stop() { GetScene()->Stop(); }
+    void GameState::Stop()
+    {
+        CancelLoading();
+        GetScene()->Stop();
+    }
+
+    void GameState::CancelLoading()
+    {
+        State loadingState = m_LoadingState;
+        if (loadingState == State::NULL_STATE)
+        {
+            return;
+        }
+        if (Scene* scene = GetScene(loadingState))
+        {
+            LOG_APP_INFO("cancelling the loading of scene {0}", StateToString(loadingState));
+            scene->GetLoadingProgress().Cancel();
+        }
+    }
 
     std::string GameState::StateToString(State state) const
     {
@@ -132,13 +193,56 @@ namespace LucreApp
         return str;
     }
 
+    GameState::State GameState::SceneDescriptionToState(const std::string& sceneDescription) const
+    {
+        // accepts "island2.json" as well as "application/lucre/sceneDescriptions/island2.json"
+        std::string filename = std::filesystem::path(sceneDescription).filename().string();
+        State state = State::NULL_STATE;
+        if (filename == "main.json")
+        {
+            state = State::MAIN;
+        }
+        else if (filename == "beach.json")
+        {
+            state = State::BEACH;
+        }
+        else if (filename == "night.json")
+        {
+            state = State::NIGHT;
+        }
+        else if (filename == "dessert.json")
+        {
+            state = State::DESSERT;
+        }
+        else if (filename == "terrain.json")
+        {
+            state = State::TERRAIN;
+        }
+        else if (filename == "island2.json")
+        {
+            state = State::ISLAND_2;
+        }
+        else if (filename == "volcano.json")
+        {
+            state = State::VOLCANO;
+        }
+        else if (filename == "reserved0.json")
+        {
+            state = State::RESERVED0;
+        }
+        return state;
+    }
+
     Scene* GameState::OnUpdate()
     {
+        UpdateResidency();
         switch (m_State)
         {
             case State::SPLASH:
             {
-                if (GetScene()->IsFinished() && IsLoaded(GetNextState()))
+                // benchmark runs skip the splash animation
+                bool splashFinished = GetScene()->IsFinished() || (m_BenchmarkState != State::NULL_STATE);
+                if (splashFinished && IsLoaded(GetNextState()))
                 {
                     SetState(GetNextState());
                 }
@@ -153,7 +257,6 @@ namespace LucreApp
                         SetState(GetNextState());
                     }
                 }
-                DeleteScene();
                 LoadNextState();
                 break;
             }
@@ -188,12 +291,33 @@ namespace LucreApp
         m_State = state;
         GetScene()->SetRunning();
         GetScene()->OnResize();
-        PrepareDeleteScene();
     }
 
     void GameState::SetNextState(State state)
     {
         m_NextState = state;
+        if (state == m_DeleteScene)
+        {
+            LOG_APP_INFO("keeping scene {0}, it was requested before its eviction", StateToString(state));
+            m_DeleteScene = State::NULL_STATE;
+        }
+        if (m_PreloadState != State::NULL_STATE)
+        {
+            if (state == m_PreloadState)
+            {
+                // the player wants the scene that is being preloaded: merge it at full speed
+                std::lock_guard lock(m_Mutex);
+                m_PreloadState = State::NULL_STATE;
+                if (auto& scene = m_Scenes[static_cast<int>(state)])
+                {
+                    scene->GetLoadingProgress().SetLowPriority(false);
+                }
+            }
+            else
+            {
+                CancelPreload();
+            }
+        }
         if (!IsLoaded(state) && m_DeleteScene == State::NULL_STATE)
         {
             Load(state);
@@ -215,19 +339,100 @@ namespace LucreApp
         }
     }
 
-    void GameState::PrepareDeleteScene()
+    std::vector<uint> GameState::GetPinnedScenes() const
+    {
+        std::vector<uint> pinned = {static_cast<uint>(State::SPLASH), static_cast<uint>(State::SETTINGS),
+                                    static_cast<uint>(State::CUTSCENE), static_cast<uint>(m_State),
+                                    static_cast<uint>(m_NextState)};
+        if (m_State == State::SETTINGS)
+        {
+            // the settings return to the last scene
+            pinned.push_back(static_cast<uint>(m_LastState));
+        }
+        return pinned;
+    }
+
+    void GameState::UpdateResidency()
     {
-        // last scene must be a game level
-        if (static_cast<int>(m_LastState) > static_cast<int>(State::CUTSCENE))
+        uint victim = SceneResidency::NO_SCENE;
+        uint preload = SceneResidency::NO_SCENE;
+        size_t victimBytes = 0;
+        size_t residentBytes = 0;
         {
-            // current scene must be cut scene
-            if (static_cast<int>(m_State) == static_cast<int>(State::CUTSCENE))
+            std::lock_guard lock(m_Mutex);
+            if (m_CancelledState != State::NULL_STATE)
             {
-                LOG_APP_INFO("deleting scene {0}", StateToString(m_LastState));
-                m_DeleteScene = m_LastState;
-                m_DeleteSceneCounter = 5;
+                // a cancelled scene was never drawn and can be released right away
+                if (m_CancelledState != m_LoadingState)
+                {
+                    m_Scenes[static_cast<int>(m_CancelledState)] = nullptr;
+                }
+                m_CancelledState = State::NULL_STATE;
+            }
+            m_Residency.Touch(static_cast<uint>(m_State));
+            if ((m_DeleteScene == State::NULL_STATE) && (m_LoadingState == State::NULL_STATE))
+            {
+                std::vector<uint> pinned = GetPinnedScenes();
+                victim = m_Residency.SelectEviction(static_cast<uint>(m_State), pinned);
+                victimBytes = m_Residency.GetCost(victim).Total();
+                residentBytes = m_Residency.GetResidentBytes();
+
+                // preload while a game level is running, benchmarks measure without background loads
+                bool gameLevel = static_cast<int>(m_State) > static_cast<int>(State::CUTSCENE);
+                bool preloadAllowed = gameLevel && (m_BenchmarkState == State::NULL_STATE);
+                if ((victim == SceneResidency::NO_SCENE) && preloadAllowed)
+                {
+                    preload = m_Residency.SelectPreload(static_cast<uint>(m_State), pinned);
+                }
             }
         }
+
+        if (victim != SceneResidency::NO_SCENE)
+        {
+            m_DeleteScene = static_cast<State>(victim);
+            m_DeleteSceneCounter = 5;
+            LOG_APP_INFO("evicting scene {0} ({1} MB), {2} MB of {3} MB in use", StateToString(m_DeleteScene),
+                         victimBytes / (1024 * 1024), residentBytes / (1024 * 1024),
+                         m_Residency.GetBudget() / (1024 * 1024));
+        }
+        else if (preload != SceneResidency::NO_SCENE)
+        {
+            {
+                std::lock_guard lock(m_Mutex);
+                m_PreloadState = static_cast<State>(preload);
+            }
+            LOG_APP_INFO("preloading scene {0}", StateToString(static_cast<State>(preload)));
+            Load(static_cast<State>(preload));
+        }
+        DeleteScene();
+    }
+
+    void GameState::CancelPreload()
+    {
+        std::lock_guard lock(m_Mutex);
+        if ((m_PreloadState == State::NULL_STATE) || (m_LoadingState != m_PreloadState))
+        {
+            return;
+        }
+        LOG_APP_INFO("cancelling the preload of scene {0}", StateToString(m_PreloadState));
+        // the loader may not have created the scene yet, see SetupScene()
+        m_PreloadCancelled = true;
+        if (auto& scene = m_Scenes[static_cast<int>(m_PreloadState)])
+        {
+            scene->GetLoadingProgress().Cancel();
+        }
+    }
+
+    void GameState::LoadCancelled(State state)
+    {
+        std::lock_guard lock(m_Mutex);
+        m_StateLoaded[static_cast<int>(state)] = false;
+        m_CancelledState = state;
+        if (state == m_PreloadState)
+        {
+            m_PreloadState = State::NULL_STATE;
+        }
+        m_LoadingState = State::NULL_STATE;
     }
 
     void GameState::DeleteScene()
@@ -243,6 +448,8 @@ namespace LucreApp
             else
             {
                 DestroyScene(m_DeleteScene);
+                // geometry of the deleted scene stays warm for the next scene
+                Engine::m_Engine->m_AssetRegistry.LogResidency();
             }
         }
     }
@@ -255,6 +462,12 @@ namespace LucreApp
             return;
         }
         m_LoadingState = state;
+        m_PreloadCancelled = false;
+        m_LoadStartMemory = SceneResidency::GetResidentMemory();
+        if (state == m_BenchmarkState)
+        {
+            Engine::m_Engine->m_Benchmark.BeginSceneLoad();
+        }
         switch (state)
         {
             case State::SPLASH:
@@ -274,6 +487,11 @@ namespace LucreApp
                         std::make_shared<MainScene>("main.json", "application/lucre/sceneDescriptions/main.json");
                     SetupScene(state, scenePtr);
                     GetScene(state)->Load();
+                    if (GetScene(state)->GetLoadingProgress().IsCancelled())
+                    {
+                        LoadCancelled(state);
+                        return;
+                    }
                     GetScene(state)->Start();
                     SetLoaded(state);
                 };
@@ -289,6 +507,11 @@ namespace LucreApp
                         std::make_shared<BeachScene>("beach.json", "application/lucre/sceneDescriptions/beach.json");
                     SetupScene(state, scenePtr);
                     GetScene(state)->Load();
+                    if (GetScene(state)->GetLoadingProgress().IsCancelled())
+                    {
+                        LoadCancelled(state);
+                        return;
+                    }
                     GetScene(state)->Start();
                     SetLoaded(state);
                 };
@@ -304,6 +527,11 @@ namespace LucreApp
                         std::make_shared<NightScene>("night.json", "application/lucre/sceneDescriptions/night.json");
                     SetupScene(state, scenePtr);
                     GetScene(state)->Load();
+                    if (GetScene(state)->GetLoadingProgress().IsCancelled())
+                    {
+                        LoadCancelled(state);
+                        return;
+                    }
                     GetScene(state)->Start();
                     SetLoaded(state);
                 };
@@ -319,6 +547,11 @@ namespace LucreApp
                         std::make_shared<DessertScene>("dessert.json", "application/lucre/sceneDescriptions/dessert.json");
                     SetupScene(state, scenePtr);
                     GetScene(state)->Load();
+                    if (GetScene(state)->GetLoadingProgress().IsCancelled())
+                    {
+                        LoadCancelled(state);
+                        return;
+                    }
                     GetScene(state)->Start();
                     SetLoaded(state);
                 };
@@ -335,6 +568,11 @@ namespace LucreApp
                         std::make_shared<TerrainScene>("terrain.json", "application/lucre/sceneDescriptions/terrain.json");
                     SetupScene(state, scenePtr);
                     GetScene(state)->Load();
+                    if (GetScene(state)->GetLoadingProgress().IsCancelled())
+                    {
+                        LoadCancelled(state);
+                        return;
+                    }
                     GetScene(state)->Start();
                     SetLoaded(state);
                 };
@@ -351,6 +589,11 @@ namespace LucreApp
                         std::make_shared<Island2Scene>("island2.json", "application/lucre/sceneDescriptions/island2.json");
                     SetupScene(state, scenePtr);
                     GetScene(state)->Load();
+                    if (GetScene(state)->GetLoadingProgress().IsCancelled())
+                    {
+                        LoadCancelled(state);
+                        return;
+                    }
                     GetScene(state)->Start();
                     SetLoaded(state);
                 };
@@ -367,6 +610,11 @@ namespace LucreApp
                         std::make_shared<VolcanoScene>("volcano.json", "application/lucre/sceneDescriptions/volcano.json");
                     SetupScene(state, scenePtr);
                     GetScene(state)->Load();
+                    if (GetScene(state)->GetLoadingProgress().IsCancelled())
+                    {
+                        LoadCancelled(state);
+                        return;
+                    }
                     GetScene(state)->Start();
                     SetLoaded(state);
                 };
@@ -383,6 +631,11 @@ namespace LucreApp
                                                                      "application/lucre/sceneDescriptions/reserved0.json");
                     SetupScene(state, scenePtr);
                     GetScene(state)->Load();
+                    if (GetScene(state)->GetLoadingProgress().IsCancelled())
+                    {
+                        LoadCancelled(state);
+                        return;
+                    }
                     GetScene(state)->Start();
                     SetLoaded(state);
                 };
@@ -435,15 +688,47 @@ namespace LucreApp
 
     void GameState::SetLoaded(State state, bool isLoaded)
     {
+        if (isLoaded && (state == m_BenchmarkState))
+        {
+            Engine::m_Engine->m_Benchmark.EndSceneLoad();
+        }
+        SceneResidency::Cost cost;
+        if (isLoaded)
+        {
+            // the resident set also grows with other allocations during the load, so this is an estimate
+            size_t residentMemory = SceneResidency::GetResidentMemory();
+            cost.m_CpuBytes = (residentMemory > m_LoadStartMemory) ? residentMemory - m_LoadStartMemory : 0;
+            cost.m_GpuBytes = SceneResidency::GetGpuMemory(*GetScene(state));
+            LOG_APP_INFO("scene {0} loaded, cost: {1} MB CPU, {2} MB GPU", StateToString(state),
+                         cost.m_CpuBytes / (1024 * 1024), cost.m_GpuBytes / (1024 * 1024));
+        }
         std::lock_guard lock(m_Mutex);
         m_StateLoaded[static_cast<int>(state)] = isLoaded;
         m_LoadingState = State::NULL_STATE;
+        if (state == m_PreloadState)
+        {
+            m_PreloadState = State::NULL_STATE;
+        }
+        if (isLoaded)
+        {
+            m_Residency.SetCost(static_cast<uint>(state), cost);
+        }
+        m_Residency.SetResident(static_cast<uint>(state), isLoaded);
     }
 
     void GameState::SetupScene(const State state, const std::shared_ptr<Scene>& scene)
     {
         std::lock_guard lock(m_Mutex);
         m_Scenes[static_cast<int>(state)] = scene;
+        if (state == m_PreloadState)
+        {
+            // preloads must not take frame time from the running scene
+            scene->GetLoadingProgress().SetLowPriority(true);
+            if (m_PreloadCancelled)
+            {
+                scene->GetLoadingProgress().Cancel();
+            }
+        }
     }
 
     void GameState::DestroyScene(const State state)
@@ -452,5 +737,6 @@ namespace LucreApp
         m_StateLoaded[static_cast<int>(state)] = false;
         m_Scenes[static_cast<int>(state)] = nullptr;
         m_DeleteScene = State::NULL_STATE;
+        m_Residency.SetResident(static_cast<uint>(state), false);
     }
 } // namespace LucreApp
@@ -27,6 +27,7 @@
 #include "engine.h"
 #include "events/event.h"
 #include "scene/scene.h"
+#include "sceneResidency.h"
 
 namespace LucreApp
 {
@@ -59,20 +60,22 @@ namespace LucreApp
 
         void Start();
         void Stop();
+        void CancelLoading();
         Scene* OnUpdate();
 
         void EnableUserInput(bool enable);
 
         void DeleteScene();
-        void PrepareDeleteScene();
         void SetState(State state);
         bool IsLoaded(State state);
         void SetLoaded(State state, bool isLoaded = true);
         std::string StateToString(State state) const;
+        State SceneDescriptionToState(const std::string& sceneDescription) const;
         void SetNextState(State state);
         void LoadNextState();
         State GetState() const { return m_State; }
         State GetNextState() const { return m_NextState; }
+        State GetBenchmarkState() const { return m_BenchmarkState; }
         bool UserInputIsInabled() const { return m_UserInputEnabled; }
 
         Scene* GetScene();
@@ -83,10 +86,19 @@ namespace LucreApp
 
     private:
         void Load(State state);
+        void LoadCancelled(State state);
+        void CancelPreload();
+        void UpdateResidency();
+        std::vector<uint> GetPinnedScenes() const;
 
     private:
         std::mutex m_Mutex;
-        State m_State, m_NextState, m_LastState, m_DeleteScene, m_LoadingState;
+        State m_State, m_NextState, m_LastState, m_DeleteScene, m_LoadingState, m_BenchmarkState;
+        State m_PreloadState{State::NULL_STATE};   // scene loading in the background at low priority
+        State m_CancelledState{State::NULL_STATE}; // released on the main thread
+        bool m_PreloadCancelled{false};
+        SceneResidency m_Residency;
+        size_t m_LoadStartMemory{0};
         std::shared_ptr<Scene> m_Scenes[static_cast<int>(State::MAX_STATES)];
         bool m_UserInputEnabled;
         bool m_StateLoaded[static_cast<int>(State::MAX_STATES)];
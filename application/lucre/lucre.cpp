@@ -82,6 +82,10 @@ namespace LucreApp
     void Lucre::OnUpdate(const Timestep& timestep)
     {
         m_CurrentScene = m_GameState.OnUpdate();
+        if (Engine::m_Engine->m_Benchmark.IsEnabled())
+        {
+            RunBenchmark();
+        }
         m_CurrentScene->OnUpdate(timestep);
 
         // update/render layer stack
@@ -101,6 +105,38 @@ namespace LucreApp
         m_Renderer->EndScene();
     }
 
+    void Lucre::RunBenchmark()
+    {
+        auto& benchmark = Engine::m_Engine->m_Benchmark;
+        if (m_GameState.GetState() != m_GameState.GetBenchmarkState())
+        {
+            return;
+        }
+        benchmark.SceneIsRunning();
+        if (!benchmark.IsRunning())
+        {
+            return;
+        }
+
+        // drive the default camera along the scripted path
+        auto& registry = m_CurrentScene->GetRegistry();
+        entt::entity camera = m_CurrentScene->GetDictionary().Retrieve("defaultCamera"_name);
+        if ((camera == entt::null) || !registry.all_of<TransformComponent>(camera))
+        {
+            return;
+        }
+        auto& cameraTransform = registry.get<TransformComponent>(camera);
+        if (!m_BenchmarkCameraOriginSet)
+        {
+            m_BenchmarkCameraOrigin.m_Translation = cameraTransform.GetTranslation();
+            m_BenchmarkCameraOrigin.m_Rotation = cameraTransform.GetRotation();
+            m_BenchmarkCameraOriginSet = true;
+        }
+        Benchmark::CameraKeyframe keyframe = benchmark.GetCameraKeyframe(m_BenchmarkCameraOrigin);
+        cameraTransform.SetTranslation(keyframe.m_Translation);
+        cameraTransform.SetRotation(keyframe.m_Rotation);
+    }
+
     void Lucre::OnResize()
     {
         ASSERT(m_CurrentScene);
@@ -235,7 +271,14 @@ namespace LucreApp
                 if (m_GameState.GetState() != GameState::State::CUTSCENE)
                 {
                     // show cut scene only for game levels
-                    if (static_cast<int>(l_Event.GetScene()) > static_cast<int>(GameState::State::CUTSCENE))
+                    bool gameLevel = static_cast<int>(l_Event.GetScene()) > static_cast<int>(GameState::State::CUTSCENE);
+                    if (gameLevel && m_GameState.IsLoaded(l_Event.GetScene()))
+                    {
+                        // preloaded: switch without the cut scene
+                        m_GameState.SetNextState(l_Event.GetScene());
+                        m_GameState.SetState(l_Event.GetScene());
+                    }
+                    else if (gameLevel)
                     {
                         m_GameState.GetScene(GameState::State::CUTSCENE)->ResetTimer();
                         m_GameState.SetState(GameState::State::CUTSCENE);
@@ -72,6 +72,7 @@ namespace LucreApp
         void ShowCursor();
         void HideCursor();
         void Cancel();
+        void RunBenchmark();
 
     private:
         std::unique_ptr<UIControllerIcon> m_UIControllerIcon;
@@ -90,5 +91,9 @@ namespace LucreApp
         SpriteSheet m_Atlas;
         bool m_InGameGuiIsRunning;
         bool m_DebugWindowIsRunning;
+
+        // scripted camera of benchmark runs
+        bool m_BenchmarkCameraOriginSet{false};
+        Benchmark::CameraKeyframe m_BenchmarkCameraOrigin;
     };
 } // namespace LucreApp
@@ -0,0 +1,231 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <algorithm>
+#include <fstream>
+#include <unordered_set>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#elif defined(MACOSX)
+#include <mach/mach.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "renderer/model.h"
+#include "scene/components.h"
+#include "sceneResidency.h"
+
+namespace LucreApp
+{
+
+    void SceneResidency::AddTransition(uint from, uint to, float likelihood)
+    {
+        CORE_ASSERT((from < MAX_SCENES) && (to < MAX_SCENES), "SceneResidency::AddTransition: scene out of range");
+        auto& transitions = m_Scenes[from].m_Transitions;
+        transitions.push_back({to, likelihood});
+        std::stable_sort(transitions.begin(), transitions.end(),
+                         [](Transition const& a, Transition const& b) { return a.m_Likelihood > b.m_Likelihood; });
+    }
+
+    void SceneResidency::SetResident(uint scene, bool resident)
+    {
+        auto& info = m_Scenes[scene];
+        info.m_Resident = resident;
+        // a freshly loaded scene counts as recently used, so it is not the first one to go
+        info.m_LastUse = ++m_Clock;
+    }
+
+    void SceneResidency::SetCost(uint scene, Cost const& cost)
+    {
+        m_Scenes[scene].m_Cost = cost;
+        m_Scenes[scene].m_CostMeasured = true;
+    }
+
+    void SceneResidency::Touch(uint scene) { m_Scenes[scene].m_LastUse = ++m_Clock; }
+
+    size_t SceneResidency::GetResidentBytes() const
+    {
+        size_t bytes = 0;
+        for (auto& info : m_Scenes)
+        {
+            if (info.m_Resident)
+            {
+                bytes += info.m_Cost.Total();
+            }
+        }
+        return bytes;
+    }
+
+    float SceneResidency::GetLikelihood(uint from, uint to) const
+    {
+        for (auto& transition : m_Scenes[from].m_Transitions)
+        {
+            if (transition.m_To == to)
+            {
+                return transition.m_Likelihood;
+            }
+        }
+        return 0.0f;
+    }
+
+    size_t SceneResidency::EstimateCost(uint scene) const
+    {
+        if (m_Scenes[scene].m_CostMeasured)
+        {
+            return m_Scenes[scene].m_Cost.Total();
+        }
+        size_t sum = 0;
+        size_t count = 0;
+        for (auto& info : m_Scenes)
+        {
+            if (info.m_CostMeasured)
+            {
+                sum += info.m_Cost.Total();
+                ++count;
+            }
+        }
+        return count ? sum / count : 0;
+    }
+
+    uint SceneResidency::SelectPreload(uint current, std::vector<uint> const& keep) const
+    {
+        size_t residentBytes = GetResidentBytes();
+        for (auto& transition : m_Scenes[current].m_Transitions)
+        {
+            if (m_Scenes[transition.m_To].m_Resident)
+            {
+                continue;
+            }
+            if (!m_Budget)
+            {
+                return transition.m_To;
+            }
+
+            // memory of less likely scenes can be reclaimed for this one
+            size_t available = (residentBytes < m_Budget) ? m_Budget - residentBytes : 0;
+            for (uint scene = 0; scene < MAX_SCENES; ++scene)
+            {
+                bool keepScene = std::find(keep.begin(), keep.end(), scene) != keep.end();
+                if (m_Scenes[scene].m_Resident && (scene != current) && !keepScene &&
+                    (GetLikelihood(current, scene) < transition.m_Likelihood))
+                {
+                    available += m_Scenes[scene].m_Cost.Total();
+                }
+            }
+            if (EstimateCost(transition.m_To) <= available)
+            {
+                return transition.m_To;
+            }
+        }
+        return NO_SCENE;
+    }
+
+    uint SceneResidency::SelectEviction(uint current, std::vector<uint> const& keep) const
+    {
+        if (!m_Budget || (GetResidentBytes() <= m_Budget))
+        {
+            return NO_SCENE;
+        }
+
+        uint victim = NO_SCENE;
+        for (uint scene = 0; scene < MAX_SCENES; ++scene)
+        {
+            auto& info = m_Scenes[scene];
+            bool keepScene = std::find(keep.begin(), keep.end(), scene) != keep.end();
+            if (!info.m_Resident || (scene == current) || keepScene)
+            {
+                continue;
+            }
+            if (victim == NO_SCENE)
+            {
+                victim = scene;
+                continue;
+            }
+            auto& victimInfo = m_Scenes[victim];
+            float likelihood = GetLikelihood(current, scene);
+            float victimLikelihood = GetLikelihood(current, victim);
+            if (likelihood != victimLikelihood)
+            {
+                victim = (likelihood < victimLikelihood) ? scene : victim;
+            }
+            else if (info.m_LastUse != victimInfo.m_LastUse)
+            {
+                victim = (info.m_LastUse < victimInfo.m_LastUse) ? scene : victim;
+            }
+            else if (info.m_Cost.Total() > victimInfo.m_Cost.Total())
+            {
+                victim = scene;
+            }
+        }
+        return victim;
+    }
+
+    size_t SceneResidency::GetResidentMemory()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return counters.WorkingSetSize;
+        }
+        return 0;
+#elif defined(MACOSX)
+        mach_task_basic_info_data_t info;
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+        if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) !=
+            KERN_SUCCESS)
+        {
+            return 0;
+        }
+        return static_cast<size_t>(info.resident_size);
+#else
+        // second field: resident pages
+        std::ifstream statm("/proc/self/statm");
+        size_t totalPages = 0;
+        size_t residentPages = 0;
+        if (!(statm >> totalPages >> residentPages))
+        {
+            return 0;
+        }
+        return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    size_t SceneResidency::GetGpuMemory(Scene& scene)
+    {
+        std::unordered_set<void const*> counted;
+        size_t bytes = 0;
+        auto view = scene.GetRegistry().view<MeshComponent>();
+        for (auto entity : view)
+        {
+            auto& mesh = view.get<MeshComponent>(entity);
+            if (mesh.m_Model)
+            {
+                bytes += mesh.m_Model->GetMemorySize(counted);
+            }
+        }
+        return bytes;
+    }
+} // namespace LucreApp
@@ -0,0 +1,101 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "engine.h"
+#include "scene/scene.h"
+
+namespace LucreApp
+{
+
+    // Keeps track of which scenes are loaded and what they cost.
+    // Scenes the player is likely to enter next, according to a declared
+    // transition graph, are preloaded while memory is left in the budget.
+    // When the loaded scenes exceed the budget, the scene least likely to be
+    // needed soon is evicted: unlikely successors first, then the least recently
+    // used, then the most expensive.
+    // Scenes are identified by the integer value of GameState::State.
+    class SceneResidency
+    {
+    public:
+        static constexpr uint MAX_SCENES = 16;
+        static constexpr uint NO_SCENE = 0;
+
+        struct Cost
+        {
+            size_t m_CpuBytes{0}; // growth of the resident set while the scene was loading
+            size_t m_GpuBytes{0}; // buffers and textures of the scene's models
+            size_t Total() const { return m_CpuBytes + m_GpuBytes; }
+        };
+
+    public:
+        void AddTransition(uint from, uint to, float likelihood);
+        void SetBudget(size_t bytes) { m_Budget = bytes; } // 0: unlimited
+        size_t GetBudget() const { return m_Budget; }
+
+        void SetResident(uint scene, bool resident);
+        bool IsResident(uint scene) const { return m_Scenes[scene].m_Resident; }
+        void SetCost(uint scene, Cost const& cost);
+        Cost const& GetCost(uint scene) const { return m_Scenes[scene].m_Cost; }
+        void Touch(uint scene); // the scene is in use this frame
+        size_t GetResidentBytes() const;
+
+        // most likely successor of 'current' that is not loaded and fits into the budget,
+        // counting memory of less likely scenes that could be evicted for it; NO_SCENE if none
+        // scenes in 'keep' are neither evicted nor counted as reclaimable
+        uint SelectPreload(uint current, std::vector<uint> const& keep) const;
+        // a loaded scene to evict while over budget; NO_SCENE if none
+        uint SelectEviction(uint current, std::vector<uint> const& keep) const;
+
+        static size_t GetResidentMemory(); // resident set of the process in bytes
+        static size_t GetGpuMemory(Scene& scene);
+
+    private:
+        struct Transition
+        {
+            uint m_To;
+            float m_Likelihood;
+        };
+
+        struct SceneInfo
+        {
+            bool m_Resident{false};
+            bool m_CostMeasured{false};
+            Cost m_Cost;
+            uint64 m_LastUse{0};
+            std::vector<Transition> m_Transitions; // sorted by likelihood, highest first
+        };
+
+    private:
+        float GetLikelihood(uint from, uint to) const;
+        size_t EstimateCost(uint scene) const; // measured cost or the average of all measured scenes
+
+    private:
+        std::array<SceneInfo, MAX_SCENES> m_Scenes;
+        size_t m_Budget{0};
+        uint64 m_Clock{0};
+    };
+} // namespace LucreApp
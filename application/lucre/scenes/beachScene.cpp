@@ -79,7 +79,7 @@ namespace LucreApp
         m_SceneGraph.TraverseLog(SceneGraph::ROOT_NODE);
         m_Dictionary.List();
         m_NonPlayableCharacter =
-            m_Dictionary.Retrieve("SL::application/lucre/models/external_3D_files/monkey01/monkey01.glb::0::root");
+            m_Dictionary.Retrieve("SL::application/lucre/models/external_3D_files/monkey01/monkey01.glb::0::root"_name);
 
         {
             // place static lights for beach scene
@@ -117,6 +117,7 @@ namespace LucreApp
         ImGUI::SetupSlider(this);
 
         LoadModels();
+        m_SceneLoaderJSON.RestoreSnapshot();
         LoadScripts();
     }
 
@@ -137,7 +138,7 @@ namespace LucreApp
         {
             {
                 m_Lightbulb0 = m_Dictionary.Retrieve(
-                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb.gltf::0::root");
+                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb.gltf::0::root"_name);
                 if (m_Lightbulb0 == entt::null)
                 {
                     m_Lightbulb0 = m_Registry.Create();
@@ -162,7 +163,7 @@ namespace LucreApp
 
             {
                 m_Lightbulb1 = m_Dictionary.Retrieve(
-                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb2.gltf::0::root");
+                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb2.gltf::0::root"_name);
                 if (m_Lightbulb1 == entt::null)
                 {
                     m_Lightbulb1 = m_Registry.Create();
@@ -189,8 +190,8 @@ namespace LucreApp
 
     void BeachScene::LoadScripts()
     {
-        auto duck =
-            m_Dictionary.Retrieve("SL::application/lucre/models/external_3D_files/duck/duck.gltf::0::SceneWithDuck::duck");
+        auto duck = m_Dictionary.Retrieve(
+            "SL::application/lucre/models/external_3D_files/duck/duck.gltf::0::SceneWithDuck::duck"_name);
         if ((duck != entt::null) && m_Registry.all_of<ScriptComponent>(duck))
         {
             auto& duckScriptComponent = m_Registry.get<ScriptComponent>(duck);
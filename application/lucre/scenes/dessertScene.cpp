@@ -84,7 +84,7 @@ namespace LucreApp
         m_Dictionary.List();
 
         {
-            auto sceneLights = m_Dictionary.Retrieve("SceneLights");
+            auto sceneLights = m_Dictionary.Retrieve("SceneLights"_name);
             if (sceneLights != entt::null)
             {
                 auto& transform = m_Registry.get<TransformComponent>(sceneLights);
@@ -129,6 +129,7 @@ namespace LucreApp
         ImGUI::SetupSlider(this);
 
         LoadModels();
+        m_SceneLoaderJSON.RestoreSnapshot();
         LoadScripts();
     }
 
@@ -151,7 +152,7 @@ namespace LucreApp
         { // directional lights
             {
                 m_Lightbulb0 = m_Dictionary.Retrieve(
-                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb.gltf::0::root");
+                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb.gltf::0::root"_name);
                 if (m_Lightbulb0 == entt::null)
                 {
                     LOG_APP_INFO("m_Lightbulb0 not found");
@@ -171,7 +172,7 @@ namespace LucreApp
 
             {
                 m_Lightbulb1 = m_Dictionary.Retrieve(
-                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb2.gltf::0::root");
+                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb2.gltf::0::root"_name);
                 if (m_Lightbulb1 == entt::null)
                 {
                     LOG_APP_INFO("m_Lightbulb1 not found");
@@ -83,8 +83,8 @@ namespace LucreApp
         m_SceneGraph.TraverseLog(SceneGraph::ROOT_NODE);
         m_Dictionary.List();
 
-        m_Camera[CameraTypes::AttachedToLight] =
-            m_Dictionary.Retrieve("SL::application/lucre/models/external_3D_files/lights/gltf/lights.glb::0::Scene::Camera");
+        m_Camera[CameraTypes::AttachedToLight] = m_Dictionary.Retrieve(
+            "SL::application/lucre/models/external_3D_files/lights/gltf/lights.glb::0::Scene::Camera"_name);
         // set up 2nd camera
         if (m_Camera[CameraTypes::AttachedToLight] != entt::null)
         {
@@ -119,7 +119,7 @@ namespace LucreApp
         }
 
         {
-            auto sceneLights = m_Dictionary.Retrieve("SceneLights");
+            auto sceneLights = m_Dictionary.Retrieve("SceneLights"_name);
             if (sceneLights != entt::null)
             {
                 auto& transform = m_Registry.get<TransformComponent>(sceneLights);
@@ -127,11 +127,11 @@ namespace LucreApp
             }
         }
         m_Water = m_Dictionary.Retrieve(
-            "SL::application/lucre/models/external_3D_files/Island scene/gltf/Island2.glb::0::Scene::Water");
+            "SL::application/lucre/models/external_3D_files/Island scene/gltf/Island2.glb::0::Scene::Water"_name);
 
         // get characters and start all animations
         m_Guybrush = m_Dictionary.Retrieve(
-            "SL::application/lucre/models/guybrush_animated_gltf/animation/guybrush.glb::0::Scene::guybrush object");
+            "SL::application/lucre/models/guybrush_animated_gltf/animation/guybrush.glb::0::Scene::guybrush object"_name);
         if (m_Guybrush != entt::null)
         {
             if (m_Registry.all_of<SkeletalAnimationTag>(m_Guybrush))
@@ -156,7 +156,7 @@ namespace LucreApp
                 SkeletalAnimations& animations = mesh.m_Model->GetAnimations();
 
                 entt::entity model = m_Dictionary.Retrieve(
-                    "SL::application/lucre/models/guybrush_animated_gltf/animation/guybrush.glb::0::Scene::Armature");
+                    "SL::application/lucre/models/guybrush_animated_gltf/animation/guybrush.glb::0::Scene::Armature"_name);
                 if (model != entt::null)
                 {
                     m_CharacterAnimation = std::make_unique<CharacterAnimation>(m_Registry, model, animations);
@@ -166,7 +166,7 @@ namespace LucreApp
         }
 
         m_NonPlayableCharacters[NPC::Character2] =
-            m_Dictionary.Retrieve("SL::application/lucre/models/Kaya/gltf/Kaya.glb::0::Scene::Kaya Body_Mesh");
+            m_Dictionary.Retrieve("SL::application/lucre/models/Kaya/gltf/Kaya.glb::0::Scene::Kaya Body_Mesh"_name);
         if (m_NonPlayableCharacters[NPC::Character2] != entt::null)
         {
             auto& mesh = m_Registry.get<MeshComponent>(m_NonPlayableCharacters[NPC::Character2]);
@@ -176,7 +176,7 @@ namespace LucreApp
         }
 
         m_NonPlayableCharacters[NPC::Character3] =
-            m_Dictionary.Retrieve("SL::application/lucre/models/Kaya/gltf/Kaya.glb::1::Scene::Kaya Body_Mesh");
+            m_Dictionary.Retrieve("SL::application/lucre/models/Kaya/gltf/Kaya.glb::1::Scene::Kaya Body_Mesh"_name);
         if (m_NonPlayableCharacters[NPC::Character3] != entt::null)
         {
             auto& mesh = m_Registry.get<MeshComponent>(m_NonPlayableCharacters[NPC::Character3]);
@@ -186,7 +186,7 @@ namespace LucreApp
         }
 
         m_NonPlayableCharacters[NPC::Character1] =
-            m_Dictionary.Retrieve("SL::application/lucre/models/dancing/gltf/Dancing Michelle.glb::0::Scene::Michelle");
+            m_Dictionary.Retrieve("SL::application/lucre/models/dancing/gltf/Dancing Michelle.glb::0::Scene::Michelle"_name);
         if (m_NonPlayableCharacters[NPC::Character1] != entt::null)
         {
             auto& mesh = m_Registry.get<MeshComponent>(m_NonPlayableCharacters[NPC::Character1]);
@@ -196,7 +196,7 @@ namespace LucreApp
         }
 
         m_NonPlayableCharacters[NPC::Character4] =
-            m_Dictionary.Retrieve("SL::application/lucre/models/dancing/fbx/Dancing Michelle.fbx::0::Michelle");
+            m_Dictionary.Retrieve("SL::application/lucre/models/dancing/fbx/Dancing Michelle.fbx::0::Michelle"_name);
         if (m_NonPlayableCharacters[NPC::Character4] != entt::null)
         {
             auto& mesh = m_Registry.get<MeshComponent>(m_NonPlayableCharacters[NPC::Character4]);
@@ -242,6 +242,7 @@ namespace LucreApp
         ImGUI::SetupSlider(this);
 
         LoadModels();
+        m_SceneLoaderJSON.RestoreSnapshot();
         LoadScripts();
     }
 
@@ -264,7 +265,7 @@ namespace LucreApp
         { // directional lights
             {
                 m_Lightbulb0 = m_Dictionary.Retrieve(
-                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb.gltf::0::root");
+                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb.gltf::0::root"_name);
                 if (m_Lightbulb0 == entt::null)
                 {
                     LOG_APP_INFO("m_Lightbulb0 not found");
@@ -284,7 +285,7 @@ namespace LucreApp
 
             {
                 m_Lightbulb1 = m_Dictionary.Retrieve(
-                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb2.gltf::0::root");
+                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb2.gltf::0::root"_name);
                 if (m_Lightbulb1 == entt::null)
                 {
                     LOG_APP_INFO("m_Lightbulb1 not found");
@@ -114,6 +114,7 @@ namespace LucreApp
         ImGUI::SetupSlider(this);
         LoadModels();
         LoadTerrain();
+        m_SceneLoaderJSON.RestoreSnapshot();
         LoadScripts();
     }
 
@@ -136,7 +137,7 @@ namespace LucreApp
         { // directional lights
             {
                 m_Lightbulb0 = m_Dictionary.Retrieve(
-                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb.gltf::0::root");
+                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb.gltf::0::root"_name);
                 if (m_Lightbulb0 == entt::null)
                 {
                     LOG_APP_INFO("m_Lightbulb0 not found");
@@ -156,7 +157,7 @@ namespace LucreApp
 
             {
                 m_Lightbulb1 = m_Dictionary.Retrieve(
-                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb2.gltf::0::root");
+                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb2.gltf::0::root"_name);
                 if (m_Lightbulb1 == entt::null)
                 {
                     LOG_APP_INFO("m_Lightbulb1 not found");
@@ -108,11 +108,11 @@ namespace LucreApp
         }
 
         m_Water = m_Dictionary.Retrieve(
-            "SL::application/lucre/models/external_3D_files/Island scene/gltf/Island10.glb::0::Scene::Water");
+            "SL::application/lucre/models/external_3D_files/Island scene/gltf/Island10.glb::0::Scene::Water"_name);
 
         // get characters and start all animations
         m_Guybrush = m_Dictionary.Retrieve(
-            "SL::application/lucre/models/guybrush_animated_gltf/animation/guybrush.glb::0::Scene::guybrush object");
+            "SL::application/lucre/models/guybrush_animated_gltf/animation/guybrush.glb::0::Scene::guybrush object"_name);
         if (m_Guybrush != entt::null)
         {
             if (m_Registry.all_of<SkeletalAnimationTag>(m_Guybrush))
@@ -137,7 +137,7 @@ namespace LucreApp
                 SkeletalAnimations& animations = mesh.m_Model->GetAnimations();
 
                 entt::entity model = m_Dictionary.Retrieve(
-                    "SL::application/lucre/models/guybrush_animated_gltf/animation/guybrush.glb::0::Scene::Armature");
+                    "SL::application/lucre/models/guybrush_animated_gltf/animation/guybrush.glb::0::Scene::Armature"_name);
                 if (model != entt::null)
                 {
                     m_CharacterAnimation = std::make_unique<CharacterAnimation>(m_Registry, model, animations);
@@ -153,12 +153,13 @@ namespace LucreApp
         ImGUI::SetupSlider(this);
         LoadModels();
         LoadTerrain();
+        m_SceneLoaderJSON.RestoreSnapshot();
         LoadScripts();
     }
 
     void TerrainScene::LoadTerrain()
     {
-        m_Terrain = m_Dictionary.Retrieve("application/lucre/terrainDescriptions/heightmap2.json::0");
+        m_Terrain = m_Dictionary.Retrieve("application/lucre/terrainDescriptions/heightmap2.json::0"_name);
     }
     void TerrainScene::LoadModels()
     {
@@ -177,7 +178,7 @@ namespace LucreApp
         { // directional lights
             {
                 m_Lightbulb0 = m_Dictionary.Retrieve(
-                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb.gltf::0::root");
+                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb.gltf::0::root"_name);
                 if (m_Lightbulb0 == entt::null)
                 {
                     LOG_APP_INFO("m_Lightbulb0 not found");
@@ -197,7 +198,7 @@ namespace LucreApp
 
             {
                 m_Lightbulb1 = m_Dictionary.Retrieve(
-                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb2.gltf::0::root");
+                    "SL::application/lucre/models/external_3D_files/lightBulb/lightBulb2.gltf::0::root"_name);
                 if (m_Lightbulb1 == entt::null)
                 {
                     LOG_APP_INFO("m_Lightbulb1 not found");
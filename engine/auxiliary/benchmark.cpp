@@ -0,0 +1,314 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <fstream>
+#include <cstdlib>
+#include <algorithm>
+#include <numeric>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "auxiliary/benchmark.h"
+
+namespace GfxRenderEngine
+{
+    Benchmark::Benchmark()
+        : m_Running{false}, m_Finished{false}, m_FrameCounter{0}, m_SceneLoadTimeMs{0.0f}, m_StartupTimeMs{0.0f}
+    {
+        m_StartTime = std::chrono::high_resolution_clock::now();
+        m_SceneLoadStartTime = m_StartTime;
+    }
+
+    bool Benchmark::ParseCommandLine(int argc, char* argv[])
+    {
+        for (int index = 1; index < argc; ++index)
+        {
+            std::string argument{argv[index]};
+            bool hasValue = (index + 1) < argc;
+            if (argument == "--benchmark")
+            {
+                if (!hasValue)
+                {
+                    LOG_CORE_CRITICAL("Benchmark::ParseCommandLine: --benchmark requires a scene description");
+                    return false;
+                }
+                m_Settings.m_Enabled = true;
+                m_Settings.m_SceneDescription = argv[++index];
+            }
+            else if ((argument == "--frames") && hasValue)
+            {
+                m_Settings.m_Frames = std::max(1, std::atoi(argv[++index]));
+            }
+            else if ((argument == "--warmup") && hasValue)
+            {
+                m_Settings.m_WarmupFrames = std::max(0, std::atoi(argv[++index]));
+            }
+            else if ((argument == "--output") && hasValue)
+            {
+                m_Settings.m_OutputFile = argv[++index];
+            }
+            else if (argument == "--window")
+            {
+                m_Settings.m_Headless = false;
+            }
+            else if (argument == "--threadpool")
+            {
+                m_Settings.m_ThreadPoolBenchmark = true;
+            }
+        }
+
+        if (m_Settings.m_Enabled)
+        {
+            LOG_CORE_INFO("benchmark: scene {0}, {1} frames ({2} warm-up), output {3}, {4}",
+                          m_Settings.m_SceneDescription, m_Settings.m_Frames, m_Settings.m_WarmupFrames,
+                          m_Settings.m_OutputFile, m_Settings.m_Headless ? "headless" : "windowed");
+        }
+        return true;
+    }
+
+    std::chrono::duration<float, std::chrono::seconds::period> Benchmark::GetTimestep() const
+    {
+        return std::chrono::duration<float, std::chrono::seconds::period>(m_Settings.m_Timestep);
+    }
+
+    void Benchmark::BeginSceneLoad()
+    {
+        std::lock_guard<std::mutex> guard(m_LoadMutex);
+        m_SceneLoadStartTime = std::chrono::high_resolution_clock::now();
+    }
+
+    void Benchmark::EndSceneLoad()
+    {
+        std::lock_guard<std::mutex> guard(m_LoadMutex);
+        std::chrono::duration<float, std::milli> duration =
+            std::chrono::high_resolution_clock::now() - m_SceneLoadStartTime;
+        m_SceneLoadTimeMs = duration.count();
+    }
+
+    // the application calls this every frame once the benchmarked scene is current
+    void Benchmark::SceneIsRunning()
+    {
+        if (!m_Settings.m_Enabled || m_Running || m_Finished)
+        {
+            return;
+        }
+        std::chrono::duration<float, std::milli> duration = std::chrono::high_resolution_clock::now() - m_StartTime;
+        m_StartupTimeMs = duration.count();
+        m_Running = true;
+        m_FrameCounter = 0;
+        LOG_CORE_INFO("benchmark: scene running after {0} ms (scene load {1} ms)", m_StartupTimeMs, m_SceneLoadTimeMs);
+    }
+
+    // one orbit around the camera's start position over the measured frames
+    // (the warm-up frames run the first part of the path)
+    Benchmark::CameraKeyframe Benchmark::GetCameraKeyframe(const CameraKeyframe& origin) const
+    {
+        uint totalFrames = m_Settings.m_WarmupFrames + m_Settings.m_Frames;
+        float progress = static_cast<float>(m_FrameCounter) / static_cast<float>(totalFrames);
+        float angle = glm::two_pi<float>() * progress;
+        float radius = m_Settings.m_CameraRadius;
+
+        CameraKeyframe keyframe;
+        keyframe.m_Translation = origin.m_Translation + glm::vec3(radius * glm::sin(angle), 0.0f,
+                                                                  radius * (glm::cos(angle) - 1.0f));
+        keyframe.m_Rotation = origin.m_Rotation + glm::vec3(0.0f, angle, 0.0f);
+        return keyframe;
+    }
+
+    void Benchmark::BeginFrame()
+    {
+        m_FrameStartTime = std::chrono::high_resolution_clock::now();
+        m_CurrentCpuTimes.clear();
+    }
+
+    void Benchmark::AddCpuTime(const std::string& name, float milliseconds) { m_CurrentCpuTimes[name] += milliseconds; }
+
+    void Benchmark::EndFrame(const RenderStatistics& renderStatistics)
+    {
+        if (!m_Running)
+        {
+            return;
+        }
+
+        std::chrono::duration<float, std::milli> frameTime = std::chrono::high_resolution_clock::now() - m_FrameStartTime;
+        bool measuring = m_FrameCounter >= m_Settings.m_WarmupFrames;
+        ++m_FrameCounter;
+        if (!measuring)
+        {
+            return;
+        }
+
+        m_FrameTimes.push_back(frameTime.count());
+        for (uint pass = 0; pass < RenderStatistics::NUMBER_OF_PASSES; ++pass)
+        {
+            m_CpuTimes[RenderStatistics::PASS_NAMES[pass]].push_back(renderStatistics.m_CpuTimeMs[pass]);
+        }
+        for (auto& [name, milliseconds] : m_CurrentCpuTimes)
+        {
+            m_CpuTimes[name].push_back(milliseconds);
+        }
+        if (renderStatistics.m_GpuTimingsValid)
+        {
+            float gpuFrameTime = 0.0f;
+            for (uint pass = 0; pass < RenderStatistics::NUMBER_OF_PASSES; ++pass)
+            {
+                m_GpuTimes[RenderStatistics::PASS_NAMES[pass]].push_back(renderStatistics.m_GpuTimeMs[pass]);
+                gpuFrameTime += renderStatistics.m_GpuTimeMs[pass];
+            }
+            m_GpuTimes["total"].push_back(gpuFrameTime);
+        }
+        m_DrawCalls.push_back(static_cast<float>(renderStatistics.m_DrawCalls));
+        m_Instances.push_back(static_cast<float>(renderStatistics.m_Instances));
+        m_Triangles.push_back(static_cast<float>(renderStatistics.m_Triangles));
+
+        if (m_FrameCounter >= (m_Settings.m_WarmupFrames + m_Settings.m_Frames))
+        {
+            m_Running = false;
+            m_Finished = true;
+        }
+    }
+
+    Benchmark::Summary Benchmark::Summarize(std::vector<float> samples)
+    {
+        Summary summary;
+        if (samples.empty())
+        {
+            return summary;
+        }
+        std::sort(samples.begin(), samples.end());
+        auto percentile = [&samples](float fraction)
+        {
+            size_t index = static_cast<size_t>(fraction * static_cast<float>(samples.size() - 1) + 0.5f);
+            return samples[std::min(index, samples.size() - 1)];
+        };
+        summary.m_Mean = std::accumulate(samples.begin(), samples.end(), 0.0f) / static_cast<float>(samples.size());
+        summary.m_Min = samples.front();
+        summary.m_P50 = percentile(0.50f);
+        summary.m_P90 = percentile(0.90f);
+        summary.m_P95 = percentile(0.95f);
+        summary.m_P99 = percentile(0.99f);
+        summary.m_Max = samples.back();
+        return summary;
+    }
+
+    size_t Benchmark::GetPeakMemory()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return counters.PeakWorkingSetSize;
+        }
+        return 0;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0;
+        }
+#ifdef MACOSX
+        return static_cast<size_t>(usage.ru_maxrss); // bytes
+#else
+        return static_cast<size_t>(usage.ru_maxrss) * 1024; // kilobytes
+#endif
+#endif
+    }
+
+    void Benchmark::WriteSummary(std::ofstream& outputFile, const std::string& name, const Summary& summary,
+                                 const std::string& indent, bool lastEntry)
+    {
+        outputFile << indent << "\"" << name << "\": {"
+                   << "\"mean\": " << summary.m_Mean << ", \"min\": " << summary.m_Min << ", \"p50\": " << summary.m_P50
+                   << ", \"p90\": " << summary.m_P90 << ", \"p95\": " << summary.m_P95 << ", \"p99\": " << summary.m_P99
+                   << ", \"max\": " << summary.m_Max << "}" << (lastEntry ? "\n" : ",\n");
+    }
+
+    bool Benchmark::WriteReport() const
+    {
+        if (!m_Settings.m_Enabled)
+        {
+            return true;
+        }
+        if (!m_Finished)
+        {
+            LOG_CORE_WARN("benchmark: incomplete run ({0} of {1} frames measured)", m_FrameTimes.size(),
+                          m_Settings.m_Frames);
+        }
+
+        std::ofstream outputFile(m_Settings.m_OutputFile);
+        if (!outputFile.is_open())
+        {
+            LOG_CORE_CRITICAL("Benchmark::WriteReport: could not open {0}", m_Settings.m_OutputFile);
+            return false;
+        }
+
+        Summary frameTime = Summarize(m_FrameTimes);
+        float peakMemoryMB = static_cast<float>(GetPeakMemory()) / (1024.0f * 1024.0f);
+
+        outputFile << "{\n";
+        outputFile << "    \"scene\": \"" << m_Settings.m_SceneDescription << "\",\n";
+        outputFile << "    \"headless\": " << (m_Settings.m_Headless ? "true" : "false") << ",\n";
+        outputFile << "    \"frames\": " << m_FrameTimes.size() << ",\n";
+        outputFile << "    \"warmupFrames\": " << m_Settings.m_WarmupFrames << ",\n";
+        outputFile << "    \"timestep\": " << m_Settings.m_Timestep << ",\n";
+        outputFile << "    \"completed\": " << (m_Finished ? "true" : "false") << ",\n";
+        outputFile << "    \"startupTimeMs\": " << m_StartupTimeMs << ",\n";
+        outputFile << "    \"sceneLoadTimeMs\": " << m_SceneLoadTimeMs << ",\n";
+        outputFile << "    \"peakMemoryMB\": " << peakMemoryMB << ",\n";
+        WriteSummary(outputFile, "frameTimeMs", frameTime, "    ", false);
+        outputFile << "    \"cpuTimeMs\": {\n";
+        {
+            size_t index = 0;
+            for (auto& [name, samples] : m_CpuTimes)
+            {
+                ++index;
+                WriteSummary(outputFile, name, Summarize(samples), "        ", index == m_CpuTimes.size());
+            }
+        }
+        outputFile << "    },\n";
+        outputFile << "    \"gpuTimeMs\": {\n";
+        {
+            size_t index = 0;
+            for (auto& [name, samples] : m_GpuTimes)
+            {
+                ++index;
+                WriteSummary(outputFile, name, Summarize(samples), "        ", index == m_GpuTimes.size());
+            }
+        }
+        outputFile << "    },\n";
+        outputFile << "    \"drawCalls\": {\n";
+        WriteSummary(outputFile, "draws", Summarize(m_DrawCalls), "        ", false);
+        WriteSummary(outputFile, "instances", Summarize(m_Instances), "        ", false);
+        WriteSummary(outputFile, "triangles", Summarize(m_Triangles), "        ", true);
+        outputFile << "    }\n";
+        outputFile << "}\n";
+
+        LOG_CORE_INFO("benchmark: {0} frames, mean {1} ms, p99 {2} ms, peak memory {3} MB, report written to {4}",
+                      m_FrameTimes.size(), frameTime.m_Mean, frameTime.m_P99, peakMemoryMB, m_Settings.m_OutputFile);
+        return true;
+    }
+} // namespace GfxRenderEngine
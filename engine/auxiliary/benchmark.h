@@ -0,0 +1,130 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <map>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include "engine.h"
+#include "renderer/renderStatistics.h"
+
+namespace GfxRenderEngine
+{
+    // Runs a scene for a fixed number of frames with a fixed timestep and a scripted camera,
+    // then writes frame-time percentiles, per-pass CPU and GPU times, load time, peak memory,
+    // and draw counts as JSON. Usage:
+    // ./bin/Release/lucre --benchmark island2.json --frames 1000 --output benchmark.json
+    // Without --window, the engine runs headless (glfw null platform, VK_EXT_headless_surface),
+    // which works on lavapipe.
+    // --threadpool runs the job system microbenchmarks instead (see threadPoolBenchmark.h).
+    class Benchmark
+    {
+    public:
+        using TimePoint = std::chrono::time_point<std::chrono::high_resolution_clock>;
+
+        struct Settings
+        {
+            bool m_Enabled{false};
+            bool m_Headless{true};
+            bool m_ThreadPoolBenchmark{false};
+            std::string m_SceneDescription;
+            std::string m_OutputFile{"benchmark.json"};
+            uint m_Frames{1000};
+            uint m_WarmupFrames{60};
+            float m_Timestep{1.0f / 60.0f};
+            float m_CameraRadius{5.0f};
+        };
+
+        struct CameraKeyframe
+        {
+            glm::vec3 m_Translation{0.0f};
+            glm::vec3 m_Rotation{0.0f};
+        };
+
+    public:
+        Benchmark();
+
+        bool ParseCommandLine(int argc, char* argv[]);
+        const Settings& GetSettings() const { return m_Settings; }
+        bool IsEnabled() const { return m_Settings.m_Enabled; }
+        bool IsHeadless() const { return m_Settings.m_Enabled && m_Settings.m_Headless; }
+        bool IsThreadPoolBenchmark() const { return m_Settings.m_ThreadPoolBenchmark; }
+        bool IsRunning() const { return m_Running; }
+        bool IsFinished() const { return m_Finished; }
+        std::chrono::duration<float, std::chrono::seconds::period> GetTimestep() const;
+
+        // called by the application
+        void BeginSceneLoad();
+        void EndSceneLoad();
+        void SceneIsRunning();
+        CameraKeyframe GetCameraKeyframe(const CameraKeyframe& origin) const;
+
+        // called by the engine's main loop
+        void BeginFrame();
+        void AddCpuTime(const std::string& name, float milliseconds);
+        void EndFrame(const RenderStatistics& renderStatistics);
+        bool WriteReport() const;
+
+    private:
+        struct Summary
+        {
+            float m_Mean{0.0f};
+            float m_Min{0.0f};
+            float m_P50{0.0f};
+            float m_P90{0.0f};
+            float m_P95{0.0f};
+            float m_P99{0.0f};
+            float m_Max{0.0f};
+        };
+
+        static Summary Summarize(std::vector<float> samples);
+        static size_t GetPeakMemory();
+        static void WriteSummary(std::ofstream& outputFile, const std::string& name, const Summary& summary,
+                                 const std::string& indent, bool lastEntry);
+
+    private:
+        Settings m_Settings;
+        bool m_Running;
+        bool m_Finished;
+        uint m_FrameCounter;
+
+        TimePoint m_StartTime;
+        TimePoint m_FrameStartTime;
+        std::mutex m_LoadMutex;
+        TimePoint m_SceneLoadStartTime;
+        float m_SceneLoadTimeMs;
+        float m_StartupTimeMs;
+
+        std::map<std::string, float> m_CurrentCpuTimes;
+        std::map<std::string, std::vector<float>> m_CpuTimes;
+        std::map<std::string, std::vector<float>> m_GpuTimes;
+        std::vector<float> m_FrameTimes;
+        std::vector<float> m_DrawCalls;
+        std::vector<float> m_Instances;
+        std::vector<float> m_Triangles;
+    };
+} // namespace GfxRenderEngine
@@ -0,0 +1,128 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "auxiliary/mappedFile.h"
+
+namespace GfxRenderEngine
+{
+    MappedFile::~MappedFile() { Close(); }
+
+#ifdef _WIN32
+    bool MappedFile::Open(std::string const& filename)
+    {
+        Close();
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || (fileSize.QuadPart == 0))
+        {
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+        {
+            CloseHandle(file);
+            return false;
+        }
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!data)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        m_File = file;
+        m_Mapping = mapping;
+        m_Data = static_cast<const uint8_t*>(data);
+        m_Size = static_cast<size_t>(fileSize.QuadPart);
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_Data)
+        {
+            UnmapViewOfFile(m_Data);
+            CloseHandle(m_Mapping);
+            CloseHandle(m_File);
+        }
+        m_Data = nullptr;
+        m_Size = 0;
+        m_File = nullptr;
+        m_Mapping = nullptr;
+    }
+#else
+    bool MappedFile::Open(std::string const& filename)
+    {
+        Close();
+        int file = open(filename.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            return false;
+        }
+        struct stat fileStatus;
+        if ((fstat(file, &fileStatus) != 0) || (fileStatus.st_size == 0))
+        {
+            close(file);
+            return false;
+        }
+        void* data = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        if (data == MAP_FAILED)
+        {
+            close(file);
+            return false;
+        }
+        // the file is read front to back once
+        madvise(data, static_cast<size_t>(fileStatus.st_size), MADV_SEQUENTIAL);
+        m_File = file;
+        m_Data = static_cast<const uint8_t*>(data);
+        m_Size = static_cast<size_t>(fileStatus.st_size);
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_Data)
+        {
+            munmap(const_cast<uint8_t*>(m_Data), m_Size);
+            close(m_File);
+        }
+        m_Data = nullptr;
+        m_Size = 0;
+        m_File = -1;
+    }
+#endif
+} // namespace GfxRenderEngine
@@ -0,0 +1,67 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <mutex>
+
+#include "auxiliary/nameTable.h"
+
+namespace GfxRenderEngine
+{
+    std::shared_mutex NameTable::m_Mutex;
+    std::unordered_map<NameID, std::string, NameIDHash> NameTable::m_Names;
+
+    NameID NameTable::Intern(std::string_view name)
+    {
+        NameID nameID = HashName(name);
+        {
+            std::shared_lock<std::shared_mutex> readLock(m_Mutex);
+            auto iterator = m_Names.find(nameID);
+            if (iterator != m_Names.end())
+            {
+                if (iterator->second != name)
+                {
+                    LOG_CORE_CRITICAL("NameTable::Intern: hash collision between '{0}' and '{1}'", iterator->second,
+                                      name);
+                }
+                return nameID;
+            }
+        }
+        std::unique_lock<std::shared_mutex> writeLock(m_Mutex);
+        m_Names.try_emplace(nameID, name);
+        return nameID;
+    }
+
+    const std::string& NameTable::GetString(NameID nameID)
+    {
+        static const std::string unknown{"unknown name"};
+        std::shared_lock<std::shared_mutex> readLock(m_Mutex);
+        auto iterator = m_Names.find(nameID);
+        // references stay valid, unordered_map does not move its nodes
+        return (iterator != m_Names.end()) ? iterator->second : unknown;
+    }
+
+    size_t NameTable::Size()
+    {
+        std::shared_lock<std::shared_mutex> readLock(m_Mutex);
+        return m_Names.size();
+    }
+} // namespace GfxRenderEngine
@@ -0,0 +1,72 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "engine.h"
+
+namespace GfxRenderEngine
+{
+    // 64-bit ID of an interned name (FNV-1a)
+    using NameID = uint64;
+
+    static constexpr NameID NAME_ID_INVALID = 0;
+
+    constexpr NameID HashName(std::string_view name)
+    {
+        NameID hash = 0xcbf29ce484222325ull;
+        for (char character : name)
+        {
+            hash ^= static_cast<uint64>(static_cast<unsigned char>(character));
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    // compile-time hash for literals: m_Dictionary.Retrieve("defaultCamera"_name)
+    consteval NameID operator""_name(const char* name, size_t length) { return HashName(std::string_view(name, length)); }
+
+    // name IDs are already hashes
+    struct NameIDHash
+    {
+        size_t operator()(NameID nameID) const { return static_cast<size_t>(nameID); }
+    };
+
+    // Each name string is stored once for the whole engine,
+    // scene graph nodes, components, and dictionaries store the ID.
+    class NameTable
+    {
+    public:
+        static NameID Intern(std::string_view name);
+        static const std::string& GetString(NameID nameID);
+        static size_t Size();
+
+    private:
+        static std::shared_mutex m_Mutex;
+        static std::unordered_map<NameID, std::string, NameIDHash> m_Names;
+    };
+} // namespace GfxRenderEngine
@@ -18,18 +18,370 @@
    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
-   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <algorithm>
 
 #include "auxiliary/threadPool.h"
 
 namespace GfxRenderEngine
 {
+    namespace
+    {
+        // identifies the worker a thread belongs to
+        thread_local ThreadPool* t_ThreadPool = nullptr;
+        thread_local int t_WorkerIndex = -1;
+    } // namespace
+
+    class ThreadPool::Task
+    {
+    public:
+        Job m_Job;
+        TaskGroup* m_Group{nullptr};
+        std::atomic<int> m_PendingDependencies{1}; // one extra reference until Run() added all dependencies
+        std::atomic<bool> m_Claimed{false};        // by the pool or by TaskGroup::Wait()
+
+        std::mutex m_Mutex;
+        bool m_Finished{false};
+        std::vector<TaskHandle> m_Successors;
+    };
+
+    ThreadPool::TaskGroup::TaskGroup(ThreadPool& threadPool) : m_ThreadPool{threadPool}, m_UnfinishedTasks{0} {}
+
+    ThreadPool::TaskGroup::~TaskGroup() { Wait(); }
+
+    bool ThreadPool::TaskGroup::ExecuteOne()
+    {
+        TaskHandle task;
+        {
+            std::lock_guard<std::mutex> guard(m_Mutex);
+            while (!task && !m_ScheduledTasks.empty())
+            {
+                task = std::move(m_ScheduledTasks.front());
+                m_ScheduledTasks.pop_front();
+                if (task->m_Claimed.load(std::memory_order_relaxed))
+                {
+                    task.reset(); // already running or done
+                }
+            }
+        }
+        return task && ThreadPool::Execute(task);
+    }
+
+    ThreadPool::TaskHandle ThreadPool::TaskGroup::Run(Job job, const std::vector<TaskHandle>& dependencies)
+    {
+        auto task = std::make_shared<Task>();
+        task->m_Job = std::move(job);
+        task->m_Group = this;
+        m_UnfinishedTasks.fetch_add(1, std::memory_order_relaxed);
+
+        for (auto& dependency : dependencies)
+        {
+            std::lock_guard<std::mutex> guard(dependency->m_Mutex);
+            if (!dependency->m_Finished)
+            {
+                dependency->m_Successors.push_back(task);
+                task->m_PendingDependencies.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        if (task->m_PendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            m_ThreadPool.Schedule(task);
+        }
+        return task;
+    }
+
+    void ThreadPool::TaskGroup::Wait()
+    {
+        // workers of the pool help with any job, other threads only with the tasks of this group
+        bool isWorker = m_ThreadPool.GetWorkerIndex() >= 0;
+        uint idleCount = 0;
+        while (!IsFinished())
+        {
+            if (ExecuteOne())
+            {
+                idleCount = 0;
+            }
+            else if (isWorker)
+            {
+                m_ThreadPool.Help(idleCount);
+            }
+            else
+            {
+                m_ThreadPool.Backoff(idleCount);
+            }
+        }
+    }
+
+    ThreadPool::ThreadPool() : m_QueuedJobs{0}, m_UnfinishedJobs{0}, m_Stop{false}, m_SleepingWorkers{0}
+    {
+        Start(std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    ThreadPool::ThreadPool(const uint numThreads)
+        : m_QueuedJobs{0}, m_UnfinishedJobs{0}, m_Stop{false}, m_SleepingWorkers{0}
+    {
+        Start(std::max(1u, numThreads));
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        Wait();
+        {
+            std::lock_guard<std::mutex> guard(m_SleepMutex);
+            m_Stop = true;
+        }
+        m_WakeUp.notify_all();
+        for (auto& worker : m_Workers)
+        {
+            worker->m_Thread.join();
+        }
+    }
+
+    void ThreadPool::Start(const uint numThreads)
+    {
+        // all deques must exist before the first worker may steal
+        m_Workers.reserve(numThreads);
+        for (uint workerIndex = 0; workerIndex < numThreads; ++workerIndex)
+        {
+            m_Workers.push_back(std::make_unique<Worker>());
+        }
+        for (uint workerIndex = 0; workerIndex < numThreads; ++workerIndex)
+        {
+            m_Workers[workerIndex]->m_Thread = std::thread([this, workerIndex]() { WorkerLoop(workerIndex); });
+        }
+    }
+
+    std::vector<std::thread::id> ThreadPool::GetThreadIDs() const
+    {
+        std::vector<std::thread::id> threadIDs;
+        threadIDs.reserve(m_Workers.size());
+        for (auto& worker : m_Workers)
+        {
+            threadIDs.push_back(worker->m_Thread.get_id());
+        }
+        return threadIDs;
+    }
+
+    int ThreadPool::GetWorkerIndex() const { return (t_ThreadPool == this) ? t_WorkerIndex : -1; }
+
+    void ThreadPool::WorkerLoop(uint workerIndex)
+    {
+        t_ThreadPool = this;
+        t_WorkerIndex = static_cast<int>(workerIndex);
+
+        while (true)
+        {
+            Job job;
+            if (Pop(job))
+            {
+                Run(job);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_SleepMutex);
+            ++m_SleepingWorkers;
+            m_WakeUp.wait(lock, [this]() { return m_Stop || (m_QueuedJobs > 0); });
+            --m_SleepingWorkers;
+            if (m_Stop && (m_QueuedJobs <= 0))
+            {
+                break;
+            }
+        }
+    }
+
+    void ThreadPool::Submit(Job job)
+    {
+        m_UnfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+        Push(std::move(job));
+    }
+
+    void ThreadPool::Push(Job&& job)
+    {
+        int workerIndex = GetWorkerIndex();
+        if (workerIndex >= 0)
+        {
+            // a job spawned by a job: keep it local, it is likely to use warm caches
+            Worker& worker = *m_Workers[workerIndex];
+            std::lock_guard<std::mutex> guard(worker.m_Mutex);
+            worker.m_Jobs.push_back(std::move(job));
+        }
+        else
+        {
+            std::lock_guard<std::mutex> guard(m_InjectionMutex);
+            m_InjectionQueue.push_back(std::move(job));
+        }
+        // sequentially consistent: either this thread sees a sleeping worker
+        // or the worker sees the job in its wait predicate
+        ++m_QueuedJobs;
+        if (m_SleepingWorkers > 0)
+        {
+            {
+                std::lock_guard<std::mutex> guard(m_SleepMutex);
+            }
+            m_WakeUp.notify_one();
+        }
+    }
+
+    bool ThreadPool::Pop(Job& job)
+    {
+        int workerIndex = GetWorkerIndex();
+        if (workerIndex >= 0)
+        {
+            // own jobs, newest first
+            Worker& worker = *m_Workers[workerIndex];
+            std::lock_guard<std::mutex> guard(worker.m_Mutex);
+            if (!worker.m_Jobs.empty())
+            {
+                job = std::move(worker.m_Jobs.back());
+                worker.m_Jobs.pop_back();
+                m_QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> guard(m_InjectionMutex);
+            if (!m_InjectionQueue.empty())
+            {
+                job = std::move(m_InjectionQueue.front());
+                m_InjectionQueue.pop_front();
+                m_QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return Steal(job, workerIndex >= 0 ? static_cast<uint>(workerIndex) : 0);
+    }
+
+    bool ThreadPool::Steal(Job& job, uint thiefIndex)
+    {
+        uint numberOfWorkers = static_cast<uint>(m_Workers.size());
+        for (uint offset = 1; offset <= numberOfWorkers; ++offset)
+        {
+            // oldest jobs first, they tend to be the biggest
+            Worker& victim = *m_Workers[(thiefIndex + offset) % numberOfWorkers];
+            std::unique_lock<std::mutex> lock(victim.m_Mutex, std::try_to_lock);
+            if (lock.owns_lock() && !victim.m_Jobs.empty())
+            {
+                job = std::move(victim.m_Jobs.front());
+                victim.m_Jobs.pop_front();
+                m_QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::Run(Job& job)
+    {
+        job();
+        m_UnfinishedJobs.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    bool ThreadPool::ExecuteOne()
+    {
+        Job job;
+        if (Pop(job))
+        {
+            Run(job);
+            return true;
+        }
+        return false;
+    }
+
+    void ThreadPool::Help(uint& idleCount)
+    {
+        if (ExecuteOne())
+        {
+            idleCount = 0;
+        }
+        else
+        {
+            Backoff(idleCount);
+        }
+    }
+
+    void ThreadPool::Backoff(uint& idleCount)
+    {
+        if (++idleCount < 64)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            // nothing to steal, the awaited jobs are running elsewhere
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    void ThreadPool::Wait()
+    {
+        CORE_ASSERT(GetWorkerIndex() < 0, "ThreadPool::Wait() called from a worker of the same pool");
+        uint idleCount = 0;
+        while (m_UnfinishedJobs.load(std::memory_order_acquire) > 0)
+        {
+            Help(idleCount);
+        }
+    }
+
+    void ThreadPool::Schedule(const TaskHandle& task)
+    {
+        {
+            std::lock_guard<std::mutex> guard(task->m_Group->m_Mutex);
+            task->m_Group->m_ScheduledTasks.push_back(task);
+        }
+        Submit([task]() { Execute(task); });
+    }
 
-    ThreadPool::ThreadPool() {}
+    bool ThreadPool::Execute(const TaskHandle& task)
+    {
+        if (task->m_Claimed.exchange(true, std::memory_order_acq_rel))
+        {
+            return false; // the group may already be gone, do not touch it
+        }
+        task->m_Job();
+        task->m_Job = nullptr;
 
-    ThreadPool::ThreadPool(const BS::concurrency_t numThreads) : m_Pool{numThreads} {}
+        std::vector<TaskHandle> successors;
+        {
+            std::lock_guard<std::mutex> guard(task->m_Mutex);
+            task->m_Finished = true;
+            successors.swap(task->m_Successors);
+        }
+        ThreadPool& threadPool = task->m_Group->m_ThreadPool;
+        for (auto& successor : successors)
+        {
+            if (successor->m_PendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                threadPool.Schedule(successor);
+            }
+        }
+        // last access to the group, it may be destroyed right after
+        task->m_Group->m_UnfinishedTasks.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
 
-    void ThreadPool::Wait() { m_Pool.wait(); }
-    [[nodiscard]] BS::concurrency_t ThreadPool::Size() const { return m_Pool.get_thread_count(); }
+    void ThreadPool::ParallelFor(uint begin, uint end, uint grainSize, const std::function<void(uint, uint)>& body)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+        grainSize = std::max(1u, grainSize);
+        if ((end - begin) <= grainSize)
+        {
+            body(begin, end);
+            return;
+        }
 
+        TaskGroup taskGroup(*this);
+        uint first = begin;
+        while (first < end)
+        {
+            uint last = ((end - first) > grainSize) ? first + grainSize : end;
+            taskGroup.Run([&body, first, last]() { body(first, last); });
+            first = last;
+        }
+        taskGroup.Wait();
+    }
 } // namespace GfxRenderEngine
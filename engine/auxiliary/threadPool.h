@@ -18,36 +18,147 @@
    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
-   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #pragma once
 #include <iostream>
 #include <mutex>
-#include "BS_thread_pool/BS_thread_pool.hpp"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <future>
+#include <functional>
+#include <condition_variable>
+
+#include "engine.h"
 
 namespace GfxRenderEngine
 {
 
+    // work-stealing job system
+    // Each worker owns a deque: it pushes and pops its own jobs at the back,
+    // idle workers steal from the front of the other deques. Jobs submitted
+    // from outside the pool go to a shared injection queue.
+    // All waits (Wait(), WaitFor(), TaskGroup::Wait(), ParallelFor()) execute
+    // pending jobs while waiting, so nested waits from worker threads cannot deadlock.
+    // A thread from outside the pool that waits on a TaskGroup (or in ParallelFor()) only
+    // executes tasks of that group, so a frame never picks up an unrelated job such as a scene load.
+    // The worker threads live as long as the pool; VK_Pool keys its per-thread
+    // command and descriptor pools by the IDs from GetThreadIDs().
     class ThreadPool
     {
 
+    public:
+        using Job = std::function<void()>;
+
+        class Task;
+        using TaskHandle = std::shared_ptr<Task>;
+
+        // a set of jobs that can be waited on
+        // a job may depend on other jobs of the group, it gets scheduled when its last dependency finished;
+        // scheduled tasks are queued in the pool and in the group, whichever thread claims a task first runs it
+        class TaskGroup
+        {
+        public:
+            TaskGroup(ThreadPool& threadPool);
+            ~TaskGroup();
+
+            TaskGroup(const TaskGroup&) = delete;
+            TaskGroup& operator=(const TaskGroup&) = delete;
+
+            TaskHandle Run(Job job, const std::vector<TaskHandle>& dependencies = {});
+            void Wait();
+            bool IsFinished() const { return m_UnfinishedTasks.load(std::memory_order_acquire) == 0; }
+
+        private:
+            bool ExecuteOne(); // runs one scheduled task of this group, returns false if there was none
+
+        private:
+            friend class ThreadPool;
+            ThreadPool& m_ThreadPool;
+            std::atomic<uint> m_UnfinishedTasks;
+            std::mutex m_Mutex;
+            std::deque<TaskHandle> m_ScheduledTasks; // may hold tasks that the pool already claimed
+        };
+
     public:
         ThreadPool();
-        ThreadPool(const BS::concurrency_t numThreads);
+        ThreadPool(const uint numThreads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
 
+        // waits until all jobs submitted to this pool have finished
+        // (not to be called from a job of the same pool, use a TaskGroup instead)
         void Wait();
-        [[nodiscard]] BS::concurrency_t Size() const;
+        [[nodiscard]] uint Size() const { return static_cast<uint>(m_Workers.size()); }
+        [[nodiscard]] std::vector<std::thread::id> GetThreadIDs() const;
+
+        // fire-and-forget
+        void Submit(Job job);
 
         template <typename FunctionType, typename ReturnType = std::invoke_result_t<std::decay_t<FunctionType>>>
         [[nodiscard]] std::future<ReturnType> SubmitTask(FunctionType&& task)
         {
-            std::lock_guard<std::mutex> guard(m_Mutex);
-            return m_Pool.submit_task(task);
+            auto packagedTask = std::make_shared<std::packaged_task<ReturnType()>>(std::forward<FunctionType>(task));
+            std::future<ReturnType> future = packagedTask->get_future();
+            Submit([packagedTask]() { (*packagedTask)(); });
+            return future;
+        }
+
+        // blocks until the future is ready and executes jobs in the meantime
+        template <typename ReturnType>
+        ReturnType WaitFor(std::future<ReturnType>& future)
+        {
+            uint idleCount = 0;
+            while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                Help(idleCount);
+            }
+            return future.get();
         }
-        [[nodiscard]] std::vector<std::thread::id> GetThreadIDs() const { return m_Pool.get_thread_ids(); }
+
+        // calls body(first, last) for consecutive ranges of up to grainSize elements of [begin, end)
+        // the calling thread participates and returns when all ranges are done
+        void ParallelFor(uint begin, uint end, uint grainSize,
+                         const std::function<void(uint, uint)>& body);
+
+        // runs one pending job on the calling thread, returns false if there was none
+        bool ExecuteOne();
 
     private:
-        BS::thread_pool m_Pool;
-        std::mutex m_Mutex;
+        struct Worker
+        {
+            std::thread m_Thread;
+            std::deque<Job> m_Jobs;
+            std::mutex m_Mutex;
+        };
+
+        void Start(const uint numThreads);
+        void WorkerLoop(uint workerIndex);
+        void Push(Job&& job);
+        bool Pop(Job& job);
+        bool Steal(Job& job, uint thiefIndex);
+        void Run(Job& job);
+        void Schedule(const TaskHandle& task);
+        static bool Execute(const TaskHandle& task); // false if another thread claimed the task
+        void Help(uint& idleCount);
+        void Backoff(uint& idleCount);
+        int GetWorkerIndex() const;
+
+    private:
+        std::vector<std::unique_ptr<Worker>> m_Workers;
+        std::deque<Job> m_InjectionQueue;
+        std::mutex m_InjectionMutex;
+
+        std::atomic<int> m_QueuedJobs;      // jobs waiting in a queue
+        std::atomic<uint> m_UnfinishedJobs; // queued or running
+        std::atomic<bool> m_Stop;
+        std::atomic<uint> m_SleepingWorkers;
+        std::mutex m_SleepMutex;
+        std::condition_variable m_WakeUp;
     };
 } // namespace GfxRenderEngine
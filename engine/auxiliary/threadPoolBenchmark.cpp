@@ -0,0 +1,279 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <future>
+#include <vector>
+
+#include "BS_thread_pool/BS_thread_pool.hpp"
+
+#include "auxiliary/threadPool.h"
+#include "auxiliary/threadPoolBenchmark.h"
+
+namespace GfxRenderEngine
+{
+    namespace
+    {
+        constexpr uint REPETITIONS = 10;
+        constexpr uint TINY_JOBS = 100000;
+        constexpr uint FUTURES = 10000;
+        constexpr uint LOOP_ELEMENTS = 16 * 1024 * 1024;
+        constexpr uint LOOP_GRAIN_SIZE = 16 * 1024;
+        constexpr uint OUTER_TASKS = 64;
+        constexpr uint INNER_ELEMENTS = 64 * 1024;
+        constexpr uint INNER_GRAIN_SIZE = 1024;
+
+        struct Result
+        {
+            std::string m_Name;
+            float m_NewMinMs{0.0f};
+            float m_NewMeanMs{0.0f};
+            float m_OldMinMs{0.0f};
+            float m_OldMeanMs{0.0f};
+            bool m_HasOld{false};
+        };
+
+        // runs the function a few times and returns min and mean in milliseconds
+        void Measure(const std::function<void()>& function, float& minMs, float& meanMs)
+        {
+            function(); // warm-up
+            minMs = std::numeric_limits<float>::max();
+            meanMs = 0.0f;
+            for (uint repetition = 0; repetition < REPETITIONS; ++repetition)
+            {
+                auto start = std::chrono::high_resolution_clock::now();
+                function();
+                std::chrono::duration<float, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+                minMs = std::min(minMs, duration.count());
+                meanMs += duration.count();
+            }
+            meanMs /= REPETITIONS;
+        }
+
+        void Check(bool condition, const std::string& name)
+        {
+            if (!condition)
+            {
+                LOG_CORE_ERROR("ThreadPoolBenchmark: wrong result in {0}", name);
+            }
+        }
+    } // namespace
+
+    bool ThreadPoolBenchmark::Run(const std::string& outputFileName)
+    {
+        uint numThreads = std::max(1u, std::thread::hardware_concurrency());
+        ThreadPool newPool{numThreads};
+        BS::thread_pool oldPool{numThreads};
+        std::vector<Result> results;
+        std::vector<uint> data(LOOP_ELEMENTS, 1);
+
+        { // many tiny fire-and-forget jobs submitted from the main thread
+            Result result{"tinyJobs"};
+            std::atomic<uint> counter{0};
+            Measure(
+                [&]()
+                {
+                    counter = 0;
+                    for (uint job = 0; job < TINY_JOBS; ++job)
+                    {
+                        newPool.Submit([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+                    }
+                    newPool.Wait();
+                    Check(counter == TINY_JOBS, result.m_Name);
+                },
+                result.m_NewMinMs, result.m_NewMeanMs);
+            Measure(
+                [&]()
+                {
+                    counter = 0;
+                    for (uint job = 0; job < TINY_JOBS; ++job)
+                    {
+                        oldPool.detach_task([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+                    }
+                    oldPool.wait();
+                    Check(counter == TINY_JOBS, result.m_Name);
+                },
+                result.m_OldMinMs, result.m_OldMeanMs);
+            result.m_HasOld = true;
+            results.push_back(result);
+        }
+
+        { // futures, as used by the scene loader and the texture loader
+            Result result{"futures"};
+            auto task = [](uint value) { return value * 2; };
+            Measure(
+                [&]()
+                {
+                    std::vector<std::future<uint>> futures(FUTURES);
+                    for (uint index = 0; index < FUTURES; ++index)
+                    {
+                        futures[index] = newPool.SubmitTask([task, index]() { return task(index); });
+                    }
+                    uint64 sum = 0;
+                    for (auto& future : futures)
+                    {
+                        sum += newPool.WaitFor(future);
+                    }
+                    Check(sum == static_cast<uint64>(FUTURES) * (FUTURES - 1), result.m_Name);
+                },
+                result.m_NewMinMs, result.m_NewMeanMs);
+            Measure(
+                [&]()
+                {
+                    std::vector<std::future<uint>> futures(FUTURES);
+                    for (uint index = 0; index < FUTURES; ++index)
+                    {
+                        futures[index] = oldPool.submit_task([task, index]() { return task(index); });
+                    }
+                    uint64 sum = 0;
+                    for (auto& future : futures)
+                    {
+                        sum += future.get();
+                    }
+                    Check(sum == static_cast<uint64>(FUTURES) * (FUTURES - 1), result.m_Name);
+                },
+                result.m_OldMinMs, result.m_OldMeanMs);
+            result.m_HasOld = true;
+            results.push_back(result);
+        }
+
+        { // data-parallel loop with a fixed grain size
+            Result result{"parallelFor"};
+            std::atomic<uint64> sum{0};
+            auto body = [&data, &sum](uint first, uint last)
+            {
+                uint64 partialSum = 0;
+                for (uint index = first; index < last; ++index)
+                {
+                    partialSum += data[index];
+                }
+                sum.fetch_add(partialSum, std::memory_order_relaxed);
+            };
+            Measure(
+                [&]()
+                {
+                    sum = 0;
+                    newPool.ParallelFor(0, LOOP_ELEMENTS, LOOP_GRAIN_SIZE, body);
+                    Check(sum == LOOP_ELEMENTS, result.m_Name);
+                },
+                result.m_NewMinMs, result.m_NewMeanMs);
+            Measure(
+                [&]()
+                {
+                    sum = 0;
+                    oldPool.detach_blocks(0u, LOOP_ELEMENTS, body, LOOP_ELEMENTS / LOOP_GRAIN_SIZE);
+                    oldPool.wait();
+                    Check(sum == LOOP_ELEMENTS, result.m_Name);
+                },
+                result.m_OldMinMs, result.m_OldMeanMs);
+            result.m_HasOld = true;
+            results.push_back(result);
+        }
+
+        { // parallel loops spawned from jobs; the old pool would deadlock waiting inside a job
+            Result result{"nestedParallelFor"};
+            std::atomic<uint64> sum{0};
+            Measure(
+                [&]()
+                {
+                    sum = 0;
+                    newPool.ParallelFor(0, OUTER_TASKS, 1,
+                                        [&](uint, uint)
+                                        {
+                                            newPool.ParallelFor(0, INNER_ELEMENTS, INNER_GRAIN_SIZE,
+                                                                [&](uint first, uint last)
+                                                                {
+                                                                    uint64 partialSum = 0;
+                                                                    for (uint index = first; index < last; ++index)
+                                                                    {
+                                                                        partialSum += data[index];
+                                                                    }
+                                                                    sum.fetch_add(partialSum, std::memory_order_relaxed);
+                                                                });
+                                        });
+                    Check(sum == static_cast<uint64>(OUTER_TASKS) * INNER_ELEMENTS, result.m_Name);
+                },
+                result.m_NewMinMs, result.m_NewMeanMs);
+            results.push_back(result);
+        }
+
+        { // dependency chains: a diamond per iteration
+            Result result{"taskGraph"};
+            std::atomic<uint> counter{0};
+            Measure(
+                [&]()
+                {
+                    counter = 0;
+                    ThreadPool::TaskGroup taskGroup{newPool};
+                    auto increment = [&counter]() { counter.fetch_add(1, std::memory_order_relaxed); };
+                    for (uint diamond = 0; diamond < FUTURES / 4; ++diamond)
+                    {
+                        auto top = taskGroup.Run(increment);
+                        auto left = taskGroup.Run(increment, {top});
+                        auto right = taskGroup.Run(increment, {top});
+                        taskGroup.Run(increment, {left, right});
+                    }
+                    taskGroup.Wait();
+                    Check(counter == (FUTURES / 4) * 4, result.m_Name);
+                },
+                result.m_NewMinMs, result.m_NewMeanMs);
+            results.push_back(result);
+        }
+
+        std::ofstream outputFile(outputFileName);
+        if (!outputFile.is_open())
+        {
+            LOG_CORE_CRITICAL("ThreadPoolBenchmark::Run: could not open {0}", outputFileName);
+            return false;
+        }
+
+        outputFile << "{\n";
+        outputFile << "    \"threads\": " << numThreads << ",\n";
+        outputFile << "    \"repetitions\": " << REPETITIONS << ",\n";
+        outputFile << "    \"cases\": {\n";
+        for (size_t index = 0; index < results.size(); ++index)
+        {
+            auto& result = results[index];
+            outputFile << "        \"" << result.m_Name << "\": { \"workStealing\": { \"minMs\": " << result.m_NewMinMs
+                       << ", \"meanMs\": " << result.m_NewMeanMs << " }";
+            if (result.m_HasOld)
+            {
+                outputFile << ", \"bsThreadPool\": { \"minMs\": " << result.m_OldMinMs
+                           << ", \"meanMs\": " << result.m_OldMeanMs << " }";
+            }
+            outputFile << " }" << ((index + 1 < results.size()) ? ",\n" : "\n");
+
+            LOG_CORE_INFO("thread pool benchmark {0}: {1} ms (BS::thread_pool {2} ms)", result.m_Name,
+                          result.m_NewMinMs, result.m_HasOld ? std::to_string(result.m_OldMinMs) : "n/a");
+        }
+        outputFile << "    }\n";
+        outputFile << "}\n";
+
+        LOG_CORE_INFO("thread pool benchmark report written to {0}", outputFileName);
+        return true;
+    }
+} // namespace GfxRenderEngine
@@ -67,7 +67,12 @@ namespace GfxRenderEngine
             });
     }
 
-    Engine::~Engine() {}
+    Engine::~Engine()
+    {
+        // release cached textures and geometry before the graphics context goes away
+        m_TextureCache.Clear();
+        m_AssetRegistry.Clear();
+    }
 
     bool Engine::Start()
     {
@@ -79,6 +84,7 @@ namespace GfxRenderEngine
         // create main window
         std::string title = "Vulkan Engine v" ENGINE_VERSION;
         WindowProperties windowProperties(title);
+        windowProperties.m_Headless = m_Benchmark.IsHeadless();
         m_Window = Window::Create(windowProperties);
         if (!m_Window->IsOK())
         {
@@ -113,12 +119,19 @@ namespace GfxRenderEngine
 
     void Engine::Shutdown(bool switchOffComputer)
     {
+        // loader threads must not wait for a main loop that is about to end
+        m_LoadingPipeline.Shutdown();
         m_Window->Shutdown();
         m_Running = false;
     }
 
     void Engine::Quit()
     {
+        if (m_Benchmark.IsEnabled())
+        {
+            // a headless run would overwrite the window settings of the user
+            return;
+        }
         // save settings
         m_CoreSettings.m_EngineVersion = ENGINE_VERSION;
         m_CoreSettings.m_EnableFullscreen = IsFullscreen();
@@ -151,6 +164,11 @@ namespace GfxRenderEngine
         auto time = GetTime();
         m_Timestep = time - m_TimeLastFrame;
         m_TimeLastFrame = time;
+        if (m_Benchmark.IsEnabled())
+        {
+            // deterministic simulation, independent of the frame rate
+            m_Timestep = m_Benchmark.GetTimestep();
+        }
 
         if (!m_Window->IsOK())
         {
@@ -167,9 +185,18 @@ namespace GfxRenderEngine
             m_EventQueue.clear();
         }
         m_StartTime = GetTime();
+
+        // merge scenes loaded in the background, bounded per frame
+        m_LoadingPipeline.Update();
     }
 
-    void Engine::PostRender() { m_GraphicsContext->LimitFrameRate(m_StartTime); }
+    void Engine::PostRender()
+    {
+        if (!m_Benchmark.IsEnabled())
+        {
+            m_GraphicsContext->LimitFrameRate(m_StartTime);
+        }
+    }
 
     void Engine::SignalHandler(int signal)
     {
@@ -312,6 +339,11 @@ namespace GfxRenderEngine
         {
             LOG_CORE_INFO("Starting engine (gfxRenderEngine) v" ENGINE_VERSION);
         }
+
+        size_t textureCacheBudget = static_cast<size_t>(std::max(m_CoreSettings.m_TextureCacheBudgetMB, 0)) * 1024 * 1024;
+        m_TextureCache.SetBudget(textureCacheBudget);
+        size_t assetRegistryBudget = static_cast<size_t>(std::max(m_CoreSettings.m_AssetRegistryBudgetMB, 0)) * 1024 * 1024;
+        m_AssetRegistry.SetBudget(assetRegistryBudget);
     }
 
     void Engine::ApplyAppSettings() { m_SettingsManager.ApplySettings(); }
@@ -38,8 +38,12 @@
 #include "layer/layerStack.h"
 #include "renderer/graphicsContext.h"
 #include "auxiliary/threadPool.h"
+#include "auxiliary/benchmark.h"
 #include "renderer/renderer.h"
 #include "renderer/model.h"
+#include "renderer/textureCache.h"
+#include "renderer/assetRegistry.h"
+#include "scene/loadingPipeline.h"
 #include "audio/audio.h"
 
 namespace GfxRenderEngine
@@ -124,6 +128,10 @@ namespace GfxRenderEngine
         CoreSettings m_CoreSettings{&m_SettingsManager};
         ThreadPool m_PoolPrimary;
         ThreadPool m_PoolSecondary;
+        Benchmark m_Benchmark;
+        TextureCache m_TextureCache;
+        AssetRegistry m_AssetRegistry;
+        LoadingPipeline m_LoadingPipeline;
 
     private:
         static void SignalHandler(int signal);
@@ -33,6 +33,25 @@ namespace GfxRenderEngine
     bool CoreSettings::m_EnableSystemSounds;
     std::string CoreSettings::m_BlacklistedDevice;
     int CoreSettings::m_UITheme;
+    int CoreSettings::m_TextureCacheBudgetMB;
+    int CoreSettings::m_AssetRegistryBudgetMB;
+    bool CoreSettings::m_TranscodeTextures;
+    bool CoreSettings::m_TextureStreaming;
+    int CoreSettings::m_TextureStreamingBudgetMB;
+    int CoreSettings::m_TextureStreamingUploadMB;
+    bool CoreSettings::m_BindlessMaterials;
+    bool CoreSettings::m_ComputeBloom;
+    int CoreSettings::m_BloomMipLevels;
+    int CoreSettings::m_ShadowCascades;
+    int CoreSettings::m_ShadowDistance;
+    bool CoreSettings::m_OcclusionCulling;
+    bool CoreSettings::m_MeshLod;
+    int CoreSettings::m_LodErrorPixels;
+    bool CoreSettings::m_Impostors;
+    int CoreSettings::m_ImpostorDistance;
+    bool CoreSettings::m_DynamicResolution;
+    int CoreSettings::m_TargetFrameTimeMs;
+    int CoreSettings::m_MinRenderScale;
 
     void CoreSettings::InitDefaults()
     {
@@ -42,6 +61,25 @@ namespace GfxRenderEngine
         m_EnableSystemSounds = true;
         m_BlacklistedDevice = "empty";
         m_UITheme = THEME_RETRO;
+        m_TextureCacheBudgetMB = 2048; // 0: unlimited
+        m_AssetRegistryBudgetMB = 1024; // 0: unlimited
+        m_TranscodeTextures = false;
+        m_TextureStreaming = true;
+        m_TextureStreamingBudgetMB = 1024; // 0: unlimited
+        m_TextureStreamingUploadMB = 16;
+        m_BindlessMaterials = true;
+        m_ComputeBloom = true;
+        m_BloomMipLevels = 4;
+        m_ShadowCascades = 4;
+        m_ShadowDistance = 100;
+        m_OcclusionCulling = true;
+        m_MeshLod = true;
+        m_LodErrorPixels = 1;
+        m_Impostors = true;
+        m_ImpostorDistance = 150;
+        m_DynamicResolution = true;
+        m_TargetFrameTimeMs = 16;
+        m_MinRenderScale = 50;
     }
 
     void CoreSettings::RegisterSettings()
@@ -52,6 +90,25 @@ namespace GfxRenderEngine
         m_SettingsManager->PushSetting<bool>("EnableSystemSounds", &m_EnableSystemSounds);
         m_SettingsManager->PushSetting<std::string>("BlacklstedDevice", &m_BlacklistedDevice);
         m_SettingsManager->PushSetting<int>("UITheme", &m_UITheme);
+        m_SettingsManager->PushSetting<int>("TextureCacheBudgetMB", &m_TextureCacheBudgetMB);
+        m_SettingsManager->PushSetting<int>("AssetRegistryBudgetMB", &m_AssetRegistryBudgetMB);
+        m_SettingsManager->PushSetting<bool>("TranscodeTextures", &m_TranscodeTextures);
+        m_SettingsManager->PushSetting<bool>("TextureStreaming", &m_TextureStreaming);
+        m_SettingsManager->PushSetting<int>("TextureStreamingBudgetMB", &m_TextureStreamingBudgetMB);
+        m_SettingsManager->PushSetting<int>("TextureStreamingUploadMB", &m_TextureStreamingUploadMB);
+        m_SettingsManager->PushSetting<bool>("BindlessMaterials", &m_BindlessMaterials);
+        m_SettingsManager->PushSetting<bool>("ComputeBloom", &m_ComputeBloom);
+        m_SettingsManager->PushSetting<int>("BloomMipLevels", &m_BloomMipLevels);
+        m_SettingsManager->PushSetting<int>("ShadowCascades", &m_ShadowCascades);
+        m_SettingsManager->PushSetting<int>("ShadowDistance", &m_ShadowDistance);
+        m_SettingsManager->PushSetting<bool>("OcclusionCulling", &m_OcclusionCulling);
+        m_SettingsManager->PushSetting<bool>("MeshLod", &m_MeshLod);
+        m_SettingsManager->PushSetting<int>("LodErrorPixels", &m_LodErrorPixels);
+        m_SettingsManager->PushSetting<bool>("Impostors", &m_Impostors);
+        m_SettingsManager->PushSetting<int>("ImpostorDistance", &m_ImpostorDistance);
+        m_SettingsManager->PushSetting<bool>("DynamicResolution", &m_DynamicResolution);
+        m_SettingsManager->PushSetting<int>("TargetFrameTimeMs", &m_TargetFrameTimeMs);
+        m_SettingsManager->PushSetting<int>("MinRenderScale", &m_MinRenderScale);
     }
 
     void CoreSettings::PrintSettings() const
@@ -62,5 +119,24 @@ namespace GfxRenderEngine
         LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "EnableSystemSounds", m_EnableSystemSounds);
         LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "BlacklistedDevice", m_BlacklistedDevice);
         LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "UITheme", m_UITheme);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "TextureCacheBudgetMB", m_TextureCacheBudgetMB);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "AssetRegistryBudgetMB", m_AssetRegistryBudgetMB);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "TranscodeTextures", m_TranscodeTextures);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "TextureStreaming", m_TextureStreaming);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "TextureStreamingBudgetMB", m_TextureStreamingBudgetMB);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "TextureStreamingUploadMB", m_TextureStreamingUploadMB);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "BindlessMaterials", m_BindlessMaterials);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "ComputeBloom", m_ComputeBloom);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "BloomMipLevels", m_BloomMipLevels);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "ShadowCascades", m_ShadowCascades);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "ShadowDistance", m_ShadowDistance);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "OcclusionCulling", m_OcclusionCulling);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "MeshLod", m_MeshLod);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "LodErrorPixels", m_LodErrorPixels);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "Impostors", m_Impostors);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "ImpostorDistance", m_ImpostorDistance);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "DynamicResolution", m_DynamicResolution);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "TargetFrameTimeMs", m_TargetFrameTimeMs);
+        LOG_CORE_INFO("CoreSettings: key '{0}', value is {1}", "MinRenderScale", m_MinRenderScale);
     }
 } // namespace GfxRenderEngine
@@ -46,6 +46,25 @@ namespace GfxRenderEngine
         static bool m_EnableSystemSounds;
         static std::string m_BlacklistedDevice;
         static int m_UITheme;
+        static int m_TextureCacheBudgetMB;
+        static int m_AssetRegistryBudgetMB;
+        static bool m_TranscodeTextures; // encode PNG/JPEG into block-compressed KTX2 on import
+        static bool m_TextureStreaming;  // stream mip levels of KTX2/DDS textures by on-screen size
+        static int m_TextureStreamingBudgetMB;
+        static int m_TextureStreamingUploadMB; // per frame
+        static bool m_BindlessMaterials;       // requires descriptor indexing, otherwise one descriptor set per material
+        static bool m_ComputeBloom;            // compute shader bloom, otherwise one render pass per mip level
+        static int m_BloomMipLevels;           // including level 0, clamped to [2, BLOOM_MAX_MIP_LEVELS]
+        static int m_ShadowCascades;           // clamped to [1, MAX_SHADOW_CASCADES]
+        static int m_ShadowDistance;           // in world units from the camera, covered by the shadow cascades
+        static bool m_OcclusionCulling;        // GPU culling against the depth of the previous frame, two phases
+        static bool m_MeshLod;                 // select a level of detail per instance by its projected error
+        static int m_LodErrorPixels;           // largest projected error of a level of detail
+        static bool m_Impostors;               // draw distant instances of instanced models as baked impostors
+        static int m_ImpostorDistance;         // metres from the camera where impostors replace the mesh
+        static bool m_DynamicResolution;       // scale the 3D pass resolution to meet m_TargetFrameTimeMs
+        static int m_TargetFrameTimeMs;        // GPU frame time the dynamic resolution aims for
+        static int m_MinRenderScale;           // in percent of the output resolution
 
     private:
         SettingsManager* m_SettingsManager;
@@ -26,6 +26,7 @@
 #include "core.h"
 #include "engine.h"
 #include "application.h"
+#include "auxiliary/threadPoolBenchmark.h"
 
 using Profiler = GfxRenderEngine::Instrumentation::Profiler;
 // global logger for the engine and application
@@ -44,6 +45,14 @@ int engine(int argc, char* argv[])
     {
         PROFILE_SCOPE("engine startup");
         engine = std::make_unique<GfxRenderEngine::Engine>("./");
+        if (!engine->m_Benchmark.ParseCommandLine(argc, argv))
+        {
+            return -1;
+        }
+        if (engine->m_Benchmark.IsThreadPoolBenchmark())
+        {
+            return GfxRenderEngine::ThreadPoolBenchmark::Run(engine->m_Benchmark.GetSettings().m_OutputFile) ? 0 : -1;
+        }
 
         if (!engine->Start())
         {
@@ -71,8 +80,10 @@ int engine(int argc, char* argv[])
     }
 
     LOG_CORE_INFO("entering main application");
+    auto& benchmark = engine->m_Benchmark;
     while (engine->IsRunning())
     {
+        benchmark.BeginFrame();
         {
             {
                 PROFILE_SCOPE("engine->OnUpdate()");
@@ -83,8 +94,18 @@ int engine(int argc, char* argv[])
                 {
                     PROFILE_SCOPE("application->OnUpdate()");
                     ZoneScopedN("application->OnUpdate");
+                    auto startTime = engine->GetTime();
                     application->OnUpdate(engine->GetTimestep());
+                    auto scriptsStartTime = engine->GetTime();
                     engine->RunScripts(application.get());
+                    auto endTime = engine->GetTime();
+                    if (benchmark.IsRunning())
+                    {
+                        std::chrono::duration<float, std::milli> applicationTime = scriptsStartTime - startTime;
+                        std::chrono::duration<float, std::milli> scriptsTime = endTime - scriptsStartTime;
+                        benchmark.AddCpuTime("application", applicationTime.count());
+                        benchmark.AddCpuTime("scripts", scriptsTime.count());
+                    }
                 }
                 {
                     ZoneScopedN("engine->PostRender()");
@@ -96,8 +117,14 @@ int engine(int argc, char* argv[])
                 std::this_thread::sleep_for(16ms);
             }
         }
+        benchmark.EndFrame(engine->GetRenderer()->GetRenderStatistics());
+        if (benchmark.IsFinished() && engine->IsRunning())
+        {
+            engine->Shutdown();
+        }
         FrameMark;
     }
+    benchmark.WriteReport();
 
     application->Shutdown();
     engine->Shutdown();
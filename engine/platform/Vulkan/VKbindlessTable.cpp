@@ -0,0 +1,269 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+
+#include "auxiliary/hash.h"
+#include "engine/platform/Vulkan/material.h"
+
+#include "VKcore.h"
+#include "VKbindlessTable.h"
+#include "VKtexture.h"
+
+namespace GfxRenderEngine
+{
+    namespace
+    {
+        constexpr uint MATERIAL_BINDING = 0;
+        constexpr uint TEXTURE_BINDING = 1;
+    } // namespace
+
+    static_assert(sizeof(VK_BindlessTable::MaterialRecord) % 16 == 0, "std430 array stride");
+    static_assert(Material::DIFFUSE_MAP_INDEX == GLSL_DIFFUSE_MAP_INDEX);
+    static_assert(Material::NORMAL_MAP_INDEX == GLSL_NORMAL_MAP_INDEX);
+    static_assert(Material::ROUGHNESS_MAP_INDEX == GLSL_ROUGHNESS_MAP_INDEX);
+    static_assert(Material::METALLIC_MAP_INDEX == GLSL_METALLIC_MAP_INDEX);
+    static_assert(Material::ROUGHNESS_METALLIC_MAP_INDEX == GLSL_ROUGHNESS_METALLIC_MAP_INDEX);
+    static_assert(Material::EMISSIVE_MAP_INDEX == GLSL_EMISSIVE_MAP_INDEX);
+
+    VK_BindlessTable::VK_BindlessTable(std::shared_ptr<Texture> const& defaultTexture, uint maxTextures)
+        : m_MaxTextures{std::min(maxTextures, MAX_TEXTURES)}
+    {
+        m_DescriptorSetLayout =
+            VK_DescriptorSetLayout::Builder()
+                .AddBinding(MATERIAL_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT)
+                .AddBinding(TEXTURE_BINDING, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT,
+                            m_MaxTextures)
+                .SetBindingFlags(TEXTURE_BINDING, VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                                                      VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                                      VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT)
+                .Build();
+
+        m_DescriptorPool = VK_DescriptorPool::Builder(VK_Core::m_Device->Device())
+                               .AddPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1)
+                               .AddPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_MaxTextures)
+                               .SetPoolFlags(VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT)
+                               .SetMaxSets(1)
+                               .Build();
+        m_DescriptorPool->AllocateDescriptorSet(m_DescriptorSetLayout->GetDescriptorSetLayout(), m_DescriptorSet);
+
+        // materials are written once when acquired and only read by the GPU afterwards
+        m_MaterialBuffer =
+            std::make_unique<VK_Buffer>(sizeof(MaterialRecord), MAX_MATERIALS, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        m_MaterialBuffer->Map();
+        {
+            VkDescriptorBufferInfo bufferInfo = m_MaterialBuffer->DescriptorInfo();
+            VkWriteDescriptorSet write{};
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.dstSet = m_DescriptorSet;
+            write.dstBinding = MATERIAL_BINDING;
+            write.descriptorCount = 1;
+            write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            write.pBufferInfo = &bufferInfo;
+            vkUpdateDescriptorSets(VK_Core::m_Device->Device(), 1, &write, 0, nullptr);
+        }
+
+        // the default texture and the default material are never released
+        m_Textures.resize(m_MaxTextures);
+        for (uint textureIndex = m_MaxTextures - 1; textureIndex > DEFAULT_TEXTURE; --textureIndex)
+        {
+            m_FreeTextures.push_back(textureIndex);
+        }
+        m_Textures[DEFAULT_TEXTURE] = {defaultTexture, 1};
+        m_TextureIndices[defaultTexture.get()] = DEFAULT_TEXTURE;
+        WriteTexture(DEFAULT_TEXTURE, static_cast<VK_Texture*>(defaultTexture.get()));
+
+        m_Materials.push_back({0, 1, {}});
+        WriteMaterial(DEFAULT_MATERIAL, Material::PbrMaterial{});
+    }
+
+    VK_BindlessTable::~VK_BindlessTable()
+    {
+        // textures may outlive the table, streaming must not write to the destroyed set
+        for (uint textureIndex = 0; textureIndex < m_Textures.size(); ++textureIndex)
+        {
+            if (m_Textures[textureIndex].m_Texture)
+            {
+                static_cast<VK_Texture*>(m_Textures[textureIndex].m_Texture.get())
+                    ->RemoveDescriptorUser(m_DescriptorSet, TEXTURE_BINDING, textureIndex);
+            }
+        }
+    }
+
+    size_t VK_BindlessTable::GetKey(Material const& material)
+    {
+        // the padding at the end of PbrMaterial is not initialized
+        size_t key = 0;
+        HashCombine(key, std::string_view(reinterpret_cast<char const*>(&material.m_PbrMaterial),
+                                          offsetof(Material::PbrMaterial, m_Spare4)));
+        for (auto& texture : material.m_MaterialTextures)
+        {
+            // file names survive a scene reload, texture objects may not
+            std::string const& filename = texture ? static_cast<VK_Texture*>(texture.get())->GetFilename() : "";
+            if (!filename.empty())
+            {
+                HashCombine(key, filename);
+            }
+            else
+            {
+                HashCombine(key, static_cast<void*>(texture.get()));
+            }
+        }
+        return key;
+    }
+
+    uint VK_BindlessTable::AcquireMaterial(Material const& material)
+    {
+        size_t key = GetKey(material);
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        uint materialIndex;
+        auto iterator = m_MaterialIndices.find(key);
+        if (iterator != m_MaterialIndices.end())
+        {
+            materialIndex = iterator->second;
+            if (m_Materials[materialIndex].m_References++)
+            {
+                return materialIndex; // still in use
+            }
+            m_ReleasedMaterials.erase(
+                std::find(m_ReleasedMaterials.begin(), m_ReleasedMaterials.end(), materialIndex));
+        }
+        else
+        {
+            if (m_Materials.size() < MAX_MATERIALS)
+            {
+                materialIndex = static_cast<uint>(m_Materials.size());
+                m_Materials.emplace_back();
+            }
+            else if (!m_ReleasedMaterials.empty())
+            {
+                materialIndex = m_ReleasedMaterials.front();
+                m_ReleasedMaterials.pop_front();
+                m_MaterialIndices.erase(m_Materials[materialIndex].m_Key);
+            }
+            else
+            {
+                LOG_CORE_WARN("VK_BindlessTable::AcquireMaterial: all {0} materials in use", MAX_MATERIALS);
+                return DEFAULT_MATERIAL;
+            }
+            m_MaterialIndices[key] = materialIndex;
+            m_Materials[materialIndex] = {key, 1, {}};
+        }
+
+        // (re)acquire the textures, they are released while the material is not referenced
+        MaterialSlot& materialSlot = m_Materials[materialIndex];
+        for (uint index = 0; index < Material::NUM_TEXTURES; ++index)
+        {
+            auto& texture = material.m_MaterialTextures[index];
+            materialSlot.m_TextureIndices[index] = texture ? AcquireTexture(texture) : DEFAULT_TEXTURE;
+        }
+        WriteMaterial(materialIndex, material.m_PbrMaterial);
+        return materialIndex;
+    }
+
+    void VK_BindlessTable::ReleaseMaterial(uint materialIndex)
+    {
+        if (materialIndex == DEFAULT_MATERIAL)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        MaterialSlot& materialSlot = m_Materials[materialIndex];
+        CORE_ASSERT(materialSlot.m_References, "VK_BindlessTable::ReleaseMaterial: material not acquired");
+        if (--materialSlot.m_References)
+        {
+            return;
+        }
+        for (auto textureIndex : materialSlot.m_TextureIndices)
+        {
+            ReleaseTexture(textureIndex);
+        }
+        m_ReleasedMaterials.push_back(materialIndex);
+    }
+
+    void VK_BindlessTable::WriteMaterial(uint materialIndex, Material::PbrMaterial const& pbrMaterial)
+    {
+        MaterialRecord record{pbrMaterial, m_Materials[materialIndex].m_TextureIndices, 0, 0};
+        m_MaterialBuffer->WriteToIndex(&record, materialIndex);
+    }
+
+    uint VK_BindlessTable::AcquireTexture(std::shared_ptr<Texture> const& texture)
+    {
+        auto iterator = m_TextureIndices.find(texture.get());
+        if (iterator != m_TextureIndices.end())
+        {
+            ++m_Textures[iterator->second].m_References;
+            return iterator->second;
+        }
+        if (m_FreeTextures.empty())
+        {
+            LOG_CORE_WARN("VK_BindlessTable::AcquireTexture: all {0} textures in use", m_MaxTextures);
+            return DEFAULT_TEXTURE;
+        }
+        uint textureIndex = m_FreeTextures.back();
+        m_FreeTextures.pop_back();
+        m_Textures[textureIndex] = {texture, 1};
+        m_TextureIndices[texture.get()] = textureIndex;
+
+        VK_Texture* vkTexture = static_cast<VK_Texture*>(texture.get());
+        WriteTexture(textureIndex, vkTexture);
+        vkTexture->AddDescriptorUser(m_DescriptorSet, TEXTURE_BINDING, textureIndex);
+        return textureIndex;
+    }
+
+    void VK_BindlessTable::ReleaseTexture(uint textureIndex)
+    {
+        if (textureIndex == DEFAULT_TEXTURE)
+        {
+            return;
+        }
+        TextureSlot& textureSlot = m_Textures[textureIndex];
+        if (--textureSlot.m_References)
+        {
+            return;
+        }
+        VK_Texture* vkTexture = static_cast<VK_Texture*>(textureSlot.m_Texture.get());
+        vkTexture->RemoveDescriptorUser(m_DescriptorSet, TEXTURE_BINDING, textureIndex);
+        // the slot must not keep the image view of a texture that may be destroyed
+        WriteTexture(textureIndex, static_cast<VK_Texture*>(m_Textures[DEFAULT_TEXTURE].m_Texture.get()));
+        m_TextureIndices.erase(vkTexture);
+        textureSlot.m_Texture.reset();
+        m_FreeTextures.push_back(textureIndex);
+    }
+
+    void VK_BindlessTable::WriteTexture(uint textureIndex, VK_Texture* texture)
+    {
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = m_DescriptorSet;
+        write.dstBinding = TEXTURE_BINDING;
+        write.dstArrayElement = textureIndex;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo = &texture->GetDescriptorImageInfo();
+        vkUpdateDescriptorSets(VK_Core::m_Device->Device(), 1, &write, 0, nullptr);
+    }
+} // namespace GfxRenderEngine
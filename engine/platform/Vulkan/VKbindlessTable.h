@@ -0,0 +1,118 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+#include "scene/material.h"
+
+#include "VKbuffer.h"
+#include "VKdescriptor.h"
+
+namespace GfxRenderEngine
+{
+    class Texture;
+    class VK_Texture;
+
+    // Bindless materials: one descriptor set with all material textures in a single array
+    // and all pbr materials in a storage buffer. Draws select their material with an index.
+    // Indices are keyed by material content, a material released with its scene
+    // keeps its index until the table runs out of slots, so reloading a scene
+    // finds its materials at the same indices.
+    class VK_BindlessTable
+    {
+    public:
+        static constexpr uint MAX_MATERIALS = 4096;
+        static constexpr uint MAX_TEXTURES = 4096;
+        static constexpr uint DEFAULT_MATERIAL = 0; // plain pbr material without textures
+        static constexpr uint DEFAULT_TEXTURE = 0;  // bound where a material has no texture
+
+        // std430 layout of the material buffer, see pbrBindless.frag
+        struct MaterialRecord
+        {
+            Material::PbrMaterial m_PbrMaterial;
+            std::array<uint, Material::NUM_TEXTURES> m_TextureIndices;
+            uint m_Spare0; // padding
+            uint m_Spare1; // padding
+        };
+
+    public:
+        VK_BindlessTable(std::shared_ptr<Texture> const& defaultTexture, uint maxTextures);
+        ~VK_BindlessTable();
+
+        VK_BindlessTable(const VK_BindlessTable&) = delete;
+        VK_BindlessTable& operator=(const VK_BindlessTable&) = delete;
+
+        // thread-safe, models are loaded on worker threads
+        uint AcquireMaterial(Material const& material);
+        void ReleaseMaterial(uint materialIndex);
+
+        VkDescriptorSet GetDescriptorSet() const { return m_DescriptorSet; }
+        VkDescriptorSetLayout GetDescriptorSetLayout() const { return m_DescriptorSetLayout->GetDescriptorSetLayout(); }
+
+    private:
+        struct MaterialSlot
+        {
+            size_t m_Key{0};
+            uint m_References{0};
+            std::array<uint, Material::NUM_TEXTURES> m_TextureIndices{};
+        };
+
+        struct TextureSlot
+        {
+            std::shared_ptr<Texture> m_Texture;
+            uint m_References{0};
+        };
+
+    private:
+        static size_t GetKey(Material const& material);
+        void WriteMaterial(uint materialIndex, Material::PbrMaterial const& pbrMaterial);
+        uint AcquireTexture(std::shared_ptr<Texture> const& texture);
+        void ReleaseTexture(uint textureIndex);
+        void WriteTexture(uint textureIndex, VK_Texture* texture);
+
+    private:
+        std::mutex m_Mutex;
+        uint m_MaxTextures;
+
+        std::unique_ptr<VK_DescriptorSetLayout> m_DescriptorSetLayout;
+        std::unique_ptr<VK_DescriptorPool> m_DescriptorPool;
+        VkDescriptorSet m_DescriptorSet{VK_NULL_HANDLE};
+        std::unique_ptr<VK_Buffer> m_MaterialBuffer;
+
+        std::vector<MaterialSlot> m_Materials;
+        std::unordered_map<size_t, uint> m_MaterialIndices;
+        std::deque<uint> m_ReleasedMaterials; // unreferenced, least recently released first
+
+        std::vector<TextureSlot> m_Textures;
+        std::unordered_map<Texture*, uint> m_TextureIndices;
+        std::vector<uint> m_FreeTextures;
+    };
+} // namespace GfxRenderEngine
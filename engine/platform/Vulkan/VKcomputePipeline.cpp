@@ -0,0 +1,77 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include "VKcomputePipeline.h"
+#include "VKpipeline.h"
+
+namespace GfxRenderEngine
+{
+    VK_ComputePipeline::VK_ComputePipeline(VK_Device* device, const std::string& filePathComputeShader_SPV,
+                                           VkPipelineLayout pipelineLayout, const VkSpecializationInfo* specialization)
+        : m_Device(device)
+    {
+        ASSERT(pipelineLayout != nullptr);
+
+        auto computeCode = VK_Pipeline::readFile(filePathComputeShader_SPV);
+        CORE_ASSERT(computeCode.size(), "compute shader code size is zero");
+
+        VkShaderModuleCreateInfo moduleInfo{};
+        moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        moduleInfo.codeSize = computeCode.size();
+        moduleInfo.pCode = reinterpret_cast<const uint*>(computeCode.data());
+        if (vkCreateShaderModule(m_Device->Device(), &moduleInfo, nullptr, &m_ComputeShaderModule) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to create shader module");
+        }
+
+        VkPipelineShaderStageCreateInfo shaderStage{};
+        shaderStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shaderStage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        shaderStage.module = m_ComputeShaderModule;
+        shaderStage.pName = "main";
+        shaderStage.pSpecializationInfo = specialization;
+
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage = shaderStage;
+        pipelineInfo.layout = pipelineLayout;
+        pipelineInfo.basePipelineIndex = -1;
+        pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+        if (vkCreateComputePipelines(m_Device->Device(), m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr,
+                                     &m_ComputePipeline) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to create compute pipeline");
+        }
+    }
+
+    VK_ComputePipeline::~VK_ComputePipeline()
+    {
+        vkDestroyShaderModule(m_Device->Device(), m_ComputeShaderModule, nullptr);
+        vkDestroyPipeline(m_Device->Device(), m_ComputePipeline, nullptr);
+    }
+
+    void VK_ComputePipeline::Bind(VkCommandBuffer commandBuffer)
+    {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_ComputePipeline);
+    }
+} // namespace GfxRenderEngine
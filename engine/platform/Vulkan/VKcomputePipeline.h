@@ -0,0 +1,51 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <string>
+
+#include "engine.h"
+
+#include "VKdevice.h"
+
+namespace GfxRenderEngine
+{
+    class VK_ComputePipeline
+    {
+
+    public:
+        VK_ComputePipeline(VK_Device* device, const std::string& filePathComputeShader_SPV, VkPipelineLayout pipelineLayout,
+                           const VkSpecializationInfo* specialization = nullptr);
+        ~VK_ComputePipeline();
+
+        VK_ComputePipeline(const VK_ComputePipeline&) = delete;
+        VK_ComputePipeline& operator=(const VK_ComputePipeline&) = delete;
+
+        void Bind(VkCommandBuffer commandBuffer);
+
+    private:
+        VK_Device* m_Device;
+        VkPipeline m_ComputePipeline{nullptr};
+        VkShaderModule m_ComputeShaderModule{nullptr};
+    };
+} // namespace GfxRenderEngine
@@ -46,24 +46,48 @@ namespace GfxRenderEngine
         return *this;
     }
 
+    VK_DescriptorSetLayout::Builder& VK_DescriptorSetLayout::Builder::SetBindingFlags(uint binding,
+                                                                                      VkDescriptorBindingFlags flags)
+    {
+        ASSERT(m_Bindings.count(binding) == 1); // binding must be added first
+        m_BindingFlags[binding] = flags;
+        return *this;
+    }
+
     std::unique_ptr<VK_DescriptorSetLayout> VK_DescriptorSetLayout::Builder::Build() const
     {
-        return std::make_unique<VK_DescriptorSetLayout>(m_Bindings);
+        return std::make_unique<VK_DescriptorSetLayout>(m_Bindings, m_BindingFlags);
     }
 
     // *************** Descriptor Set Layout *********************
 
-    VK_DescriptorSetLayout::VK_DescriptorSetLayout(std::unordered_map<uint, VkDescriptorSetLayoutBinding> bindings)
+    VK_DescriptorSetLayout::VK_DescriptorSetLayout(std::unordered_map<uint, VkDescriptorSetLayoutBinding> bindings,
+                                                   std::unordered_map<uint, VkDescriptorBindingFlags> const& bindingFlags)
         : m_Bindings{bindings}
     {
         std::vector<VkDescriptorSetLayoutBinding> setLayoutBindings{};
+        std::vector<VkDescriptorBindingFlags> setLayoutBindingFlags{};
+        VkDescriptorSetLayoutCreateFlags layoutFlags{0};
         for (auto kv : bindings)
         {
             setLayoutBindings.push_back(kv.second);
+            auto flags = bindingFlags.find(kv.first);
+            setLayoutBindingFlags.push_back(flags != bindingFlags.end() ? flags->second : 0);
+            if (setLayoutBindingFlags.back() & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT)
+            {
+                layoutFlags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+            }
         }
 
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+        bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        bindingFlagsInfo.bindingCount = static_cast<uint>(setLayoutBindingFlags.size());
+        bindingFlagsInfo.pBindingFlags = setLayoutBindingFlags.data();
+
         VkDescriptorSetLayoutCreateInfo descriptorSetLayoutInfo{};
         descriptorSetLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        descriptorSetLayoutInfo.pNext = bindingFlags.empty() ? nullptr : &bindingFlagsInfo;
+        descriptorSetLayoutInfo.flags = layoutFlags;
         descriptorSetLayoutInfo.bindingCount = static_cast<uint>(setLayoutBindings.size());
         descriptorSetLayoutInfo.pBindings = setLayoutBindings.data();
 
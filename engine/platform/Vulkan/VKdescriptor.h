@@ -43,16 +43,20 @@ namespace GfxRenderEngine
 
             Builder& AddBinding(uint binding, VkDescriptorType descriptorType, VkShaderStageFlags stageFlags,
                                 uint count = 1);
+            // descriptor indexing, e.g. partially bound or update-after-bind bindings
+            Builder& SetBindingFlags(uint binding, VkDescriptorBindingFlags flags);
 
             size_t Size() const { return m_Bindings.size(); }
             std::unique_ptr<VK_DescriptorSetLayout> Build() const;
 
         private:
             std::unordered_map<uint, VkDescriptorSetLayoutBinding> m_Bindings;
+            std::unordered_map<uint, VkDescriptorBindingFlags> m_BindingFlags;
         };
 
     public:
-        VK_DescriptorSetLayout(std::unordered_map<uint, VkDescriptorSetLayoutBinding> bindings);
+        VK_DescriptorSetLayout(std::unordered_map<uint, VkDescriptorSetLayoutBinding> bindings,
+                               std::unordered_map<uint, VkDescriptorBindingFlags> const& bindingFlags = {});
         ~VK_DescriptorSetLayout();
 
         VK_DescriptorSetLayout(const VK_DescriptorSetLayout&) = delete;
@@ -20,7 +20,9 @@
    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
+#include <algorithm>
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <set>
 #include <unordered_set>
@@ -83,12 +85,16 @@ namespace GfxRenderEngine
         PickPhysicalDevice();
         CreateLogicalDevice();
         CreateCommandPool();
-        m_LoadPool = std::make_unique<VK_Pool>(m_Device, m_QueueFamilyIndices, threadPoolPrimary, threadPoolSecondary);
+        CreatePipelineCache();
+        m_LoadPool = std::make_unique<VK_Pool>(m_Device, m_QueueFamilyIndices, threadPoolPrimary, threadPoolSecondary,
+                                               m_DescriptorIndexing);
     }
 
     VK_Device::~VK_Device()
     {
         m_LoadPool.reset();
+        SavePipelineCache();
+        vkDestroyPipelineCache(m_Device, m_PipelineCache, nullptr);
         vkDestroyCommandPool(m_Device, m_GraphicsCommandPool, nullptr);
         vkDestroyDevice(m_Device, nullptr);
 
@@ -101,6 +107,43 @@ namespace GfxRenderEngine
         vkDestroyInstance(m_Instance, nullptr);
     }
 
+    void VK_Device::CreatePipelineCache()
+    {
+        // the driver validates the header and ignores data of another device or driver version
+        std::vector<char> cacheData;
+        std::ifstream file(PIPELINE_CACHE_FILE, std::ios::ate | std::ios::binary);
+        if (file.is_open())
+        {
+            cacheData.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(cacheData.data(), cacheData.size());
+        }
+
+        VkPipelineCacheCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.initialDataSize = cacheData.size();
+        createInfo.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
+        if (vkCreatePipelineCache(m_Device, &createInfo, nullptr, &m_PipelineCache) != VK_SUCCESS)
+        {
+            LOG_CORE_WARN("failed to create pipeline cache");
+        }
+    }
+
+    void VK_Device::SavePipelineCache()
+    {
+        size_t cacheSize = 0;
+        if (!m_PipelineCache || (vkGetPipelineCacheData(m_Device, m_PipelineCache, &cacheSize, nullptr) != VK_SUCCESS))
+        {
+            return;
+        }
+        std::vector<char> cacheData(cacheSize);
+        if (vkGetPipelineCacheData(m_Device, m_PipelineCache, &cacheSize, cacheData.data()) == VK_SUCCESS)
+        {
+            std::ofstream file(PIPELINE_CACHE_FILE, std::ios::binary | std::ios::trunc);
+            file.write(cacheData.data(), cacheSize);
+        }
+    }
+
     void VK_Device::Shutdown()
     {
         vkQueueWaitIdle(m_GraphicsQueue);
@@ -244,8 +287,57 @@ namespace GfxRenderEngine
         physicalDeviceVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
         physicalDeviceVulkan12Features.timelineSemaphore = VK_TRUE;
 
+        // descriptor indexing is optional, bindless materials fall back to one descriptor set per material
+        {
+            VkPhysicalDeviceVulkan12Features supported12Features{};
+            supported12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+            VkPhysicalDeviceFeatures2 supportedFeatures2{};
+            supportedFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            supportedFeatures2.pNext = &supported12Features;
+            vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &supportedFeatures2);
+
+            VkPhysicalDeviceVulkan12Properties properties12{};
+            properties12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+            VkPhysicalDeviceProperties2 properties2{};
+            properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+            properties2.pNext = &properties12;
+            vkGetPhysicalDeviceProperties2(m_PhysicalDevice, &properties2);
+
+            m_DescriptorIndexing = supported12Features.descriptorIndexing &&
+                                   supported12Features.runtimeDescriptorArray &&
+                                   supported12Features.shaderSampledImageArrayNonUniformIndexing &&
+                                   supported12Features.descriptorBindingPartiallyBound &&
+                                   supported12Features.descriptorBindingSampledImageUpdateAfterBind &&
+                                   supported12Features.descriptorBindingUpdateUnusedWhilePending;
+            if (m_DescriptorIndexing)
+            {
+                physicalDeviceVulkan12Features.descriptorIndexing = VK_TRUE;
+                physicalDeviceVulkan12Features.runtimeDescriptorArray = VK_TRUE;
+                physicalDeviceVulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+                physicalDeviceVulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+                physicalDeviceVulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+                physicalDeviceVulkan12Features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+                m_MaxBindlessTextures = std::min(properties12.maxPerStageDescriptorUpdateAfterBindSamplers,
+                                                 properties12.maxDescriptorSetUpdateAfterBindSampledImages);
+            }
+            LOG_CORE_INFO("descriptor indexing supported: {0}, max bindless textures: {1}", m_DescriptorIndexing,
+                          m_MaxBindlessTextures);
+        }
+
+        // block-compressed texture formats are optional
+        VkPhysicalDeviceFeatures supportedFeatures;
+        vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &supportedFeatures);
+
         VkPhysicalDeviceFeatures deviceFeatures = {};
         deviceFeatures.samplerAnisotropy = VK_TRUE;
+        deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+        deviceFeatures.textureCompressionETC2 = supportedFeatures.textureCompressionETC2;
+        deviceFeatures.textureCompressionASTC_LDR = supportedFeatures.textureCompressionASTC_LDR;
+        // GPU occlusion culling writes one indirect draw command per instance
+        m_MultiDrawIndirect = supportedFeatures.multiDrawIndirect && supportedFeatures.drawIndirectFirstInstance;
+        deviceFeatures.multiDrawIndirect = m_MultiDrawIndirect ? VK_TRUE : VK_FALSE;
+        deviceFeatures.drawIndirectFirstInstance = m_MultiDrawIndirect ? VK_TRUE : VK_FALSE;
+        m_EnabledFeatures = deviceFeatures;
 
         VkDeviceCreateInfo createInfo = {};
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -84,16 +84,23 @@ namespace GfxRenderEngine
                                  VkDeviceMemory& imageMemory);
 
         VkPhysicalDeviceProperties m_Properties;
+        VkPhysicalDeviceFeatures m_EnabledFeatures{};
+        bool m_DescriptorIndexing{false}; // runtime-sized, partially bound, update-after-bind texture arrays
+        uint m_MaxBindlessTextures{0};
+        bool m_MultiDrawIndirect{false}; // indirect draws with several commands and a first instance, see occlusion culling
         VkSampleCountFlagBits m_SampleCountFlagBits;
 
         VkInstance GetInstance() const { return m_Instance; }
         bool MultiThreadingSupport() const { return true; }
         std::mutex m_QueueAccessMutex;
         VK_Pool* GetLoadPool() { return m_LoadPool.get(); }
+        // shared by all pipelines, internally synchronized, persisted in bin-int
+        VkPipelineCache GetPipelineCache() const { return m_PipelineCache; }
         void WaitIdle();
 
     private:
         static constexpr int NO_ASSIGNED = -1;
+        static constexpr const char* PIPELINE_CACHE_FILE = "bin-int/pipelineCache.bin";
 
         struct QueueSpec
         {
@@ -109,6 +116,8 @@ namespace GfxRenderEngine
         VkDeviceQueueCreateInfo CreateQueue(const QueueSpec& spec);
         void CreateLogicalDevice();
         void CreateCommandPool();
+        void CreatePipelineCache();
+        void SavePipelineCache();
 
         // helper functions
         bool IsSuitableDevice(VkPhysicalDevice& device);
@@ -127,6 +136,7 @@ namespace GfxRenderEngine
         VkPhysicalDevice m_PhysicalDevice{nullptr};
         VK_Window* m_Window;
         VkCommandPool m_GraphicsCommandPool{nullptr};
+        VkPipelineCache m_PipelineCache{VK_NULL_HANDLE};
         std::unique_ptr<VK_Pool> m_LoadPool;
         VkDevice m_Device{nullptr};
         VkSurfaceKHR m_Surface{nullptr};
@@ -25,11 +25,15 @@
 #include <vulkan/vulkan.h>
 
 #include "renderer/camera.h"
+#include "renderer/renderStatistics.h"
 #include "scene/components.h"
 #include "pointlights.h"
+#include "shadowMapping.h"
 
 namespace GfxRenderEngine
 {
+    class VK_TextureStreamer;
+    class VK_RenderQueue;
 
     struct PointLight
     {
@@ -56,6 +60,12 @@ namespace GfxRenderEngine
         DirectionalLight m_DirectionalLight;
         int m_NumberOfActivePointLights;
         int m_NumberOfActiveDirectionalLights;
+        int m_Spare0{0}; // padding
+        int m_Spare1{0}; // padding
+
+        // read by the shaders that declare them, see impostor.vert and pbr.frag
+        glm::vec4 m_CameraPosition{0.0f}; // ignore w
+        glm::vec4 m_ImpostorFade{0.0f};   // x: distance where the crossfade begins, y: where it ends
     };
 
     struct ShadowUniformBuffer
@@ -64,6 +74,15 @@ namespace GfxRenderEngine
         glm::mat4 m_View{1.0f};
     };
 
+    // shadow cascades as seen by the lighting pass
+    struct CascadeUniformBuffer
+    {
+        glm::mat4 m_ViewProjection[MAX_SHADOW_CASCADES];
+        glm::vec4 m_SplitDepths{0.0f}; // view space depth where each cascade ends
+        int m_NumberOfCascades{0};
+    };
+    static_assert(MAX_SHADOW_CASCADES <= 4, "split depths are packed into a vec4");
+
     struct VK_FrameInfo
     {
         int m_FrameIndex{0};
@@ -73,6 +92,10 @@ namespace GfxRenderEngine
         Camera* m_Camera{nullptr};
         VkDescriptorSet m_GlobalDescriptorSet{nullptr};
         VkDescriptorSet m_DiffuseDescriptorSet{nullptr};
+        RenderStatistics* m_RenderStatistics{nullptr};
+        VK_TextureStreamer* m_TextureStreamer{nullptr};
+        VK_RenderQueue* m_RenderQueue{nullptr};
+        float m_ScreenHeight{1.0f}; // in pixels, see Camera::GetScreenSize()
     };
 
 } // namespace GfxRenderEngine
@@ -0,0 +1,207 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <vector>
+#include <algorithm>
+
+#include "VKgpuTimer.h"
+#include "VKcore.h"
+
+namespace GfxRenderEngine
+{
+    VK_GpuTimer::Scope::Scope(VK_GpuTimer& gpuTimer, VkCommandBuffer commandBuffer, RenderStatistics::Pass pass)
+        : m_GpuTimer{gpuTimer}, m_CommandBuffer{commandBuffer}, m_Pass{pass}
+    {
+        m_GpuTimer.Begin(m_CommandBuffer, m_Pass);
+    }
+
+    VK_GpuTimer::Scope::~Scope() { m_GpuTimer.End(m_CommandBuffer, m_Pass); }
+
+    VK_GpuTimer::VK_GpuTimer()
+        : m_Device{VK_Core::m_Device}, m_Supported{false}, m_TimestampPeriod{0.0f}, m_TimestampMask{0},
+          m_CurrentFrameIndex{0}, m_HistoryIndex{0}, m_HistorySize{0}
+    {
+        // the graphics queue must support timestamps
+        uint queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(m_Device->PhysicalDevice(), &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(m_Device->PhysicalDevice(), &queueFamilyCount, queueFamilies.data());
+        uint graphicsQueueFamily = m_Device->GetGraphicsQueueFamily();
+        uint validBits = (graphicsQueueFamily < queueFamilyCount) ? queueFamilies[graphicsQueueFamily].timestampValidBits : 0;
+
+        m_TimestampPeriod = m_Device->m_Properties.limits.timestampPeriod;
+        m_Supported = (validBits > 0) && (m_TimestampPeriod > 0.0f);
+        if (!m_Supported)
+        {
+            LOG_CORE_WARN("VK_GpuTimer: timestamp queries not supported on the graphics queue, GPU timings disabled");
+            return;
+        }
+        m_TimestampMask = (validBits >= 64) ? ~0ull : ((1ull << validBits) - 1);
+
+        VkQueryPoolCreateInfo queryPoolInfo{};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolInfo.queryCount = NUMBER_OF_QUERIES;
+        for (auto& queryPool : m_QueryPools)
+        {
+            if (vkCreateQueryPool(m_Device->Device(), &queryPoolInfo, nullptr, &queryPool) != VK_SUCCESS)
+            {
+                LOG_CORE_CRITICAL("VK_GpuTimer: failed to create query pool!");
+                m_Supported = false;
+                return;
+            }
+        }
+
+#ifdef TRACY_ENABLE
+        {
+            VkCommandBufferAllocateInfo allocateInfo{};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocateInfo.commandPool = m_Device->GetCommandPool();
+            allocateInfo.commandBufferCount = 1;
+            if (vkAllocateCommandBuffers(m_Device->Device(), &allocateInfo, &m_TracyCommandBuffer) == VK_SUCCESS)
+            {
+                // the context calibrates with a submit on the graphics queue
+                std::lock_guard<std::mutex> guard(m_Device->m_QueueAccessMutex);
+                m_TracyContext = TracyVkContext(m_Device->PhysicalDevice(), m_Device->Device(), m_Device->GraphicsQueue(),
+                                                m_TracyCommandBuffer);
+            }
+        }
+#endif
+    }
+
+    VK_GpuTimer::~VK_GpuTimer()
+    {
+#ifdef TRACY_ENABLE
+        if (m_TracyContext)
+        {
+            TracyVkDestroy(m_TracyContext);
+        }
+        if (m_TracyCommandBuffer)
+        {
+            vkFreeCommandBuffers(m_Device->Device(), m_Device->GetCommandPool(), 1, &m_TracyCommandBuffer);
+        }
+#endif
+        for (auto& queryPool : m_QueryPools)
+        {
+            if (queryPool)
+            {
+                vkDestroyQueryPool(m_Device->Device(), queryPool, nullptr);
+            }
+        }
+    }
+
+    void VK_GpuTimer::BeginFrame(VkCommandBuffer commandBuffer, int frameIndex, RenderStatistics& renderStatistics)
+    {
+        m_CurrentFrameIndex = frameIndex;
+        if (!m_Supported)
+        {
+            return;
+        }
+
+        // the fence of this frame slot was waited on in AcquireNextImage()
+        if (m_QueryPoolUsed[frameIndex])
+        {
+            ReadResults(frameIndex);
+            UpdateRollingAverage();
+        }
+        renderStatistics.m_GpuTimeMs = m_GpuTimeMs;
+        renderStatistics.m_GpuTimeAverageMs = m_GpuTimeAverageMs;
+        renderStatistics.m_GpuTimingsValid = m_HistorySize > 0;
+
+        vkCmdResetQueryPool(commandBuffer, m_QueryPools[frameIndex], 0, NUMBER_OF_QUERIES);
+        m_QueryPoolUsed[frameIndex] = true;
+        m_Segments.fill(0);
+
+#ifdef TRACY_ENABLE
+        if (m_TracyContext)
+        {
+            TracyVkCollect(m_TracyContext, commandBuffer);
+        }
+#endif
+    }
+
+    void VK_GpuTimer::Begin(VkCommandBuffer commandBuffer, RenderStatistics::Pass pass)
+    {
+        if (m_Supported && commandBuffer && (m_Segments[pass] < MAX_SEGMENTS))
+        {
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_QueryPools[m_CurrentFrameIndex],
+                                2 * (pass * MAX_SEGMENTS + m_Segments[pass]));
+        }
+    }
+
+    void VK_GpuTimer::End(VkCommandBuffer commandBuffer, RenderStatistics::Pass pass)
+    {
+        if (m_Supported && commandBuffer && (m_Segments[pass] < MAX_SEGMENTS))
+        {
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_QueryPools[m_CurrentFrameIndex],
+                                2 * (pass * MAX_SEGMENTS + m_Segments[pass]) + 1);
+            ++m_Segments[pass];
+        }
+    }
+
+    void VK_GpuTimer::ReadResults(int frameIndex)
+    {
+        // pairs of {timestamp, availability}; no VK_QUERY_RESULT_WAIT_BIT, passes
+        // that were not recorded stay unavailable and are reported as zero
+        std::array<uint64, 2 * NUMBER_OF_QUERIES> results{};
+        vkGetQueryPoolResults(m_Device->Device(), m_QueryPools[frameIndex], 0, NUMBER_OF_QUERIES, sizeof(results),
+                              results.data(), 2 * sizeof(uint64),
+                              VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+        for (uint pass = 0; pass < RenderStatistics::NUMBER_OF_PASSES; ++pass)
+        {
+            float milliseconds = 0.0f;
+            for (uint segment = 0; segment < MAX_SEGMENTS; ++segment)
+            {
+                uint query = 4 * (pass * MAX_SEGMENTS + segment);
+                uint64 begin = results[query + 0];
+                bool beginAvailable = results[query + 1] != 0;
+                uint64 end = results[query + 2];
+                bool endAvailable = results[query + 3] != 0;
+
+                if (beginAvailable && endAvailable)
+                {
+                    uint64 ticks = ((end & m_TimestampMask) - (begin & m_TimestampMask)) & m_TimestampMask;
+                    milliseconds += static_cast<float>(static_cast<double>(ticks) * m_TimestampPeriod / 1000000.0);
+                }
+            }
+            m_GpuTimeMs[pass] = milliseconds;
+        }
+    }
+
+    void VK_GpuTimer::UpdateRollingAverage()
+    {
+        for (uint pass = 0; pass < RenderStatistics::NUMBER_OF_PASSES; ++pass)
+        {
+            m_HistorySum[pass] += m_GpuTimeMs[pass] - m_History[pass][m_HistoryIndex];
+            m_History[pass][m_HistoryIndex] = m_GpuTimeMs[pass];
+        }
+        m_HistoryIndex = (m_HistoryIndex + 1) % ROLLING_AVERAGE_FRAMES;
+        m_HistorySize = std::min(m_HistorySize + 1, ROLLING_AVERAGE_FRAMES);
+
+        for (uint pass = 0; pass < RenderStatistics::NUMBER_OF_PASSES; ++pass)
+        {
+            m_GpuTimeAverageMs[pass] = m_HistorySum[pass] / static_cast<float>(m_HistorySize);
+        }
+    }
+} // namespace GfxRenderEngine
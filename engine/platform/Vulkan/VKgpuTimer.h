@@ -0,0 +1,103 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <array>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+#include "renderer/renderStatistics.h"
+#include "tracy/TracyVulkan.hpp"
+
+#include "VKdevice.h"
+#include "VKswapChain.h"
+
+namespace GfxRenderEngine
+{
+    // GPU time per render pass from timestamp queries
+    // there is one query pool per frame in flight; the results of a pool are read
+    // when its frame slot comes around again (its fence has been waited on by then),
+    // so reading never stalls and the values are MAX_FRAMES_IN_FLIGHT frames old;
+    // a pass may be interrupted by another pass and resumed, the time of its segments is summed up
+    class VK_GpuTimer
+    {
+
+    public:
+        static constexpr uint MAX_SEGMENTS = 2; // per pass and frame
+        static constexpr uint NUMBER_OF_QUERIES = 2 * MAX_SEGMENTS * RenderStatistics::NUMBER_OF_PASSES; // begin and end
+        static constexpr uint ROLLING_AVERAGE_FRAMES = 64;
+
+        // writes the begin and end timestamps of a pass
+        class Scope
+        {
+        public:
+            Scope(VK_GpuTimer& gpuTimer, VkCommandBuffer commandBuffer, RenderStatistics::Pass pass);
+            ~Scope();
+
+        private:
+            VK_GpuTimer& m_GpuTimer;
+            VkCommandBuffer m_CommandBuffer;
+            RenderStatistics::Pass m_Pass;
+        };
+
+    public:
+        VK_GpuTimer();
+        ~VK_GpuTimer();
+
+        VK_GpuTimer(const VK_GpuTimer&) = delete;
+        VK_GpuTimer& operator=(const VK_GpuTimer&) = delete;
+
+        // must be called outside of a render pass, right after the command buffer began
+        void BeginFrame(VkCommandBuffer commandBuffer, int frameIndex, RenderStatistics& renderStatistics);
+        void Begin(VkCommandBuffer commandBuffer, RenderStatistics::Pass pass);
+        void End(VkCommandBuffer commandBuffer, RenderStatistics::Pass pass);
+
+        bool IsSupported() const { return m_Supported; }
+        TracyVkCtx GetTracyContext() const { return m_TracyContext; }
+
+    private:
+        void ReadResults(int frameIndex);
+        void UpdateRollingAverage();
+
+    private:
+        VK_Device* m_Device;
+        bool m_Supported;
+        float m_TimestampPeriod; // nanoseconds per tick
+        uint64 m_TimestampMask;
+        int m_CurrentFrameIndex;
+
+        std::array<VkQueryPool, VK_SwapChain::MAX_FRAMES_IN_FLIGHT> m_QueryPools{};
+        std::array<bool, VK_SwapChain::MAX_FRAMES_IN_FLIGHT> m_QueryPoolUsed{};
+        std::array<uint, RenderStatistics::NUMBER_OF_PASSES> m_Segments{}; // segments recorded in the current frame
+
+        std::array<float, RenderStatistics::NUMBER_OF_PASSES> m_GpuTimeMs{};
+        std::array<float, RenderStatistics::NUMBER_OF_PASSES> m_GpuTimeAverageMs{};
+        std::array<std::array<float, ROLLING_AVERAGE_FRAMES>, RenderStatistics::NUMBER_OF_PASSES> m_History{};
+        std::array<float, RenderStatistics::NUMBER_OF_PASSES> m_HistorySum{};
+        uint m_HistoryIndex;
+        uint m_HistorySize;
+
+        TracyVkCtx m_TracyContext{nullptr};
+        VkCommandBuffer m_TracyCommandBuffer{nullptr};
+    };
+} // namespace GfxRenderEngine
@@ -25,43 +25,98 @@
    Initially based off VulkanBuffer by Sascha Willems -
    https://github.com/SaschaWillems/Vulkan/blob/master/base/VulkanBuffer.h */
 
+#include <algorithm>
+#include <cstring>
+
+#include "VKcore.h"
 #include "VKinstanceBuffer.h"
 
 namespace GfxRenderEngine
 {
-    VK_InstanceBuffer::VK_InstanceBuffer(uint numInstances) : m_NumInstances(numInstances), m_Dirty{true}
+    void VK_InstanceBuffer::DirtyRange::Add(uint index)
     {
-        m_Ubo = std::make_shared<VK_Buffer>(numInstances * sizeof(InstanceData));
-        m_Ubo->MapBuffer();
+        if (Empty())
+        {
+            m_Begin = index;
+            m_End = index + 1;
+        }
+        else
+        {
+            m_Begin = std::min(m_Begin, index);
+            m_End = std::max(m_End, index + 1);
+        }
+    }
+
+    VK_InstanceBuffer::VK_InstanceBuffer(uint numInstances) : m_NumInstances(numInstances)
+    {
+        VkDeviceSize minOffsetAlignment = VK_Core::m_Device->m_Properties.limits.minUniformBufferOffsetAlignment;
+        m_Ubo = std::make_shared<VK_Buffer>(numInstances * sizeof(InstanceData), VK_SwapChain::MAX_FRAMES_IN_FLIGHT,
+                                            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                            minOffsetAlignment);
+        m_Ubo->Map();
+        m_ModelMatrices.resize(numInstances, glm::mat4(1.0f));
         m_DataInstances.resize(numInstances);
+        for (auto& dirtyRange : m_DirtyRanges)
+        {
+            dirtyRange = {0, numInstances};
+        }
     }
 
     VK_InstanceBuffer::~VK_InstanceBuffer() {}
 
-    void VK_InstanceBuffer::SetInstanceData(uint index, glm::mat4 const& mat4Global, glm::mat4 const& normalMatrix)
+    void VK_InstanceBuffer::SetInstanceData(uint index, glm::mat4 const& mat4Global)
     {
         CORE_ASSERT(index < m_NumInstances, "out of bounds");
 
-        m_DataInstances[index].m_ModelMatrix = mat4Global;
-        m_DataInstances[index].m_NormalMatrix = normalMatrix;
+        m_ModelMatrices[index] = mat4Global;
+
+        InstanceData instanceData;
+        glm::mat4 rows = glm::transpose(mat4Global);
+        instanceData.m_ModelMatrix[0] = rows[0];
+        instanceData.m_ModelMatrix[1] = rows[1];
+        instanceData.m_ModelMatrix[2] = rows[2];
+        if (memcmp(&instanceData, &m_DataInstances[index], sizeof(InstanceData)) == 0)
+        {
+            return; // scene graph updates rewrite unchanged transforms
+        }
+        m_DataInstances[index] = instanceData;
+        ++m_Version;
 
-        m_Dirty = true;
+        for (auto& dirtyRange : m_DirtyRanges)
+        {
+            dirtyRange.Add(index);
+        }
     }
 
-    void VK_InstanceBuffer::Update()
+    void VK_InstanceBuffer::Update(uint frameIndex)
     {
-        if (m_Dirty)
+        DirtyRange& dirtyRange = m_DirtyRanges[frameIndex];
+        if (dirtyRange.Empty())
         {
-            // update ubo
-            m_Ubo->WriteToBuffer(m_DataInstances.data());
-            m_Ubo->Flush();
-            m_Dirty = false;
+            return;
         }
+
+        VkDeviceSize sliceOffset = frameIndex * m_Ubo->GetAlignmentSize();
+        VkDeviceSize offset = sliceOffset + dirtyRange.m_Begin * sizeof(InstanceData);
+        VkDeviceSize size = (dirtyRange.m_End - dirtyRange.m_Begin) * sizeof(InstanceData);
+        m_Ubo->WriteToBuffer(&m_DataInstances[dirtyRange.m_Begin], size, offset);
+
+        // flushed ranges of non-coherent memory must be multiples of nonCoherentAtomSize
+        VkDeviceSize atomSize = VK_Core::m_Device->m_Properties.limits.nonCoherentAtomSize;
+        VkDeviceSize flushBegin = offset / atomSize * atomSize;
+        VkDeviceSize flushEnd = (offset + size + atomSize - 1) / atomSize * atomSize;
+        if (flushEnd >= m_Ubo->GetBufferSize())
+        {
+            m_Ubo->Flush(VK_WHOLE_SIZE, flushBegin);
+        }
+        else
+        {
+            m_Ubo->Flush(flushEnd - flushBegin, flushBegin);
+        }
+        dirtyRange = {};
     }
 
     std::shared_ptr<Buffer> VK_InstanceBuffer::GetBuffer() { return m_Ubo; }
 
-    const glm::mat4& VK_InstanceBuffer::GetModelMatrix(uint index) { return m_DataInstances[index].m_ModelMatrix; }
-
-    const glm::mat4& VK_InstanceBuffer::GetNormalMatrix(uint index) { return m_DataInstances[index].m_NormalMatrix; }
+    const glm::mat4& VK_InstanceBuffer::GetModelMatrix(uint index) { return m_ModelMatrices[index]; }
 } // namespace GfxRenderEngine
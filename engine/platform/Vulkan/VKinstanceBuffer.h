@@ -20,17 +20,20 @@
    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
-   Encapsulates a vulkan buffer to hold the model and normal matrix for instanced rendering
-*/
+   Encapsulates a vulkan buffer to hold the model matrices for instanced rendering
+   The buffer holds one copy per frame in flight, bound with a dynamic offset.
+   Only instances that changed are copied and flushed. */
 
 #pragma once
 
+#include <array>
 #include <vulkan/vulkan.h>
 
 #include "engine.h"
 #include "renderer/instanceBuffer.h"
 
 #include "VKbuffer.h"
+#include "VKswapChain.h"
 
 namespace GfxRenderEngine
 {
@@ -44,22 +47,37 @@ namespace GfxRenderEngine
         VK_InstanceBuffer(const VK_InstanceBuffer&) = delete;
         VK_InstanceBuffer& operator=(const VK_InstanceBuffer&) = delete;
 
-        virtual void SetInstanceData(uint index, glm::mat4 const& mat4Global, glm::mat4 const& normalMatrix) override;
+        virtual void SetInstanceData(uint index, glm::mat4 const& mat4Global) override;
         virtual const glm::mat4& GetModelMatrix(uint index) override;
-        virtual const glm::mat4& GetNormalMatrix(uint index) override;
         virtual std::shared_ptr<Buffer> GetBuffer() override;
-        void Update();
+
+        // copies the instances that changed since the copy of this frame was last written
+        // the copy is not in use by the GPU, its fence was waited for in BeginFrame()
+        void Update(uint frameIndex);
+
+        // incremented whenever an instance changed, used to tell static from moving shadow casters
+        uint64 GetVersion() const { return m_Version; }
 
     private:
         struct InstanceData
         {
-            glm::mat4 m_ModelMatrix;
-            glm::mat4 m_NormalMatrix;
+            glm::vec4 m_ModelMatrix[3]; // rows of a 3x4 model matrix, the normal matrix is derived in the shader
+        };
+
+        struct DirtyRange
+        {
+            uint m_Begin{0};
+            uint m_End{0};
+            bool Empty() const { return m_Begin == m_End; }
+            void Add(uint index);
         };
 
+    private:
         uint m_NumInstances;
-        bool m_Dirty;
+        std::vector<glm::mat4> m_ModelMatrices;
         std::vector<InstanceData> m_DataInstances;
+        std::array<DirtyRange, VK_SwapChain::MAX_FRAMES_IN_FLIGHT> m_DirtyRanges;
         std::shared_ptr<VK_Buffer> m_Ubo;
+        uint64 m_Version{0};
     };
 } // namespace GfxRenderEngine
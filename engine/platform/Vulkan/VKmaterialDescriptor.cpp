@@ -76,6 +76,16 @@ namespace GfxRenderEngine
                         .WriteImage(5, imageInfo5)
                         .Build(m_DescriptorSet);
                 }
+                // streamed textures rewrite their binding when their image is replaced
+                {
+                    m_DescriptorUserTextures = {diffuseMap,  normalMap,    roughnessMetallicMap,
+                                                emissiveMap, roughnessMap, metallicMap};
+                    for (uint binding = 0; binding < m_DescriptorUserTextures.size(); ++binding)
+                    {
+                        static_cast<VK_Texture*>(m_DescriptorUserTextures[binding].get())
+                            ->AddDescriptorUser(m_DescriptorSet, binding);
+                    }
+                }
                 break;
             }
             default:
@@ -125,7 +135,15 @@ namespace GfxRenderEngine
         }
     }
 
-    VK_MaterialDescriptor::~VK_MaterialDescriptor() {}
+    VK_MaterialDescriptor::~VK_MaterialDescriptor()
+    {
+        // textures may outlive the material, streaming must not write to a released set
+        for (uint binding = 0; binding < m_DescriptorUserTextures.size(); ++binding)
+        {
+            static_cast<VK_Texture*>(m_DescriptorUserTextures[binding].get())
+                ->RemoveDescriptorUser(m_DescriptorSet, binding);
+        }
+    }
 
     MaterialDescriptor::MaterialType VK_MaterialDescriptor::GetMaterialType() const { return m_MaterialType; }
 
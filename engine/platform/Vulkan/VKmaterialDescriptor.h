@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
 #include <vulkan/vulkan.h>
 
 #include "renderer/materialDescriptor.h"
@@ -37,8 +39,10 @@ namespace GfxRenderEngine
         VK_MaterialDescriptor(MaterialDescriptor::MaterialType materialType, Material::MaterialTextures& textures);
         VK_MaterialDescriptor(MaterialDescriptor::MaterialType materialType, std::shared_ptr<Cubemap> const& cubemap);
 
+        // copies share the descriptor set, only the original is registered with streamed textures
         VK_MaterialDescriptor(VK_MaterialDescriptor const& other);
         VK_MaterialDescriptor(std::shared_ptr<MaterialDescriptor> const& materialDescriptor);
+        VK_MaterialDescriptor& operator=(VK_MaterialDescriptor const&) = delete;
 
         virtual ~VK_MaterialDescriptor();
 
@@ -52,5 +56,9 @@ namespace GfxRenderEngine
     private:
         MaterialDescriptor::MaterialType m_MaterialType;
         VkDescriptorSet m_DescriptorSet{nullptr};
+
+        // registered as descriptor users of m_DescriptorSet, indexed by binding;
+        // empty for copies, they must not outlive the original (submeshes keep their material)
+        std::vector<std::shared_ptr<Texture>> m_DescriptorUserTextures;
     };
 } // namespace GfxRenderEngine
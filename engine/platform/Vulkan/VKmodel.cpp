@@ -21,15 +21,24 @@
    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
 #include "core.h"
+#include "coreSettings.h"
 #include "VKmodel.h"
 #include "VKdescriptor.h"
 #include "VKmaterialDescriptor.h"
 #include "VKrenderer.h"
+#include "renderer/instanceBuffer.h"
 
 #include "systems/pushConstantData.h"
+#include "systems/impostor/VKimpostor.h"
 
 namespace GfxRenderEngine
 {
+    namespace
+    {
+        // a coarser level is selected once its projected error falls below this fraction of the threshold
+        constexpr float LOD_HYSTERESIS = 0.8f;
+    } // namespace
+
     // Vertex
     std::vector<VkVertexInputBindingDescription> VK_Model::VK_Vertex::GetBindingDescriptions()
     {
@@ -50,7 +59,7 @@ namespace GfxRenderEngine
         attributeDescriptions.push_back({1, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Vertex, m_Color)});
         attributeDescriptions.push_back({2, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, m_Normal)});
         attributeDescriptions.push_back({3, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, m_UV)});
-        attributeDescriptions.push_back({4, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, m_Tangent)});
+        attributeDescriptions.push_back({4, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Vertex, m_Tangent)});
         attributeDescriptions.push_back({5, 0, VK_FORMAT_R32G32B32A32_SINT, offsetof(Vertex, m_JointIds)});
         attributeDescriptions.push_back({6, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Vertex, m_Weights)});
 
@@ -68,15 +77,25 @@ namespace GfxRenderEngine
     CreateIndexBuffer(std::move(builder.m_Indices));   \
     m_Skeleton = std::move(builder.m_Skeleton);        \
     m_Animations = std::move(builder.m_Animations);    \
-    m_ShaderDataUbo = builder.m_ShaderData;
+    m_ShaderDataUbo = builder.m_ShaderData;            \
+    CreateSkinnedVertexBuffers();
+
+#define INIT_GLTF_MODEL()                                                                          \
+    CopySubmeshes(builder.m_Submeshes);                                                            \
+    LoadGeometry(builder.m_Geometry, builder.m_GeometryKey, builder.m_Vertices, builder.m_Indices, \
+                 builder.m_Submeshes);                                                             \
+    m_Skeleton = std::move(builder.m_Skeleton);                                                    \
+    m_Animations = std::move(builder.m_Animations);                                                \
+    m_ShaderDataUbo = builder.m_ShaderData;                                                        \
+    CreateSkinnedVertexBuffers();
 
     VK_Model::VK_Model(VK_Device* device, const FastgltfBuilder& builder) : m_Device(device)
     {
         ZoneScopedNC("VK_Model(FastgltfBuilder)", 0x00ffff);
-        INIT_GLTF_AND_FBX_MODEL();
+        INIT_GLTF_MODEL();
     }
     VK_Model::VK_Model(VK_Device* device, const UFbxBuilder& builder) : m_Device(device) { INIT_GLTF_AND_FBX_MODEL(); }
-    VK_Model::VK_Model(VK_Device* device, const GltfBuilder& builder) : m_Device(device) { INIT_GLTF_AND_FBX_MODEL(); }
+    VK_Model::VK_Model(VK_Device* device, const GltfBuilder& builder) : m_Device(device) { INIT_GLTF_MODEL(); }
     VK_Model::VK_Model(VK_Device* device, const FbxBuilder& builder) : m_Device(device) { INIT_GLTF_AND_FBX_MODEL(); }
     VK_Model::VK_Model(VK_Device* device, const Builder& builder) : m_Device(device)
     {
@@ -85,11 +104,23 @@ namespace GfxRenderEngine
     }
     VK_Model::VK_Model(VK_Device* device, const TerrainBuilder& builder) : m_Device(device) { INIT_MODEL(); }
 
-    VK_Model::~VK_Model() {}
+    VK_Model::~VK_Model()
+    {
+        auto renderer = static_cast<VK_Renderer*>(Engine::m_Engine->GetRenderer());
+        if (VK_BindlessTable* bindlessTable = renderer ? renderer->GetBindlessTable() : nullptr)
+        {
+            for (auto& submesh : m_SubmeshesPbrMap)
+            {
+                bindlessTable->ReleaseMaterial(submesh.m_MaterialIndex);
+            }
+        }
+    }
+
+    void VK_Model::SetImpostor(std::unique_ptr<VK_Impostor> impostor) { m_Impostor = std::move(impostor); }
 
     VK_Submesh::VK_Submesh(Submesh const& submesh)
         : Submesh{submesh.m_FirstIndex,    submesh.m_FirstVertex, submesh.m_IndexCount, submesh.m_VertexCount,
-                  submesh.m_InstanceCount, submesh.m_Material,    submesh.m_Resources},
+                  submesh.m_InstanceCount, submesh.m_Material,    submesh.m_Resources,  submesh.m_Lods},
           m_MaterialDescriptor(submesh.m_Material.m_MaterialDescriptor),
           m_ResourceDescriptor(submesh.m_Resources.m_ResourceDescriptor)
     {
@@ -97,6 +128,8 @@ namespace GfxRenderEngine
 
     void VK_Model::CopySubmeshes(std::vector<Submesh> const& submeshes)
     {
+        auto renderer = static_cast<VK_Renderer*>(Engine::m_Engine->GetRenderer());
+        VK_BindlessTable* bindlessTable = renderer->GetBindlessTable();
         for (auto& submesh : submeshes)
         {
             VK_Submesh vkSubmesh(submesh);
@@ -107,7 +140,19 @@ namespace GfxRenderEngine
             {
                 case MaterialDescriptor::MaterialType::MtPbr:
                 {
+                    if (bindlessTable)
+                    {
+                        vkSubmesh.m_MaterialIndex = bindlessTable->AcquireMaterial(vkSubmesh.m_Material);
+                    }
                     m_SubmeshesPbrMap.push_back(vkSubmesh);
+                    if (m_LodErrors.size() <= submesh.m_Lods.size())
+                    {
+                        m_LodErrors.resize(submesh.m_Lods.size() + 1, 0.0f);
+                    }
+                    for (size_t level = 0; level < submesh.m_Lods.size(); ++level)
+                    {
+                        m_LodErrors[level + 1] = std::max(m_LodErrors[level + 1], submesh.m_Lods[level].m_Error);
+                    }
                     break;
                 }
                 case MaterialDescriptor::MaterialType::MtCubemap:
@@ -124,7 +169,33 @@ namespace GfxRenderEngine
         }
     }
 
-    void VK_Model::CreateVertexBuffer(const std::vector<Vertex>& vertices) { CreateVertexBuffer<Vertex>(vertices); }
+    void VK_Model::CreateVertexBuffer(const std::vector<Vertex>& vertices)
+    {
+        for (auto& vertex : vertices)
+        {
+            m_BoundingRadius = std::max(m_BoundingRadius, glm::length(vertex.m_Position));
+        }
+        CreateVertexBuffer<Vertex>(vertices);
+    }
+
+    // the skinned copies start out as the bind pose, VK_Skinning only rewrites positions, normals, and tangents
+    void VK_Model::CreateSkinnedVertexBuffers()
+    {
+        if (!m_Skeleton)
+        {
+            return;
+        }
+        m_SkinnedVertices.resize(VK_SwapChain::MAX_FRAMES_IN_FLIGHT);
+        for (auto& skinnedVertices : m_SkinnedVertices)
+        {
+            skinnedVertices.m_Buffer = std::make_unique<VK_Buffer>(
+                sizeof(Vertex), m_VertexCount,
+                VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            m_Device->CopyBuffer(m_VertexBuffer->GetBuffer(), skinnedVertices.m_Buffer->GetBuffer(),
+                                 sizeof(Vertex) * m_VertexCount);
+        }
+    }
 
     void VK_Model::CreateIndexBuffer(const std::vector<uint>& indices)
     {
@@ -143,15 +214,56 @@ namespace GfxRenderEngine
         stagingBuffer.Map();
         stagingBuffer.WriteToBuffer((void*)indices.data());
 
-        m_IndexBuffer = std::make_unique<VK_Buffer>(indexSize, m_IndexCount,
+        m_IndexBuffer = std::make_shared<VK_Buffer>(indexSize, m_IndexCount,
                                                     VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                                                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
         m_Device->CopyBuffer(stagingBuffer.GetBuffer(), m_IndexBuffer->GetBuffer(), bufferSize);
     }
 
+    void VK_Model::LoadGeometry(std::shared_ptr<MeshGeometry> const& geometry, AssetRegistry::Key const& key,
+                                std::vector<Vertex> const& vertices, std::vector<uint> const& indices,
+                                std::vector<Submesh> const& submeshes)
+    {
+        if (!geometry->m_VertexBuffer)
+        {
+            // first model of this mesh: upload and register the buffers
+            CreateVertexBuffer(vertices);
+            CreateIndexBuffer(indices);
+
+            geometry->m_VertexBuffer = m_VertexBuffer;
+            geometry->m_IndexBuffer = m_IndexBuffer;
+            geometry->m_VertexCount = m_VertexCount;
+            geometry->m_IndexCount = m_IndexCount;
+            geometry->m_BoundingRadius = m_BoundingRadius;
+            geometry->m_MemorySize = m_VertexBuffer->GetBufferSize() + (m_IndexBuffer ? m_IndexBuffer->GetBufferSize() : 0);
+            geometry->m_Ranges.reserve(submeshes.size());
+            for (auto const& submesh : submeshes)
+            {
+                geometry->m_Ranges.push_back({submesh.m_FirstIndex, submesh.m_FirstVertex, submesh.m_IndexCount,
+                                              submesh.m_VertexCount, submesh.m_Lods});
+            }
+            m_Geometry = Engine::m_Engine->m_AssetRegistry.Insert(key, geometry);
+            if (m_Geometry == geometry)
+            {
+                return;
+            }
+        }
+        else
+        {
+            m_Geometry = geometry;
+        }
+
+        m_VertexBuffer = std::static_pointer_cast<VK_Buffer>(m_Geometry->m_VertexBuffer);
+        m_IndexBuffer = std::static_pointer_cast<VK_Buffer>(m_Geometry->m_IndexBuffer);
+        m_VertexCount = m_Geometry->m_VertexCount;
+        m_IndexCount = m_Geometry->m_IndexCount;
+        m_BoundingRadius = m_Geometry->m_BoundingRadius;
+        m_HasIndexBuffer = (m_IndexCount > 0);
+    }
+
     void VK_Model::Bind(VkCommandBuffer commandBuffer)
     {
-        VkBuffer buffers[] = {m_VertexBuffer->GetBuffer()};
+        VkBuffer buffers[] = {GetVertexBuffer()};
         VkDeviceSize offsets[] = {0};
         vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
 
@@ -167,6 +279,15 @@ namespace GfxRenderEngine
         m_Animations->Update(timestep, *m_Skeleton, frameCounter);
         m_Skeleton->Update();
 
+        // a paused or finished animation keeps its pose, VK_Skinning skips it
+        auto const& joints = m_Skeleton->m_ShaderData.m_FinalJointsMatrices;
+        if (joints == m_PoseJoints)
+        {
+            return;
+        }
+        m_PoseJoints = joints;
+        ++m_Pose;
+
         // update ubo
         static_cast<VK_Buffer*>(m_ShaderDataUbo.get())->WriteToBuffer(m_Skeleton->m_ShaderData.m_FinalJointsMatrices.data());
         static_cast<VK_Buffer*>(m_ShaderDataUbo.get())->Flush();
@@ -195,14 +316,15 @@ namespace GfxRenderEngine
         const VkDescriptorSet& resourceDescriptorSet = submesh.m_ResourceDescriptor.GetDescriptorSet();
         std::vector<VkDescriptorSet> descriptorSets = {frameInfo.m_GlobalDescriptorSet, materialDescriptorSet,
                                                        resourceDescriptorSet};
+        uint32_t dynamicOffset = submesh.m_ResourceDescriptor.GetDynamicOffset(frameInfo.m_FrameIndex);
         vkCmdBindDescriptorSets(frameInfo.m_CommandBuffer,       // VkCommandBuffer        commandBuffer,
                                 VK_PIPELINE_BIND_POINT_GRAPHICS, // VkPipelineBindPoint    pipelineBindPoint,
                                 pipelineLayout,                  // VkPipelineLayout       layout,
                                 0,                               // uint32_t               firstSet,
                                 descriptorSets.size(),           // uint32_t               descriptorSetCount,
                                 descriptorSets.data(),           // const VkDescriptorSet* pDescriptorSets,
-                                0,                               // uint32_t               dynamicOffsetCount,
-                                nullptr                          // const uint32_t*        pDynamicOffsets);
+                                1,                               // uint32_t               dynamicOffsetCount,
+                                &dynamicOffset                   // const uint32_t*        pDynamicOffsets);
         );
     }
 
@@ -214,50 +336,66 @@ namespace GfxRenderEngine
                            sizeof(Material::PbrMaterial), &submesh.m_Material.m_PbrMaterial);
     }
 
-    void VK_Model::Draw(VkCommandBuffer commandBuffer)
+    void VK_Model::Draw(const VK_FrameInfo& frameInfo)
     {
         if (m_HasIndexBuffer)
         {
-            vkCmdDrawIndexed(commandBuffer, // VkCommandBuffer commandBuffer
-                             m_IndexCount,  // uint32_t        indexCount
-                             1,             // uint32_t        instanceCount
-                             0,             // uint32_t        firstIndex
-                             0,             // int32_t         vertexOffset
-                             0              // uint32_t        firstInstance
+            vkCmdDrawIndexed(frameInfo.m_CommandBuffer, // VkCommandBuffer commandBuffer
+                             m_IndexCount,              // uint32_t        indexCount
+                             1,                         // uint32_t        instanceCount
+                             0,                         // uint32_t        firstIndex
+                             0,                         // int32_t         vertexOffset
+                             0                          // uint32_t        firstInstance
             );
         }
         else
         {
-            vkCmdDraw(commandBuffer, // VkCommandBuffer commandBuffer
-                      m_VertexCount, // uint32_t        vertexCount
-                      1,             // uint32_t        instanceCount
-                      0,             // uint32_t        firstVertex
-                      0              // uint32_t        firstInstance
+            vkCmdDraw(frameInfo.m_CommandBuffer, // VkCommandBuffer commandBuffer
+                      m_VertexCount,             // uint32_t        vertexCount
+                      1,                         // uint32_t        instanceCount
+                      0,                         // uint32_t        firstVertex
+                      0                          // uint32_t        firstInstance
             );
         }
+        if (frameInfo.m_RenderStatistics)
+        {
+            frameInfo.m_RenderStatistics->Draw(m_HasIndexBuffer ? m_IndexCount : m_VertexCount, 1);
+        }
+    }
+
+    void VK_Model::DrawSubmesh(const VK_FrameInfo& frameInfo, Submesh const& submesh)
+    {
+        DrawSubmesh(frameInfo, submesh, 0, submesh.m_InstanceCount);
     }
 
-    void VK_Model::DrawSubmesh(VkCommandBuffer commandBuffer, Submesh const& submesh)
+    void VK_Model::DrawSubmesh(const VK_FrameInfo& frameInfo, Submesh const& submesh, uint firstInstance,
+                               uint instanceCount, uint lod)
     {
+        SubmeshLod level = submesh.GetLod(lod);
         if (m_HasIndexBuffer)
         {
-            vkCmdDrawIndexed(commandBuffer,           // VkCommandBuffer commandBuffer
-                             submesh.m_IndexCount,    // uint32_t        indexCount
-                             submesh.m_InstanceCount, // uint32_t        instanceCount
-                             submesh.m_FirstIndex,    // uint32_t        firstIndex
-                             submesh.m_FirstVertex,   // int32_t         vertexOffset
-                             0                        // uint32_t        firstInstance
+            vkCmdDrawIndexed(frameInfo.m_CommandBuffer, // VkCommandBuffer commandBuffer
+                             level.m_IndexCount,        // uint32_t        indexCount
+                             instanceCount,             // uint32_t        instanceCount
+                             level.m_FirstIndex,        // uint32_t        firstIndex
+                             level.m_FirstVertex,       // int32_t         vertexOffset
+                             firstInstance              // uint32_t        firstInstance
             );
         }
         else
         {
-            vkCmdDraw(commandBuffer,           // VkCommandBuffer commandBuffer
-                      submesh.m_VertexCount,   // uint32_t        vertexCount
-                      submesh.m_InstanceCount, // uint32_t        instanceCount
-                      submesh.m_FirstVertex,   // uint32_t        firstVertex
-                      0                        // uint32_t        firstInstance
+            vkCmdDraw(frameInfo.m_CommandBuffer, // VkCommandBuffer commandBuffer
+                      submesh.m_VertexCount,     // uint32_t        vertexCount
+                      instanceCount,             // uint32_t        instanceCount
+                      submesh.m_FirstVertex,     // uint32_t        firstVertex
+                      firstInstance              // uint32_t        firstInstance
             );
         }
+        if (frameInfo.m_RenderStatistics)
+        {
+            frameInfo.m_RenderStatistics->Draw(m_HasIndexBuffer ? level.m_IndexCount : submesh.m_VertexCount,
+                                               instanceCount);
+        }
     }
 
     void VK_Model::DrawPbr(const VK_FrameInfo& frameInfo, const VkPipelineLayout& pipelineLayout)
@@ -266,8 +404,105 @@ namespace GfxRenderEngine
         {
             BindDescriptors(frameInfo, pipelineLayout, submesh, true /*bind resources*/);
             PushConstantsPbr(frameInfo, pipelineLayout, submesh);
-            DrawSubmesh(frameInfo.m_CommandBuffer, submesh);
+            DrawSubmesh(frameInfo, submesh);
+        }
+    }
+
+    void VK_Model::RequestTextures(const VK_FrameInfo& frameInfo, InstanceBuffer& instanceBuffer, uint instanceCount)
+    {
+        if (!frameInfo.m_TextureStreamer)
+        {
+            return;
+        }
+        auto& textureStreamer = *frameInfo.m_TextureStreamer;
+        float screenSize = 0.0f;
+        for (uint index = 0; index < instanceCount; ++index)
+        {
+            screenSize = std::max(screenSize, frameInfo.m_Camera->GetScreenSize(instanceBuffer.GetModelMatrix(index),
+                                                                                m_BoundingRadius, frameInfo.m_ScreenHeight));
+        }
+        for (auto& submesh : m_SubmeshesPbrMap)
+        {
+            for (auto& texture : submesh.m_Material.m_MaterialTextures)
+            {
+                if (texture)
+                {
+                    textureStreamer.Request(texture, screenSize);
+                }
+            }
+        }
+    }
+
+    std::vector<uint> const& VK_Model::SelectLods(const VK_FrameInfo& frameInfo, InstanceBuffer& instanceBuffer,
+                                                  uint instanceCount)
+    {
+        m_InstanceLods.resize(instanceCount, 0);
+        uint coarsestLod = GetNumberOfLods() - 1;
+        if (!CoreSettings::m_MeshLod || !coarsestLod)
+        {
+            std::fill(m_InstanceLods.begin(), m_InstanceLods.end(), 0);
+            return m_InstanceLods;
         }
+
+        Camera const& camera = *frameInfo.m_Camera;
+        float threshold = static_cast<float>(std::max(CoreSettings::m_LodErrorPixels, 1));
+        for (uint index = 0; index < instanceCount; ++index)
+        {
+            // pixels per model space unit at the closest point of the bounding sphere,
+            // GetScreenSize() projects a diameter at the distance of the origin
+            glm::mat4 const& modelMatrix = instanceBuffer.GetModelMatrix(index);
+            float pixelsPerUnit = camera.GetScreenSize(modelMatrix, 0.5f, frameInfo.m_ScreenHeight);
+            float scale = std::max({glm::length(glm::vec3(modelMatrix[0])), glm::length(glm::vec3(modelMatrix[1])),
+                                    glm::length(glm::vec3(modelMatrix[2]))});
+            float distance = glm::length(glm::vec3(camera.GetViewMatrix() * modelMatrix[3]));
+            float closestDistance = distance - m_BoundingRadius * scale;
+            pixelsPerUnit = (closestDistance > 0.0f) ? pixelsPerUnit * distance / closestDistance
+                                                     : std::numeric_limits<float>::max();
+
+            // finer while the level is too coarse, coarser once the next level is clearly below the threshold
+            uint& lod = m_InstanceLods[index];
+            lod = std::min(lod, coarsestLod);
+            while ((lod > 0) && (m_LodErrors[lod] * pixelsPerUnit > threshold))
+            {
+                --lod;
+            }
+            while ((lod < coarsestLod) && (m_LodErrors[lod + 1] * pixelsPerUnit < threshold * LOD_HYSTERESIS))
+            {
+                ++lod;
+            }
+        }
+        return m_InstanceLods;
+    }
+
+    size_t VK_Model::GetMemorySize(std::unordered_set<void const*>& counted) const
+    {
+        size_t memorySize = 0;
+        if (m_VertexBuffer && counted.insert(m_VertexBuffer.get()).second)
+        {
+            memorySize += static_cast<size_t>(m_VertexBuffer->GetBufferSize());
+        }
+        if (m_IndexBuffer && counted.insert(m_IndexBuffer.get()).second)
+        {
+            memorySize += static_cast<size_t>(m_IndexBuffer->GetBufferSize());
+        }
+        for (auto& skinnedVertices : m_SkinnedVertices)
+        {
+            memorySize += static_cast<size_t>(skinnedVertices.m_Buffer->GetBufferSize());
+        }
+        for (auto submeshes : {&m_SubmeshesPbrMap, &m_SubmeshesPbrSAMap})
+        {
+            for (auto& submesh : *submeshes)
+            {
+                for (auto& texture : submesh.m_Material.m_MaterialTextures)
+                {
+                    if (texture && counted.insert(texture.get()).second)
+                    {
+                        memorySize += texture->GetMemorySize();
+                    }
+                }
+            }
+        }
+        return memorySize;
     }
 
     void VK_Model::DrawGrass(const VK_FrameInfo& frameInfo, const VkPipelineLayout& pipelineLayout, int instanceCount)
@@ -283,6 +518,10 @@ namespace GfxRenderEngine
                              submesh.m_FirstVertex,     // int32_t         vertexOffset
                              0                          // uint32_t        firstInstance
             );
+            if (frameInfo.m_RenderStatistics)
+            {
+                frameInfo.m_RenderStatistics->Draw(submesh.m_IndexCount, instanceCount);
+            }
         }
     }
 
@@ -301,10 +540,11 @@ namespace GfxRenderEngine
         VkDescriptorSet localDescriptorSet = submesh.m_ResourceDescriptor.GetDescriptorSet();
         std::vector<VkDescriptorSet> descriptorSets = {shadowDescriptorSet, localDescriptorSet};
         CORE_ASSERT(localDescriptorSet, "resource descriptor set empty");
+        uint32_t dynamicOffset = submesh.m_ResourceDescriptor.GetDynamicOffset(frameInfo.m_FrameIndex);
         vkCmdBindDescriptorSets(frameInfo.m_CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 2,
-                                descriptorSets.data(), 0, nullptr);
+                                descriptorSets.data(), 1, &dynamicOffset);
 
-        DrawSubmesh(frameInfo.m_CommandBuffer, submesh);
+        DrawSubmesh(frameInfo, submesh);
     }
 
     void VK_Model::DrawCubemap(const VK_FrameInfo& frameInfo, const VkPipelineLayout& pipelineLayout)
@@ -318,6 +558,10 @@ namespace GfxRenderEngine
                       submesh.m_FirstVertex,     // uint32_t        firstVertex
                       0                          // uint32_t        firstInstance
             );
+            if (frameInfo.m_RenderStatistics)
+            {
+                frameInfo.m_RenderStatistics->Draw(submesh.m_VertexCount, 1);
+            }
         }
     }
 } // namespace GfxRenderEngine
@@ -28,6 +28,7 @@
 #include "engine.h"
 #include "renderer/model.h"
 #include "renderer/buffer.h"
+#include "renderer/assetRegistry.h"
 #include "renderer/builder/builder.h"
 #include "renderer/builder/gltfBuilder.h"
 #include "renderer/builder/terrainBuilder.h"
@@ -48,12 +49,15 @@
 
 namespace GfxRenderEngine
 {
+    class InstanceBuffer;
+    class VK_Impostor;
 
     struct VK_Submesh : public Submesh
     {
         VK_Submesh(Submesh const& submesh);
         VK_MaterialDescriptor m_MaterialDescriptor;
         VK_ResourceDescriptor m_ResourceDescriptor;
+        uint m_MaterialIndex{0}; // bindless materials, see VK_BindlessTable
     };
 
     class VK_Model : public Model
@@ -71,8 +75,11 @@ namespace GfxRenderEngine
             stagingBuffer.Map();
             stagingBuffer.WriteToBuffer((void*)vertices.data());
 
-            m_VertexBuffer = std::make_unique<VK_Buffer>(
-                vertexSize, m_VertexCount, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            // skeletal animations copy the bind pose and VK_Skinning reads it as a storage buffer
+            m_VertexBuffer = std::make_shared<VK_Buffer>(
+                vertexSize, m_VertexCount,
+                VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                    VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
             m_Device->CopyBuffer(stagingBuffer.GetBuffer(), m_VertexBuffer->GetBuffer(), bufferSize);
@@ -85,6 +92,14 @@ namespace GfxRenderEngine
             static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions();
         };
 
+        // skeletal animations: the bind pose skinned by VK_Skinning, one copy per frame in flight
+        struct SkinnedVertices
+        {
+            std::unique_ptr<VK_Buffer> m_Buffer;
+            VkDescriptorSet m_DescriptorSet{VK_NULL_HANDLE}; // written by VK_Skinning on first use
+            uint64 m_Pose{0};                                // pose in the buffer, 0 is the bind pose
+        };
+
     public:
         VK_Model(VK_Device* device, const Builder& builder);
         VK_Model(VK_Device* device, const GltfBuilder& builder);
@@ -99,6 +114,7 @@ namespace GfxRenderEngine
 
         virtual void CreateVertexBuffer(const std::vector<Vertex>& vertices) override;
         virtual void CreateIndexBuffer(const std::vector<uint>& indices) override;
+        virtual size_t GetMemorySize(std::unordered_set<void const*>& counted) const override;
 
         void Bind(VkCommandBuffer commandBuffer);
         void UpdateAnimation(const Timestep& timestep, uint frameCounter);
@@ -110,11 +126,21 @@ namespace GfxRenderEngine
         void BindDescriptors(const VK_FrameInfo& frameInfo, const VkPipelineLayout& pipelineLayout,
                              VK_Submesh const& submesh, bool bindResources);
 
-        void Draw(VkCommandBuffer commandBuffer);
-        void DrawSubmesh(VkCommandBuffer commandBuffer, Submesh const& submesh);
+        void Draw(const VK_FrameInfo& frameInfo);
+        void DrawSubmesh(const VK_FrameInfo& frameInfo, Submesh const& submesh);
+        void DrawSubmesh(const VK_FrameInfo& frameInfo, Submesh const& submesh, uint firstInstance, uint instanceCount,
+                         uint lod = 0);
 
         // draw pbr materials
         void DrawPbr(const VK_FrameInfo& frameInfo, const VkPipelineLayout& pipelineLayout);
+        std::vector<VK_Submesh> const& GetSubmeshesPbr() const { return m_SubmeshesPbrMap; }
+        // the skinned vertices of the current frame for skeletal animations, the bind pose otherwise
+        VkBuffer GetVertexBuffer() const
+        {
+            return IsSkinned() ? m_SkinnedVertices[m_SkinnedFrame].m_Buffer->GetBuffer() : m_VertexBuffer->GetBuffer();
+        }
+        bool HasIndexBuffer() const { return m_HasIndexBuffer; }
+        float GetBoundingRadius() const { return m_BoundingRadius; } // bind pose for skeletal animations
         void DrawGrass(const VK_FrameInfo& frameInfo, const VkPipelineLayout& pipelineLayout, int instanceCount);
 
         // draw shadow
@@ -125,21 +151,60 @@ namespace GfxRenderEngine
         // cube map
         void DrawCubemap(const VK_FrameInfo& frameInfo, const VkPipelineLayout& pipelineLayout);
 
+        // texture streaming: requests mip levels for the projected size of the closest instance
+        void RequestTextures(const VK_FrameInfo& frameInfo, InstanceBuffer& instanceBuffer, uint instanceCount);
+
+        // levels of detail: the coarsest level per instance whose error projects to less than
+        // CoreSettings::m_LodErrorPixels, with hysteresis against popping; valid until the next call
+        uint GetNumberOfLods() const { return static_cast<uint>(m_LodErrors.size()); } // including the full mesh
+        std::vector<uint> const& SelectLods(const VK_FrameInfo& frameInfo, InstanceBuffer& instanceBuffer,
+                                            uint instanceCount);
+
+        // impostor for distant instances, baked by VK_RenderSystemImpostor; null until then
+        VK_Impostor* GetImpostor() const { return m_Impostor.get(); }
+        void SetImpostor(std::unique_ptr<VK_Impostor> impostor);
+
+        // compute skinning: Bind() and GetVertexBuffer() use the skinned vertices of the frame
+        // last passed to SetSkinnedFrame(), so the pbr and shadow pipelines draw them as static geometry
+        bool IsSkinned() const { return !m_SkinnedVertices.empty(); }
+        SkinnedVertices& GetSkinnedVertices(uint frameIndex) { return m_SkinnedVertices[frameIndex]; }
+        void SetSkinnedFrame(uint frameIndex) { m_SkinnedFrame = frameIndex; }
+        uint64 GetPose() const { return m_Pose; } // changes when UpdateAnimation() moves a joint
+        uint GetVertexCount() const { return m_VertexCount; }
+        VK_Buffer& GetBindPose() const { return *m_VertexBuffer; }
+        VK_Buffer& GetJointsBuffer() const { return *static_cast<VK_Buffer*>(m_ShaderDataUbo.get()); }
+
     private:
         void CopySubmeshes(std::vector<Submesh> const& submeshes);
+        void CreateSkinnedVertexBuffers();
+        void LoadGeometry(std::shared_ptr<MeshGeometry> const& geometry, AssetRegistry::Key const& key,
+                          std::vector<Vertex> const& vertices, std::vector<uint> const& indices,
+                          std::vector<Submesh> const& submeshes);
 
     private:
         VK_Device* m_Device;
-        std::unique_ptr<VK_Buffer> m_VertexBuffer;
+        std::shared_ptr<MeshGeometry> m_Geometry; // glTF models share their buffers via the asset registry
+        std::shared_ptr<VK_Buffer> m_VertexBuffer;
 
         uint m_VertexCount{0};
         uint m_IndexCount{0};
+        float m_BoundingRadius{0.0f}; // model space, centered at the origin
 
         bool m_HasIndexBuffer{false};
-        std::unique_ptr<VK_Buffer> m_IndexBuffer;
+        std::shared_ptr<VK_Buffer> m_IndexBuffer;
 
         std::vector<VK_Submesh> m_SubmeshesPbrMap{};
         std::vector<VK_Submesh> m_SubmeshesPbrSAMap{};
         std::vector<VK_Submesh> m_SubmeshesCubemap{};
+
+        std::vector<float> m_LodErrors{0.0f}; // per level, the largest error of all pbr submeshes
+        std::vector<uint> m_InstanceLods;     // selected in the previous frame
+
+        std::unique_ptr<VK_Impostor> m_Impostor;
+
+        std::vector<SkinnedVertices> m_SkinnedVertices; // empty without a skeleton
+        uint m_SkinnedFrame{0};
+        uint64 m_Pose{0};
+        std::vector<glm::mat4> m_PoseJoints; // the joint matrices of m_Pose
     };
 } // namespace GfxRenderEngine
@@ -29,10 +29,11 @@ namespace GfxRenderEngine
 {
 
     VK_Pipeline::VK_Pipeline(VK_Device* device, const std::string& filePathVertexShader_SPV,
-                             const std::string& filePathFragmentShader_SPV, const PipelineConfigInfo& spec)
+                             const std::string& filePathFragmentShader_SPV, const PipelineConfigInfo& spec,
+                             const VkSpecializationInfo* fragmentSpecialization)
         : m_Device(device)
     {
-        CreateGraphicsPipeline(filePathVertexShader_SPV, filePathFragmentShader_SPV, spec);
+        CreateGraphicsPipeline(filePathVertexShader_SPV, filePathFragmentShader_SPV, spec, fragmentSpecialization);
     }
 
     VK_Pipeline::~VK_Pipeline()
@@ -64,7 +65,8 @@ namespace GfxRenderEngine
 
     void VK_Pipeline::CreateGraphicsPipeline(const std::string& filePathVertexShader_SPV,
                                              const std::string& filePathFragmentShader_SPV,
-                                             const PipelineConfigInfo& configInfo)
+                                             const PipelineConfigInfo& configInfo,
+                                             const VkSpecializationInfo* fragmentSpecialization)
     {
         ASSERT(configInfo.pipelineLayout != nullptr);
         ASSERT(configInfo.renderPass != nullptr);
@@ -92,7 +94,7 @@ namespace GfxRenderEngine
         shaderStages[1].pName = "main";
         shaderStages[1].flags = 0;
         shaderStages[1].pNext = nullptr;
-        shaderStages[1].pSpecializationInfo = nullptr;
+        shaderStages[1].pSpecializationInfo = fragmentSpecialization;
 
         auto& bindingDescription = configInfo.m_BindingDescriptions;
         auto& attributeDescription = configInfo.m_AttributeDescriptions;
@@ -130,8 +132,8 @@ namespace GfxRenderEngine
         pipelineInfo.basePipelineIndex = -1;
         pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-        if (vkCreateGraphicsPipelines(m_Device->Device(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_GraphicsPipeline) !=
-            VK_SUCCESS)
+        if (vkCreateGraphicsPipelines(m_Device->Device(), m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr,
+                                      &m_GraphicsPipeline) != VK_SUCCESS)
         {
             LOG_CORE_CRITICAL("failed to create graphics pipeline");
         }
@@ -56,8 +56,10 @@ namespace GfxRenderEngine
     {
 
     public:
+        // fragmentSpecialization: optional specialization constants of the fragment shader
         VK_Pipeline(VK_Device* device, const std::string& filePathVertexShader_SPV,
-                    const std::string& filePathFragmentShader_SPV, const PipelineConfigInfo& spec);
+                    const std::string& filePathFragmentShader_SPV, const PipelineConfigInfo& spec,
+                    const VkSpecializationInfo* fragmentSpecialization = nullptr);
         ~VK_Pipeline();
 
         VK_Pipeline(const VK_Pipeline&) = delete;
@@ -68,11 +70,12 @@ namespace GfxRenderEngine
         static void DefaultPipelineConfigInfo(PipelineConfigInfo& configInfo);
         static void SetColorBlendState(PipelineConfigInfo& configInfo, int attachmentCount,
                                        const VkPipelineColorBlendAttachmentState* blendAttachments);
+        static std::vector<char> readFile(const std::string& filepath);
 
     private:
-        static std::vector<char> readFile(const std::string& filepath);
         void CreateGraphicsPipeline(const std::string& filePathVertexShader_SPV,
-                                    const std::string& filePathFragmentShader_SPV, const PipelineConfigInfo& configInfo);
+                                    const std::string& filePathFragmentShader_SPV, const PipelineConfigInfo& configInfo,
+                                    const VkSpecializationInfo* fragmentSpecialization);
         void CreateShaderModule(const std::vector<char>& code, VkShaderModule* shaderModule);
 
     private:
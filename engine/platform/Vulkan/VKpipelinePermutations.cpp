@@ -0,0 +1,89 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include "core.h"
+#include "auxiliary/instrumentation.h"
+
+#include "VKpipelinePermutations.h"
+
+namespace GfxRenderEngine
+{
+    VK_PipelinePermutations::VK_PipelinePermutations(VK_Device* device, std::string const& filePathVertexShader_SPV,
+                                                     std::string const& filePathFragmentShader_SPV,
+                                                     PipelineConfigInfo const& configInfo, uint featureMask)
+        : m_Device{device}, m_VertexShader{filePathVertexShader_SPV}, m_FragmentShader{filePathFragmentShader_SPV},
+          m_ConfigInfo{configInfo}, m_FeatureMask{featureMask}
+    {
+        // the config info points to blend attachments and dynamic states owned by the caller
+        m_BlendAttachments.assign(configInfo.colorBlendInfo.pAttachments,
+                                  configInfo.colorBlendInfo.pAttachments + configInfo.colorBlendInfo.attachmentCount);
+        m_ConfigInfo.colorBlendInfo.pAttachments = m_BlendAttachments.data();
+        m_ConfigInfo.dynamicStateInfo.pDynamicStates = m_ConfigInfo.dynamicStateEnables.data();
+
+        m_UberPipeline = std::make_unique<VK_Pipeline>(m_Device, m_VertexShader, m_FragmentShader, m_ConfigInfo);
+    }
+
+    VK_PipelinePermutations::~VK_PipelinePermutations()
+    {
+        for (auto& [features, permutation] : m_Permutations)
+        {
+            if (permutation->m_Compile.valid())
+            {
+                permutation->m_Compile.wait();
+            }
+        }
+    }
+
+    VK_Pipeline* VK_PipelinePermutations::GetPipeline(uint features)
+    {
+        features &= m_FeatureMask;
+        auto& permutation = m_Permutations[features];
+        if (!permutation)
+        {
+            permutation = std::make_unique<Permutation>();
+            Permutation* newPermutation = permutation.get();
+            permutation->m_Compile = Engine::m_Engine->m_PoolSecondary.SubmitTask(
+                [this, newPermutation, features]() { Compile(*newPermutation, features); });
+        }
+        return permutation->m_Ready.load(std::memory_order_acquire) ? permutation->m_Pipeline.get() : m_UberPipeline.get();
+    }
+
+    void VK_PipelinePermutations::Compile(Permutation& permutation, uint features)
+    {
+        ZoneScopedN("VK_PipelinePermutations::Compile");
+        int specializedFeatures = static_cast<int>(features);
+        VkSpecializationMapEntry mapEntry{};
+        mapEntry.constantID = 0;
+        mapEntry.offset = 0;
+        mapEntry.size = sizeof(int);
+
+        VkSpecializationInfo specializationInfo{};
+        specializationInfo.mapEntryCount = 1;
+        specializationInfo.pMapEntries = &mapEntry;
+        specializationInfo.dataSize = sizeof(int);
+        specializationInfo.pData = &specializedFeatures;
+
+        permutation.m_Pipeline =
+            std::make_unique<VK_Pipeline>(m_Device, m_VertexShader, m_FragmentShader, m_ConfigInfo, &specializationInfo);
+        permutation.m_Ready.store(true, std::memory_order_release);
+    }
+} // namespace GfxRenderEngine
@@ -0,0 +1,81 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "engine.h"
+
+#include "VKpipeline.h"
+
+namespace GfxRenderEngine
+{
+    // Pipelines of one shader pair specialized by material features.
+    // The fragment shader reads the features from specialization constant 0,
+    // so the branches on them are removed when a permutation is compiled.
+    // Permutations compile on the thread pool when first requested,
+    // the uber-shader pipeline (features read at runtime) is used until they are ready.
+    class VK_PipelinePermutations
+    {
+    public:
+        // featureMask: the features the fragment shader branches on, other bits do not create permutations
+        VK_PipelinePermutations(VK_Device* device, std::string const& filePathVertexShader_SPV,
+                                std::string const& filePathFragmentShader_SPV, PipelineConfigInfo const& configInfo,
+                                uint featureMask);
+        ~VK_PipelinePermutations();
+
+        VK_PipelinePermutations(const VK_PipelinePermutations&) = delete;
+        VK_PipelinePermutations& operator=(const VK_PipelinePermutations&) = delete;
+
+        // main thread
+        VK_Pipeline* GetPipeline(uint features);
+        VK_Pipeline* GetUberPipeline() const { return m_UberPipeline.get(); }
+
+    private:
+        struct Permutation
+        {
+            std::unique_ptr<VK_Pipeline> m_Pipeline;
+            std::atomic<bool> m_Ready{false};
+            std::future<void> m_Compile;
+        };
+
+    private:
+        void Compile(Permutation& permutation, uint features);
+
+    private:
+        VK_Device* m_Device;
+        std::string m_VertexShader;
+        std::string m_FragmentShader;
+        PipelineConfigInfo m_ConfigInfo; // points to the copies below
+        std::vector<VkPipelineColorBlendAttachmentState> m_BlendAttachments;
+        uint m_FeatureMask;
+
+        std::unique_ptr<VK_Pipeline> m_UberPipeline;
+        std::unordered_map<uint, std::unique_ptr<Permutation>> m_Permutations;
+    };
+} // namespace GfxRenderEngine
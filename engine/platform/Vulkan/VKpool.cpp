@@ -28,7 +28,7 @@
 namespace GfxRenderEngine
 {
     VK_Pool::VK_Pool(VkDevice& device, QueueFamilyIndices& queueFamilyIndices, ThreadPool& threadPoolPrimary,
-                     ThreadPool& threadPoolSecondary)
+                     ThreadPool& threadPoolSecondary, bool updateAfterBind)
         : m_Device{device}, m_QueueFamilyIndices{queueFamilyIndices}, m_PoolPrimary(threadPoolPrimary),
           m_PoolSecondary(threadPoolSecondary)
     {
@@ -47,15 +47,18 @@ namespace GfxRenderEngine
             return commandPool;
         };
 
-        auto createDescriptorPool = [device]()
+        auto createDescriptorPool = [device, updateAfterBind]()
         {
             static constexpr uint POOL_SIZE = 10000;
             std::unique_ptr<VK_DescriptorPool> descriptorPool =
                 VK_DescriptorPool::Builder(device)
                     .AddPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, POOL_SIZE)
+                    .AddPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, POOL_SIZE)
                     .AddPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, POOL_SIZE)
                     .AddPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, POOL_SIZE)
                     .AddPoolSize(VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, POOL_SIZE)
+                    .AddPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, POOL_SIZE)
+                    .SetPoolFlags(updateAfterBind ? VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT : 0)
                     .Build();
             return descriptorPool;
         };
@@ -34,8 +34,9 @@ namespace GfxRenderEngine
     {
 
     public:
+        // updateAfterBind: descriptor pools can allocate sets with update-after-bind bindings
         VK_Pool(VkDevice& device, QueueFamilyIndices& queueFamilyIndices, ThreadPool& threadPoolPrimary,
-                ThreadPool& threadPoolSecondary);
+                ThreadPool& threadPoolSecondary, bool updateAfterBind);
         ~VK_Pool();
 
         VkCommandPool& GetCommandPool();
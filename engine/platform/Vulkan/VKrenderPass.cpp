@@ -20,7 +20,11 @@
    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
+#include <algorithm>
+#include <cmath>
+
 #include "engine.h"
+#include "coreSettings.h"
 
 #include "auxiliary/instrumentation.h"
 
@@ -34,7 +38,8 @@ namespace GfxRenderEngine
 {
 
     VK_RenderPass::VK_RenderPass(VK_SwapChain* swapChain)
-        : m_RenderPassExtent{swapChain->GetSwapChainExtent()}, m_SwapChain{swapChain}
+        : m_RenderPassExtent{swapChain->GetSwapChainExtent()}, m_RenderExtent{swapChain->GetSwapChainExtent()},
+          m_SwapChain{swapChain}
     {
         m_Device = VK_Core::m_Device;
 
@@ -45,12 +50,24 @@ namespace GfxRenderEngine
         m_BufferMaterialFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
         m_BufferEmissionFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
 
-        Create3DRenderPass();
+        // bloom mip chain of the emission image, the last level must have at least one texel
+        m_EmissionMipLevels = static_cast<uint>(std::clamp(CoreSettings::m_BloomMipLevels, 2, BLOOM_MAX_MIP_LEVELS));
+        uint shortSide = std::min(m_RenderPassExtent.width, m_RenderPassExtent.height);
+        while ((m_EmissionMipLevels > 2) && ((shortSide >> (m_EmissionMipLevels - 1)) == 0))
+        {
+            --m_EmissionMipLevels;
+        }
+
+        for (uint phase = 0; phase < static_cast<uint>(Phase3D::NUMBER_OF_PHASES); ++phase)
+        {
+            Create3DRenderPass(static_cast<Phase3D>(phase));
+        }
         CreatePostProcessingRenderPass();
         CreateGUIRenderPass();
 
         CreateColorAttachmentResources();
         CreateDepthResources();
+        CreateSampler();
 
         CreateGBufferImages();
         CreateGBufferImageViews();
@@ -70,6 +87,8 @@ namespace GfxRenderEngine
         vkDestroyImage(m_Device->Device(), m_ColorAttachmentImage, nullptr);
         vkFreeMemory(m_Device->Device(), m_ColorAttachmentImageMemory, nullptr);
 
+        vkDestroySampler(m_Device->Device(), m_Sampler, nullptr);
+
         for (auto framebuffer : m_3DFramebuffers)
         {
             vkDestroyFramebuffer(m_Device->Device(), framebuffer, nullptr);
@@ -83,7 +102,10 @@ namespace GfxRenderEngine
             vkDestroyFramebuffer(m_Device->Device(), framebuffer, nullptr);
         }
 
-        vkDestroyRenderPass(m_Device->Device(), m_3DRenderPass, nullptr);
+        for (auto renderPass : m_3DRenderPasses)
+        {
+            vkDestroyRenderPass(m_Device->Device(), renderPass, nullptr);
+        }
         vkDestroyRenderPass(m_Device->Device(), m_PostProcessingRenderPass, nullptr);
         vkDestroyRenderPass(m_Device->Device(), m_GUIRenderPass, nullptr);
 
@@ -105,7 +127,7 @@ namespace GfxRenderEngine
         imageInfo.format = format;
         imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
         imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT; // upscaled in post processing
         imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
         imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
         imageInfo.flags = 0;
@@ -130,6 +152,44 @@ namespace GfxRenderEngine
         }
     }
 
+    void VK_RenderPass::CreateSampler()
+    {
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = VK_FILTER_LINEAR;
+        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.anisotropyEnable = VK_FALSE;
+        samplerInfo.maxAnisotropy = 1.0f;
+        samplerInfo.compareEnable = VK_FALSE;
+        samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+        samplerInfo.minLod = 0.0f;
+        samplerInfo.maxLod = 0.0f; // level 0 of the emission
+        samplerInfo.unnormalizedCoordinates = VK_FALSE;
+
+        if (vkCreateSampler(m_Device->Device(), &samplerInfo, nullptr, &m_Sampler) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to create sampler!");
+        }
+    }
+
+    void VK_RenderPass::SetRenderScale(float renderScale)
+    {
+        m_RenderScale = std::clamp(renderScale, 0.1f, 1.0f);
+        m_RenderExtent = ScaleExtent(m_RenderPassExtent, m_RenderScale);
+    }
+
+    VkExtent2D VK_RenderPass::ScaleExtent(VkExtent2D const& extent, float scale)
+    {
+        // rounded up, the shaders that bound the rendered part of a mip level round the same way
+        uint width = static_cast<uint>(std::ceil(static_cast<float>(extent.width) * scale));
+        uint height = static_cast<uint>(std::ceil(static_cast<float>(extent.height) * scale));
+        return {std::clamp(width, 1u, extent.width), std::clamp(height, 1u, extent.height)};
+    }
+
     void VK_RenderPass::CreateDepthResources()
     {
         VkFormat depthFormat = m_Device->FindDepthFormat();
@@ -146,7 +206,7 @@ namespace GfxRenderEngine
         imageInfo.format = depthFormat;
         imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
         imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT; // depth pyramid
         imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
         imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
         imageInfo.flags = 0;
@@ -181,7 +241,7 @@ namespace GfxRenderEngine
 
             VkFramebufferCreateInfo framebufferInfo = {};
             framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-            framebufferInfo.renderPass = m_3DRenderPass;
+            framebufferInfo.renderPass = m_3DRenderPasses[static_cast<uint>(Phase3D::PHASE_SINGLE)]; // all phases compatible
             framebufferInfo.attachmentCount = static_cast<uint>(RenderTargets3D::NUMBER_OF_ATTACHMENTS);
             framebufferInfo.pAttachments = attachments.data();
             framebufferInfo.width = m_RenderPassExtent.width;
@@ -201,7 +261,7 @@ namespace GfxRenderEngine
         for (size_t i = 0; i < m_SwapChain->ImageCount(); i++)
         {
             std::array<VkImageView, static_cast<uint>(RenderTargetsPostProcessing::NUMBER_OF_ATTACHMENTS)> attachments = {
-                m_SwapChain->GetImageView(i), m_ColorAttachmentView, m_GBufferEmissionView};
+                m_SwapChain->GetImageView(i)};
 
             VkFramebufferCreateInfo framebufferInfo = {};
             framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
@@ -337,13 +397,14 @@ namespace GfxRenderEngine
             imageInfo.extent.width = m_RenderPassExtent.width;
             imageInfo.extent.height = m_RenderPassExtent.height;
             imageInfo.extent.depth = 1;
-            imageInfo.mipLevels = VK_RenderSystemBloom::NUMBER_OF_MIPMAPS;
+            imageInfo.mipLevels = m_EmissionMipLevels;
             imageInfo.arrayLayers = 1;
             imageInfo.format = m_BufferEmissionFormat;
             imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
             imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            imageInfo.usage =
-                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+            // storage: the compute bloom writes the mip chain
+            imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT |
+                              VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT;
             imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
             imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
             imageInfo.flags = 0;
@@ -461,7 +522,7 @@ namespace GfxRenderEngine
         }
     }
 
-    void VK_RenderPass::Create3DRenderPass()
+    void VK_RenderPass::Create3DRenderPass(Phase3D phase)
     {
         // ATTACHMENT_COLOR
         VkAttachmentDescription colorAttachment = {};
@@ -636,7 +697,7 @@ namespace GfxRenderEngine
         subpassTransparency.preserveAttachmentCount = 0;
         subpassTransparency.pPreserveAttachments = nullptr;
 
-        constexpr uint NUMBER_OF_DEPENDENCIES = 4;
+        constexpr uint NUMBER_OF_DEPENDENCIES = 6;
         std::array<VkSubpassDependency, NUMBER_OF_DEPENDENCIES> dependencies;
 
         // lighting depends on geometry
@@ -679,6 +740,51 @@ namespace GfxRenderEngine
         dependencies[3].dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
         dependencies[3].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
 
+        // occlusion culling: the depth pyramid is built from the depth of the first phase
+        dependencies[4].srcSubpass = static_cast<uint>(SubPasses3D::SUBPASS_GEOMETRY);
+        dependencies[4].dstSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[4].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependencies[4].dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        dependencies[4].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependencies[4].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        dependencies[4].dependencyFlags = 0;
+
+        // the second phase continues on the depth and g buffer of the first phase, after the pyramid was built
+        dependencies[5].srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[5].dstSubpass = static_cast<uint>(SubPasses3D::SUBPASS_GEOMETRY);
+        dependencies[5].srcStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+                                       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependencies[5].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                       VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+                                       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependencies[5].srcAccessMask =
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        dependencies[5].dstAccessMask =
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+            VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        dependencies[5].dependencyFlags = 0;
+
+        // only load and store operations and layouts differ between the phases, which keeps them compatible
+        if (phase == Phase3D::PHASE_FIRST)
+        {
+            // nothing is lit in the first phase, depth is sampled for the depth pyramid
+            colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        }
+        else if (phase == Phase3D::PHASE_SECOND)
+        {
+            depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+            depthAttachment.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+            for (auto gBufferAttachment : {&gBufferPositionAttachment, &gBufferNormalAttachment, &gBufferColorAttachment,
+                                           &gBufferMaterialAttachment, &gBufferEmissionAttachment})
+            {
+                gBufferAttachment->loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+                gBufferAttachment->initialLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            }
+        }
+
         // render pass
         std::array<VkAttachmentDescription, static_cast<uint>(RenderTargets3D::NUMBER_OF_ATTACHMENTS)> attachments = {
             colorAttachment,        depthAttachment,           gBufferPositionAttachment, gBufferNormalAttachment,
@@ -695,7 +801,8 @@ namespace GfxRenderEngine
         renderPassInfo.dependencyCount = NUMBER_OF_DEPENDENCIES;
         renderPassInfo.pDependencies = dependencies.data();
 
-        if (vkCreateRenderPass(m_Device->Device(), &renderPassInfo, nullptr, &m_3DRenderPass) != VK_SUCCESS)
+        if (vkCreateRenderPass(m_Device->Device(), &renderPassInfo, nullptr,
+                               &m_3DRenderPasses[static_cast<uint>(phase)]) != VK_SUCCESS)
         {
             LOG_CORE_CRITICAL("failed to create render pass!");
         }
@@ -718,48 +825,15 @@ namespace GfxRenderEngine
         colorAttachmentRef.attachment = static_cast<uint>(RenderTargetsPostProcessing::ATTACHMENT_COLOR);
         colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
-        // INPUT_ATTACHMENT_3DPASS_COLOR
-        VkAttachmentDescription inputAttachment3DPassColor = {};
-        inputAttachment3DPassColor.format = m_SwapChain->GetSwapChainImageFormat();
-        inputAttachment3DPassColor.samples = VK_SAMPLE_COUNT_1_BIT;
-        inputAttachment3DPassColor.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
-        inputAttachment3DPassColor.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-        inputAttachment3DPassColor.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        inputAttachment3DPassColor.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        inputAttachment3DPassColor.initialLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        inputAttachment3DPassColor.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        // INPUT_ATTACHMENT_GBUFFER_EMISSION
-        VkAttachmentDescription inputAttachmentgBufferEmission = {};
-        inputAttachmentgBufferEmission.format = m_BufferEmissionFormat;
-        inputAttachmentgBufferEmission.samples = VK_SAMPLE_COUNT_1_BIT;
-        inputAttachmentgBufferEmission.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
-        inputAttachmentgBufferEmission.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-        inputAttachmentgBufferEmission.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        inputAttachmentgBufferEmission.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        inputAttachmentgBufferEmission.initialLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        inputAttachmentgBufferEmission.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        // input attachments
-        VkAttachmentReference gColorInputAttachmentRef = {};
-        gColorInputAttachmentRef.attachment = static_cast<uint>(RenderTargetsPostProcessing::INPUT_ATTACHMENT_3DPASS_COLOR);
-        gColorInputAttachmentRef.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkAttachmentReference gBufferEmissionInputAttachmentRef = {};
-        gBufferEmissionInputAttachmentRef.attachment =
-            static_cast<uint>(RenderTargetsPostProcessing::INPUT_ATTACHMENT_GBUFFER_EMISSION);
-        gBufferEmissionInputAttachmentRef.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        std::array<VkAttachmentReference, NUMBER_OF_POSTPROCESSING_INPUT_ATTACHMENTS> inputAttachments = {
-            gColorInputAttachmentRef, gBufferEmissionInputAttachmentRef};
-
         // subpass
+        // the 3D pass color and the emission are sampled in SHADER_READ_ONLY_OPTIMAL,
+        // input attachments cannot be read at another resolution than the one they were rendered at
         VkSubpassDescription subpassPostProcessing = {};
         subpassPostProcessing.flags = 0;
         subpassPostProcessing.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        subpassPostProcessing.inputAttachmentCount = NUMBER_OF_POSTPROCESSING_INPUT_ATTACHMENTS;
-        subpassPostProcessing.pInputAttachments = inputAttachments.data();
-        subpassPostProcessing.colorAttachmentCount = NUMBER_OF_POSTPROCESSING_OUPUT_ATTACHMENTS;
+        subpassPostProcessing.inputAttachmentCount = 0;
+        subpassPostProcessing.pInputAttachments = nullptr;
+        subpassPostProcessing.colorAttachmentCount = 1;
         subpassPostProcessing.pColorAttachments = &colorAttachmentRef;
         subpassPostProcessing.pResolveAttachments = nullptr;
         subpassPostProcessing.pDepthStencilAttachment = nullptr;
@@ -769,13 +843,15 @@ namespace GfxRenderEngine
         constexpr uint NUMBER_OF_DEPENDENCIES = 2;
         std::array<VkSubpassDependency, NUMBER_OF_DEPENDENCIES> dependencies;
 
+        // the 3D pass and the bloom render passes or dispatches wrote the sampled images
         dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
         dependencies[0].dstSubpass = static_cast<uint>(SubPassesPostProcessing::SUBPASS_BLOOM);
-        dependencies[0].srcStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-        dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dependencies[0].srcAccessMask = VK_ACCESS_MEMORY_READ_BIT;
-        dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        dependencies[0].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+        dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        dependencies[0].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependencies[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        dependencies[0].dstAccessMask =
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        dependencies[0].dependencyFlags = 0;
 
         dependencies[1].srcSubpass = static_cast<uint>(SubPassesPostProcessing::SUBPASS_BLOOM);
         dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
@@ -787,7 +863,7 @@ namespace GfxRenderEngine
 
         // render pass
         std::array<VkAttachmentDescription, static_cast<uint>(RenderTargetsPostProcessing::NUMBER_OF_ATTACHMENTS)>
-            attachments = {colorAttachment, inputAttachment3DPassColor, inputAttachmentgBufferEmission};
+            attachments = {colorAttachment};
         std::array<VkSubpassDescription, static_cast<uint>(SubPassesPostProcessing::NUMBER_OF_SUBPASSES)> subpasses = {
             subpassPostProcessing};
 
@@ -22,12 +22,15 @@
 
 #pragma once
 
+#include <array>
 #include <vulkan/vulkan.h>
 #include "VKswapChain.h"
 
 #include "engine.h"
 #include "VKcore.h"
 
+#include "systems/bloom/bloom.h"
+
 namespace GfxRenderEngine
 {
     class VK_RenderPass
@@ -54,17 +57,26 @@ namespace GfxRenderEngine
             NUMBER_OF_ATTACHMENTS
         };
 
+        // the 3D pass and two compatible halves of it for occlusion culling:
+        // the first phase clears and stores depth and g buffer, the second phase loads them
+        enum class Phase3D
+        {
+            PHASE_SINGLE = 0,
+            PHASE_FIRST,
+            PHASE_SECOND,
+            NUMBER_OF_PHASES
+        };
+
         enum class SubPassesPostProcessing
         {
             SUBPASS_BLOOM = 0,
             NUMBER_OF_SUBPASSES
         };
 
+        // the 3D pass color and the emission are sampled, they are upscaled from the render extent
         enum class RenderTargetsPostProcessing
         {
             ATTACHMENT_COLOR = 0,
-            INPUT_ATTACHMENT_3DPASS_COLOR,
-            INPUT_ATTACHMENT_GBUFFER_EMISSION,
             NUMBER_OF_ATTACHMENTS
         };
 
@@ -82,12 +94,6 @@ namespace GfxRenderEngine
 
         static constexpr int NUMBER_OF_GBUFFER_ATTACHMENTS =
             (int)RenderTargets3D::NUMBER_OF_ATTACHMENTS - (int)RenderTargets3D::ATTACHMENT_GBUFFER_POSITION;
-        static constexpr int NUMBER_OF_POSTPROCESSING_INPUT_ATTACHMENTS =
-            (int)RenderTargetsPostProcessing::NUMBER_OF_ATTACHMENTS -
-            (int)RenderTargetsPostProcessing::INPUT_ATTACHMENT_3DPASS_COLOR;
-        static constexpr int NUMBER_OF_POSTPROCESSING_OUPUT_ATTACHMENTS =
-            (int)RenderTargetsPostProcessing::INPUT_ATTACHMENT_3DPASS_COLOR; // 1st input attachment == number of output
-                                                                             // attachments
 
     public:
         VK_RenderPass(VK_SwapChain* swapChain);
@@ -102,25 +108,40 @@ namespace GfxRenderEngine
         VkImageView GetImageViewGBufferColor() { return m_GBufferColorView; }
         VkImageView GetImageViewGBufferMaterial() { return m_GBufferMaterialView; }
         VkImageView GetImageViewGBufferEmission() { return m_GBufferEmissionView; }
+        VkImageView GetImageViewDepth() const { return m_DepthImageView; } // depth aspect, sampled after the first phase
 
         VkImage GetImageEmission() const { return m_GBufferEmissionImage; }
         VkFormat GetFormatEmission() const { return m_BufferEmissionFormat; }
+        uint GetMipLevelsEmission() const { return m_EmissionMipLevels; }
 
         VkFramebuffer Get3DFrameBuffer(int index) { return m_3DFramebuffers[index]; }
         VkFramebuffer GetPostProcessingFrameBuffer(int index) { return m_PostProcessingFramebuffers[index]; }
         VkFramebuffer GetGUIFrameBuffer(int index) { return m_GUIFramebuffers[index]; }
 
-        VkRenderPass Get3DRenderPass() { return m_3DRenderPass; }
+        VkRenderPass Get3DRenderPass(Phase3D phase = Phase3D::PHASE_SINGLE)
+        {
+            return m_3DRenderPasses[static_cast<uint>(phase)];
+        }
         VkRenderPass GetPostProcessingRenderPass() { return m_PostProcessingRenderPass; }
         VkRenderPass GetGUIRenderPass() { return m_GUIRenderPass; }
 
         VkExtent2D GetExtent() const { return m_RenderPassExtent; }
 
+        // dynamic resolution: the attachments keep the swapchain extent,
+        // the 3D pass and bloom render into the top left part of them, the post processing upscales it
+        void SetRenderScale(float renderScale);
+        float GetRenderScale() const { return m_RenderScale; }
+        VkExtent2D GetRenderExtent() const { return m_RenderExtent; }
+        static VkExtent2D ScaleExtent(VkExtent2D const& extent, float scale);
+
+        VkSampler GetSampler() const { return m_Sampler; } // linear, clamp to edge, for sampling the attachments
+
     private:
         void CreateColorAttachmentResources();
+        void CreateSampler();
         void CreateDepthResources();
 
-        void Create3DRenderPass();
+        void Create3DRenderPass(Phase3D phase);
         void CreatePostProcessingRenderPass();
         void CreateGUIRenderPass();
 
@@ -136,6 +157,8 @@ namespace GfxRenderEngine
         VK_Device* m_Device;
         VK_SwapChain* m_SwapChain;     // constructor initialized
         VkExtent2D m_RenderPassExtent; // constructor initialized
+        VkExtent2D m_RenderExtent;     // constructor initialized
+        float m_RenderScale{1.0f};
 
         VkFormat m_DepthFormat{VkFormat::VK_FORMAT_UNDEFINED};
         VkFormat m_BufferPositionFormat{VkFormat::VK_FORMAT_UNDEFINED};
@@ -143,6 +166,7 @@ namespace GfxRenderEngine
         VkFormat m_BufferColorFormat{VkFormat::VK_FORMAT_UNDEFINED};
         VkFormat m_BufferMaterialFormat{VkFormat::VK_FORMAT_UNDEFINED};
         VkFormat m_BufferEmissionFormat{VkFormat::VK_FORMAT_UNDEFINED};
+        uint m_EmissionMipLevels{BLOOM_MIP_LEVELS};
 
         VkImage m_DepthImage{nullptr};
         VkImage m_ColorAttachmentImage{nullptr};
@@ -168,11 +192,13 @@ namespace GfxRenderEngine
         VkDeviceMemory m_GBufferMaterialImageMemory{nullptr};
         VkDeviceMemory m_GBufferEmissionImageMemory{nullptr};
 
+        VkSampler m_Sampler{nullptr};
+
         std::vector<VkFramebuffer> m_3DFramebuffers;
         std::vector<VkFramebuffer> m_PostProcessingFramebuffers;
         std::vector<VkFramebuffer> m_GUIFramebuffers;
 
-        VkRenderPass m_3DRenderPass{nullptr};
+        std::array<VkRenderPass, static_cast<uint>(Phase3D::NUMBER_OF_PHASES)> m_3DRenderPasses{};
         VkRenderPass m_PostProcessingRenderPass{nullptr};
         VkRenderPass m_GUIRenderPass{nullptr};
     };
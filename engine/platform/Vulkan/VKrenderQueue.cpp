@@ -0,0 +1,340 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+
+#include "auxiliary/instrumentation.h"
+
+#include "renderer/instanceBuffer.h"
+
+#include "VKmodel.h"
+#include "VKpipeline.h"
+#include "VKrenderQueue.h"
+
+namespace GfxRenderEngine
+{
+    namespace
+    {
+        // sort key layout, most significant first
+        constexpr uint PASS_BITS = 4;
+        constexpr uint PIPELINE_BITS = 8;
+        constexpr uint MATERIAL_BITS = 16;
+        constexpr uint MESH_BITS = 16;
+        constexpr uint DEPTH_BITS = 20;
+        static_assert(PASS_BITS + PIPELINE_BITS + MATERIAL_BITS + MESH_BITS + DEPTH_BITS == 64);
+
+        constexpr uint DEPTH_SHIFT = 0;
+        constexpr uint MESH_SHIFT = DEPTH_SHIFT + DEPTH_BITS;
+        constexpr uint MATERIAL_SHIFT = MESH_SHIFT + MESH_BITS;
+        constexpr uint PIPELINE_SHIFT = MATERIAL_SHIFT + MATERIAL_BITS;
+        constexpr uint PASS_SHIFT = PIPELINE_SHIFT + PIPELINE_BITS;
+
+        constexpr uint NO_MATERIAL_INDEX = std::numeric_limits<uint>::max();
+
+        constexpr uint64 Field(uint64 value, uint bits, uint shift)
+        {
+            return (std::min(value, (uint64{1} << bits) - 1)) << shift;
+        }
+    } // namespace
+
+    template <typename T> uint VK_RenderQueue::GetId(std::unordered_map<T, uint>& ids, T handle)
+    {
+        auto [iterator, inserted] = ids.try_emplace(handle, static_cast<uint>(ids.size()));
+        return iterator->second;
+    }
+
+    uint VK_RenderQueue::QuantizeDepth(float depth)
+    {
+        // the bits of a positive float sort like its value, the top bits keep a logarithmic precision
+        uint bits;
+        depth = std::max(depth, 0.0f);
+        memcpy(&bits, &depth, sizeof(bits));
+        return bits >> (32 - DEPTH_BITS);
+    }
+
+    void VK_RenderQueue::Submit(Pass pass, VK_Pipeline* pipeline, VkPipelineLayout pipelineLayout, VK_Model* model,
+                                VK_Submesh const& submesh, float depth, InstanceBuffer* instanceBuffer)
+    {
+        Submit(pass, pipeline, pipelineLayout, model, submesh, depth, 0, submesh.m_InstanceCount, instanceBuffer);
+    }
+
+    void VK_RenderQueue::Submit(Pass pass, VK_Pipeline* pipeline, VkPipelineLayout pipelineLayout, VK_Model* model,
+                                VK_Submesh const& submesh, float depth, uint firstInstance, uint instanceCount,
+                                InstanceBuffer* instanceBuffer, uint lod)
+    {
+        uint pipelineId = GetId(m_PipelineIds, pipeline);
+        uint materialId = m_BindlessDescriptorSet ? submesh.m_MaterialIndex
+                                                  : GetId(m_MaterialIds, submesh.m_MaterialDescriptor.GetDescriptorSet());
+        uint meshId = GetId(m_MeshIds, model->GetVertexBuffer());
+
+        uint64 sortKey = Field(pass, PASS_BITS, PASS_SHIFT) | Field(pipelineId, PIPELINE_BITS, PIPELINE_SHIFT) |
+                         Field(materialId, MATERIAL_BITS, MATERIAL_SHIFT) | Field(meshId, MESH_BITS, MESH_SHIFT) |
+                         Field(QuantizeDepth(depth), DEPTH_BITS, DEPTH_SHIFT);
+        m_Packets.push_back(
+            {sortKey, pipeline, pipelineLayout, model, &submesh, firstInstance, instanceCount, instanceBuffer, lod});
+    }
+
+    void VK_RenderQueue::Sort()
+    {
+        ZoneScopedN("VK_RenderQueue::Sort");
+        size_t numberOfPackets = m_Packets.size();
+        m_SortEntries.resize(numberOfPackets);
+        m_SortScratch.resize(numberOfPackets);
+        for (uint index = 0; index < numberOfPackets; ++index)
+        {
+            m_SortEntries[index] = {m_Packets[index].m_SortKey, index};
+        }
+
+        // least significant digit radix sort, eight bits per pass, stable
+        for (uint shift = 0; shift < 64; shift += 8)
+        {
+            std::array<uint, 257> offsets{};
+            for (auto& entry : m_SortEntries)
+            {
+                ++offsets[((entry.m_SortKey >> shift) & 0xff) + 1];
+            }
+            bool allEqual = std::any_of(offsets.begin(), offsets.end(),
+                                        [numberOfPackets](uint count) { return count == numberOfPackets; });
+            if (allEqual)
+            {
+                continue; // all keys share this digit
+            }
+            for (uint digit = 1; digit < offsets.size(); ++digit)
+            {
+                offsets[digit] += offsets[digit - 1];
+            }
+            for (auto& entry : m_SortEntries)
+            {
+                m_SortScratch[offsets[(entry.m_SortKey >> shift) & 0xff]++] = entry;
+            }
+            m_SortEntries.swap(m_SortScratch);
+        }
+    }
+
+    bool VK_RenderQueue::CanMerge(DrawPacket const& packet, uint instanceEnd, DrawPacket const& next) const
+    {
+        // the same submesh of the same model shares material, resources and instance buffer
+        return (next.m_Submesh == packet.m_Submesh) && (next.m_Model == packet.m_Model) &&
+               (next.m_Pipeline == packet.m_Pipeline) && (next.m_Lod == packet.m_Lod) &&
+               (next.m_FirstInstance == instanceEnd);
+    }
+
+    void VK_RenderQueue::Flush(VK_FrameInfo const& frameInfo)
+    {
+        ZoneScopedN("VK_RenderQueue::Flush");
+        Prepare(frameInfo, nullptr);
+        Record(frameInfo, VK_OcclusionCulling::PHASE_FIRST);
+        Clear();
+    }
+
+    void VK_RenderQueue::Prepare(VK_FrameInfo const& frameInfo, VK_OcclusionCulling* culling)
+    {
+        ZoneScopedN("VK_RenderQueue::Prepare");
+        m_Culling = culling;
+        m_Draws.clear();
+        if (m_Packets.empty())
+        {
+            return;
+        }
+        Sort();
+
+        uint mergedDraws = 0;
+        for (size_t index = 0; index < m_SortEntries.size(); ++index)
+        {
+            uint packetIndex = m_SortEntries[index].m_Packet;
+            DrawPacket const& packet = m_Packets[packetIndex];
+
+            uint instanceCount = packet.m_InstanceCount;
+            while ((index + 1 < m_SortEntries.size()) &&
+                   CanMerge(packet, packet.m_FirstInstance + instanceCount, m_Packets[m_SortEntries[index + 1].m_Packet]))
+            {
+                ++index;
+                instanceCount += m_Packets[m_SortEntries[index].m_Packet].m_InstanceCount;
+                ++mergedDraws;
+            }
+
+            Draw& draw = m_Draws.emplace_back(Draw{packetIndex, instanceCount, 0, 0});
+            if (culling && packet.m_InstanceBuffer && packet.m_Model->HasIndexBuffer())
+            {
+                // one sphere per instance, the instances of a merged draw may be far apart
+                float radius = packet.m_Model->GetBoundingRadius();
+                draw.m_FirstObject = culling->GetNumberOfObjects();
+                draw.m_NumberOfObjects = instanceCount;
+                for (uint instance = packet.m_FirstInstance; instance < packet.m_FirstInstance + instanceCount; ++instance)
+                {
+                    glm::vec4 sphere = VK_OcclusionCulling::BoundingSphere(
+                        packet.m_InstanceBuffer->GetModelMatrix(instance), glm::vec3(0.0f), radius);
+                    culling->AddObject(sphere, *packet.m_Submesh, instance, 1, packet.m_Lod);
+                }
+            }
+        }
+
+        if (frameInfo.m_RenderStatistics)
+        {
+            frameInfo.m_RenderStatistics->m_MergedDraws += mergedDraws;
+        }
+    }
+
+    void VK_RenderQueue::Record(VK_FrameInfo const& frameInfo, VK_OcclusionCulling::Phase phase)
+    {
+        ZoneScopedN("VK_RenderQueue::Record");
+        if (m_Draws.empty())
+        {
+            return;
+        }
+
+        VkCommandBuffer commandBuffer = frameInfo.m_CommandBuffer;
+        VK_Pipeline* boundPipeline = nullptr;
+        VkPipelineLayout boundPipelineLayout = VK_NULL_HANDLE;
+        VkBuffer boundVertexBuffer = VK_NULL_HANDLE;
+        VkDescriptorSet boundMaterial = VK_NULL_HANDLE;
+        VkDescriptorSet boundResources = VK_NULL_HANDLE;
+        uint32_t boundDynamicOffset = 0;
+        Material::PbrMaterial const* pushedMaterial = nullptr;
+        uint pushedMaterialIndex = NO_MATERIAL_INDEX;
+        uint bindsSaved = 0;
+
+        for (auto const& draw : m_Draws)
+        {
+            bool culled = draw.m_NumberOfObjects > 0;
+            if (!culled && (phase != VK_OcclusionCulling::PHASE_FIRST))
+            {
+                continue; // drawn in the first phase
+            }
+            DrawPacket const& packet = m_Packets[draw.m_Packet];
+            VK_Submesh const& submesh = *packet.m_Submesh;
+
+            if (packet.m_Pipeline != boundPipeline)
+            {
+                boundPipeline = packet.m_Pipeline;
+                boundPipeline->Bind(commandBuffer);
+            }
+            else
+            {
+                ++bindsSaved;
+            }
+            if (packet.m_PipelineLayout != boundPipelineLayout)
+            {
+                // a new pipeline layout invalidates all descriptor sets and push constants,
+                // pipeline permutations share their layout
+                boundPipelineLayout = packet.m_PipelineLayout;
+                vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, packet.m_PipelineLayout, 0, 1,
+                                        &frameInfo.m_GlobalDescriptorSet, 0, nullptr);
+                boundVertexBuffer = VK_NULL_HANDLE;
+                boundMaterial = VK_NULL_HANDLE;
+                boundResources = VK_NULL_HANDLE;
+                pushedMaterial = nullptr;
+                pushedMaterialIndex = NO_MATERIAL_INDEX;
+            }
+
+            VkBuffer vertexBuffer = packet.m_Model->GetVertexBuffer();
+            if (vertexBuffer != boundVertexBuffer)
+            {
+                packet.m_Model->Bind(commandBuffer);
+                boundVertexBuffer = vertexBuffer;
+            }
+            else
+            {
+                ++bindsSaved;
+            }
+
+            VkDescriptorSet material =
+                m_BindlessDescriptorSet ? m_BindlessDescriptorSet : submesh.m_MaterialDescriptor.GetDescriptorSet();
+            if (material != boundMaterial)
+            {
+                vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, packet.m_PipelineLayout, 1, 1,
+                                        &material, 0, nullptr);
+                boundMaterial = material;
+            }
+            else
+            {
+                ++bindsSaved;
+            }
+
+            VkDescriptorSet resources = submesh.m_ResourceDescriptor.GetDescriptorSet();
+            uint32_t dynamicOffset = submesh.m_ResourceDescriptor.GetDynamicOffset(frameInfo.m_FrameIndex);
+            if ((resources != boundResources) || (dynamicOffset != boundDynamicOffset))
+            {
+                vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, packet.m_PipelineLayout, 2, 1,
+                                        &resources, 1, &dynamicOffset);
+                boundResources = resources;
+                boundDynamicOffset = dynamicOffset;
+            }
+            else
+            {
+                ++bindsSaved;
+            }
+
+            Material::PbrMaterial const& pbrMaterial = submesh.m_Material.m_PbrMaterial;
+            if (m_BindlessDescriptorSet)
+            {
+                if (submesh.m_MaterialIndex != pushedMaterialIndex)
+                {
+                    vkCmdPushConstants(commandBuffer, packet.m_PipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                                       sizeof(uint), &submesh.m_MaterialIndex);
+                    pushedMaterialIndex = submesh.m_MaterialIndex;
+                }
+                else
+                {
+                    ++bindsSaved;
+                }
+            }
+            else if (!pushedMaterial || memcmp(pushedMaterial, &pbrMaterial, sizeof(Material::PbrMaterial)))
+            {
+                packet.m_Model->PushConstantsPbr(frameInfo, packet.m_PipelineLayout, submesh);
+                pushedMaterial = &pbrMaterial;
+            }
+            else
+            {
+                ++bindsSaved;
+            }
+
+            if (culled)
+            {
+                m_Culling->DrawIndirect(frameInfo, phase, draw.m_FirstObject, draw.m_NumberOfObjects);
+            }
+            else
+            {
+                packet.m_Model->DrawSubmesh(frameInfo, submesh, packet.m_FirstInstance, draw.m_InstanceCount,
+                                            packet.m_Lod);
+            }
+        }
+
+        if (frameInfo.m_RenderStatistics)
+        {
+            frameInfo.m_RenderStatistics->m_BindsSaved += bindsSaved;
+        }
+    }
+
+    void VK_RenderQueue::Clear()
+    {
+        m_Packets.clear();
+        m_Draws.clear();
+        m_Culling = nullptr;
+        m_PipelineIds.clear();
+        m_MaterialIds.clear();
+        m_MeshIds.clear();
+    }
+} // namespace GfxRenderEngine
@@ -0,0 +1,129 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+
+#include "VKframeInfo.h"
+#include "systems/culling/VKocclusionCulling.h"
+
+namespace GfxRenderEngine
+{
+    class InstanceBuffer;
+    class VK_Model;
+    class VK_Pipeline;
+    struct VK_Submesh;
+
+    // Draw packets of the geometry pass, sorted to minimize state changes.
+    // Render systems submit one packet per submesh while iterating their views.
+    // Flush() radix-sorts the packets by a 64-bit key (pass, pipeline, material,
+    // mesh, depth) and records them. It skips binds of state that is already
+    // bound, and it merges draws of the same submesh and level of detail whose instance ranges are adjacent.
+    // With occlusion culling, Prepare() adds a bounding sphere per instance of the packets
+    // that have an instance buffer, and Record() draws them indirectly once per culling phase.
+    class VK_RenderQueue
+    {
+    public:
+        enum Pass
+        {
+            PASS_GEOMETRY = 0,
+            NUMBER_OF_PASSES
+        };
+
+        struct DrawPacket
+        {
+            uint64 m_SortKey;
+            VK_Pipeline* m_Pipeline;
+            VkPipelineLayout m_PipelineLayout;
+            VK_Model* m_Model;
+            VK_Submesh const* m_Submesh;
+            uint m_FirstInstance;
+            uint m_InstanceCount;
+            InstanceBuffer* m_InstanceBuffer; // world transforms for the bounding spheres, optional
+            uint m_Lod;                       // level of detail, see VK_Model::SelectLods()
+        };
+
+    public:
+        VK_RenderQueue() = default;
+        ~VK_RenderQueue() = default;
+
+        VK_RenderQueue(const VK_RenderQueue&) = delete;
+        VK_RenderQueue& operator=(const VK_RenderQueue&) = delete;
+
+        // depth: distance to the camera, draws of the same state are sorted front to back
+        void Submit(Pass pass, VK_Pipeline* pipeline, VkPipelineLayout pipelineLayout, VK_Model* model,
+                    VK_Submesh const& submesh, float depth, InstanceBuffer* instanceBuffer = nullptr);
+        void Submit(Pass pass, VK_Pipeline* pipeline, VkPipelineLayout pipelineLayout, VK_Model* model,
+                    VK_Submesh const& submesh, float depth, uint firstInstance, uint instanceCount,
+                    InstanceBuffer* instanceBuffer = nullptr, uint lod = 0);
+
+        // sorts and records all packets, then empties the queue
+        void Flush(VK_FrameInfo const& frameInfo);
+
+        // the steps of Flush(), the occlusion culling records the queue once per phase:
+        // Prepare() sorts and merges the packets and adds the culled instances to 'culling' (optional),
+        // Record() draws the culled instances indirectly and all others in the first phase
+        void Prepare(VK_FrameInfo const& frameInfo, VK_OcclusionCulling* culling);
+        void Record(VK_FrameInfo const& frameInfo, VK_OcclusionCulling::Phase phase);
+        void Clear();
+
+        // bindless materials: set 1 is the bindless table, draws push their material index
+        void SetBindlessDescriptorSet(VkDescriptorSet descriptorSet) { m_BindlessDescriptorSet = descriptorSet; }
+
+    private:
+        struct SortEntry
+        {
+            uint64 m_SortKey;
+            uint m_Packet;
+        };
+
+        struct Draw
+        {
+            uint m_Packet;
+            uint m_InstanceCount; // merged
+            uint m_FirstObject;   // occlusion culling objects, one per instance
+            uint m_NumberOfObjects;
+        };
+
+    private:
+        void Sort();
+        bool CanMerge(DrawPacket const& packet, uint instanceEnd, DrawPacket const& next) const;
+        static uint QuantizeDepth(float depth);
+        template <typename T> static uint GetId(std::unordered_map<T, uint>& ids, T handle);
+
+    private:
+        std::vector<DrawPacket> m_Packets;
+        std::vector<SortEntry> m_SortEntries;
+        std::vector<SortEntry> m_SortScratch;
+        std::vector<Draw> m_Draws;
+        VK_OcclusionCulling* m_Culling{nullptr};
+        std::unordered_map<VK_Pipeline*, uint> m_PipelineIds; // in order of submission
+        std::unordered_map<VkDescriptorSet, uint> m_MaterialIds;
+        std::unordered_map<VkBuffer, uint> m_MeshIds;
+        VkDescriptorSet m_BindlessDescriptorSet{VK_NULL_HANDLE};
+    };
+} // namespace GfxRenderEngine
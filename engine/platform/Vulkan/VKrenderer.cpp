@@ -24,6 +24,7 @@
 #include "engine.h"
 #include "resources/resources.h"
 #include "auxiliary/file.h"
+#include "coreSettings.h"
 
 #include "shadowMapping.h"
 #include "VKrenderer.h"
@@ -52,25 +53,30 @@ namespace GfxRenderEngine
         RecreateRenderpass();
         RecreateShadowMaps();
         CreateCommandBuffers();
+        m_GpuTimer = std::make_unique<VK_GpuTimer>();
+        m_TextureStreamer = std::make_unique<VK_TextureStreamer>();
 
-        for (uint i = 0; i < m_ShadowUniformBuffers0.size(); i++)
+        for (auto& shadowUniformBuffers : m_ShadowUniformBuffers)
         {
-            m_ShadowUniformBuffers0[i] =
-                std::make_unique<VK_Buffer>(sizeof(ShadowUniformBuffer),
-                                            1, // uint instanceCount
-                                            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                                            m_Device->m_Properties.limits.minUniformBufferOffsetAlignment);
-            m_ShadowUniformBuffers0[i]->Map();
+            for (uint i = 0; i < shadowUniformBuffers.size(); i++)
+            {
+                shadowUniformBuffers[i] =
+                    std::make_unique<VK_Buffer>(sizeof(ShadowUniformBuffer),
+                                                1, // uint instanceCount
+                                                VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                                m_Device->m_Properties.limits.minUniformBufferOffsetAlignment);
+                shadowUniformBuffers[i]->Map();
+            }
         }
 
-        for (uint i = 0; i < m_ShadowUniformBuffers1.size(); i++)
+        for (uint i = 0; i < m_CascadeUniformBuffers.size(); i++)
         {
-            m_ShadowUniformBuffers1[i] =
-                std::make_unique<VK_Buffer>(sizeof(ShadowUniformBuffer),
+            m_CascadeUniformBuffers[i] =
+                std::make_unique<VK_Buffer>(sizeof(CascadeUniformBuffer),
                                             1, // uint instanceCount
                                             VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
                                             m_Device->m_Properties.limits.minUniformBufferOffsetAlignment);
-            m_ShadowUniformBuffers1[i]->Map();
+            m_CascadeUniformBuffers[i]->Map();
         }
 
         for (uint i = 0; i < m_UniformBuffers.size(); i++)
@@ -90,10 +96,8 @@ namespace GfxRenderEngine
 
         m_ShadowMapDescriptorSetLayout =
             VK_DescriptorSetLayout::Builder()
-                .AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
-                .AddBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
-                .AddBinding(2, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
-                .AddBinding(3, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
+                .AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT) // cascades
+                .AddBinding(1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)         // cascade matrices
                 .Build();
 
         m_GlobalDescriptorSetLayout =
@@ -108,35 +112,38 @@ namespace GfxRenderEngine
                 .AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT) // color map
                 .Build();
 
-        m_MaterialDescriptorSetLayouts[Mt::MtPbr] = VK_DescriptorSetLayout::Builder()
-                                                        .AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                                                                    VK_SHADER_STAGE_FRAGMENT_BIT) // diffuse color map
-                                                        .AddBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                                                                    VK_SHADER_STAGE_FRAGMENT_BIT) // normal map
-                                                        .AddBinding(2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                                                                    VK_SHADER_STAGE_FRAGMENT_BIT) // roughness metallic map
-                                                        .AddBinding(3, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                                                                    VK_SHADER_STAGE_FRAGMENT_BIT) // emissive map
-                                                        .AddBinding(4, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                                                                    VK_SHADER_STAGE_FRAGMENT_BIT) // roughness map
-                                                        .AddBinding(5, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                                                                    VK_SHADER_STAGE_FRAGMENT_BIT) // metallic map
-                                                        .Build();
+        {
+            // diffuse color, normal, roughness metallic, emissive, roughness and metallic map;
+            // the texture streamer rewrites the bindings of streamed textures while frames are in flight
+            VK_DescriptorSetLayout::Builder builder;
+            for (uint binding = 0; binding < 6; ++binding)
+            {
+                builder.AddBinding(binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT);
+                if (m_Device->m_DescriptorIndexing)
+                {
+                    builder.SetBindingFlags(binding, VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT);
+                }
+            }
+            m_MaterialDescriptorSetLayouts[Mt::MtPbr] = builder.Build();
+        }
 
         m_ResourceDescriptorSetLayouts[Rt::RtInstance] =
             VK_DescriptorSetLayout::Builder()
-                .AddBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT) // shader data for instances
+                .AddBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                            VK_SHADER_STAGE_VERTEX_BIT) // shader data for instances, one copy per frame in flight
                 .Build();
 
         m_ResourceDescriptorSetLayouts[Rt::RtInstanceSA] =
             VK_DescriptorSetLayout::Builder()
-                .AddBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT) // shader data for instances
+                .AddBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                            VK_SHADER_STAGE_VERTEX_BIT) // shader data for instances, one copy per frame in flight
                 .AddBinding(1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT) // shader data for animation
                 .Build();
 
         m_ResourceDescriptorSetLayouts[Rt::RtGrass] =
             VK_DescriptorSetLayout::Builder()
-                .AddBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT) // shader data for instances
+                .AddBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                            VK_SHADER_STAGE_VERTEX_BIT) // shader data for instances, one copy per frame in flight
                 .AddBinding(1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT) // dummy
                 .AddBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT) // shader data for height map
                 .AddBinding(3, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT) // shader parameters
@@ -157,9 +164,9 @@ namespace GfxRenderEngine
 
         m_PostProcessingDescriptorSetLayout =
             VK_DescriptorSetLayout::Builder()
-                .AddBinding(0, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, VK_SHADER_STAGE_FRAGMENT_BIT) // color input attachment
-                .AddBinding(1, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,
-                            VK_SHADER_STAGE_FRAGMENT_BIT) // g buffer emissive input attachment
+                .AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT) // 3D pass color
+                .AddBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                            VK_SHADER_STAGE_FRAGMENT_BIT) // g buffer emission with bloom
                 .Build();
 
         m_MaterialDescriptorSetLayouts[Mt::MtCubemap] =
@@ -237,20 +244,15 @@ namespace GfxRenderEngine
             gDummyBuffer->Flush();
         }
 
-        for (uint i = 0; i < VK_SwapChain::MAX_FRAMES_IN_FLIGHT; i++)
-        {
-            VkDescriptorBufferInfo shadowUBObufferInfo = m_ShadowUniformBuffers0[i]->DescriptorInfo();
-            VK_DescriptorWriter(*m_ShadowUniformBufferDescriptorSetLayout)
-                .WriteBuffer(0, shadowUBObufferInfo)
-                .Build(m_ShadowDescriptorSets0[i]);
-        }
-
-        for (uint i = 0; i < VK_SwapChain::MAX_FRAMES_IN_FLIGHT; i++)
+        for (uint cascade = 0; cascade < MAX_SHADOW_CASCADES; ++cascade)
         {
-            VkDescriptorBufferInfo shadowUBObufferInfo = m_ShadowUniformBuffers1[i]->DescriptorInfo();
-            VK_DescriptorWriter(*m_ShadowUniformBufferDescriptorSetLayout)
-                .WriteBuffer(0, shadowUBObufferInfo)
-                .Build(m_ShadowDescriptorSets1[i]);
+            for (uint i = 0; i < VK_SwapChain::MAX_FRAMES_IN_FLIGHT; i++)
+            {
+                VkDescriptorBufferInfo shadowUBObufferInfo = m_ShadowUniformBuffers[cascade][i]->DescriptorInfo();
+                VK_DescriptorWriter(*m_ShadowUniformBufferDescriptorSetLayout)
+                    .WriteBuffer(0, shadowUBObufferInfo)
+                    .Build(m_ShadowDescriptorSets[cascade][i]);
+            }
         }
 
         for (uint i = 0; i < VK_SwapChain::MAX_FRAMES_IN_FLIGHT; i++)
@@ -263,19 +265,32 @@ namespace GfxRenderEngine
                 .Build(m_GlobalDescriptorSets[i]);
         }
 
-        m_RenderSystemPbr = std::make_unique<VK_RenderSystemPbr>(m_RenderPass->Get3DRenderPass(), descriptorSetLayoutsPbr);
+        // bindless materials replace the per-material descriptor set of the pbr pipelines
+        if (m_Device->m_DescriptorIndexing && CoreSettings::m_BindlessMaterials)
+        {
+            m_BindlessTable = std::make_unique<VK_BindlessTable>(gTextureAtlas, m_Device->m_MaxBindlessTextures);
+            descriptorSetLayoutsPbr[1] = m_BindlessTable->GetDescriptorSetLayout();
+            descriptorSetLayoutsPbrSA[1] = m_BindlessTable->GetDescriptorSetLayout();
+            m_RenderQueue.SetBindlessDescriptorSet(m_BindlessTable->GetDescriptorSet());
+        }
+        bool bindless = m_BindlessTable != nullptr;
+
+        m_RenderSystemPbr =
+            std::make_unique<VK_RenderSystemPbr>(m_RenderPass->Get3DRenderPass(), descriptorSetLayoutsPbr, bindless);
         m_RenderSystemPbrSA =
-            std::make_unique<VK_RenderSystemPbrSA>(m_RenderPass->Get3DRenderPass(), descriptorSetLayoutsPbrSA);
+            std::make_unique<VK_RenderSystemPbrSA>(m_RenderPass->Get3DRenderPass(), descriptorSetLayoutsPbrSA, bindless);
+        m_Skinning = std::make_unique<VK_Skinning>();
 
         m_RenderSystemGrass =
             std::make_unique<VK_RenderSystemGrass>(m_RenderPass->Get3DRenderPass(), descriptorSetLayoutsGrass);
+        m_RenderSystemImpostor = std::make_unique<VK_RenderSystemImpostor>(
+            m_RenderPass->Get3DRenderPass(), *m_GlobalDescriptorSetLayout, *m_MaterialDescriptorSetLayouts[Mt::MtPbr]);
 
+        // the static and the dynamic shadow render passes are compatible, one pipeline serves both
         m_RenderSystemShadowInstanced = std::make_unique<VK_RenderSystemShadowInstanced>(
-            m_ShadowMap[ShadowMaps::HIGH_RES]->GetShadowRenderPass(),
-            m_ShadowMap[ShadowMaps::LOW_RES]->GetShadowRenderPass(), descriptorSetLayoutsShadowInstanced);
+            m_ShadowMap->GetShadowRenderPass(VK_ShadowMap::STATIC_CASTERS), descriptorSetLayoutsShadowInstanced);
         m_RenderSystemShadowAnimatedInstanced = std::make_unique<VK_RenderSystemShadowAnimatedInstanced>(
-            m_ShadowMap[ShadowMaps::HIGH_RES]->GetShadowRenderPass(),
-            m_ShadowMap[ShadowMaps::LOW_RES]->GetShadowRenderPass(), descriptorSetLayoutsShadowAnimatedInstanced);
+            m_ShadowMap->GetShadowRenderPass(VK_ShadowMap::STATIC_CASTERS), descriptorSetLayoutsShadowAnimatedInstanced);
 
         m_LightSystem =
             std::make_unique<VK_LightSystem>(m_Device, m_RenderPass->Get3DRenderPass(), *m_GlobalDescriptorSetLayout);
@@ -296,6 +311,7 @@ namespace GfxRenderEngine
             m_RenderPass->Get3DRenderPass(), descriptorSetLayoutsLighting, m_LightingDescriptorSets.data(),
             m_ShadowMapDescriptorSets.data());
         CreateRenderSystemBloom();
+        CreateOcclusionCulling();
 
         m_RenderSystemPostProcessing = std::make_unique<VK_RenderSystemPostProcessing>(
             m_RenderPass->GetPostProcessingRenderPass(), descriptorSetLayoutsPostProcessing,
@@ -310,24 +326,34 @@ namespace GfxRenderEngine
 
     void VK_Renderer::CreateRenderSystemBloom()
     {
+        // both paths are kept so that CoreSettings::m_ComputeBloom can switch them at runtime for comparison
         m_RenderSystemBloom = std::make_unique<VK_RenderSystemBloom>(*m_RenderPass);
+        m_RenderSystemBloomCompute = std::make_unique<VK_RenderSystemBloomCompute>(*m_RenderPass);
+    }
+
+    void VK_Renderer::CreateOcclusionCulling()
+    {
+        // the culled draws are indirect draws with several commands and a first instance
+        if (m_Device->m_MultiDrawIndirect)
+        {
+            m_OcclusionCulling = std::make_unique<VK_OcclusionCulling>(*m_RenderPass);
+        }
+        else
+        {
+            LOG_CORE_WARN("occlusion culling disabled, multiDrawIndirect not supported");
+        }
     }
 
     void VK_Renderer::CreateShadowMapDescriptorSets()
     {
         for (uint i = 0; i < VK_SwapChain::MAX_FRAMES_IN_FLIGHT; i++)
         {
-            VkDescriptorImageInfo shadowMapInfo0 = m_ShadowMap[ShadowMaps::HIGH_RES]->GetDescriptorImageInfo();
-            VkDescriptorImageInfo shadowMapInfo1 = m_ShadowMap[ShadowMaps::LOW_RES]->GetDescriptorImageInfo();
-
-            VkDescriptorBufferInfo shadowUBObufferInfo0 = m_ShadowUniformBuffers0[i]->DescriptorInfo();
-            VkDescriptorBufferInfo shadowUBObufferInfo1 = m_ShadowUniformBuffers1[i]->DescriptorInfo();
+            VkDescriptorImageInfo shadowMapInfo = m_ShadowMap->GetDescriptorImageInfo();
+            VkDescriptorBufferInfo cascadeUBObufferInfo = m_CascadeUniformBuffers[i]->DescriptorInfo();
 
             VK_DescriptorWriter(*m_ShadowMapDescriptorSetLayout)
-                .WriteImage(0, shadowMapInfo0)
-                .WriteImage(1, shadowMapInfo1)
-                .WriteBuffer(2, shadowUBObufferInfo0)
-                .WriteBuffer(3, shadowUBObufferInfo1)
+                .WriteImage(0, shadowMapInfo)
+                .WriteBuffer(1, cascadeUBObufferInfo)
                 .Build(m_ShadowMapDescriptorSets[i]);
         }
     }
@@ -370,28 +396,34 @@ namespace GfxRenderEngine
     {
         for (uint frameIndex = 0; frameIndex < VK_SwapChain::MAX_FRAMES_IN_FLIGHT; frameIndex++)
         {
-            VkDescriptorImageInfo imageInfoColorInputAttachment{};
-            imageInfoColorInputAttachment.imageView = m_RenderPass->GetImageViewColorAttachment();
-            imageInfoColorInputAttachment.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            // sampled, the post processing upscales them from the render extent
+            VkDescriptorImageInfo imageInfoColor{};
+            imageInfoColor.sampler = m_RenderPass->GetSampler();
+            imageInfoColor.imageView = m_RenderPass->GetImageViewColorAttachment();
+            imageInfoColor.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-            VkDescriptorImageInfo imageInfoGBufferEmissionInputAttachment{};
-            imageInfoGBufferEmissionInputAttachment.imageView = m_RenderPass->GetImageViewGBufferEmission();
-            imageInfoGBufferEmissionInputAttachment.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            VkDescriptorImageInfo imageInfoGBufferEmission{};
+            imageInfoGBufferEmission.sampler = m_RenderPass->GetSampler();
+            imageInfoGBufferEmission.imageView = m_RenderPass->GetImageViewGBufferEmission();
+            imageInfoGBufferEmission.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
             VK_DescriptorWriter(*m_PostProcessingDescriptorSetLayout)
-                .WriteImage(0, imageInfoColorInputAttachment)
-                .WriteImage(1, imageInfoGBufferEmissionInputAttachment)
+                .WriteImage(0, imageInfoColor)
+                .WriteImage(1, imageInfoGBufferEmission)
                 .Build(m_PostProcessingDescriptorSets[frameIndex]);
         }
     }
 
     VK_Renderer::~VK_Renderer()
     {
+        m_TextureStreamer.reset();
+        m_BindlessTable.reset();
         gTextureAtlas.reset();
         gTextureFontAtlas.reset();
         gDummyBuffer.reset();
         m_Imgui->Destroy();
         FreeCommandBuffers();
+        m_GpuTimer.reset();
     }
 
     void VK_Renderer::RecreateSwapChain()
@@ -425,9 +457,8 @@ namespace GfxRenderEngine
 
     void VK_Renderer::RecreateShadowMaps()
     {
-        // create shadow maps
-        m_ShadowMap[ShadowMaps::HIGH_RES] = std::make_unique<VK_ShadowMap>(SHADOW_MAP_HIGH_RES);
-        m_ShadowMap[ShadowMaps::LOW_RES] = std::make_unique<VK_ShadowMap>(SHADOW_MAP_LOW_RES);
+        // create shadow map cascades
+        m_ShadowMap = std::make_unique<VK_ShadowMap>(SHADOW_MAP_SIZE, CoreSettings::m_ShadowCascades);
     }
 
     void VK_Renderer::CreateCommandBuffers()
@@ -527,21 +558,22 @@ namespace GfxRenderEngine
         RecreateRenderpass();
         CreateLightingDescriptorSets();
         CreateRenderSystemBloom();
+        CreateOcclusionCulling();
         CreatePostProcessingDescriptorSets();
     }
 
-    void VK_Renderer::BeginShadowRenderPass0(VkCommandBuffer commandBuffer)
+    void VK_Renderer::BeginShadowRenderPass(VkCommandBuffer commandBuffer, VK_ShadowMap::ShadowPass pass, uint cascade)
     {
         ASSERT(m_FrameInProgress);
         ASSERT(commandBuffer == GetCurrentCommandBuffer());
 
         VkRenderPassBeginInfo renderPassInfo{};
         renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        renderPassInfo.renderPass = m_ShadowMap[ShadowMaps::HIGH_RES]->GetShadowRenderPass();
-        renderPassInfo.framebuffer = m_ShadowMap[ShadowMaps::HIGH_RES]->GetShadowFrameBuffer();
+        renderPassInfo.renderPass = m_ShadowMap->GetShadowRenderPass(pass);
+        renderPassInfo.framebuffer = m_ShadowMap->GetShadowFrameBuffer(pass, cascade);
 
         renderPassInfo.renderArea.offset = {0, 0};
-        renderPassInfo.renderArea.extent = m_ShadowMap[ShadowMaps::HIGH_RES]->GetShadowMapExtent();
+        renderPassInfo.renderArea.extent = m_ShadowMap->GetShadowMapExtent();
 
         std::array<VkClearValue, static_cast<uint>(VK_ShadowMap::ShadowRenderTargets::NUMBER_OF_ATTACHMENTS)> clearValues{};
         clearValues[0].depthStencil = {1.0f, 0};
@@ -553,110 +585,95 @@ namespace GfxRenderEngine
         VkViewport viewport{};
         viewport.x = 0.0f;
         viewport.y = 0.0f;
-        viewport.width = static_cast<float>(m_ShadowMap[ShadowMaps::HIGH_RES]->GetShadowMapExtent().width);
-        viewport.height = static_cast<float>(m_ShadowMap[ShadowMaps::HIGH_RES]->GetShadowMapExtent().height);
+        viewport.width = static_cast<float>(m_ShadowMap->GetShadowMapExtent().width);
+        viewport.height = static_cast<float>(m_ShadowMap->GetShadowMapExtent().height);
         viewport.minDepth = 0.0f;
         viewport.maxDepth = 1.0f;
-        VkRect2D scissor{{0, 0}, m_ShadowMap[ShadowMaps::HIGH_RES]->GetShadowMapExtent()};
+        VkRect2D scissor{{0, 0}, m_ShadowMap->GetShadowMapExtent()};
         vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
         vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
     }
 
-    void VK_Renderer::BeginShadowRenderPass1(VkCommandBuffer commandBuffer)
+    void VK_Renderer::SubmitShadows(Registry& registry, const std::vector<DirectionalLightComponent*>& directionalLights)
     {
-        ASSERT(m_FrameInProgress);
-        ASSERT(commandBuffer == GetCurrentCommandBuffer());
-
-        VkRenderPassBeginInfo renderPassInfo{};
-        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        renderPassInfo.renderPass = m_ShadowMap[ShadowMaps::LOW_RES]->GetShadowRenderPass();
-        renderPassInfo.framebuffer = m_ShadowMap[ShadowMaps::LOW_RES]->GetShadowFrameBuffer();
-
-        renderPassInfo.renderArea.offset = {0, 0};
-        renderPassInfo.renderArea.extent = m_ShadowMap[ShadowMaps::LOW_RES]->GetShadowMapExtent();
-
-        std::array<VkClearValue, static_cast<uint>(VK_ShadowMap::ShadowRenderTargets::NUMBER_OF_ATTACHMENTS)> clearValues{};
-        clearValues[0].depthStencil = {1.0f, 0};
-        renderPassInfo.clearValueCount = static_cast<uint>(clearValues.size());
-        renderPassInfo.pClearValues = clearValues.data();
+        RenderStatistics::CpuTimer cpuTimer(m_RenderStatistics, RenderStatistics::PASS_SHADOW);
+        VK_GpuTimer::Scope gpuTimer(*m_GpuTimer, m_CurrentCommandBuffer, RenderStatistics::PASS_SHADOW);
+        TracyVkNamedZone(m_GpuTimer->GetTracyContext(), gpuZone, m_CurrentCommandBuffer, "shadow",
+                         m_GpuTimer->GetTracyContext() && m_CurrentCommandBuffer);
+        // this function supports one directional light, its cascades are fitted to the camera
+        // only the orientation of the light view is used, further lights are ignored
+        if (directionalLights.empty() || !m_FrameInfo.m_Camera)
+        {
+            // the lighting shader expects values in the shadow map
+            m_ShadowMap->Clear(m_CurrentCommandBuffer);
+            return;
+        }
 
-        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        if (m_RenderSystemShadowInstanced->UpdateCasters(m_FrameInfo, registry))
+        {
+            m_ShadowMap->InvalidateStaticCache();
+        }
+        m_ShadowMap->Update(*m_FrameInfo.m_Camera, directionalLights[0]->m_LightView->GetViewMatrix());
 
-        VkViewport viewport{};
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = static_cast<float>(m_ShadowMap[ShadowMaps::LOW_RES]->GetShadowMapExtent().width);
-        viewport.height = static_cast<float>(m_ShadowMap[ShadowMaps::LOW_RES]->GetShadowMapExtent().height);
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-        VkRect2D scissor{{0, 0}, m_ShadowMap[ShadowMaps::LOW_RES]->GetShadowMapExtent()};
-        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-    }
+        uint numberOfCascades = m_ShadowMap->GetNumberOfCascades();
+        CascadeUniformBuffer cascadeUbo{};
+        cascadeUbo.m_NumberOfCascades = static_cast<int>(numberOfCascades);
+        for (uint cascade = 0; cascade < numberOfCascades; ++cascade)
+        {
+            auto& cascadeData = m_ShadowMap->GetCascade(cascade);
+            ShadowUniformBuffer ubo{};
+            ubo.m_Projection = cascadeData.m_Projection;
+            ubo.m_View = cascadeData.m_View;
+            m_ShadowUniformBuffers[cascade][m_CurrentFrameIndex]->WriteToBuffer(&ubo);
+            m_ShadowUniformBuffers[cascade][m_CurrentFrameIndex]->Flush();
+
+            cascadeUbo.m_ViewProjection[cascade] = cascadeData.m_ViewProjection;
+            cascadeUbo.m_SplitDepths[cascade] = cascadeData.m_SplitDepth;
+        }
+        m_CascadeUniformBuffers[m_CurrentFrameIndex]->WriteToBuffer(&cascadeUbo);
+        m_CascadeUniformBuffers[m_CurrentFrameIndex]->Flush();
 
-    void VK_Renderer::SubmitShadows(Registry& registry, const std::vector<DirectionalLightComponent*>& directionalLights)
-    {
-        // this function supports one directional light
-        // with a high-resolution and
-        // with a low-resolution component
-        // --> either both or none must be provided
-        if (directionalLights.size() == 2)
+        // static casters: only redrawn when the cascade moved, the light rotated, or static geometry changed
+        for (uint cascade = 0; cascade < numberOfCascades; ++cascade)
         {
+            if (m_ShadowMap->IsStaticCacheValid(cascade))
             {
-                ShadowUniformBuffer ubo{};
-                ubo.m_Projection = directionalLights[0]->m_LightView->GetProjectionMatrix();
-                ubo.m_View = directionalLights[0]->m_LightView->GetViewMatrix();
-                m_ShadowUniformBuffers0[m_CurrentFrameIndex]->WriteToBuffer(&ubo);
-                m_ShadowUniformBuffers0[m_CurrentFrameIndex]->Flush();
+                continue;
             }
-            {
-                ShadowUniformBuffer ubo{};
-                ubo.m_Projection = directionalLights[1]->m_LightView->GetProjectionMatrix();
-                ubo.m_View = directionalLights[1]->m_LightView->GetViewMatrix();
-                m_ShadowUniformBuffers1[m_CurrentFrameIndex]->WriteToBuffer(&ubo);
-                m_ShadowUniformBuffers1[m_CurrentFrameIndex]->Flush();
-            }
-
-            BeginShadowRenderPass0(m_CurrentCommandBuffer);
-
-            m_RenderSystemShadowInstanced->RenderEntities(m_FrameInfo, registry, directionalLights[0], 0 /* shadow pass 0*/,
-                                                          m_ShadowDescriptorSets0[m_CurrentFrameIndex]);
-            m_RenderSystemShadowAnimatedInstanced->RenderEntities(m_FrameInfo, registry, directionalLights[0],
-                                                                  0 /* shadow pass 0*/,
-                                                                  m_ShadowDescriptorSets0[m_CurrentFrameIndex]);
-            EndRenderPass(m_CurrentCommandBuffer);
-
-            BeginShadowRenderPass1(m_CurrentCommandBuffer);
-            m_RenderSystemShadowInstanced->RenderEntities(m_FrameInfo, registry, directionalLights[1], 1 /* shadow pass 1*/,
-                                                          m_ShadowDescriptorSets1[m_CurrentFrameIndex]);
-            m_RenderSystemShadowAnimatedInstanced->RenderEntities(m_FrameInfo, registry, directionalLights[1],
-                                                                  1 /* shadow pass 1*/,
-                                                                  m_ShadowDescriptorSets1[m_CurrentFrameIndex]);
+            BeginShadowRenderPass(m_CurrentCommandBuffer, VK_ShadowMap::STATIC_CASTERS, cascade);
+            m_RenderSystemShadowInstanced->RenderEntities(m_FrameInfo, registry, VK_ShadowMap::STATIC_CASTERS,
+                                                          m_ShadowDescriptorSets[cascade][m_CurrentFrameIndex]);
             EndRenderPass(m_CurrentCommandBuffer);
+            m_ShadowMap->SetStaticCacheValid(cascade);
         }
-        else
+
+        // dynamic and animated casters on top of a copy of the cache
+        m_ShadowMap->CopyStaticCache(m_CurrentCommandBuffer);
+        for (uint cascade = 0; cascade < numberOfCascades; ++cascade)
         {
-            // we still have to clear the shadow map depth buffers
-            // because the lighting shader expects values
-            BeginShadowRenderPass0(m_CurrentCommandBuffer);
-            EndRenderPass(m_CurrentCommandBuffer);
-            BeginShadowRenderPass1(m_CurrentCommandBuffer);
+            BeginShadowRenderPass(m_CurrentCommandBuffer, VK_ShadowMap::DYNAMIC_CASTERS, cascade);
+            m_RenderSystemShadowInstanced->RenderEntities(m_FrameInfo, registry, VK_ShadowMap::DYNAMIC_CASTERS,
+                                                          m_ShadowDescriptorSets[cascade][m_CurrentFrameIndex]);
+            m_RenderSystemShadowAnimatedInstanced->RenderEntities(m_FrameInfo, registry,
+                                                                  m_ShadowDescriptorSets[cascade][m_CurrentFrameIndex]);
             EndRenderPass(m_CurrentCommandBuffer);
         }
     }
 
-    void VK_Renderer::Begin3DRenderPass(VkCommandBuffer commandBuffer)
+    void VK_Renderer::Begin3DRenderPass(VkCommandBuffer commandBuffer, VK_RenderPass::Phase3D phase)
     {
         ASSERT(m_FrameInProgress);
         ASSERT(commandBuffer == GetCurrentCommandBuffer());
 
         VkRenderPassBeginInfo renderPassInfo{};
         renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        renderPassInfo.renderPass = m_RenderPass->Get3DRenderPass();
+        renderPassInfo.renderPass = m_RenderPass->Get3DRenderPass(phase);
         renderPassInfo.framebuffer = m_RenderPass->Get3DFrameBuffer(m_CurrentImageIndex);
 
+        // dynamic resolution: only the render extent of the attachments is cleared and drawn
+        VkExtent2D renderExtent = m_RenderPass->GetRenderExtent();
         renderPassInfo.renderArea.offset = {0, 0};
-        renderPassInfo.renderArea.extent = m_SwapChain->GetSwapChainExtent();
+        renderPassInfo.renderArea.extent = renderExtent;
 
         std::array<VkClearValue, static_cast<uint>(VK_RenderPass::RenderTargets3D::NUMBER_OF_ATTACHMENTS)> clearValues{};
         clearValues[0].color = {{0.01f, 0.01f, 0.01f, 1.0f}};
@@ -674,11 +691,11 @@ namespace GfxRenderEngine
         VkViewport viewport{};
         viewport.x = 0.0f;
         viewport.y = 0.0f;
-        viewport.width = static_cast<float>(m_SwapChain->GetSwapChainExtent().width);
-        viewport.height = static_cast<float>(m_SwapChain->GetSwapChainExtent().height);
+        viewport.width = static_cast<float>(renderExtent.width);
+        viewport.height = static_cast<float>(renderExtent.height);
         viewport.minDepth = 0.0f;
         viewport.maxDepth = 1.0f;
-        VkRect2D scissor{{0, 0}, m_SwapChain->GetSwapChainExtent()};
+        VkRect2D scissor{{0, 0}, renderExtent};
         vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
         vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
     }
@@ -755,15 +772,32 @@ namespace GfxRenderEngine
 
     void VK_Renderer::BeginFrame(Camera* camera)
     {
+        m_RenderStatistics.Reset();
+        m_TextureStreamer->Update(*m_SwapChain, m_RenderStatistics);
         m_CurrentCommandBuffer = BeginFrame();
         if (m_CurrentCommandBuffer)
         {
+            m_GpuTimer->BeginFrame(m_CurrentCommandBuffer, m_CurrentFrameIndex, m_RenderStatistics);
+
+            // the render extent of this frame, the attachments keep their size
+            m_RenderPass->SetRenderScale(m_DynamicResolution.Update(m_RenderStatistics));
+            m_RenderStatistics.m_RenderScale = m_RenderPass->GetRenderScale();
+            m_RenderStatistics.m_GpuFrameTimeMs = m_DynamicResolution.GetFrameTimeMs();
+            if (m_OcclusionCulling)
+            {
+                m_OcclusionCulling->BeginFrame(m_CurrentFrameIndex, m_RenderStatistics);
+            }
             m_FrameInfo = {m_CurrentFrameIndex,
                            m_CurrentImageIndex,
                            0.0f, /* m_FrameTime */
                            m_CurrentCommandBuffer,
                            camera,
-                           m_GlobalDescriptorSets[m_CurrentFrameIndex]};
+                           m_GlobalDescriptorSets[m_CurrentFrameIndex],
+                           nullptr, /* m_DiffuseDescriptorSet */
+                           &m_RenderStatistics,
+                           m_TextureStreamer.get(),
+                           &m_RenderQueue,
+                           static_cast<float>(m_SwapChain->Height())};
         }
     }
 
@@ -775,11 +809,24 @@ namespace GfxRenderEngine
             ubo.m_Projection = m_FrameInfo.m_Camera->GetProjectionMatrix();
             ubo.m_View = m_FrameInfo.m_Camera->GetViewMatrix();
             ubo.m_AmbientLightColor = {1.0f, 1.0f, 1.0f, m_AmbientLightIntensity};
+            ubo.m_CameraPosition = glm::vec4(m_FrameInfo.m_Camera->GetPosition(), 1.0f);
+            ubo.m_ImpostorFade = glm::vec4(VK_RenderSystemImpostor::GetFadeDistances(), 0.0f, 0.0f);
             m_LightSystem->Update(m_FrameInfo, ubo, registry);
             m_UniformBuffers[m_CurrentFrameIndex]->WriteToBuffer(&ubo);
             m_UniformBuffers[m_CurrentFrameIndex]->Flush();
 
-            Begin3DRenderPass(m_CurrentCommandBuffer);
+            // impostors of models seen for the first time, outside of the render pass
+            m_RenderSystemImpostor->Bake(m_FrameInfo, registry);
+
+            if (CoreSettings::m_OcclusionCulling && m_OcclusionCulling)
+            {
+                // the culling dispatches must be recorded outside of the render pass, Submit() begins it
+                m_Begin3DRenderPassPending = true;
+            }
+            else
+            {
+                Begin3DRenderPass(m_CurrentCommandBuffer);
+            }
         }
     }
 
@@ -805,31 +852,107 @@ namespace GfxRenderEngine
 
     void VK_Renderer::Submit(Scene& scene)
     {
+        if (m_Begin3DRenderPassPending)
+        {
+            SubmitOcclusionCulled(scene);
+            return;
+        }
+        RenderStatistics::CpuTimer cpuTimer(m_RenderStatistics, RenderStatistics::PASS_GEOMETRY);
         if (m_CurrentCommandBuffer)
         {
+            VK_GpuTimer::Scope gpuTimer(*m_GpuTimer, m_CurrentCommandBuffer, RenderStatistics::PASS_GEOMETRY);
+            TracyVkNamedZone(m_GpuTimer->GetTracyContext(), gpuZone, m_CurrentCommandBuffer, "geometry",
+                             m_GpuTimer->GetTracyContext() != nullptr);
             UpdateTransformCache(scene, SceneGraph::ROOT_NODE, glm::mat4(1.0f), false);
 
             auto& registry = scene.GetRegistry();
 
-            // 3D objects
+            // 3D objects, the pbr systems submit to the render queue
             m_RenderSystemPbr->RenderEntities(m_FrameInfo, registry);
             m_RenderSystemPbrSA->RenderEntities(m_FrameInfo, registry);
+            m_RenderQueue.Flush(m_FrameInfo);
+            m_RenderSystemImpostor->RenderEntities(m_FrameInfo, registry);
             m_RenderSystemGrass->RenderEntities(m_FrameInfo, registry);
         }
     }
 
+    // first phase: cull against the depth pyramid of the previous frame, draw the visible objects,
+    // second phase: build the pyramid from that depth, draw what was hidden only in the old depth but is visible now
+    void VK_Renderer::SubmitOcclusionCulled(Scene& scene)
+    {
+        auto& registry = scene.GetRegistry();
+        auto& culling = *m_OcclusionCulling;
+        {
+            RenderStatistics::CpuTimer cpuTimer(m_RenderStatistics, RenderStatistics::PASS_GEOMETRY);
+            UpdateTransformCache(scene, SceneGraph::ROOT_NODE, glm::mat4(1.0f), false);
+
+            // 3D objects, the pbr systems submit to the render queue
+            m_RenderSystemPbr->RenderEntities(m_FrameInfo, registry);
+            m_RenderSystemPbrSA->RenderEntities(m_FrameInfo, registry);
+        }
+
+        for (auto phase : {VK_OcclusionCulling::PHASE_FIRST, VK_OcclusionCulling::PHASE_SECOND})
+        {
+            {
+                RenderStatistics::CpuTimer cpuTimer(m_RenderStatistics, RenderStatistics::PASS_OCCLUSION);
+                VK_GpuTimer::Scope gpuTimer(*m_GpuTimer, m_CurrentCommandBuffer, RenderStatistics::PASS_OCCLUSION);
+                TracyVkNamedZone(m_GpuTimer->GetTracyContext(), gpuZone, m_CurrentCommandBuffer, "occlusion",
+                                 m_GpuTimer->GetTracyContext() != nullptr);
+                if (phase == VK_OcclusionCulling::PHASE_FIRST)
+                {
+                    m_RenderQueue.Prepare(m_FrameInfo, &culling);
+                    m_RenderSystemGrass->AddCullObjects(m_FrameInfo, registry, culling);
+                }
+                else
+                {
+                    culling.BuildHiZ(m_FrameInfo);
+                }
+                culling.Cull(m_FrameInfo, phase);
+            }
+
+            RenderStatistics::CpuTimer cpuTimer(m_RenderStatistics, RenderStatistics::PASS_GEOMETRY);
+            VK_GpuTimer::Scope gpuTimer(*m_GpuTimer, m_CurrentCommandBuffer, RenderStatistics::PASS_GEOMETRY);
+            TracyVkNamedZone(m_GpuTimer->GetTracyContext(), gpuZone, m_CurrentCommandBuffer, "geometry",
+                             m_GpuTimer->GetTracyContext() != nullptr);
+            bool firstPhase = (phase == VK_OcclusionCulling::PHASE_FIRST);
+            Begin3DRenderPass(m_CurrentCommandBuffer,
+                              firstPhase ? VK_RenderPass::Phase3D::PHASE_FIRST : VK_RenderPass::Phase3D::PHASE_SECOND);
+            m_RenderQueue.Record(m_FrameInfo, phase);
+            m_RenderSystemGrass->RenderEntities(m_FrameInfo, registry, culling, phase);
+            if (firstPhase)
+            {
+                // not culled, the impostors are drawn once and occlude in the depth pyramid
+                m_RenderSystemImpostor->RenderEntities(m_FrameInfo, registry);
+                // the lighting and transparency subpasses run in the second phase
+                vkCmdNextSubpass(m_CurrentCommandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+                vkCmdNextSubpass(m_CurrentCommandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+                EndRenderPass(m_CurrentCommandBuffer);
+            }
+        }
+        m_RenderQueue.Clear();
+        m_Begin3DRenderPassPending = false;
+    }
+
     void VK_Renderer::LightingPass()
     {
+        RenderStatistics::CpuTimer cpuTimer(m_RenderStatistics, RenderStatistics::PASS_LIGHTING);
         if (m_CurrentCommandBuffer)
         {
+            VK_GpuTimer::Scope gpuTimer(*m_GpuTimer, m_CurrentCommandBuffer, RenderStatistics::PASS_LIGHTING);
+            TracyVkNamedZone(m_GpuTimer->GetTracyContext(), gpuZone, m_CurrentCommandBuffer, "lighting",
+                             m_GpuTimer->GetTracyContext() != nullptr);
             m_RenderSystemDeferredShading->LightingPass(m_FrameInfo);
         }
     }
 
     void VK_Renderer::TransparencyPass(Registry& registry, ParticleSystem* particleSystem)
     {
+        RenderStatistics::CpuTimer cpuTimer(m_RenderStatistics, RenderStatistics::PASS_TRANSPARENCY);
         if (m_CurrentCommandBuffer)
         {
+            VK_GpuTimer::Scope gpuTimer(*m_GpuTimer, m_CurrentCommandBuffer, RenderStatistics::PASS_TRANSPARENCY);
+            TracyVkNamedZone(m_GpuTimer->GetTracyContext(), gpuZone, m_CurrentCommandBuffer, "transparency",
+                             m_GpuTimer->GetTracyContext() != nullptr);
             // sprites
             m_RenderSystemCubemap->RenderEntities(m_FrameInfo, registry);
             m_RenderSystemSpriteRenderer->RenderEntities(m_FrameInfo, registry);
@@ -845,9 +968,26 @@ namespace GfxRenderEngine
         if (m_CurrentCommandBuffer)
         {
             EndRenderPass(m_CurrentCommandBuffer); // end 3D renderpass
-            m_RenderSystemBloom->RenderBloom(m_FrameInfo);
+            {
+                RenderStatistics::CpuTimer cpuTimer(m_RenderStatistics, RenderStatistics::PASS_BLOOM);
+                VK_GpuTimer::Scope gpuTimer(*m_GpuTimer, m_CurrentCommandBuffer, RenderStatistics::PASS_BLOOM);
+                TracyVkNamedZone(m_GpuTimer->GetTracyContext(), gpuZone, m_CurrentCommandBuffer, "bloom",
+                                 m_GpuTimer->GetTracyContext() != nullptr);
+                if (CoreSettings::m_ComputeBloom)
+                {
+                    m_RenderSystemBloomCompute->RenderBloom(m_FrameInfo);
+                }
+                else
+                {
+                    m_RenderSystemBloom->RenderBloom(m_FrameInfo);
+                }
+            }
+            RenderStatistics::CpuTimer cpuTimer(m_RenderStatistics, RenderStatistics::PASS_POST_PROCESSING);
+            VK_GpuTimer::Scope gpuTimer(*m_GpuTimer, m_CurrentCommandBuffer, RenderStatistics::PASS_POST_PROCESSING);
+            TracyVkNamedZone(m_GpuTimer->GetTracyContext(), gpuZone, m_CurrentCommandBuffer, "postprocessing",
+                             m_GpuTimer->GetTracyContext() != nullptr);
             BeginPostProcessingRenderPass(m_CurrentCommandBuffer);
-            m_RenderSystemPostProcessing->PostProcessingPass(m_FrameInfo);
+            m_RenderSystemPostProcessing->PostProcessingPass(m_FrameInfo, m_RenderPass->GetRenderExtent());
         }
     }
 
@@ -855,6 +995,12 @@ namespace GfxRenderEngine
     {
         if (m_CurrentCommandBuffer)
         {
+            if (m_Begin3DRenderPassPending)
+            {
+                // nothing was submitted, e.g. a scene without 3D objects
+                Begin3DRenderPass(m_CurrentCommandBuffer);
+                m_Begin3DRenderPassPending = false;
+            }
             vkCmdNextSubpass(m_CurrentCommandBuffer, VK_SUBPASS_CONTENTS_INLINE);
         }
     }
@@ -865,6 +1011,7 @@ namespace GfxRenderEngine
         {
             EndRenderPass(m_CurrentCommandBuffer); // end post processing renderpass
             BeginGUIRenderPass(m_CurrentCommandBuffer);
+            m_GpuTimer->Begin(m_CurrentCommandBuffer, RenderStatistics::PASS_GUI); // ends in EndScene()
 
             // set up orthogonal camera
             m_GUIViewProjectionMatrix = camera->GetProjectionMatrix() * camera->GetViewMatrix();
@@ -873,6 +1020,7 @@ namespace GfxRenderEngine
 
     void VK_Renderer::Submit2D(Camera* camera, Registry& registry)
     {
+        RenderStatistics::CpuTimer cpuTimer(m_RenderStatistics, RenderStatistics::PASS_GUI);
         if (m_CurrentCommandBuffer)
         {
             m_RenderSystemSpriteRenderer2D->RenderEntities(m_FrameInfo, registry, camera);
@@ -883,10 +1031,16 @@ namespace GfxRenderEngine
     {
         if (m_CurrentCommandBuffer)
         {
-            // built-in editor GUI runs last
-            m_Imgui->NewFrame();
-            m_Imgui->Run();
-            m_Imgui->Render(m_CurrentCommandBuffer);
+            {
+                // built-in editor GUI runs last
+                RenderStatistics::CpuTimer cpuTimer(m_RenderStatistics, RenderStatistics::PASS_GUI);
+                TracyVkNamedZone(m_GpuTimer->GetTracyContext(), gpuZone, m_CurrentCommandBuffer, "gui",
+                                 m_GpuTimer->GetTracyContext() != nullptr);
+                m_Imgui->NewFrame();
+                m_Imgui->Run();
+                m_Imgui->Render(m_CurrentCommandBuffer);
+            }
+            m_GpuTimer->End(m_CurrentCommandBuffer, RenderStatistics::PASS_GUI);
 
             EndRenderPass(m_CurrentCommandBuffer); // end GUI render pass
             EndFrame();
@@ -901,14 +1055,26 @@ namespace GfxRenderEngine
 
     void VK_Renderer::UpdateAnimations(Registry& registry, const Timestep& timestep)
     {
-        auto view = registry.view<MeshComponent, TransformComponent, SkeletalAnimationTag>();
-        for (auto entity : view)
-        {
-            auto& mesh = view.get<MeshComponent>(entity);
-            if (mesh.m_Enabled)
+        RenderStatistics::CpuTimer cpuTimer(m_RenderStatistics, RenderStatistics::PASS_ANIMATION);
+        // each animated model has its own skeleton and shader data buffer
+        registry.ParallelEach<MeshComponent, TransformComponent, SkeletalAnimationTag>(
+            Engine::m_Engine->m_PoolPrimary, 1 /*grain size*/,
+            [&registry, &timestep, this](entt::entity entity)
             {
-                static_cast<VK_Model*>(mesh.m_Model.get())->UpdateAnimation(timestep, m_FrameCounter);
-            }
+                auto& mesh = registry.get<MeshComponent>(entity);
+                if (mesh.m_Enabled)
+                {
+                    static_cast<VK_Model*>(mesh.m_Model.get())->UpdateAnimation(timestep, m_FrameCounter);
+                }
+            });
+
+        // skinned once for the shadow cascades and the geometry pass
+        if (m_CurrentCommandBuffer)
+        {
+            VK_GpuTimer::Scope gpuTimer(*m_GpuTimer, m_CurrentCommandBuffer, RenderStatistics::PASS_ANIMATION);
+            TracyVkNamedZone(m_GpuTimer->GetTracyContext(), gpuZone, m_CurrentCommandBuffer, "animation",
+                             m_GpuTimer->GetTracyContext() != nullptr);
+            m_Skinning->Skin(m_FrameInfo, registry);
         }
     }
 
@@ -936,14 +1102,16 @@ namespace GfxRenderEngine
             "pointLight.frag",
             "pbr.vert",
             "pbr.frag",
-            "pbrSA.vert",
+            "pbrBindless.frag",
             "grass.vert",
+            "impostor.vert",
+            "impostor.frag",
+            "impostorBake.vert",
+            "impostorBake.frag",
             "deferredShading.vert",
             "deferredShading.frag",
             "skybox.vert",
             "skybox.frag",
-            "shadowShaderAnimatedInstanced.vert",
-            "shadowShaderAnimatedInstanced.frag",
             "shadowShaderInstanced.vert",
             "shadowShaderInstanced.frag",
             "debug.vert",
@@ -953,35 +1121,44 @@ namespace GfxRenderEngine
             "bloomUp.vert",
             "bloomUp.frag",
             "bloomDown.vert",
-            "bloomDown.frag"
+            "bloomDown.frag",
+            "bloomDown.comp",
+            "hiZ.comp",
+            "occlusionCulling.comp",
+            "skinning.comp",
+            "bloomUp.comp"
         };
         // clang-format on
 
-        ThreadPool& threadPool = Engine::m_Engine->m_PoolPrimary;
-        std::vector<std::future<bool>> futures;
-        futures.resize(shaderFilenames.size());
+        ThreadPool::TaskGroup compileTasks{Engine::m_Engine->m_PoolPrimary};
+        std::atomic<bool> allOk{true};
 
-        uint futureCounter = 0;
+        uint taskCounter = 0;
         for (auto& filename : shaderFilenames)
         {
-            auto compileThread = [filename, futureCounter]() -> bool
+            auto compileThread = [filename, taskCounter, &allOk]()
             {
                 ZoneScopedN("compileTread");
-                ZoneTransientN(variableName, std::string(std::to_string(futureCounter)).c_str(), true);
-                bool isOk = true;
+                ZoneTransientN(variableName, std::string(std::to_string(taskCounter)).c_str(), true);
                 std::string spirvFilename = std::string("bin-int/") + filename + std::string(".spv");
                 if (!EngineCore::FileExists(spirvFilename))
                 {
                     std::string name = std::string("engine/platform/Vulkan/shaders/") + filename;
                     VK_Shader shader{name, spirvFilename};
-                    isOk = shader.IsOk();
+                    if (!shader.IsOk())
+                    {
+                        allOk = false;
+                    }
                 }
-                return isOk;
             };
-            futures[futureCounter] = threadPool.SubmitTask(compileThread);
-            ++futureCounter;
+            compileTasks.Run(compileThread);
+            ++taskCounter;
+        }
+        compileTasks.Wait();
+        if (!allOk)
+        {
+            LOG_CORE_CRITICAL("VK_Renderer::CompileShaders: not all shaders compiled");
         }
-        threadPool.Wait();
         m_ShadersCompiled = true;
     }
 
@@ -30,6 +30,7 @@
 #include "renderer/renderer.h"
 #include "renderer/materialDescriptor.h"
 #include "renderer/resourceDescriptor.h"
+#include "renderer/dynamicResolution.h"
 #include "platform/Vulkan/imguiEngine/imgui.h"
 
 #include "systems/VKshadowAnimatedRenderSysInstanced.h"
@@ -45,6 +46,10 @@
 #include "systems/VKpbrSASys.h"
 #include "systems/VKgrassSys.h"
 #include "systems/bloom/VKbloomRenderSystem.h"
+#include "systems/bloom/VKbloomComputeSystem.h"
+#include "systems/culling/VKocclusionCulling.h"
+#include "systems/impostor/VKimpostorSys.h"
+#include "systems/skinning/VKskinning.h"
 #include "systems/VKpostprocessingSys.h"
 #include "systems/VKdeferredShading.h"
 
@@ -55,6 +60,10 @@
 #include "VKdescriptor.h"
 #include "VKtexture.h"
 #include "VKbuffer.h"
+#include "VKgpuTimer.h"
+#include "VKtextureStreamer.h"
+#include "VKrenderQueue.h"
+#include "VKbindlessTable.h"
 
 namespace GfxRenderEngine
 {
@@ -78,9 +87,9 @@ namespace GfxRenderEngine
 
         VkCommandBuffer BeginFrame();
         void EndFrame();
-        void BeginShadowRenderPass0(VkCommandBuffer commandBuffer);
-        void BeginShadowRenderPass1(VkCommandBuffer commandBuffer);
-        void Begin3DRenderPass(VkCommandBuffer commandBuffer);
+        void BeginShadowRenderPass(VkCommandBuffer commandBuffer, VK_ShadowMap::ShadowPass pass, uint cascade);
+        void Begin3DRenderPass(VkCommandBuffer commandBuffer,
+                               VK_RenderPass::Phase3D phase = VK_RenderPass::Phase3D::PHASE_SINGLE);
         void BeginPostProcessingRenderPass(VkCommandBuffer commandBuffer);
         void BeginGUIRenderPass(VkCommandBuffer commandBuffer);
         void EndRenderPass(VkCommandBuffer commandBuffer);
@@ -116,7 +125,9 @@ namespace GfxRenderEngine
 
         VK_DescriptorSetLayout& GetMaterialDescriptorSetLayout(MaterialDescriptor::MaterialType materialType);
         VK_DescriptorSetLayout& GetResourceDescriptorSetLayout(ResourceDescriptor::ResourceType resourceType);
+        VK_BindlessTable* GetBindlessTable() const { return m_BindlessTable.get(); } // null: one set per material
         virtual std::shared_ptr<Texture> GetTextureAtlas() override;
+        virtual const RenderStatistics& GetRenderStatistics() const override { return m_RenderStatistics; }
 
     public:
         std::shared_ptr<Texture> gTextureAtlas;
@@ -135,6 +146,8 @@ namespace GfxRenderEngine
         void CreateLightingDescriptorSets();
         void CreatePostProcessingDescriptorSets();
         void CreateRenderSystemBloom();
+        void CreateOcclusionCulling();
+        void SubmitOcclusionCulled(Scene& scene);
         void Recreate();
 
     private:
@@ -143,23 +156,21 @@ namespace GfxRenderEngine
         VK_Device* m_Device;
         std::unique_ptr<VK_SwapChain> m_SwapChain;
 
-        enum ShadowMaps
-        {
-            HIGH_RES = 0,
-            LOW_RES,
-            NUMBER_OF_SHADOW_MAPS
-        };
         std::unique_ptr<VK_RenderPass> m_RenderPass;
-        std::unique_ptr<VK_ShadowMap> m_ShadowMap[NUMBER_OF_SHADOW_MAPS];
+        std::unique_ptr<VK_ShadowMap> m_ShadowMap;
 
         std::unique_ptr<VK_RenderSystemPbr> m_RenderSystemPbr;
         std::unique_ptr<VK_RenderSystemPbrSA> m_RenderSystemPbrSA;
+        std::unique_ptr<VK_Skinning> m_Skinning;
         std::unique_ptr<VK_RenderSystemGrass> m_RenderSystemGrass;
+        std::unique_ptr<VK_RenderSystemImpostor> m_RenderSystemImpostor;
         std::unique_ptr<VK_RenderSystemShadowInstanced> m_RenderSystemShadowInstanced;
         std::unique_ptr<VK_RenderSystemShadowAnimatedInstanced> m_RenderSystemShadowAnimatedInstanced;
         std::unique_ptr<VK_RenderSystemDeferredShading> m_RenderSystemDeferredShading;
         std::unique_ptr<VK_RenderSystemPostProcessing> m_RenderSystemPostProcessing;
         std::unique_ptr<VK_RenderSystemBloom> m_RenderSystemBloom;
+        std::unique_ptr<VK_RenderSystemBloomCompute> m_RenderSystemBloomCompute;
+        std::unique_ptr<VK_OcclusionCulling> m_OcclusionCulling; // null without multi draw indirect
         std::unique_ptr<VK_RenderSystemCubemap> m_RenderSystemCubemap;
         std::unique_ptr<VK_RenderSystemSpriteRenderer> m_RenderSystemSpriteRenderer;
         std::unique_ptr<VK_RenderSystemSpriteRenderer2D> m_RenderSystemSpriteRenderer2D;
@@ -178,6 +189,13 @@ namespace GfxRenderEngine
         uint m_FrameCounter;
         bool m_FrameInProgress;
         VK_FrameInfo m_FrameInfo{};
+        RenderStatistics m_RenderStatistics;
+        std::unique_ptr<VK_GpuTimer> m_GpuTimer;
+        DynamicResolution m_DynamicResolution{VK_SwapChain::MAX_FRAMES_IN_FLIGHT}; // timings are read a slot later
+        std::unique_ptr<VK_TextureStreamer> m_TextureStreamer;
+        VK_RenderQueue m_RenderQueue;
+        bool m_Begin3DRenderPassPending{false}; // occlusion culling runs before the 3D pass begins
+        std::unique_ptr<VK_BindlessTable> m_BindlessTable;
 
         // *** descriptor set layouts ***
         std::unique_ptr<VK_DescriptorSetLayout> m_ShadowMapDescriptorSetLayout;
@@ -191,12 +209,14 @@ namespace GfxRenderEngine
         using Rt = ResourceDescriptor::ResourceType;
         std::array<std::unique_ptr<VK_DescriptorSetLayout>, Rt::NUM_TYPES> m_ResourceDescriptorSetLayouts;
 
-        std::array<VkDescriptorSet, VK_SwapChain::MAX_FRAMES_IN_FLIGHT> m_ShadowDescriptorSets0;
-        std::array<VkDescriptorSet, VK_SwapChain::MAX_FRAMES_IN_FLIGHT> m_ShadowDescriptorSets1;
+        // one shadow uniform buffer per cascade for the shadow passes
+        using ShadowDescriptorSets = std::array<VkDescriptorSet, VK_SwapChain::MAX_FRAMES_IN_FLIGHT>;
+        using ShadowUniformBuffers = std::array<std::unique_ptr<VK_Buffer>, VK_SwapChain::MAX_FRAMES_IN_FLIGHT>;
+        std::array<ShadowDescriptorSets, MAX_SHADOW_CASCADES> m_ShadowDescriptorSets;
+        std::array<ShadowUniformBuffers, MAX_SHADOW_CASCADES> m_ShadowUniformBuffers;
         std::array<VkDescriptorSet, VK_SwapChain::MAX_FRAMES_IN_FLIGHT> m_GlobalDescriptorSets;
         std::array<std::unique_ptr<VK_Buffer>, VK_SwapChain::MAX_FRAMES_IN_FLIGHT> m_UniformBuffers;
-        std::array<std::unique_ptr<VK_Buffer>, VK_SwapChain::MAX_FRAMES_IN_FLIGHT> m_ShadowUniformBuffers0;
-        std::array<std::unique_ptr<VK_Buffer>, VK_SwapChain::MAX_FRAMES_IN_FLIGHT> m_ShadowUniformBuffers1;
+        std::array<std::unique_ptr<VK_Buffer>, VK_SwapChain::MAX_FRAMES_IN_FLIGHT> m_CascadeUniformBuffers;
         std::array<VkDescriptorSet, VK_SwapChain::MAX_FRAMES_IN_FLIGHT> m_ShadowMapDescriptorSets;
         std::array<VkDescriptorSet, VK_SwapChain::MAX_FRAMES_IN_FLIGHT> m_LightingDescriptorSets;
         std::array<VkDescriptorSet, VK_SwapChain::MAX_FRAMES_IN_FLIGHT> m_PostProcessingDescriptorSets;
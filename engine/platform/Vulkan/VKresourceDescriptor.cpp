@@ -45,6 +45,14 @@ namespace GfxRenderEngine
         std::shared_ptr<Buffer>& instanceUbo = instBuffer ? instBuffer : gDummyBuffer;
         VK_Buffer* instanceBuffer = static_cast<VK_Buffer*>(instanceUbo.get());
         VkDescriptorBufferInfo instanceBufferInfo = instanceBuffer->DescriptorInfo();
+        if (instBuffer)
+        {
+            // bound with a dynamic offset to the copy of the current frame
+            CORE_ASSERT(instanceBuffer->GetInstanceCount() == VK_SwapChain::MAX_FRAMES_IN_FLIGHT,
+                        "instance buffer needs one copy per frame in flight");
+            instanceBufferInfo = instanceBuffer->DescriptorInfoForIndex(0);
+            m_DynamicOffsetStride = static_cast<uint>(instanceBuffer->GetAlignmentSize());
+        }
 
         // joint/bone matrices
         std::shared_ptr<Buffer>& skeletalAnimationUbo = skelBuffer ? skelBuffer : gDummyBuffer;
@@ -107,6 +115,7 @@ namespace GfxRenderEngine
     VK_ResourceDescriptor::VK_ResourceDescriptor(VK_ResourceDescriptor const& other)
     {
         m_DescriptorSet = other.m_DescriptorSet;
+        m_DynamicOffsetStride = other.m_DynamicOffsetStride;
     }
 
     VK_ResourceDescriptor::VK_ResourceDescriptor(std::shared_ptr<ResourceDescriptor> const& resourceDescriptor)
@@ -116,6 +125,7 @@ namespace GfxRenderEngine
             VK_ResourceDescriptor* other = static_cast<VK_ResourceDescriptor*>(resourceDescriptor.get());
 
             m_DescriptorSet = other->m_DescriptorSet;
+            m_DynamicOffsetStride = other->m_DynamicOffsetStride;
         }
     }
 
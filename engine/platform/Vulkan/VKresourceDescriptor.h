@@ -42,11 +42,14 @@ namespace GfxRenderEngine
 
     public:
         const VkDescriptorSet& GetDescriptorSet() const;
+        // the instance buffer holds one copy per frame in flight
+        uint GetDynamicOffset(uint frameIndex) const { return frameIndex * m_DynamicOffsetStride; }
 
     private:
         VK_DescriptorSetLayout& GetResourceDescriptorSetLayout(ResourceDescriptor::ResourceType resourcelType);
 
     private:
         VkDescriptorSet m_DescriptorSet{nullptr};
+        uint m_DynamicOffsetStride{0};
     };
 } // namespace GfxRenderEngine
@@ -100,9 +100,13 @@ namespace GfxRenderEngine
         {
             shaderType = shaderc_fragment_shader;
         }
+        else if (extension.find(".comp") != std::string::npos)
+        {
+            shaderType = shaderc_compute_shader;
+        }
         else
         {
-            LOG_CORE_ERROR("VK_Shader: Could not determine shader type from extension (allowed: .vert and .frag");
+            LOG_CORE_ERROR("VK_Shader: Could not determine shader type from extension (allowed: .vert, .frag and .comp");
             return;
         }
 
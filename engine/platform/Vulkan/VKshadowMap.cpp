@@ -20,7 +20,11 @@
    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
+#include <algorithm>
+#include <cmath>
+
 #include "engine.h"
+#include "coreSettings.h"
 
 #include "auxiliary/instrumentation.h"
 #include "platform/Vulkan/shadowMapping.h"
@@ -29,42 +33,73 @@
 
 namespace GfxRenderEngine
 {
+    namespace
+    {
+        // blend between logarithmic (1.0) and uniform (0.0) split distances
+        constexpr float SPLIT_LAMBDA = 0.75f;
+        // cascades move in steps of this many texels so that the cached layers stay valid while the camera moves
+        constexpr float SNAP_TEXELS = 32.0f;
+    } // namespace
 
-    VK_ShadowMap::VK_ShadowMap(int width)
+    VK_ShadowMap::VK_ShadowMap(int width, int numberOfCascades)
     {
         m_ShadowMapExtent.width = width;
         m_ShadowMapExtent.height = width;
+        m_NumberOfCascades = static_cast<uint>(std::clamp(numberOfCascades, 1, MAX_SHADOW_CASCADES));
         m_Device = VK_Core::m_Device;
         m_DepthFormat = m_Device->FindDepthFormat();
 
-        CreateShadowRenderPass();
+        CreateShadowRenderPass(STATIC_CASTERS);
+        CreateShadowRenderPass(DYNAMIC_CASTERS);
         CreateShadowDepthResources();
-        CreateShadowFramebuffer();
+        CreateShadowFramebuffers();
+        InvalidateStaticCache();
     }
 
     VK_ShadowMap::~VK_ShadowMap()
     {
+        for (auto& framebuffers : m_ShadowFramebuffers)
+        {
+            for (auto framebuffer : framebuffers)
+            {
+                vkDestroyFramebuffer(m_Device->Device(), framebuffer, nullptr);
+            }
+        }
+        for (uint cascade = 0; cascade < m_NumberOfCascades; ++cascade)
+        {
+            vkDestroyImageView(m_Device->Device(), m_StaticCacheLayerViews[cascade], nullptr);
+            vkDestroyImageView(m_Device->Device(), m_ShadowDepthLayerViews[cascade], nullptr);
+        }
         vkDestroyImageView(m_Device->Device(), m_ShadowDepthImageView, nullptr);
         vkDestroyImage(m_Device->Device(), m_ShadowDepthImage, nullptr);
         vkFreeMemory(m_Device->Device(), m_ShadowDepthImageMemory, nullptr);
+        vkDestroyImage(m_Device->Device(), m_StaticCacheImage, nullptr);
+        vkFreeMemory(m_Device->Device(), m_StaticCacheImageMemory, nullptr);
         vkDestroySampler(m_Device->Device(), m_ShadowDepthSampler, nullptr);
-        vkDestroyRenderPass(m_Device->Device(), m_ShadowRenderPass, nullptr);
-        vkDestroyFramebuffer(m_Device->Device(), m_ShadowFramebuffer, nullptr);
+        for (auto renderPass : m_ShadowRenderPasses)
+        {
+            vkDestroyRenderPass(m_Device->Device(), renderPass, nullptr);
+        }
     }
 
-    void VK_ShadowMap::CreateShadowRenderPass()
+    void VK_ShadowMap::CreateShadowRenderPass(ShadowPass pass)
     {
+        // both passes have the same attachment format and are therefore compatible,
+        // pipelines created for one of them can be used with the other
+        bool staticPass = (pass == STATIC_CASTERS);
+
         // ATTACHMENT_DEPTH
         VkAttachmentDescription depthAttachment{};
         depthAttachment.format = m_DepthFormat;
         depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-        depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        depthAttachment.loadOp = staticPass ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
         depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
         depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        depthAttachment.initialLayout =
+            staticPass ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL; // after CopyStaticCache()
         m_ImageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-        depthAttachment.finalLayout = m_ImageLayout;
+        depthAttachment.finalLayout = staticPass ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : m_ImageLayout;
 
         VkAttachmentReference depthAttachmentRef{};
         depthAttachmentRef.attachment = static_cast<uint>(ShadowRenderTargets::ATTACHMENT_DEPTH);
@@ -87,25 +122,27 @@ namespace GfxRenderEngine
         constexpr uint NUMBER_OF_DEPENDENCIES = 2;
         std::array<VkSubpassDependency, NUMBER_OF_DEPENDENCIES> dependencies;
 
-        dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL; // Index of the render pass being depended upon by dstSubpass
-        dependencies[0].dstSubpass =
-            static_cast<uint>(SubPassesShadow::SUBPASS_SHADOW); // The index of the render pass depending on srcSubpass
-        dependencies[0].srcStageMask =
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT; // What pipeline stage must have completed for the dependency
+        // static pass: the previous copy must have read the cache layer
+        // dynamic pass: the copy must have written the layer that is loaded
+        dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[0].dstSubpass = static_cast<uint>(SubPassesShadow::SUBPASS_SHADOW);
+        dependencies[0].srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
         dependencies[0].dstStageMask =
-            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;            // What pipeline stage is waiting on the dependency
-        dependencies[0].srcAccessMask = VK_ACCESS_SHADER_READ_BIT; // What access scopes influence the dependency
+            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependencies[0].srcAccessMask = staticPass ? VK_ACCESS_TRANSFER_READ_BIT : VK_ACCESS_TRANSFER_WRITE_BIT;
         dependencies[0].dstAccessMask =
-            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;              // What access scopes are waiting on the dependency
-        dependencies[0].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT; // Other configuration about the dependency
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependencies[0].dependencyFlags = 0;
 
+        // static pass: the cache layer is copied next
+        // dynamic pass: the layer is sampled by the lighting pass
         dependencies[1].srcSubpass = static_cast<uint>(SubPassesShadow::SUBPASS_SHADOW);
         dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
         dependencies[1].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-        dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        dependencies[1].dstStageMask = staticPass ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
         dependencies[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-        dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+        dependencies[1].dstAccessMask = staticPass ? VK_ACCESS_TRANSFER_READ_BIT : VK_ACCESS_SHADER_READ_BIT;
+        dependencies[1].dependencyFlags = staticPass ? 0 : VK_DEPENDENCY_BY_REGION_BIT;
 
         // render pass
         VkRenderPassCreateInfo renderPassInfo = {};
@@ -117,7 +154,7 @@ namespace GfxRenderEngine
         renderPassInfo.dependencyCount = NUMBER_OF_DEPENDENCIES;
         renderPassInfo.pDependencies = dependencies.data();
 
-        if (vkCreateRenderPass(m_Device->Device(), &renderPassInfo, nullptr, &m_ShadowRenderPass) != VK_SUCCESS)
+        if (vkCreateRenderPass(m_Device->Device(), &renderPassInfo, nullptr, &m_ShadowRenderPasses[pass]) != VK_SUCCESS)
         {
             LOG_CORE_CRITICAL("failed to create render pass!");
         }
@@ -125,7 +162,7 @@ namespace GfxRenderEngine
 
     void VK_ShadowMap::CreateShadowDepthResources()
     {
-        // image
+        // images
         VkImageCreateInfo imageInfo{};
         imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
         imageInfo.imageType = VK_IMAGE_TYPE_2D;
@@ -133,35 +170,60 @@ namespace GfxRenderEngine
         imageInfo.extent.height = m_ShadowMapExtent.height;
         imageInfo.extent.depth = 1;
         imageInfo.mipLevels = 1;
-        imageInfo.arrayLayers = 1;
+        imageInfo.arrayLayers = m_NumberOfCascades;
         imageInfo.format = m_DepthFormat;
         imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
         imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
         imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
         imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
         imageInfo.flags = 0;
 
+        m_Device->CreateImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_StaticCacheImage,
+                                      m_StaticCacheImageMemory);
+
+        imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+                          VK_IMAGE_USAGE_TRANSFER_DST_BIT;
         m_Device->CreateImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_ShadowDepthImage,
                                       m_ShadowDepthImageMemory);
 
-        // image view
+        // image views
         VkImageViewCreateInfo viewInfo{};
         viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
         viewInfo.image = m_ShadowDepthImage;
-        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
         viewInfo.format = m_DepthFormat;
         viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
         viewInfo.subresourceRange.baseMipLevel = 0;
         viewInfo.subresourceRange.levelCount = 1;
         viewInfo.subresourceRange.baseArrayLayer = 0;
-        viewInfo.subresourceRange.layerCount = 1;
+        viewInfo.subresourceRange.layerCount = m_NumberOfCascades;
 
         if (vkCreateImageView(m_Device->Device(), &viewInfo, nullptr, &m_ShadowDepthImageView) != VK_SUCCESS)
         {
             LOG_CORE_CRITICAL("failed to create texture image view! (CreateShadowDepthResources)");
         }
 
+        // one view per layer for the framebuffers
+        m_StaticCacheLayerViews.resize(m_NumberOfCascades);
+        m_ShadowDepthLayerViews.resize(m_NumberOfCascades);
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.subresourceRange.layerCount = 1;
+        for (uint cascade = 0; cascade < m_NumberOfCascades; ++cascade)
+        {
+            viewInfo.subresourceRange.baseArrayLayer = cascade;
+
+            viewInfo.image = m_StaticCacheImage;
+            auto result = vkCreateImageView(m_Device->Device(), &viewInfo, nullptr, &m_StaticCacheLayerViews[cascade]);
+            viewInfo.image = m_ShadowDepthImage;
+            if ((result != VK_SUCCESS) ||
+                (vkCreateImageView(m_Device->Device(), &viewInfo, nullptr, &m_ShadowDepthLayerViews[cascade]) !=
+                 VK_SUCCESS))
+            {
+                LOG_CORE_CRITICAL("failed to create texture image view! (CreateShadowDepthResources)");
+            }
+        }
+
         // sampler
         VkSamplerCreateInfo samplerCreateInfo{};
         samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
@@ -192,20 +254,190 @@ namespace GfxRenderEngine
         m_DescriptorImageInfo.imageLayout = m_ImageLayout;
     }
 
-    void VK_ShadowMap::CreateShadowFramebuffer()
+    void VK_ShadowMap::CreateShadowFramebuffers()
+    {
+        for (uint pass = 0; pass < NUMBER_OF_SHADOW_PASSES; ++pass)
+        {
+            auto& layerViews = (pass == STATIC_CASTERS) ? m_StaticCacheLayerViews : m_ShadowDepthLayerViews;
+            m_ShadowFramebuffers[pass].resize(m_NumberOfCascades);
+            for (uint cascade = 0; cascade < m_NumberOfCascades; ++cascade)
+            {
+                VkFramebufferCreateInfo framebufferInfo = {};
+                framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+                framebufferInfo.renderPass = m_ShadowRenderPasses[pass];
+                framebufferInfo.attachmentCount = static_cast<uint>(ShadowRenderTargets::NUMBER_OF_ATTACHMENTS);
+                framebufferInfo.pAttachments = &layerViews[cascade];
+                framebufferInfo.width = m_ShadowMapExtent.width;
+                framebufferInfo.height = m_ShadowMapExtent.height;
+                framebufferInfo.layers = 1;
+
+                if (vkCreateFramebuffer(m_Device->Device(), &framebufferInfo, nullptr,
+                                        &m_ShadowFramebuffers[pass][cascade]) != VK_SUCCESS)
+                {
+                    LOG_CORE_CRITICAL("failed to create shadow framebuffer!");
+                }
+            }
+        }
+    }
+
+    void VK_ShadowMap::Update(const Camera& camera, const glm::mat4& lightView)
+    {
+        ZoneScopedN("VK_ShadowMap::Update");
+        glm::mat3 lightRotation = glm::mat3(lightView);
+        if (lightRotation != m_LightRotation)
+        {
+            m_LightRotation = lightRotation;
+            InvalidateStaticCache();
+        }
+
+        float shadowDistance = static_cast<float>(std::max(CoreSettings::m_ShadowDistance, 1));
+
+        // frustum of the camera, an orthographic camera is treated as a 90 degree frustum around its position
+        float cameraNear = 0.1f;
+        float cameraFar = shadowDistance;
+        float tanHalfFovX = 1.0f;
+        float tanHalfFovY = 1.0f;
+        if (camera.GetProjectionType() == Camera::PERSPECTIVE_PROJECTION)
+        {
+            const glm::mat4& projection = camera.GetProjectionMatrix();
+            cameraNear = -projection[3][2] / projection[2][2];
+            cameraFar = projection[2][2] * cameraNear / (projection[2][2] - 1.0f);
+            tanHalfFovX = 1.0f / projection[0][0];
+            tanHalfFovY = 1.0f / projection[1][1];
+        }
+        float shadowFar = std::min(cameraFar, shadowDistance);
+        float tanSquared = tanHalfFovX * tanHalfFovX + tanHalfFovY * tanHalfFovY;
+
+        glm::mat4 inverseView = glm::inverse(camera.GetViewMatrix());
+        glm::vec3 cameraPosition = glm::vec3(inverseView[3]);
+        glm::vec3 cameraForward = glm::normalize(glm::vec3(inverseView[2]));
+
+        float size = static_cast<float>(m_ShadowMapExtent.width);
+        float splitNear = cameraNear;
+        for (uint cascade = 0; cascade < m_NumberOfCascades; ++cascade)
+        {
+            // practical split scheme
+            float ratio = static_cast<float>(cascade + 1) / static_cast<float>(m_NumberOfCascades);
+            float logSplit = cameraNear * std::pow(shadowFar / cameraNear, ratio);
+            float uniformSplit = cameraNear + (shadowFar - cameraNear) * ratio;
+            float splitFar = glm::mix(uniformSplit, logSplit, SPLIT_LAMBDA);
+
+            // bounding sphere of the frustum slice, its size does not change when the camera rotates
+            float centerDepth = 0.5f * (splitNear + splitFar) * (1.0f + tanSquared);
+            float radius;
+            if (centerDepth >= splitFar)
+            {
+                centerDepth = splitFar;
+                radius = splitFar * std::sqrt(tanSquared);
+            }
+            else
+            {
+                radius = std::sqrt((splitFar - centerDepth) * (splitFar - centerDepth) + splitFar * splitFar * tanSquared);
+            }
+            radius = std::ceil(radius * 16.0f) / 16.0f; // absorb floating point noise
+
+            // snap the center in light space, the projection is widened so that the snapped sphere stays inside
+            float halfExtent = radius / (1.0f - SNAP_TEXELS / size);
+            float snapStep = SNAP_TEXELS * 2.0f * halfExtent / size;
+            glm::vec3 center = m_LightRotation * (cameraPosition + cameraForward * centerDepth);
+            center = glm::round(center / snapStep) * snapStep;
+
+            // the light looks along -z, casters between the light and the slice are included
+            float nearPlane = -center.z - halfExtent - shadowDistance;
+            float farPlane = -center.z + halfExtent;
+
+            Cascade& cascadeData = m_Cascades[cascade];
+            glm::mat4 view = glm::mat4(m_LightRotation);
+            glm::mat4 projection = glm::ortho(center.x - halfExtent, center.x + halfExtent, center.y - halfExtent,
+                                              center.y + halfExtent, nearPlane, farPlane);
+            glm::mat4 viewProjection = projection * view;
+            if (viewProjection != cascadeData.m_ViewProjection)
+            {
+                m_StaticCacheValid[cascade] = false;
+            }
+            cascadeData.m_View = view;
+            cascadeData.m_Projection = projection;
+            cascadeData.m_ViewProjection = viewProjection;
+            cascadeData.m_SplitDepth = splitFar;
+
+            splitNear = splitFar;
+        }
+    }
+
+    void VK_ShadowMap::TransitionToTransferDst(VkCommandBuffer commandBuffer)
     {
-        VkFramebufferCreateInfo framebufferInfo = {};
-        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebufferInfo.renderPass = m_ShadowRenderPass;
-        framebufferInfo.attachmentCount = static_cast<uint>(ShadowRenderTargets::NUMBER_OF_ATTACHMENTS);
-        framebufferInfo.pAttachments = &m_ShadowDepthImageView;
-        framebufferInfo.width = m_ShadowMapExtent.width;
-        framebufferInfo.height = m_ShadowMapExtent.height;
-        framebufferInfo.layers = 1;
-
-        if (vkCreateFramebuffer(m_Device->Device(), &framebufferInfo, nullptr, &m_ShadowFramebuffer) != VK_SUCCESS)
+        // the previous content is discarded, the lighting pass of the previous frame must be done reading it
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = m_ShadowDepthImage;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+        if (m_DepthFormat != VK_FORMAT_D32_SFLOAT)
         {
-            LOG_CORE_CRITICAL("failed to create shadow framebuffer!");
+            barrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
         }
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = m_NumberOfCascades;
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                             nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    void VK_ShadowMap::CopyStaticCache(VkCommandBuffer commandBuffer)
+    {
+        TransitionToTransferDst(commandBuffer);
+
+        VkImageCopy region{};
+        region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+        region.srcSubresource.mipLevel = 0;
+        region.srcSubresource.baseArrayLayer = 0;
+        region.srcSubresource.layerCount = m_NumberOfCascades;
+        region.dstSubresource = region.srcSubresource;
+        region.extent = {m_ShadowMapExtent.width, m_ShadowMapExtent.height, 1};
+
+        vkCmdCopyImage(commandBuffer, m_StaticCacheImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_ShadowDepthImage,
+                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    }
+
+    void VK_ShadowMap::Clear(VkCommandBuffer commandBuffer)
+    {
+        // the cache is rebuilt when a light returns
+        InvalidateStaticCache();
+        TransitionToTransferDst(commandBuffer);
+
+        VkClearDepthStencilValue clearValue{1.0f, 0};
+        VkImageSubresourceRange range{};
+        range.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+        range.baseMipLevel = 0;
+        range.levelCount = 1;
+        range.baseArrayLayer = 0;
+        range.layerCount = m_NumberOfCascades;
+        vkCmdClearDepthStencilImage(commandBuffer, m_ShadowDepthImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clearValue, 1,
+                                    &range);
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = m_ImageLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = m_ShadowDepthImage;
+        barrier.subresourceRange = range;
+        if (m_DepthFormat != VK_FORMAT_D32_SFLOAT)
+        {
+            barrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+        }
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0,
+                             nullptr, 0, nullptr, 1, &barrier);
     }
 } // namespace GfxRenderEngine
@@ -22,14 +22,21 @@
 
 #pragma once
 
+#include <array>
+#include <vector>
 #include <vulkan/vulkan.h>
 
 #include "engine.h"
+#include "renderer/camera.h"
+#include "platform/Vulkan/shadowMapping.h"
 #include "VKdevice.h"
 #include "VKcore.h"
 
 namespace GfxRenderEngine
 {
+    // cascaded shadow map of one directional light in a depth texture array, one layer per cascade
+    // static casters are rendered into a cache layer that is only redrawn when it was invalidated,
+    // each frame the cache is copied into the sampled layer and dynamic casters are drawn on top
     class VK_ShadowMap
     {
 
@@ -46,37 +53,78 @@ namespace GfxRenderEngine
             NUMBER_OF_ATTACHMENTS
         };
 
+        enum ShadowPass
+        {
+            STATIC_CASTERS = 0, // clears and renders into the cache layer
+            DYNAMIC_CASTERS,    // loads the copied cache layer and renders on top
+            NUMBER_OF_SHADOW_PASSES
+        };
+
+        struct Cascade
+        {
+            glm::mat4 m_Projection{1.0f};
+            glm::mat4 m_View{1.0f};
+            glm::mat4 m_ViewProjection{1.0f};
+            float m_SplitDepth{0.0f}; // far end of the cascade along the camera's view direction
+        };
+
     public:
-        VK_ShadowMap(int width);
+        VK_ShadowMap(int width, int numberOfCascades);
         ~VK_ShadowMap();
 
         VK_ShadowMap(const VK_ShadowMap&) = delete;
         VK_ShadowMap& operator=(const VK_ShadowMap&) = delete;
 
-        VkFramebuffer GetShadowFrameBuffer() { return m_ShadowFramebuffer; }
-        VkRenderPass GetShadowRenderPass() { return m_ShadowRenderPass; }
+        VkFramebuffer GetShadowFrameBuffer(ShadowPass pass, uint cascade) { return m_ShadowFramebuffers[pass][cascade]; }
+        VkRenderPass GetShadowRenderPass(ShadowPass pass) { return m_ShadowRenderPasses[pass]; }
         VkExtent2D GetShadowMapExtent() { return m_ShadowMapExtent; }
         const VkDescriptorImageInfo& GetDescriptorImageInfo() const { return m_DescriptorImageInfo; }
 
+        // fits the cascades to the camera frustum, invalidates cached layers whose projection changed
+        void Update(const Camera& camera, const glm::mat4& lightView);
+        void InvalidateStaticCache() { m_StaticCacheValid.fill(false); }
+        bool IsStaticCacheValid(uint cascade) const { return m_StaticCacheValid[cascade]; }
+        void SetStaticCacheValid(uint cascade) { m_StaticCacheValid[cascade] = true; }
+
+        // copies the static cache into the sampled layers before the dynamic casters are drawn
+        void CopyStaticCache(VkCommandBuffer commandBuffer);
+        // fills the sampled layers with the far plane when there is no light to cast shadows
+        void Clear(VkCommandBuffer commandBuffer);
+
+        uint GetNumberOfCascades() const { return m_NumberOfCascades; }
+        const Cascade& GetCascade(uint cascade) const { return m_Cascades[cascade]; }
+
     private:
         void CreateShadowDepthResources();
-        void CreateShadowRenderPass();
-        void CreateShadowFramebuffer();
+        void CreateShadowRenderPass(ShadowPass pass);
+        void CreateShadowFramebuffers();
+        void TransitionToTransferDst(VkCommandBuffer commandBuffer);
 
     private:
         VkFormat m_DepthFormat{VkFormat::VK_FORMAT_UNDEFINED};
         VK_Device* m_Device;
+        uint m_NumberOfCascades;
 
         VkExtent2D m_ShadowMapExtent{};
-        VkFramebuffer m_ShadowFramebuffer{nullptr};
-        VkRenderPass m_ShadowRenderPass{nullptr};
+        std::array<std::vector<VkFramebuffer>, NUMBER_OF_SHADOW_PASSES> m_ShadowFramebuffers;
+        std::array<VkRenderPass, NUMBER_OF_SHADOW_PASSES> m_ShadowRenderPasses{};
+
+        // the static cache is only read by transfers, the shadow depth image is sampled by the lighting pass
+        VkImage m_StaticCacheImage{nullptr};
+        VkDeviceMemory m_StaticCacheImageMemory{nullptr};
+        std::vector<VkImageView> m_StaticCacheLayerViews;
 
         VkImage m_ShadowDepthImage{nullptr};
         VkImageLayout m_ImageLayout{};
-        VkImageView m_ShadowDepthImageView{nullptr};
+        VkImageView m_ShadowDepthImageView{nullptr}; // all layers
         VkDeviceMemory m_ShadowDepthImageMemory{nullptr};
+        std::vector<VkImageView> m_ShadowDepthLayerViews;
         VkSampler m_ShadowDepthSampler{nullptr};
 
         VkDescriptorImageInfo m_DescriptorImageInfo{};
+
+        std::array<Cascade, MAX_SHADOW_CASCADES> m_Cascades{};
+        std::array<bool, MAX_SHADOW_CASCADES> m_StaticCacheValid{};
+        glm::mat3 m_LightRotation{0.0f};
     };
 } // namespace GfxRenderEngine
@@ -85,6 +85,13 @@ namespace GfxRenderEngine
         return result;
     }
 
+    void VK_SwapChain::WaitForFramesInFlight()
+    {
+        ZoneScopedN("WaitForFramesInFlight");
+        vkWaitForFences(m_Device->Device(), static_cast<uint>(m_InFlightFences.size()), m_InFlightFences.data(), VK_TRUE,
+                        std::numeric_limits<uint64>::max());
+    }
+
     VkResult VK_SwapChain::SubmitCommandBuffers(const VkCommandBuffer* buffers, uint* imageIndex)
     {
         if (m_ImagesInFlight[*imageIndex] != VK_NULL_HANDLE)
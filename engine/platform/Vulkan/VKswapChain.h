@@ -59,6 +59,7 @@ namespace GfxRenderEngine
         }
 
         VkResult AcquireNextImage(uint* imageIndex);
+        void WaitForFramesInFlight(); // blocks until all submitted frames have finished executing
         VkResult SubmitCommandBuffers(const VkCommandBuffer* buffers, uint* imageIndex);
         bool CompareSwapFormats(const VK_SwapChain& swapChain) const;
 
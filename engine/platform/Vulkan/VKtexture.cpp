@@ -20,6 +20,7 @@
    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
+#include <algorithm>
 #include <string>
 
 #include "core.h"
@@ -30,6 +31,7 @@
 
 namespace GfxRenderEngine
 {
+    std::mutex VK_Texture::m_DescriptorUsersMutex;
 
     VK_Texture::VK_Texture(bool nearestFilter)
         : m_FileName(""), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BytesPerPixel(0), m_MipLevels(0), m_sRGB(false)
@@ -113,20 +115,376 @@ namespace GfxRenderEngine
         return ok;
     }
 
+    // create texture from block-compressed (or RGBA8) image with a stored mip chain
+    bool VK_Texture::Init(const CompressedImage& image, bool sRGB, int minFilter, int magFilter)
+    {
+        ZoneScopedNC("VK_Texture::Init compressed", 0xffff00);
+        return InitCompressed(image, sRGB, minFilter, magFilter, 0 /*baseLevel*/);
+    }
+
+    // create texture from the mip tail of a compressed image, the VK_TextureStreamer uploads larger levels on demand
+    bool VK_Texture::InitStreamed(const CompressedImage& image, const std::string& streamSource, bool sRGB, int minFilter,
+                                  int magFilter)
+    {
+        ZoneScopedNC("VK_Texture::InitStreamed", 0xffff00);
+        if (!image.IsValid())
+        {
+            return false;
+        }
+        uint levelCount = static_cast<uint>(image.m_Levels.size());
+        uint tailLevel = 0;
+        while ((tailLevel + 1 < levelCount) &&
+               (std::max(image.m_Levels[tailLevel].m_Width, image.m_Levels[tailLevel].m_Height) > STREAMING_TAIL_SIZE))
+        {
+            ++tailLevel;
+        }
+        if (tailLevel == 0) // small enough to keep all levels resident
+        {
+            return InitCompressed(image, sRGB, minFilter, magFilter, 0 /*baseLevel*/);
+        }
+
+        if (!InitCompressed(image, sRGB, minFilter, magFilter, tailLevel))
+        {
+            return false;
+        }
+        m_Streaming = std::make_unique<StreamingState>();
+        m_Streaming->m_Source = streamSource;
+        m_Streaming->m_Format = image.m_Format;
+        m_Streaming->m_LevelSizes.resize(levelCount);
+        for (uint level = 0; level < levelCount; ++level)
+        {
+            m_Streaming->m_LevelSizes[level] = image.m_Levels[level].m_Size;
+        }
+        m_Streaming->m_TailLevel = tailLevel;
+        m_Streaming->m_ResidentLevel = tailLevel;
+        m_Streaming->m_RequestedLevel = tailLevel;
+        return true;
+    }
+
+    bool VK_Texture::InitCompressed(const CompressedImage& image, bool sRGB, int minFilter, int magFilter, uint baseLevel)
+    {
+        if (!image.IsValid())
+        {
+            return false;
+        }
+        VkFormat format = GetVkFormat(image.m_Format, sRGB);
+        if (!IsFormatSupported(image.m_Format))
+        {
+            LOG_CORE_ERROR("VK_Texture: format {0} not supported by the device", static_cast<int>(format));
+            return false;
+        }
+
+        m_FileName = "compressed image";
+        m_sRGB = sRGB;
+        m_MinFilter = SetFilter(minFilter);
+        m_MagFilter = SetFilter(magFilter);
+        m_MinFilterMip = SetFilterMip(minFilter);
+        m_Width = static_cast<int>(image.m_Width);
+        m_Height = static_cast<int>(image.m_Height);
+        m_ImageFormat = format;
+
+        auto toSwizzle = [](char component, VkComponentSwizzle identity)
+        {
+            switch (component)
+            {
+                case 'r':
+                    return VK_COMPONENT_SWIZZLE_R;
+                case 'g':
+                    return VK_COMPONENT_SWIZZLE_G;
+                case 'b':
+                    return VK_COMPONENT_SWIZZLE_B;
+                case 'a':
+                    return VK_COMPONENT_SWIZZLE_A;
+                case '0':
+                    return VK_COMPONENT_SWIZZLE_ZERO;
+                case '1':
+                    return VK_COMPONENT_SWIZZLE_ONE;
+                default:
+                    return identity;
+            }
+        };
+        m_Components = {toSwizzle(image.m_Swizzle[0], VK_COMPONENT_SWIZZLE_R),
+                        toSwizzle(image.m_Swizzle[1], VK_COMPONENT_SWIZZLE_G),
+                        toSwizzle(image.m_Swizzle[2], VK_COMPONENT_SWIZZLE_B),
+                        toSwizzle(image.m_Swizzle[3], VK_COMPONENT_SWIZZLE_A)};
+
+        StreamedImage streamedImage;
+        if (!CreateStreamedImage(image, baseLevel, streamedImage))
+        {
+            return false;
+        }
+        m_TextureImage = streamedImage.m_Image;
+        m_TextureImageMemory = streamedImage.m_Memory;
+        m_MemorySize = streamedImage.m_MemorySize;
+        m_ImageView = streamedImage.m_ImageView;
+        m_MipLevels = streamedImage.m_MipLevels;
+        m_ImageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        // the sampler covers the full chain, so it stays valid when more levels are streamed in
+        CreateSampler(static_cast<float>(image.m_Levels.size()));
+        m_DescriptorImageInfo.sampler = m_Sampler;
+        m_DescriptorImageInfo.imageView = m_ImageView;
+        m_DescriptorImageInfo.imageLayout = m_ImageLayout;
+        return true;
+    }
+
+    // creates an image with the levels [baseLevel, end of chain) and uploads them,
+    // may run on a worker thread of the thread pools
+    bool VK_Texture::CreateStreamedImage(const CompressedImage& image, uint baseLevel, StreamedImage& streamedImage)
+    {
+        ZoneScopedN("VK_Texture::CreateStreamedImage");
+        auto device = VK_Core::m_Device->Device();
+        uint levelCount = static_cast<uint>(image.m_Levels.size());
+        CORE_ASSERT(baseLevel < levelCount, "VK_Texture::CreateStreamedImage: base level out of range");
+
+        streamedImage.m_BaseLevel = baseLevel;
+        streamedImage.m_MipLevels = levelCount - baseLevel;
+
+        // pack the levels base first into the staging buffer, one copy region per level
+        VkDeviceSize uploadSize = 0;
+        std::vector<VkBufferImageCopy> regions(streamedImage.m_MipLevels);
+        for (uint level = baseLevel; level < levelCount; ++level)
+        {
+            auto& mip = image.m_Levels[level];
+            VkBufferImageCopy& region = regions[level - baseLevel];
+            region.bufferOffset = uploadSize;
+            region.bufferRowLength = 0;
+            region.bufferImageHeight = 0;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = level - baseLevel;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 1;
+            region.imageOffset = {0, 0, 0};
+            region.imageExtent = {mip.m_Width, mip.m_Height, 1};
+            uploadSize += mip.m_Size;
+        }
+
+        VkBuffer stagingBuffer;
+        VkDeviceMemory stagingBufferMemory;
+        CreateBuffer(uploadSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer,
+                     stagingBufferMemory);
+
+        void* data;
+        vkMapMemory(device, stagingBufferMemory, 0, uploadSize, 0, &data);
+        for (uint level = baseLevel; level < levelCount; ++level)
+        {
+            auto& mip = image.m_Levels[level];
+            memcpy(static_cast<uchar*>(data) + regions[level - baseLevel].bufferOffset, image.m_Data.data() + mip.m_Offset,
+                   static_cast<size_t>(mip.m_Size));
+        }
+        vkUnmapMemory(device, stagingBufferMemory);
+
+        bool ok = AllocateImage(image.m_Levels[baseLevel].m_Width, image.m_Levels[baseLevel].m_Height,
+                                streamedImage.m_MipLevels, VK_IMAGE_TILING_OPTIMAL,
+                                VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, streamedImage.m_Image, streamedImage.m_Memory,
+                                streamedImage.m_MemorySize);
+        if (ok)
+        {
+            VkCommandBuffer commandBuffer = VK_Core::m_Device->BeginSingleTimeCommands();
+            RecordLayoutTransition(commandBuffer, streamedImage.m_Image, streamedImage.m_MipLevels,
+                                   VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+            vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, streamedImage.m_Image,
+                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint>(regions.size()),
+                                   regions.data());
+            RecordLayoutTransition(commandBuffer, streamedImage.m_Image, streamedImage.m_MipLevels,
+                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            VK_Core::m_Device->EndSingleTimeCommands(commandBuffer); // waits for completion
+
+            streamedImage.m_ImageView = CreateImageView(streamedImage.m_Image, streamedImage.m_MipLevels);
+        }
+
+        vkDestroyBuffer(device, stagingBuffer, nullptr);
+        vkFreeMemory(device, stagingBufferMemory, nullptr);
+
+        if (!ok)
+        {
+            DestroyStreamedImage(streamedImage);
+        }
+        return ok;
+    }
+
+    bool VK_Texture::LoadStreamedImage(uint baseLevel, StreamedImage& streamedImage)
+    {
+        ZoneScopedN("VK_Texture::LoadStreamedImage");
+        CompressedImage image;
+        if (!image.Load(m_Streaming->m_Source))
+        {
+            LOG_CORE_WARN("VK_Texture: couldn't stream {0}", m_Streaming->m_Source);
+            return false;
+        }
+        // the file must still match what was uploaded at load time
+        if ((image.m_Format != m_Streaming->m_Format) || (image.m_Levels.size() != m_Streaming->m_LevelSizes.size()) ||
+            (image.m_Width != static_cast<uint>(m_Width)) || (image.m_Height != static_cast<uint>(m_Height)))
+        {
+            LOG_CORE_WARN("VK_Texture: {0} changed on disk, streaming disabled for it", m_Streaming->m_Source);
+            return false;
+        }
+        return CreateStreamedImage(image, baseLevel, streamedImage);
+    }
+
+    // swaps in a streamed image and rewrites the descriptor users,
+    // frames in flight may still use the replaced image, the caller destroys it when they finished
+    void VK_Texture::CommitStreamedImage(StreamedImage& streamedImage)
+    {
+        std::lock_guard<std::mutex> lock(m_DescriptorUsersMutex);
+
+        StreamedImage replacedImage{m_TextureImage,        m_TextureImageMemory,         m_ImageView,
+                                    m_MemorySize,          m_Streaming->m_ResidentLevel, m_MipLevels};
+        m_TextureImage = streamedImage.m_Image;
+        m_TextureImageMemory = streamedImage.m_Memory;
+        m_MemorySize = streamedImage.m_MemorySize;
+        m_ImageView = streamedImage.m_ImageView;
+        m_MipLevels = streamedImage.m_MipLevels;
+        m_Streaming->m_ResidentLevel = streamedImage.m_BaseLevel;
+        m_DescriptorImageInfo.imageView = m_ImageView;
+        streamedImage = replacedImage;
+
+        for (auto& descriptorUser : m_Streaming->m_DescriptorUsers)
+        {
+            WriteDescriptor(descriptorUser);
+        }
+    }
+
+    void VK_Texture::DestroyStreamedImage(StreamedImage& streamedImage)
+    {
+        auto device = VK_Core::m_Device->Device();
+        vkDestroyImageView(device, streamedImage.m_ImageView, nullptr);
+        vkDestroyImage(device, streamedImage.m_Image, nullptr);
+        vkFreeMemory(device, streamedImage.m_Memory, nullptr);
+        streamedImage = {};
+    }
+
+    void VK_Texture::AddDescriptorUser(VkDescriptorSet descriptorSet, uint binding, uint arrayElement)
+    {
+        if (!m_Streaming)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_DescriptorUsersMutex);
+        DescriptorUser descriptorUser{descriptorSet, binding, arrayElement};
+        m_Streaming->m_DescriptorUsers.push_back(descriptorUser);
+        // the set may have been written with an image view replaced in the meantime
+        WriteDescriptor(descriptorUser);
+    }
+
+    void VK_Texture::RemoveDescriptorUser(VkDescriptorSet descriptorSet, uint binding, uint arrayElement)
+    {
+        if (!m_Streaming)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_DescriptorUsersMutex);
+        auto& descriptorUsers = m_Streaming->m_DescriptorUsers;
+        auto iterator =
+            std::find(descriptorUsers.begin(), descriptorUsers.end(), DescriptorUser{descriptorSet, binding, arrayElement});
+        if (iterator != descriptorUsers.end())
+        {
+            descriptorUsers.erase(iterator);
+        }
+    }
+
+    void VK_Texture::WriteDescriptor(DescriptorUser const& descriptorUser)
+    {
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = descriptorUser.m_DescriptorSet;
+        write.dstBinding = descriptorUser.m_Binding;
+        write.dstArrayElement = descriptorUser.m_ArrayElement;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo = &m_DescriptorImageInfo;
+        vkUpdateDescriptorSets(VK_Core::m_Device->Device(), 1, &write, 0, nullptr);
+    }
+
+    VkFormat VK_Texture::GetVkFormat(CompressedImage::Format format, bool sRGB)
+    {
+        switch (format)
+        {
+            case CompressedImage::FORMAT_RGBA8:
+                return sRGB ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+            case CompressedImage::FORMAT_BC1:
+                return sRGB ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK : VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+            case CompressedImage::FORMAT_BC3:
+                return sRGB ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+            case CompressedImage::FORMAT_BC4: // single and dual channel formats have no sRGB variant
+                return VK_FORMAT_BC4_UNORM_BLOCK;
+            case CompressedImage::FORMAT_BC5:
+                return VK_FORMAT_BC5_UNORM_BLOCK;
+            case CompressedImage::FORMAT_BC7:
+                return sRGB ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+            case CompressedImage::FORMAT_ETC2_RGB8:
+                return sRGB ? VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK : VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+            case CompressedImage::FORMAT_ETC2_RGBA8:
+                return sRGB ? VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK : VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK;
+            case CompressedImage::FORMAT_ASTC_4x4:
+                return sRGB ? VK_FORMAT_ASTC_4x4_SRGB_BLOCK : VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+            default:
+                return VK_FORMAT_UNDEFINED;
+        }
+    }
+
+    bool VK_Texture::IsFormatSupported(CompressedImage::Format format)
+    {
+        auto& features = VK_Core::m_Device->m_EnabledFeatures;
+        switch (format)
+        {
+            case CompressedImage::FORMAT_RGBA8:
+                return true;
+            case CompressedImage::FORMAT_BC1:
+            case CompressedImage::FORMAT_BC3:
+            case CompressedImage::FORMAT_BC4:
+            case CompressedImage::FORMAT_BC5:
+            case CompressedImage::FORMAT_BC7:
+                if (!features.textureCompressionBC)
+                {
+                    return false;
+                }
+                break;
+            case CompressedImage::FORMAT_ETC2_RGB8:
+            case CompressedImage::FORMAT_ETC2_RGBA8:
+                if (!features.textureCompressionETC2)
+                {
+                    return false;
+                }
+                break;
+            case CompressedImage::FORMAT_ASTC_4x4:
+                if (!features.textureCompressionASTC_LDR)
+                {
+                    return false;
+                }
+                break;
+            default:
+                return false;
+        }
+
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(VK_Core::m_Device->PhysicalDevice(), GetVkFormat(format, false),
+                                            &formatProperties);
+        return formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+    }
+
     void VK_Texture::TransitionImageLayout(VkImageLayout oldLayout, VkImageLayout newLayout)
     {
         VkCommandBuffer commandBuffer = VK_Core::m_Device->BeginSingleTimeCommands();
+        RecordLayoutTransition(commandBuffer, m_TextureImage, m_MipLevels, oldLayout, newLayout);
+        VK_Core::m_Device->EndSingleTimeCommands(commandBuffer);
+    }
 
+    bool VK_Texture::RecordLayoutTransition(VkCommandBuffer commandBuffer, VkImage image, uint mipLevels,
+                                            VkImageLayout oldLayout, VkImageLayout newLayout)
+    {
         VkImageMemoryBarrier barrier{};
         barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
         barrier.oldLayout = oldLayout;
         barrier.newLayout = newLayout;
         barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
         barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = m_TextureImage;
+        barrier.image = image;
         barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = m_MipLevels;
+        barrier.subresourceRange.levelCount = mipLevels;
         barrier.subresourceRange.baseArrayLayer = 0;
         barrier.subresourceRange.layerCount = 1;
 
@@ -152,30 +510,36 @@ namespace GfxRenderEngine
         else
         {
             LOG_APP_CRITICAL("unsupported layout transition!");
-            return;
+            return false;
         }
 
         vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-        VK_Core::m_Device->EndSingleTimeCommands(commandBuffer);
+        return true;
     }
 
     void VK_Texture::CreateImage(VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage,
                                  VkMemoryPropertyFlags properties)
+    {
+        m_ImageFormat = format;
+        AllocateImage(m_Width, m_Height, m_MipLevels, tiling, usage, properties, m_TextureImage, m_TextureImageMemory,
+                      m_MemorySize);
+    }
+
+    bool VK_Texture::AllocateImage(uint width, uint height, uint mipLevels, VkImageTiling tiling, VkImageUsageFlags usage,
+                                   VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& memory,
+                                   VkDeviceSize& memorySize)
     {
         auto device = VK_Core::m_Device->Device();
-        m_MipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(m_Width, m_Height)))) + 1;
 
-        m_ImageFormat = format;
         VkImageCreateInfo imageInfo{};
         imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
         imageInfo.imageType = VK_IMAGE_TYPE_2D;
-        imageInfo.extent.width = m_Width;
-        imageInfo.extent.height = m_Height;
+        imageInfo.extent.width = width;
+        imageInfo.extent.height = height;
         imageInfo.extent.depth = 1;
-        imageInfo.mipLevels = m_MipLevels;
+        imageInfo.mipLevels = mipLevels;
         imageInfo.arrayLayers = 1;
-        imageInfo.format = format;
+        imageInfo.format = m_ImageFormat;
         imageInfo.tiling = tiling;
         imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
         imageInfo.usage = usage;
@@ -183,15 +547,16 @@ namespace GfxRenderEngine
         imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
         {
-            auto result = vkCreateImage(device, &imageInfo, nullptr, &m_TextureImage);
+            auto result = vkCreateImage(device, &imageInfo, nullptr, &image);
             if (result != VK_SUCCESS)
             {
                 LOG_CORE_CRITICAL("failed to create image!");
+                return false;
             }
         }
 
         VkMemoryRequirements memRequirements;
-        vkGetImageMemoryRequirements(device, m_TextureImage, &memRequirements);
+        vkGetImageMemoryRequirements(device, image, &memRequirements);
 
         VkMemoryAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
@@ -199,15 +564,21 @@ namespace GfxRenderEngine
         allocInfo.memoryTypeIndex = VK_Core::m_Device->FindMemoryType(memRequirements.memoryTypeBits, properties);
 
         {
-            auto result = vkAllocateMemory(device, &allocInfo, nullptr, &m_TextureImageMemory);
+            auto result = vkAllocateMemory(device, &allocInfo, nullptr, &memory);
             if (result != VK_SUCCESS)
             {
                 LOG_CORE_CRITICAL("failed to allocate image memory in 'void "
-                                  "VK_Texture::CreateImage'");
+                                  "VK_Texture::AllocateImage'");
+                return false;
+            }
+            else
+            {
+                memorySize = memRequirements.size;
             }
         }
 
-        vkBindImageMemory(device, m_TextureImage, m_TextureImageMemory, 0);
+        vkBindImageMemory(device, image, memory, 0);
+        return true;
     }
 
     void VK_Texture::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
@@ -269,6 +640,7 @@ namespace GfxRenderEngine
         vkUnmapMemory(device, stagingBufferMemory);
 
         VkFormat format = m_sRGB ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+        m_MipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(m_Width, m_Height)))) + 1;
         CreateImage(format, VK_IMAGE_TILING_OPTIMAL,
                     VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
@@ -286,6 +658,26 @@ namespace GfxRenderEngine
         vkDestroyBuffer(device, stagingBuffer, nullptr);
         vkFreeMemory(device, stagingBufferMemory, nullptr);
 
+        CreateSamplerAndImageView(
+            {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A});
+        return true;
+    }
+
+    void VK_Texture::CreateSamplerAndImageView(VkComponentMapping const& components)
+    {
+        m_Components = components;
+        CreateSampler(static_cast<float>(m_MipLevels));
+        m_ImageView = CreateImageView(m_TextureImage, m_MipLevels);
+
+        m_DescriptorImageInfo.sampler = m_Sampler;
+        m_DescriptorImageInfo.imageView = m_ImageView;
+        m_DescriptorImageInfo.imageLayout = m_ImageLayout;
+    }
+
+    void VK_Texture::CreateSampler(float maxLod)
+    {
+        auto device = VK_Core::m_Device->Device();
+
         // Create a texture sampler
         // In Vulkan, textures are accessed by samplers
         // This separates sampling information from texture data.
@@ -303,7 +695,7 @@ namespace GfxRenderEngine
         samplerCreateInfo.mipLodBias = 0.0f;
         samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
         samplerCreateInfo.minLod = 0.0f;
-        samplerCreateInfo.maxLod = static_cast<float>(m_MipLevels);
+        samplerCreateInfo.maxLod = maxLod;
         samplerCreateInfo.maxAnisotropy = 4.0;
         samplerCreateInfo.anisotropyEnable = VK_TRUE;
         samplerCreateInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
@@ -315,6 +707,11 @@ namespace GfxRenderEngine
                 LOG_CORE_CRITICAL("failed to create sampler!");
             }
         }
+    }
+
+    VkImageView VK_Texture::CreateImageView(VkImage image, uint mipLevels)
+    {
+        auto device = VK_Core::m_Device->Device();
 
         // Create image view
         // Textures are not directly accessed by shaders and
@@ -325,7 +722,7 @@ namespace GfxRenderEngine
         view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
         view.viewType = VK_IMAGE_VIEW_TYPE_2D;
         view.format = m_ImageFormat;
-        view.components = {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A};
+        view.components = m_Components;
         // A subresource range describes the set of mip levels (and array layers) that can be accessed through this image
         // view It's possible to create multiple image views for a single image referring to different (and/or overlapping)
         // ranges of the image
@@ -335,23 +732,19 @@ namespace GfxRenderEngine
         view.subresourceRange.layerCount = 1;
         // Linear tiling usually won't support mip maps
         // Only set mip map count if optimal tiling is used
-        view.subresourceRange.levelCount = m_MipLevels;
+        view.subresourceRange.levelCount = mipLevels;
         // The view will be based on the texture's image
-        view.image = m_TextureImage;
+        view.image = image;
 
+        VkImageView imageView{nullptr};
         {
-            auto result = vkCreateImageView(device, &view, nullptr, &m_ImageView);
+            auto result = vkCreateImageView(device, &view, nullptr, &imageView);
             if (result != VK_SUCCESS)
             {
                 LOG_CORE_CRITICAL("failed to create image view!");
             }
         }
-
-        m_DescriptorImageInfo.sampler = m_Sampler;
-        m_DescriptorImageInfo.imageView = m_ImageView;
-        m_DescriptorImageInfo.imageLayout = m_ImageLayout;
-
-        return true;
+        return imageView;
     }
 
     void VK_Texture::Blit(uint x, uint y, uint width, uint height, uint bytesPerPixel, const void* data)
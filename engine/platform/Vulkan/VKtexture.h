@@ -22,6 +22,9 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <vector>
 #include <vulkan/vulkan.h>
 
 #include "engine.h"
@@ -34,6 +37,18 @@ namespace GfxRenderEngine
     class VK_Texture : public Texture
     {
 
+    public:
+        // device image holding the mip levels [m_BaseLevel, m_BaseLevel + m_MipLevels) of the full chain
+        struct StreamedImage
+        {
+            VkImage m_Image{nullptr};
+            VkDeviceMemory m_Memory{nullptr};
+            VkImageView m_ImageView{nullptr};
+            VkDeviceSize m_MemorySize{0};
+            uint m_BaseLevel{0};
+            uint m_MipLevels{0};
+        };
+
     public:
         VK_Texture(bool nearestFilter = false);
         virtual ~VK_Texture();
@@ -42,22 +57,80 @@ namespace GfxRenderEngine
                           int magFilter) override;
         virtual bool Init(const std::string& fileName, bool sRGB, bool flip = true) override;
         virtual bool Init(const unsigned char* data, int length, bool sRGB) override;
+        virtual bool Init(const CompressedImage& image, bool sRGB, int minFilter, int magFilter) override;
+        virtual bool InitStreamed(const CompressedImage& image, const std::string& streamSource, bool sRGB, int minFilter,
+                                  int magFilter) override;
         virtual int GetWidth() const override { return m_Width; }
         virtual int GetHeight() const override { return m_Height; }
         virtual void Resize(uint width, uint height) override;
         virtual void Blit(uint x, uint y, uint width, uint height, uint bytesPerPixel, const void* data) override;
         virtual void Blit(uint x, uint y, uint width, uint height, int dataFormat, int type, const void* data) override;
         virtual void SetFilename(const std::string& filename) override { m_FileName = filename; }
+        const std::string& GetFilename() const { return m_FileName; }
+        virtual size_t GetMemorySize() const override { return static_cast<size_t>(m_MemorySize); }
 
         const VkDescriptorImageInfo& GetDescriptorImageInfo() const { return m_DescriptorImageInfo; }
 
+        static bool IsFormatSupported(CompressedImage::Format format);
+
+        // streaming: descriptor sets using a streamed texture are rewritten when its image is replaced
+        bool IsStreamed() const { return m_Streaming != nullptr; }
+        void AddDescriptorUser(VkDescriptorSet descriptorSet, uint binding, uint arrayElement = 0);
+        void RemoveDescriptorUser(VkDescriptorSet descriptorSet, uint binding, uint arrayElement = 0);
+
+    private:
+        friend class VK_TextureStreamer;
+
+        struct DescriptorUser
+        {
+            VkDescriptorSet m_DescriptorSet;
+            uint m_Binding;
+            uint m_ArrayElement;
+            bool operator==(DescriptorUser const& other) const = default;
+        };
+
+        struct StreamingState
+        {
+            std::string m_Source; // KTX2/DDS file with the full mip chain
+            CompressedImage::Format m_Format{CompressedImage::FORMAT_UNDEFINED};
+            std::vector<VkDeviceSize> m_LevelSizes; // per level of the full chain
+            uint m_TailLevel{0};                    // first level of the mip tail, always resident
+            uint m_ResidentLevel{0};                // first level resident on the device
+            uint m_RequestedLevel{0};               // finest level requested by the renderer in m_RequestFrame
+            uint64 m_RequestFrame{0};
+            bool m_Registered{false}; // known to the streamer
+            bool m_JobPending{false};
+            bool m_Failed{false};
+            std::vector<DescriptorUser> m_DescriptorUsers;
+        };
+
+        // mip tail: levels no larger than this are uploaded right away
+        static constexpr uint STREAMING_TAIL_SIZE = 128;
+
+        bool InitCompressed(const CompressedImage& image, bool sRGB, int minFilter, int magFilter, uint baseLevel);
+        bool CreateStreamedImage(const CompressedImage& image, uint baseLevel, StreamedImage& streamedImage);
+        bool LoadStreamedImage(uint baseLevel, StreamedImage& streamedImage); // reads m_Streaming->m_Source
+        void CommitStreamedImage(StreamedImage& streamedImage); // returns the replaced image in streamedImage
+        static void DestroyStreamedImage(StreamedImage& streamedImage);
+        void WriteDescriptor(DescriptorUser const& descriptorUser);
+
     private:
         bool Create();
         void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer,
                           VkDeviceMemory& bufferMemory);
         void CreateImage(VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties);
+        bool AllocateImage(uint width, uint height, uint mipLevels, VkImageTiling tiling, VkImageUsageFlags usage,
+                           VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& memory,
+                           VkDeviceSize& memorySize); // uses m_ImageFormat
         void TransitionImageLayout(VkImageLayout oldLayout, VkImageLayout newLayout);
+        static bool RecordLayoutTransition(VkCommandBuffer commandBuffer, VkImage image, uint mipLevels,
+                                           VkImageLayout oldLayout, VkImageLayout newLayout);
         void GenerateMipmaps();
+        void CreateSamplerAndImageView(VkComponentMapping const& components);
+        void CreateSampler(float maxLod);
+        VkImageView CreateImageView(VkImage image, uint mipLevels);
+
+        static VkFormat GetVkFormat(CompressedImage::Format format, bool sRGB);
 
         VkFilter SetFilter(int minMagFilter);
         VkFilter SetFilterMip(int minFilter);
@@ -76,12 +149,18 @@ namespace GfxRenderEngine
         VkFormat m_ImageFormat{VkFormat::VK_FORMAT_UNDEFINED};
         VkImage m_TextureImage{nullptr};
         VkDeviceMemory m_TextureImageMemory{nullptr};
+        VkDeviceSize m_MemorySize{0};
         VkImageLayout m_ImageLayout{VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED};
         VkImageView m_ImageView{nullptr};
         VkSampler m_Sampler{nullptr};
+        VkComponentMapping m_Components{VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B,
+                                        VK_COMPONENT_SWIZZLE_A};
 
         VkDescriptorImageInfo m_DescriptorImageInfo{};
 
+        std::unique_ptr<StreamingState> m_Streaming;
+        static std::mutex m_DescriptorUsersMutex;
+
     private:
         static constexpr int TEXTURE_FILTER_NEAREST = 9728;
         static constexpr int TEXTURE_FILTER_LINEAR = 9729;
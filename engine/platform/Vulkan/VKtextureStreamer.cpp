@@ -0,0 +1,315 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "core.h"
+#include "coreSettings.h"
+
+#include "VKcore.h"
+#include "VKtextureStreamer.h"
+
+namespace GfxRenderEngine
+{
+    VK_TextureStreamer::~VK_TextureStreamer()
+    {
+        for (auto& job : m_Jobs)
+        {
+            if (job->m_Future.get())
+            {
+                VK_Texture::DestroyStreamedImage(job->m_Image);
+            }
+        }
+        for (auto& retiredImage : m_RetiredImages)
+        {
+            VK_Texture::DestroyStreamedImage(retiredImage.m_Image);
+        }
+    }
+
+    void VK_TextureStreamer::Request(std::shared_ptr<Texture> const& texture, float screenSize)
+    {
+        auto vkTexture = static_cast<VK_Texture*>(texture.get());
+        if (!vkTexture || !vkTexture->m_Streaming)
+        {
+            return;
+        }
+        auto& state = *vkTexture->m_Streaming;
+
+        // one texel per pixel: the level whose size is the first one not larger than the projected size
+        uint level = state.m_TailLevel;
+        if (screenSize > 0.0f)
+        {
+            float textureSize = static_cast<float>(std::max(vkTexture->m_Width, vkTexture->m_Height));
+            float lod = std::floor(std::log2(textureSize / screenSize));
+            level = static_cast<uint>(std::clamp(lod, 0.0f, static_cast<float>(state.m_TailLevel)));
+        }
+
+        if (state.m_RequestFrame != m_FrameCounter)
+        {
+            state.m_RequestFrame = m_FrameCounter;
+            state.m_RequestedLevel = level;
+        }
+        else
+        {
+            state.m_RequestedLevel = std::min(state.m_RequestedLevel, level);
+        }
+
+        if (!state.m_Registered)
+        {
+            state.m_Registered = true;
+            m_Textures.push_back(std::static_pointer_cast<VK_Texture>(texture));
+        }
+    }
+
+    void VK_TextureStreamer::Update(VK_SwapChain& swapChain, RenderStatistics& statistics)
+    {
+        ZoneScopedN("VK_TextureStreamer::Update");
+
+        DestroyRetiredImages();
+        CommitJobs(swapChain);
+        m_UploadBytes = 0;
+        ScheduleJobs();
+
+        statistics.m_StreamedTextures = static_cast<uint>(m_Textures.size());
+        statistics.m_StreamingJobs = static_cast<uint>(m_Jobs.size());
+        statistics.m_StreamingResidentBytes = m_ResidentBytes;
+        statistics.m_StreamingBudgetBytes =
+            static_cast<uint64>(std::max(CoreSettings::m_TextureStreamingBudgetMB, 0)) * 1024 * 1024;
+        statistics.m_StreamingUploadBytes = m_UploadBytes;
+
+        // requests recorded in this frame are evaluated in the next Update()
+        ++m_FrameCounter;
+    }
+
+    void VK_TextureStreamer::CommitJobs(VK_SwapChain& swapChain)
+    {
+        auto isReady = [](std::unique_ptr<Job> const& job)
+        { return job->m_Future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; };
+
+        if (std::none_of(m_Jobs.begin(), m_Jobs.end(), isReady))
+        {
+            return;
+        }
+
+        // the material bindings are update-after-bind if supported,
+        // otherwise descriptor sets of frames in flight must not be updated
+        if (!VK_Core::m_Device->m_DescriptorIndexing)
+        {
+            swapChain.WaitForFramesInFlight();
+        }
+
+        for (auto iterator = m_Jobs.begin(); iterator != m_Jobs.end();)
+        {
+            if (!isReady(*iterator))
+            {
+                ++iterator;
+                continue;
+            }
+            Job& job = **iterator;
+            auto& state = *job.m_Texture->m_Streaming;
+            state.m_JobPending = false;
+            if (!job.m_Future.get())
+            {
+                state.m_Failed = true; // the source can't be read anymore, keep the resident levels
+            }
+            else if (job.m_Texture.use_count() > 1)
+            {
+                job.m_Texture->CommitStreamedImage(job.m_Image);
+                // frames already submitted may still sample the replaced image
+                m_RetiredImages.push_back({job.m_Image, m_FrameCounter + VK_SwapChain::MAX_FRAMES_IN_FLIGHT});
+            }
+            else // texture was released while loading
+            {
+                VK_Texture::DestroyStreamedImage(job.m_Image);
+            }
+            iterator = m_Jobs.erase(iterator);
+        }
+    }
+
+    void VK_TextureStreamer::DestroyRetiredImages()
+    {
+        std::erase_if(m_RetiredImages,
+                      [this](RetiredImage& retiredImage)
+                      {
+                          if (retiredImage.m_DestroyFrame > m_FrameCounter)
+                          {
+                              return false;
+                          }
+                          VK_Texture::DestroyStreamedImage(retiredImage.m_Image);
+                          return true;
+                      });
+    }
+
+    void VK_TextureStreamer::ScheduleJobs()
+    {
+        ZoneScopedN("VK_TextureStreamer::ScheduleJobs");
+        std::erase_if(m_Textures, [](std::weak_ptr<VK_Texture> const& texture) { return texture.expired(); });
+
+        std::vector<std::shared_ptr<VK_Texture>> textures;
+        textures.reserve(m_Textures.size());
+        m_ResidentBytes = 0;
+        for (auto& weakTexture : m_Textures)
+        {
+            if (auto texture = weakTexture.lock())
+            {
+                m_ResidentBytes += texture->m_MemorySize;
+                textures.push_back(texture);
+            }
+        }
+
+        // memory after all running jobs have been swapped in
+        int64 projectedBytes = static_cast<int64>(m_ResidentBytes);
+        for (auto& job : m_Jobs)
+        {
+            projectedBytes += static_cast<int64>(GetImageSize(*job->m_Texture->m_Streaming, job->m_BaseLevel)) -
+                              static_cast<int64>(job->m_Texture->m_MemorySize);
+        }
+        int64 budget = static_cast<int64>(std::max(CoreSettings::m_TextureStreamingBudgetMB, 0)) * 1024 * 1024;
+        int64 uploadBudget = static_cast<int64>(std::max(CoreSettings::m_TextureStreamingUploadMB, 1)) * 1024 * 1024;
+        bool unlimited = (budget == 0);
+
+        // evict: least recently used first, textures not needed anymore or when over budget
+        {
+            std::vector<std::shared_ptr<VK_Texture>> candidates;
+            for (auto& texture : textures)
+            {
+                auto& state = *texture->m_Streaming;
+                if (!state.m_JobPending && !state.m_Failed && (GetWantedLevel(state) > state.m_ResidentLevel))
+                {
+                    candidates.push_back(texture);
+                }
+            }
+            std::sort(candidates.begin(), candidates.end(),
+                      [](std::shared_ptr<VK_Texture> const& lhs, std::shared_ptr<VK_Texture> const& rhs)
+                      { return lhs->m_Streaming->m_RequestFrame < rhs->m_Streaming->m_RequestFrame; });
+            for (auto& texture : candidates)
+            {
+                if (m_Jobs.size() >= MAX_JOBS)
+                {
+                    break;
+                }
+                auto& state = *texture->m_Streaming;
+                bool overBudget = !unlimited && (projectedBytes > budget);
+                if (!overBudget && !IsUnused(state))
+                {
+                    continue;
+                }
+                uint level = GetWantedLevel(state);
+                projectedBytes += static_cast<int64>(GetImageSize(state, level)) - static_cast<int64>(texture->m_MemorySize);
+                m_UploadBytes += GetImageSize(state, level);
+                StartJob(texture, level);
+            }
+        }
+
+        // upload: largest deficit first, then most recently requested
+        {
+            std::vector<std::shared_ptr<VK_Texture>> candidates;
+            for (auto& texture : textures)
+            {
+                auto& state = *texture->m_Streaming;
+                if (!state.m_JobPending && !state.m_Failed && (GetWantedLevel(state) < state.m_ResidentLevel))
+                {
+                    candidates.push_back(texture);
+                }
+            }
+            auto deficit = [this](VK_Texture::StreamingState const& state)
+            { return state.m_ResidentLevel - GetWantedLevel(state); };
+            std::sort(candidates.begin(), candidates.end(),
+                      [&deficit](std::shared_ptr<VK_Texture> const& lhs, std::shared_ptr<VK_Texture> const& rhs)
+                      {
+                          auto& lhsState = *lhs->m_Streaming;
+                          auto& rhsState = *rhs->m_Streaming;
+                          if (deficit(lhsState) != deficit(rhsState))
+                          {
+                              return deficit(lhsState) > deficit(rhsState);
+                          }
+                          return lhsState.m_RequestFrame > rhsState.m_RequestFrame;
+                      });
+            for (auto& texture : candidates)
+            {
+                if (m_Jobs.size() >= MAX_JOBS)
+                {
+                    break;
+                }
+                auto& state = *texture->m_Streaming;
+                int64 currentBytes = static_cast<int64>(texture->m_MemorySize);
+
+                // settle for a coarser level if the wanted one doesn't fit into the budget
+                uint level = GetWantedLevel(state);
+                while ((level < state.m_ResidentLevel) && !unlimited &&
+                       (projectedBytes + static_cast<int64>(GetImageSize(state, level)) - currentBytes > budget))
+                {
+                    ++level;
+                }
+                if (level == state.m_ResidentLevel)
+                {
+                    continue;
+                }
+
+                // the first upload of a frame is always allowed, so that large levels don't starve
+                VkDeviceSize uploadBytes = GetImageSize(state, level);
+                if ((m_UploadBytes > 0) && (static_cast<int64>(m_UploadBytes + uploadBytes) > uploadBudget))
+                {
+                    break;
+                }
+                projectedBytes += static_cast<int64>(uploadBytes) - currentBytes;
+                m_UploadBytes += uploadBytes;
+                StartJob(texture, level);
+            }
+        }
+    }
+
+    void VK_TextureStreamer::StartJob(std::shared_ptr<VK_Texture> const& texture, uint baseLevel)
+    {
+        auto job = std::make_unique<Job>();
+        job->m_Texture = texture;
+        job->m_BaseLevel = baseLevel;
+        texture->m_Streaming->m_JobPending = true;
+
+        Job* jobPtr = job.get(); // stable, the job is owned by m_Jobs until the future is consumed
+        job->m_Future = Engine::m_Engine->m_PoolSecondary.SubmitTask(
+            [jobPtr]() { return jobPtr->m_Texture->LoadStreamedImage(jobPtr->m_BaseLevel, jobPtr->m_Image); });
+        m_Jobs.push_back(std::move(job));
+    }
+
+    uint VK_TextureStreamer::GetWantedLevel(VK_Texture::StreamingState const& state) const
+    {
+        return IsUnused(state) ? state.m_TailLevel : state.m_RequestedLevel;
+    }
+
+    bool VK_TextureStreamer::IsUnused(VK_Texture::StreamingState const& state) const
+    {
+        return state.m_RequestFrame + UNUSED_FRAMES < m_FrameCounter;
+    }
+
+    VkDeviceSize VK_TextureStreamer::GetImageSize(VK_Texture::StreamingState const& state, uint baseLevel)
+    {
+        VkDeviceSize size = 0;
+        for (size_t level = baseLevel; level < state.m_LevelSizes.size(); ++level)
+        {
+            size += state.m_LevelSizes[level];
+        }
+        return size;
+    }
+} // namespace GfxRenderEngine
@@ -0,0 +1,99 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <future>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+#include "renderer/renderStatistics.h"
+#include "renderer/texture.h"
+
+#include "VKswapChain.h"
+#include "VKtexture.h"
+
+namespace GfxRenderEngine
+{
+    // Streams the mip levels of textures created with VK_Texture::InitStreamed().
+    // While a frame is recorded, Request() collects the finest level each texture needs,
+    // estimated from the projected size of the models using it. Update() runs at the beginning
+    // of the next frame: it swaps in finished uploads, evicts levels that are no longer needed
+    // when over the memory budget and schedules uploads on the secondary thread pool within the
+    // per-frame upload budget. A streamed image always holds a texture's levels from its
+    // resident level down to the smallest one, so the view and sampler need no clamping.
+    // A replaced image is destroyed once the frames in flight that may still use it finished.
+    class VK_TextureStreamer
+    {
+
+    public:
+        VK_TextureStreamer() = default;
+        ~VK_TextureStreamer();
+
+        VK_TextureStreamer(const VK_TextureStreamer&) = delete;
+        VK_TextureStreamer& operator=(const VK_TextureStreamer&) = delete;
+
+        // call before a frame is recorded, no frame must be in progress
+        void Update(VK_SwapChain& swapChain, RenderStatistics& statistics);
+
+        // screenSize: projected size in pixels of the surface the texture is mapped onto, see Camera::GetScreenSize()
+        void Request(std::shared_ptr<Texture> const& texture, float screenSize);
+
+    private:
+        struct Job
+        {
+            std::shared_ptr<VK_Texture> m_Texture;
+            uint m_BaseLevel{0};
+            VK_Texture::StreamedImage m_Image;
+            std::future<bool> m_Future;
+        };
+
+        struct RetiredImage
+        {
+            VK_Texture::StreamedImage m_Image;
+            uint64 m_DestroyFrame;
+        };
+
+        void CommitJobs(VK_SwapChain& swapChain);
+        void DestroyRetiredImages();
+        void ScheduleJobs();
+        void StartJob(std::shared_ptr<VK_Texture> const& texture, uint baseLevel);
+        uint GetWantedLevel(VK_Texture::StreamingState const& state) const;
+        bool IsUnused(VK_Texture::StreamingState const& state) const;
+        static VkDeviceSize GetImageSize(VK_Texture::StreamingState const& state, uint baseLevel);
+
+    private:
+        // uploads running in parallel
+        static constexpr size_t MAX_JOBS = 4;
+        // textures not requested for this many frames drop back to their mip tail
+        static constexpr uint64 UNUSED_FRAMES = 300;
+
+        uint64 m_FrameCounter{1};
+        VkDeviceSize m_ResidentBytes{0};
+        VkDeviceSize m_UploadBytes{0}; // scheduled in the current frame
+        std::vector<std::weak_ptr<VK_Texture>> m_Textures;
+        std::vector<std::unique_ptr<Job>> m_Jobs;
+        std::vector<RetiredImage> m_RetiredImages;
+    };
+} // namespace GfxRenderEngine
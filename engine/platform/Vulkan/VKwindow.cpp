@@ -36,7 +36,8 @@ namespace GfxRenderEngine
 
     bool VK_Window::m_GLFWIsInitialized = false;
 
-    VK_Window::VK_Window(const WindowProperties& props) : m_OK(false), m_IsFullscreen(false), m_AllowCursor(false)
+    VK_Window::VK_Window(const WindowProperties& props)
+        : m_OK(false), m_Headless(props.m_Headless), m_IsFullscreen(false), m_AllowCursor(false)
     {
         m_WindowProperties.m_Title = props.m_Title;
         m_WindowProperties.m_Width = props.m_Width;
@@ -279,6 +280,12 @@ namespace GfxRenderEngine
 
     bool VK_Window::InitGLFW()
     {
+        if (m_Headless)
+        {
+            // the null platform creates no native window,
+            // glfwCreateWindowSurface() then uses VK_EXT_headless_surface
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        }
 
         // init glfw
         if (!glfwInit())
@@ -336,7 +343,7 @@ namespace GfxRenderEngine
         m_WindowPositionX = (videoMode->width - m_WindowedWidth) / 2;
         m_WindowPositionY = (videoMode->height - m_WindowedHeight) / 2;
 
-        if (CoreSettings::m_EnableFullscreen)
+        if (CoreSettings::m_EnableFullscreen && !m_Headless)
         {
 #ifdef _WIN32
             m_WindowProperties.m_Width = videoMode->width;
@@ -106,6 +106,7 @@ namespace GfxRenderEngine
         static bool m_GLFWIsInitialized;
         //
         bool m_OK;
+        bool m_Headless;
 
         WindowData m_WindowProperties;
 
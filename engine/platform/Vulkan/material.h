@@ -28,3 +28,12 @@
 #define GLSL_HAS_ROUGHNESS_METALLIC_MAP (0x1 << 0x4)
 #define GLSL_HAS_EMISSIVE_COLOR (0x1 << 0x5)
 #define GLSL_HAS_EMISSIVE_MAP (0x1 << 0x6)
+
+// material texture slots, bindless materials store one texture index per slot
+#define GLSL_DIFFUSE_MAP_INDEX 0
+#define GLSL_NORMAL_MAP_INDEX 1
+#define GLSL_ROUGHNESS_MAP_INDEX 2
+#define GLSL_METALLIC_MAP_INDEX 3
+#define GLSL_ROUGHNESS_METALLIC_MAP_INDEX 4
+#define GLSL_EMISSIVE_MAP_INDEX 5
+#define GLSL_NUM_TEXTURES 6
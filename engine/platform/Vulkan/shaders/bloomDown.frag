@@ -33,9 +33,15 @@ layout(push_constant) uniform VK_PushConstantDataBloom
 {
     vec2 m_SrcResolution;
     float m_FilterRadius;
-    float m_Padding;
+    float m_RenderScale; // the top left part of every mip level holds the rendered image
 } push;
 
+// clamped to the rendered part, the texels beyond it are stale
+vec3 Sample(vec2 uv)
+{
+    return texture(emissiveMap, min(uv, vec2(push.m_RenderScale))).rgb;
+}
+
 vec3 PowVec3(vec3 v, float p)
 {
     return vec3(pow(v.x, p), pow(v.y, p), pow(v.z, p));
@@ -62,6 +68,8 @@ float KarisAverage(vec3 col)
 
 void main()
 {
+    // the viewport covers the rendered part of the target mip level
+    vec2 uv = fragUV * push.m_RenderScale;
     vec2 srcTexelSize = 1.0 / push.m_SrcResolution;
     float x = srcTexelSize.x;
     float y = srcTexelSize.y;
@@ -73,22 +81,22 @@ void main()
     // - l - m -
     // g - h - i
     // === ('e' is the current texel) ===
-    vec3 a = texture(emissiveMap, vec2(fragUV.x - 2*x, fragUV.y + 2*y)).rgb;
-    vec3 b = texture(emissiveMap, vec2(fragUV.x,       fragUV.y + 2*y)).rgb;
-    vec3 c = texture(emissiveMap, vec2(fragUV.x + 2*x, fragUV.y + 2*y)).rgb;
+    vec3 a = Sample(vec2(uv.x - 2*x, uv.y + 2*y));
+    vec3 b = Sample(vec2(uv.x,       uv.y + 2*y));
+    vec3 c = Sample(vec2(uv.x + 2*x, uv.y + 2*y));
     
-    vec3 d = texture(emissiveMap, vec2(fragUV.x - 2*x, fragUV.y)).rgb;
-    vec3 e = texture(emissiveMap, vec2(fragUV.x,       fragUV.y)).rgb;
-    vec3 f = texture(emissiveMap, vec2(fragUV.x + 2*x, fragUV.y)).rgb;
+    vec3 d = Sample(vec2(uv.x - 2*x, uv.y));
+    vec3 e = Sample(vec2(uv.x,       uv.y));
+    vec3 f = Sample(vec2(uv.x + 2*x, uv.y));
     
-    vec3 g = texture(emissiveMap, vec2(fragUV.x - 2*x, fragUV.y - 2*y)).rgb;
-    vec3 h = texture(emissiveMap, vec2(fragUV.x,       fragUV.y - 2*y)).rgb;
-    vec3 i = texture(emissiveMap, vec2(fragUV.x + 2*x, fragUV.y - 2*y)).rgb;
+    vec3 g = Sample(vec2(uv.x - 2*x, uv.y - 2*y));
+    vec3 h = Sample(vec2(uv.x,       uv.y - 2*y));
+    vec3 i = Sample(vec2(uv.x + 2*x, uv.y - 2*y));
     
-    vec3 j = texture(emissiveMap, vec2(fragUV.x - x, fragUV.y + y)).rgb;
-    vec3 k = texture(emissiveMap, vec2(fragUV.x + x, fragUV.y + y)).rgb;
-    vec3 l = texture(emissiveMap, vec2(fragUV.x - x, fragUV.y - y)).rgb;
-    vec3 m = texture(emissiveMap, vec2(fragUV.x + x, fragUV.y - y)).rgb;
+    vec3 j = Sample(vec2(uv.x - x, uv.y + y));
+    vec3 k = Sample(vec2(uv.x + x, uv.y + y));
+    vec3 l = Sample(vec2(uv.x - x, uv.y - y));
+    vec3 m = Sample(vec2(uv.x + x, uv.y - y));
     
     outEmissive.rgb = e*0.125;
     outEmissive.rgb += (a+c+g+i)*0.03125;
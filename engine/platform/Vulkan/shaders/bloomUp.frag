@@ -33,11 +33,19 @@ layout(push_constant) uniform VK_PushConstantDataBloom
 {
     vec2 m_SrcResolution;
     float m_FilterRadius;
-    float m_Padding;
+    float m_RenderScale; // the top left part of every mip level holds the rendered image
 } push;
 
+// clamped to the rendered part, the texels beyond it are stale
+vec3 Sample(vec2 uv)
+{
+    return texture(emissiveMap, min(uv, vec2(push.m_RenderScale))).rgb;
+}
+
 void main()
 {
+    // the viewport covers the rendered part of the target mip level
+    vec2 uv = fragUV * push.m_RenderScale;
     float x = push.m_FilterRadius;
     float y = push.m_FilterRadius;
     
@@ -46,17 +54,17 @@ void main()
     // d - e - f
     // g - h - i
     // === ('e' is the current texel) ===
-    vec3 a = texture(emissiveMap, vec2(fragUV.x - x, fragUV.y + y)).rgb;
-    vec3 b = texture(emissiveMap, vec2(fragUV.x,     fragUV.y + y)).rgb;
-    vec3 c = texture(emissiveMap, vec2(fragUV.x + x, fragUV.y + y)).rgb;
+    vec3 a = Sample(vec2(uv.x - x, uv.y + y));
+    vec3 b = Sample(vec2(uv.x,     uv.y + y));
+    vec3 c = Sample(vec2(uv.x + x, uv.y + y));
     
-    vec3 d = texture(emissiveMap, vec2(fragUV.x - x, fragUV.y)).rgb;
-    vec3 e = texture(emissiveMap, vec2(fragUV.x,     fragUV.y)).rgb;
-    vec3 f = texture(emissiveMap, vec2(fragUV.x + x, fragUV.y)).rgb;
+    vec3 d = Sample(vec2(uv.x - x, uv.y));
+    vec3 e = Sample(vec2(uv.x,     uv.y));
+    vec3 f = Sample(vec2(uv.x + x, uv.y));
     
-    vec3 g = texture(emissiveMap, vec2(fragUV.x - x, fragUV.y - y)).rgb;
-    vec3 h = texture(emissiveMap, vec2(fragUV.x,     fragUV.y - y)).rgb;
-    vec3 i = texture(emissiveMap, vec2(fragUV.x + x, fragUV.y - y)).rgb;
+    vec3 g = Sample(vec2(uv.x - x, uv.y - y));
+    vec3 h = Sample(vec2(uv.x,     uv.y - y));
+    vec3 i = Sample(vec2(uv.x + x, uv.y - y));
     
     // Apply weighted distribution, by using a 3x3 tent filter:
     //  1   | 1 2 1 |
@@ -25,7 +25,7 @@
 // inputs
 layout(location = 0)      in vec2  fragUV;
 
-layout(set = 0, binding = 0) uniform sampler2D shadowMapTexture;
+layout(set = 0, binding = 0) uniform sampler2DArray shadowMapTexture; // cascades, the first one is shown
 
 // outputs
 layout (location = 0) out vec4 outColor;
@@ -41,7 +41,7 @@ float LinearizeDepth(float depth)
 
 void main()
 {
-    vec4 depthValue = texture(shadowMapTexture,fragUV);
+    vec4 depthValue = texture(shadowMapTexture, vec3(fragUV, 0.0));
     float blue = LinearizeDepth(depthValue.x);
     outColor = vec4(0.0, 0.0, blue, 1.0);
 }
@@ -60,19 +60,13 @@ layout(set = 0, binding = 0) uniform GlobalUniformBuffer
     int m_NumberOfActiveDirectionalLights;
 } ubo;
 
-layout(set = 2, binding = 0) uniform sampler2DShadow shadowMapTextureHiRes;
-layout(set = 2, binding = 1) uniform sampler2DShadow shadowMapTextureLowRes;
-layout(set = 2, binding = 2) uniform ShadowUniformBuffer0
+layout(set = 2, binding = 0) uniform sampler2DArrayShadow shadowMapCascades;
+layout(set = 2, binding = 1) uniform CascadeUniformBuffer
 {
-    mat4 m_Projection;
-    mat4 m_View;
-} lightUboHiRes;
-
-layout(set = 2, binding = 3) uniform ShadowUniformBuffer1
-{
-    mat4 m_Projection;
-    mat4 m_View;
-} lightUboLowRes;
+    mat4 m_ViewProjection[MAX_SHADOW_CASCADES];
+    vec4 m_SplitDepths; // view space depth where each cascade ends
+    int m_NumberOfCascades;
+} cascadeUbo;
 
 const float PI = 3.14159265359;
 
@@ -236,62 +230,63 @@ void main()
         // scale light by NdotL
         float NdotL = max(dot(N, L), 0.0);
         float litPercentage = 1.0;
-        int SHADOWMAP_SIZE_HIRES_RES = SHADOW_MAP_HIGH_RES;
-        int SHADOWMAP_SIZE_LOW_RES   = SHADOW_MAP_LOW_RES;
-
-        // compute total number of samples to take from the shadow map
-        int PCF_SIZE = 3;
-        int pcfSizeMinus1 = int(PCF_SIZE - 1);
-        float kernelSize = 2.0 * pcfSizeMinus1 + 1.0;
-        float numSamples = kernelSize * kernelSize;
-        
-        vec4 lightSpacePosistionHiRes = lightUboHiRes.m_Projection * lightUboHiRes.m_View * vec4(fragPosition, 1.0);
-        vec3 lightSpacePosistionNDCHiRes = lightSpacePosistionHiRes.xyz / lightSpacePosistionHiRes.w;
+
+        // select the cascade by the view space depth of the fragment
+        float viewDepth = (ubo.m_View * vec4(fragPosition, 1.0)).z;
+        int cascade = 0;
+        while (cascade < cascadeUbo.m_NumberOfCascades && viewDepth > cascadeUbo.m_SplitDepths[cascade])
+        {
+            cascade++;
+        }
+
+        vec3 lightSpacePosistionNDC = vec3(2.0); // outside of the shadow map
+        if (cascade < cascadeUbo.m_NumberOfCascades)
+        {
+            vec4 lightSpacePosistion = cascadeUbo.m_ViewProjection[cascade] * vec4(fragPosition, 1.0);
+            lightSpacePosistionNDC = lightSpacePosistion.xyz / lightSpacePosistion.w;
+        }
 
         if (
-                abs(lightSpacePosistionNDCHiRes.x) > 1.0 ||
-                abs(lightSpacePosistionNDCHiRes.y) > 1.0 ||
-                abs(lightSpacePosistionNDCHiRes.z) > 1.0
+                abs(lightSpacePosistionNDC.x) > 1.0 ||
+                abs(lightSpacePosistionNDC.y) > 1.0 ||
+                abs(lightSpacePosistionNDC.z) > 1.0
             )
         {
-            // check low-resolution shadow map
-            vec4 lightSpacePosistionLowRes = lightUboLowRes.m_Projection * lightUboLowRes.m_View * vec4(fragPosition, 1.0);
-            vec3 lightSpacePosistionNDCLowRes = lightSpacePosistionLowRes.xyz / lightSpacePosistionLowRes.w;
-            if (
-                    abs(lightSpacePosistionNDCLowRes.x) > 1.0 ||
-                    abs(lightSpacePosistionNDCLowRes.y) > 1.0 ||
-                    abs(lightSpacePosistionNDCLowRes.z) > 1.0
-                )
-            {
-                litPercentage = 1.0;
-            }
-            else
+            litPercentage = 1.0;
+        }
+        else if (cascade > 0)
+        {
+            // compute total number of samples to take from the shadow map
+            int PCF_SIZE = 3;
+            int pcfSizeMinus1 = int(PCF_SIZE - 1);
+            float kernelSize = 2.0 * pcfSizeMinus1 + 1.0;
+            float numSamples = kernelSize * kernelSize;
+
+            // Translate from NDC to shadow map space (Vulkan's Z is already in [0..1])
+            vec2 shadowMapCoord = lightSpacePosistionNDC.xy * 0.5 + 0.5;
+
+            // Counter for the shadow map samples not in the shadow
+            float litCount = 0.0;
+
+            // Take samples from the shadow map
+            float shadowmapTexelSize = 1.0 / SHADOW_MAP_SIZE;
+            for (int x = -pcfSizeMinus1; x <= pcfSizeMinus1; x++)
             {
-                // Translate from NDC to shadow map space (Vulkan's Z is already in [0..1])
-                vec2 shadowMapCoord = lightSpacePosistionNDCLowRes.xy * 0.5 + 0.5;
-            
-                // Counter for the shadow map samples not in the shadow
-                float litCount = 0.0;
-            
-                // Take samples from the shadow map
-                float shadowmapTexelSize = 1.0 / SHADOWMAP_SIZE_LOW_RES;
-                for (int x = -pcfSizeMinus1; x <= pcfSizeMinus1; x++)
+                for (int y = -pcfSizeMinus1; y <= pcfSizeMinus1; y++)
                 {
-                    for (int y = -pcfSizeMinus1; y <= pcfSizeMinus1; y++)
-                    {
-                        // Compute coordinate for this PFC sample
-                        vec2 pcfCoordinate = shadowMapCoord + vec2(x, y) * shadowmapTexelSize;
-                        vec3 pcfCoordinatePlusReference = vec3(pcfCoordinate, lightSpacePosistionNDCLowRes.z);
-            
-                        // Check if the sample is in light
-                        litCount += texture(shadowMapTextureLowRes, pcfCoordinatePlusReference).x;
-                    }
+                    // Compute coordinate for this PFC sample
+                    vec2 pcfCoordinate = shadowMapCoord + vec2(x, y) * shadowmapTexelSize;
+                    vec4 pcfCoordinatePlusReference = vec4(pcfCoordinate, cascade, lightSpacePosistionNDC.z);
+
+                    // Check if the sample is in light
+                    litCount += texture(shadowMapCascades, pcfCoordinatePlusReference);
                 }
-                litPercentage = litCount / numSamples;
             }
+            litPercentage = litCount / numSamples;
         }
         else
         {
+            // the first cascade is sampled with a rotated kernel
             #define NUM_KERNEL_SAMPLES 16
             float scale = 3.0;
             vec2 samples[NUM_KERNEL_SAMPLES] =
@@ -317,20 +312,20 @@ void main()
             mat2 gradientMatrix = getGradientSampleMatrix();
 
             // Translate from NDC to shadow map space (Vulkan's Z is already in [0..1])
-            vec2 shadowMapCoord = lightSpacePosistionNDCHiRes.xy * 0.5 + 0.5;
+            vec2 shadowMapCoord = lightSpacePosistionNDC.xy * 0.5 + 0.5;
 
             // Counter for the shadow map samples not in the shadow
             float litCount = 0.0;
 
             // Take samples from the shadow map
-            float shadowmapTexelSize = 1.0 / SHADOWMAP_SIZE_HIRES_RES;
+            float shadowmapTexelSize = 1.0 / SHADOW_MAP_SIZE;
             for (int i = 0; i < NUM_KERNEL_SAMPLES; i++)
             {
                 // Compute coordinate for this PFC sample
                 vec2 pcfCoordinate = shadowMapCoord + (gradientMatrix * samples[i]) * shadowmapTexelSize;
-                vec3 pcfCoordinatePlusReference = vec3(pcfCoordinate, lightSpacePosistionNDCHiRes.z);
+                vec4 pcfCoordinatePlusReference = vec4(pcfCoordinate, cascade, lightSpacePosistionNDC.z);
                 // Check if the sample is in light
-                litCount += texture(shadowMapTextureHiRes, pcfCoordinatePlusReference).x;
+                litCount += texture(shadowMapCascades, pcfCoordinatePlusReference);
             }
             litPercentage = max(litCount / (NUM_KERNEL_SAMPLES), 0.15);
         }
@@ -28,7 +28,7 @@ layout(location = 0) in vec3  position;
 layout(location = 1) in vec4  color;
 layout(location = 2) in vec3  normal;
 layout(location = 3) in vec2  uv;
-layout(location = 4) in vec3  tangent;
+layout(location = 4) in vec4  tangent; // w is the handedness of the bitangent
 
 struct PointLight
 {
@@ -44,8 +44,7 @@ struct DirectionalLight
 
 struct BaseModelData
 {
-    mat4 m_ModelMatrix;
-    mat4 m_NormalMatrix;
+    vec4 m_ModelMatrix[3]; // rows of a 3x4 model matrix
 };
 
 struct GrassShaderData
@@ -89,12 +88,12 @@ layout(location = 0) out vec3 fragPosition;
 layout(location = 1) out vec4 fragColor;
 layout(location = 2) out vec3 fragNormal;
 layout(location = 3) out vec2 fragUV;
-layout(location = 4) out vec3 fragTangent;
+layout(location = 4) out vec4 fragTangent;
 
 void main()
 {
-    mat4 baseModelMatrix = baseTransform.m_BaseModelData.m_ModelMatrix;
-    mat4 normalMatrix = baseTransform.m_BaseModelData.m_NormalMatrix;
+    vec4 baseModelRows[3] = baseTransform.m_BaseModelData.m_ModelMatrix;
+    mat4 baseModelMatrix = transpose(mat4(baseModelRows[0], baseModelRows[1], baseModelRows[2], vec4(0.0, 0.0, 0.0, 1.0)));
 
     int index = heightMap.m_GrassShaderData[gl_InstanceIndex].m_Index;
     float hgt = heightMap.m_GrassShaderData[gl_InstanceIndex].m_Height;
@@ -176,7 +175,7 @@ void main()
 
     mat3 normalMatrixTransformed = transpose(inverse(mat3(baseModelMatrix) * mat3(localTransform)));
     fragNormal = normalize(normalMatrixTransformed * normal);
-    fragTangent = normalize(normalMatrixTransformed * tangent);
+    fragTangent = vec4(normalize(normalMatrixTransformed * tangent.xyz), tangent.w);
 
     fragUV = uv;
     fragColor = color;
@@ -0,0 +1,134 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+#version 450
+
+#include "engine/platform/Vulkan/pointlights.h"
+#include "engine/platform/Vulkan/systems/impostor/impostor.h"
+
+struct PointLight
+{
+    vec4 m_Position; // ignore w
+    vec4 m_Color;    // w is intensity
+};
+
+struct DirectionalLight
+{
+    vec4 m_Direction; // ignore w
+    vec4 m_Color;     // w is intensity
+};
+
+layout(set = 0, binding = 0) uniform GlobalUniformBuffer
+{
+    mat4 m_Projection;
+    mat4 m_View;
+
+    // point light
+    vec4 m_AmbientLightColor;
+    PointLight m_PointLights[MAX_LIGHTS];
+    DirectionalLight m_DirectionalLight;
+    int m_NumberOfActivePointLights;
+    int m_NumberOfActiveDirectionalLights;
+    int m_Spare0; // padding
+    int m_Spare1; // padding
+
+    // impostors
+    vec4 m_CameraPosition; // ignore w
+    vec4 m_ImpostorFade;   // x: distance where the crossfade begins, y: where it ends
+} ubo;
+
+layout(set = 1, binding = 0) uniform sampler2D albedoAtlas;
+layout(set = 1, binding = 1) uniform sampler2D normalDepthAtlas; // xyz: model space normal, w: depth toward the viewer
+
+layout(location = 0) in vec3 fragPosition;
+layout(location = 1) in vec2 fragFrameUV0;
+layout(location = 2) in vec2 fragFrameUV1;
+layout(location = 3) in vec2 fragFrameUV2;
+layout(location = 4) flat in vec3 fragWeights;
+layout(location = 5) flat in vec2 fragFrame0;
+layout(location = 6) flat in vec2 fragFrame1;
+layout(location = 7) flat in vec2 fragFrame2;
+layout(location = 8) flat in mat3 fragNormalMatrix;
+layout(location = 11) flat in float fragRadius;
+
+layout (location = 0) out vec4 outPosition;
+layout (location = 1) out vec4 outNormal;
+layout (location = 2) out vec4 outColor;
+layout (location = 3) out vec4 outMaterial;
+layout (location = 4) out vec4 outEmissive;
+
+const float IMPOSTOR_ROUGHNESS = 0.8; // the atlas has no material channels, foliage is rough
+
+// ordered dither, the mesh in pbr.frag discards the complementary pixels
+float DitherThreshold()
+{
+    const float BAYER[16] = float[](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0, 3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+    ivec2 pixel = ivec2(gl_FragCoord.xy) & 3;
+    return (BAYER[pixel.y * 4 + pixel.x] + 0.5) / 16.0;
+}
+
+vec2 AtlasUV(vec2 frame, vec2 frameUV)
+{
+    return (frame + clamp(frameUV, 0.0, 1.0)) / float(IMPOSTOR_FRAMES);
+}
+
+void main()
+{
+    // 0 outside the crossfade, 1 where the mesh is gone
+    float distanceToCamera = length(ubo.m_CameraPosition.xyz - fragPosition);
+    float fade = clamp((distanceToCamera - ubo.m_ImpostorFade.x) / (ubo.m_ImpostorFade.y - ubo.m_ImpostorFade.x), 0.0, 1.0);
+    if (fade <= DitherThreshold())
+    {
+        discard;
+    }
+
+    // a frame does not contribute where the quad leaves its view of the bounding sphere
+    vec3 weights = fragWeights;
+    weights.x *= float(all(equal(fragFrameUV0, clamp(fragFrameUV0, 0.0, 1.0))));
+    weights.y *= float(all(equal(fragFrameUV1, clamp(fragFrameUV1, 0.0, 1.0))));
+    weights.z *= float(all(equal(fragFrameUV2, clamp(fragFrameUV2, 0.0, 1.0))));
+
+    vec2 uv0 = AtlasUV(fragFrame0, fragFrameUV0);
+    vec2 uv1 = AtlasUV(fragFrame1, fragFrameUV1);
+    vec2 uv2 = AtlasUV(fragFrame2, fragFrameUV2);
+
+    // the atlas is premultiplied by coverage, the blend is divided by the blended alpha
+    vec4 albedo = texture(albedoAtlas, uv0) * weights.x + texture(albedoAtlas, uv1) * weights.y +
+                  texture(albedoAtlas, uv2) * weights.z;
+    if (albedo.a < 0.5)
+    {
+        discard;
+    }
+    vec4 normalDepth = texture(normalDepthAtlas, uv0) * weights.x + texture(normalDepthAtlas, uv1) * weights.y +
+                       texture(normalDepthAtlas, uv2) * weights.z;
+
+    // move the quad's fragment onto the baked surface
+    float depth = normalDepth.w / albedo.a * fragRadius;
+    vec3 position = fragPosition + normalize(ubo.m_CameraPosition.xyz - fragPosition) * depth;
+    vec4 clip = ubo.m_Projection * ubo.m_View * vec4(position, 1.0);
+    gl_FragDepth = clip.z / clip.w;
+
+    outPosition = vec4(position, 1.0);
+    outNormal = vec4(normalize(fragNormalMatrix * normalDepth.xyz), 1.0);
+    outColor = vec4(albedo.rgb / albedo.a, 1.0);
+    outMaterial = vec4(1.0, IMPOSTOR_ROUGHNESS, 0.0, 0.0);
+    outEmissive = vec4(0.0, 0.0, 0.0, 1.0);
+}
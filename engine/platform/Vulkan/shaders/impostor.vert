@@ -0,0 +1,161 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+#version 450
+
+#include "engine/platform/Vulkan/pointlights.h"
+#include "engine/platform/Vulkan/systems/impostor/impostor.h"
+
+struct PointLight
+{
+    vec4 m_Position; // ignore w
+    vec4 m_Color;    // w is intensity
+};
+
+struct DirectionalLight
+{
+    vec4 m_Direction; // ignore w
+    vec4 m_Color;     // w is intensity
+};
+
+struct InstanceData
+{
+    vec4 m_ModelMatrix[3]; // rows of a 3x4 model matrix
+};
+
+layout(set = 0, binding = 0) uniform GlobalUniformBuffer
+{
+    mat4 m_Projection;
+    mat4 m_View;
+
+    // point light
+    vec4 m_AmbientLightColor;
+    PointLight m_PointLights[MAX_LIGHTS];
+    DirectionalLight m_DirectionalLight;
+    int m_NumberOfActivePointLights;
+    int m_NumberOfActiveDirectionalLights;
+    int m_Spare0; // padding
+    int m_Spare1; // padding
+
+    // impostors
+    vec4 m_CameraPosition; // ignore w
+    vec4 m_ImpostorFade;   // x: distance where the crossfade begins, y: where it ends
+} ubo;
+
+// all impostor instances of the frame, a draw starts at its first instance
+layout(std430, set = 2, binding = 0) readonly buffer InstanceBuffer
+{
+    InstanceData m_Instances[];
+} instances;
+
+layout(push_constant) uniform Push
+{
+    float m_Radius; // bounding sphere of the model, model space
+    float m_Spare0; // padding
+    float m_Spare1; // padding
+    float m_Spare2; // padding
+} push;
+
+layout(location = 0) out vec3 fragPosition;
+layout(location = 1) out vec2 fragFrameUV0;
+layout(location = 2) out vec2 fragFrameUV1;
+layout(location = 3) out vec2 fragFrameUV2;
+layout(location = 4) flat out vec3 fragWeights;
+layout(location = 5) flat out vec2 fragFrame0;
+layout(location = 6) flat out vec2 fragFrame1;
+layout(location = 7) flat out vec2 fragFrame2;
+layout(location = 8) flat out mat3 fragNormalMatrix; // locations 8 to 10
+layout(location = 11) flat out float fragRadius;     // world space
+
+const vec2 CORNERS[6] = vec2[](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),
+                               vec2(-1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0));
+
+// must match impostorBake.vert
+vec3 FrameDirection(vec2 frame)
+{
+    vec2 octahedral = frame / float(IMPOSTOR_FRAMES - 1) * 2.0 - 1.0;
+    vec2 xz = vec2(octahedral.x + octahedral.y, octahedral.x - octahedral.y) * 0.5;
+    return normalize(vec3(xz.x, 1.0 - abs(xz.x) - abs(xz.y), xz.y));
+}
+
+void FrameBasis(vec3 direction, out vec3 right, out vec3 up)
+{
+    vec3 worldUp = (abs(direction.y) > 0.999) ? vec3(0.0, 0.0, -1.0) : vec3(0.0, 1.0, 0.0);
+    right = normalize(cross(worldUp, direction));
+    up = cross(direction, right);
+}
+
+// uv of a model space point projected into a frame, 0..1 inside the frame
+vec2 FrameUV(vec2 frame, vec3 p)
+{
+    vec3 right;
+    vec3 up;
+    FrameBasis(FrameDirection(frame), right, up);
+    return vec2(0.5 + 0.5 * dot(p, right), 0.5 - 0.5 * dot(p, up));
+}
+
+void main()
+{
+    vec4 rows[3] = instances.m_Instances[gl_InstanceIndex].m_ModelMatrix;
+    mat4 modelMatrix = transpose(mat4(rows[0], rows[1], rows[2], vec4(0.0, 0.0, 0.0, 1.0)));
+    mat3 model3 = mat3(modelMatrix);
+    mat3 inverseModel3 = inverse(model3);
+    vec3 center = modelMatrix[3].xyz;
+    float scale = max(length(model3[0]), max(length(model3[1]), length(model3[2])));
+    float radius = push.m_Radius * scale;
+
+    // the three frames closest to the view direction, interpolated barycentrically
+    vec3 viewDirection = normalize(inverseModel3 * (ubo.m_CameraPosition.xyz - center));
+    viewDirection.y = max(viewDirection.y, 0.0); // from below the horizon, the lowest frames are used
+    viewDirection /= max(abs(viewDirection.x) + abs(viewDirection.y) + abs(viewDirection.z), 1e-5);
+    vec2 octahedral = vec2(viewDirection.x + viewDirection.z, viewDirection.x - viewDirection.z);
+    vec2 grid = (octahedral * 0.5 + 0.5) * float(IMPOSTOR_FRAMES - 1);
+    vec2 cell = min(floor(grid), vec2(IMPOSTOR_FRAMES - 2));
+    vec2 f = grid - cell;
+    if (f.x + f.y < 1.0)
+    {
+        fragFrame0 = cell;
+        fragWeights = vec3(1.0 - f.x - f.y, f.x, f.y);
+    }
+    else
+    {
+        fragFrame0 = cell + vec2(1.0, 1.0);
+        fragWeights = vec3(f.x + f.y - 1.0, 1.0 - f.y, 1.0 - f.x);
+    }
+    fragFrame1 = cell + vec2(1.0, 0.0);
+    fragFrame2 = cell + vec2(0.0, 1.0);
+
+    // camera facing quad around the bounding sphere
+    vec3 cameraRight = vec3(ubo.m_View[0][0], ubo.m_View[1][0], ubo.m_View[2][0]);
+    vec3 cameraUp = vec3(ubo.m_View[0][1], ubo.m_View[1][1], ubo.m_View[2][1]);
+    vec2 corner = CORNERS[gl_VertexIndex];
+    vec3 positionWorld = center + (cameraRight * corner.x + cameraUp * corner.y) * radius;
+    gl_Position = ubo.m_Projection * ubo.m_View * vec4(positionWorld, 1.0);
+
+    vec3 p = inverseModel3 * (positionWorld - center) / push.m_Radius;
+    fragFrameUV0 = FrameUV(fragFrame0, p);
+    fragFrameUV1 = FrameUV(fragFrame1, p);
+    fragFrameUV2 = FrameUV(fragFrame2, p);
+
+    fragPosition = positionWorld;
+    fragNormalMatrix = transpose(inverseModel3);
+    fragRadius = radius;
+}
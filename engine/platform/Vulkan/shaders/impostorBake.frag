@@ -0,0 +1,81 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+#version 450
+
+#include "engine/platform/Vulkan/material.h"
+
+layout(set = 0, binding = 0) uniform sampler2D diffuseMap;
+layout(set = 0, binding = 1) uniform sampler2D normalMap;
+
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec3 fragNormal;
+layout(location = 2) in vec2 fragUV;
+layout(location = 3) in vec4 fragTangent;
+layout(location = 4) in float fragDepth;
+
+layout(location = 0) out vec4 outAlbedo;
+layout(location = 1) out vec4 outNormalDepth;
+
+layout(push_constant) uniform Push
+{
+    vec4 m_DiffuseColor;
+    int m_Features;
+    float m_NormalMapIntensity;
+    float m_Radius;
+    int m_Frame;
+} push;
+
+void main()
+{
+    vec4 col;
+    if (bool(push.m_Features & GLSL_HAS_DIFFUSE_MAP))
+    {
+        col = texture(diffuseMap, fragUV) * push.m_DiffuseColor;
+    }
+    else
+    {
+        col = fragColor;
+    }
+    if (col.a < 0.5)
+    {
+        discard;
+    }
+
+    // model space normal
+    vec3 N = normalize(fragNormal);
+    if (bool(push.m_Features & GLSL_HAS_NORMAL_MAP))
+    {
+        vec3 T = normalize(fragTangent.xyz);
+        T = normalize(T - dot(T, N) * N);
+        vec3 B = cross(N, T) * fragTangent.w;
+        mat3 TBN = mat3(T, B, N);
+
+        vec2 normalXY = texture(normalMap, fragUV).xy * 2 - vec2(1.0, 1.0);
+        vec3 normalTangentSpace = vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0)));
+        normalTangentSpace = mix(vec3(0.0, 0.0, 1.0), normalTangentSpace, push.m_NormalMapIntensity);
+        N = normalize(TBN * normalTangentSpace);
+    }
+
+    // full coverage, the cleared texels are zero and the mip levels average to premultiplied values
+    outAlbedo = vec4(col.rgb, 1.0);
+    outNormalDepth = vec4(N, fragDepth);
+}
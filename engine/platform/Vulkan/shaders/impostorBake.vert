@@ -0,0 +1,79 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+#version 450
+
+#include "engine/platform/Vulkan/systems/impostor/impostor.h"
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec4 color;
+layout(location = 2) in vec3 normal;
+layout(location = 3) in vec2 uv;
+layout(location = 4) in vec4 tangent; // w is the handedness of the bitangent
+
+layout(push_constant) uniform Push
+{
+    vec4 m_DiffuseColor;
+    int m_Features;
+    float m_NormalMapIntensity;
+    float m_Radius;
+    int m_Frame; // y * IMPOSTOR_FRAMES + x
+} push;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec2 fragUV;
+layout(location = 3) out vec4 fragTangent;
+layout(location = 4) out float fragDepth;
+
+// hemi-octahedral grid, the corners of the atlas look from the horizon, its center from above
+vec3 FrameDirection(vec2 frame)
+{
+    vec2 octahedral = frame / float(IMPOSTOR_FRAMES - 1) * 2.0 - 1.0;
+    vec2 xz = vec2(octahedral.x + octahedral.y, octahedral.x - octahedral.y) * 0.5;
+    return normalize(vec3(xz.x, 1.0 - abs(xz.x) - abs(xz.y), xz.y));
+}
+
+void FrameBasis(vec3 direction, out vec3 right, out vec3 up)
+{
+    vec3 worldUp = (abs(direction.y) > 0.999) ? vec3(0.0, 0.0, -1.0) : vec3(0.0, 1.0, 0.0);
+    right = normalize(cross(worldUp, direction));
+    up = cross(direction, right);
+}
+
+void main()
+{
+    // orthographic view of the bounding sphere from the frame direction, model space
+    vec2 frame = vec2(push.m_Frame % IMPOSTOR_FRAMES, push.m_Frame / IMPOSTOR_FRAMES);
+    vec3 direction = FrameDirection(frame);
+    vec3 right;
+    vec3 up;
+    FrameBasis(direction, right, up);
+
+    vec3 p = position / push.m_Radius;
+    fragDepth = dot(p, direction); // toward the viewer
+    gl_Position = vec4(dot(p, right), -dot(p, up), 0.5 - 0.5 * fragDepth, 1.0);
+
+    fragColor = color;
+    fragNormal = normal;
+    fragUV = uv;
+    fragTangent = tangent;
+}
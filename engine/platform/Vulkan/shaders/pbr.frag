@@ -26,6 +26,7 @@
 #version 450
 #include "engine/platform/Vulkan/pointlights.h"
 #include "engine/platform/Vulkan/material.h"
+#include "engine/platform/Vulkan/systems/impostor/impostor.h"
 
 layout(set = 1, binding = 0) uniform sampler2D diffuseMap;
 layout(set = 1, binding = 1) uniform sampler2D normalMap;
@@ -38,7 +39,7 @@ layout(location = 0) in vec3 fragPosition;
 layout(location = 1) in vec4 fragColor;
 layout(location = 2) in vec3 fragNormal;
 layout(location = 3) in vec2 fragUV;
-layout(location = 4) in vec3 fragTangent;
+layout(location = 4) in vec4 fragTangent; // w is the handedness of the bitangent
 
 layout (location = 0) out vec4 outPosition;
 layout (location = 1) out vec4 outNormal;
@@ -69,8 +70,18 @@ layout(set = 0, binding = 0) uniform GlobalUniformBuffer
     DirectionalLight m_DirectionalLight;
     int m_NumberOfActivePointLights;
     int m_NumberOfActiveDirectionalLights;
+    int m_Spare0; // padding
+    int m_Spare1; // padding
+
+    // impostors
+    vec4 m_CameraPosition; // ignore w
+    vec4 m_ImpostorFade;   // x: distance where the crossfade begins, y: where it ends
 } ubo;
 
+// material features of a pipeline permutation, the branches on them are removed when the pipeline is compiled
+// -1: uber shader, the features are read from the material at runtime
+layout(constant_id = 0) const int SPECIALIZED_FEATURES = -1;
+
 layout(push_constant) uniform Push
 {
     int m_Features;
@@ -95,14 +106,35 @@ layout(push_constant) uniform Push
     vec4 m_Spare4[4];
 } push;
 
+// ordered dither, impostor.frag keeps the complementary pixels
+float DitherThreshold()
+{
+    const float BAYER[16] = float[](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0, 3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+    ivec2 pixel = ivec2(gl_FragCoord.xy) & 3;
+    return (BAYER[pixel.y * 4 + pixel.x] + 0.5) / 16.0;
+}
+
 void main()
 {
+    int features = (SPECIALIZED_FEATURES >= 0) ? SPECIALIZED_FEATURES : push.m_Features;
+
+    // crossfade to the impostor, 0 before the band and 1 where only the impostor remains
+    if (bool(features & GLSL_IMPOSTOR_FADE))
+    {
+        float distanceToCamera = length(ubo.m_CameraPosition.xyz - fragPosition);
+        float fade = (distanceToCamera - ubo.m_ImpostorFade.x) / (ubo.m_ImpostorFade.y - ubo.m_ImpostorFade.x);
+        if (clamp(fade, 0.0, 1.0) > DitherThreshold())
+        {
+            discard;
+        }
+    }
+
     // position
     outPosition = vec4(fragPosition, 1.0);
 
     // color
     vec4 col;
-    if (bool(push.m_Features & GLSL_HAS_DIFFUSE_MAP))
+    if (bool(features & GLSL_HAS_DIFFUSE_MAP))
     {
         col = texture(diffuseMap, fragUV) * push.m_DiffuseColor;
     }
@@ -118,17 +150,19 @@ void main()
     
     // normal
     vec3 N = normalize(fragNormal);
-    vec3 T = normalize(fragTangent);
+    vec3 T = normalize(fragTangent.xyz);
     // Gram Schmidt
     T = normalize(T - dot(T, N) * N);
-    vec3 B = cross(N, T);
+    vec3 B = cross(N, T) * fragTangent.w;
     mat3 TBN = mat3(T, B, N);
 
     float normalMapIntensity  = push.m_NormalMapIntensity;
     vec3 normalTangentSpace;
-    if (bool(push.m_Features & GLSL_HAS_NORMAL_MAP))
+    if (bool(features & GLSL_HAS_NORMAL_MAP))
     {
-        normalTangentSpace = texture(normalMap,fragUV).xyz * 2 - vec3(1.0, 1.0, 1.0);
+        // z is reconstructed, block-compressed normal maps (BC5) only store x and y
+        vec2 normalXY = texture(normalMap,fragUV).xy * 2 - vec2(1.0, 1.0);
+        normalTangentSpace = vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0)));
         normalTangentSpace = mix(vec3(0.0, 0.0, 1.0), normalTangentSpace, normalMapIntensity);
         outNormal = vec4(normalize(TBN * normalTangentSpace), 1.0);
     }
@@ -140,14 +174,14 @@ void main()
     // roughness, metallic
     float roughness;
     float metallic;
-    if (bool(push.m_Features & GLSL_HAS_ROUGHNESS_METALLIC_MAP))
+    if (bool(features & GLSL_HAS_ROUGHNESS_METALLIC_MAP))
     {
         roughness = texture(roughnessMetallicMap, fragUV).g;
         metallic = texture(roughnessMetallicMap, fragUV).b;
     }
     else
     {
-        if (bool(push.m_Features & GLSL_HAS_ROUGHNESS_MAP))
+        if (bool(features & GLSL_HAS_ROUGHNESS_MAP))
         {
             roughness = texture(roughnessMap, fragUV).r; // gray scale
         }
@@ -155,7 +189,7 @@ void main()
         {
             roughness = push.m_Roughness;
         }
-        if (bool(push.m_Features & GLSL_HAS_METALLIC_MAP))
+        if (bool(features & GLSL_HAS_METALLIC_MAP))
         {
             metallic = texture(metallicMap, fragUV).r; // gray scale
         }
@@ -168,7 +202,7 @@ void main()
 
     // emissive material
     vec4 emissiveColor = vec4(push.m_EmissiveColor.r, push.m_EmissiveColor.g, push.m_EmissiveColor.b, 1.0);
-    if (bool(push.m_Features & GLSL_HAS_EMISSIVE_MAP))
+    if (bool(features & GLSL_HAS_EMISSIVE_MAP))
     {
         vec4 fragEmissiveColor = texture(emissiveMap, fragUV);        
         outEmissive = fragEmissiveColor * emissiveColor * push.m_EmissiveStrength;
@@ -31,7 +31,7 @@ layout(location = 0) in vec3 position;
 layout(location = 1) in vec4 color;
 layout(location = 2) in vec3 normal;
 layout(location = 3) in vec2 uv;
-layout(location = 4) in vec3 tangent;
+layout(location = 4) in vec4 tangent; // w is the handedness of the bitangent
 
 struct PointLight
 {
@@ -47,8 +47,7 @@ struct DirectionalLight
 
 struct InstanceData
 {
-    mat4 m_ModelMatrix;
-    mat4 m_NormalMatrix;
+    vec4 m_ModelMatrix[3]; // rows of a 3x4 model matrix, the normal matrix is derived from it
 };
 
 layout(set = 0, binding = 0) uniform GlobalUniformBuffer
@@ -73,20 +72,26 @@ layout(location = 0) out vec3 fragPosition;
 layout(location = 1) out vec4 fragColor;
 layout(location = 2) out vec3 fragNormal;
 layout(location = 3) out vec2 fragUV;
-layout(location = 4) out vec3 fragTangent;
+layout(location = 4) out vec4 fragTangent;
+
+mat4 GetModelMatrix(InstanceData instance)
+{
+    return transpose(mat4(instance.m_ModelMatrix[0], instance.m_ModelMatrix[1], instance.m_ModelMatrix[2],
+                          vec4(0.0, 0.0, 0.0, 1.0)));
+}
 
 void main()
 {
-    mat4 modelMatrix = uboInstanced.m_InstanceData[gl_InstanceIndex].m_ModelMatrix;
-    mat4 normalMatrix = uboInstanced.m_InstanceData[gl_InstanceIndex].m_NormalMatrix;
+    mat4 modelMatrix = GetModelMatrix(uboInstanced.m_InstanceData[gl_InstanceIndex]);
+    mat3 normalMatrix = transpose(inverse(mat3(modelMatrix)));
 
     // projection * view * model * position
     gl_Position = ubo.m_Projection * ubo.m_View * modelMatrix * vec4(position, 1.0);
 
     vec4 positionWorld = modelMatrix * vec4(position, 1.0);
     fragPosition = positionWorld.xyz;
-    fragNormal = mat3(normalMatrix) * normal;
-    fragTangent = mat3(normalMatrix) * tangent;
+    fragNormal = normalMatrix * normal;
+    fragTangent = vec4(normalMatrix * tangent.xyz, tangent.w);
 
     fragUV = uv;
     fragColor = color;
@@ -0,0 +1,229 @@
+/* Engine Copyright (c) 2024 Engine Development Team 
+   https://github.com/beaumanvienna/vulkan
+   *
+   * PBR rendering; parts of this code are based on https://learnopengl.com/PBR/Lighting
+   * bindless variant of pbr.frag: materials and textures are indexed, see VK_BindlessTable
+   *
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+#include "engine/platform/Vulkan/pointlights.h"
+#include "engine/platform/Vulkan/material.h"
+#include "engine/platform/Vulkan/systems/impostor/impostor.h"
+
+struct PbrMaterial
+{
+    int m_Features;
+    float m_Roughness;
+    float m_Metallic;
+    float m_Spare0; // padding
+
+    // byte 16 to 31
+    vec4 m_DiffuseColor;
+
+    // byte 32 to 47
+    vec3 m_EmissiveColor;
+    float m_EmissiveStrength;
+
+    // byte 48 to 63
+    float m_NormalMapIntensity;
+    float m_Spare1; // padding
+    float m_Spare2; // padding
+    float m_Spare3; // padding
+
+    // byte 64 to 128
+    vec4 m_Spare4[4];
+
+    // byte 128 to 159
+    uint m_TextureIndices[GLSL_NUM_TEXTURES];
+    uint m_Spare5; // padding
+    uint m_Spare6; // padding
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer MaterialBuffer
+{
+    PbrMaterial m_Materials[];
+} materialBuffer;
+
+layout(set = 1, binding = 1) uniform sampler2D textures[];
+
+#define MATERIAL_TEXTURE(index) textures[nonuniformEXT(material.m_TextureIndices[index])]
+
+layout(location = 0) in vec3 fragPosition;
+layout(location = 1) in vec4 fragColor;
+layout(location = 2) in vec3 fragNormal;
+layout(location = 3) in vec2 fragUV;
+layout(location = 4) in vec4 fragTangent; // w is the handedness of the bitangent
+
+layout (location = 0) out vec4 outPosition;
+layout (location = 1) out vec4 outNormal;
+layout (location = 2) out vec4 outColor;
+layout (location = 3) out vec4 outMaterial;
+layout (location = 4) out vec4 outEmissive;
+
+struct PointLight
+{
+    vec4 m_Position;  // ignore w
+    vec4 m_Color;     // w is intensity
+};
+
+struct DirectionalLight
+{
+    vec4 m_Direction;  // ignore w
+    vec4 m_Color;     // w is intensity
+};
+
+layout(set = 0, binding = 0) uniform GlobalUniformBuffer
+{
+    mat4 m_Projection;
+    mat4 m_View;
+
+    // point light
+    vec4 m_AmbientLightColor;
+    PointLight m_PointLights[MAX_LIGHTS];
+    DirectionalLight m_DirectionalLight;
+    int m_NumberOfActivePointLights;
+    int m_NumberOfActiveDirectionalLights;
+    int m_Spare0; // padding
+    int m_Spare1; // padding
+
+    // impostors
+    vec4 m_CameraPosition; // ignore w
+    vec4 m_ImpostorFade;   // x: distance where the crossfade begins, y: where it ends
+} ubo;
+
+// material features of a pipeline permutation, the branches on them are removed when the pipeline is compiled
+// -1: uber shader, the features are read from the material at runtime
+layout(constant_id = 0) const int SPECIALIZED_FEATURES = -1;
+
+layout(push_constant) uniform Push
+{
+    uint m_MaterialIndex;
+} push;
+
+// ordered dither, impostor.frag keeps the complementary pixels
+float DitherThreshold()
+{
+    const float BAYER[16] = float[](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0, 3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+    ivec2 pixel = ivec2(gl_FragCoord.xy) & 3;
+    return (BAYER[pixel.y * 4 + pixel.x] + 0.5) / 16.0;
+}
+
+void main()
+{
+    PbrMaterial material = materialBuffer.m_Materials[push.m_MaterialIndex];
+    int features = (SPECIALIZED_FEATURES >= 0) ? SPECIALIZED_FEATURES : material.m_Features;
+
+    // crossfade to the impostor, 0 before the band and 1 where only the impostor remains
+    if (bool(features & GLSL_IMPOSTOR_FADE))
+    {
+        float distanceToCamera = length(ubo.m_CameraPosition.xyz - fragPosition);
+        float fade = (distanceToCamera - ubo.m_ImpostorFade.x) / (ubo.m_ImpostorFade.y - ubo.m_ImpostorFade.x);
+        if (clamp(fade, 0.0, 1.0) > DitherThreshold())
+        {
+            discard;
+        }
+    }
+
+    // position
+    outPosition = vec4(fragPosition, 1.0);
+
+    // color
+    vec4 col;
+    if (bool(features & GLSL_HAS_DIFFUSE_MAP))
+    {
+        col = texture(MATERIAL_TEXTURE(GLSL_DIFFUSE_MAP_INDEX), fragUV) * material.m_DiffuseColor;
+    }
+    else
+    {
+        col = vec4(fragColor.r, fragColor.g, fragColor.b, fragColor.a);
+    }
+    if (col.a < 0.5)
+    {
+        discard;
+    }
+    outColor = col;
+    
+    // normal
+    vec3 N = normalize(fragNormal);
+    vec3 T = normalize(fragTangent.xyz);
+    // Gram Schmidt
+    T = normalize(T - dot(T, N) * N);
+    vec3 B = cross(N, T) * fragTangent.w;
+    mat3 TBN = mat3(T, B, N);
+
+    float normalMapIntensity  = material.m_NormalMapIntensity;
+    vec3 normalTangentSpace;
+    if (bool(features & GLSL_HAS_NORMAL_MAP))
+    {
+        // z is reconstructed, block-compressed normal maps (BC5) only store x and y
+        vec2 normalXY = texture(MATERIAL_TEXTURE(GLSL_NORMAL_MAP_INDEX),fragUV).xy * 2 - vec2(1.0, 1.0);
+        normalTangentSpace = vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0)));
+        normalTangentSpace = mix(vec3(0.0, 0.0, 1.0), normalTangentSpace, normalMapIntensity);
+        outNormal = vec4(normalize(TBN * normalTangentSpace), 1.0);
+    }
+    else
+    {
+        outNormal = vec4(N, 1.0);
+    }
+    
+    // roughness, metallic
+    float roughness;
+    float metallic;
+    if (bool(features & GLSL_HAS_ROUGHNESS_METALLIC_MAP))
+    {
+        roughness = texture(MATERIAL_TEXTURE(GLSL_ROUGHNESS_METALLIC_MAP_INDEX), fragUV).g;
+        metallic = texture(MATERIAL_TEXTURE(GLSL_ROUGHNESS_METALLIC_MAP_INDEX), fragUV).b;
+    }
+    else
+    {
+        if (bool(features & GLSL_HAS_ROUGHNESS_MAP))
+        {
+            roughness = texture(MATERIAL_TEXTURE(GLSL_ROUGHNESS_MAP_INDEX), fragUV).r; // gray scale
+        }
+        else
+        {
+            roughness = material.m_Roughness;
+        }
+        if (bool(features & GLSL_HAS_METALLIC_MAP))
+        {
+            metallic = texture(MATERIAL_TEXTURE(GLSL_METALLIC_MAP_INDEX), fragUV).r; // gray scale
+        }
+        else
+        {
+            metallic = material.m_Metallic;
+        }
+    }
+    outMaterial = vec4(normalMapIntensity, roughness, metallic, 0.0);
+
+    // emissive material
+    vec4 emissiveColor = vec4(material.m_EmissiveColor.r, material.m_EmissiveColor.g, material.m_EmissiveColor.b, 1.0);
+    if (bool(features & GLSL_HAS_EMISSIVE_MAP))
+    {
+        vec4 fragEmissiveColor = texture(MATERIAL_TEXTURE(GLSL_EMISSIVE_MAP_INDEX), fragUV);        
+        outEmissive = fragEmissiveColor * emissiveColor * material.m_EmissiveStrength;
+    }
+    else
+    {
+        outEmissive = emissiveColor * material.m_EmissiveStrength;
+    }
+}
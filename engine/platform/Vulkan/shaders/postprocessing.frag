@@ -22,17 +22,125 @@
 
 #version 450
 
-layout(input_attachment_index = 0, set = 1, binding = 0) uniform subpassInput colorAttachment;
-layout(input_attachment_index = 1, set = 1, binding = 1) uniform subpassInput emissiveMap;
+// the 3D pass rendered into the top left part of the images, see VK_RenderPass::SetRenderScale()
+layout(set = 1, binding = 0) uniform sampler2D colorMap;
+layout(set = 1, binding = 1) uniform sampler2D emissiveMap;
+
+layout(push_constant) uniform VK_PushConstantDataPostProcessing
+{
+    vec2 m_RenderExtent; // in texels
+    vec2 m_Spare0;       // padding
+} push;
 
 layout(location = 0) out vec4 outColor;
 
+float Luma(vec3 color)
+{
+    return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+vec3 FetchColor(ivec2 texel)
+{
+    return texelFetch(colorMap, clamp(texel, ivec2(0), ivec2(push.m_RenderExtent) - 1), 0).rgb;
+}
+
+// edge-directed upscaling in the spirit of FSR 1 EASU:
+// 12 taps of a windowed lanczos-2 kernel, rotated along the local luma gradient,
+// stretched along edges and narrowed across them, then clamped to the nearest 2x2 texels against ringing
+vec3 UpscaleColor(vec2 position) // in texels of the render extent
+{
+    vec2 p = position - 0.5;
+    ivec2 base = ivec2(floor(p));
+    vec2 f = p - vec2(base);
+
+    // 4x4 neighborhood, index 5, 6, 9, 10 are the 2x2 texels around p
+    vec3 colors[16];
+    float luma[16];
+    for (int y = 0; y < 4; ++y)
+    {
+        for (int x = 0; x < 4; ++x)
+        {
+            colors[y * 4 + x] = FetchColor(base + ivec2(x - 1, y - 1));
+            luma[y * 4 + x] = Luma(colors[y * 4 + x]);
+        }
+    }
+
+    // gradient and edge strength of the 2x2 texels, bilinearly weighted
+    vec2 gradient = vec2(0.0);
+    float edge = 0.0;
+    for (int y = 1; y < 3; ++y)
+    {
+        for (int x = 1; x < 3; ++x)
+        {
+            float weight = ((x == 1) ? 1.0 - f.x : f.x) * ((y == 1) ? 1.0 - f.y : f.y);
+            int i = y * 4 + x;
+            vec2 g = vec2(luma[i + 1] - luma[i - 1], luma[i + 4] - luma[i - 4]);
+            float lo = min(min(luma[i - 1], luma[i + 1]), min(luma[i - 4], luma[i + 4]));
+            float hi = max(max(luma[i - 1], luma[i + 1]), max(luma[i - 4], luma[i + 4]));
+            gradient += g * weight;
+            edge += clamp(length(g) / max(hi - lo, 1e-5), 0.0, 1.0) * weight;
+        }
+    }
+    edge *= edge;
+    vec2 across = (dot(gradient, gradient) > 1e-10) ? normalize(gradient) : vec2(1.0, 0.0);
+    vec2 along = vec2(-across.y, across.x);
+
+    // 1 on the axes, sqrt(2) on the diagonals: the kernel covers the same texels in every direction
+    float stretch = 1.0 / max(abs(across.x), abs(across.y));
+    vec2 scale = vec2(1.0 + (stretch - 1.0) * edge, 1.0 - 0.5 * edge);
+    float lobe = 0.5 - 0.29 * edge;
+    float clip = 1.0 / lobe;
+
+    vec3 color = vec3(0.0);
+    float weightSum = 0.0;
+    for (int y = 0; y < 4; ++y)
+    {
+        for (int x = 0; x < 4; ++x)
+        {
+            bool corner = ((x == 0) || (x == 3)) && ((y == 0) || (y == 3));
+            if (!corner)
+            {
+                vec2 offset = vec2(x - 1, y - 1) - f;
+                vec2 v = vec2(dot(offset, across), dot(offset, along)) * scale;
+                float d2 = min(dot(v, v), clip);
+                // polynomial approximation of lanczos 2, (25/16 * (2/5 * d2 - 1)^2 - 9/16) * (lobe * d2 - 1)^2
+                float lanczos = 0.4 * d2 - 1.0;
+                float window = lobe * d2 - 1.0;
+                float weight = (1.5625 * lanczos * lanczos - 0.5625) * (window * window);
+                color += colors[y * 4 + x] * weight;
+                weightSum += weight;
+            }
+        }
+    }
+    color /= weightSum;
+
+    vec3 lo = min(min(colors[5], colors[6]), min(colors[9], colors[10]));
+    vec3 hi = max(max(colors[5], colors[6]), max(colors[9], colors[10]));
+    return clamp(color, lo, hi);
+}
+
 void main()
 {
-    // retrieve G buffer data
-    vec4 emissiveColor = subpassLoad(emissiveMap);
-    // retrieve 3D pass main output color attachment
-    vec4 inColor = subpassLoad(colorAttachment);
+    vec2 outputExtent = vec2(textureSize(colorMap, 0));
+    bool fullResolution = all(equal(push.m_RenderExtent, outputExtent));
+
+    vec4 inColor;
+    vec4 emissiveColor;
+    if (fullResolution)
+    {
+        // retrieve 3D pass main output color attachment and G buffer data
+        inColor = texelFetch(colorMap, ivec2(gl_FragCoord.xy), 0);
+        emissiveColor = texelFetch(emissiveMap, ivec2(gl_FragCoord.xy), 0);
+    }
+    else
+    {
+        vec2 position = gl_FragCoord.xy * push.m_RenderExtent / outputExtent;
+        inColor = vec4(UpscaleColor(position), 1.0);
+
+        // the bloom is smooth, bilinear is enough; the clamp keeps the filter inside the rendered part
+        vec2 emissiveUV = clamp(position, vec2(0.5), push.m_RenderExtent - 0.5) / outputExtent;
+        emissiveColor = textureLod(emissiveMap, emissiveUV, 0.0);
+    }
 
     if (emissiveColor.a == 0)
     {
@@ -42,4 +150,4 @@ void main()
     {
         outColor = inColor + emissiveColor;
     }
-}
\ No newline at end of file
+}
@@ -32,8 +32,7 @@ layout(set = 0, binding = 0) uniform ShadowUniformBuffer
 
 struct InstanceData
 {
-    mat4 m_ModelMatrix;
-    mat4 m_NormalMatrix;
+    vec4 m_ModelMatrix[3]; // rows of a 3x4 model matrix, the normal matrix is derived from it
 };
 
 layout(set = 1, binding = 0) uniform InstanceUniformBuffer
@@ -41,9 +40,15 @@ layout(set = 1, binding = 0) uniform InstanceUniformBuffer
     InstanceData m_InstanceData[MAX_INSTANCE];
 } uboInstanced;
 
+mat4 GetModelMatrix(InstanceData instance)
+{
+    return transpose(mat4(instance.m_ModelMatrix[0], instance.m_ModelMatrix[1], instance.m_ModelMatrix[2],
+                          vec4(0.0, 0.0, 0.0, 1.0)));
+}
+
 void main()
 {
-    mat4 modelMatrix = uboInstanced.m_InstanceData[gl_InstanceIndex].m_ModelMatrix;
+    mat4 modelMatrix = GetModelMatrix(uboInstanced.m_InstanceData[gl_InstanceIndex]);
 
     // projection * view * model * position
     gl_Position = ubo.m_Projection * ubo.m_View * modelMatrix * vec4(position, 1.0);
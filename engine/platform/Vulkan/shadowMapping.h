@@ -23,5 +23,5 @@
    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
-#define SHADOW_MAP_HIGH_RES 2048
-#define SHADOW_MAP_LOW_RES 2048
\ No newline at end of file
+#define SHADOW_MAP_SIZE 2048
+#define MAX_SHADOW_CASCADES 4 // the lighting shader holds the split depths in a vec4
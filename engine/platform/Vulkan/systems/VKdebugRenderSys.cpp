@@ -99,5 +99,9 @@ namespace GfxRenderEngine
                   0,                         // uint32_t        firstVertex
                   0                          // uint32_t        firstInstance
         );
+        if (frameInfo.m_RenderStatistics)
+        {
+            frameInfo.m_RenderStatistics->Draw(vertexCount, 1);
+        }
     }
 } // namespace GfxRenderEngine
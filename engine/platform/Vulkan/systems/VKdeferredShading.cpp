@@ -110,5 +110,9 @@ namespace GfxRenderEngine
                   0, // firstVertex
                   0  // firstInstance
         );
+        if (frameInfo.m_RenderStatistics)
+        {
+            frameInfo.m_RenderStatistics->Draw(3, 1);
+        }
     }
 } // namespace GfxRenderEngine
@@ -106,7 +106,7 @@ namespace GfxRenderEngine
             { // update instance buffer on the GPU
                 InstanceTag& instanced = view.get<InstanceTag>(mainInstance);
                 VK_InstanceBuffer* instanceBuffer = static_cast<VK_InstanceBuffer*>(instanced.m_InstanceBuffer.get());
-                instanceBuffer->Update();
+                instanceBuffer->Update(frameInfo.m_FrameIndex);
             }
             if (mesh.m_Enabled)
             {
@@ -116,4 +116,81 @@ namespace GfxRenderEngine
             }
         }
     }
+
+    void VK_RenderSystemGrass::AddCullObjects(const VK_FrameInfo& frameInfo, Registry& registry,
+                                              VK_OcclusionCulling& culling)
+    {
+        m_CulledGrass.clear();
+        auto view = registry.view<MeshComponent, TransformComponent, PbrMaterialTag, InstanceTag, GrassTag>();
+        for (auto mainInstance : view)
+        {
+            auto& mesh = view.get<MeshComponent>(mainInstance);
+            InstanceTag& instanced = view.get<InstanceTag>(mainInstance);
+            { // update instance buffer on the GPU
+                VK_InstanceBuffer* instanceBuffer = static_cast<VK_InstanceBuffer*>(instanced.m_InstanceBuffer.get());
+                instanceBuffer->Update(frameInfo.m_FrameIndex);
+            }
+            auto& grassTag = view.get<GrassTag>(mainInstance);
+            VK_Model* model = static_cast<VK_Model*>(mesh.m_Model.get());
+            if (!mesh.m_Enabled || grassTag.m_Chunks.empty() || !model->HasIndexBuffer())
+            {
+                continue;
+            }
+
+            // chunks are boxes in grass space, a blade reaches up to the model radius beyond its root
+            glm::mat4 const& transform = instanced.m_InstanceBuffer->GetModelMatrix(0);
+            float bladeRadius = model->GetBoundingRadius() * grassTag.m_BladeScale;
+            m_CulledGrass[mainInstance] = culling.GetNumberOfObjects();
+            for (auto& submesh : model->GetSubmeshesPbr())
+            {
+                for (auto const& chunk : grassTag.m_Chunks)
+                {
+                    glm::vec3 center = 0.5f * (chunk.m_Min + chunk.m_Max);
+                    float radius = 0.5f * glm::length(chunk.m_Max - chunk.m_Min) + bladeRadius;
+                    culling.AddObject(VK_OcclusionCulling::BoundingSphere(transform, center, radius), submesh,
+                                      chunk.m_FirstInstance, chunk.m_InstanceCount);
+                }
+            }
+        }
+    }
+
+    void VK_RenderSystemGrass::RenderEntities(const VK_FrameInfo& frameInfo, Registry& registry,
+                                              VK_OcclusionCulling& culling, VK_OcclusionCulling::Phase phase)
+    {
+        m_Pipeline->Bind(frameInfo.m_CommandBuffer);
+
+        auto view = registry.view<MeshComponent, TransformComponent, PbrMaterialTag, InstanceTag, GrassTag>();
+        for (auto mainInstance : view)
+        {
+            auto& mesh = view.get<MeshComponent>(mainInstance);
+            if (!mesh.m_Enabled)
+            {
+                continue;
+            }
+            VK_Model* model = static_cast<VK_Model*>(mesh.m_Model.get());
+            auto& grassTag = view.get<GrassTag>(mainInstance);
+            auto culledGrass = m_CulledGrass.find(mainInstance);
+            if (culledGrass == m_CulledGrass.end())
+            {
+                // not culled, drawn in the first phase
+                if (phase == VK_OcclusionCulling::PHASE_FIRST)
+                {
+                    model->Bind(frameInfo.m_CommandBuffer);
+                    model->DrawGrass(frameInfo, m_PipelineLayout, grassTag.m_InstanceCount);
+                }
+                continue;
+            }
+
+            model->Bind(frameInfo.m_CommandBuffer);
+            uint firstObject = culledGrass->second;
+            uint numberOfChunks = static_cast<uint>(grassTag.m_Chunks.size());
+            for (auto& submesh : model->GetSubmeshesPbr())
+            {
+                model->BindDescriptors(frameInfo, m_PipelineLayout, submesh, true /*bind resources*/);
+                model->PushConstantsPbr(frameInfo, m_PipelineLayout, submesh);
+                culling.DrawIndirect(frameInfo, phase, firstObject, numberOfChunks);
+                firstObject += numberOfChunks;
+            }
+        }
+    }
 } // namespace GfxRenderEngine
@@ -33,6 +33,7 @@
 #include "VKpipeline.h"
 #include "VKframeInfo.h"
 #include "VKdescriptor.h"
+#include "systems/culling/VKocclusionCulling.h"
 
 namespace GfxRenderEngine
 {
@@ -51,6 +52,12 @@ namespace GfxRenderEngine
 
         void RenderEntities(const VK_FrameInfo& frameInfo, Registry& registry);
 
+        // occlusion culling: one bounding sphere per submesh and chunk of blades,
+        // AddCullObjects() runs before the first phase, RenderEntities() once per phase
+        void AddCullObjects(const VK_FrameInfo& frameInfo, Registry& registry, VK_OcclusionCulling& culling);
+        void RenderEntities(const VK_FrameInfo& frameInfo, Registry& registry, VK_OcclusionCulling& culling,
+                            VK_OcclusionCulling::Phase phase);
+
     private:
         void CreatePipelineLayout(std::vector<VkDescriptorSetLayout>& descriptorSetLayouts);
         void CreatePipeline(VkRenderPass renderPass);
@@ -58,5 +65,6 @@ namespace GfxRenderEngine
     private:
         VkPipelineLayout m_PipelineLayout;
         std::unique_ptr<VK_Pipeline> m_Pipeline;
+        std::unordered_map<entt::entity, uint> m_CulledGrass; // first culling object of an entity
     };
 } // namespace GfxRenderEngine
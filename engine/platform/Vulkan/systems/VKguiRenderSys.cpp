@@ -112,6 +112,10 @@ namespace GfxRenderEngine
                   0,                         // uint32_t        firstVertex
                   0                          // uint32_t        firstInstance
         );
+        if (frameInfo.m_RenderStatistics)
+        {
+            frameInfo.m_RenderStatistics->Draw(m_VertexCount, 1);
+        }
     }
 
     // uses guiShader2
@@ -147,5 +151,9 @@ namespace GfxRenderEngine
                   0,                         // uint32_t        firstVertex
                   0                          // uint32_t        firstInstance
         );
+        if (frameInfo.m_RenderStatistics)
+        {
+            frameInfo.m_RenderStatistics->Draw(m_VertexCount, 1);
+        }
     }
 } // namespace GfxRenderEngine
@@ -113,6 +113,10 @@ namespace GfxRenderEngine
                                &push);
 
             vkCmdDraw(frameInfo.m_CommandBuffer, 6, 1, 0, 0);
+            if (frameInfo.m_RenderStatistics)
+            {
+                frameInfo.m_RenderStatistics->Draw(6, 1);
+            }
         }
     }
 
@@ -25,6 +25,7 @@
 #include "VKinstanceBuffer.h"
 #include "VKrenderPass.h"
 #include "VKmodel.h"
+#include "VKrenderQueue.h"
 #include "VKrenderPass.h"
 #include "VKswapChain.h"
 
@@ -33,7 +34,8 @@
 namespace GfxRenderEngine
 {
     VK_RenderSystemPbrSA::VK_RenderSystemPbrSA(VkRenderPass renderPass,
-                                               std::vector<VkDescriptorSetLayout>& descriptorSetLayouts)
+                                               std::vector<VkDescriptorSetLayout>& descriptorSetLayouts, bool bindless)
+        : m_Bindless{bindless}
     {
         CreatePipelineLayout(descriptorSetLayouts);
         CreatePipeline(renderPass);
@@ -49,7 +51,7 @@ namespace GfxRenderEngine
         VkPushConstantRange pushConstantRange{};
         pushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
         pushConstantRange.offset = 0;
-        pushConstantRange.size = sizeof(Material::PbrMaterial);
+        pushConstantRange.size = m_Bindless ? sizeof(uint) : sizeof(Material::PbrMaterial);
 
         VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
         pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -89,15 +91,15 @@ namespace GfxRenderEngine
         }
         VK_Pipeline::SetColorBlendState(pipelineConfig, attachmentCount, blAttachments.data());
 
-        // create a pipeline
-        m_Pipeline = std::make_unique<VK_Pipeline>(VK_Core::m_Device, "bin-int/pbrSA.vert.spv", "bin-int/pbr.frag.spv",
-                                                   pipelineConfig);
+        // create a pipeline, the vertices are skinned by VK_Skinning before the pass
+        char const* fragmentShader = m_Bindless ? "bin-int/pbrBindless.frag.spv" : "bin-int/pbr.frag.spv";
+        m_Pipelines = std::make_unique<VK_PipelinePermutations>(VK_Core::m_Device, "bin-int/pbr.vert.spv", fragmentShader,
+                                                                pipelineConfig, Material::SHADER_FEATURES);
     }
 
     void VK_RenderSystemPbrSA::RenderEntities(const VK_FrameInfo& frameInfo, Registry& registry)
     {
-        m_Pipeline->Bind(frameInfo.m_CommandBuffer);
-
+        // the render queue binds the pipeline when it records the draws
         auto view = registry.view<MeshComponent, TransformComponent, PbrMaterialTag, InstanceTag, SkeletalAnimationTag>();
         for (auto mainInstance : view)
         {
@@ -105,12 +107,41 @@ namespace GfxRenderEngine
             { // update instance buffer on the GPU
                 InstanceTag& instanced = view.get<InstanceTag>(mainInstance);
                 VK_InstanceBuffer* instanceBuffer = static_cast<VK_InstanceBuffer*>(instanced.m_InstanceBuffer.get());
-                instanceBuffer->Update();
+                instanceBuffer->Update(frameInfo.m_FrameIndex);
             }
             if (mesh.m_Enabled)
             {
-                static_cast<VK_Model*>(mesh.m_Model.get())->Bind(frameInfo.m_CommandBuffer);
-                static_cast<VK_Model*>(mesh.m_Model.get())->DrawPbr(frameInfo, m_PipelineLayout);
+                VK_Model* model = static_cast<VK_Model*>(mesh.m_Model.get());
+                InstanceTag& instanced = view.get<InstanceTag>(mainInstance);
+                glm::vec3 position = instanced.m_InstanceBuffer->GetModelMatrix(0)[3];
+                float depth = glm::length(position - frameInfo.m_Camera->GetPosition());
+                uint instanceCount = static_cast<uint>(instanced.m_Instances.size());
+                std::vector<uint> const& lods = model->SelectLods(frameInfo, *instanced.m_InstanceBuffer, instanceCount);
+                for (auto& submesh : model->GetSubmeshesPbr())
+                {
+                    VK_Pipeline* pipeline = m_Pipelines->GetPipeline(submesh.m_Material.m_PbrMaterial.m_Features);
+                    if (submesh.m_Lods.empty())
+                    {
+                        frameInfo.m_RenderQueue->Submit(VK_RenderQueue::PASS_GEOMETRY, pipeline, m_PipelineLayout, model,
+                                                        submesh, depth, instanced.m_InstanceBuffer.get());
+                        continue;
+                    }
+                    // one packet per run of instances with the same level of detail
+                    for (uint firstInstance = 0; firstInstance < instanceCount;)
+                    {
+                        uint lastInstance = firstInstance + 1;
+                        while ((lastInstance < instanceCount) && (lods[lastInstance] == lods[firstInstance]))
+                        {
+                            ++lastInstance;
+                        }
+                        frameInfo.m_RenderQueue->Submit(VK_RenderQueue::PASS_GEOMETRY, pipeline, m_PipelineLayout, model,
+                                                        submesh, depth, firstInstance, lastInstance - firstInstance,
+                                                        instanced.m_InstanceBuffer.get(), lods[firstInstance]);
+                        firstInstance = lastInstance;
+                    }
+                }
+
+                model->RequestTextures(frameInfo, *instanced.m_InstanceBuffer, instanceCount);
             }
         }
     }
@@ -33,6 +33,7 @@
 
 #include "VKdevice.h"
 #include "VKpipeline.h"
+#include "VKpipelinePermutations.h"
 #include "VKframeInfo.h"
 #include "VKdescriptor.h"
 
@@ -42,7 +43,8 @@ namespace GfxRenderEngine
     {
 
     public:
-        VK_RenderSystemPbrSA(VkRenderPass renderPass, std::vector<VkDescriptorSetLayout>& descriptorSetLayouts);
+        VK_RenderSystemPbrSA(VkRenderPass renderPass, std::vector<VkDescriptorSetLayout>& descriptorSetLayouts,
+                             bool bindless);
         ~VK_RenderSystemPbrSA();
 
         VK_RenderSystemPbrSA(const VK_RenderSystemPbrSA&) = delete;
@@ -56,6 +58,7 @@ namespace GfxRenderEngine
 
     private:
         VkPipelineLayout m_PipelineLayout;
-        std::unique_ptr<VK_Pipeline> m_Pipeline;
+        std::unique_ptr<VK_PipelinePermutations> m_Pipelines; // specialized by material features
+        bool m_Bindless; // material index push constant instead of the material
     };
 } // namespace GfxRenderEngine
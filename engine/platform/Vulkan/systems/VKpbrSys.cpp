@@ -20,17 +20,22 @@
    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
+#include "coreSettings.h"
+
 #include "VKcore.h"
 #include "VKswapChain.h"
 #include "VKinstanceBuffer.h"
 #include "VKrenderPass.h"
 #include "VKmodel.h"
+#include "VKrenderQueue.h"
 
 #include "systems/VKpbrSys.h"
 
 namespace GfxRenderEngine
 {
-    VK_RenderSystemPbr::VK_RenderSystemPbr(VkRenderPass renderPass, std::vector<VkDescriptorSetLayout>& descriptorSetLayouts)
+    VK_RenderSystemPbr::VK_RenderSystemPbr(VkRenderPass renderPass, std::vector<VkDescriptorSetLayout>& descriptorSetLayouts,
+                                           bool bindless)
+        : m_Bindless{bindless}
     {
         CreatePipelineLayout(descriptorSetLayouts);
         CreatePipeline(renderPass);
@@ -46,7 +51,7 @@ namespace GfxRenderEngine
         VkPushConstantRange pushConstantRange{};
         pushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
         pushConstantRange.offset = 0;
-        pushConstantRange.size = sizeof(Material::PbrMaterial);
+        pushConstantRange.size = m_Bindless ? sizeof(uint) : sizeof(Material::PbrMaterial);
 
         VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
         pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -86,15 +91,16 @@ namespace GfxRenderEngine
         }
         VK_Pipeline::SetColorBlendState(pipelineConfig, attachmentCount, blAttachments.data());
 
-        // create a pipeline
-        m_Pipeline =
-            std::make_unique<VK_Pipeline>(VK_Core::m_Device, "bin-int/pbr.vert.spv", "bin-int/pbr.frag.spv", pipelineConfig);
+        // create a pipeline, the crossfade with impostors is one more permutation bit
+        char const* fragmentShader = m_Bindless ? "bin-int/pbrBindless.frag.spv" : "bin-int/pbr.frag.spv";
+        m_Pipelines = std::make_unique<VK_PipelinePermutations>(VK_Core::m_Device, "bin-int/pbr.vert.spv", fragmentShader,
+                                                                pipelineConfig,
+                                                                Material::SHADER_FEATURES | GLSL_IMPOSTOR_FADE);
     }
 
     void VK_RenderSystemPbr::RenderEntities(const VK_FrameInfo& frameInfo, Registry& registry)
     {
-        m_Pipeline->Bind(frameInfo.m_CommandBuffer);
-
+        // the render queue binds the pipeline when it records the draws
         auto view = registry.Get().view<MeshComponent, TransformComponent, PbrMaterialTag, InstanceTag>(
             entt::exclude<SkeletalAnimationTag, GrassTag>);
         for (auto mainInstance : view)
@@ -103,12 +109,65 @@ namespace GfxRenderEngine
             { // update instance buffer on the GPU
                 InstanceTag& instanced = view.get<InstanceTag>(mainInstance);
                 VK_InstanceBuffer* instanceBuffer = static_cast<VK_InstanceBuffer*>(instanced.m_InstanceBuffer.get());
-                instanceBuffer->Update();
+                instanceBuffer->Update(frameInfo.m_FrameIndex);
             }
             if (mesh.m_Enabled)
             {
-                static_cast<VK_Model*>(mesh.m_Model.get())->Bind(frameInfo.m_CommandBuffer);
-                static_cast<VK_Model*>(mesh.m_Model.get())->DrawPbr(frameInfo, m_PipelineLayout);
+                VK_Model* model = static_cast<VK_Model*>(mesh.m_Model.get());
+                InstanceTag& instanced = view.get<InstanceTag>(mainInstance);
+                glm::vec3 position = instanced.m_InstanceBuffer->GetModelMatrix(0)[3];
+                float depth = glm::length(position - frameInfo.m_Camera->GetPosition());
+                uint instanceCount = static_cast<uint>(instanced.m_Instances.size());
+                std::vector<uint> const& lods = model->SelectLods(frameInfo, *instanced.m_InstanceBuffer, instanceCount);
+                bool impostor = CoreSettings::m_Impostors && model->GetImpostor();
+                if (impostor)
+                {
+                    uint impostorsOnly = VK_RenderSystemImpostor::SelectMeshes(
+                        frameInfo, *model, *instanced.m_InstanceBuffer, instanceCount, m_MeshStates);
+                    if (frameInfo.m_RenderStatistics)
+                    {
+                        frameInfo.m_RenderStatistics->m_ImpostorInstances += impostorsOnly;
+                    }
+                }
+                else
+                {
+                    m_MeshStates.assign(instanceCount, VK_RenderSystemImpostor::MESH_OPAQUE);
+                }
+                for (auto& submesh : model->GetSubmeshesPbr())
+                {
+                    uint features = submesh.m_Material.m_PbrMaterial.m_Features;
+                    if (submesh.m_Lods.empty() && !impostor)
+                    {
+                        frameInfo.m_RenderQueue->Submit(VK_RenderQueue::PASS_GEOMETRY, m_Pipelines->GetPipeline(features),
+                                                        m_PipelineLayout, model, submesh, depth,
+                                                        instanced.m_InstanceBuffer.get());
+                        continue;
+                    }
+                    // one packet per run of instances with the same level of detail and crossfade,
+                    // instances behind the crossfade are left to the impostor system
+                    for (uint firstInstance = 0; firstInstance < instanceCount;)
+                    {
+                        uint lastInstance = firstInstance + 1;
+                        while ((lastInstance < instanceCount) && (lods[lastInstance] == lods[firstInstance]) &&
+                               (m_MeshStates[lastInstance] == m_MeshStates[firstInstance]))
+                        {
+                            ++lastInstance;
+                        }
+                        VK_RenderSystemImpostor::MeshState state = m_MeshStates[firstInstance];
+                        if (state != VK_RenderSystemImpostor::MESH_NONE)
+                        {
+                            uint runFeatures =
+                                (state == VK_RenderSystemImpostor::MESH_FADE) ? (features | GLSL_IMPOSTOR_FADE) : features;
+                            frameInfo.m_RenderQueue->Submit(VK_RenderQueue::PASS_GEOMETRY,
+                                                            m_Pipelines->GetPipeline(runFeatures), m_PipelineLayout, model,
+                                                            submesh, depth, firstInstance, lastInstance - firstInstance,
+                                                            instanced.m_InstanceBuffer.get(), lods[firstInstance]);
+                        }
+                        firstInstance = lastInstance;
+                    }
+                }
+
+                model->RequestTextures(frameInfo, *instanced.m_InstanceBuffer, instanceCount);
             }
         }
     }
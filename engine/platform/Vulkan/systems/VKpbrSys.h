@@ -33,16 +33,19 @@
 
 #include "VKdevice.h"
 #include "VKpipeline.h"
+#include "VKpipelinePermutations.h"
 #include "VKframeInfo.h"
 #include "VKdescriptor.h"
 
+#include "systems/impostor/VKimpostorSys.h"
+
 namespace GfxRenderEngine
 {
     class VK_RenderSystemPbr
     {
 
     public:
-        VK_RenderSystemPbr(VkRenderPass renderPass, std::vector<VkDescriptorSetLayout>& descriptorSetLayouts);
+        VK_RenderSystemPbr(VkRenderPass renderPass, std::vector<VkDescriptorSetLayout>& descriptorSetLayouts, bool bindless);
         ~VK_RenderSystemPbr();
 
         VK_RenderSystemPbr(const VK_RenderSystemPbr&) = delete;
@@ -56,6 +59,8 @@ namespace GfxRenderEngine
 
     private:
         VkPipelineLayout m_PipelineLayout;
-        std::unique_ptr<VK_Pipeline> m_Pipeline;
+        std::unique_ptr<VK_PipelinePermutations> m_Pipelines; // specialized by material features
+        bool m_Bindless; // material index push constant instead of the material
+        std::vector<VK_RenderSystemImpostor::MeshState> m_MeshStates; // per instance of the current group
     };
 } // namespace GfxRenderEngine
@@ -25,7 +25,6 @@
 #include "VKrenderPass.h"
 #include "VKmodel.h"
 
-#include "systems/pushConstantData.h"
 #include "systems/VKpostprocessingSys.h"
 #include "VKswapChain.h"
 
@@ -51,7 +50,7 @@ namespace GfxRenderEngine
         VkPushConstantRange pushConstantRange{};
         pushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
         pushConstantRange.offset = 0;
-        pushConstantRange.size = sizeof(VK_PushConstantDataGeneric);
+        pushConstantRange.size = sizeof(VK_PushConstantDataPostProcessing);
 
         VkPipelineLayoutCreateInfo postProcessingPipelineLayoutInfo{};
         postProcessingPipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -85,10 +84,15 @@ namespace GfxRenderEngine
                                                                  "bin-int/postprocessing.frag.spv", pipelineConfig);
     }
 
-    void VK_RenderSystemPostProcessing::PostProcessingPass(const VK_FrameInfo& frameInfo)
+    void VK_RenderSystemPostProcessing::PostProcessingPass(const VK_FrameInfo& frameInfo, VkExtent2D const& renderExtent)
     {
         m_PostProcessingPipeline->Bind(frameInfo.m_CommandBuffer);
 
+        VK_PushConstantDataPostProcessing push{};
+        push.m_RenderExtent = glm::vec2(renderExtent.width, renderExtent.height);
+        vkCmdPushConstants(frameInfo.m_CommandBuffer, m_PostProcessingPipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                           sizeof(VK_PushConstantDataPostProcessing), &push);
+
         std::vector<VkDescriptorSet> descriptorSets = {frameInfo.m_GlobalDescriptorSet,
                                                        m_PostProcessingDescriptorSets[frameInfo.m_FrameIndex]};
 
@@ -107,5 +111,9 @@ namespace GfxRenderEngine
                   0, // firstVertex
                   0  // firstInstance
         );
+        if (frameInfo.m_RenderStatistics)
+        {
+            frameInfo.m_RenderStatistics->Draw(3, 1);
+        }
     }
 } // namespace GfxRenderEngine
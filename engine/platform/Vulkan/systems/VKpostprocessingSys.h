@@ -38,6 +38,14 @@
 
 namespace GfxRenderEngine
 {
+    struct VK_PushConstantDataPostProcessing
+    {
+        glm::vec2 m_RenderExtent; // part of the sampled images the 3D pass rendered, in texels
+        glm::vec2 m_Spare0;       // padding
+    };
+
+    // composites the 3D pass color and the bloom into the swapchain image;
+    // below full resolution, the color is upscaled with an edge-directed filter (postprocessing.frag)
     class VK_RenderSystemPostProcessing
     {
 
@@ -50,7 +58,7 @@ namespace GfxRenderEngine
         VK_RenderSystemPostProcessing(const VK_RenderSystemPostProcessing&) = delete;
         VK_RenderSystemPostProcessing& operator=(const VK_RenderSystemPostProcessing&) = delete;
 
-        void PostProcessingPass(const VK_FrameInfo& frameInfo);
+        void PostProcessingPass(const VK_FrameInfo& frameInfo, VkExtent2D const& renderExtent);
 
     private:
         void CreatePostProcessingPipelineLayout(std::vector<VkDescriptorSetLayout>& descriptorSetLayouts);
@@ -32,11 +32,10 @@
 namespace GfxRenderEngine
 {
     VK_RenderSystemShadowAnimatedInstanced::VK_RenderSystemShadowAnimatedInstanced(
-        VkRenderPass renderPass0, VkRenderPass renderPass1, std::vector<VkDescriptorSetLayout>& descriptorSetLayouts)
+        VkRenderPass renderPass, std::vector<VkDescriptorSetLayout>& descriptorSetLayouts)
     {
         CreatePipelineLayout(descriptorSetLayouts);
-        CreatePipeline(m_Pipeline0, renderPass0);
-        CreatePipeline(m_Pipeline1, renderPass1);
+        CreatePipeline(m_Pipeline, renderPass);
     }
 
     VK_RenderSystemShadowAnimatedInstanced::~VK_RenderSystemShadowAnimatedInstanced()
@@ -76,24 +75,15 @@ namespace GfxRenderEngine
         pipelineConfig.rasterizationInfo.depthBiasClamp = 0.0f;          // Optional
         pipelineConfig.rasterizationInfo.depthBiasSlopeFactor = 3.0f;    // Optional
 
-        // create a pipeline
-        pipeline = std::make_unique<VK_Pipeline>(VK_Core::m_Device, "bin-int/shadowShaderAnimatedInstanced.vert.spv",
-                                                 "bin-int/shadowShaderAnimatedInstanced.frag.spv", pipelineConfig);
+        // create a pipeline, the vertices are skinned by VK_Skinning before the pass
+        pipeline = std::make_unique<VK_Pipeline>(VK_Core::m_Device, "bin-int/shadowShaderInstanced.vert.spv",
+                                                 "bin-int/shadowShaderInstanced.frag.spv", pipelineConfig);
     }
 
     void VK_RenderSystemShadowAnimatedInstanced::RenderEntities(const VK_FrameInfo& frameInfo, Registry& registry,
-                                                                DirectionalLightComponent* directionalLight, int renderpass,
                                                                 const VkDescriptorSet& shadowDescriptorSet)
     {
-
-        if (directionalLight->m_RenderPass == 0)
-        {
-            m_Pipeline0->Bind(frameInfo.m_CommandBuffer);
-        }
-        else
-        {
-            m_Pipeline1->Bind(frameInfo.m_CommandBuffer);
-        }
+        m_Pipeline->Bind(frameInfo.m_CommandBuffer);
 
         auto view = registry.view<MeshComponent, TransformComponent, SkeletalAnimationTag, InstanceTag>();
 
@@ -105,7 +95,7 @@ namespace GfxRenderEngine
                 { // update instance buffer on the GPU
                     InstanceTag& instanced = view.get<InstanceTag>(mainInstance);
                     VK_InstanceBuffer* instanceBuffer = static_cast<VK_InstanceBuffer*>(instanced.m_InstanceBuffer.get());
-                    instanceBuffer->Update();
+                    instanceBuffer->Update(frameInfo.m_FrameIndex);
                 }
                 if (mesh.m_Enabled)
                 {
@@ -42,16 +42,15 @@ namespace GfxRenderEngine
     {
 
     public:
-        VK_RenderSystemShadowAnimatedInstanced(VkRenderPass renderPass0, VkRenderPass renderPass1,
+        VK_RenderSystemShadowAnimatedInstanced(VkRenderPass renderPass,
                                                std::vector<VkDescriptorSetLayout>& descriptorSetLayouts);
         ~VK_RenderSystemShadowAnimatedInstanced();
 
         VK_RenderSystemShadowAnimatedInstanced(const VK_RenderSystemShadowAnimatedInstanced&) = delete;
         VK_RenderSystemShadowAnimatedInstanced& operator=(const VK_RenderSystemShadowAnimatedInstanced&) = delete;
 
-        void RenderEntities(const VK_FrameInfo& frameInfo, Registry& registry,
-                            DirectionalLightComponent* directionalLight, int renderpass,
-                            const VkDescriptorSet& shadowDescriptorSet);
+        // animated casters are always dynamic, they are drawn on top of the cached static shadows
+        void RenderEntities(const VK_FrameInfo& frameInfo, Registry& registry, const VkDescriptorSet& shadowDescriptorSet);
 
     private:
         void CreatePipelineLayout(std::vector<VkDescriptorSetLayout>& descriptorSetLayouts);
@@ -59,7 +58,6 @@ namespace GfxRenderEngine
 
     private:
         VkPipelineLayout m_PipelineLayout;
-        std::unique_ptr<VK_Pipeline> m_Pipeline0;
-        std::unique_ptr<VK_Pipeline> m_Pipeline1;
+        std::unique_ptr<VK_Pipeline> m_Pipeline;
     };
 } // namespace GfxRenderEngine
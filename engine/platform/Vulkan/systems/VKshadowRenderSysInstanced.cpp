@@ -22,6 +22,7 @@
 
 #include "VKcore.h"
 #include "VKmodel.h"
+#include "VKinstanceBuffer.h"
 #include "VKswapChain.h"
 #include "VKshadowMap.h"
 
@@ -30,12 +31,14 @@
 
 namespace GfxRenderEngine
 {
-    VK_RenderSystemShadowInstanced::VK_RenderSystemShadowInstanced(VkRenderPass renderPass0, VkRenderPass renderPass1,
+    // casters that did not move for this many frames are moved into the cached static layers
+    static constexpr uint STATIC_CASTER_FRAMES = 60;
+
+    VK_RenderSystemShadowInstanced::VK_RenderSystemShadowInstanced(VkRenderPass renderPass,
                                                                    std::vector<VkDescriptorSetLayout>& descriptorSetLayouts)
     {
         CreatePipelineLayout(descriptorSetLayouts);
-        CreatePipeline(m_Pipeline0, renderPass0);
-        CreatePipeline(m_Pipeline1, renderPass1);
+        CreatePipeline(m_Pipeline, renderPass);
     }
 
     VK_RenderSystemShadowInstanced::~VK_RenderSystemShadowInstanced()
@@ -77,26 +80,80 @@ namespace GfxRenderEngine
                                                  "bin-int/shadowShaderInstanced.frag.spv", pipelineConfig);
     }
 
-    void VK_RenderSystemShadowInstanced::RenderEntities(const VK_FrameInfo& frameInfo, Registry& registry,
-                                                        DirectionalLightComponent* directionalLight, int renderpass,
-                                                        const VkDescriptorSet& shadowDescriptorSet)
+    bool VK_RenderSystemShadowInstanced::UpdateCasters(const VK_FrameInfo& frameInfo, Registry& registry)
     {
+        ++m_FrameCounter;
+        bool staticCastersChanged = false;
 
-        if (directionalLight->m_RenderPass == 0)
+        auto meshView = registry.Get().view<MeshComponent, TransformComponent, InstanceTag>(
+            entt::exclude<SkeletalAnimationTag, GrassTag>);
+        for (auto entity : meshView)
         {
-            m_Pipeline0->Bind(frameInfo.m_CommandBuffer);
+            auto& mesh = meshView.get<MeshComponent>(entity);
+            InstanceTag& instanced = meshView.get<InstanceTag>(entity);
+            VK_InstanceBuffer* instanceBuffer = static_cast<VK_InstanceBuffer*>(instanced.m_InstanceBuffer.get());
+            // update instance buffer on the GPU, the shadow pass runs before the geometry pass
+            instanceBuffer->Update(frameInfo.m_FrameIndex);
+
+            uint64 version = instanceBuffer->GetVersion();
+            auto [iterator, inserted] = m_Casters.try_emplace(entity);
+            CasterState& caster = iterator->second;
+            if (inserted)
+            {
+                // new casters, e.g. after loading a scene, are assumed to be static
+                caster.m_Version = version;
+                caster.m_StillFrames = STATIC_CASTER_FRAMES;
+            }
+            else if (version != caster.m_Version)
+            {
+                caster.m_Version = version;
+                caster.m_StillFrames = 0;
+            }
+            else if (caster.m_StillFrames < STATIC_CASTER_FRAMES)
+            {
+                ++caster.m_StillFrames;
+            }
+            caster.m_LastSeen = m_FrameCounter;
+
+            bool isStatic = mesh.m_Enabled && (caster.m_StillFrames >= STATIC_CASTER_FRAMES);
+            if (isStatic != caster.m_Static)
+            {
+                caster.m_Static = isStatic;
+                staticCastersChanged = true;
+            }
         }
-        else
+
+        // destroyed entities
+        for (auto iterator = m_Casters.begin(); iterator != m_Casters.end();)
         {
-            m_Pipeline1->Bind(frameInfo.m_CommandBuffer);
+            if (iterator->second.m_LastSeen != m_FrameCounter)
+            {
+                staticCastersChanged |= iterator->second.m_Static;
+                iterator = m_Casters.erase(iterator);
+            }
+            else
+            {
+                ++iterator;
+            }
         }
+        return staticCastersChanged;
+    }
+
+    void VK_RenderSystemShadowInstanced::RenderEntities(const VK_FrameInfo& frameInfo, Registry& registry,
+                                                        VK_ShadowMap::ShadowPass pass,
+                                                        const VkDescriptorSet& shadowDescriptorSet)
+    {
+        m_Pipeline->Bind(frameInfo.m_CommandBuffer);
 
+        bool staticPass = (pass == VK_ShadowMap::STATIC_CASTERS);
         auto meshView = registry.Get().view<MeshComponent, TransformComponent, InstanceTag>(
             entt::exclude<SkeletalAnimationTag, GrassTag>);
         for (auto entity : meshView)
         {
             auto& mesh = meshView.get<MeshComponent>(entity);
-            if (mesh.m_Enabled)
+            auto caster = m_Casters.find(entity);
+            bool isStatic = (caster != m_Casters.end()) && caster->second.m_Static;
+            if (mesh.m_Enabled && (isStatic == staticPass))
             {
                 static_cast<VK_Model*>(mesh.m_Model.get())->Bind(frameInfo.m_CommandBuffer);
                 static_cast<VK_Model*>(mesh.m_Model.get())
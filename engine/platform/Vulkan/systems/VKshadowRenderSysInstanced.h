@@ -23,6 +23,7 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <vulkan/vulkan.h>
 
@@ -35,6 +36,7 @@
 #include "VKframeInfo.h"
 #include "VKdescriptor.h"
 #include "VKbuffer.h"
+#include "VKshadowMap.h"
 
 namespace GfxRenderEngine
 {
@@ -42,24 +44,36 @@ namespace GfxRenderEngine
     {
 
     public:
-        VK_RenderSystemShadowInstanced(VkRenderPass renderPass0, VkRenderPass renderPass1,
-                                       std::vector<VkDescriptorSetLayout>& descriptorSetLayouts);
+        VK_RenderSystemShadowInstanced(VkRenderPass renderPass, std::vector<VkDescriptorSetLayout>& descriptorSetLayouts);
         ~VK_RenderSystemShadowInstanced();
 
         VK_RenderSystemShadowInstanced(const VK_RenderSystemShadowInstanced&) = delete;
         VK_RenderSystemShadowInstanced& operator=(const VK_RenderSystemShadowInstanced&) = delete;
 
-        void RenderEntities(const VK_FrameInfo& frameInfo, Registry& registry,
-                            DirectionalLightComponent* directionalLight, int renderpass,
+        // updates the instance buffers once per frame and sorts the casters into static and dynamic ones
+        // returns true if the static casters changed and the cached shadow layers must be redrawn
+        bool UpdateCasters(const VK_FrameInfo& frameInfo, Registry& registry);
+        void RenderEntities(const VK_FrameInfo& frameInfo, Registry& registry, VK_ShadowMap::ShadowPass pass,
                             const VkDescriptorSet& shadowDescriptorSet);
 
     private:
         void CreatePipelineLayout(std::vector<VkDescriptorSetLayout>& descriptorSetLayouts);
         void CreatePipeline(std::unique_ptr<VK_Pipeline>& pipeline, VkRenderPass renderPass);
 
+    private:
+        struct CasterState
+        {
+            uint64 m_Version{0};     // of the instance buffer
+            uint m_StillFrames{0};   // frames since the instances last moved
+            uint64 m_LastSeen{0};    // frame counter when the entity was last in the view
+            bool m_Static{false};    // drawn into the cached layers
+        };
+
     private:
         VkPipelineLayout m_PipelineLayout;
-        std::unique_ptr<VK_Pipeline> m_Pipeline0;
-        std::unique_ptr<VK_Pipeline> m_Pipeline1;
+        std::unique_ptr<VK_Pipeline> m_Pipeline;
+
+        std::unordered_map<entt::entity, CasterState> m_Casters;
+        uint64 m_FrameCounter{0};
     };
 } // namespace GfxRenderEngine
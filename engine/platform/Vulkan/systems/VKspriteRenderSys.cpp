@@ -102,7 +102,7 @@ namespace GfxRenderEngine
             if (mesh.m_Enabled)
             {
                 static_cast<VK_Model*>(mesh.m_Model.get())->Bind(frameInfo.m_CommandBuffer);
-                static_cast<VK_Model*>(mesh.m_Model.get())->Draw(frameInfo.m_CommandBuffer);
+                static_cast<VK_Model*>(mesh.m_Model.get())->Draw(frameInfo);
             }
         }
     }
@@ -131,7 +131,7 @@ namespace GfxRenderEngine
 
             auto& mesh = particleSystem->m_Registry.get<MeshComponent>(particle.m_SpriteEntity);
             static_cast<VK_Model*>(mesh.m_Model.get())->Bind(frameInfo.m_CommandBuffer);
-            static_cast<VK_Model*>(mesh.m_Model.get())->Draw(frameInfo.m_CommandBuffer);
+            static_cast<VK_Model*>(mesh.m_Model.get())->Draw(frameInfo);
         }
     }
 } // namespace GfxRenderEngine
@@ -0,0 +1,267 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <algorithm>
+#include <array>
+
+#include "VKcore.h"
+
+#include "systems/bloom/VKbloomComputeSystem.h"
+
+namespace GfxRenderEngine
+{
+    VK_RenderSystemBloomCompute::VK_RenderSystemBloomCompute(VK_RenderPass const& renderPass3D)
+        : m_RenderPass3D{renderPass3D}, m_FilterRadius{0.001}
+    {
+        m_ExtentMipLevel0 = m_RenderPass3D.GetExtent();
+        m_NumberOfMipmaps = m_RenderPass3D.GetMipLevelsEmission();
+        CORE_ASSERT(m_NumberOfMipmaps <= BLOOM_MAX_MIP_LEVELS, "too many bloom mip levels");
+
+        CreateImageViews();
+        CreateDescriptorSets();
+        CreatePipelines();
+    }
+
+    VK_RenderSystemBloomCompute::~VK_RenderSystemBloomCompute()
+    {
+        vkDestroyPipelineLayout(VK_Core::m_Device->Device(), m_PipelineLayout, nullptr);
+        for (auto imageView : m_EmissionMipmapViews)
+        {
+            vkDestroyImageView(VK_Core::m_Device->Device(), imageView, nullptr);
+        }
+        vkDestroySampler(VK_Core::m_Device->Device(), m_Sampler, nullptr);
+    }
+
+    void VK_RenderSystemBloomCompute::CreateImageViews()
+    {
+        m_EmissionMipmapViews.resize(m_NumberOfMipmaps);
+        for (uint mipLevel = 0; mipLevel < m_NumberOfMipmaps; ++mipLevel)
+        {
+            VkImageViewCreateInfo viewInfo{};
+            viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            viewInfo.image = m_RenderPass3D.GetImageEmission();
+            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewInfo.format = m_RenderPass3D.GetFormatEmission();
+            viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            viewInfo.subresourceRange.baseMipLevel = mipLevel;
+            viewInfo.subresourceRange.levelCount = 1;
+            viewInfo.subresourceRange.baseArrayLayer = 0;
+            viewInfo.subresourceRange.layerCount = 1;
+
+            auto result =
+                vkCreateImageView(VK_Core::m_Device->Device(), &viewInfo, nullptr, &m_EmissionMipmapViews[mipLevel]);
+            if (result != VK_SUCCESS)
+            {
+                LOG_CORE_CRITICAL("failed to create texture image view!");
+            }
+        }
+    }
+
+    void VK_RenderSystemBloomCompute::CreateDescriptorSets()
+    {
+        VkSamplerCreateInfo samplerCreateInfo{};
+        samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerCreateInfo.magFilter = VK_FILTER_LINEAR;
+        samplerCreateInfo.minFilter = VK_FILTER_LINEAR;
+        samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerCreateInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerCreateInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerCreateInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerCreateInfo.anisotropyEnable = VK_FALSE;
+        samplerCreateInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+        samplerCreateInfo.minLod = 0.0f;
+        samplerCreateInfo.maxLod = 0.0f;
+        samplerCreateInfo.unnormalizedCoordinates = VK_FALSE;
+        {
+            auto result = vkCreateSampler(VK_Core::m_Device->Device(), &samplerCreateInfo, nullptr, &m_Sampler);
+            if (result != VK_SUCCESS)
+            {
+                LOG_CORE_CRITICAL("failed to create sampler!");
+            }
+        }
+
+        m_DescriptorSetLayout =
+            VK_DescriptorSetLayout::Builder()
+                .AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT)
+                .AddBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, BLOOM_MAX_MIP_LEVELS)
+                .Build();
+
+        // the shader declares BLOOM_MAX_MIP_LEVELS storage images, unused entries repeat the last level
+        std::vector<VkDescriptorImageInfo> storageImageInfos(BLOOM_MAX_MIP_LEVELS);
+        for (uint index = 0; index < BLOOM_MAX_MIP_LEVELS; ++index)
+        {
+            uint mipLevel = std::min(index, m_NumberOfMipmaps - 1);
+            storageImageInfos[index].sampler = VK_NULL_HANDLE;
+            storageImageInfos[index].imageView = m_EmissionMipmapViews[mipLevel];
+            storageImageInfos[index].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        }
+
+        m_DescriptorSets.resize(m_NumberOfMipmaps);
+        for (uint mipLevel = 0; mipLevel < m_NumberOfMipmaps; ++mipLevel)
+        {
+            VkDescriptorImageInfo sampledImageInfo{};
+            sampledImageInfo.sampler = m_Sampler;
+            sampledImageInfo.imageView = m_EmissionMipmapViews[mipLevel];
+            sampledImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+            VK_DescriptorWriter(*m_DescriptorSetLayout)
+                .WriteImage(0, sampledImageInfo)
+                .WriteImage(1, storageImageInfos)
+                .Build(m_DescriptorSets[mipLevel]);
+        }
+    }
+
+    void VK_RenderSystemBloomCompute::CreatePipelines()
+    {
+        VkDescriptorSetLayout descriptorSetLayout = m_DescriptorSetLayout->GetDescriptorSetLayout();
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(VK_PushConstantDataBloomCompute);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+        if (vkCreatePipelineLayout(VK_Core::m_Device->Device(), &pipelineLayoutInfo, nullptr, &m_PipelineLayout) !=
+            VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to create pipeline layout!");
+        }
+
+        m_PipelineDown =
+            std::make_unique<VK_ComputePipeline>(VK_Core::m_Device, "bin-int/bloomDown.comp.spv", m_PipelineLayout);
+        m_PipelineUp = std::make_unique<VK_ComputePipeline>(VK_Core::m_Device, "bin-int/bloomUp.comp.spv", m_PipelineLayout);
+    }
+
+    // the 3D pass leaves level 0 in SHADER_READ_ONLY_OPTIMAL, the other levels are overwritten;
+    // afterwards all levels are in SHADER_READ_ONLY_OPTIMAL, as after the raster path
+    void VK_RenderSystemBloomCompute::TransitionMipChain(VkCommandBuffer commandBuffer, bool toCompute)
+    {
+        std::array<VkImageMemoryBarrier, 2> barriers{};
+        for (auto& barrier : barriers)
+        {
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = m_RenderPass3D.GetImageEmission();
+            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            barrier.subresourceRange.layerCount = 1;
+        }
+        barriers[0].subresourceRange.baseMipLevel = 0;
+        barriers[0].subresourceRange.levelCount = 1;
+        barriers[1].subresourceRange.baseMipLevel = 1;
+        barriers[1].subresourceRange.levelCount = m_NumberOfMipmaps - 1;
+
+        VkPipelineStageFlags srcStage;
+        VkPipelineStageFlags dstStage;
+        if (toCompute)
+        {
+            barriers[0].oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            for (auto& barrier : barriers)
+            {
+                barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+                barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+                barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+            }
+            srcStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            dstStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        }
+        else
+        {
+            for (auto& barrier : barriers)
+            {
+                barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+                barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+                barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+            }
+            srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        }
+        vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr,
+                             static_cast<uint>(barriers.size()), barriers.data());
+    }
+
+    // the next dispatch reads what the previous one wrote
+    void VK_RenderSystemBloomCompute::ComputeBarrier(VkCommandBuffer commandBuffer)
+    {
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                             1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    void VK_RenderSystemBloomCompute::RenderBloom(VK_FrameInfo const& frameInfo)
+    {
+        VkCommandBuffer commandBuffer = frameInfo.m_CommandBuffer;
+        TransitionMipChain(commandBuffer, true);
+
+        VK_PushConstantDataBloomCompute push{};
+        push.m_FilterRadius = m_FilterRadius;
+        push.m_MipLevels = static_cast<int>(m_NumberOfMipmaps);
+        push.m_RenderScale = m_RenderPass3D.GetRenderScale(); // only the rendered part of each mip level is filtered
+
+        // down: sample mip level 0, write mip level 1 to m_NumberOfMipmaps - 1 in one dispatch
+        {
+            VkExtent2D extent{m_ExtentMipLevel0.width >> 1, m_ExtentMipLevel0.height >> 1};
+            // filter footprint in texels of the target, as in the raster path
+            push.m_SrcResolution = glm::vec2(extent.width, extent.height);
+            push.m_TargetMipLevel = 1;
+
+            m_PipelineDown->Bind(commandBuffer);
+            vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                               sizeof(VK_PushConstantDataBloomCompute), &push);
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1,
+                                    &m_DescriptorSets[0], 0, nullptr);
+            VkExtent2D rendered = VK_RenderPass::ScaleExtent(extent, push.m_RenderScale);
+            vkCmdDispatch(commandBuffer, GroupCount(rendered.width), GroupCount(rendered.height), 1);
+        }
+
+        // up: sample mip level m_NumberOfMipmaps - 1 to 1, add into mip level m_NumberOfMipmaps - 2 to 0
+        m_PipelineUp->Bind(commandBuffer);
+        for (uint mipLevel = m_NumberOfMipmaps - 1; mipLevel > 0; --mipLevel)
+        {
+            ComputeBarrier(commandBuffer);
+
+            uint targetMipLevel = mipLevel - 1;
+            VkExtent2D extent{m_ExtentMipLevel0.width >> targetMipLevel, m_ExtentMipLevel0.height >> targetMipLevel};
+            push.m_SrcResolution = glm::vec2(extent.width, extent.height);
+            push.m_TargetMipLevel = static_cast<int>(targetMipLevel);
+
+            vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                               sizeof(VK_PushConstantDataBloomCompute), &push);
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1,
+                                    &m_DescriptorSets[mipLevel], 0, nullptr);
+            VkExtent2D rendered = VK_RenderPass::ScaleExtent(extent, push.m_RenderScale);
+            vkCmdDispatch(commandBuffer, GroupCount(rendered.width), GroupCount(rendered.height), 1);
+        }
+
+        TransitionMipChain(commandBuffer, false);
+    }
+} // namespace GfxRenderEngine
@@ -0,0 +1,90 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+
+#include "VKdevice.h"
+#include "VKframeInfo.h"
+#include "VKdescriptor.h"
+#include "VKrenderPass.h"
+#include "VKcomputePipeline.h"
+
+#include "systems/bloom/bloom.h"
+
+namespace GfxRenderEngine
+{
+    struct VK_PushConstantDataBloomCompute
+    {
+        glm::vec2 m_SrcResolution;
+        float m_FilterRadius;
+        int m_MipLevels;
+        int m_TargetMipLevel;
+        float m_RenderScale; // dynamic resolution, see VK_RenderPass::SetRenderScale()
+    };
+
+    // compute implementation of VK_RenderSystemBloom:
+    // one dispatch builds the downsampled mip chain, one dispatch per level adds the upsampled chain,
+    // no render passes or frame buffers are needed
+    class VK_RenderSystemBloomCompute
+    {
+
+    public:
+        VK_RenderSystemBloomCompute(VK_RenderPass const& renderPass3D);
+        ~VK_RenderSystemBloomCompute();
+
+        VK_RenderSystemBloomCompute(const VK_RenderSystemBloomCompute&) = delete;
+        VK_RenderSystemBloomCompute& operator=(const VK_RenderSystemBloomCompute&) = delete;
+
+        void RenderBloom(VK_FrameInfo const& frameInfo);
+        void SetFilterRadius(float radius) { m_FilterRadius = radius; }
+
+    private:
+        void CreateImageViews();
+        void CreateDescriptorSets();
+        void CreatePipelines();
+
+        void TransitionMipChain(VkCommandBuffer commandBuffer, bool toCompute);
+        void ComputeBarrier(VkCommandBuffer commandBuffer);
+        static uint GroupCount(uint texels) { return (texels + BLOOM_COMPUTE_TILE_SIZE - 1) / BLOOM_COMPUTE_TILE_SIZE; }
+
+    private:
+        VK_RenderPass const& m_RenderPass3D; // external 3D pass
+        VkExtent2D m_ExtentMipLevel0;
+        uint m_NumberOfMipmaps;
+        float m_FilterRadius;
+
+        VkSampler m_Sampler;
+        std::vector<VkImageView> m_EmissionMipmapViews;
+        std::unique_ptr<VK_DescriptorSetLayout> m_DescriptorSetLayout;
+        std::vector<VkDescriptorSet> m_DescriptorSets; // per mip level: samples that level, writes all levels
+
+        VkPipelineLayout m_PipelineLayout;
+        std::unique_ptr<VK_ComputePipeline> m_PipelineDown;
+        std::unique_ptr<VK_ComputePipeline> m_PipelineUp;
+    };
+} // namespace GfxRenderEngine
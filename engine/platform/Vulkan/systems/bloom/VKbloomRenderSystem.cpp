@@ -33,13 +33,19 @@ namespace GfxRenderEngine
         : m_RenderPass3D{renderPass3D}, m_FilterRadius{0.001}
     {
         m_ExtentMipLevel0 = m_RenderPass3D.GetExtent();
+        m_NumberOfMipmaps = m_RenderPass3D.GetMipLevelsEmission();
+        m_NumberOfDownsampledImages = m_NumberOfMipmaps - 1;
+        m_BloomDescriptorSets.resize(m_NumberOfMipmaps);
+        m_EmissionMipmapViews.resize(m_NumberOfMipmaps);
+        m_FramebuffersDown.resize(m_NumberOfDownsampledImages);
+        m_FramebuffersUp.resize(m_NumberOfDownsampledImages);
 
         // render pass and frame buffers
         CreateImageViews();
         CreateAttachments();
         CreateRenderPasses();     // up and down renderpass
-        CreateFrameBuffersDown(); // use 'NUMBER_OF_MIPMAPS-1' frame buffers for downsampling
-        CreateFrameBuffersUp();   // use 'NUMBER_OF_MIPMAPS-1' frame buffers for upsampling
+        CreateFrameBuffersDown(); // use 'm_NumberOfMipmaps-1' frame buffers for downsampling
+        CreateFrameBuffersUp();   // use 'm_NumberOfMipmaps-1' frame buffers for upsampling
 
         // pipelines
         CreateBloomDescriptorSetLayout();
@@ -52,7 +58,7 @@ namespace GfxRenderEngine
     {
         vkDestroyPipelineLayout(VK_Core::m_Device->Device(), m_BloomPipelineLayout, nullptr);
 
-        for (uint mipLevel = 0; mipLevel < VK_RenderSystemBloom::NUMBER_OF_MIPMAPS; ++mipLevel)
+        for (uint mipLevel = 0; mipLevel < m_NumberOfMipmaps; ++mipLevel)
         {
             vkDestroyImageView(VK_Core::m_Device->Device(), m_EmissionMipmapViews[mipLevel], nullptr);
         }
@@ -62,7 +68,7 @@ namespace GfxRenderEngine
 
     void VK_RenderSystemBloom::CreateImageViews()
     {
-        for (uint mipLevel = 0; mipLevel < VK_RenderSystemBloom::NUMBER_OF_MIPMAPS; ++mipLevel)
+        for (uint mipLevel = 0; mipLevel < m_NumberOfMipmaps; ++mipLevel)
         {
             VkImageViewCreateInfo viewInfo{};
             viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -100,14 +106,14 @@ namespace GfxRenderEngine
             //
             //  --> VK_ATTACHMENT_LOAD_OP_CLEAR
             //
-            // e.g. if BLOOM_MIP_LEVELS == 4, then use mip level 1, 2, 3
+            // e.g. if m_NumberOfMipmaps == 4, then use mip level 1, 2, 3
             // so that we downsample mip 0 into mip 1 (== render target), etc.
             // (the g-buffer level zero image must not be cleared)
             // before the pass: VK_IMAGE_LAYOUT_UNDEFINED
             // after the pass VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
             // during the pass: VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
             uint mipLevel = 1;
-            for (uint index = 0; index < VK_RenderSystemBloom::NUMBER_OF_DOWNSAMPLED_IMAGES; ++index)
+            for (uint index = 0; index < m_NumberOfDownsampledImages; ++index)
             {
                 VkExtent2D extentMipLevel{extent.width >> mipLevel, extent.height >> mipLevel};
 
@@ -132,13 +138,13 @@ namespace GfxRenderEngine
             //
             //  --> VK_ATTACHMENT_LOAD_OP_LOAD
             //
-            // e.g. if BLOOM_MIP_LEVELS == 4, then use mip level 2, 1, 0
-            // so that we upsample the last mip (mip BLOOM_MIP_LEVELS-1) into (mip BLOOM_MIP_LEVELS-2)
+            // e.g. if m_NumberOfMipmaps == 4, then use mip level 2, 1, 0
+            // so that we upsample the last mip (mip m_NumberOfMipmaps-1) into (mip m_NumberOfMipmaps-2)
             // before the pass: VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
             // after the pass VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
             // during the pass: VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
-            uint mipLevel = VK_RenderSystemBloom::NUMBER_OF_DOWNSAMPLED_IMAGES - 1;
-            for (uint index = 0; index < VK_RenderSystemBloom::NUMBER_OF_DOWNSAMPLED_IMAGES; ++index)
+            uint mipLevel = m_NumberOfDownsampledImages - 1;
+            for (uint index = 0; index < m_NumberOfDownsampledImages; ++index)
             {
                 VkExtent2D extentMipLevel{extent.width >> mipLevel, extent.height >> mipLevel};
 
@@ -168,18 +174,18 @@ namespace GfxRenderEngine
         }
         { // up
             // use any image from m_AttachmentsUp since they all have VK_ATTACHMENT_LOAD_OP_CLEAR,
-            // m_attachmentsUp[0] -> mip level 'NUMBER_OF_MIPMAPS - 2'
+            // m_attachmentsUp[0] -> mip level 'm_NumberOfMipmaps - 2'
             VK_Attachments::Attachment& attachment = m_AttachmentsUp[0];
             m_RenderPassUp = std::make_unique<VK_BloomRenderPass>(attachment);
         }
     }
 
     // this function creates a frame buffer for each downsampled image
-    // for example if BLOOM_MIP_LEVELS == 4, then it creates 3 frame buffers
+    // for example if m_NumberOfMipmaps == 4, then it creates 3 frame buffers
     void VK_RenderSystemBloom::CreateFrameBuffersDown()
     {
         auto renderPass = m_RenderPassDown->Get();
-        for (uint index = 0; index < VK_RenderSystemBloom::NUMBER_OF_DOWNSAMPLED_IMAGES; ++index)
+        for (uint index = 0; index < m_NumberOfDownsampledImages; ++index)
         {
             auto& attachment = m_AttachmentsDown[index]; // m_attachmentsDown[0] -> mip level 1
             m_FramebuffersDown[index] = std::make_unique<VK_BloomFrameBuffer>(attachment, renderPass);
@@ -187,13 +193,13 @@ namespace GfxRenderEngine
     }
 
     // this function creates a frame buffer for each upsampled image
-    // for example if BLOOM_MIP_LEVELS == 4, then it creates 3 frame buffers
+    // for example if m_NumberOfMipmaps == 4, then it creates 3 frame buffers
     void VK_RenderSystemBloom::CreateFrameBuffersUp()
     {
         auto renderPass = m_RenderPassUp->Get();
-        for (uint index = 0; index < VK_RenderSystemBloom::NUMBER_OF_DOWNSAMPLED_IMAGES; ++index)
+        for (uint index = 0; index < m_NumberOfDownsampledImages; ++index)
         {
-            auto& attachment = m_AttachmentsUp[index]; // m_attachmentsUp[0] -> mip level [NUMBER_OF_MIPMAPS-2]
+            auto& attachment = m_AttachmentsUp[index]; // m_attachmentsUp[0] -> mip level [m_NumberOfMipmaps-2]
             m_FramebuffersUp[index] = std::make_unique<VK_BloomFrameBuffer>(attachment, renderPass);
         }
     }
@@ -238,7 +244,7 @@ namespace GfxRenderEngine
 
         VK_DescriptorWriter descriptorWriter(*m_BloomDescriptorSetsLayout);
 
-        for (uint mipLevel = 0; mipLevel < VK_RenderSystemBloom::NUMBER_OF_MIPMAPS; ++mipLevel)
+        for (uint mipLevel = 0; mipLevel < m_NumberOfMipmaps; ++mipLevel)
         {
             VkDescriptorImageInfo descriptorImageInfo{};
             descriptorImageInfo.sampler = m_Sampler;
@@ -335,22 +341,26 @@ namespace GfxRenderEngine
 
     void VK_RenderSystemBloom::RenderBloom(VK_FrameInfo const& frameInfo)
     {
+        // only the rendered part of each mip level is filtered
+        float renderScale = m_RenderPass3D.GetRenderScale();
+
         // down -------------------------------------------------------------------------------------------------------------
         m_BloomPipelineDown->Bind(frameInfo.m_CommandBuffer);
 
-        // sample from mip level 0 to mip level NUMBER_OF_MIPMAPS - 2
-        // render into mip level 1 to mip level NUMBER_OF_MIPMAPS - 1
-        // e.g. if NUMBER_OF_MIPMAPS == 4, then sample from 0, 1, 2 and render into 1, 2, 3
+        // sample from mip level 0 to mip level m_NumberOfMipmaps - 2
+        // render into mip level 1 to mip level m_NumberOfMipmaps - 1
+        // e.g. if m_NumberOfMipmaps == 4, then sample from 0, 1, 2 and render into 1, 2, 3
         uint mipLevel = 0;
-        for (uint index = 0; index < VK_RenderSystemBloom::NUMBER_OF_DOWNSAMPLED_IMAGES; ++index)
+        for (uint index = 0; index < m_NumberOfDownsampledImages; ++index)
         {
             BeginRenderPass(frameInfo, m_RenderPassDown.get(), m_FramebuffersDown[index].get());
             VkExtent2D extent{m_ExtentMipLevel0.width >> (mipLevel + 1), m_ExtentMipLevel0.height >> (mipLevel + 1)};
-            SetViewPort(frameInfo, extent);
+            SetViewPort(frameInfo, VK_RenderPass::ScaleExtent(extent, renderScale));
             VK_PushConstantDataBloom push{};
 
             push.m_SrcResolution = glm::vec2(extent.width, extent.height);
             push.m_FilterRadius = m_FilterRadius;
+            push.m_RenderScale = renderScale;
 
             vkCmdPushConstants(frameInfo.m_CommandBuffer, m_BloomPipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0,
                                sizeof(VK_PushConstantDataBloom), &push);
@@ -370,6 +380,10 @@ namespace GfxRenderEngine
                       0, // firstVertex
                       0  // firstInstance
             );
+            if (frameInfo.m_RenderStatistics)
+            {
+                frameInfo.m_RenderStatistics->Draw(3, 1);
+            }
             vkCmdEndRenderPass(frameInfo.m_CommandBuffer);
             ++mipLevel;
         }
@@ -377,19 +391,20 @@ namespace GfxRenderEngine
         // up ---------------------------------------------------------------------------------------------------------------
         m_BloomPipelineUp->Bind(frameInfo.m_CommandBuffer);
 
-        // sample from mip level mip level NUMBER_OF_MIPMAPS - 1 to 1
-        // render into mip level NUMBER_OF_MIPMAPS - 2 to mip level 0
-        // e.g. if NUMBER_OF_MIPMAPS == 4, then sample from 3, 2, 1 and render into 2, 1, 0
-        mipLevel = VK_RenderSystemBloom::NUMBER_OF_DOWNSAMPLED_IMAGES;
-        for (uint index = 0; index < VK_RenderSystemBloom::NUMBER_OF_DOWNSAMPLED_IMAGES; ++index)
+        // sample from mip level mip level m_NumberOfMipmaps - 1 to 1
+        // render into mip level m_NumberOfMipmaps - 2 to mip level 0
+        // e.g. if m_NumberOfMipmaps == 4, then sample from 3, 2, 1 and render into 2, 1, 0
+        mipLevel = m_NumberOfDownsampledImages;
+        for (uint index = 0; index < m_NumberOfDownsampledImages; ++index)
         {
             BeginRenderPass(frameInfo, m_RenderPassUp.get(), m_FramebuffersUp[index].get());
             VkExtent2D extent{m_ExtentMipLevel0.width >> (mipLevel - 1), m_ExtentMipLevel0.height >> (mipLevel - 1)};
-            SetViewPort(frameInfo, extent);
+            SetViewPort(frameInfo, VK_RenderPass::ScaleExtent(extent, renderScale));
             VK_PushConstantDataBloom push{};
 
             push.m_SrcResolution = glm::vec2(extent.width, extent.height);
             push.m_FilterRadius = m_FilterRadius;
+            push.m_RenderScale = renderScale;
 
             vkCmdPushConstants(frameInfo.m_CommandBuffer, m_BloomPipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0,
                                sizeof(VK_PushConstantDataBloom), &push);
@@ -409,6 +424,10 @@ namespace GfxRenderEngine
                       0, // firstVertex
                       0  // firstInstance
             );
+            if (frameInfo.m_RenderStatistics)
+            {
+                frameInfo.m_RenderStatistics->Draw(3, 1);
+            }
             vkCmdEndRenderPass(frameInfo.m_CommandBuffer);
             --mipLevel;
         }
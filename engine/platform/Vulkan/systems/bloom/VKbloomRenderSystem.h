@@ -47,16 +47,12 @@ namespace GfxRenderEngine
     {
         glm::vec2 m_SrcResolution;
         float m_FilterRadius;
-        float m_Padding;
+        float m_RenderScale; // dynamic resolution, see VK_RenderPass::SetRenderScale()
     };
 
     class VK_RenderSystemBloom
     {
 
-    public:
-        static constexpr int NUMBER_OF_MIPMAPS = BLOOM_MIP_LEVELS; // number of down-sampled images plus level 0
-        static constexpr int NUMBER_OF_DOWNSAMPLED_IMAGES = NUMBER_OF_MIPMAPS - 1; // number of down-sampled images
-
     public:
         VK_RenderSystemBloom(VK_RenderPass const& renderPass3D);
         ~VK_RenderSystemBloom();
@@ -88,20 +84,22 @@ namespace GfxRenderEngine
         VkPipelineLayout m_BloomPipelineLayout;
 
         VkExtent2D m_ExtentMipLevel0;
+        uint m_NumberOfMipmaps;           // number of down-sampled images plus level 0
+        uint m_NumberOfDownsampledImages; // number of down-sampled images
         float m_FilterRadius;
 
         VkSampler m_Sampler;
         std::unique_ptr<VK_DescriptorSetLayout> m_BloomDescriptorSetsLayout;
-        VkDescriptorSet m_BloomDescriptorSets[VK_RenderSystemBloom::NUMBER_OF_MIPMAPS];
+        std::vector<VkDescriptorSet> m_BloomDescriptorSets;
 
-        VkImageView m_EmissionMipmapViews[VK_RenderSystemBloom::NUMBER_OF_MIPMAPS];
+        std::vector<VkImageView> m_EmissionMipmapViews;
         VK_Attachments m_AttachmentsDown;
         VK_Attachments m_AttachmentsUp;
 
         std::unique_ptr<VK_BloomRenderPass> m_RenderPassDown;
         std::unique_ptr<VK_BloomRenderPass> m_RenderPassUp;
-        std::unique_ptr<VK_BloomFrameBuffer> m_FramebuffersDown[VK_RenderSystemBloom::NUMBER_OF_DOWNSAMPLED_IMAGES];
-        std::unique_ptr<VK_BloomFrameBuffer> m_FramebuffersUp[VK_RenderSystemBloom::NUMBER_OF_DOWNSAMPLED_IMAGES];
+        std::vector<std::unique_ptr<VK_BloomFrameBuffer>> m_FramebuffersDown;
+        std::vector<std::unique_ptr<VK_BloomFrameBuffer>> m_FramebuffersUp;
         std::unique_ptr<VK_Pipeline> m_BloomPipelineDown;
         std::unique_ptr<VK_Pipeline> m_BloomPipelineUp;
     };
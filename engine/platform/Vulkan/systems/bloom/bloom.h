@@ -1 +1,5 @@
-#define BLOOM_MIP_LEVELS 4
\ No newline at end of file
+// shared by the bloom render systems and the bloom compute shaders
+
+#define BLOOM_MIP_LEVELS 4          // default of CoreSettings::m_BloomMipLevels
+#define BLOOM_MAX_MIP_LEVELS 6      // level 0 plus the five levels a compute workgroup reduces on chip
+#define BLOOM_COMPUTE_TILE_SIZE 16  // mip 1 texels per workgroup and dimension, 16 >> 4 == 1 texel in mip 5
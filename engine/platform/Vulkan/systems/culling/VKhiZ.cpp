@@ -0,0 +1,268 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <algorithm>
+
+#include "VKcore.h"
+
+#include "systems/culling/VKhiZ.h"
+
+namespace GfxRenderEngine
+{
+    namespace
+    {
+        uint PreviousPowerOfTwo(uint value)
+        {
+            uint powerOfTwo = 1;
+            while ((powerOfTwo << 1) <= value)
+            {
+                powerOfTwo <<= 1;
+            }
+            return powerOfTwo;
+        }
+    } // namespace
+
+    VK_HiZ::VK_HiZ(VK_RenderPass const& renderPass3D) : m_RenderPass3D{renderPass3D}
+    {
+        // power-of-two levels halve exactly, so every texel of a level covers 2x2 texels of the level before it
+        VkExtent2D extent = m_RenderPass3D.GetExtent();
+        m_Extent = {PreviousPowerOfTwo(extent.width), PreviousPowerOfTwo(extent.height)};
+        m_MipLevels = 1;
+        while ((std::max(m_Extent.width, m_Extent.height) >> m_MipLevels) > 0)
+        {
+            ++m_MipLevels;
+        }
+
+        CreateImage();
+        CreateDescriptorSets();
+        CreatePipeline();
+    }
+
+    VK_HiZ::~VK_HiZ()
+    {
+        auto device = VK_Core::m_Device->Device();
+        vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+        vkDestroySampler(device, m_Sampler, nullptr);
+        for (auto imageView : m_MipViews)
+        {
+            vkDestroyImageView(device, imageView, nullptr);
+        }
+        vkDestroyImageView(device, m_ImageView, nullptr);
+        vkDestroyImage(device, m_Image, nullptr);
+        vkFreeMemory(device, m_ImageMemory, nullptr);
+    }
+
+    void VK_HiZ::CreateImage()
+    {
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent.width = m_Extent.width;
+        imageInfo.extent.height = m_Extent.height;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = m_MipLevels;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = VK_FORMAT_R32_SFLOAT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.flags = 0;
+
+        VK_Core::m_Device->CreateImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_Image, m_ImageMemory);
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = m_Image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = VK_FORMAT_R32_SFLOAT;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = m_MipLevels;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+        if (vkCreateImageView(VK_Core::m_Device->Device(), &viewInfo, nullptr, &m_ImageView) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to create texture image view!");
+        }
+
+        m_MipViews.resize(m_MipLevels);
+        for (uint mipLevel = 0; mipLevel < m_MipLevels; ++mipLevel)
+        {
+            viewInfo.subresourceRange.baseMipLevel = mipLevel;
+            viewInfo.subresourceRange.levelCount = 1;
+            if (vkCreateImageView(VK_Core::m_Device->Device(), &viewInfo, nullptr, &m_MipViews[mipLevel]) != VK_SUCCESS)
+            {
+                LOG_CORE_CRITICAL("failed to create texture image view!");
+            }
+        }
+
+        // the image never leaves VK_IMAGE_LAYOUT_GENERAL
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = m_Image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = m_MipLevels;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+        VkCommandBuffer commandBuffer = VK_Core::m_Device->BeginSingleTimeCommands();
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0,
+                             nullptr, 0, nullptr, 1, &barrier);
+        VK_Core::m_Device->EndSingleTimeCommands(commandBuffer);
+    }
+
+    void VK_HiZ::CreateDescriptorSets()
+    {
+        // nearest, the shaders fetch texels and reduce them themselves
+        VkSamplerCreateInfo samplerCreateInfo{};
+        samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerCreateInfo.magFilter = VK_FILTER_NEAREST;
+        samplerCreateInfo.minFilter = VK_FILTER_NEAREST;
+        samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerCreateInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerCreateInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerCreateInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerCreateInfo.anisotropyEnable = VK_FALSE;
+        samplerCreateInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+        samplerCreateInfo.minLod = 0.0f;
+        samplerCreateInfo.maxLod = static_cast<float>(m_MipLevels);
+        samplerCreateInfo.unnormalizedCoordinates = VK_FALSE;
+        if (vkCreateSampler(VK_Core::m_Device->Device(), &samplerCreateInfo, nullptr, &m_Sampler) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to create sampler!");
+        }
+
+        m_DescriptorSetLayout = VK_DescriptorSetLayout::Builder()
+                                    .AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT)
+                                    .AddBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT)
+                                    .Build();
+
+        m_DescriptorSets.resize(m_MipLevels);
+        for (uint mipLevel = 0; mipLevel < m_MipLevels; ++mipLevel)
+        {
+            VkDescriptorImageInfo srcImageInfo{};
+            srcImageInfo.sampler = m_Sampler;
+            if (mipLevel == 0)
+            {
+                srcImageInfo.imageView = m_RenderPass3D.GetImageViewDepth();
+                srcImageInfo.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+            }
+            else
+            {
+                srcImageInfo.imageView = m_MipViews[mipLevel - 1];
+                srcImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+            }
+
+            VkDescriptorImageInfo dstImageInfo{};
+            dstImageInfo.sampler = VK_NULL_HANDLE;
+            dstImageInfo.imageView = m_MipViews[mipLevel];
+            dstImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+            VK_DescriptorWriter(*m_DescriptorSetLayout)
+                .WriteImage(0, srcImageInfo)
+                .WriteImage(1, dstImageInfo)
+                .Build(m_DescriptorSets[mipLevel]);
+        }
+    }
+
+    void VK_HiZ::CreatePipeline()
+    {
+        VkDescriptorSetLayout descriptorSetLayout = m_DescriptorSetLayout->GetDescriptorSetLayout();
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(VK_PushConstantDataHiZ);
+
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+        if (vkCreatePipelineLayout(VK_Core::m_Device->Device(), &pipelineLayoutInfo, nullptr, &m_PipelineLayout) !=
+            VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to create pipeline layout!");
+        }
+
+        m_Pipeline = std::make_unique<VK_ComputePipeline>(VK_Core::m_Device, "bin-int/hiZ.comp.spv", m_PipelineLayout);
+    }
+
+    void VK_HiZ::Barrier(VkCommandBuffer commandBuffer, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask)
+    {
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccessMask;
+        barrier.dstAccessMask = dstAccessMask;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                             1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    void VK_HiZ::Build(VkCommandBuffer commandBuffer)
+    {
+        // the first culling phase has finished reading the old pyramid
+        Barrier(commandBuffer, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+
+        m_Pipeline->Bind(commandBuffer);
+        VkExtent2D srcExtent = m_RenderPass3D.GetRenderExtent();
+        for (uint mipLevel = 0; mipLevel < m_MipLevels; ++mipLevel)
+        {
+            if (mipLevel > 0)
+            {
+                Barrier(commandBuffer, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+            }
+            uint width = std::max(m_Extent.width >> mipLevel, 1u);
+            uint height = std::max(m_Extent.height >> mipLevel, 1u);
+
+            VK_PushConstantDataHiZ push{};
+            push.m_SrcExtent = glm::ivec2(srcExtent.width, srcExtent.height);
+            vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                               sizeof(VK_PushConstantDataHiZ), &push);
+            srcExtent = {width, height};
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1,
+                                    &m_DescriptorSets[mipLevel], 0, nullptr);
+            vkCmdDispatch(commandBuffer, GroupCount(width), GroupCount(height), 1);
+        }
+
+        // the second culling phase and the first phase of the next frame read the new pyramid
+        Barrier(commandBuffer, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
+    }
+
+    VkDescriptorImageInfo VK_HiZ::DescriptorInfo() const
+    {
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.sampler = m_Sampler;
+        imageInfo.imageView = m_ImageView;
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        return imageInfo;
+    }
+} // namespace GfxRenderEngine
@@ -0,0 +1,91 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+
+#include "VKdevice.h"
+#include "VKdescriptor.h"
+#include "VKrenderPass.h"
+#include "VKcomputePipeline.h"
+
+#include "systems/culling/occlusionCulling.h"
+
+namespace GfxRenderEngine
+{
+    struct VK_PushConstantDataHiZ
+    {
+        glm::ivec2 m_SrcExtent; // texels of the source that were rendered
+        glm::ivec2 m_Spare0;    // padding
+    };
+
+    // max-reduced depth pyramid of the 3D pass, level 0 is the previous power of two of the attachment extent;
+    // it stays in VK_IMAGE_LAYOUT_GENERAL, the culling shader samples it, the build writes it
+    class VK_HiZ
+    {
+
+    public:
+        VK_HiZ(VK_RenderPass const& renderPass3D);
+        ~VK_HiZ();
+
+        VK_HiZ(const VK_HiZ&) = delete;
+        VK_HiZ& operator=(const VK_HiZ&) = delete;
+
+        // reads the depth buffer in DEPTH_STENCIL_READ_ONLY_OPTIMAL, outside of a render pass;
+        // level 0 reduces the render extent of the 3D pass, so the pyramid always covers the whole view
+        void Build(VkCommandBuffer commandBuffer);
+
+        VkDescriptorImageInfo DescriptorInfo() const;
+        VkExtent2D GetExtent() const { return m_Extent; }
+        uint GetMipLevels() const { return m_MipLevels; }
+
+    private:
+        void CreateImage();
+        void CreateDescriptorSets();
+        void CreatePipeline();
+
+        void Barrier(VkCommandBuffer commandBuffer, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask);
+        static uint GroupCount(uint texels) { return (texels + HIZ_TILE_SIZE - 1) / HIZ_TILE_SIZE; }
+
+    private:
+        VK_RenderPass const& m_RenderPass3D; // external 3D pass
+        VkExtent2D m_Extent;                 // level 0
+        uint m_MipLevels;
+
+        VkImage m_Image;
+        VkDeviceMemory m_ImageMemory;
+        VkImageView m_ImageView; // all levels
+        std::vector<VkImageView> m_MipViews;
+        VkSampler m_Sampler;
+
+        std::unique_ptr<VK_DescriptorSetLayout> m_DescriptorSetLayout;
+        std::vector<VkDescriptorSet> m_DescriptorSets; // per level: reads the level before it, writes the level
+
+        VkPipelineLayout m_PipelineLayout;
+        std::unique_ptr<VK_ComputePipeline> m_Pipeline;
+    };
+} // namespace GfxRenderEngine
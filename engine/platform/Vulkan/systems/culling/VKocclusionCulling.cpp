@@ -0,0 +1,310 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <algorithm>
+#include <cstring>
+
+#include "VKcore.h"
+
+#include "systems/culling/VKocclusionCulling.h"
+
+namespace GfxRenderEngine
+{
+    namespace
+    {
+        // Gribb-Hartmann, depth range zero to one, normals point inwards
+        void ExtractFrustumPlanes(glm::mat4 const& viewProjection, glm::vec4 (&planes)[6])
+        {
+            glm::vec4 row0{viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]};
+            glm::vec4 row1{viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]};
+            glm::vec4 row2{viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]};
+            glm::vec4 row3{viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]};
+
+            planes[0] = row3 + row0; // left
+            planes[1] = row3 - row0; // right
+            planes[2] = row3 + row1; // top
+            planes[3] = row3 - row1; // bottom
+            planes[4] = row2;        // near
+            planes[5] = row3 - row2; // far
+            for (auto& plane : planes)
+            {
+                plane /= glm::length(glm::vec3(plane));
+            }
+        }
+
+        uint NextPowerOfTwo(uint value)
+        {
+            uint powerOfTwo = 1;
+            while (powerOfTwo < value)
+            {
+                powerOfTwo <<= 1;
+            }
+            return powerOfTwo;
+        }
+    } // namespace
+
+    VK_OcclusionCulling::VK_OcclusionCulling(VK_RenderPass const& renderPass3D)
+    {
+        m_HiZ = std::make_unique<VK_HiZ>(renderPass3D);
+        m_DescriptorSetLayout =
+            VK_DescriptorSetLayout::Builder()
+                .AddBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+                .AddBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+                .AddBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+                .AddBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+                .AddBinding(4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+                .AddBinding(5, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT)
+                .Build();
+        CreatePipeline();
+
+        for (auto& frame : m_Frames)
+        {
+            frame.m_UniformBuffer = std::make_unique<VK_Buffer>(
+                sizeof(UniformBuffer), 1, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+            frame.m_UniformBuffer->Map();
+            frame.m_Counters = std::make_unique<VK_Buffer>(
+                sizeof(Counters), 1, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+            frame.m_Counters->Map();
+            Reserve(frame, MIN_CAPACITY);
+        }
+    }
+
+    VK_OcclusionCulling::~VK_OcclusionCulling()
+    {
+        vkDestroyPipelineLayout(VK_Core::m_Device->Device(), m_PipelineLayout, nullptr);
+    }
+
+    void VK_OcclusionCulling::CreatePipeline()
+    {
+        VkDescriptorSetLayout descriptorSetLayout = m_DescriptorSetLayout->GetDescriptorSetLayout();
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(VK_PushConstantDataOcclusionCulling);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+        if (vkCreatePipelineLayout(VK_Core::m_Device->Device(), &pipelineLayoutInfo, nullptr, &m_PipelineLayout) !=
+            VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to create pipeline layout!");
+        }
+
+        m_Pipeline = std::make_unique<VK_ComputePipeline>(VK_Core::m_Device, "bin-int/occlusionCulling.comp.spv",
+                                                          m_PipelineLayout);
+    }
+
+    // the buffers of a frame slot grow in powers of two, the slot is idle while its frame is recorded
+    void VK_OcclusionCulling::Reserve(FrameResources& frame, uint numberOfObjects)
+    {
+        if (numberOfObjects <= frame.m_Capacity)
+        {
+            return;
+        }
+        frame.m_Capacity = std::max(NextPowerOfTwo(numberOfObjects), MIN_CAPACITY);
+
+        frame.m_Objects = std::make_unique<VK_Buffer>(
+            sizeof(CullObject), frame.m_Capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        frame.m_Objects->Map();
+        frame.m_Commands = std::make_unique<VK_Buffer>(
+            sizeof(VkDrawIndexedIndirectCommand), 2 * frame.m_Capacity,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        frame.m_Visibility = std::make_unique<VK_Buffer>(sizeof(uint), frame.m_Capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        VkDescriptorBufferInfo uniformBufferInfo = frame.m_UniformBuffer->DescriptorInfo();
+        VkDescriptorBufferInfo objectsInfo = frame.m_Objects->DescriptorInfo();
+        VkDescriptorBufferInfo commandsInfo = frame.m_Commands->DescriptorInfo();
+        VkDescriptorBufferInfo visibilityInfo = frame.m_Visibility->DescriptorInfo();
+        VkDescriptorBufferInfo countersInfo = frame.m_Counters->DescriptorInfo();
+        VkDescriptorImageInfo hiZInfo = m_HiZ->DescriptorInfo();
+
+        VK_DescriptorWriter writer(*m_DescriptorSetLayout);
+        writer.WriteBuffer(0, uniformBufferInfo)
+            .WriteBuffer(1, objectsInfo)
+            .WriteBuffer(2, commandsInfo)
+            .WriteBuffer(3, visibilityInfo)
+            .WriteBuffer(4, countersInfo)
+            .WriteImage(5, hiZInfo);
+        if (frame.m_DescriptorSet == VK_NULL_HANDLE)
+        {
+            writer.Build(frame.m_DescriptorSet);
+        }
+        else
+        {
+            writer.Overwrite(frame.m_DescriptorSet);
+        }
+    }
+
+    void VK_OcclusionCulling::BeginFrame(uint frameIndex, RenderStatistics& statistics)
+    {
+        // the fence of this slot has been waited for, its counters are final
+        FrameResources& frame = m_Frames[frameIndex];
+        if (frame.m_NumberOfObjects)
+        {
+            Counters counters;
+            memcpy(&counters, frame.m_Counters->GetMappedMemory(), sizeof(Counters));
+            statistics.m_CullingObjects = frame.m_NumberOfObjects;
+            statistics.m_FrustumCulled = counters.m_FrustumCulled;
+            statistics.m_OcclusionCulled = counters.m_OcclusionCulledFirstPhase - counters.m_VisibleSecondPhase;
+            statistics.m_OcclusionRescued = counters.m_VisibleSecondPhase;
+        }
+        else
+        {
+            statistics.m_CullingObjects = 0;
+            statistics.m_FrustumCulled = 0;
+            statistics.m_OcclusionCulled = 0;
+            statistics.m_OcclusionRescued = 0;
+        }
+        frame.m_NumberOfObjects = 0;
+        m_Objects.clear();
+    }
+
+    uint VK_OcclusionCulling::AddObject(glm::vec4 const& sphere, Submesh const& submesh, uint firstInstance,
+                                       uint instanceCount, uint lod)
+    {
+        SubmeshLod level = submesh.GetLod(lod);
+        uint index = static_cast<uint>(m_Objects.size());
+        CullObject& object = m_Objects.emplace_back();
+        object.m_Sphere = sphere;
+        object.m_IndexCount = level.m_IndexCount;
+        object.m_InstanceCount = instanceCount;
+        object.m_FirstIndex = level.m_FirstIndex;
+        object.m_VertexOffset = static_cast<int>(level.m_FirstVertex);
+        object.m_FirstInstance = firstInstance;
+        return index;
+    }
+
+    glm::vec4 VK_OcclusionCulling::BoundingSphere(glm::mat4 const& transform, glm::vec3 const& center, float radius)
+    {
+        glm::vec3 worldCenter = glm::vec3(transform * glm::vec4(center, 1.0f));
+        float scale = std::max({glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])),
+                                glm::length(glm::vec3(transform[2]))});
+        return glm::vec4(worldCenter, radius * scale);
+    }
+
+    void VK_OcclusionCulling::ComputeBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags dstStage,
+                                             VkAccessFlags dstAccessMask)
+    {
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = dstAccessMask;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, dstStage, 0, 1, &barrier, 0, nullptr, 0,
+                             nullptr);
+    }
+
+    void VK_OcclusionCulling::Cull(VK_FrameInfo const& frameInfo, Phase phase)
+    {
+        ZoneScopedN("VK_OcclusionCulling::Cull");
+        FrameResources& frame = m_Frames[frameInfo.m_FrameIndex];
+        uint numberOfObjects = static_cast<uint>(m_Objects.size());
+        if (phase == PHASE_FIRST)
+        {
+            frame.m_NumberOfObjects = numberOfObjects;
+            if (!numberOfObjects)
+            {
+                return;
+            }
+            Reserve(frame, numberOfObjects);
+            frame.m_Objects->WriteToBuffer(m_Objects.data(), numberOfObjects * sizeof(CullObject), 0);
+            memset(frame.m_Counters->GetMappedMemory(), 0, sizeof(Counters));
+
+            UniformBuffer ubo{};
+            ubo.m_ViewProjection = frameInfo.m_Camera->GetProjectionMatrix() * frameInfo.m_Camera->GetViewMatrix();
+            ubo.m_PreviousViewProjection = m_PreviousViewProjection;
+            ExtractFrustumPlanes(ubo.m_ViewProjection, ubo.m_FrustumPlanes);
+            ubo.m_HiZSize = glm::vec2(m_HiZ->GetExtent().width, m_HiZ->GetExtent().height);
+            ubo.m_HiZLevels = static_cast<int>(m_HiZ->GetMipLevels());
+            ubo.m_HiZValid = m_HiZValid ? 1 : 0;
+            frame.m_UniformBuffer->WriteToBuffer(&ubo);
+        }
+        else if (!frame.m_NumberOfObjects)
+        {
+            return;
+        }
+
+        VkCommandBuffer commandBuffer = frameInfo.m_CommandBuffer;
+        VK_PushConstantDataOcclusionCulling push{numberOfObjects, static_cast<uint>(phase)};
+        m_Pipeline->Bind(commandBuffer);
+        vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                           sizeof(VK_PushConstantDataOcclusionCulling), &push);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1,
+                                &frame.m_DescriptorSet, 0, nullptr);
+        vkCmdDispatch(commandBuffer, (numberOfObjects + OCCLUSION_CULLING_GROUP_SIZE - 1) / OCCLUSION_CULLING_GROUP_SIZE,
+                      1, 1);
+
+        if (phase == PHASE_FIRST)
+        {
+            // the geometry pass draws the commands, the second phase reads the visibility
+            ComputeBarrier(commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                           VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+        }
+        else
+        {
+            // the counters are read back when this frame slot comes around again
+            ComputeBarrier(commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+                           VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_HOST_READ_BIT);
+        }
+    }
+
+    void VK_OcclusionCulling::BuildHiZ(VK_FrameInfo const& frameInfo)
+    {
+        ZoneScopedN("VK_OcclusionCulling::BuildHiZ");
+        m_HiZ->Build(frameInfo.m_CommandBuffer);
+
+        // the next frame's first phase reprojects into this pyramid
+        m_HiZValid = true;
+        m_PreviousViewProjection = frameInfo.m_Camera->GetProjectionMatrix() * frameInfo.m_Camera->GetViewMatrix();
+    }
+
+    void VK_OcclusionCulling::DrawIndirect(VK_FrameInfo const& frameInfo, Phase phase, uint firstObject,
+                                           uint numberOfObjects)
+    {
+        FrameResources& frame = m_Frames[frameInfo.m_FrameIndex];
+        if (!numberOfObjects)
+        {
+            return;
+        }
+        CORE_ASSERT(firstObject + numberOfObjects <= frame.m_NumberOfObjects, "DrawIndirect: object out of range");
+
+        VkDeviceSize offset = (static_cast<VkDeviceSize>(phase) * frame.m_NumberOfObjects + firstObject) *
+                              sizeof(VkDrawIndexedIndirectCommand);
+        vkCmdDrawIndexedIndirect(frameInfo.m_CommandBuffer, frame.m_Commands->GetBuffer(), offset, numberOfObjects,
+                                 sizeof(VkDrawIndexedIndirectCommand));
+
+        if (frameInfo.m_RenderStatistics && (phase == PHASE_FIRST))
+        {
+            for (uint index = firstObject; index < firstObject + numberOfObjects; ++index)
+            {
+                frameInfo.m_RenderStatistics->Draw(m_Objects[index].m_IndexCount, m_Objects[index].m_InstanceCount);
+            }
+        }
+    }
+} // namespace GfxRenderEngine
@@ -0,0 +1,153 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+#include "renderer/model.h"
+#include "renderer/renderStatistics.h"
+
+#include "VKdevice.h"
+#include "VKbuffer.h"
+#include "VKswapChain.h"
+#include "VKframeInfo.h"
+#include "VKdescriptor.h"
+#include "VKrenderPass.h"
+#include "VKcomputePipeline.h"
+
+#include "systems/culling/VKhiZ.h"
+#include "systems/culling/occlusionCulling.h"
+
+namespace GfxRenderEngine
+{
+    struct VK_PushConstantDataOcclusionCulling
+    {
+        uint m_NumberOfObjects;
+        uint m_Phase;
+    };
+
+    // two-phase GPU culling of the geometry pass:
+    // the first phase tests bounding spheres against the frustum and the depth pyramid of the previous frame,
+    // the second phase tests what the first phase rejected by depth against the pyramid of the first phase's depth;
+    // every object gets one indexed indirect command per phase, culled objects draw zero instances
+    class VK_OcclusionCulling
+    {
+
+    public:
+        enum Phase
+        {
+            PHASE_FIRST = OCCLUSION_CULLING_PHASE_FIRST,
+            PHASE_SECOND = OCCLUSION_CULLING_PHASE_SECOND
+        };
+
+        // std430 layout of occlusionCulling.comp
+        struct CullObject
+        {
+            glm::vec4 m_Sphere; // world space center, radius in w
+            uint m_IndexCount;
+            uint m_InstanceCount;
+            uint m_FirstIndex;
+            int m_VertexOffset;
+            uint m_FirstInstance;
+            uint m_Padding[3];
+        };
+
+    public:
+        VK_OcclusionCulling(VK_RenderPass const& renderPass3D);
+        ~VK_OcclusionCulling();
+
+        VK_OcclusionCulling(const VK_OcclusionCulling&) = delete;
+        VK_OcclusionCulling& operator=(const VK_OcclusionCulling&) = delete;
+
+        // reads back the counters of the frame that used this slot before, then starts a new object list
+        void BeginFrame(uint frameIndex, RenderStatistics& statistics);
+
+        // returns the index of the object, its commands are drawn with DrawIndirect()
+        uint AddObject(glm::vec4 const& sphere, Submesh const& submesh, uint firstInstance, uint instanceCount,
+                       uint lod = 0);
+        uint GetNumberOfObjects() const { return static_cast<uint>(m_Objects.size()); }
+
+        // outside of a render pass
+        void Cull(VK_FrameInfo const& frameInfo, Phase phase);
+        void BuildHiZ(VK_FrameInfo const& frameInfo);
+
+        // inside the geometry pass, after the model, descriptor sets and push constants are bound
+        void DrawIndirect(VK_FrameInfo const& frameInfo, Phase phase, uint firstObject, uint numberOfObjects);
+
+        // a sphere around 'center' in the space of 'transform', scaled by its largest axis
+        static glm::vec4 BoundingSphere(glm::mat4 const& transform, glm::vec3 const& center, float radius);
+
+    private:
+        struct UniformBuffer
+        {
+            glm::mat4 m_ViewProjection;
+            glm::mat4 m_PreviousViewProjection;
+            glm::vec4 m_FrustumPlanes[6];
+            glm::vec2 m_HiZSize;
+            int m_HiZLevels;
+            int m_HiZValid;
+        };
+
+        struct Counters
+        {
+            uint m_FrustumCulled;
+            uint m_OcclusionCulledFirstPhase;
+            uint m_VisibleSecondPhase;
+        };
+
+        struct FrameResources
+        {
+            std::unique_ptr<VK_Buffer> m_UniformBuffer;
+            std::unique_ptr<VK_Buffer> m_Objects;
+            std::unique_ptr<VK_Buffer> m_Commands; // first phase, then second phase
+            std::unique_ptr<VK_Buffer> m_Visibility;
+            std::unique_ptr<VK_Buffer> m_Counters;
+            VkDescriptorSet m_DescriptorSet{VK_NULL_HANDLE};
+            uint m_Capacity{0};
+            uint m_NumberOfObjects{0}; // culled in this slot, zero until its counters are valid
+        };
+
+    private:
+        void CreatePipeline();
+        void Reserve(FrameResources& frame, uint numberOfObjects);
+        void ComputeBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags dstStage, VkAccessFlags dstAccessMask);
+
+    private:
+        static constexpr uint MIN_CAPACITY = 1024;
+
+        std::unique_ptr<VK_HiZ> m_HiZ;
+        bool m_HiZValid{false};
+        glm::mat4 m_PreviousViewProjection{1.0f};
+
+        std::vector<CullObject> m_Objects;
+        std::array<FrameResources, VK_SwapChain::MAX_FRAMES_IN_FLIGHT> m_Frames;
+
+        std::unique_ptr<VK_DescriptorSetLayout> m_DescriptorSetLayout;
+        VkPipelineLayout m_PipelineLayout;
+        std::unique_ptr<VK_ComputePipeline> m_Pipeline;
+    };
+} // namespace GfxRenderEngine
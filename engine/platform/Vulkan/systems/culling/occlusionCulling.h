@@ -0,0 +1,6 @@
+// shared by the occlusion culling system and its compute shaders
+
+#define HIZ_TILE_SIZE 8                      // depth pyramid texels per workgroup and dimension
+#define OCCLUSION_CULLING_GROUP_SIZE 64      // bounding spheres per workgroup
+#define OCCLUSION_CULLING_PHASE_FIRST 0      // tests against the depth pyramid of the previous frame
+#define OCCLUSION_CULLING_PHASE_SECOND 1     // tests what the first phase rejected against the new pyramid
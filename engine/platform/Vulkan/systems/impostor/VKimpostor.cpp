@@ -0,0 +1,187 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include "VKcore.h"
+
+#include "systems/impostor/VKimpostor.h"
+
+namespace GfxRenderEngine
+{
+    VK_Impostor::VK_Impostor(VkRenderPass bakeRenderPass, VkImageView bakeDepth,
+                             VK_DescriptorSetLayout& descriptorSetLayout, VkSampler sampler)
+    {
+        auto device = VK_Core::m_Device->Device();
+        for (uint atlas = 0; atlas < NUMBER_OF_ATLASES; ++atlas)
+        {
+            VkImageCreateInfo imageInfo{};
+            imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            imageInfo.imageType = VK_IMAGE_TYPE_2D;
+            imageInfo.extent.width = ATLAS_SIZE;
+            imageInfo.extent.height = ATLAS_SIZE;
+            imageInfo.extent.depth = 1;
+            imageInfo.mipLevels = IMPOSTOR_MIP_LEVELS;
+            imageInfo.arrayLayers = 1;
+            imageInfo.format = FORMATS[atlas];
+            imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+            imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                              VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+            imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+            imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            imageInfo.flags = 0;
+
+            VK_Core::m_Device->CreateImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_Images[atlas],
+                                                   m_ImageMemory[atlas]);
+
+            VkImageViewCreateInfo viewInfo{};
+            viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            viewInfo.image = m_Images[atlas];
+            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewInfo.format = FORMATS[atlas];
+            viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            viewInfo.subresourceRange.baseMipLevel = 0;
+            viewInfo.subresourceRange.levelCount = IMPOSTOR_MIP_LEVELS;
+            viewInfo.subresourceRange.baseArrayLayer = 0;
+            viewInfo.subresourceRange.layerCount = 1;
+            if (vkCreateImageView(device, &viewInfo, nullptr, &m_ImageViews[atlas]) != VK_SUCCESS)
+            {
+                LOG_CORE_CRITICAL("failed to create texture image view!");
+            }
+
+            viewInfo.subresourceRange.levelCount = 1;
+            if (vkCreateImageView(device, &viewInfo, nullptr, &m_BakeViews[atlas]) != VK_SUCCESS)
+            {
+                LOG_CORE_CRITICAL("failed to create texture image view!");
+            }
+        }
+
+        std::array<VkImageView, NUMBER_OF_ATLASES + 1> attachments = {m_BakeViews[ATLAS_ALBEDO],
+                                                                       m_BakeViews[ATLAS_NORMAL_DEPTH], bakeDepth};
+        VkFramebufferCreateInfo framebufferInfo{};
+        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInfo.renderPass = bakeRenderPass;
+        framebufferInfo.attachmentCount = static_cast<uint>(attachments.size());
+        framebufferInfo.pAttachments = attachments.data();
+        framebufferInfo.width = ATLAS_SIZE;
+        framebufferInfo.height = ATLAS_SIZE;
+        framebufferInfo.layers = 1;
+        if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &m_Framebuffer) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to create framebuffer!");
+        }
+
+        VkDescriptorImageInfo albedoInfo{sampler, m_ImageViews[ATLAS_ALBEDO], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        VkDescriptorImageInfo normalDepthInfo{sampler, m_ImageViews[ATLAS_NORMAL_DEPTH],
+                                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        VK_DescriptorWriter(descriptorSetLayout)
+            .WriteImage(0, albedoInfo)
+            .WriteImage(1, normalDepthInfo)
+            .Build(m_DescriptorSet);
+    }
+
+    VK_Impostor::~VK_Impostor()
+    {
+        auto device = VK_Core::m_Device->Device();
+        vkDestroyFramebuffer(device, m_Framebuffer, nullptr);
+        for (uint atlas = 0; atlas < NUMBER_OF_ATLASES; ++atlas)
+        {
+            vkDestroyImageView(device, m_BakeViews[atlas], nullptr);
+            vkDestroyImageView(device, m_ImageViews[atlas], nullptr);
+            vkDestroyImage(device, m_Images[atlas], nullptr);
+            vkFreeMemory(device, m_ImageMemory[atlas], nullptr);
+        }
+    }
+
+    void VK_Impostor::GenerateMipmaps(VkCommandBuffer commandBuffer)
+    {
+        // the frames are square and a power of two, every level halves them exactly
+        // and a texel never straddles two frames
+        std::array<VkImageMemoryBarrier, NUMBER_OF_ATLASES> barriers{};
+        for (uint atlas = 0; atlas < NUMBER_OF_ATLASES; ++atlas)
+        {
+            VkImageMemoryBarrier& barrier = barriers[atlas];
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.image = m_Images[atlas];
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            barrier.subresourceRange.baseMipLevel = 1;
+            barrier.subresourceRange.levelCount = IMPOSTOR_MIP_LEVELS - 1;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount = 1;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        }
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr,
+                             0, nullptr, NUMBER_OF_ATLASES, barriers.data());
+
+        int32_t size = static_cast<int32_t>(ATLAS_SIZE);
+        for (uint level = 1; level < IMPOSTOR_MIP_LEVELS; ++level)
+        {
+            for (uint atlas = 0; atlas < NUMBER_OF_ATLASES; ++atlas)
+            {
+                VkImageBlit blit{};
+                blit.srcOffsets[0] = {0, 0, 0};
+                blit.srcOffsets[1] = {size, size, 1};
+                blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                blit.srcSubresource.mipLevel = level - 1;
+                blit.srcSubresource.baseArrayLayer = 0;
+                blit.srcSubresource.layerCount = 1;
+                blit.dstOffsets[0] = {0, 0, 0};
+                blit.dstOffsets[1] = {size / 2, size / 2, 1};
+                blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                blit.dstSubresource.mipLevel = level;
+                blit.dstSubresource.baseArrayLayer = 0;
+                blit.dstSubresource.layerCount = 1;
+                vkCmdBlitImage(commandBuffer, m_Images[atlas], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_Images[atlas],
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+                // the new level is the source of the next one
+                VkImageMemoryBarrier& barrier = barriers[atlas];
+                barrier.subresourceRange.baseMipLevel = level;
+                barrier.subresourceRange.levelCount = 1;
+                barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+                barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            }
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                                 nullptr, 0, nullptr, NUMBER_OF_ATLASES, barriers.data());
+            size /= 2;
+        }
+
+        for (uint atlas = 0; atlas < NUMBER_OF_ATLASES; ++atlas)
+        {
+            VkImageMemoryBarrier& barrier = barriers[atlas];
+            barrier.subresourceRange.baseMipLevel = 0;
+            barrier.subresourceRange.levelCount = IMPOSTOR_MIP_LEVELS;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        }
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0,
+                             nullptr, 0, nullptr, NUMBER_OF_ATLASES, barriers.data());
+    }
+} // namespace GfxRenderEngine
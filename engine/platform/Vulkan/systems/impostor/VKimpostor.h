@@ -0,0 +1,77 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <array>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+
+#include "VKdescriptor.h"
+
+#include "systems/impostor/impostor.h"
+
+namespace GfxRenderEngine
+{
+    // Views of one model baked into two atlases, see VK_RenderSystemImpostor.
+    // Albedo with the coverage in alpha, model space normals with the depth along the view in alpha.
+    // Both atlases are premultiplied by the coverage, texels outside of the model are zero.
+    class VK_Impostor
+    {
+
+    public:
+        enum Atlas
+        {
+            ATLAS_ALBEDO = 0,
+            ATLAS_NORMAL_DEPTH,
+            NUMBER_OF_ATLASES
+        };
+
+        static constexpr uint ATLAS_SIZE = IMPOSTOR_FRAMES * IMPOSTOR_FRAME_SIZE;
+        static constexpr VkFormat FORMATS[NUMBER_OF_ATLASES] = {VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_R16G16B16A16_SFLOAT};
+
+    public:
+        // bakeDepth: the depth attachment of the bake render pass, shared by all impostors
+        VK_Impostor(VkRenderPass bakeRenderPass, VkImageView bakeDepth, VK_DescriptorSetLayout& descriptorSetLayout,
+                    VkSampler sampler);
+        ~VK_Impostor();
+
+        VK_Impostor(const VK_Impostor&) = delete;
+        VK_Impostor& operator=(const VK_Impostor&) = delete;
+
+        // the bake render pass leaves level 0 in TRANSFER_SRC_OPTIMAL,
+        // this blits the remaining levels and transitions all of them to SHADER_READ_ONLY_OPTIMAL
+        void GenerateMipmaps(VkCommandBuffer commandBuffer);
+
+        VkFramebuffer GetFramebuffer() const { return m_Framebuffer; }
+        VkDescriptorSet const& GetDescriptorSet() const { return m_DescriptorSet; }
+
+    private:
+        std::array<VkImage, NUMBER_OF_ATLASES> m_Images{};
+        std::array<VkDeviceMemory, NUMBER_OF_ATLASES> m_ImageMemory{};
+        std::array<VkImageView, NUMBER_OF_ATLASES> m_ImageViews{}; // all levels, sampled
+        std::array<VkImageView, NUMBER_OF_ATLASES> m_BakeViews{};  // level 0, render targets of the bake
+        VkFramebuffer m_Framebuffer{VK_NULL_HANDLE};
+        VkDescriptorSet m_DescriptorSet{VK_NULL_HANDLE};
+    };
+} // namespace GfxRenderEngine
@@ -0,0 +1,554 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <algorithm>
+
+#include "coreSettings.h"
+
+#include "VKcore.h"
+#include "VKrenderPass.h"
+#include "VKmodel.h"
+#include "VKinstanceBuffer.h"
+
+#include "systems/impostor/VKimpostorSys.h"
+
+namespace GfxRenderEngine
+{
+    namespace
+    {
+        float MaxScale(glm::mat4 const& modelMatrix)
+        {
+            return std::max({glm::length(glm::vec3(modelMatrix[0])), glm::length(glm::vec3(modelMatrix[1])),
+                             glm::length(glm::vec3(modelMatrix[2]))});
+        }
+
+        uint NextPowerOfTwo(uint value)
+        {
+            uint powerOfTwo = 1;
+            while (powerOfTwo < value)
+            {
+                powerOfTwo <<= 1;
+            }
+            return powerOfTwo;
+        }
+
+        constexpr uint MIN_CAPACITY = 256;  // instances per frame slot
+        constexpr uint VERTICES_PER_QUAD = 6; // two triangles, generated in impostor.vert
+    } // namespace
+
+    VK_RenderSystemImpostor::VK_RenderSystemImpostor(VkRenderPass renderPass3D,
+                                                     VK_DescriptorSetLayout& globalDescriptorSetLayout,
+                                                     VK_DescriptorSetLayout& materialDescriptorSetLayout)
+    {
+        CreateBakeRenderPass();
+        CreateBakeDepth();
+        CreateSampler();
+        CreateBakePipeline(materialDescriptorSetLayout);
+        CreatePipeline(renderPass3D, globalDescriptorSetLayout);
+
+        for (auto& frame : m_Frames)
+        {
+            Reserve(frame, MIN_CAPACITY);
+        }
+    }
+
+    VK_RenderSystemImpostor::~VK_RenderSystemImpostor()
+    {
+        auto device = VK_Core::m_Device->Device();
+        vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+        vkDestroyPipelineLayout(device, m_BakePipelineLayout, nullptr);
+        vkDestroySampler(device, m_Sampler, nullptr);
+        vkDestroyImageView(device, m_BakeDepthImageView, nullptr);
+        vkDestroyImage(device, m_BakeDepthImage, nullptr);
+        vkFreeMemory(device, m_BakeDepthImageMemory, nullptr);
+        vkDestroyRenderPass(device, m_BakeRenderPass, nullptr);
+    }
+
+    void VK_RenderSystemImpostor::CreateBakeRenderPass()
+    {
+        std::array<VkAttachmentDescription, VK_Impostor::NUMBER_OF_ATLASES + 1> attachments{};
+        std::array<VkAttachmentReference, VK_Impostor::NUMBER_OF_ATLASES> colorAttachmentRefs{};
+        for (uint atlas = 0; atlas < VK_Impostor::NUMBER_OF_ATLASES; ++atlas)
+        {
+            // level 0 is the source of the mip chain
+            VkAttachmentDescription& attachment = attachments[atlas];
+            attachment.format = VK_Impostor::FORMATS[atlas];
+            attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+            attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+            attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            attachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+            colorAttachmentRefs[atlas] = {atlas, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+        }
+
+        VkAttachmentDescription& depthAttachment = attachments[VK_Impostor::NUMBER_OF_ATLASES];
+        depthAttachment.format = VK_Core::m_Device->FindDepthFormat();
+        depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        VkAttachmentReference depthAttachmentRef{VK_Impostor::NUMBER_OF_ATLASES,
+                                                 VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+
+        VkSubpassDescription subpass{};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = static_cast<uint>(colorAttachmentRefs.size());
+        subpass.pColorAttachments = colorAttachmentRefs.data();
+        subpass.pDepthStencilAttachment = &depthAttachmentRef;
+
+        std::array<VkSubpassDependency, 2> dependencies{};
+        // the depth buffer is shared with the bake of an earlier frame
+        dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[0].dstSubpass = 0;
+        dependencies[0].srcStageMask =
+            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependencies[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                       VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+                                       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependencies[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependencies[0].dstAccessMask =
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        // VK_Impostor::GenerateMipmaps() reads level 0
+        dependencies[1].srcSubpass = 0;
+        dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        VkRenderPassCreateInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderPassInfo.attachmentCount = static_cast<uint>(attachments.size());
+        renderPassInfo.pAttachments = attachments.data();
+        renderPassInfo.subpassCount = 1;
+        renderPassInfo.pSubpasses = &subpass;
+        renderPassInfo.dependencyCount = static_cast<uint>(dependencies.size());
+        renderPassInfo.pDependencies = dependencies.data();
+        if (vkCreateRenderPass(VK_Core::m_Device->Device(), &renderPassInfo, nullptr, &m_BakeRenderPass) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to create render pass!");
+        }
+    }
+
+    void VK_RenderSystemImpostor::CreateBakeDepth()
+    {
+        VkFormat depthFormat = VK_Core::m_Device->FindDepthFormat();
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent.width = VK_Impostor::ATLAS_SIZE;
+        imageInfo.extent.height = VK_Impostor::ATLAS_SIZE;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = depthFormat;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.flags = 0;
+
+        VK_Core::m_Device->CreateImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_BakeDepthImage,
+                                               m_BakeDepthImageMemory);
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = m_BakeDepthImage;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = depthFormat;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+        if (vkCreateImageView(VK_Core::m_Device->Device(), &viewInfo, nullptr, &m_BakeDepthImageView) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to create texture image view!");
+        }
+    }
+
+    void VK_RenderSystemImpostor::CreateSampler()
+    {
+        // clamped, impostor.frag keeps the coordinates inside of a frame
+        VkSamplerCreateInfo samplerCreateInfo{};
+        samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerCreateInfo.magFilter = VK_FILTER_LINEAR;
+        samplerCreateInfo.minFilter = VK_FILTER_LINEAR;
+        samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        samplerCreateInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerCreateInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerCreateInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerCreateInfo.anisotropyEnable = VK_FALSE;
+        samplerCreateInfo.compareOp = VK_COMPARE_OP_NEVER;
+        samplerCreateInfo.minLod = 0.0f;
+        samplerCreateInfo.maxLod = static_cast<float>(IMPOSTOR_MIP_LEVELS);
+        samplerCreateInfo.unnormalizedCoordinates = VK_FALSE;
+        if (vkCreateSampler(VK_Core::m_Device->Device(), &samplerCreateInfo, nullptr, &m_Sampler) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to create sampler!");
+        }
+
+        m_AtlasDescriptorSetLayout =
+            VK_DescriptorSetLayout::Builder()
+                .AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
+                .AddBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
+                .Build();
+        m_InstanceDescriptorSetLayout = VK_DescriptorSetLayout::Builder()
+                                            .AddBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT)
+                                            .Build();
+    }
+
+    void VK_RenderSystemImpostor::CreateBakePipeline(VK_DescriptorSetLayout& materialDescriptorSetLayout)
+    {
+        VkDescriptorSetLayout descriptorSetLayout = materialDescriptorSetLayout.GetDescriptorSetLayout();
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(VK_PushConstantDataImpostorBake);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+        if (vkCreatePipelineLayout(VK_Core::m_Device->Device(), &pipelineLayoutInfo, nullptr, &m_BakePipelineLayout) !=
+            VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to create pipeline layout!");
+        }
+
+        PipelineConfigInfo pipelineConfig{};
+        VK_Pipeline::DefaultPipelineConfigInfo(pipelineConfig);
+        pipelineConfig.renderPass = m_BakeRenderPass;
+        pipelineConfig.pipelineLayout = m_BakePipelineLayout;
+        pipelineConfig.subpass = 0;
+
+        // albedo, normal and depth, no blending
+        pipelineConfig.colorBlendAttachment.blendEnable = VK_FALSE;
+        std::array<VkPipelineColorBlendAttachmentState, VK_Impostor::NUMBER_OF_ATLASES> blAttachments;
+        blAttachments.fill(pipelineConfig.colorBlendAttachment);
+        VK_Pipeline::SetColorBlendState(pipelineConfig, VK_Impostor::NUMBER_OF_ATLASES, blAttachments.data());
+
+        m_BakePipeline = std::make_unique<VK_Pipeline>(VK_Core::m_Device, "bin-int/impostorBake.vert.spv",
+                                                       "bin-int/impostorBake.frag.spv", pipelineConfig);
+    }
+
+    void VK_RenderSystemImpostor::CreatePipeline(VkRenderPass renderPass3D,
+                                                 VK_DescriptorSetLayout& globalDescriptorSetLayout)
+    {
+        std::array<VkDescriptorSetLayout, 3> descriptorSetLayouts = {
+            globalDescriptorSetLayout.GetDescriptorSetLayout(), m_AtlasDescriptorSetLayout->GetDescriptorSetLayout(),
+            m_InstanceDescriptorSetLayout->GetDescriptorSetLayout()};
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(VK_PushConstantDataImpostor);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = static_cast<uint>(descriptorSetLayouts.size());
+        pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+        if (vkCreatePipelineLayout(VK_Core::m_Device->Device(), &pipelineLayoutInfo, nullptr, &m_PipelineLayout) !=
+            VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to create pipeline layout!");
+        }
+
+        PipelineConfigInfo pipelineConfig{};
+        VK_Pipeline::DefaultPipelineConfigInfo(pipelineConfig);
+        pipelineConfig.renderPass = renderPass3D;
+        pipelineConfig.pipelineLayout = m_PipelineLayout;
+        pipelineConfig.subpass = static_cast<uint>(VK_RenderPass::SubPasses3D::SUBPASS_GEOMETRY);
+        pipelineConfig.m_BindingDescriptions.clear(); // the quads are generated from gl_VertexIndex
+        pipelineConfig.m_AttributeDescriptions.clear();
+
+        // g buffer position, g buffer normal, g buffer color, g buffer material, g buffer emission
+        // no blending
+        auto attachmentCount = (int)VK_RenderPass::NUMBER_OF_GBUFFER_ATTACHMENTS;
+        pipelineConfig.colorBlendAttachment.blendEnable = VK_FALSE;
+
+        std::array<VkPipelineColorBlendAttachmentState,
+                   static_cast<uint>(VK_RenderPass::RenderTargets3D::NUMBER_OF_ATTACHMENTS)>
+            blAttachments;
+        for (uint i = 0; i < static_cast<uint>(VK_RenderPass::RenderTargets3D::NUMBER_OF_ATTACHMENTS); ++i)
+        {
+            blAttachments[i] = pipelineConfig.colorBlendAttachment;
+        }
+        VK_Pipeline::SetColorBlendState(pipelineConfig, attachmentCount, blAttachments.data());
+
+        m_Pipeline = std::make_unique<VK_Pipeline>(VK_Core::m_Device, "bin-int/impostor.vert.spv",
+                                                   "bin-int/impostor.frag.spv", pipelineConfig);
+    }
+
+    // the buffer of a frame slot grows in powers of two, the slot is idle while its frame is recorded
+    void VK_RenderSystemImpostor::Reserve(FrameResources& frame, uint numberOfInstances)
+    {
+        if (numberOfInstances <= frame.m_Capacity)
+        {
+            return;
+        }
+        frame.m_Capacity = std::max(NextPowerOfTwo(numberOfInstances), MIN_CAPACITY);
+
+        frame.m_Instances = std::make_unique<VK_Buffer>(
+            sizeof(InstanceData), frame.m_Capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        frame.m_Instances->Map();
+
+        VkDescriptorBufferInfo instancesInfo = frame.m_Instances->DescriptorInfo();
+        VK_DescriptorWriter writer(*m_InstanceDescriptorSetLayout);
+        writer.WriteBuffer(0, instancesInfo);
+        if (frame.m_DescriptorSet == VK_NULL_HANDLE)
+        {
+            writer.Build(frame.m_DescriptorSet);
+        }
+        else
+        {
+            writer.Overwrite(frame.m_DescriptorSet);
+        }
+    }
+
+    glm::vec2 VK_RenderSystemImpostor::GetFadeDistances()
+    {
+        float distance = static_cast<float>(std::max(CoreSettings::m_ImpostorDistance, 1));
+        return {distance, distance * (1.0f + IMPOSTOR_FADE_BAND)};
+    }
+
+    uint VK_RenderSystemImpostor::SelectMeshes(const VK_FrameInfo& frameInfo, VK_Model const& model,
+                                               InstanceBuffer& instanceBuffer, uint instanceCount,
+                                               std::vector<MeshState>& meshStates)
+    {
+        // the dithering is per pixel, an instance takes part in the crossfade if its bounding sphere does
+        glm::vec2 fade = GetFadeDistances();
+        glm::vec3 cameraPosition = frameInfo.m_Camera->GetPosition();
+        uint impostorsOnly = 0;
+        meshStates.resize(instanceCount);
+        for (uint index = 0; index < instanceCount; ++index)
+        {
+            glm::mat4 const& modelMatrix = instanceBuffer.GetModelMatrix(index);
+            float radius = model.GetBoundingRadius() * MaxScale(modelMatrix);
+            float distance = glm::length(glm::vec3(modelMatrix[3]) - cameraPosition);
+            if (distance - radius >= fade.y)
+            {
+                meshStates[index] = MESH_NONE;
+                ++impostorsOnly;
+            }
+            else
+            {
+                meshStates[index] = (distance + radius > fade.x) ? MESH_FADE : MESH_OPAQUE;
+            }
+        }
+        return impostorsOnly;
+    }
+
+    void VK_RenderSystemImpostor::Bake(const VK_FrameInfo& frameInfo, Registry& registry)
+    {
+        if (!CoreSettings::m_Impostors)
+        {
+            return;
+        }
+
+        auto view = registry.Get().view<MeshComponent, TransformComponent, PbrMaterialTag, InstanceTag>(
+            entt::exclude<SkeletalAnimationTag, GrassTag>);
+        for (auto mainInstance : view)
+        {
+            auto& mesh = view.get<MeshComponent>(mainInstance);
+            VK_Model* model = static_cast<VK_Model*>(mesh.m_Model.get());
+            InstanceTag& instanced = view.get<InstanceTag>(mainInstance);
+            bool eligible = mesh.m_Enabled && (instanced.m_Instances.size() >= MIN_INSTANCES) &&
+                            !model->GetSubmeshesPbr().empty() && (model->GetBoundingRadius() > 0.0f);
+            if (eligible && !model->GetImpostor())
+            {
+                // one bake per frame keeps the hitch of loading a forest small
+                Bake(frameInfo, *model);
+                ++m_BakedModels;
+                break;
+            }
+        }
+
+        if (frameInfo.m_RenderStatistics)
+        {
+            frameInfo.m_RenderStatistics->m_ImpostorModels = m_BakedModels;
+        }
+    }
+
+    void VK_RenderSystemImpostor::Bake(const VK_FrameInfo& frameInfo, VK_Model& model)
+    {
+        ZoneScopedN("VK_RenderSystemImpostor::Bake");
+        auto impostor =
+            std::make_unique<VK_Impostor>(m_BakeRenderPass, m_BakeDepthImageView, *m_AtlasDescriptorSetLayout, m_Sampler);
+        VkCommandBuffer commandBuffer = frameInfo.m_CommandBuffer;
+
+        std::array<VkClearValue, VK_Impostor::NUMBER_OF_ATLASES + 1> clearValues{};
+        clearValues[VK_Impostor::ATLAS_ALBEDO].color = {{0.0f, 0.0f, 0.0f, 0.0f}};
+        clearValues[VK_Impostor::ATLAS_NORMAL_DEPTH].color = {{0.0f, 0.0f, 0.0f, 0.0f}};
+        clearValues[VK_Impostor::NUMBER_OF_ATLASES].depthStencil = {1.0f, 0};
+
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = m_BakeRenderPass;
+        renderPassInfo.framebuffer = impostor->GetFramebuffer();
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = {VK_Impostor::ATLAS_SIZE, VK_Impostor::ATLAS_SIZE};
+        renderPassInfo.clearValueCount = static_cast<uint>(clearValues.size());
+        renderPassInfo.pClearValues = clearValues.data();
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+        m_BakePipeline->Bind(commandBuffer);
+        model.Bind(commandBuffer);
+
+        VK_PushConstantDataImpostorBake push{};
+        push.m_Radius = model.GetBoundingRadius();
+        for (auto& submesh : model.GetSubmeshesPbr())
+        {
+            Material::PbrMaterial const& pbrMaterial = submesh.m_Material.m_PbrMaterial;
+            push.m_DiffuseColor = pbrMaterial.m_DiffuseColor;
+            push.m_Features = static_cast<int>(pbrMaterial.m_Features);
+            push.m_NormalMapIntensity = pbrMaterial.m_NormalMapIntensity;
+
+            VkDescriptorSet const& materialDescriptorSet = submesh.m_MaterialDescriptor.GetDescriptorSet();
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_BakePipelineLayout, 0, 1,
+                                    &materialDescriptorSet, 0, nullptr);
+
+            // one viewport per frame of the atlas
+            for (int frame = 0; frame < IMPOSTOR_FRAMES * IMPOSTOR_FRAMES; ++frame)
+            {
+                int x = (frame % IMPOSTOR_FRAMES) * IMPOSTOR_FRAME_SIZE;
+                int y = (frame / IMPOSTOR_FRAMES) * IMPOSTOR_FRAME_SIZE;
+                VkViewport viewport{static_cast<float>(x), static_cast<float>(y), IMPOSTOR_FRAME_SIZE, IMPOSTOR_FRAME_SIZE,
+                                    0.0f, 1.0f};
+                VkRect2D scissor{{x, y}, {IMPOSTOR_FRAME_SIZE, IMPOSTOR_FRAME_SIZE}};
+                vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+                vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+                push.m_Frame = frame;
+                vkCmdPushConstants(commandBuffer, m_BakePipelineLayout,
+                                   VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                                   sizeof(VK_PushConstantDataImpostorBake), &push);
+                model.DrawSubmesh(frameInfo, submesh, 0, 1);
+            }
+        }
+
+        vkCmdEndRenderPass(commandBuffer);
+        impostor->GenerateMipmaps(commandBuffer);
+        model.SetImpostor(std::move(impostor));
+    }
+
+    void VK_RenderSystemImpostor::RenderEntities(const VK_FrameInfo& frameInfo, Registry& registry)
+    {
+        if (!CoreSettings::m_Impostors)
+        {
+            return;
+        }
+
+        // models that had no impostor instances in the last frame are dropped, they may have been unloaded
+        std::erase_if(m_Batches, [](auto const& batch) { return batch.second.empty(); });
+        for (auto& [model, instances] : m_Batches)
+        {
+            instances.clear();
+        }
+
+        // instances in or behind the crossfade, see SelectMeshes()
+        glm::vec2 fade = GetFadeDistances();
+        glm::vec3 cameraPosition = frameInfo.m_Camera->GetPosition();
+        auto view = registry.Get().view<MeshComponent, TransformComponent, PbrMaterialTag, InstanceTag>(
+            entt::exclude<SkeletalAnimationTag, GrassTag>);
+        for (auto mainInstance : view)
+        {
+            auto& mesh = view.get<MeshComponent>(mainInstance);
+            VK_Model* model = static_cast<VK_Model*>(mesh.m_Model.get());
+            if (!mesh.m_Enabled || !model->GetImpostor())
+            {
+                continue;
+            }
+            InstanceTag& instanced = view.get<InstanceTag>(mainInstance);
+            std::vector<InstanceData>& batch = m_Batches[model];
+            uint instanceCount = static_cast<uint>(instanced.m_Instances.size());
+            for (uint index = 0; index < instanceCount; ++index)
+            {
+                glm::mat4 const& modelMatrix = instanced.m_InstanceBuffer->GetModelMatrix(index);
+                float radius = model->GetBoundingRadius() * MaxScale(modelMatrix);
+                float distance = glm::length(glm::vec3(modelMatrix[3]) - cameraPosition);
+                if (distance + radius > fade.x)
+                {
+                    glm::mat4 rows = glm::transpose(modelMatrix);
+                    batch.push_back({{rows[0], rows[1], rows[2]}});
+                }
+            }
+        }
+
+        m_Instances.clear();
+        for (auto& [model, instances] : m_Batches)
+        {
+            m_Instances.insert(m_Instances.end(), instances.begin(), instances.end());
+        }
+        if (m_Instances.empty())
+        {
+            return;
+        }
+
+        FrameResources& frame = m_Frames[frameInfo.m_FrameIndex];
+        Reserve(frame, static_cast<uint>(m_Instances.size()));
+        frame.m_Instances->WriteToBuffer(m_Instances.data(), m_Instances.size() * sizeof(InstanceData), 0);
+
+        VkCommandBuffer commandBuffer = frameInfo.m_CommandBuffer;
+        m_Pipeline->Bind(commandBuffer);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 0, 1,
+                                &frameInfo.m_GlobalDescriptorSet, 0, nullptr);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 2, 1,
+                                &frame.m_DescriptorSet, 0, nullptr);
+
+        // one draw per model, the instances of a model are consecutive in the buffer
+        uint firstInstance = 0;
+        for (auto& [model, instances] : m_Batches)
+        {
+            if (instances.empty())
+            {
+                continue;
+            }
+            uint instanceCount = static_cast<uint>(instances.size());
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 1, 1,
+                                    &model->GetImpostor()->GetDescriptorSet(), 0, nullptr);
+            VK_PushConstantDataImpostor push{};
+            push.m_Radius = model->GetBoundingRadius();
+            vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0,
+                               sizeof(VK_PushConstantDataImpostor), &push);
+            vkCmdDraw(commandBuffer, VERTICES_PER_QUAD, instanceCount, 0, firstInstance);
+            if (frameInfo.m_RenderStatistics)
+            {
+                frameInfo.m_RenderStatistics->Draw(VERTICES_PER_QUAD, instanceCount);
+            }
+            firstInstance += instanceCount;
+        }
+    }
+} // namespace GfxRenderEngine
@@ -0,0 +1,150 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+#include "scene/scene.h"
+
+#include "VKdevice.h"
+#include "VKpipeline.h"
+#include "VKframeInfo.h"
+#include "VKdescriptor.h"
+#include "VKbuffer.h"
+#include "VKswapChain.h"
+
+#include "systems/impostor/VKimpostor.h"
+
+namespace GfxRenderEngine
+{
+    class VK_Model;
+    class InstanceBuffer;
+
+    struct VK_PushConstantDataImpostorBake
+    {
+        glm::vec4 m_DiffuseColor{1.0f};
+        int m_Features{0}; // only the diffuse and the normal map are baked
+        float m_NormalMapIntensity{1.0f};
+        float m_Radius{1.0f}; // bounding radius of the model
+        int m_Frame{0};       // y * IMPOSTOR_FRAMES + x
+    };
+
+    struct VK_PushConstantDataImpostor
+    {
+        float m_Radius{1.0f}; // bounding radius of the model
+        float m_Spare0{0.0f}; // padding
+        float m_Spare1{0.0f}; // padding
+        float m_Spare2{0.0f}; // padding
+    };
+
+    // Octahedral impostors for distant instances of instanced models.
+    // Each model of an instance group with at least MIN_INSTANCES instances is baked once, on the frame it is
+    // first rendered: IMPOSTOR_FRAMES x IMPOSTOR_FRAMES orthographic views from a hemi-octahedral grid of directions
+    // (vegetation is seen from above) into an albedo and a normal-depth atlas, see VK_Impostor.
+    // Beyond CoreSettings::m_ImpostorDistance an instance is drawn as a camera-facing quad that blends the three
+    // views closest to its view direction and writes the g buffer, so the lighting pass shades it like the mesh.
+    // In a band of IMPOSTOR_FADE_BAND * m_ImpostorDistance the mesh dithers out where the impostor dithers in,
+    // per pixel and by the same pattern, so both cover every pixel exactly once.
+    // All impostor instances of a model, from all of its instance groups, are one draw.
+    class VK_RenderSystemImpostor
+    {
+
+    public:
+        enum MeshState
+        {
+            MESH_OPAQUE = 0, // in front of the crossfade
+            MESH_FADE,       // overlaps the crossfade, dithered
+            MESH_NONE        // behind the crossfade, impostor only
+        };
+
+        static constexpr uint MIN_INSTANCES = 16;
+
+    public:
+        VK_RenderSystemImpostor(VkRenderPass renderPass3D, VK_DescriptorSetLayout& globalDescriptorSetLayout,
+                                VK_DescriptorSetLayout& materialDescriptorSetLayout);
+        ~VK_RenderSystemImpostor();
+
+        VK_RenderSystemImpostor(const VK_RenderSystemImpostor&) = delete;
+        VK_RenderSystemImpostor& operator=(const VK_RenderSystemImpostor&) = delete;
+
+        // bakes one model per frame, to be recorded outside of a render pass
+        void Bake(const VK_FrameInfo& frameInfo, Registry& registry);
+        void RenderEntities(const VK_FrameInfo& frameInfo, Registry& registry);
+
+        // distances from the camera where the crossfade begins and ends
+        static glm::vec2 GetFadeDistances();
+        // which instances the pbr system draws as a mesh and how, returns the number of MESH_NONE instances
+        static uint SelectMeshes(const VK_FrameInfo& frameInfo, VK_Model const& model, InstanceBuffer& instanceBuffer,
+                                 uint instanceCount, std::vector<MeshState>& meshStates);
+
+    private:
+        struct InstanceData
+        {
+            glm::vec4 m_ModelMatrix[3]; // rows of a 3x4 model matrix, see VK_InstanceBuffer
+        };
+
+        struct FrameResources
+        {
+            std::unique_ptr<VK_Buffer> m_Instances; // host visible storage buffer
+            uint m_Capacity{0};
+            VkDescriptorSet m_DescriptorSet{VK_NULL_HANDLE};
+        };
+
+    private:
+        void CreateBakeRenderPass();
+        void CreateBakeDepth();
+        void CreateSampler();
+        void CreateBakePipeline(VK_DescriptorSetLayout& materialDescriptorSetLayout);
+        void CreatePipeline(VkRenderPass renderPass3D, VK_DescriptorSetLayout& globalDescriptorSetLayout);
+
+        void Bake(const VK_FrameInfo& frameInfo, VK_Model& model);
+        void Reserve(FrameResources& frame, uint numberOfInstances);
+
+    private:
+        // bake
+        VkRenderPass m_BakeRenderPass;
+        VkImage m_BakeDepthImage;
+        VkDeviceMemory m_BakeDepthImageMemory;
+        VkImageView m_BakeDepthImageView;
+        VkPipelineLayout m_BakePipelineLayout;
+        std::unique_ptr<VK_Pipeline> m_BakePipeline;
+        uint m_BakedModels{0};
+
+        // render
+        VkSampler m_Sampler;
+        std::unique_ptr<VK_DescriptorSetLayout> m_AtlasDescriptorSetLayout;
+        std::unique_ptr<VK_DescriptorSetLayout> m_InstanceDescriptorSetLayout;
+        VkPipelineLayout m_PipelineLayout;
+        std::unique_ptr<VK_Pipeline> m_Pipeline;
+        std::array<FrameResources, VK_SwapChain::MAX_FRAMES_IN_FLIGHT> m_Frames;
+
+        // impostor instances per model, collected from all instance groups; the vectors keep their capacity
+        std::unordered_map<VK_Model*, std::vector<InstanceData>> m_Batches;
+        std::vector<InstanceData> m_Instances; // all batches, in draw order
+    };
+} // namespace GfxRenderEngine
@@ -0,0 +1,7 @@
+// shared by the impostor render system, its shaders and the pbr shaders
+
+#define IMPOSTOR_FRAMES 8            // views per dimension of the hemi-octahedral atlas
+#define IMPOSTOR_FRAME_SIZE 256      // texels per view and dimension
+#define IMPOSTOR_MIP_LEVELS 4        // frames shrink to 32 texels in the last level
+#define IMPOSTOR_FADE_BAND 0.1       // crossfade width as a fraction of CoreSettings::m_ImpostorDistance
+#define GLSL_IMPOSTOR_FADE (0x1 << 0x10) // pbr pipeline permutation that dithers the mesh out in the crossfade
@@ -0,0 +1,147 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <cstddef>
+
+#include "VKcore.h"
+#include "VKmodel.h"
+
+#include "systems/skinning/VKskinning.h"
+
+namespace GfxRenderEngine
+{
+    static_assert(sizeof(Vertex) == SKINNING_VERTEX_STRIDE * sizeof(float), "skinning.h out of sync with Vertex");
+    static_assert(offsetof(Vertex, m_Position) == SKINNING_OFFSET_POSITION * sizeof(float));
+    static_assert(offsetof(Vertex, m_Normal) == SKINNING_OFFSET_NORMAL * sizeof(float));
+    static_assert(offsetof(Vertex, m_Tangent) == SKINNING_OFFSET_TANGENT * sizeof(float));
+    static_assert(offsetof(Vertex, m_JointIds) == SKINNING_OFFSET_JOINT_IDS * sizeof(float));
+    static_assert(offsetof(Vertex, m_Weights) == SKINNING_OFFSET_WEIGHTS * sizeof(float));
+
+    VK_Skinning::VK_Skinning()
+    {
+        m_DescriptorSetLayout = VK_DescriptorSetLayout::Builder()
+                                    .AddBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+                                    .AddBinding(1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+                                    .AddBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+                                    .Build();
+        CreatePipeline();
+    }
+
+    VK_Skinning::~VK_Skinning() { vkDestroyPipelineLayout(VK_Core::m_Device->Device(), m_PipelineLayout, nullptr); }
+
+    void VK_Skinning::CreatePipeline()
+    {
+        VkDescriptorSetLayout descriptorSetLayout = m_DescriptorSetLayout->GetDescriptorSetLayout();
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(VK_PushConstantDataSkinning);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+        if (vkCreatePipelineLayout(VK_Core::m_Device->Device(), &pipelineLayoutInfo, nullptr, &m_PipelineLayout) !=
+            VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to create pipeline layout!");
+        }
+
+        m_Pipeline = std::make_unique<VK_ComputePipeline>(VK_Core::m_Device, "bin-int/skinning.comp.spv", m_PipelineLayout);
+    }
+
+    void VK_Skinning::Skin(VK_FrameInfo const& frameInfo, Registry& registry)
+    {
+        ZoneScopedN("VK_Skinning::Skin");
+        VkCommandBuffer commandBuffer = frameInfo.m_CommandBuffer;
+        uint skinnedModels = 0;
+        uint skinnedVertices = 0;
+        uint skipped = 0;
+
+        auto view = registry.view<MeshComponent, SkeletalAnimationTag>();
+        for (auto entity : view)
+        {
+            auto& mesh = view.get<MeshComponent>(entity);
+            VK_Model* model = static_cast<VK_Model*>(mesh.m_Model.get());
+            if (!mesh.m_Enabled || !model->IsSkinned())
+            {
+                continue;
+            }
+
+            // the buffer of this frame slot was last read MAX_FRAMES_IN_FLIGHT frames ago
+            model->SetSkinnedFrame(frameInfo.m_FrameIndex);
+            VK_Model::SkinnedVertices& target = model->GetSkinnedVertices(frameInfo.m_FrameIndex);
+            if (target.m_Pose == model->GetPose())
+            {
+                ++skipped;
+                continue;
+            }
+            target.m_Pose = model->GetPose();
+
+            if (!target.m_DescriptorSet)
+            {
+                VkDescriptorBufferInfo bindPoseInfo = model->GetBindPose().DescriptorInfo();
+                VkDescriptorBufferInfo jointsInfo = model->GetJointsBuffer().DescriptorInfo();
+                VkDescriptorBufferInfo skinnedInfo = target.m_Buffer->DescriptorInfo();
+                VK_DescriptorWriter(*m_DescriptorSetLayout)
+                    .WriteBuffer(0, bindPoseInfo)
+                    .WriteBuffer(1, jointsInfo)
+                    .WriteBuffer(2, skinnedInfo)
+                    .Build(target.m_DescriptorSet);
+            }
+
+            if (!skinnedModels)
+            {
+                m_Pipeline->Bind(commandBuffer);
+            }
+            uint vertexCount = model->GetVertexCount();
+            VK_PushConstantDataSkinning push{vertexCount, 0, 0, 0};
+            vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                               sizeof(VK_PushConstantDataSkinning), &push);
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1,
+                                    &target.m_DescriptorSet, 0, nullptr);
+            vkCmdDispatch(commandBuffer, (vertexCount + SKINNING_GROUP_SIZE - 1) / SKINNING_GROUP_SIZE, 1, 1);
+            ++skinnedModels;
+            skinnedVertices += vertexCount;
+        }
+
+        if (skinnedModels)
+        {
+            // the shadow and geometry passes fetch the skinned vertices
+            VkMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                                 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        }
+
+        if (frameInfo.m_RenderStatistics)
+        {
+            frameInfo.m_RenderStatistics->m_SkinnedModels += skinnedModels;
+            frameInfo.m_RenderStatistics->m_SkinnedVertices += skinnedVertices;
+            frameInfo.m_RenderStatistics->m_SkinningSkipped += skipped;
+        }
+    }
+} // namespace GfxRenderEngine
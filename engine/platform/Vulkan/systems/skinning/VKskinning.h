@@ -0,0 +1,73 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <memory>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+#include "scene/scene.h"
+
+#include "VKdevice.h"
+#include "VKframeInfo.h"
+#include "VKdescriptor.h"
+#include "VKcomputePipeline.h"
+
+#include "systems/skinning/skinning.h"
+
+namespace GfxRenderEngine
+{
+    struct VK_PushConstantDataSkinning
+    {
+        uint m_VertexCount;
+        uint m_Spare0; // padding
+        uint m_Spare1;
+        uint m_Spare2;
+    };
+
+    // compute skinning of skeletal animations, once per frame and animated model,
+    // into the skinned vertex buffers of VK_Model; the shadow cascades and the geometry pass
+    // draw the result with the static pipelines; a frame slot whose buffer already holds
+    // the current pose is skipped
+    class VK_Skinning
+    {
+
+    public:
+        VK_Skinning();
+        ~VK_Skinning();
+
+        VK_Skinning(const VK_Skinning&) = delete;
+        VK_Skinning& operator=(const VK_Skinning&) = delete;
+
+        // outside of a render pass, after the animations were updated and before the shadow passes
+        void Skin(VK_FrameInfo const& frameInfo, Registry& registry);
+
+    private:
+        void CreatePipeline();
+
+    private:
+        std::unique_ptr<VK_DescriptorSetLayout> m_DescriptorSetLayout;
+        VkPipelineLayout m_PipelineLayout;
+        std::unique_ptr<VK_ComputePipeline> m_Pipeline;
+    };
+} // namespace GfxRenderEngine
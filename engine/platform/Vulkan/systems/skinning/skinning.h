@@ -0,0 +1,9 @@
+// shared by the skinning system and its compute shader, offsets in floats into the packed Vertex of renderer/model.h
+
+#define SKINNING_GROUP_SIZE 64         // vertices per workgroup
+#define SKINNING_VERTEX_STRIDE 24      // sizeof(Vertex) / sizeof(float)
+#define SKINNING_OFFSET_POSITION 0
+#define SKINNING_OFFSET_NORMAL 7
+#define SKINNING_OFFSET_TANGENT 12     // vec4, w is the handedness of the bitangent
+#define SKINNING_OFFSET_JOINT_IDS 16   // ivec4, read with floatBitsToInt()
+#define SKINNING_OFFSET_WEIGHTS 20
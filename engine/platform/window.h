@@ -41,10 +41,11 @@ namespace GfxRenderEngine
         int m_Width;
         int m_Height;
         int m_VSync;
+        bool m_Headless; // no visible window, presents to VK_EXT_headless_surface
 
         WindowProperties(const std::string& title = "", const bool vsync = 1 /*true*/,
-                        const int width = -1, const int height = -1)
-            : m_Title(title), m_VSync(vsync), m_Width(width), m_Height(height)
+                        const int width = -1, const int height = -1, const bool headless = false)
+            : m_Title(title), m_VSync(vsync), m_Width(width), m_Height(height), m_Headless(headless)
         {
         }
     };
@@ -0,0 +1,146 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <filesystem>
+#include <string_view>
+
+#include "renderer/assetRegistry.h"
+
+namespace GfxRenderEngine
+{
+    AssetRegistry::Key AssetRegistry::MakeKey(std::string const& filename, uint64 importOptions, uint meshIndex)
+    {
+        // the same file reached via different relative paths maps to one key
+        std::error_code errorCode;
+        std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(filename, errorCode);
+        std::string path = errorCode ? filename : canonicalPath.generic_string();
+
+        uint64 hash = std::hash<std::string_view>{}(path);
+        hash ^= (importOptions + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2));
+        hash ^= (static_cast<uint64>(meshIndex) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2));
+        return Key{hash};
+    }
+
+    std::shared_ptr<MeshGeometry> AssetRegistry::Find(Key const& key)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto iterator = m_Entries.find(key);
+        if (iterator == m_Entries.end())
+        {
+            ++m_Statistics.m_Misses;
+            return nullptr;
+        }
+        ++m_Statistics.m_Hits;
+        Entry& entry = iterator->second;
+        m_LRU.splice(m_LRU.begin(), m_LRU, entry.m_LRUPosition);
+        return entry.m_Geometry;
+    }
+
+    std::shared_ptr<MeshGeometry> AssetRegistry::Insert(Key const& key, std::shared_ptr<MeshGeometry> const& geometry)
+    {
+        CORE_ASSERT(geometry && geometry->m_VertexBuffer, "AssetRegistry::Insert: geometry not uploaded");
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto iterator = m_Entries.find(key);
+        if (iterator != m_Entries.end())
+        {
+            // two scenes loaded the same mesh concurrently, the first upload wins
+            Entry& entry = iterator->second;
+            m_LRU.splice(m_LRU.begin(), m_LRU, entry.m_LRUPosition);
+            return entry.m_Geometry;
+        }
+
+        m_LRU.push_front(key);
+        m_Entries.emplace(key, Entry{geometry, m_LRU.begin()});
+        m_Statistics.m_MemoryBytes += geometry->m_MemorySize;
+        Evict();
+        return geometry;
+    }
+
+    void AssetRegistry::Evict()
+    {
+        if (m_Statistics.m_BudgetBytes == UNLIMITED_BUDGET)
+        {
+            return;
+        }
+
+        // walk from the least recently used end, geometry still used by a model stays resident
+        auto iterator = m_LRU.end();
+        while ((m_Statistics.m_MemoryBytes > m_Statistics.m_BudgetBytes) && (iterator != m_LRU.begin()))
+        {
+            --iterator;
+            auto entryIterator = m_Entries.find(*iterator);
+            CORE_ASSERT(entryIterator != m_Entries.end(), "AssetRegistry::Evict: LRU list out of sync");
+            Entry& entry = entryIterator->second;
+            if (entry.m_Geometry.use_count() == 1)
+            {
+                m_Statistics.m_MemoryBytes -= entry.m_Geometry->m_MemorySize;
+                ++m_Statistics.m_Evictions;
+                m_Entries.erase(entryIterator);
+                iterator = m_LRU.erase(iterator);
+            }
+        }
+    }
+
+    void AssetRegistry::SetBudget(size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Statistics.m_BudgetBytes = bytes;
+        Evict();
+    }
+
+    AssetRegistry::Statistics AssetRegistry::GetStatistics() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Statistics statistics = m_Statistics;
+        statistics.m_Entries = m_Entries.size();
+        for (auto const& [key, entry] : m_Entries)
+        {
+            if (entry.m_Geometry.use_count() > 1)
+            {
+                ++statistics.m_EntriesInUse;
+            }
+        }
+        return statistics;
+    }
+
+    void AssetRegistry::LogResidency() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        LOG_CORE_INFO("AssetRegistry: {0} meshes resident, {1:.1f} MB (hits: {2}, misses: {3}, evictions: {4})",
+                      m_Entries.size(), static_cast<float>(m_Statistics.m_MemoryBytes) / (1024.0f * 1024.0f),
+                      m_Statistics.m_Hits, m_Statistics.m_Misses, m_Statistics.m_Evictions);
+        for (auto const& key : m_LRU)
+        {
+            auto const& geometry = m_Entries.at(key).m_Geometry;
+            LOG_CORE_INFO("    {0}: {1:.2f} MB, {2} model(s)", geometry->m_Name,
+                          static_cast<float>(geometry->m_MemorySize) / (1024.0f * 1024.0f), geometry.use_count() - 1);
+        }
+    }
+
+    void AssetRegistry::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Entries.clear();
+        m_LRU.clear();
+        m_Statistics.m_MemoryBytes = 0;
+    }
+} // namespace GfxRenderEngine
@@ -0,0 +1,136 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "engine.h"
+#include "renderer/buffer.h"
+#include "renderer/builder/lodGenerator.h"
+
+namespace GfxRenderEngine
+{
+    // GPU vertex and index buffers of one mesh, shared by all models created from it
+    // materials and instance buffers are not part of the geometry, they stay with each scene
+    struct MeshGeometry
+    {
+        struct Range
+        {
+            uint m_FirstIndex{0};
+            uint m_FirstVertex{0};
+            uint m_IndexCount{0};
+            uint m_VertexCount{0};
+            std::vector<SubmeshLod> m_Lods;
+        };
+
+        std::string m_Name; // asset path and mesh index, for residency reports
+        std::shared_ptr<Buffer> m_VertexBuffer; // nullptr until the first model uploads the geometry
+        std::shared_ptr<Buffer> m_IndexBuffer;
+        uint m_VertexCount{0};
+        uint m_IndexCount{0};
+        float m_BoundingRadius{0.0f};
+        std::vector<Range> m_Ranges; // one per submesh
+        size_t m_MemorySize{0};
+    };
+
+    // Process-wide registry for mesh geometry imported from asset files.
+    // Geometry is keyed by asset path, importer options and mesh index,
+    // so scenes referencing the same asset skip vertex extraction and upload.
+    // Geometry no longer used by any model stays resident across scene
+    // switches and is evicted least-recently-used first once the memory
+    // budget is exceeded.
+    class AssetRegistry
+    {
+    public:
+        static constexpr size_t UNLIMITED_BUDGET = 0;
+
+        // import options that change the extracted vertex data
+        enum ImportOptions : uint64
+        {
+            IMPORTER_GLTF = 1 << 0,
+            IMPORTER_FASTGLTF = 1 << 1
+        };
+
+        struct Key
+        {
+            uint64 m_Hash{0};
+
+            bool operator==(Key const& other) const = default;
+        };
+
+        struct Statistics
+        {
+            uint64 m_Hits{0};
+            uint64 m_Misses{0};
+            uint64 m_Evictions{0};
+            size_t m_Entries{0};
+            size_t m_EntriesInUse{0};
+            size_t m_MemoryBytes{0};
+            size_t m_BudgetBytes{UNLIMITED_BUDGET};
+        };
+
+    public:
+        AssetRegistry() = default;
+        ~AssetRegistry() = default;
+
+        AssetRegistry(AssetRegistry const&) = delete;
+        AssetRegistry& operator=(AssetRegistry const&) = delete;
+
+        static Key MakeKey(std::string const& filename, uint64 importOptions, uint meshIndex);
+
+        // returns the registered geometry or nullptr
+        std::shared_ptr<MeshGeometry> Find(Key const& key);
+        // registers uploaded geometry; if another loader registered the key first, that geometry is returned
+        std::shared_ptr<MeshGeometry> Insert(Key const& key, std::shared_ptr<MeshGeometry> const& geometry);
+
+        void SetBudget(size_t bytes);
+        Statistics GetStatistics() const;
+        void LogResidency() const;
+        void Clear();
+
+    private:
+        struct KeyHash
+        {
+            size_t operator()(Key const& key) const { return static_cast<size_t>(key.m_Hash); }
+        };
+
+        struct Entry
+        {
+            std::shared_ptr<MeshGeometry> m_Geometry;
+            std::list<Key>::iterator m_LRUPosition;
+        };
+
+        void Evict(); // caller holds m_Mutex
+
+    private:
+        mutable std::mutex m_Mutex;
+        std::unordered_map<Key, Entry, KeyHash> m_Entries;
+        std::list<Key> m_LRU; // front: most recently used
+        Statistics m_Statistics;
+    };
+} // namespace GfxRenderEngine
@@ -245,106 +245,4 @@ namespace GfxRenderEngine
 
         return entity;
     }
-
-    void Builder::CalculateTangents()
-    {
-        if (m_Indices.size())
-        {
-            CalculateTangentsFromIndexBuffer(m_Indices);
-        }
-        else
-        {
-            uint vertexCount = m_Vertices.size();
-            if (vertexCount)
-            {
-                std::vector<uint> indices;
-                indices.resize(vertexCount);
-                for (uint i = 0; i < vertexCount; i++)
-                {
-                    indices[i] = i;
-                }
-                CalculateTangentsFromIndexBuffer(indices);
-            }
-        }
-    }
-
-    void Builder::CalculateTangentsFromIndexBuffer(std::vector<uint> const& indices)
-    {
-        uint cnt = 0;
-        uint vertexIndex1 = 0;
-        uint vertexIndex2 = 0;
-        uint vertexIndex3 = 0;
-        glm::vec3 position1 = glm::vec3{0.0f};
-        glm::vec3 position2 = glm::vec3{0.0f};
-        glm::vec3 position3 = glm::vec3{0.0f};
-        glm::vec2 uv1 = glm::vec2{0.0f};
-        glm::vec2 uv2 = glm::vec2{0.0f};
-        glm::vec2 uv3 = glm::vec2{0.0f};
-
-        for (uint index : indices)
-        {
-            auto& vertex = m_Vertices[index];
-
-            switch (cnt)
-            {
-                case 0:
-                    position1 = vertex.m_Position;
-                    uv1 = vertex.m_UV;
-                    vertexIndex1 = index;
-                    break;
-                case 1:
-                    position2 = vertex.m_Position;
-                    uv2 = vertex.m_UV;
-                    vertexIndex2 = index;
-                    break;
-                case 2:
-                    position3 = vertex.m_Position;
-                    uv3 = vertex.m_UV;
-                    vertexIndex3 = index;
-
-                    glm::vec3 edge1 = position2 - position1;
-                    glm::vec3 edge2 = position3 - position1;
-                    glm::vec2 deltaUV1 = uv2 - uv1;
-                    glm::vec2 deltaUV2 = uv3 - uv1;
-
-                    float dU1 = deltaUV1.x;
-                    float dU2 = deltaUV2.x;
-                    float dV1 = deltaUV1.y;
-                    float dV2 = deltaUV2.y;
-                    float E1x = edge1.x;
-                    float E2x = edge2.x;
-                    float E1y = edge1.y;
-                    float E2y = edge2.y;
-                    float E1z = edge1.z;
-                    float E2z = edge2.z;
-
-                    float factor;
-                    if ((dU1 * dV2 - dU2 * dV1) > std::numeric_limits<float>::epsilon())
-                    {
-                        factor = 1.0f / (dU1 * dV2 - dU2 * dV1);
-                    }
-                    else
-                    {
-                        factor = 100000.0f;
-                    }
-
-                    glm::vec3 tangent;
-
-                    tangent.x = factor * (dV2 * E1x - dV1 * E2x);
-                    tangent.y = factor * (dV2 * E1y - dV1 * E2y);
-                    tangent.z = factor * (dV2 * E1z - dV1 * E2z);
-                    if (tangent.x == 0.0f && tangent.y == 0.0f && tangent.z == 0.0f)
-                    {
-                        tangent = glm::vec3(1.0f, 0.0f, 0.0f);
-                    }
-
-                    m_Vertices[vertexIndex1].m_Tangent = tangent;
-                    m_Vertices[vertexIndex2].m_Tangent = tangent;
-                    m_Vertices[vertexIndex3].m_Tangent = tangent;
-
-                    break;
-            }
-            cnt = (cnt + 1) % 3;
-        }
-    }
 } // namespace GfxRenderEngine
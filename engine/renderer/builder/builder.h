@@ -44,10 +44,6 @@ namespace GfxRenderEngine
                         glm::vec4 const& color = glm::vec4(1.0f));
         entt::entity LoadCubemap(std::vector<std::string> const& faces, Registry& registry);
 
-    private:
-        void CalculateTangents();
-        void CalculateTangentsFromIndexBuffer(std::vector<uint> const& indices);
-
     public:
         std::vector<uint> m_Indices{};
         std::vector<Vertex> m_Vertices{};
@@ -22,13 +22,17 @@
 
 #include "gtc/type_ptr.hpp"
 #include "stb_image.h"
+#include "simdjson.h"
 
 #include "core.h"
 #include "scene/scene.h"
 #include "renderer/model.h"
 #include "renderer/instanceBuffer.h"
 #include "renderer/builder/fastgltfBuilder.h"
+#include "renderer/builder/tangentGenerator.h"
+#include "renderer/builder/lodGenerator.h"
 #include "renderer/materialDescriptor.h"
+#include "renderer/textureTranscoder.h"
 #include "auxiliary/instrumentation.h"
 #include "auxiliary/file.h"
 
@@ -84,6 +88,7 @@ namespace GfxRenderEngine
                 return Gltf::GLTF_LOAD_FAILURE;
             }
             m_GltfModel = std::move(asset.get());
+            LoadLodNodes(dataBuffer);
         }
 
         if (!m_GltfModel.meshes.size() && !m_GltfModel.lights.size() && !m_GltfModel.cameras.size())
@@ -194,6 +199,10 @@ namespace GfxRenderEngine
 
     void FastgltfBuilder::ProcessNode(fastgltf::Scene& scene, int const gltfNodeIndex, uint const parentNode)
     {
+        if (m_IsLodNode[gltfNodeIndex])
+        {
+            return; // a level of detail of another node, loaded with it
+        }
         auto& node = m_GltfModel.nodes[gltfNodeIndex];
         std::string nodeName(node.name);
 
@@ -273,16 +282,24 @@ namespace GfxRenderEngine
                 instanceTag.m_Instances.push_back(entity);
                 m_InstanceBuffer = InstanceBuffer::Create(m_InstanceCount);
                 instanceTag.m_InstanceBuffer = m_InstanceBuffer;
-                instanceTag.m_InstanceBuffer->SetInstanceData(m_InstanceIndex, transform.GetMat4Global(),
-                                                              transform.GetNormalMatrix());
+                instanceTag.m_InstanceBuffer->SetInstanceData(m_InstanceIndex, transform.GetMat4Global());
                 m_Registry.emplace<InstanceTag>(entity, instanceTag);
                 transform.SetInstance(m_InstanceBuffer, m_InstanceIndex);
                 m_InstancedObjects.push_back(entity);
 
                 // create model for 1st instance
-                LoadVertexData(meshIndex);
-                LOG_CORE_INFO("Vertex count: {0}, Index count: {1} (file: {2}, node: {3})", m_Vertices.size(),
-                              m_Indices.size(), m_Filepath, nodeName);
+                if (LoadSharedGeometry(meshIndex))
+                {
+                    LOG_CORE_INFO("shared geometry, vertex count: {0}, index count: {1} (file: {2}, node: {3})",
+                                  m_Geometry->m_VertexCount, m_Geometry->m_IndexCount, m_Filepath, nodeName);
+                }
+                else
+                {
+                    LoadVertexData(meshIndex);
+                    LoadLods(gltfNodeIndex, meshIndex);
+                    LOG_CORE_INFO("Vertex count: {0}, Index count: {1} (file: {2}, node: {3})", m_Vertices.size(),
+                                  m_Indices.size(), m_Filepath, nodeName);
+                }
 
                 { // assign material
                     uint primitiveIndex = 0;
@@ -323,8 +340,7 @@ namespace GfxRenderEngine
                 entt::entity instance = m_InstancedObjects[m_RenderObject++];
                 InstanceTag& instanceTag = m_Registry.get<InstanceTag>(instance);
                 instanceTag.m_Instances.push_back(entity);
-                instanceTag.m_InstanceBuffer->SetInstanceData(m_InstanceIndex, transform.GetMat4Global(),
-                                                              transform.GetNormalMatrix());
+                instanceTag.m_InstanceBuffer->SetInstanceData(m_InstanceIndex, transform.GetMat4Global());
                 transform.SetInstance(instanceTag.m_InstanceBuffer, m_InstanceIndex);
             }
 
@@ -420,6 +436,28 @@ namespace GfxRenderEngine
         return Texture::USE_UNORM;
     }
 
+    Texture::Usage FastgltfBuilder::GetImageUsage(uint const imageIndex)
+    {
+        auto isImage = [&](size_t textureIndex)
+        {
+            auto& texture = m_GltfModel.textures[textureIndex];
+            return texture.imageIndex.has_value() && (texture.imageIndex.value() == imageIndex);
+        };
+        for (fastgltf::Material& material : m_GltfModel.materials)
+        {
+            if (material.normalTexture.has_value() && isImage(material.normalTexture.value().textureIndex))
+            {
+                return Texture::USAGE_NORMAL_MAP;
+            }
+            if (material.pbrData.metallicRoughnessTexture.has_value() &&
+                isImage(material.pbrData.metallicRoughnessTexture.value().textureIndex))
+            {
+                return Texture::USAGE_ROUGHNESS_METALLIC_MAP;
+            }
+        }
+        return Texture::USAGE_COLOR;
+    }
+
     int FastgltfBuilder::GetMinFilter(uint index)
     {
         fastgltf::Filter filter = fastgltf::Filter::Linear;
@@ -463,7 +501,38 @@ namespace GfxRenderEngine
                 ZoneScopedNC("FastgltfBuilder::LoadTextures", 0x0000ff);
 
                 fastgltf::Image& glTFImage = m_GltfModel.images[imageIndex];
-                auto texture = Texture::Create();
+                std::shared_ptr<Texture> texture;
+
+                int minFilter = GetMinFilter(imageIndex);
+                int magFilter = GetMagFilter(imageIndex);
+                bool imageFormat = GetImageFormat(imageIndex);
+                Texture::Usage usage = GetImageUsage(imageIndex);
+                auto& textureCache = Engine::m_Engine->m_TextureCache;
+
+                // takes ownership of the pixels decoded by stbi
+                auto createTexture = [&](unsigned char* buffer, int width, int height) -> std::shared_ptr<Texture>
+                {
+                    auto newTexture = Texture::Create();
+                    bool ok = newTexture->Init(width, height, imageFormat, buffer, minFilter, magFilter);
+                    stbi_image_free(buffer);
+                    return ok ? newTexture : nullptr;
+                };
+
+                // decodes compressed image data (png, jpg) from memory
+                auto loadFromMemory = [&](const unsigned char* data, size_t size) -> std::shared_ptr<Texture>
+                {
+                    // images shared between glTF files are decoded and uploaded only once
+                    auto key = TextureCache::MakeContentKey(data, size, imageFormat, minFilter, magFilter);
+                    auto loader = [&]() -> std::shared_ptr<Texture>
+                    {
+                        int width = 0, height = 0, nrChannels = 0;
+                        unsigned char* buffer = stbi_load_from_memory(data, static_cast<int>(size), &width, &height,
+                                                                      &nrChannels, 4 /*int desired_channels*/);
+                        CORE_ASSERT(buffer, "stbi failed (image data = Array) " + glTFImage.name);
+                        return createTexture(buffer, width, height);
+                    };
+                    return textureCache.Get(key, loader);
+                };
 
                 // image data is of type std::variant: the data type can be a URI/filepath, an Array, or a BufferView
                 // std::visit calls the appropriate function
@@ -476,35 +545,30 @@ namespace GfxRenderEngine
                             CORE_ASSERT(filePath.fileByteOffset == 0, "no offset data support with stbi " + glTFImage.name);
                             CORE_ASSERT(filePath.uri.isLocalPath(), "no local file " + glTFImage.name);
 
-                            int width = 0, height = 0, nrChannels = 0;
-                            unsigned char* buffer =
-                                stbi_load(imageFilepath.c_str(), &width, &height, &nrChannels, 4 /*int desired_channels*/);
-                            CORE_ASSERT(buffer, "stbi failed (image data = URI) " + glTFImage.name);
-                            CORE_ASSERT(nrChannels == 4, "wrong number of channels");
-
-                            int minFilter = GetMinFilter(imageIndex);
-                            int magFilter = GetMagFilter(imageIndex);
-                            bool imageFormat = GetImageFormat(imageIndex);
-                            texture->Init(width, height, imageFormat, buffer, minFilter, magFilter);
-
-                            stbi_image_free(buffer);
+                            auto key = TextureCache::MakeFileKey(imageFilepath, imageFormat, false /*flip*/, usage);
+                            key.m_MinFilter = minFilter;
+                            key.m_MagFilter = magFilter;
+                            auto loader = [&]() -> std::shared_ptr<Texture>
+                            {
+                                // KTX2/DDS images, or PNG/JPEG with transcoding enabled
+                                auto compressed = TextureTranscoder::LoadCompressed(imageFilepath, usage, imageFormat,
+                                                                                    false /*flip*/, minFilter, magFilter);
+                                if (compressed)
+                                {
+                                    return compressed;
+                                }
+
+                                int width = 0, height = 0, nrChannels = 0;
+                                unsigned char* buffer = stbi_load(imageFilepath.c_str(), &width, &height, &nrChannels,
+                                                                  4 /*int desired_channels*/);
+                                CORE_ASSERT(buffer, "stbi failed (image data = URI) " + glTFImage.name);
+                                CORE_ASSERT(nrChannels == 4, "wrong number of channels");
+                                return createTexture(buffer, width, height);
+                            };
+                            texture = textureCache.Get(key, loader);
                         },
                         [&](fastgltf::sources::Array& vector) // load from memory
-                        {
-                            int width = 0, height = 0, nrChannels = 0;
-
-                            using byte = unsigned char;
-                            byte* buffer = stbi_load_from_memory(vector.bytes.data(), static_cast<int>(vector.bytes.size()),
-                                                                 &width, &height, &nrChannels, 4 /*int desired_channels*/);
-                            CORE_ASSERT(buffer, "stbi failed (image data = Array) " + glTFImage.name);
-
-                            int minFilter = GetMinFilter(imageIndex);
-                            int magFilter = GetMagFilter(imageIndex);
-                            bool imageFormat = GetImageFormat(imageIndex);
-                            texture->Init(width, height, imageFormat, buffer, minFilter, magFilter);
-
-                            stbi_image_free(buffer);
-                        },
+                        { texture = loadFromMemory(vector.bytes.data(), vector.bytes.size()); },
                         [&](fastgltf::sources::BufferView& view) // load from buffer view
                         {
                             auto& bufferView = m_GltfModel.bufferViews[view.bufferViewIndex];
@@ -519,19 +583,8 @@ namespace GfxRenderEngine
                                     },
                                     [&](fastgltf::sources::Array& vector) // load from memory
                                     {
-                                        int width = 0, height = 0, nrChannels = 0;
-                                        using byte = unsigned char;
-                                        byte* buffer = stbi_load_from_memory(vector.bytes.data() + bufferView.byteOffset,
-                                                                             static_cast<int>(bufferView.byteLength), &width,
-                                                                             &height, &nrChannels, 4);
-                                        CORE_ASSERT(buffer, "stbi failed (image data = Array) " + glTFImage.name);
-
-                                        int minFilter = GetMinFilter(imageIndex);
-                                        int magFilter = GetMagFilter(imageIndex);
-                                        bool imageFormat = GetImageFormat(imageIndex);
-                                        texture->Init(width, height, imageFormat, buffer, minFilter, magFilter);
-
-                                        stbi_image_free(buffer);
+                                        texture = loadFromMemory(vector.bytes.data() + bufferView.byteOffset,
+                                                                 bufferView.byteLength);
                                     }},
                                 bufferFromBufferView.data);
                         },
@@ -545,7 +598,8 @@ namespace GfxRenderEngine
         }
         for (uint imageIndex = 0; imageIndex < numTextures; ++imageIndex)
         {
-            m_Textures[imageIndex] = futures[imageIndex].get();
+            // help with the loading instead of blocking this thread
+            m_Textures[imageIndex] = Engine::m_Engine->m_PoolSecondary.WaitFor(futures[imageIndex]);
         }
     }
 
@@ -655,6 +709,8 @@ namespace GfxRenderEngine
                 diffuseColor = m_Materials[materialIndex].m_PbrMaterial.m_DiffuseColor;
             }
 
+            bool calculateTangents = false;
+
             // Vertices
             {
                 const float* positionBuffer = nullptr;
@@ -811,7 +867,7 @@ namespace GfxRenderEngine
 
                     // tangent
                     glm::vec4 t = tangentsBuffer ? glm::make_vec4(&tangentsBuffer[vertexIterator * 4]) : glm::vec4(0.0f);
-                    vertex.m_Tangent = glm::vec3(t.x, t.y, t.z) * t.w;
+                    vertex.m_Tangent = t;
 
                     // joint indices and joint weights
                     if (jointsBuffer && weightsBuffer)
@@ -843,11 +899,7 @@ namespace GfxRenderEngine
                     ++vertexIndex;
                 }
 
-                // calculate tangents
-                if (!tangentsBuffer)
-                {
-                    CalculateTangents();
-                }
+                calculateTangents = !tangentsBuffer;
             }
 
             // Indices
@@ -864,11 +916,145 @@ namespace GfxRenderEngine
                                                          { destination[iterator] = submeshIndex; });
             }
 
+            // calculate tangents
+            if (calculateTangents)
+            {
+                TangentGenerator::Generate(m_Vertices.data() + submesh.m_FirstVertex, static_cast<uint>(vertexCount),
+                                           m_Indices.data() + submesh.m_FirstIndex, static_cast<uint>(indexCount));
+            }
+
             submesh.m_VertexCount = vertexCount;
             submesh.m_IndexCount = indexCount;
         }
     }
 
+    bool FastgltfBuilder::LoadSharedGeometry(uint const meshIndex)
+    {
+        m_GeometryKey = AssetRegistry::MakeKey(m_Filepath, AssetRegistry::IMPORTER_FASTGLTF, meshIndex);
+        m_Geometry = Engine::m_Engine->m_AssetRegistry.Find(m_GeometryKey);
+        if (!m_Geometry)
+        {
+            // the model uploads the vertex data and registers it
+            m_Geometry = std::make_shared<MeshGeometry>();
+            m_Geometry->m_Name = m_Filepath + "::" + std::to_string(meshIndex);
+            return false;
+        }
+
+        m_Vertices.clear();
+        m_Indices.clear();
+        m_Submeshes.clear();
+        m_Submeshes.resize(m_Geometry->m_Ranges.size());
+        for (size_t submeshIndex = 0; submeshIndex < m_Submeshes.size(); ++submeshIndex)
+        {
+            Submesh& submesh = m_Submeshes[submeshIndex];
+            MeshGeometry::Range const& range = m_Geometry->m_Ranges[submeshIndex];
+            submesh.m_FirstIndex = range.m_FirstIndex;
+            submesh.m_FirstVertex = range.m_FirstVertex;
+            submesh.m_IndexCount = range.m_IndexCount;
+            submesh.m_VertexCount = range.m_VertexCount;
+            submesh.m_InstanceCount = m_InstanceCount;
+            submesh.m_Lods = range.m_Lods;
+        }
+        return true;
+    }
+
+    void FastgltfBuilder::LoadLodNodes(fastgltf::GltfDataBuffer& dataBuffer)
+    {
+        // MSFT_lod lists the coarser nodes of a node in its extensions, fastgltf does not parse it
+        m_LodNodes.clear();
+        m_IsLodNode.assign(m_GltfModel.nodes.size(), false);
+
+        auto data = static_cast<fastgltf::span<std::byte>>(dataBuffer);
+        char const* json = reinterpret_cast<char const*>(data.data());
+        size_t jsonLength = data.size();
+        if ((jsonLength >= 20) && !memcmp(json, "glTF", 4))
+        {
+            // glb: 12 byte header, the first chunk is the JSON chunk (length, type, data)
+            uint32_t chunkLength;
+            memcpy(&chunkLength, json + 12, sizeof(chunkLength));
+            json += 20;
+            jsonLength = std::min<size_t>(chunkLength, jsonLength - 20);
+        }
+        if (std::string_view(json, jsonLength).find("MSFT_lod") == std::string_view::npos)
+        {
+            return;
+        }
+
+        simdjson::dom::parser parser;
+        simdjson::dom::element document;
+        simdjson::dom::array nodes;
+        if (parser.parse(json, jsonLength).get(document) || document["nodes"].get_array().get(nodes))
+        {
+            LOG_CORE_WARN("FastgltfBuilder::LoadLodNodes: could not parse MSFT_lod in {0}", m_Filepath);
+            return;
+        }
+        int nodeIndex = 0;
+        for (simdjson::dom::element node : nodes)
+        {
+            simdjson::dom::array ids;
+            if (!node["extensions"]["MSFT_lod"]["ids"].get_array().get(ids))
+            {
+                for (simdjson::dom::element id : ids)
+                {
+                    uint64_t lodNodeIndex;
+                    if (!id.get_uint64().get(lodNodeIndex) && (lodNodeIndex < m_GltfModel.nodes.size()))
+                    {
+                        m_LodNodes[nodeIndex].push_back(static_cast<int>(lodNodeIndex));
+                        m_IsLodNode[lodNodeIndex] = true;
+                    }
+                }
+            }
+            ++nodeIndex;
+        }
+    }
+
+    void FastgltfBuilder::LoadLods(int const gltfNodeIndex, uint const meshIndex)
+    {
+        auto lodNodes = m_LodNodes.find(gltfNodeIndex);
+        if (lodNodes != m_LodNodes.end())
+        {
+            // authored levels: the primitives of the coarser meshes are matched by material
+            auto getMaterialIndex = [](fastgltf::Primitive const& primitive)
+            { return primitive.materialIndex.has_value() ? static_cast<int>(primitive.materialIndex.value()) : -1; };
+            std::vector<Vertex> vertices = std::move(m_Vertices);
+            std::vector<uint> indices = std::move(m_Indices);
+            std::vector<Submesh> submeshes = std::move(m_Submeshes);
+            auto& primitives = m_GltfModel.meshes[meshIndex].primitives;
+            for (int lodNodeIndex : lodNodes->second)
+            {
+                auto& lodNode = m_GltfModel.nodes[lodNodeIndex];
+                if (!lodNode.meshIndex.has_value())
+                {
+                    continue;
+                }
+                uint lodMeshIndex = lodNode.meshIndex.value();
+                auto& lodPrimitives = m_GltfModel.meshes[lodMeshIndex].primitives;
+                LoadVertexData(lodMeshIndex);
+                for (size_t primitiveIndex = 0; primitiveIndex < primitives.size(); ++primitiveIndex)
+                {
+                    size_t lodPrimitiveIndex = primitiveIndex;
+                    for (size_t candidate = 0; candidate < lodPrimitives.size(); ++candidate)
+                    {
+                        if (getMaterialIndex(lodPrimitives[candidate]) == getMaterialIndex(primitives[primitiveIndex]))
+                        {
+                            lodPrimitiveIndex = candidate;
+                            break;
+                        }
+                    }
+                    if (lodPrimitiveIndex < lodPrimitives.size())
+                    {
+                        LodGenerator::AppendLevel(vertices, indices, submeshes[primitiveIndex], m_Vertices, m_Indices,
+                                                  m_Submeshes[lodPrimitiveIndex]);
+                    }
+                }
+            }
+            m_Vertices = std::move(vertices);
+            m_Indices = std::move(indices);
+            m_Submeshes = std::move(submeshes);
+        }
+        LodGenerator::Generate(m_Vertices, m_Indices, m_Submeshes);
+    }
+
     void FastgltfBuilder::LoadTransformationMatrix(TransformComponent& transform, int const gltfNodeIndex)
     {
         auto& node = m_GltfModel.nodes[gltfNodeIndex];
@@ -926,106 +1112,6 @@ namespace GfxRenderEngine
         LOG_CORE_INFO("material assigned (fastgltf): material index {0}", materialIndex);
     }
 
-    void FastgltfBuilder::CalculateTangents()
-    {
-        if (m_Indices.size())
-        {
-            CalculateTangentsFromIndexBuffer(m_Indices);
-        }
-        else
-        {
-            uint vertexCount = m_Vertices.size();
-            if (vertexCount)
-            {
-                std::vector<uint> indices;
-                indices.resize(vertexCount);
-                for (uint i = 0; i < vertexCount; i++)
-                {
-                    indices[i] = i;
-                }
-                CalculateTangentsFromIndexBuffer(indices);
-            }
-        }
-    }
-
-    void FastgltfBuilder::CalculateTangentsFromIndexBuffer(const std::vector<uint>& indices)
-    {
-        uint cnt = 0;
-        uint vertexIndex1 = 0;
-        uint vertexIndex2 = 0;
-        uint vertexIndex3 = 0;
-        glm::vec3 position1 = glm::vec3{0.0f};
-        glm::vec3 position2 = glm::vec3{0.0f};
-        glm::vec3 position3 = glm::vec3{0.0f};
-        glm::vec2 uv1 = glm::vec2{0.0f};
-        glm::vec2 uv2 = glm::vec2{0.0f};
-        glm::vec2 uv3 = glm::vec2{0.0f};
-
-        for (uint index : indices)
-        {
-            auto& vertex = m_Vertices[index];
-
-            switch (cnt)
-            {
-                case 0:
-                    position1 = vertex.m_Position;
-                    uv1 = vertex.m_UV;
-                    vertexIndex1 = index;
-                    break;
-                case 1:
-                    position2 = vertex.m_Position;
-                    uv2 = vertex.m_UV;
-                    vertexIndex2 = index;
-                    break;
-                case 2:
-                    position3 = vertex.m_Position;
-                    uv3 = vertex.m_UV;
-                    vertexIndex3 = index;
-
-                    glm::vec3 edge1 = position2 - position1;
-                    glm::vec3 edge2 = position3 - position1;
-                    glm::vec2 deltaUV1 = uv2 - uv1;
-                    glm::vec2 deltaUV2 = uv3 - uv1;
-
-                    float dU1 = deltaUV1.x;
-                    float dU2 = deltaUV2.x;
-                    float dV1 = deltaUV1.y;
-                    float dV2 = deltaUV2.y;
-                    float E1x = edge1.x;
-                    float E2x = edge2.x;
-                    float E1y = edge1.y;
-                    float E2y = edge2.y;
-                    float E1z = edge1.z;
-                    float E2z = edge2.z;
-
-                    float factor;
-                    if ((dU1 * dV2 - dU2 * dV1) > std::numeric_limits<float>::epsilon())
-                    {
-                        factor = 1.0f / (dU1 * dV2 - dU2 * dV1);
-                    }
-                    else
-                    {
-                        factor = 100000.0f;
-                    }
-
-                    glm::vec3 tangent;
-
-                    tangent.x = factor * (dV2 * E1x - dV1 * E2x);
-                    tangent.y = factor * (dV2 * E1y - dV1 * E2y);
-                    tangent.z = factor * (dV2 * E1z - dV1 * E2z);
-                    if (tangent.x == 0.0f && tangent.y == 0.0f && tangent.z == 0.0f)
-                        tangent = glm::vec3(1.0f, 0.0f, 0.0f);
-
-                    m_Vertices[vertexIndex1].m_Tangent = tangent;
-                    m_Vertices[vertexIndex2].m_Tangent = tangent;
-                    m_Vertices[vertexIndex3].m_Tangent = tangent;
-
-                    break;
-            }
-            cnt = (cnt + 1) % 3;
-        }
-    }
-
     void FastgltfBuilder::SetDictionaryPrefix(std::string const& dictionaryPrefix) { m_DictionaryPrefix = dictionaryPrefix; }
 
     void FastgltfBuilder::PrintAssetError(fastgltf::Error assetErrorCode)
@@ -32,6 +32,7 @@
 #include "scene/material.h"
 #include "scene/registry.h"
 #include "renderer/resourceDescriptor.h"
+#include "renderer/assetRegistry.h"
 
 namespace GfxRenderEngine
 {
@@ -67,15 +68,21 @@ namespace GfxRenderEngine
         std::vector<Vertex> m_Vertices{};
         std::vector<Submesh> m_Submeshes{};
 
+        // GPU geometry of the current mesh, shared across scenes (see AssetRegistry)
+        AssetRegistry::Key m_GeometryKey{};
+        std::shared_ptr<MeshGeometry> m_Geometry;
+
     private:
         void LoadTextures();
         void LoadMaterials();
         void LoadVertexData(uint const meshIndex);
+        bool LoadSharedGeometry(uint const meshIndex);
+        void LoadLodNodes(fastgltf::GltfDataBuffer& dataBuffer);
+        void LoadLods(int const gltfNodeIndex, uint const meshIndex);
         bool GetImageFormat(uint const imageIndex);
+        Texture::Usage GetImageUsage(uint const imageIndex);
         void AssignMaterial(Submesh& submesh, int const materialIndex);
         void LoadTransformationMatrix(TransformComponent& transform, int const gltfNodeIndex);
-        void CalculateTangents();
-        void CalculateTangentsFromIndexBuffer(const std::vector<uint>& indices);
 
         bool MarkNode(fastgltf::Scene& scene, int const gltfNodeIndex);
         void ProcessScene(fastgltf::Scene& scene, uint const parentNode);
@@ -129,6 +136,10 @@ namespace GfxRenderEngine
         std::vector<bool> m_HasMesh;
         entt::entity m_GameObject;
 
+        // levels of detail (MSFT_lod): the coarser nodes of a node, they are not part of the scene graph
+        std::unordered_map<int, std::vector<int>> m_LodNodes;
+        std::vector<bool> m_IsLodNode;
+
         std::vector<entt::entity> m_InstancedObjects;
         std::shared_ptr<InstanceBuffer> m_InstanceBuffer;
         Resources::ResourceBuffers m_ResourceBuffersPre;
@@ -28,6 +28,8 @@
 #include "core.h"
 #include "renderer/instanceBuffer.h"
 #include "renderer/builder/fbxBuilder.h"
+#include "renderer/builder/tangentGenerator.h"
+#include "renderer/builder/lodGenerator.h"
 #include "renderer/materialDescriptor.h"
 #include "auxiliary/instrumentation.h"
 #include "auxiliary/file.h"
@@ -40,7 +42,7 @@ namespace GfxRenderEngine
     FbxBuilder::FbxBuilder(const std::string& filepath, Scene& scene)
         : m_Filepath{filepath}, m_SkeletalAnimation{false}, m_Registry{scene.GetRegistry()},
           m_SceneGraph{scene.GetSceneGraph()}, m_Dictionary{scene.GetDictionary()}, m_InstanceCount{0}, m_InstanceIndex{0},
-          m_FbxScene{nullptr}, m_FbxNoBuiltInTangents{false}
+          m_FbxScene{nullptr}
     {
         m_Basepath = EngineCore::GetPathWithoutFilename(filepath);
     }
@@ -70,8 +72,10 @@ namespace GfxRenderEngine
             LOG_CORE_WARN("FbxBuilder::Load: scene ID for fbx not supported (in file {0})", m_Filepath);
         }
 
+        m_InstanceCount = instanceCount;
         LoadSkeletonsFbx();
         LoadMaterials();
+        LoadVertexData();
 
         // PASS 1
         // mark Fbx nodes to receive a game object ID if they have a mesh or any child has
@@ -79,7 +83,6 @@ namespace GfxRenderEngine
         MarkNode(m_FbxScene->mRootNode);
 
         // PASS 2 (for all instances)
-        m_InstanceCount = instanceCount;
         for (m_InstanceIndex = 0; m_InstanceIndex < m_InstanceCount; ++m_InstanceIndex)
         {
             // create group game object(s) for all instances to apply transform from JSON file to
@@ -100,6 +103,7 @@ namespace GfxRenderEngine
             m_RenderObject = 0;
             ProcessNode(m_FbxScene->mRootNode, groupNode, hasMeshIndex);
         }
+        m_MeshData.clear();
         return Fbx::FBX_LOAD_SUCCESS;
     }
 
@@ -216,14 +220,16 @@ namespace GfxRenderEngine
             instanceTag.m_Instances.push_back(entity);
             m_InstanceBuffer = InstanceBuffer::Create(m_InstanceCount);
             instanceTag.m_InstanceBuffer = m_InstanceBuffer;
-            instanceTag.m_InstanceBuffer->SetInstanceData(m_InstanceIndex, transform.GetMat4Global(),
-                                                          transform.GetNormalMatrix());
+            instanceTag.m_InstanceBuffer->SetInstanceData(m_InstanceIndex, transform.GetMat4Global());
             m_Registry.emplace<InstanceTag>(entity, instanceTag);
             transform.SetInstance(m_InstanceBuffer, m_InstanceIndex);
             m_InstancedObjects.push_back(entity);
 
             // create model for 1st instance
-            LoadVertexData(fbxNodePtr);
+            MeshData& meshData = m_MeshData[fbxNodePtr];
+            m_Vertices = std::move(meshData.m_Vertices);
+            m_Indices = std::move(meshData.m_Indices);
+            m_Submeshes = std::move(meshData.m_Submeshes);
             LOG_CORE_INFO("Vertex count: {0}, Index count: {1} (file: {2}, node: {3})", m_Vertices.size(), m_Indices.size(),
                           m_Filepath, nodeName);
             for (uint submeshIndex = 0; submeshIndex < fbxNodePtr->mNumMeshes; ++submeshIndex)
@@ -250,8 +256,7 @@ namespace GfxRenderEngine
             entt::entity instance = m_InstancedObjects[m_RenderObject++];
             InstanceTag& instanceTag = m_Registry.get<InstanceTag>(instance);
             instanceTag.m_Instances.push_back(entity);
-            instanceTag.m_InstanceBuffer->SetInstanceData(m_InstanceIndex, transform.GetMat4Global(),
-                                                          transform.GetNormalMatrix());
+            instanceTag.m_InstanceBuffer->SetInstanceData(m_InstanceIndex, transform.GetMat4Global());
             transform.SetInstance(instanceTag.m_InstanceBuffer, m_InstanceIndex);
         }
 
@@ -264,34 +269,51 @@ namespace GfxRenderEngine
         return newNode;
     }
 
-    std::shared_ptr<Texture> FbxBuilder::LoadTexture(std::string const& filepath, bool useSRGB)
+    std::shared_ptr<Texture> FbxBuilder::LoadTexture(std::string const& filepath, bool useSRGB, Texture::Usage usage)
     {
-        std::shared_ptr<Texture> texture;
-        bool loadSucess = false;
-
-        if (EngineCore::FileExists(filepath) && !EngineCore::IsDirectory(filepath))
-        {
-            texture = Texture::Create();
-            loadSucess = texture->Init(filepath, useSRGB);
-        }
-        else if (EngineCore::FileExists(m_Basepath + filepath) && !EngineCore::IsDirectory(m_Basepath + filepath))
-        {
-            texture = Texture::Create();
-            loadSucess = texture->Init(m_Basepath + filepath, useSRGB);
-        }
-        else
-        {
-            LOG_CORE_CRITICAL("bool FbxBuilder::LoadTexture(): file '{0}' not found", filepath);
-        }
-
-        if (loadSucess)
+        auto texture = m_TexturePrefetcher.Get({filepath, m_Basepath + filepath}, useSRGB, usage);
+        if (texture)
         {
             m_Textures.push_back(texture);
             return texture;
         }
+        LOG_CORE_CRITICAL("bool FbxBuilder::LoadTexture(): file '{0}' not found", filepath);
         return nullptr;
     }
 
+    // queues the same maps that LoadMap() uses, so that they are decoded concurrently
+    void FbxBuilder::PrefetchTextures()
+    {
+        struct MapType
+        {
+            aiTextureType m_TextureType;
+            bool m_SRGB;
+            Texture::Usage m_Usage;
+        };
+        static constexpr MapType mapTypes[] = {
+            {aiTextureType_DIFFUSE, Texture::USE_SRGB, Texture::USAGE_COLOR},
+            {aiTextureType_NORMALS, Texture::USE_UNORM, Texture::USAGE_NORMAL_MAP},
+            {aiTextureType_SHININESS, Texture::USE_UNORM, Texture::USAGE_GRAYSCALE_MAP},
+            {aiTextureType_METALNESS, Texture::USE_UNORM, Texture::USAGE_GRAYSCALE_MAP},
+            {aiTextureType_EMISSIVE, Texture::USE_SRGB, Texture::USAGE_COLOR}};
+
+        for (uint materialIndex = 0; materialIndex < m_FbxScene->mNumMaterials; ++materialIndex)
+        {
+            const aiMaterial* fbxMaterial = m_FbxScene->mMaterials[materialIndex];
+            for (MapType const& mapType : mapTypes)
+            {
+                aiString aiFilepath;
+                if (fbxMaterial->GetTextureCount(mapType.m_TextureType) &&
+                    (fbxMaterial->GetTexture(mapType.m_TextureType, 0 /* first map*/, &aiFilepath) == aiReturn_SUCCESS))
+                {
+                    std::string filepath(aiFilepath.C_Str());
+                    m_TexturePrefetcher.Add({filepath, m_Basepath + filepath}, mapType.m_SRGB, mapType.m_Usage);
+                }
+            }
+        }
+        m_TexturePrefetcher.Load();
+    }
+
     void FbxBuilder::LoadMap(const aiMaterial* fbxMaterial, aiTextureType textureType, int materialIndex)
     {
         uint textureCount = fbxMaterial->GetTextureCount(textureType);
@@ -325,7 +347,7 @@ namespace GfxRenderEngine
                 }
                 case aiTextureType_NORMALS:
                 {
-                    auto texture = LoadTexture(filepath, Texture::USE_UNORM);
+                    auto texture = LoadTexture(filepath, Texture::USE_UNORM, Texture::USAGE_NORMAL_MAP);
                     if (texture)
                     {
                         materialTextures[Material::NORMAL_MAP_INDEX] = texture;
@@ -335,7 +357,7 @@ namespace GfxRenderEngine
                 }
                 case aiTextureType_SHININESS: // assimp XD
                 {
-                    auto texture = LoadTexture(filepath, Texture::USE_UNORM);
+                    auto texture = LoadTexture(filepath, Texture::USE_UNORM, Texture::USAGE_GRAYSCALE_MAP);
                     if (texture)
                     {
                         materialTextures[Material::ROUGHNESS_MAP_INDEX] = texture;
@@ -345,7 +367,7 @@ namespace GfxRenderEngine
                 }
                 case aiTextureType_METALNESS:
                 {
-                    auto texture = LoadTexture(filepath, Texture::USE_UNORM);
+                    auto texture = LoadTexture(filepath, Texture::USE_UNORM, Texture::USAGE_GRAYSCALE_MAP);
                     if (texture)
                     {
                         materialTextures[Material::METALLIC_MAP_INDEX] = texture;
@@ -437,6 +459,7 @@ namespace GfxRenderEngine
         uint numMaterials = m_FbxScene->mNumMaterials;
         m_Materials.resize(numMaterials);
         m_MaterialTextures.resize(numMaterials);
+        PrefetchTextures();
         for (uint materialIndex = 0; materialIndex < numMaterials; ++materialIndex)
         {
             const aiMaterial* fbxMaterial = m_FbxScene->mMaterials[materialIndex];
@@ -455,31 +478,91 @@ namespace GfxRenderEngine
     }
 
     // handle vertex data
-    void FbxBuilder::LoadVertexData(const aiNode* fbxNodePtr, int vertexColorSet, uint uvSet)
+    // the meshes of all nodes are extracted in parallel, each job writes into
+    // its own preallocated range of the node's buffers
+    void FbxBuilder::LoadVertexData(int vertexColorSet, uint uvSet)
     {
-        m_Vertices.clear();
-        m_Indices.clear();
-        m_Submeshes.clear();
-
-        m_FbxNoBuiltInTangents = false;
-        uint numMeshes = fbxNodePtr->mNumMeshes;
-        if (numMeshes)
+        ZoneScopedN("FbxBuilder::LoadVertexData");
+        struct MeshJob
         {
-            m_Submeshes.resize(numMeshes);
-            for (uint meshIndex = 0; meshIndex < numMeshes; ++meshIndex)
+            MeshData* m_MeshData;
+            uint m_MeshIndex;
+            uint m_FbxMeshIndex;
+        };
+        std::vector<MeshJob> jobs;
+
+        m_MeshData.clear();
+        std::vector<const aiNode*> nodes{m_FbxScene->mRootNode};
+        while (!nodes.empty())
+        {
+            const aiNode* fbxNodePtr = nodes.back();
+            nodes.pop_back();
+            for (uint childNodeIndex = 0; childNodeIndex < fbxNodePtr->mNumChildren; ++childNodeIndex)
             {
-                LoadVertexData(fbxNodePtr, meshIndex, fbxNodePtr->mMeshes[meshIndex], vertexColorSet, uvSet);
+                nodes.push_back(fbxNodePtr->mChildren[childNodeIndex]);
             }
-            if (m_FbxNoBuiltInTangents) // at least one mesh did not have tangents
+
+            uint numMeshes = fbxNodePtr->mNumMeshes;
+            if (!numMeshes)
             {
-                LOG_CORE_CRITICAL("no tangents in fbx file found, calculating tangents manually");
-                CalculateTangents();
+                continue;
             }
-        }
+            MeshData& meshData = m_MeshData[fbxNodePtr];
+            meshData.m_Submeshes.resize(numMeshes);
+
+            uint numVertices = 0;
+            uint numIndices = 0;
+            for (uint meshIndex = 0; meshIndex < numMeshes; ++meshIndex)
+            {
+                uint fbxMeshIndex = fbxNodePtr->mMeshes[meshIndex];
+                const aiMesh* mesh = m_FbxScene->mMeshes[fbxMeshIndex];
+                bool isTriangleMesh = mesh->mPrimitiveTypes & aiPrimitiveType_TRIANGLE;
+
+                Submesh& submesh = meshData.m_Submeshes[meshIndex];
+                submesh.m_FirstVertex = numVertices;
+                submesh.m_FirstIndex = numIndices;
+                submesh.m_VertexCount = isTriangleMesh ? mesh->mNumVertices : 0;
+                submesh.m_IndexCount = isTriangleMesh ? mesh->mNumFaces * 3 : 0; // 3 indices per triangle a.k.a face
+                submesh.m_InstanceCount = m_InstanceCount;
+                numVertices += submesh.m_VertexCount;
+                numIndices += submesh.m_IndexCount;
+                jobs.push_back({&meshData, meshIndex, fbxMeshIndex});
+            }
+            meshData.m_Vertices.resize(numVertices);
+            meshData.m_Indices.resize(numIndices);
+        }
+
+        Engine::m_Engine->m_PoolPrimary.ParallelFor(0, jobs.size(), 1 /*grain size*/,
+                                                    [&](uint firstJob, uint lastJob)
+                                                    {
+                                                        for (uint jobIndex = firstJob; jobIndex < lastJob; ++jobIndex)
+                                                        {
+                                                            MeshJob const& job = jobs[jobIndex];
+                                                            LoadVertexData(*job.m_MeshData, job.m_MeshIndex,
+                                                                           job.m_FbxMeshIndex, vertexColorSet, uvSet);
+                                                        }
+                                                    });
+
+        // levels of detail, one job per mesh node
+        std::vector<MeshData*> meshes;
+        for (auto& [fbxNodePtr, meshData] : m_MeshData)
+        {
+            meshes.push_back(&meshData);
+        }
+        Engine::m_Engine->m_PoolPrimary.ParallelFor(0, meshes.size(), 1 /*grain size*/,
+                                                    [&](uint firstMesh, uint lastMesh)
+                                                    {
+                                                        for (uint meshIndex = firstMesh; meshIndex < lastMesh; ++meshIndex)
+                                                        {
+                                                            MeshData& meshData = *meshes[meshIndex];
+                                                            LodGenerator::Generate(meshData.m_Vertices, meshData.m_Indices,
+                                                                                   meshData.m_Submeshes);
+                                                        }
+                                                    });
     }
 
-    void FbxBuilder::LoadVertexData(const aiNode* fbxNodePtr, uint const meshIndex, uint const fbxMeshIndex,
-                                    int vertexColorSet, uint uvSet)
+    void FbxBuilder::LoadVertexData(MeshData& meshData, uint const meshIndex, uint const fbxMeshIndex, int vertexColorSet,
+                                    uint uvSet)
     {
         const aiMesh* mesh = m_FbxScene->mMeshes[fbxMeshIndex];
 
@@ -494,17 +577,11 @@ namespace GfxRenderEngine
         const uint numFaces = mesh->mNumFaces;
         const uint numIndices = numFaces * 3; // 3 indices per triangle a.k.a face
 
-        size_t numVerticesBefore = m_Vertices.size();
-        size_t numIndicesBefore = m_Indices.size();
-        m_Vertices.resize(numVerticesBefore + numVertices);
-        m_Indices.resize(numIndicesBefore + numIndices);
-
-        Submesh& submesh = m_Submeshes[meshIndex];
-        submesh.m_FirstVertex = numVerticesBefore;
-        submesh.m_FirstIndex = numIndicesBefore;
-        submesh.m_VertexCount = numVertices;
-        submesh.m_IndexCount = numIndices;
-        submesh.m_InstanceCount = m_InstanceCount;
+        Submesh const& submesh = meshData.m_Submeshes[meshIndex];
+        uint numVerticesBefore = submesh.m_FirstVertex;
+        uint numIndicesBefore = submesh.m_FirstIndex;
+        Vertex* vertices = meshData.m_Vertices.data() + numVerticesBefore;
+        uint* indices = meshData.m_Indices.data() + numIndicesBefore;
 
         { // vertices
             bool hasPositions = mesh->HasPositions();
@@ -516,12 +593,9 @@ namespace GfxRenderEngine
             CORE_ASSERT(hasPositions, "no postions found in " + m_Filepath);
             CORE_ASSERT(hasNormals, "no normals found in " + m_Filepath);
 
-            m_FbxNoBuiltInTangents = m_FbxNoBuiltInTangents || (!hasTangents);
-
-            uint vertexIndex = numVerticesBefore;
             for (uint fbxVertexIndex = 0; fbxVertexIndex < numVertices; ++fbxVertexIndex)
             {
-                Vertex& vertex = m_Vertices[vertexIndex];
+                Vertex& vertex = vertices[fbxVertexIndex];
 
                 if (hasPositions)
                 { // position (guaranteed to always be there)
@@ -538,7 +612,12 @@ namespace GfxRenderEngine
                 if (hasTangents) // tangents
                 {
                     aiVector3D& tangentFbx = mesh->mTangents[fbxVertexIndex];
-                    vertex.m_Tangent = glm::vec3(tangentFbx.x, tangentFbx.y, tangentFbx.z);
+                    aiVector3D& bitangentFbx = mesh->mBitangents[fbxVertexIndex];
+                    glm::vec3 tangent{tangentFbx.x, tangentFbx.y, tangentFbx.z};
+                    glm::vec3 bitangent{bitangentFbx.x, bitangentFbx.y, bitangentFbx.z};
+                    // handedness in w, see TangentGenerator
+                    float sign = glm::dot(glm::cross(vertex.m_Normal, tangent), bitangent) < 0.0f ? -1.0f : 1.0f;
+                    vertex.m_Tangent = glm::vec4(tangent, sign);
                 }
 
                 if (hasUVs) // uv coordinates
@@ -563,28 +642,34 @@ namespace GfxRenderEngine
                         vertex.m_Color = m_Materials[materialIndex].m_PbrMaterial.m_DiffuseColor;
                     }
                 }
-                ++vertexIndex;
             }
         }
 
         // Indices
         {
-            uint index = numIndicesBefore;
+            uint index = 0;
             for (uint faceIndex = 0; faceIndex < numFaces; ++faceIndex)
             {
                 const aiFace& face = mesh->mFaces[faceIndex];
-                m_Indices[index + 0] = face.mIndices[0];
-                m_Indices[index + 1] = face.mIndices[1];
-                m_Indices[index + 2] = face.mIndices[2];
+                indices[index + 0] = face.mIndices[0];
+                indices[index + 1] = face.mIndices[1];
+                indices[index + 2] = face.mIndices[2];
                 index += 3;
             }
         }
 
-        // bone indices and bone weights
+        // calculate tangents
+        if (!mesh->HasTangentsAndBitangents())
+        {
+            LOG_CORE_CRITICAL("no tangents in fbx file found, calculating tangents manually");
+            TangentGenerator::Generate(vertices, numVertices, indices, numIndices);
+        }
+
+        // bone indices and bone weights (vertex IDs are relative to the mesh)
         {
             uint numberOfBones = mesh->mNumBones;
             std::vector<uint> numberOfBonesBoundtoVertex;
-            numberOfBonesBoundtoVertex.resize(m_Vertices.size(), 0);
+            numberOfBonesBoundtoVertex.resize(numVertices, 0);
             for (uint boneIndex = 0; boneIndex < numberOfBones; ++boneIndex)
             {
                 aiBone& bone = *mesh->mBones[boneIndex];
@@ -594,25 +679,25 @@ namespace GfxRenderEngine
                 for (uint weightIndex = 0; weightIndex < numberOfWeights; ++weightIndex)
                 {
                     uint vertexId = bone.mWeights[weightIndex].mVertexId;
-                    CORE_ASSERT(vertexId < m_Vertices.size(), "memory violation");
+                    CORE_ASSERT(vertexId < numVertices, "memory violation");
                     float weight = bone.mWeights[weightIndex].mWeight;
                     switch (numberOfBonesBoundtoVertex[vertexId])
                     {
                         case 0:
-                            m_Vertices[vertexId].m_JointIds.x = boneIndex;
-                            m_Vertices[vertexId].m_Weights.x = weight;
+                            vertices[vertexId].m_JointIds.x = boneIndex;
+                            vertices[vertexId].m_Weights.x = weight;
                             break;
                         case 1:
-                            m_Vertices[vertexId].m_JointIds.y = boneIndex;
-                            m_Vertices[vertexId].m_Weights.y = weight;
+                            vertices[vertexId].m_JointIds.y = boneIndex;
+                            vertices[vertexId].m_Weights.y = weight;
                             break;
                         case 2:
-                            m_Vertices[vertexId].m_JointIds.z = boneIndex;
-                            m_Vertices[vertexId].m_Weights.z = weight;
+                            vertices[vertexId].m_JointIds.z = boneIndex;
+                            vertices[vertexId].m_Weights.z = weight;
                             break;
                         case 3:
-                            m_Vertices[vertexId].m_JointIds.w = boneIndex;
-                            m_Vertices[vertexId].m_Weights.w = weight;
+                            vertices[vertexId].m_JointIds.w = boneIndex;
+                            vertices[vertexId].m_Weights.w = weight;
                             break;
                         default:
                             break;
@@ -623,14 +708,14 @@ namespace GfxRenderEngine
                 }
             }
             // normalize weights
-            for (uint vertexIndex = 0; vertexIndex < m_Vertices.size(); ++vertexIndex)
+            for (uint vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
             {
-                glm::vec4& boneWeights = m_Vertices[vertexIndex].m_Weights;
+                glm::vec4& boneWeights = vertices[vertexIndex].m_Weights;
                 float weightSum = boneWeights.x + boneWeights.y + boneWeights.z + boneWeights.w;
                 if (weightSum > std::numeric_limits<float>::epsilon())
                 {
-                    m_Vertices[vertexIndex].m_Weights = glm::vec4(boneWeights.x / weightSum, boneWeights.y / weightSum,
-                                                                  boneWeights.z / weightSum, boneWeights.w / weightSum);
+                    vertices[vertexIndex].m_Weights = glm::vec4(boneWeights.x / weightSum, boneWeights.y / weightSum,
+                                                                boneWeights.z / weightSum, boneWeights.w / weightSum);
                 }
             }
         }
@@ -697,106 +782,6 @@ namespace GfxRenderEngine
         LOG_CORE_INFO("material assigned (fastgltf): material index {0}", materialIndex);
     }
 
-    void FbxBuilder::CalculateTangents()
-    {
-        if (m_Indices.size())
-        {
-            CalculateTangentsFromIndexBuffer(m_Indices);
-        }
-        else
-        {
-            uint vertexCount = m_Vertices.size();
-            if (vertexCount)
-            {
-                std::vector<uint> indices;
-                indices.resize(vertexCount);
-                for (uint i = 0; i < vertexCount; i++)
-                {
-                    indices[i] = i;
-                }
-                CalculateTangentsFromIndexBuffer(indices);
-            }
-        }
-    }
-
-    void FbxBuilder::CalculateTangentsFromIndexBuffer(const std::vector<uint>& indices)
-    {
-        uint cnt = 0;
-        uint vertexIndex1 = 0;
-        uint vertexIndex2 = 0;
-        uint vertexIndex3 = 0;
-        glm::vec3 position1 = glm::vec3{0.0f};
-        glm::vec3 position2 = glm::vec3{0.0f};
-        glm::vec3 position3 = glm::vec3{0.0f};
-        glm::vec2 uv1 = glm::vec2{0.0f};
-        glm::vec2 uv2 = glm::vec2{0.0f};
-        glm::vec2 uv3 = glm::vec2{0.0f};
-
-        for (uint index : indices)
-        {
-            auto& vertex = m_Vertices[index];
-
-            switch (cnt)
-            {
-                case 0:
-                    position1 = vertex.m_Position;
-                    uv1 = vertex.m_UV;
-                    vertexIndex1 = index;
-                    break;
-                case 1:
-                    position2 = vertex.m_Position;
-                    uv2 = vertex.m_UV;
-                    vertexIndex2 = index;
-                    break;
-                case 2:
-                    position3 = vertex.m_Position;
-                    uv3 = vertex.m_UV;
-                    vertexIndex3 = index;
-
-                    glm::vec3 edge1 = position2 - position1;
-                    glm::vec3 edge2 = position3 - position1;
-                    glm::vec2 deltaUV1 = uv2 - uv1;
-                    glm::vec2 deltaUV2 = uv3 - uv1;
-
-                    float dU1 = deltaUV1.x;
-                    float dU2 = deltaUV2.x;
-                    float dV1 = deltaUV1.y;
-                    float dV2 = deltaUV2.y;
-                    float E1x = edge1.x;
-                    float E2x = edge2.x;
-                    float E1y = edge1.y;
-                    float E2y = edge2.y;
-                    float E1z = edge1.z;
-                    float E2z = edge2.z;
-
-                    float factor;
-                    if ((dU1 * dV2 - dU2 * dV1) > std::numeric_limits<float>::epsilon())
-                    {
-                        factor = 1.0f / (dU1 * dV2 - dU2 * dV1);
-                    }
-                    else
-                    {
-                        factor = 100000.0f;
-                    }
-
-                    glm::vec3 tangent;
-
-                    tangent.x = factor * (dV2 * E1x - dV1 * E2x);
-                    tangent.y = factor * (dV2 * E1y - dV1 * E2y);
-                    tangent.z = factor * (dV2 * E1z - dV1 * E2z);
-                    if (tangent.x == 0.0f && tangent.y == 0.0f && tangent.z == 0.0f)
-                        tangent = glm::vec3(1.0f, 0.0f, 0.0f);
-
-                    m_Vertices[vertexIndex1].m_Tangent = tangent;
-                    m_Vertices[vertexIndex2].m_Tangent = tangent;
-                    m_Vertices[vertexIndex3].m_Tangent = tangent;
-
-                    break;
-            }
-            cnt = (cnt + 1) % 3;
-        }
-    }
-
     void FbxBuilder::SetDictionaryPrefix(std::string const& dictionaryPrefix) { m_DictionaryPrefix = dictionaryPrefix; }
 
     void FbxBuilder::PrintMaps(const aiMaterial* fbxMaterial)
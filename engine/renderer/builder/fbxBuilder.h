@@ -25,6 +25,7 @@
 #include "assimp/scene.h"
 
 #include "renderer/model.h"
+#include "renderer/builder/texturePrefetcher.h"
 #include "scene/fbx.h"
 #include "scene/scene.h"
 
@@ -47,12 +48,22 @@ namespace GfxRenderEngine
         std::vector<Submesh> m_Submeshes{};
 
     private:
-        void LoadVertexData(const aiNode* fbxNodePtr, int vertexColorSet = 0, uint uvSet = 0);
-        void LoadVertexData(const aiNode* fbxNodePtr, uint const meshIndex, uint const fbxMeshIndex, int vertexColorSet = 0,
+        // vertex data of a node, extracted for all nodes before the scene graph is built
+        struct MeshData
+        {
+            std::vector<Vertex> m_Vertices;
+            std::vector<uint> m_Indices;
+            std::vector<Submesh> m_Submeshes;
+        };
+
+        void LoadVertexData(int vertexColorSet = 0, uint uvSet = 0);
+        void LoadVertexData(MeshData& meshData, uint const meshIndex, uint const fbxMeshIndex, int vertexColorSet = 0,
                             uint uvSet = 0);
 
         void LoadMaterials();
-        std::shared_ptr<Texture> LoadTexture(std::string const& filepath, bool useSRGB);
+        void PrefetchTextures();
+        std::shared_ptr<Texture> LoadTexture(std::string const& filepath, bool useSRGB,
+                                             Texture::Usage usage = Texture::USAGE_COLOR);
         void LoadProperties(const aiMaterial* fbxMaterial, Material::PbrMaterial& pbrMaterial);
         void LoadMap(const aiMaterial* fbxMaterial, aiTextureType textureType, int materialIndex);
         void AssignMaterial(Submesh& submesh, int const materialIndex);
@@ -63,9 +74,6 @@ namespace GfxRenderEngine
         void ProcessNode(const aiNode* fbxNodePtr, uint const parentNode, uint& hasMeshIndex);
         uint CreateGameObject(const aiNode* fbxNodePtr, uint const parentNode);
 
-        void CalculateTangentsFromIndexBuffer(const std::vector<uint>& indices);
-        void CalculateTangents();
-
     private:
         std::string m_Filepath;
         std::string m_Basepath;
@@ -74,7 +82,8 @@ namespace GfxRenderEngine
         std::vector<Material> m_Materials;
         std::vector<std::shared_ptr<Texture>> m_Textures;
         std::vector<Material::MaterialTextures> m_MaterialTextures{};
-        bool m_FbxNoBuiltInTangents;
+        TexturePrefetcher m_TexturePrefetcher;
+        std::unordered_map<const aiNode*, MeshData> m_MeshData;
         std::shared_ptr<Model> m_Model;
         std::shared_ptr<InstanceBuffer> m_InstanceBuffer;
         std::vector<entt::entity> m_InstancedObjects;
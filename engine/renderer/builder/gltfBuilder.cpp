@@ -26,6 +26,8 @@
 #include "core.h"
 #include "renderer/instanceBuffer.h"
 #include "renderer/builder/gltfBuilder.h"
+#include "renderer/builder/tangentGenerator.h"
+#include "renderer/builder/lodGenerator.h"
 #include "renderer/materialDescriptor.h"
 #include "auxiliary/instrumentation.h"
 #include "auxiliary/file.h"
@@ -91,6 +93,7 @@ namespace GfxRenderEngine
         LoadTextures();
         LoadSkeletonsGltf();
         LoadMaterials();
+        LoadLodNodes();
 
         // PASS 1
         // mark gltf nodes to receive a game object ID if they have a mesh or any child has
@@ -190,6 +193,10 @@ namespace GfxRenderEngine
 
     void GltfBuilder::ProcessNode(tinygltf::Scene& scene, int const gltfNodeIndex, uint const parentNode)
     {
+        if (m_IsLodNode[gltfNodeIndex])
+        {
+            return; // a level of detail of another node, loaded with it
+        }
         auto& node = m_GltfModel.nodes[gltfNodeIndex];
         auto& nodeName = node.name;
         auto meshIndex = node.mesh;
@@ -261,16 +268,24 @@ namespace GfxRenderEngine
             instanceTag.m_Instances.push_back(entity);
             m_InstanceBuffer = InstanceBuffer::Create(m_InstanceCount);
             instanceTag.m_InstanceBuffer = m_InstanceBuffer;
-            instanceTag.m_InstanceBuffer->SetInstanceData(m_InstanceIndex, transform.GetMat4Global(),
-                                                          transform.GetNormalMatrix());
+            instanceTag.m_InstanceBuffer->SetInstanceData(m_InstanceIndex, transform.GetMat4Global());
             m_Registry.emplace<InstanceTag>(entity, instanceTag);
             transform.SetInstance(m_InstanceBuffer, m_InstanceIndex);
             m_InstancedObjects.push_back(entity);
 
             // create model for 1st instance
-            LoadVertexData(meshIndex);
-            LOG_CORE_INFO("Vertex count: {0}, Index count: {1} (file: {2}, node: {3})", m_Vertices.size(), m_Indices.size(),
-                          m_Filepath, nodeName);
+            if (LoadSharedGeometry(meshIndex))
+            {
+                LOG_CORE_INFO("shared geometry, vertex count: {0}, index count: {1} (file: {2}, node: {3})",
+                              m_Geometry->m_VertexCount, m_Geometry->m_IndexCount, m_Filepath, nodeName);
+            }
+            else
+            {
+                LoadVertexData(meshIndex);
+                LoadLods(gltfNodeIndex, meshIndex);
+                LOG_CORE_INFO("Vertex count: {0}, Index count: {1} (file: {2}, node: {3})", m_Vertices.size(),
+                              m_Indices.size(), m_Filepath, nodeName);
+            }
             { // assign material
                 uint primitiveIndex = 0;
                 for (const auto& glTFPrimitive : m_GltfModel.meshes[meshIndex].primitives)
@@ -301,8 +316,7 @@ namespace GfxRenderEngine
             entt::entity instance = m_InstancedObjects[m_RenderObject++];
             InstanceTag& instanceTag = m_Registry.get<InstanceTag>(instance);
             instanceTag.m_Instances.push_back(entity);
-            instanceTag.m_InstanceBuffer->SetInstanceData(m_InstanceIndex, transform.GetMat4Global(),
-                                                          transform.GetNormalMatrix());
+            instanceTag.m_InstanceBuffer->SetInstanceData(m_InstanceIndex, transform.GetMat4Global());
             transform.SetInstance(instanceTag.m_InstanceBuffer, m_InstanceIndex);
         }
 
@@ -426,10 +440,11 @@ namespace GfxRenderEngine
             // three channels per pixel need to be converted to four channels per pixel
             uchar* buffer;
             uint64 bufferSize;
+            std::vector<uchar> imageData;
             if (glTFImage.component == 3)
             {
                 bufferSize = glTFImage.width * glTFImage.height * 4;
-                std::vector<uchar> imageData(bufferSize, 0x00);
+                imageData.resize(bufferSize, 0x00);
 
                 buffer = (uchar*)imageData.data();
                 uchar* rgba = buffer;
@@ -447,14 +462,28 @@ namespace GfxRenderEngine
                 bufferSize = glTFImage.image.size();
             }
 
-            auto texture = Texture::Create();
             int minFilter = GetMinFilter(imageIndex);
             int magFilter = GetMinFilter(imageIndex);
             bool imageFormat = GetImageFormat(imageIndex);
-            texture->Init(glTFImage.width, glTFImage.height, imageFormat, buffer, minFilter, magFilter);
+            auto loader = [&]() -> std::shared_ptr<Texture>
+            {
+                auto texture = Texture::Create();
+                if (!texture->Init(glTFImage.width, glTFImage.height, imageFormat, buffer, minFilter, magFilter))
+                {
+                    return nullptr;
+                }
 #ifdef DEBUG
-            texture->SetFilename(imageFilepath);
+                texture->SetFilename(imageFilepath);
 #endif
+                return texture;
+            };
+            // identical images embedded in different glTF files share one texture
+            auto key = TextureCache::MakeContentKey(buffer, bufferSize, imageFormat, minFilter, magFilter);
+            auto texture = Engine::m_Engine->m_TextureCache.Get(key, loader);
+            if (!texture)
+            {
+                LOG_CORE_CRITICAL("GltfBuilder::LoadTextures(): couldn't create texture {0}", imageFilepath);
+            }
             m_Textures[imageIndex] = texture;
         }
     }
@@ -615,6 +644,8 @@ namespace GfxRenderEngine
                 diffuseColor = m_Materials[materialIndex].m_PbrMaterial.m_DiffuseColor;
             }
 
+            bool calculateTangents = false;
+
             // Vertices
             {
                 const float* positionBuffer = nullptr;
@@ -705,7 +736,7 @@ namespace GfxRenderEngine
 
                     // tangent
                     glm::vec4 t = tangentsBuffer ? glm::make_vec4(&tangentsBuffer[vertexIterator * 4]) : glm::vec4(0.0f);
-                    vertex.m_Tangent = glm::vec3(t.x, t.y, t.z) * t.w;
+                    vertex.m_Tangent = t;
 
                     // joint indices and joint weights
                     if (jointsBuffer && weightsBuffer)
@@ -737,11 +768,7 @@ namespace GfxRenderEngine
                     ++vertexIndex;
                 }
 
-                // calculate tangents
-                if (!tangentsBuffer)
-                {
-                    CalculateTangents();
-                }
+                calculateTangents = !tangentsBuffer;
             }
             // Indices
             {
@@ -789,11 +816,118 @@ namespace GfxRenderEngine
                 }
             }
 
+            // calculate tangents
+            if (calculateTangents)
+            {
+                TangentGenerator::Generate(m_Vertices.data() + submesh.m_FirstVertex, static_cast<uint>(vertexCount),
+                                           m_Indices.data() + submesh.m_FirstIndex, static_cast<uint>(indexCount));
+            }
+
             submesh.m_VertexCount = vertexCount;
             submesh.m_IndexCount = indexCount;
         }
     }
 
+    bool GltfBuilder::LoadSharedGeometry(uint const meshIndex)
+    {
+        m_GeometryKey = AssetRegistry::MakeKey(m_Filepath, AssetRegistry::IMPORTER_GLTF, meshIndex);
+        m_Geometry = Engine::m_Engine->m_AssetRegistry.Find(m_GeometryKey);
+        if (!m_Geometry)
+        {
+            // the model uploads the vertex data and registers it
+            m_Geometry = std::make_shared<MeshGeometry>();
+            m_Geometry->m_Name = m_Filepath + "::" + std::to_string(meshIndex);
+            return false;
+        }
+
+        m_Vertices.clear();
+        m_Indices.clear();
+        m_Submeshes.clear();
+        m_Submeshes.resize(m_Geometry->m_Ranges.size());
+        for (size_t submeshIndex = 0; submeshIndex < m_Submeshes.size(); ++submeshIndex)
+        {
+            Submesh& submesh = m_Submeshes[submeshIndex];
+            MeshGeometry::Range const& range = m_Geometry->m_Ranges[submeshIndex];
+            submesh.m_FirstIndex = range.m_FirstIndex;
+            submesh.m_FirstVertex = range.m_FirstVertex;
+            submesh.m_IndexCount = range.m_IndexCount;
+            submesh.m_VertexCount = range.m_VertexCount;
+            submesh.m_InstanceCount = m_InstanceCount;
+            submesh.m_Lods = range.m_Lods;
+        }
+        return true;
+    }
+
+    void GltfBuilder::LoadLodNodes()
+    {
+        // MSFT_lod lists the coarser nodes of a node in its extensions
+        m_LodNodes.clear();
+        m_IsLodNode.assign(m_GltfModel.nodes.size(), false);
+        for (size_t nodeIndex = 0; nodeIndex < m_GltfModel.nodes.size(); ++nodeIndex)
+        {
+            auto& extensions = m_GltfModel.nodes[nodeIndex].extensions;
+            auto extension = extensions.find("MSFT_lod");
+            if ((extension == extensions.end()) || !extension->second.Has("ids"))
+            {
+                continue;
+            }
+            tinygltf::Value const& ids = extension->second.Get("ids");
+            for (size_t index = 0; index < ids.ArrayLen(); ++index)
+            {
+                int lodNodeIndex = ids.Get(index).GetNumberAsInt();
+                if ((lodNodeIndex >= 0) && (static_cast<size_t>(lodNodeIndex) < m_GltfModel.nodes.size()))
+                {
+                    m_LodNodes[static_cast<int>(nodeIndex)].push_back(lodNodeIndex);
+                    m_IsLodNode[lodNodeIndex] = true;
+                }
+            }
+        }
+    }
+
+    void GltfBuilder::LoadLods(int const gltfNodeIndex, uint const meshIndex)
+    {
+        auto lodNodes = m_LodNodes.find(gltfNodeIndex);
+        if (lodNodes != m_LodNodes.end())
+        {
+            // authored levels: the primitives of the coarser meshes are matched by material
+            std::vector<Vertex> vertices = std::move(m_Vertices);
+            std::vector<uint> indices = std::move(m_Indices);
+            std::vector<Submesh> submeshes = std::move(m_Submeshes);
+            auto& primitives = m_GltfModel.meshes[meshIndex].primitives;
+            for (int lodNodeIndex : lodNodes->second)
+            {
+                int lodMeshIndex = m_GltfModel.nodes[lodNodeIndex].mesh;
+                if (lodMeshIndex == Gltf::GLTF_NOT_USED)
+                {
+                    continue;
+                }
+                auto& lodPrimitives = m_GltfModel.meshes[lodMeshIndex].primitives;
+                LoadVertexData(lodMeshIndex);
+                for (size_t primitiveIndex = 0; primitiveIndex < primitives.size(); ++primitiveIndex)
+                {
+                    size_t lodPrimitiveIndex = primitiveIndex;
+                    for (size_t candidate = 0; candidate < lodPrimitives.size(); ++candidate)
+                    {
+                        if (lodPrimitives[candidate].material == primitives[primitiveIndex].material)
+                        {
+                            lodPrimitiveIndex = candidate;
+                            break;
+                        }
+                    }
+                    if (lodPrimitiveIndex < lodPrimitives.size())
+                    {
+                        LodGenerator::AppendLevel(vertices, indices, submeshes[primitiveIndex], m_Vertices, m_Indices,
+                                                  m_Submeshes[lodPrimitiveIndex]);
+                    }
+                }
+            }
+            m_Vertices = std::move(vertices);
+            m_Indices = std::move(indices);
+            m_Submeshes = std::move(submeshes);
+        }
+        LodGenerator::Generate(m_Vertices, m_Indices, m_Submeshes);
+    }
+
     void GltfBuilder::LoadTransformationMatrix(TransformComponent& transform, int const gltfNodeIndex)
     {
         auto& node = m_GltfModel.nodes[gltfNodeIndex];
@@ -860,105 +994,6 @@ namespace GfxRenderEngine
         LOG_CORE_INFO("material assigned (tinygltf): material index {0}", materialIndex);
     }
 
-    void GltfBuilder::CalculateTangents()
-    {
-        if (m_Indices.size())
-        {
-            CalculateTangentsFromIndexBuffer(m_Indices);
-        }
-        else
-        {
-            uint vertexCount = m_Vertices.size();
-            if (vertexCount)
-            {
-                std::vector<uint> indices;
-                indices.resize(vertexCount);
-                for (uint i = 0; i < vertexCount; i++)
-                {
-                    indices[i] = i;
-                }
-                CalculateTangentsFromIndexBuffer(indices);
-            }
-        }
-    }
-
     void GltfBuilder::SetDictionaryPrefix(std::string const& dictionaryPrefix) { m_DictionaryPrefix = dictionaryPrefix; }
 
-    void GltfBuilder::CalculateTangentsFromIndexBuffer(const std::vector<uint>& indices)
-    {
-        uint cnt = 0;
-        uint vertexIndex1 = 0;
-        uint vertexIndex2 = 0;
-        uint vertexIndex3 = 0;
-        glm::vec3 position1 = glm::vec3{0.0f};
-        glm::vec3 position2 = glm::vec3{0.0f};
-        glm::vec3 position3 = glm::vec3{0.0f};
-        glm::vec2 uv1 = glm::vec2{0.0f};
-        glm::vec2 uv2 = glm::vec2{0.0f};
-        glm::vec2 uv3 = glm::vec2{0.0f};
-
-        for (uint index : indices)
-        {
-            auto& vertex = m_Vertices[index];
-
-            switch (cnt)
-            {
-                case 0:
-                    position1 = vertex.m_Position;
-                    uv1 = vertex.m_UV;
-                    vertexIndex1 = index;
-                    break;
-                case 1:
-                    position2 = vertex.m_Position;
-                    uv2 = vertex.m_UV;
-                    vertexIndex2 = index;
-                    break;
-                case 2:
-                    position3 = vertex.m_Position;
-                    uv3 = vertex.m_UV;
-                    vertexIndex3 = index;
-
-                    glm::vec3 edge1 = position2 - position1;
-                    glm::vec3 edge2 = position3 - position1;
-                    glm::vec2 deltaUV1 = uv2 - uv1;
-                    glm::vec2 deltaUV2 = uv3 - uv1;
-
-                    float dU1 = deltaUV1.x;
-                    float dU2 = deltaUV2.x;
-                    float dV1 = deltaUV1.y;
-                    float dV2 = deltaUV2.y;
-                    float E1x = edge1.x;
-                    float E2x = edge2.x;
-                    float E1y = edge1.y;
-                    float E2y = edge2.y;
-                    float E1z = edge1.z;
-                    float E2z = edge2.z;
-
-                    float factor;
-                    if ((dU1 * dV2 - dU2 * dV1) > std::numeric_limits<float>::epsilon())
-                    {
-                        factor = 1.0f / (dU1 * dV2 - dU2 * dV1);
-                    }
-                    else
-                    {
-                        factor = 100000.0f;
-                    }
-
-                    glm::vec3 tangent;
-
-                    tangent.x = factor * (dV2 * E1x - dV1 * E2x);
-                    tangent.y = factor * (dV2 * E1y - dV1 * E2y);
-                    tangent.z = factor * (dV2 * E1z - dV1 * E2z);
-                    if (tangent.x == 0.0f && tangent.y == 0.0f && tangent.z == 0.0f)
-                        tangent = glm::vec3(1.0f, 0.0f, 0.0f);
-
-                    m_Vertices[vertexIndex1].m_Tangent = tangent;
-                    m_Vertices[vertexIndex2].m_Tangent = tangent;
-                    m_Vertices[vertexIndex3].m_Tangent = tangent;
-
-                    break;
-            }
-            cnt = (cnt + 1) % 3;
-        }
-    }
 } // namespace GfxRenderEngine
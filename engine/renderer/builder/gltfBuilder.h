@@ -23,6 +23,7 @@
 #pragma once
 
 #include "renderer/model.h"
+#include "renderer/assetRegistry.h"
 #include "scene/gltf.h"
 #include "scene/scene.h"
 
@@ -44,15 +45,20 @@ namespace GfxRenderEngine
         std::vector<Vertex> m_Vertices{};
         std::vector<Submesh> m_Submeshes{};
 
+        // GPU geometry of the current mesh, shared across scenes (see AssetRegistry)
+        AssetRegistry::Key m_GeometryKey{};
+        std::shared_ptr<MeshGeometry> m_Geometry;
+
     private:
         void LoadTextures();
         void LoadMaterials();
         void LoadVertexData(uint const meshIndex);
+        bool LoadSharedGeometry(uint const meshIndex);
+        void LoadLodNodes();
+        void LoadLods(int const gltfNodeIndex, uint const meshIndex);
         bool GetImageFormat(uint const imageIndex);
         void AssignMaterial(Submesh& submesh, int const materialIndex);
         void LoadTransformationMatrix(TransformComponent& transform, int const gltfNodeIndex);
-        void CalculateTangents();
-        void CalculateTangentsFromIndexBuffer(const std::vector<uint>& indices);
 
         bool MarkNode(tinygltf::Scene& scene, int const gltfNodeIndex);
         void ProcessScene(tinygltf::Scene& scene, uint const parentNode);
@@ -97,6 +103,10 @@ namespace GfxRenderEngine
         std::vector<bool> m_HasMesh;
         entt::entity m_GameObject;
 
+        // levels of detail (MSFT_lod): the coarser nodes of a node, they are not part of the scene graph
+        std::unordered_map<int, std::vector<int>> m_LodNodes;
+        std::vector<bool> m_IsLodNode;
+
         std::vector<entt::entity> m_InstancedObjects;
         std::shared_ptr<InstanceBuffer> m_InstanceBuffer;
         uint m_RenderObject;
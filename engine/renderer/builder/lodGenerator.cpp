@@ -0,0 +1,567 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <tuple>
+
+#include "core.h"
+#include "renderer/model.h"
+#include "renderer/builder/lodGenerator.h"
+#include "auxiliary/instrumentation.h"
+
+namespace GfxRenderEngine
+{
+    namespace
+    {
+        constexpr uint MIN_LEVEL_TRIANGLES = 64;
+        constexpr uint MAX_PASSES = 16;            // per level, each pass collapses independent edges
+        constexpr float MIN_REDUCTION = 0.85f;     // a level with more indices than that is not worth it
+        constexpr float ATTRIBUTE_WEIGHT = 0.25f;  // normal and UV penalty, relative to the squared edge length
+        constexpr float MIN_NORMAL_COSINE = 0.25f; // collapses may not turn a triangle by more than ~75 degrees
+        constexpr uint MAX_ERROR_SAMPLES = 4096;
+        constexpr uint NO_VERTEX = std::numeric_limits<uint>::max();
+
+        // sum of squared plane distances as a symmetric 4x4 matrix, weighted by triangle area
+        struct Quadric
+        {
+            double m_A2{0.0}, m_AB{0.0}, m_AC{0.0}, m_AD{0.0};
+            double m_B2{0.0}, m_BC{0.0}, m_BD{0.0};
+            double m_C2{0.0}, m_CD{0.0};
+            double m_D2{0.0};
+            double m_Weight{0.0};
+
+            void AddPlane(glm::dvec3 const& normal, double distance, double weight)
+            {
+                double a = normal.x;
+                double b = normal.y;
+                double c = normal.z;
+                double d = distance;
+                m_A2 += weight * a * a;
+                m_AB += weight * a * b;
+                m_AC += weight * a * c;
+                m_AD += weight * a * d;
+                m_B2 += weight * b * b;
+                m_BC += weight * b * c;
+                m_BD += weight * b * d;
+                m_C2 += weight * c * c;
+                m_CD += weight * c * d;
+                m_D2 += weight * d * d;
+                m_Weight += weight;
+            }
+
+            void Add(Quadric const& other)
+            {
+                m_A2 += other.m_A2;
+                m_AB += other.m_AB;
+                m_AC += other.m_AC;
+                m_AD += other.m_AD;
+                m_B2 += other.m_B2;
+                m_BC += other.m_BC;
+                m_BD += other.m_BD;
+                m_C2 += other.m_C2;
+                m_CD += other.m_CD;
+                m_D2 += other.m_D2;
+                m_Weight += other.m_Weight;
+            }
+
+            // mean squared distance of 'point' to the planes
+            double Evaluate(glm::vec3 const& point) const
+            {
+                double x = point.x;
+                double y = point.y;
+                double z = point.z;
+                double error = m_A2 * x * x + 2.0 * m_AB * x * y + 2.0 * m_AC * x * z + 2.0 * m_AD * x + m_B2 * y * y +
+                               2.0 * m_BC * y * z + 2.0 * m_BD * y + m_C2 * z * z + 2.0 * m_CD * z + m_D2;
+                return m_Weight > 0.0 ? std::max(error, 0.0) / m_Weight : 0.0;
+            }
+        };
+
+        struct Collapse
+        {
+            uint m_Source;
+            uint m_Target;
+            float m_Cost;
+        };
+
+        // the state of a submesh across its levels
+        struct Simplification
+        {
+            Vertex const* m_Vertices;
+            uint m_VertexCount;
+            std::vector<uint> m_PositionIds; // per vertex, vertices with the same position share a quadric
+            std::vector<Quadric> m_Quadrics; // per position
+            std::vector<bool> m_Locked;      // per position, on an open border or an attribute seam
+            std::vector<uint> m_Indices;     // the current level
+            float m_MaxCost{0.0f};
+        };
+
+        uint64 EdgeKey(uint position0, uint position1)
+        {
+            return (static_cast<uint64>(std::min(position0, position1)) << 32) | std::max(position0, position1);
+        }
+
+        float CollapseCost(Simplification const& simplification, uint source, uint target)
+        {
+            Vertex const& sourceVertex = simplification.m_Vertices[source];
+            Vertex const& targetVertex = simplification.m_Vertices[target];
+
+            Quadric quadric = simplification.m_Quadrics[simplification.m_PositionIds[source]];
+            quadric.Add(simplification.m_Quadrics[simplification.m_PositionIds[target]]);
+            float cost = static_cast<float>(quadric.Evaluate(targetVertex.m_Position));
+
+            glm::vec3 edge = targetVertex.m_Position - sourceVertex.m_Position;
+            glm::vec3 normalDifference = targetVertex.m_Normal - sourceVertex.m_Normal;
+            glm::vec2 uvDifference = targetVertex.m_UV - sourceVertex.m_UV;
+            float attributeDifference = glm::dot(normalDifference, normalDifference) + glm::dot(uvDifference, uvDifference);
+            return cost + ATTRIBUTE_WEIGHT * attributeDifference * glm::dot(edge, edge);
+        }
+
+        // true if moving 'source' onto 'target' turns one of the remaining triangles around 'source' over
+        bool Flips(Simplification const& simplification, uint const* triangles, uint triangleCount, uint source,
+                   uint target)
+        {
+            Vertex const* vertices = simplification.m_Vertices;
+            for (uint index = 0; index < triangleCount; ++index)
+            {
+                uint const* corners = &simplification.m_Indices[triangles[index] * 3];
+                if ((corners[0] == target) || (corners[1] == target) || (corners[2] == target))
+                {
+                    continue; // collapses into a line and is removed
+                }
+                glm::vec3 positions[3];
+                glm::vec3 movedPositions[3];
+                for (uint corner = 0; corner < 3; ++corner)
+                {
+                    positions[corner] = vertices[corners[corner]].m_Position;
+                    movedPositions[corner] = (corners[corner] == source) ? vertices[target].m_Position : positions[corner];
+                }
+                glm::vec3 before = glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+                glm::vec3 after = glm::cross(movedPositions[1] - movedPositions[0], movedPositions[2] - movedPositions[0]);
+                float lengthBefore = glm::length(before);
+                if (lengthBefore == 0.0f)
+                {
+                    continue;
+                }
+                if (glm::dot(before, after) <= MIN_NORMAL_COSINE * lengthBefore * glm::length(after))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // one pass of independent collapses, cheapest first
+        // a collapse blocks the vertices of all triangles around its source for the rest of the pass,
+        // so the adjacency and the flip tests of the remaining collapses stay valid
+        uint CollapseEdges(Simplification& simplification, size_t targetIndexCount)
+        {
+            std::vector<uint>& indices = simplification.m_Indices;
+            std::vector<uint> const& positionIds = simplification.m_PositionIds;
+            uint vertexCount = simplification.m_VertexCount;
+
+            // triangles around each vertex
+            std::vector<uint> firstTriangle(vertexCount + 1, 0);
+            for (uint index : indices)
+            {
+                ++firstTriangle[index + 1];
+            }
+            for (uint vertex = 0; vertex < vertexCount; ++vertex)
+            {
+                firstTriangle[vertex + 1] += firstTriangle[vertex];
+            }
+            std::vector<uint> triangles(indices.size());
+            {
+                std::vector<uint> nextTriangle(firstTriangle.begin(), firstTriangle.end() - 1);
+                for (size_t corner = 0; corner < indices.size(); ++corner)
+                {
+                    triangles[nextTriangle[indices[corner]]++] = static_cast<uint>(corner / 3);
+                }
+            }
+
+            // the cheapest collapse of each vertex
+            std::vector<float> bestCost(vertexCount, std::numeric_limits<float>::max());
+            std::vector<uint> bestTarget(vertexCount, NO_VERTEX);
+            auto evaluate = [&](uint source, uint target)
+            {
+                if (simplification.m_Locked[positionIds[source]] || (positionIds[source] == positionIds[target]))
+                {
+                    return;
+                }
+                float cost = CollapseCost(simplification, source, target);
+                if (cost < bestCost[source])
+                {
+                    bestCost[source] = cost;
+                    bestTarget[source] = target;
+                }
+            };
+            for (size_t corner = 0; corner < indices.size(); corner += 3)
+            {
+                for (uint edge = 0; edge < 3; ++edge)
+                {
+                    uint vertex0 = indices[corner + edge];
+                    uint vertex1 = indices[corner + (edge + 1) % 3];
+                    evaluate(vertex0, vertex1);
+                    evaluate(vertex1, vertex0);
+                }
+            }
+            std::vector<Collapse> collapses;
+            for (uint vertex = 0; vertex < vertexCount; ++vertex)
+            {
+                if (bestTarget[vertex] != NO_VERTEX)
+                {
+                    collapses.push_back({vertex, bestTarget[vertex], bestCost[vertex]});
+                }
+            }
+            std::sort(collapses.begin(), collapses.end(),
+                      [](Collapse const& lhs, Collapse const& rhs) { return lhs.m_Cost < rhs.m_Cost; });
+
+            // a collapse removes about two triangles
+            size_t maxCollapses = (indices.size() - targetIndexCount) / 6 + 1;
+            std::vector<bool> blocked(vertexCount, false);
+            std::vector<uint> remap(vertexCount);
+            std::iota(remap.begin(), remap.end(), 0);
+            uint collapsed = 0;
+            for (auto const& collapse : collapses)
+            {
+                uint source = collapse.m_Source;
+                uint target = collapse.m_Target;
+                uint const* sourceTriangles = triangles.data() + firstTriangle[source];
+                uint sourceTriangleCount = firstTriangle[source + 1] - firstTriangle[source];
+                if (blocked[source] || blocked[target] ||
+                    Flips(simplification, sourceTriangles, sourceTriangleCount, source, target))
+                {
+                    continue;
+                }
+
+                remap[source] = target;
+                simplification.m_Quadrics[positionIds[target]].Add(simplification.m_Quadrics[positionIds[source]]);
+                simplification.m_MaxCost = std::max(simplification.m_MaxCost, collapse.m_Cost);
+                for (uint index = 0; index < sourceTriangleCount; ++index)
+                {
+                    for (uint corner = 0; corner < 3; ++corner)
+                    {
+                        blocked[indices[sourceTriangles[index] * 3 + corner]] = true;
+                    }
+                }
+                if (++collapsed == maxCollapses)
+                {
+                    break;
+                }
+            }
+
+            // remap and remove the triangles that collapsed into lines
+            size_t indexCount = 0;
+            for (size_t corner = 0; corner < indices.size(); corner += 3)
+            {
+                uint vertex0 = remap[indices[corner + 0]];
+                uint vertex1 = remap[indices[corner + 1]];
+                uint vertex2 = remap[indices[corner + 2]];
+                if ((vertex0 == vertex1) || (vertex1 == vertex2) || (vertex2 == vertex0))
+                {
+                    continue;
+                }
+                indices[indexCount++] = vertex0;
+                indices[indexCount++] = vertex1;
+                indices[indexCount++] = vertex2;
+            }
+            indices.resize(indexCount);
+            return collapsed;
+        }
+
+        // Ericson, Real-Time Collision Detection, 5.1.5
+        glm::vec3 ClosestPointOnTriangle(glm::vec3 const& point, glm::vec3 const& a, glm::vec3 const& b,
+                                         glm::vec3 const& c)
+        {
+            glm::vec3 ab = b - a;
+            glm::vec3 ac = c - a;
+            glm::vec3 ap = point - a;
+            float d1 = glm::dot(ab, ap);
+            float d2 = glm::dot(ac, ap);
+            if ((d1 <= 0.0f) && (d2 <= 0.0f))
+            {
+                return a;
+            }
+            glm::vec3 bp = point - b;
+            float d3 = glm::dot(ab, bp);
+            float d4 = glm::dot(ac, bp);
+            if ((d3 >= 0.0f) && (d4 <= d3))
+            {
+                return b;
+            }
+            float vc = d1 * d4 - d3 * d2;
+            if ((vc <= 0.0f) && (d1 >= 0.0f) && (d3 <= 0.0f))
+            {
+                return a + ab * (d1 / (d1 - d3));
+            }
+            glm::vec3 cp = point - c;
+            float d5 = glm::dot(ab, cp);
+            float d6 = glm::dot(ac, cp);
+            if ((d6 >= 0.0f) && (d5 <= d6))
+            {
+                return c;
+            }
+            float vb = d5 * d2 - d1 * d6;
+            if ((vb <= 0.0f) && (d2 >= 0.0f) && (d6 <= 0.0f))
+            {
+                return a + ac * (d2 / (d2 - d6));
+            }
+            float va = d3 * d6 - d5 * d4;
+            if ((va <= 0.0f) && ((d4 - d3) >= 0.0f) && ((d5 - d6) >= 0.0f))
+            {
+                return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+            }
+            float denominator = 1.0f / (va + vb + vc);
+            return a + ab * (vb * denominator) + ac * (vc * denominator);
+        }
+    } // namespace
+
+    void LodGenerator::Generate(std::vector<Vertex> const& vertices, std::vector<uint>& indices,
+                                std::vector<Submesh>& submeshes)
+    {
+        ZoneScopedN("LodGenerator::Generate");
+        for (auto& submesh : submeshes)
+        {
+            if (!submesh.m_Lods.empty() || (submesh.m_IndexCount < MIN_TRIANGLES * 3))
+            {
+                continue;
+            }
+            Simplify(vertices.data() + submesh.m_FirstVertex, submesh.m_VertexCount, indices, submesh);
+        }
+    }
+
+    void LodGenerator::Simplify(Vertex const* vertices, uint vertexCount, std::vector<uint>& indices, Submesh& submesh)
+    {
+        Simplification simplification{vertices, vertexCount};
+        std::vector<uint>& current = simplification.m_Indices;
+        current.assign(indices.begin() + submesh.m_FirstIndex,
+                       indices.begin() + submesh.m_FirstIndex + submesh.m_IndexCount);
+        for (uint index : current)
+        {
+            if (index >= vertexCount)
+            {
+                LOG_CORE_ERROR("LodGenerator::Simplify: index {0} out of range (vertex count {1})", index, vertexCount);
+                return;
+            }
+        }
+
+        // weld positions
+        std::vector<uint> verticesPerPosition;
+        {
+            auto less = [vertices](uint lhs, uint rhs)
+            {
+                glm::vec3 const& a = vertices[lhs].m_Position;
+                glm::vec3 const& b = vertices[rhs].m_Position;
+                return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+            };
+            std::vector<uint> order(vertexCount);
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), less);
+
+            simplification.m_PositionIds.resize(vertexCount);
+            for (uint index = 0; index < vertexCount; ++index)
+            {
+                if ((index == 0) || less(order[index - 1], order[index]))
+                {
+                    verticesPerPosition.push_back(0);
+                }
+                simplification.m_PositionIds[order[index]] = static_cast<uint>(verticesPerPosition.size() - 1);
+                ++verticesPerPosition.back();
+            }
+        }
+        std::vector<uint> const& positionIds = simplification.m_PositionIds;
+        size_t numberOfPositions = verticesPerPosition.size();
+
+        // plane quadrics and edges
+        simplification.m_Quadrics.resize(numberOfPositions);
+        std::vector<uint64> edges;
+        edges.reserve(current.size());
+        for (size_t corner = 0; corner < current.size(); corner += 3)
+        {
+            glm::dvec3 position0 = vertices[current[corner + 0]].m_Position;
+            glm::dvec3 position1 = vertices[current[corner + 1]].m_Position;
+            glm::dvec3 position2 = vertices[current[corner + 2]].m_Position;
+            glm::dvec3 normal = glm::cross(position1 - position0, position2 - position0);
+            double doubleArea = glm::length(normal);
+            if (doubleArea > 0.0)
+            {
+                normal /= doubleArea;
+                double distance = -glm::dot(normal, position0);
+                for (uint vertex = 0; vertex < 3; ++vertex)
+                {
+                    simplification.m_Quadrics[positionIds[current[corner + vertex]]].AddPlane(normal, distance,
+                                                                                               0.5 * doubleArea);
+                }
+            }
+            for (uint edge = 0; edge < 3; ++edge)
+            {
+                uint position0Id = positionIds[current[corner + edge]];
+                uint position1Id = positionIds[current[corner + (edge + 1) % 3]];
+                if (position0Id != position1Id)
+                {
+                    edges.push_back(EdgeKey(position0Id, position1Id));
+                }
+            }
+        }
+
+        // lock open borders and non-manifold edges (not shared by exactly two triangles) and attribute seams
+        simplification.m_Locked.resize(numberOfPositions, false);
+        std::sort(edges.begin(), edges.end());
+        for (size_t first = 0; first < edges.size();)
+        {
+            size_t last = first + 1;
+            while ((last < edges.size()) && (edges[last] == edges[first]))
+            {
+                ++last;
+            }
+            if (last - first != 2)
+            {
+                simplification.m_Locked[edges[first] >> 32] = true;
+                simplification.m_Locked[edges[first] & 0xffffffff] = true;
+            }
+            first = last;
+        }
+        for (size_t position = 0; position < numberOfPositions; ++position)
+        {
+            if (verticesPerPosition[position] > 1)
+            {
+                simplification.m_Locked[position] = true;
+            }
+        }
+
+        // each level continues from the previous one, so its quadrics carry the error of all collapses so far
+        size_t previousIndexCount = current.size();
+        for (uint level = 0; level < MAX_LEVELS; ++level)
+        {
+            size_t targetIndexCount = (previousIndexCount / 6) * 3;
+            if (targetIndexCount < MIN_LEVEL_TRIANGLES * 3)
+            {
+                break;
+            }
+            for (uint pass = 0; (pass < MAX_PASSES) && (current.size() > targetIndexCount); ++pass)
+            {
+                if (!CollapseEdges(simplification, targetIndexCount))
+                {
+                    break;
+                }
+            }
+            if (current.size() > previousIndexCount * MIN_REDUCTION)
+            {
+                break; // the remaining vertices are locked or their collapses would flip triangles
+            }
+
+            SubmeshLod lod{static_cast<uint>(indices.size()), submesh.m_FirstVertex, static_cast<uint>(current.size()),
+                           std::sqrt(simplification.m_MaxCost)};
+            indices.insert(indices.end(), current.begin(), current.end());
+            submesh.m_Lods.push_back(lod);
+            previousIndexCount = current.size();
+        }
+    }
+
+    void LodGenerator::AppendLevel(std::vector<Vertex>& vertices, std::vector<uint>& indices, Submesh& submesh,
+                                   std::vector<Vertex> const& lodVertices, std::vector<uint> const& lodIndices,
+                                   Submesh const& lodSubmesh)
+    {
+        if (!submesh.m_IndexCount || !lodSubmesh.m_IndexCount)
+        {
+            LOG_CORE_WARN("LodGenerator::AppendLevel: levels of detail require indexed submeshes");
+            return;
+        }
+
+        SubmeshLod lod{static_cast<uint>(indices.size()), static_cast<uint>(vertices.size()), lodSubmesh.m_IndexCount,
+                       0.0f};
+        vertices.insert(vertices.end(), lodVertices.begin() + lodSubmesh.m_FirstVertex,
+                        lodVertices.begin() + lodSubmesh.m_FirstVertex + lodSubmesh.m_VertexCount);
+        indices.insert(indices.end(), lodIndices.begin() + lodSubmesh.m_FirstIndex,
+                       lodIndices.begin() + lodSubmesh.m_FirstIndex + lodSubmesh.m_IndexCount);
+
+        // a coarser level never selects with a smaller error than the finer ones
+        lod.m_Error = MeasureError(vertices.data() + submesh.m_FirstVertex, indices.data() + submesh.m_FirstIndex,
+                                   submesh.m_IndexCount, vertices.data() + lod.m_FirstVertex,
+                                   indices.data() + lod.m_FirstIndex, lod.m_IndexCount);
+        if (!submesh.m_Lods.empty())
+        {
+            lod.m_Error = std::max(lod.m_Error, submesh.m_Lods.back().m_Error);
+        }
+        submesh.m_Lods.push_back(lod);
+    }
+
+    float LodGenerator::MeasureError(Vertex const* vertices, uint const* indices, uint indexCount,
+                                     Vertex const* lodVertices, uint const* lodIndices, uint lodIndexCount)
+    {
+        // largest distance of the full submesh's vertices to the surface of the level,
+        // large submeshes are sampled; a vertex stops searching once it is closer than the current maximum
+        ZoneScopedN("LodGenerator::MeasureError");
+        uint stride = std::max(1u, indexCount / MAX_ERROR_SAMPLES);
+        float maxDistanceSquared = 0.0f;
+        for (uint index = 0; index < indexCount; index += stride)
+        {
+            glm::vec3 const& point = vertices[indices[index]].m_Position;
+            float distanceSquared = std::numeric_limits<float>::max();
+            for (uint corner = 0; (corner + 2 < lodIndexCount) && (distanceSquared > maxDistanceSquared); corner += 3)
+            {
+                glm::vec3 closestPoint = ClosestPointOnTriangle(point, lodVertices[lodIndices[corner + 0]].m_Position,
+                                                                lodVertices[lodIndices[corner + 1]].m_Position,
+                                                                lodVertices[lodIndices[corner + 2]].m_Position);
+                glm::vec3 difference = point - closestPoint;
+                distanceSquared = std::min(distanceSquared, glm::dot(difference, difference));
+            }
+            maxDistanceSquared = std::max(maxDistanceSquared, distanceSquared);
+        }
+        return std::sqrt(maxDistanceSquared);
+    }
+
+    int LodGenerator::ParseLodName(std::string_view name, std::string_view& baseName)
+    {
+        size_t separator = name.rfind('_');
+        if (separator == std::string_view::npos)
+        {
+            return -1;
+        }
+        std::string_view suffix = name.substr(separator + 1);
+        if ((suffix.size() < 4) || (suffix.size() > 5))
+        {
+            return -1;
+        }
+        for (uint character = 0; character < 3; ++character)
+        {
+            if (std::tolower(static_cast<unsigned char>(suffix[character])) != "lod"[character])
+            {
+                return -1;
+            }
+        }
+        int level = 0;
+        for (char digit : suffix.substr(3))
+        {
+            if (!std::isdigit(static_cast<unsigned char>(digit)))
+            {
+                return -1;
+            }
+            level = level * 10 + (digit - '0');
+        }
+        baseName = name.substr(0, separator);
+        return level;
+    }
+} // namespace GfxRenderEngine
@@ -0,0 +1,80 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "engine.h"
+
+namespace GfxRenderEngine
+{
+    struct Submesh;
+    struct Vertex;
+
+    // a coarser index range of a submesh, it references the vertices of the vertex buffer like the submesh
+    struct SubmeshLod
+    {
+        uint m_FirstIndex;
+        uint m_FirstVertex;
+        uint m_IndexCount;
+        float m_Error; // deviation from the full submesh in model space
+    };
+
+    // shared level of detail generator for all builders
+    // each level halves the triangles of the previous one by quadric edge collapse (Garland-Heckbert):
+    // a vertex moves onto a neighbor, the cost is the area-weighted squared distance to the planes of the
+    // triangles around both positions plus a penalty for the change of normal and UV along the edge
+    // vertices on open borders and attribute seams (positions shared by several vertices) stay in place,
+    // so silhouettes and UV seams do not crack; collapses that flip a triangle are rejected
+    // the levels only add indices, they reuse the vertices of the full submesh;
+    // the error of a level is the square root of its largest collapse cost, the renderer projects it
+    // to pixels to select a level (see VK_Model::SelectLods)
+    // hand-authored levels (glTF MSFT_lod, "_LOD<n>" node names) replace the generated ones
+    class LodGenerator
+    {
+
+    public:
+        static constexpr uint MAX_LEVELS = 4;       // below the full submesh
+        static constexpr uint MIN_TRIANGLES = 256;  // smaller submeshes are not simplified
+
+        // indices are relative to the first vertex of each submesh, the levels are appended to 'indices';
+        // submeshes that already have levels are skipped
+        static void Generate(std::vector<Vertex> const& vertices, std::vector<uint>& indices,
+                             std::vector<Submesh>& submeshes);
+
+        // appends an authored level to 'submesh', the vertices and indices of 'lodSubmesh' are copied
+        static void AppendLevel(std::vector<Vertex>& vertices, std::vector<uint>& indices, Submesh& submesh,
+                                std::vector<Vertex> const& lodVertices, std::vector<uint> const& lodIndices,
+                                Submesh const& lodSubmesh);
+
+        // level of detail naming convention of DCC exports, "<base name>_LOD<n>" (case-insensitive)
+        // returns n and sets 'baseName', or returns -1
+        static int ParseLodName(std::string_view name, std::string_view& baseName);
+
+    private:
+        static void Simplify(Vertex const* vertices, uint vertexCount, std::vector<uint>& indices, Submesh& submesh);
+        static float MeasureError(Vertex const* vertices, uint const* indices, uint indexCount,
+                                  Vertex const* lodVertices, uint const* lodIndices, uint lodIndexCount);
+    };
+} // namespace GfxRenderEngine
@@ -0,0 +1,399 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <cmath>
+#include <functional>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TANGENT_GENERATOR_SSE
+#endif
+
+#include "core.h"
+#include "renderer/model.h"
+#include "renderer/builder/tangentGenerator.h"
+#include "auxiliary/instrumentation.h"
+
+namespace GfxRenderEngine
+{
+    namespace
+    {
+        // faces are processed in groups of four (one SSE register per component);
+        // groups never straddle a job boundary, so each triangle always takes the same code path
+        constexpr uint GROUP_SIZE = 4;
+        constexpr uint GROUP_GRAIN = 1024;
+        constexpr uint VERTEX_GRAIN = 4096;
+        constexpr uint PARALLEL_MIN_TRIANGLES = 8192;
+        constexpr float MIN_LENGTH_SQUARED = 1e-20f;
+
+        glm::vec3 Normalize(glm::vec3 const& vector, glm::vec3 const& fallback)
+        {
+            float lengthSquared = glm::dot(vector, vector);
+            return lengthSquared > MIN_LENGTH_SQUARED ? vector / std::sqrt(lengthSquared) : fallback;
+        }
+
+        void ParallelFor(uint count, uint grainSize, bool parallel, std::function<void(uint, uint)> const& body)
+        {
+            if (parallel)
+            {
+                Engine::m_Engine->m_PoolPrimary.ParallelFor(0, count, grainSize, body);
+            }
+            else
+            {
+                body(0, count);
+            }
+        }
+    } // namespace
+
+    void TangentGenerator::Generate(std::vector<Vertex>& vertices, std::vector<uint> const& indices, bool smoothNormals)
+    {
+        Generate(vertices.data(), static_cast<uint>(vertices.size()), indices.data(), static_cast<uint>(indices.size()),
+                 smoothNormals);
+    }
+
+    void TangentGenerator::Generate(Vertex* vertices, uint vertexCount, uint const* indices, uint indexCount,
+                                    bool smoothNormals)
+    {
+        ZoneScopedN("TangentGenerator::Generate");
+        uint cornerCount = indexCount ? indexCount : vertexCount;
+        uint triangleCount = cornerCount / 3;
+        if (!triangleCount)
+        {
+            return;
+        }
+        cornerCount = triangleCount * 3;
+
+        FaceData faceData;
+
+        { // gather structure-of-arrays input
+            faceData.m_Indices.resize(cornerCount);
+            for (uint corner = 0; corner < cornerCount; ++corner)
+            {
+                uint index = indexCount ? indices[corner] : corner;
+                if (index >= vertexCount)
+                {
+                    LOG_CORE_CRITICAL("TangentGenerator::Generate: index {0} out of range (vertex count {1})", index,
+                                      vertexCount);
+                    return;
+                }
+                faceData.m_Indices[corner] = index;
+            }
+
+            faceData.m_PositionX.resize(vertexCount);
+            faceData.m_PositionY.resize(vertexCount);
+            faceData.m_PositionZ.resize(vertexCount);
+            faceData.m_U.resize(vertexCount);
+            faceData.m_V.resize(vertexCount);
+            for (uint vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+            {
+                Vertex const& vertex = vertices[vertexIndex];
+                faceData.m_PositionX[vertexIndex] = vertex.m_Position.x;
+                faceData.m_PositionY[vertexIndex] = vertex.m_Position.y;
+                faceData.m_PositionZ[vertexIndex] = vertex.m_Position.z;
+                faceData.m_U[vertexIndex] = vertex.m_UV.x;
+                faceData.m_V[vertexIndex] = vertex.m_UV.y;
+            }
+
+            faceData.m_TangentX.resize(triangleCount);
+            faceData.m_TangentY.resize(triangleCount);
+            faceData.m_TangentZ.resize(triangleCount);
+            faceData.m_NormalX.resize(triangleCount);
+            faceData.m_NormalY.resize(triangleCount);
+            faceData.m_NormalZ.resize(triangleCount);
+            faceData.m_Orientation.resize(triangleCount);
+            faceData.m_Angle.resize(cornerCount);
+        }
+
+        bool parallel = triangleCount >= PARALLEL_MIN_TRIANGLES;
+
+        { // face pass: tangent, orientation, normal and corner angles per triangle
+            uint groupCount = (triangleCount + GROUP_SIZE - 1) / GROUP_SIZE;
+            ParallelFor(groupCount, GROUP_GRAIN, parallel,
+                        [&](uint firstGroup, uint lastGroup)
+                        {
+                            uint lastTriangle = std::min(lastGroup * GROUP_SIZE, triangleCount);
+                            ProcessFaces(faceData, firstGroup * GROUP_SIZE, lastTriangle);
+                        });
+        }
+
+        // vertex -> corner lookup (counting sort, corners stay in triangle order)
+        std::vector<uint> cornerOffsets(vertexCount + 1, 0);
+        std::vector<uint> vertexCorners(cornerCount);
+        {
+            for (uint corner = 0; corner < cornerCount; ++corner)
+            {
+                ++cornerOffsets[faceData.m_Indices[corner] + 1];
+            }
+            for (uint vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+            {
+                cornerOffsets[vertexIndex + 1] += cornerOffsets[vertexIndex];
+            }
+            std::vector<uint> cursor(cornerOffsets.begin(), cornerOffsets.end() - 1);
+            for (uint corner = 0; corner < cornerCount; ++corner)
+            {
+                vertexCorners[cursor[faceData.m_Indices[corner]]++] = corner;
+            }
+        }
+
+        // vertex pass: accumulate the corners of each vertex in a fixed order
+        auto processVertices = [&](uint firstVertex, uint lastVertex)
+        {
+            for (uint vertexIndex = firstVertex; vertexIndex < lastVertex; ++vertexIndex)
+            {
+                Vertex& vertex = vertices[vertexIndex];
+                uint firstCorner = cornerOffsets[vertexIndex];
+                uint lastCorner = cornerOffsets[vertexIndex + 1];
+                if (firstCorner == lastCorner)
+                {
+                    continue; // not referenced by any triangle
+                }
+
+                glm::vec3 normal = smoothNormals ? glm::vec3(0.0f) : Normalize(vertex.m_Normal, glm::vec3(0.0f));
+                if (normal == glm::vec3(0.0f))
+                {
+                    glm::vec3 normalSum{0.0f};
+                    for (uint cornerIndex = firstCorner; cornerIndex < lastCorner; ++cornerIndex)
+                    {
+                        uint corner = vertexCorners[cornerIndex];
+                        uint triangle = corner / 3;
+                        glm::vec3 faceNormal{faceData.m_NormalX[triangle], faceData.m_NormalY[triangle],
+                                             faceData.m_NormalZ[triangle]};
+                        normalSum += faceData.m_Angle[corner] * faceNormal;
+                    }
+                    normal = Normalize(normalSum, Normalize(vertex.m_Normal, glm::vec3(0.0f, 0.0f, 1.0f)));
+                    if (smoothNormals)
+                    {
+                        vertex.m_Normal = normal;
+                    }
+                }
+
+                // the majority decides the handedness of a vertex shared by mirrored faces
+                float orientationVote = 0.0f;
+                for (uint cornerIndex = firstCorner; cornerIndex < lastCorner; ++cornerIndex)
+                {
+                    uint corner = vertexCorners[cornerIndex];
+                    orientationVote += faceData.m_Angle[corner] * faceData.m_Orientation[corner / 3];
+                }
+                float sign = orientationVote < 0.0f ? -1.0f : 1.0f;
+
+                glm::vec3 tangentSum{0.0f};
+                for (uint cornerIndex = firstCorner; cornerIndex < lastCorner; ++cornerIndex)
+                {
+                    uint corner = vertexCorners[cornerIndex];
+                    uint triangle = corner / 3;
+                    if (faceData.m_Orientation[triangle] != sign)
+                    {
+                        continue; // degenerate UVs or opposite handedness
+                    }
+                    glm::vec3 faceTangent{faceData.m_TangentX[triangle], faceData.m_TangentY[triangle],
+                                          faceData.m_TangentZ[triangle]};
+                    glm::vec3 projected = faceTangent - normal * glm::dot(normal, faceTangent);
+                    tangentSum += faceData.m_Angle[corner] * Normalize(projected, glm::vec3(0.0f));
+                }
+
+                glm::vec3 tangent = Normalize(tangentSum, glm::vec3(0.0f));
+                if (tangent == glm::vec3(0.0f))
+                {
+                    // no usable UVs: any direction in the tangent plane
+                    glm::vec3 axis = std::abs(normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+                    tangent = Normalize(axis - normal * glm::dot(normal, axis), glm::vec3(1.0f, 0.0f, 0.0f));
+                }
+                vertex.m_Tangent = glm::vec4(tangent, sign);
+            }
+        };
+        ParallelFor(vertexCount, VERTEX_GRAIN, parallel, processVertices);
+    }
+
+    void TangentGenerator::ProcessFaces(FaceData& faceData, uint firstTriangle, uint lastTriangle)
+    {
+        uint triangle = firstTriangle;
+        for (; triangle + GROUP_SIZE <= lastTriangle; triangle += GROUP_SIZE)
+        {
+            ProcessFaces4(faceData, triangle);
+        }
+        for (; triangle < lastTriangle; ++triangle)
+        {
+            ProcessFace(faceData, triangle);
+        }
+    }
+
+    // scalar reference, must produce the same results as the SSE path
+    void TangentGenerator::ProcessFace(FaceData& faceData, uint triangle)
+    {
+        uint const* index = &faceData.m_Indices[triangle * 3];
+        glm::vec3 position0{faceData.m_PositionX[index[0]], faceData.m_PositionY[index[0]], faceData.m_PositionZ[index[0]]};
+        glm::vec3 position1{faceData.m_PositionX[index[1]], faceData.m_PositionY[index[1]], faceData.m_PositionZ[index[1]]};
+        glm::vec3 position2{faceData.m_PositionX[index[2]], faceData.m_PositionY[index[2]], faceData.m_PositionZ[index[2]]};
+
+        glm::vec3 edge1 = position1 - position0;
+        glm::vec3 edge2 = position2 - position0;
+        glm::vec3 edge3 = position2 - position1;
+        float dU1 = faceData.m_U[index[1]] - faceData.m_U[index[0]];
+        float dV1 = faceData.m_V[index[1]] - faceData.m_V[index[0]];
+        float dU2 = faceData.m_U[index[2]] - faceData.m_U[index[0]];
+        float dV2 = faceData.m_V[index[2]] - faceData.m_V[index[0]];
+
+        { // tangent and orientation
+            float determinant = dU1 * dV2 - dU2 * dV1;
+            float sign = determinant < 0.0f ? -1.0f : 1.0f;
+            glm::vec3 tangent = sign * (dV2 * edge1 - dV1 * edge2);
+            float lengthSquared = glm::dot(tangent, tangent);
+            bool valid = (lengthSquared > MIN_LENGTH_SQUARED) && (determinant != 0.0f);
+            tangent = valid ? tangent * (1.0f / std::sqrt(lengthSquared)) : glm::vec3(0.0f);
+            faceData.m_TangentX[triangle] = tangent.x;
+            faceData.m_TangentY[triangle] = tangent.y;
+            faceData.m_TangentZ[triangle] = tangent.z;
+            faceData.m_Orientation[triangle] = valid ? sign : 0.0f;
+        }
+
+        { // face normal
+            glm::vec3 normal = glm::cross(edge1, edge2);
+            float lengthSquared = glm::dot(normal, normal);
+            normal = lengthSquared > MIN_LENGTH_SQUARED ? normal * (1.0f / std::sqrt(lengthSquared)) : glm::vec3(0.0f);
+            faceData.m_NormalX[triangle] = normal.x;
+            faceData.m_NormalY[triangle] = normal.y;
+            faceData.m_NormalZ[triangle] = normal.z;
+        }
+
+        { // corner angles
+            auto cosine = [](float dot, float lengthSquaredA, float lengthSquaredB)
+            {
+                float denominator = std::sqrt(lengthSquaredA * lengthSquaredB);
+                float value = denominator > 0.0f ? dot / denominator : 1.0f;
+                return std::min(std::max(value, -1.0f), 1.0f);
+            };
+            float length1 = glm::dot(edge1, edge1);
+            float length2 = glm::dot(edge2, edge2);
+            float length3 = glm::dot(edge3, edge3);
+            float* angle = &faceData.m_Angle[triangle * 3];
+            angle[0] = std::acos(cosine(glm::dot(edge1, edge2), length1, length2));
+            angle[1] = std::acos(cosine(-glm::dot(edge1, edge3), length1, length3));
+            angle[2] = std::acos(cosine(glm::dot(edge2, edge3), length2, length3));
+        }
+    }
+
+    void TangentGenerator::ProcessFaces4(FaceData& faceData, uint triangle)
+    {
+#ifdef TANGENT_GENERATOR_SSE
+        uint const* index = &faceData.m_Indices[triangle * 3];
+        auto gather = [index](std::vector<float> const& component, uint corner)
+        {
+            return _mm_set_ps(component[index[9 + corner]], component[index[6 + corner]], component[index[3 + corner]],
+                              component[index[corner]]);
+        };
+        auto dot = [](__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz)
+        { return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz)); };
+        auto select = [](__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); };
+
+        __m128 const zero = _mm_setzero_ps();
+        __m128 const one = _mm_set1_ps(1.0f);
+        __m128 const minusOne = _mm_set1_ps(-1.0f);
+        __m128 const minLengthSquared = _mm_set1_ps(MIN_LENGTH_SQUARED);
+
+        __m128 position0x = gather(faceData.m_PositionX, 0);
+        __m128 position0y = gather(faceData.m_PositionY, 0);
+        __m128 position0z = gather(faceData.m_PositionZ, 0);
+        __m128 position1x = gather(faceData.m_PositionX, 1);
+        __m128 position1y = gather(faceData.m_PositionY, 1);
+        __m128 position1z = gather(faceData.m_PositionZ, 1);
+        __m128 position2x = gather(faceData.m_PositionX, 2);
+        __m128 position2y = gather(faceData.m_PositionY, 2);
+        __m128 position2z = gather(faceData.m_PositionZ, 2);
+        __m128 u0 = gather(faceData.m_U, 0);
+        __m128 v0 = gather(faceData.m_V, 0);
+
+        __m128 edge1x = _mm_sub_ps(position1x, position0x);
+        __m128 edge1y = _mm_sub_ps(position1y, position0y);
+        __m128 edge1z = _mm_sub_ps(position1z, position0z);
+        __m128 edge2x = _mm_sub_ps(position2x, position0x);
+        __m128 edge2y = _mm_sub_ps(position2y, position0y);
+        __m128 edge2z = _mm_sub_ps(position2z, position0z);
+        __m128 edge3x = _mm_sub_ps(position2x, position1x);
+        __m128 edge3y = _mm_sub_ps(position2y, position1y);
+        __m128 edge3z = _mm_sub_ps(position2z, position1z);
+        __m128 dU1 = _mm_sub_ps(gather(faceData.m_U, 1), u0);
+        __m128 dV1 = _mm_sub_ps(gather(faceData.m_V, 1), v0);
+        __m128 dU2 = _mm_sub_ps(gather(faceData.m_U, 2), u0);
+        __m128 dV2 = _mm_sub_ps(gather(faceData.m_V, 2), v0);
+
+        { // tangent and orientation
+            __m128 determinant = _mm_sub_ps(_mm_mul_ps(dU1, dV2), _mm_mul_ps(dU2, dV1));
+            __m128 sign = select(_mm_cmplt_ps(determinant, zero), minusOne, one);
+            __m128 tangentX = _mm_mul_ps(sign, _mm_sub_ps(_mm_mul_ps(dV2, edge1x), _mm_mul_ps(dV1, edge2x)));
+            __m128 tangentY = _mm_mul_ps(sign, _mm_sub_ps(_mm_mul_ps(dV2, edge1y), _mm_mul_ps(dV1, edge2y)));
+            __m128 tangentZ = _mm_mul_ps(sign, _mm_sub_ps(_mm_mul_ps(dV2, edge1z), _mm_mul_ps(dV1, edge2z)));
+            __m128 lengthSquared = dot(tangentX, tangentY, tangentZ, tangentX, tangentY, tangentZ);
+            __m128 valid = _mm_and_ps(_mm_cmpgt_ps(lengthSquared, minLengthSquared), _mm_cmpneq_ps(determinant, zero));
+            __m128 scale = _mm_and_ps(valid, _mm_div_ps(one, _mm_sqrt_ps(lengthSquared)));
+            _mm_storeu_ps(&faceData.m_TangentX[triangle], _mm_and_ps(valid, _mm_mul_ps(tangentX, scale)));
+            _mm_storeu_ps(&faceData.m_TangentY[triangle], _mm_and_ps(valid, _mm_mul_ps(tangentY, scale)));
+            _mm_storeu_ps(&faceData.m_TangentZ[triangle], _mm_and_ps(valid, _mm_mul_ps(tangentZ, scale)));
+            _mm_storeu_ps(&faceData.m_Orientation[triangle], _mm_and_ps(valid, sign));
+        }
+
+        { // face normal
+            __m128 normalX = _mm_sub_ps(_mm_mul_ps(edge1y, edge2z), _mm_mul_ps(edge1z, edge2y));
+            __m128 normalY = _mm_sub_ps(_mm_mul_ps(edge1z, edge2x), _mm_mul_ps(edge1x, edge2z));
+            __m128 normalZ = _mm_sub_ps(_mm_mul_ps(edge1x, edge2y), _mm_mul_ps(edge1y, edge2x));
+            __m128 lengthSquared = dot(normalX, normalY, normalZ, normalX, normalY, normalZ);
+            __m128 valid = _mm_cmpgt_ps(lengthSquared, minLengthSquared);
+            __m128 scale = _mm_and_ps(valid, _mm_div_ps(one, _mm_sqrt_ps(lengthSquared)));
+            _mm_storeu_ps(&faceData.m_NormalX[triangle], _mm_and_ps(valid, _mm_mul_ps(normalX, scale)));
+            _mm_storeu_ps(&faceData.m_NormalY[triangle], _mm_and_ps(valid, _mm_mul_ps(normalY, scale)));
+            _mm_storeu_ps(&faceData.m_NormalZ[triangle], _mm_and_ps(valid, _mm_mul_ps(normalZ, scale)));
+        }
+
+        { // corner angles, acos is evaluated per lane
+            auto cosine = [&](__m128 dotProduct, __m128 lengthSquaredA, __m128 lengthSquaredB)
+            {
+                __m128 denominator = _mm_sqrt_ps(_mm_mul_ps(lengthSquaredA, lengthSquaredB));
+                __m128 value = select(_mm_cmpgt_ps(denominator, zero), _mm_div_ps(dotProduct, denominator), one);
+                return _mm_min_ps(_mm_max_ps(value, minusOne), one);
+            };
+            __m128 length1 = dot(edge1x, edge1y, edge1z, edge1x, edge1y, edge1z);
+            __m128 length2 = dot(edge2x, edge2y, edge2z, edge2x, edge2y, edge2z);
+            __m128 length3 = dot(edge3x, edge3y, edge3z, edge3x, edge3y, edge3z);
+            __m128 dot12 = dot(edge1x, edge1y, edge1z, edge2x, edge2y, edge2z);
+            __m128 dot13 = _mm_sub_ps(zero, dot(edge1x, edge1y, edge1z, edge3x, edge3y, edge3z));
+            __m128 dot23 = dot(edge2x, edge2y, edge2z, edge3x, edge3y, edge3z);
+
+            alignas(16) float cosines[3][GROUP_SIZE];
+            _mm_store_ps(cosines[0], cosine(dot12, length1, length2));
+            _mm_store_ps(cosines[1], cosine(dot13, length1, length3));
+            _mm_store_ps(cosines[2], cosine(dot23, length2, length3));
+            float* angle = &faceData.m_Angle[triangle * 3];
+            for (uint lane = 0; lane < GROUP_SIZE; ++lane)
+            {
+                angle[lane * 3 + 0] = std::acos(cosines[0][lane]);
+                angle[lane * 3 + 1] = std::acos(cosines[1][lane]);
+                angle[lane * 3 + 2] = std::acos(cosines[2][lane]);
+            }
+        }
+#else
+        for (uint lane = 0; lane < GROUP_SIZE; ++lane)
+        {
+            ProcessFace(faceData, triangle + lane);
+        }
+#endif
+    }
+} // namespace GfxRenderEngine
@@ -0,0 +1,69 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <vector>
+
+#include "engine.h"
+
+namespace GfxRenderEngine
+{
+    struct Vertex;
+
+    // shared tangent space generator for all builders
+    // follows the MikkTSpace conventions: per-face tangents are projected into the tangent plane
+    // of each vertex, weighted by the corner angle and normalized; faces with mirrored UVs only
+    // contribute to vertices of the same orientation, so mirror seams stay sharp
+    // the bitangent is not stored, the handedness is stored in the w component of the tangent
+    // (same convention as for glTF tangents, the shaders reconstruct it as cross(N, T.xyz) * T.w)
+    // large meshes are split across the primary thread pool; the result does not depend on the
+    // number of threads because every vertex sums its corners in triangle order
+    class TangentGenerator
+    {
+
+    public:
+        // indices are relative to vertices, indexCount == 0 means a non-indexed triangle list
+        // smoothNormals replaces the vertex normals with angle-weighted face normals
+        static void Generate(Vertex* vertices, uint vertexCount, uint const* indices, uint indexCount,
+                             bool smoothNormals = false);
+        static void Generate(std::vector<Vertex>& vertices, std::vector<uint> const& indices, bool smoothNormals = false);
+
+    private:
+        // structure-of-arrays input and per-triangle output of the face pass
+        struct FaceData
+        {
+            std::vector<float> m_PositionX, m_PositionY, m_PositionZ;
+            std::vector<float> m_U, m_V;
+            std::vector<uint> m_Indices;
+
+            std::vector<float> m_TangentX, m_TangentY, m_TangentZ;
+            std::vector<float> m_NormalX, m_NormalY, m_NormalZ;
+            std::vector<float> m_Orientation;
+            std::vector<float> m_Angle; // three corners per triangle
+        };
+
+        static void ProcessFaces(FaceData& faceData, uint firstTriangle, uint lastTriangle);
+        static void ProcessFace(FaceData& faceData, uint triangle);
+        static void ProcessFaces4(FaceData& faceData, uint triangle);
+    };
+} // namespace GfxRenderEngine
@@ -21,11 +21,14 @@
    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
+#include <limits>
+
 #include "core.h"
 #include "renderer/image.h"
 #include "renderer/model.h"
 #include "renderer/instanceBuffer.h"
 #include "renderer/builder/terrainBuilder.h"
+#include "renderer/builder/tangentGenerator.h"
 #include "auxiliary/file.h"
 #include "scene/scene.h"
 
@@ -177,7 +180,7 @@ namespace GfxRenderEngine
                 }
             }
         }
-        CalculateTangents();
+        TangentGenerator::Generate(m_Vertices, m_Indices);
         return true;
     }
 
@@ -275,8 +278,7 @@ namespace GfxRenderEngine
                     registry.emplace<PbrMaterialTag>(entity, pbrMaterialTag);
                 }
 
-                instanceTag.m_InstanceBuffer->SetInstanceData(instanceIndex, transform.GetMat4Global(),
-                                                              transform.GetNormalMatrix());
+                instanceTag.m_InstanceBuffer->SetInstanceData(instanceIndex, transform.GetMat4Global());
                 transform.SetInstance(instanceTag.m_InstanceBuffer, instanceIndex);
                 registry.emplace<TransformComponent>(entity, transform);
 
@@ -302,9 +304,15 @@ namespace GfxRenderEngine
                 uint heightMapSize = heightMap.Size();
                 Resources::ResourceBuffers resourceBuffers;
                 uint grassInstances = 0;
+                std::vector<GrassTag::Chunk> chunks;
                 {
                     {
-                        std::vector<Terrain::GrassShaderData> bufferData(heightMapSize);
+                        // blades are stored tile by tile, each tile is drawn (or culled) with one indirect command
+                        static constexpr uint GRASS_TILE_SIZE = 32;
+                        uint width = heightMap.Width();
+                        uint tilesX = (width + GRASS_TILE_SIZE - 1) / GRASS_TILE_SIZE;
+                        uint tilesY = (heightMap.Height() + GRASS_TILE_SIZE - 1) / GRASS_TILE_SIZE;
+                        std::vector<std::vector<Terrain::GrassShaderData>> tiles(tilesX * tilesY);
                         for (uint mapIndex = 0; mapIndex < heightMapSize; ++mapIndex)
                         {
                             float normalizedRandom = std::rand() / static_cast<float>(RAND_MAX);
@@ -313,10 +321,34 @@ namespace GfxRenderEngine
                             bool placeGrass = (heightMap[mapIndex] > 0) && (randomizedDensity > 0.05f);
                             if (placeGrass)
                             {
-                                bufferData[grassInstances].m_Height = heightMap[mapIndex];
-                                bufferData[grassInstances].m_Index = mapIndex;
-                                ++grassInstances;
+                                uint tileX = (mapIndex % width) / GRASS_TILE_SIZE;
+                                uint tileY = (mapIndex / width) / GRASS_TILE_SIZE;
+                                tiles[tileY * tilesX + tileX].push_back(
+                                    {.m_Height = heightMap[mapIndex], .m_Index = static_cast<int>(mapIndex)});
+                            }
+                        }
+
+                        std::vector<Terrain::GrassShaderData> bufferData;
+                        bufferData.reserve(heightMapSize);
+                        for (auto const& tile : tiles)
+                        {
+                            if (tile.empty())
+                            {
+                                continue;
+                            }
+                            GrassTag::Chunk chunk{.m_FirstInstance = grassInstances,
+                                                  .m_InstanceCount = static_cast<uint>(tile.size()),
+                                                  .m_Min = glm::vec3(std::numeric_limits<float>::max()),
+                                                  .m_Max = glm::vec3(std::numeric_limits<float>::lowest())};
+                            for (auto const& blade : tile)
+                            {
+                                glm::vec3 position{blade.m_Index % width, blade.m_Height, blade.m_Index / width};
+                                chunk.m_Min = glm::min(chunk.m_Min, position);
+                                chunk.m_Max = glm::max(chunk.m_Max, position);
+                                bufferData.push_back(blade);
                             }
+                            grassInstances += chunk.m_InstanceCount;
+                            chunks.push_back(chunk);
                         }
                         CORE_ASSERT(grassInstances, "no grass placed");
                         auto& ubo = resourceBuffers[Resources::HEIGHTMAP];
@@ -353,7 +385,8 @@ namespace GfxRenderEngine
                         TreeNode rootNode = sceneGraph.GetNodeByGameObject(grassEntityRoot);
                         TreeNode grassNode =
                             sceneGraph.GetNode(rootNode.GetChild(0)); // grass model must be single game object
-                        GrassTag grassTag{grassInstances};
+                        float bladeScale = std::max(grassSpec.m_ScaleXZ, grassSpec.m_ScaleY);
+                        GrassTag grassTag{grassInstances, std::move(chunks), bladeScale};
                         registry.emplace<GrassTag>(grassNode.GetGameObject(), grassTag);
 
                         auto& transform = registry.get<TransformComponent>(grassEntityRoot);
@@ -367,106 +400,4 @@ namespace GfxRenderEngine
 
         return true;
     }
-
-    void TerrainBuilder::CalculateTangents()
-    {
-        if (m_Indices.size())
-        {
-            CalculateTangentsFromIndexBuffer(m_Indices);
-        }
-        else
-        {
-            uint vertexCount = m_Vertices.size();
-            if (vertexCount)
-            {
-                std::vector<uint> indices;
-                indices.resize(vertexCount);
-                for (uint i = 0; i < vertexCount; i++)
-                {
-                    indices[i] = i;
-                }
-                CalculateTangentsFromIndexBuffer(indices);
-            }
-        }
-    }
-
-    void TerrainBuilder::CalculateTangentsFromIndexBuffer(std::vector<uint> const& indices)
-    {
-        uint cnt = 0;
-        uint vertexIndex1 = 0;
-        uint vertexIndex2 = 0;
-        uint vertexIndex3 = 0;
-        glm::vec3 position1 = glm::vec3{0.0f};
-        glm::vec3 position2 = glm::vec3{0.0f};
-        glm::vec3 position3 = glm::vec3{0.0f};
-        glm::vec2 uv1 = glm::vec2{0.0f};
-        glm::vec2 uv2 = glm::vec2{0.0f};
-        glm::vec2 uv3 = glm::vec2{0.0f};
-
-        for (uint index : indices)
-        {
-            auto& vertex = m_Vertices[index];
-
-            switch (cnt)
-            {
-                case 0:
-                    position1 = vertex.m_Position;
-                    uv1 = vertex.m_UV;
-                    vertexIndex1 = index;
-                    break;
-                case 1:
-                    position2 = vertex.m_Position;
-                    uv2 = vertex.m_UV;
-                    vertexIndex2 = index;
-                    break;
-                case 2:
-                    position3 = vertex.m_Position;
-                    uv3 = vertex.m_UV;
-                    vertexIndex3 = index;
-
-                    glm::vec3 edge1 = position2 - position1;
-                    glm::vec3 edge2 = position3 - position1;
-                    glm::vec2 deltaUV1 = uv2 - uv1;
-                    glm::vec2 deltaUV2 = uv3 - uv1;
-
-                    float dU1 = deltaUV1.x;
-                    float dU2 = deltaUV2.x;
-                    float dV1 = deltaUV1.y;
-                    float dV2 = deltaUV2.y;
-                    float E1x = edge1.x;
-                    float E2x = edge2.x;
-                    float E1y = edge1.y;
-                    float E2y = edge2.y;
-                    float E1z = edge1.z;
-                    float E2z = edge2.z;
-
-                    float factor;
-                    if ((dU1 * dV2 - dU2 * dV1) > std::numeric_limits<float>::epsilon())
-                    {
-                        factor = 1.0f / (dU1 * dV2 - dU2 * dV1);
-                    }
-                    else
-                    {
-                        factor = 100000.0f;
-                    }
-
-                    glm::vec3 tangent;
-
-                    tangent.x = factor * (dV2 * E1x - dV1 * E2x);
-                    tangent.y = factor * (dV2 * E1y - dV1 * E2y);
-                    tangent.z = factor * (dV2 * E1z - dV1 * E2z);
-                    if (tangent.x == 0.0f && tangent.y == 0.0f && tangent.z == 0.0f)
-                    {
-                        tangent = glm::vec3(1.0f, 0.0f, 0.0f);
-                    }
-
-                    m_Vertices[vertexIndex1].m_Tangent = tangent;
-                    m_Vertices[vertexIndex2].m_Tangent = tangent;
-                    m_Vertices[vertexIndex3].m_Tangent = tangent;
-
-                    break;
-            }
-            cnt = (cnt + 1) % 3;
-        }
-    }
 } // namespace GfxRenderEngine
@@ -39,8 +39,6 @@ namespace GfxRenderEngine
     private:
         bool PopulateTerrainData(Image const& heightMap);
         void ColorTerrain(Terrain::TerrainSpec const& terrainSpec, Image const& heightMap);
-        void CalculateTangents();
-        void CalculateTangentsFromIndexBuffer(std::vector<uint> const& indices);
 
     public:
         std::vector<uint> m_Indices{};
@@ -0,0 +1,95 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <future>
+
+#include "core.h"
+#include "renderer/builder/texturePrefetcher.h"
+#include "auxiliary/instrumentation.h"
+#include "auxiliary/file.h"
+
+namespace GfxRenderEngine
+{
+    TexturePrefetcher::Key TexturePrefetcher::MakeKey(std::vector<std::string> const& candidates, bool sRGB,
+                                                      Texture::Usage usage)
+    {
+        return {candidates.empty() ? std::string() : candidates[0], sRGB, static_cast<int>(usage)};
+    }
+
+    void TexturePrefetcher::Add(std::vector<std::string> const& candidates, bool sRGB, Texture::Usage usage)
+    {
+        if (candidates.empty())
+        {
+            return;
+        }
+        m_Requests.try_emplace(MakeKey(candidates, sRGB, usage), Request{candidates, sRGB, usage, nullptr});
+    }
+
+    void TexturePrefetcher::Load()
+    {
+        ZoneScopedN("TexturePrefetcher::Load");
+        std::vector<std::future<std::shared_ptr<Texture>>> futures;
+        futures.reserve(m_Requests.size());
+        for (auto& [key, request] : m_Requests)
+        {
+            Request const* requestPtr = &request;
+            futures.push_back(Engine::m_Engine->m_PoolSecondary.SubmitTask(
+                [requestPtr]() { return LoadFile(requestPtr->m_Candidates, requestPtr->m_SRGB, requestPtr->m_Usage); }));
+        }
+
+        uint futureIndex = 0;
+        for (auto& [key, request] : m_Requests)
+        {
+            // help with the loading instead of blocking this thread
+            request.m_Texture = Engine::m_Engine->m_PoolSecondary.WaitFor(futures[futureIndex]);
+            ++futureIndex;
+        }
+    }
+
+    std::shared_ptr<Texture> TexturePrefetcher::Get(std::vector<std::string> const& candidates, bool sRGB,
+                                                    Texture::Usage usage)
+    {
+        auto iterator = m_Requests.find(MakeKey(candidates, sRGB, usage));
+        if (iterator != m_Requests.end())
+        {
+            return iterator->second.m_Texture;
+        }
+        return LoadFile(candidates, sRGB, usage);
+    }
+
+    std::shared_ptr<Texture> TexturePrefetcher::LoadFile(std::vector<std::string> const& candidates, bool sRGB,
+                                                         Texture::Usage usage)
+    {
+        for (auto const& filepath : candidates)
+        {
+            if (EngineCore::FileExists(filepath) && !EngineCore::IsDirectory(filepath))
+            {
+                auto texture = Engine::m_Engine->m_TextureCache.LoadFile(filepath, sRGB, true /*flip*/, usage);
+                if (texture)
+                {
+                    return texture;
+                }
+            }
+        }
+        return nullptr;
+    }
+} // namespace GfxRenderEngine
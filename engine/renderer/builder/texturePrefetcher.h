@@ -0,0 +1,67 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "renderer/texture.h"
+
+namespace GfxRenderEngine
+{
+    // loads the texture files of a model concurrently on the secondary thread pool
+    // builders queue the textures their materials reference, call Load() once,
+    // and pick up the results with Get() while building the materials
+    class TexturePrefetcher
+    {
+
+    public:
+        // the candidate paths are tried in order, the first existing file is loaded
+        void Add(std::vector<std::string> const& candidates, bool sRGB, Texture::Usage usage = Texture::USAGE_COLOR);
+        void Load();
+
+        // textures that were not queued are loaded on the calling thread
+        // returns nullptr if none of the candidates could be loaded
+        std::shared_ptr<Texture> Get(std::vector<std::string> const& candidates, bool sRGB,
+                                     Texture::Usage usage = Texture::USAGE_COLOR);
+
+    private:
+        using Key = std::tuple<std::string, bool, int>;
+        struct Request
+        {
+            std::vector<std::string> m_Candidates;
+            bool m_SRGB;
+            Texture::Usage m_Usage;
+            std::shared_ptr<Texture> m_Texture;
+        };
+
+        static Key MakeKey(std::vector<std::string> const& candidates, bool sRGB, Texture::Usage usage);
+        static std::shared_ptr<Texture> LoadFile(std::vector<std::string> const& candidates, bool sRGB,
+                                                 Texture::Usage usage);
+
+    private:
+        std::map<Key, Request> m_Requests;
+    };
+} // namespace GfxRenderEngine
@@ -26,6 +26,8 @@
 #include "core.h"
 #include "renderer/instanceBuffer.h"
 #include "renderer/builder/ufbxBuilder.h"
+#include "renderer/builder/tangentGenerator.h"
+#include "renderer/builder/lodGenerator.h"
 #include "renderer/materialDescriptor.h"
 #include "auxiliary/instrumentation.h"
 #include "auxiliary/file.h"
@@ -34,11 +36,62 @@
 
 namespace GfxRenderEngine
 {
+    namespace
+    {
+        // runs the tasks of the ufbx parser on the primary thread pool
+        // ufbx calls Run() and Wait() from the loading thread only
+        class UFbxThreadPool
+        {
+        public:
+            UFbxThreadPool() : m_ThreadPool{Engine::m_Engine->m_PoolPrimary} {}
+
+            ufbx_thread_pool GetPool()
+            {
+                ufbx_thread_pool pool{};
+                pool.run_fn = Run;
+                pool.wait_fn = Wait;
+                pool.user = this;
+                return pool;
+            }
+
+        private:
+            static bool Run(void* user, ufbx_thread_pool_context context, uint32_t group, uint32_t startIndex,
+                            uint32_t count)
+            {
+                ThreadPool::TaskGroup& taskGroup = static_cast<UFbxThreadPool*>(user)->GetGroup(group);
+                for (uint32_t index = startIndex; index < startIndex + count; ++index)
+                {
+                    taskGroup.Run([context, index]() { ufbx_thread_pool_run_task(context, index); });
+                }
+                return true;
+            }
+
+            // waits for all tasks of a group, the calling thread helps with the work
+            static bool Wait(void* user, ufbx_thread_pool_context, uint32_t group, uint32_t)
+            {
+                static_cast<UFbxThreadPool*>(user)->GetGroup(group).Wait();
+                return true;
+            }
+
+            ThreadPool::TaskGroup& GetGroup(uint32_t group)
+            {
+                while (m_Groups.size() <= group)
+                {
+                    m_Groups.push_back(std::make_unique<ThreadPool::TaskGroup>(m_ThreadPool));
+                }
+                return *m_Groups[group];
+            }
+
+        private:
+            ThreadPool& m_ThreadPool;
+            std::vector<std::unique_ptr<ThreadPool::TaskGroup>> m_Groups;
+        };
+    } // namespace
 
     UFbxBuilder::UFbxBuilder(const std::string& filepath, Scene& scene)
         : m_Filepath{filepath}, m_SkeletalAnimation{false}, m_Registry{scene.GetRegistry()},
           m_SceneGraph{scene.GetSceneGraph()}, m_Dictionary{scene.GetDictionary()}, m_InstanceCount{0}, m_InstanceIndex{0},
-          m_FbxScene{nullptr}, m_FbxNoBuiltInTangents{false}
+          m_FbxScene{nullptr}
     {
         m_Basepath = EngineCore::GetPathWithoutFilename(filepath);
     }
@@ -57,6 +110,10 @@ namespace GfxRenderEngine
         };
         loadOptions.target_unit_meters = 1.0f;
 
+        // parse in parallel on the primary thread pool
+        UFbxThreadPool threadPool;
+        loadOptions.thread_opts.pool = threadPool.GetPool();
+
         // load raw data of the file (can be fbx or obj)
         ufbx_error ufbxError;
         m_FbxScene = ufbx_load_file(m_Filepath.c_str(), &loadOptions, &ufbxError);
@@ -80,8 +137,10 @@ namespace GfxRenderEngine
             LOG_CORE_WARN("UFbxBuilder::Load: scene ID for fbx not supported (in file {0})", m_Filepath);
         }
 
+        m_InstanceCount = instanceCount;
         LoadSkeletonsFbx();
         LoadMaterials();
+        LoadVertexData();
 
         // PASS 1
         // mark Fbx nodes to receive a game object ID if they have a mesh or any child has
@@ -89,13 +148,13 @@ namespace GfxRenderEngine
         MarkNode(m_FbxScene->root_node);
 
         // PASS 2 (for all instances)
-        m_InstanceCount = instanceCount;
         for (m_InstanceIndex = 0; m_InstanceIndex < m_InstanceCount; ++m_InstanceIndex)
         {
             uint hasMeshIndex = Fbx::FBX_ROOT_NODE;
             m_RenderObject = 0;
             ProcessNode(m_FbxScene->root_node, SceneGraph::ROOT_NODE, hasMeshIndex);
         }
+        m_MeshData.clear();
         ufbx_free_scene(m_FbxScene);
         return Fbx::FBX_LOAD_SUCCESS;
     }
@@ -107,9 +166,9 @@ namespace GfxRenderEngine
         // does this Fbx node have a mesh?
         bool localHasMesh = false;
 
-        // check if triangle mesh
+        // check if triangle mesh (levels of detail are part of their base mesh)
 
-        if (fbxNodePtr->mesh && fbxNodePtr->mesh->num_triangles)
+        if (fbxNodePtr->mesh && fbxNodePtr->mesh->num_triangles && !m_MeshData[fbxNodePtr->typed_id].m_IsLod)
         {
             localHasMesh = true;
         }
@@ -144,7 +203,7 @@ namespace GfxRenderEngine
 
         if (m_HasMesh[hasMeshIndex])
         {
-            if (fbxNodePtr->mesh && fbxNodePtr->mesh->num_triangles)
+            if (fbxNodePtr->mesh && fbxNodePtr->mesh->num_triangles && !m_MeshData[fbxNodePtr->typed_id].m_IsLod)
             {
                 currentNode = CreateGameObject(fbxNodePtr, parentNode);
             }
@@ -231,14 +290,16 @@ namespace GfxRenderEngine
             instanceTag.m_Instances.push_back(entity);
             m_InstanceBuffer = InstanceBuffer::Create(m_InstanceCount);
             instanceTag.m_InstanceBuffer = m_InstanceBuffer;
-            instanceTag.m_InstanceBuffer->SetInstanceData(m_InstanceIndex, transform.GetMat4Global(),
-                                                          transform.GetNormalMatrix());
+            instanceTag.m_InstanceBuffer->SetInstanceData(m_InstanceIndex, transform.GetMat4Global());
             m_Registry.emplace<InstanceTag>(entity, instanceTag);
             transform.SetInstance(m_InstanceBuffer, m_InstanceIndex);
             m_InstancedObjects.push_back(entity);
 
             // create model for 1st instance
-            LoadVertexData(fbxNodePtr);
+            MeshData& meshData = m_MeshData[fbxNodePtr->typed_id];
+            m_Vertices = std::move(meshData.m_Vertices);
+            m_Indices = std::move(meshData.m_Indices);
+            m_Submeshes = std::move(meshData.m_Submeshes);
             LOG_CORE_INFO("Vertex count: {0}, Index count: {1} (file: {2}, node: {3})", m_Vertices.size(), m_Indices.size(),
                           m_Filepath, nodeName);
             for (uint submeshIndex = 0; submeshIndex < fbxNodePtr->mesh->material_parts.count; ++submeshIndex)
@@ -266,8 +327,7 @@ namespace GfxRenderEngine
             entt::entity instance = m_InstancedObjects[m_RenderObject++];
             InstanceTag& instanceTag = m_Registry.get<InstanceTag>(instance);
             instanceTag.m_Instances.push_back(entity);
-            instanceTag.m_InstanceBuffer->SetInstanceData(m_InstanceIndex, transform.GetMat4Global(),
-                                                          transform.GetNormalMatrix());
+            instanceTag.m_InstanceBuffer->SetInstanceData(m_InstanceIndex, transform.GetMat4Global());
             transform.SetInstance(instanceTag.m_InstanceBuffer, m_InstanceIndex);
         }
 
@@ -280,34 +340,20 @@ namespace GfxRenderEngine
         return newNode;
     }
 
-    std::shared_ptr<Texture> UFbxBuilder::LoadTexture(ufbx_material_map const& materialMap, bool useSRGB)
+    std::vector<std::string> UFbxBuilder::GetTextureCandidates(ufbx_material_map const& materialMap)
     {
-        std::shared_ptr<Texture> texture;
-        auto createTexture = [&](ufbx_string const& str)
-        {
-            std::string filepath(str.data);
-            if (EngineCore::FileExists(filepath) && !EngineCore::IsDirectory(filepath))
-            {
-                texture = Texture::Create();
-                if (texture->Init(filepath, useSRGB))
-                {
-                    m_Textures.push_back(texture);
-                    return true;
-                }
-            }
-            return false;
-        };
+        ufbx_texture const& texture = *materialMap.texture;
+        return {std::string(texture.filename.data), std::string(texture.absolute_filename.data),
+                std::string(texture.relative_filename.data)};
+    }
 
-        if (createTexture(materialMap.texture->filename))
-        {
-            return texture;
-        }
-        if (createTexture(materialMap.texture->absolute_filename))
-        {
-            return texture;
-        }
-        if (createTexture(materialMap.texture->relative_filename))
+    std::shared_ptr<Texture> UFbxBuilder::LoadTexture(ufbx_material_map const& materialMap, bool useSRGB,
+                                                      Texture::Usage usage)
+    {
+        auto texture = m_TexturePrefetcher.Get(GetTextureCandidates(materialMap), useSRGB, usage);
+        if (texture)
         {
+            m_Textures.push_back(texture);
             return texture;
         }
 
@@ -317,6 +363,39 @@ namespace GfxRenderEngine
         return nullptr;
     }
 
+    // queues the same maps that LoadMaterial() uses, so that they are decoded concurrently
+    void UFbxBuilder::PrefetchTextures()
+    {
+        for (const ufbx_material* fbxMaterial : m_FbxScene->materials)
+        {
+            ufbx_material_pbr_maps const& pbr = fbxMaterial->pbr;
+            if (pbr.base_color.has_value && pbr.base_color.texture)
+            {
+                m_TexturePrefetcher.Add(GetTextureCandidates(pbr.base_color), Texture::USE_SRGB);
+            }
+            if (pbr.roughness.has_value && pbr.roughness.texture)
+            {
+                m_TexturePrefetcher.Add(GetTextureCandidates(pbr.roughness), Texture::USE_UNORM,
+                                        Texture::USAGE_GRAYSCALE_MAP);
+            }
+            if (pbr.metalness.has_value && pbr.metalness.texture)
+            {
+                m_TexturePrefetcher.Add(GetTextureCandidates(pbr.metalness), Texture::USE_UNORM,
+                                        Texture::USAGE_GRAYSCALE_MAP);
+            }
+            if (pbr.normal_map.texture)
+            {
+                m_TexturePrefetcher.Add(GetTextureCandidates(pbr.normal_map), Texture::USE_UNORM,
+                                        Texture::USAGE_NORMAL_MAP);
+            }
+            if (pbr.emission_color.texture)
+            {
+                m_TexturePrefetcher.Add(GetTextureCandidates(pbr.emission_color), Texture::USE_SRGB);
+            }
+        }
+        m_TexturePrefetcher.Load();
+    }
+
     void UFbxBuilder::LoadMaterial(const ufbx_material* fbxMaterial, ufbx_material_pbr_map materialProperty,
                                    int materialIndex)
     {
@@ -361,7 +440,7 @@ namespace GfxRenderEngine
                 {
                     if (materialMap.texture)
                     {
-                        if (auto texture = LoadTexture(materialMap, Texture::USE_UNORM))
+                        if (auto texture = LoadTexture(materialMap, Texture::USE_UNORM, Texture::USAGE_GRAYSCALE_MAP))
                         {
                             materialTextures[Material::ROUGHNESS_MAP_INDEX] = texture;
                             pbrMaterial.m_Features |= Material::HAS_ROUGHNESS_MAP;
@@ -381,7 +460,7 @@ namespace GfxRenderEngine
                 {
                     if (materialMap.texture)
                     {
-                        if (auto texture = LoadTexture(materialMap, Texture::USE_UNORM))
+                        if (auto texture = LoadTexture(materialMap, Texture::USE_UNORM, Texture::USAGE_GRAYSCALE_MAP))
                         {
                             materialTextures[Material::METALLIC_MAP_INDEX] = texture;
                             pbrMaterial.m_Features |= Material::HAS_METALLIC_MAP;
@@ -399,7 +478,7 @@ namespace GfxRenderEngine
                 ufbx_material_map const& materialMap = fbxMaterial->pbr.normal_map;
                 if (materialMap.texture)
                 {
-                    if (auto texture = LoadTexture(materialMap, Texture::USE_UNORM))
+                    if (auto texture = LoadTexture(materialMap, Texture::USE_UNORM, Texture::USAGE_NORMAL_MAP))
                     {
                         materialTextures[Material::NORMAL_MAP_INDEX] = texture;
                         pbrMaterial.m_Features |= Material::HAS_NORMAL_MAP;
@@ -448,6 +527,7 @@ namespace GfxRenderEngine
         uint numMaterials = m_FbxScene->materials.count;
         m_Materials.resize(numMaterials);
         m_MaterialTextures.resize(numMaterials);
+        PrefetchTextures();
         for (uint materialIndex = 0; materialIndex < numMaterials; ++materialIndex)
         {
             const ufbx_material* fbxMaterial = m_FbxScene->materials[materialIndex];
@@ -465,31 +545,168 @@ namespace GfxRenderEngine
     }
 
     // handle vertex data
-    void UFbxBuilder::LoadVertexData(const ufbx_node* fbxNodePtr)
+    // the submeshes of all mesh nodes are extracted in parallel, each job writes into
+    // its own preallocated range of the node's buffers
+    void UFbxBuilder::LoadVertexData()
     {
-        m_Vertices.clear();
-        m_Indices.clear();
-        m_Submeshes.clear();
-
-        m_FbxNoBuiltInTangents = false;
+        ZoneScopedN("UFbxBuilder::LoadVertexData");
+        struct SubmeshJob
+        {
+            const ufbx_node* m_Node;
+            uint m_SubmeshIndex;
+        };
+        std::vector<SubmeshJob> jobs;
 
-        ufbx_mesh& fbxMesh = *fbxNodePtr->mesh; // mesh for this node, contains submeshes
-        uint numSubmeshes = fbxMesh.material_parts.count;
-        if (numSubmeshes)
+        m_MeshData.clear();
+        m_MeshData.resize(m_FbxScene->nodes.count);
+        for (const ufbx_node* fbxNodePtr : m_FbxScene->nodes)
         {
-            m_Submeshes.resize(numSubmeshes);
+            if (!(fbxNodePtr->mesh && fbxNodePtr->mesh->num_triangles))
+            {
+                continue;
+            }
+            MeshData& meshData = m_MeshData[fbxNodePtr->typed_id];
+            uint numSubmeshes = fbxNodePtr->mesh->material_parts.count;
+            meshData.m_Submeshes.resize(numSubmeshes);
+
+            // reserve three vertices per triangle, ufbx_generate_indices() shrinks the ranges later
+            uint numCorners = 0;
             for (uint submeshIndex = 0; submeshIndex < numSubmeshes; ++submeshIndex)
             {
-                LoadVertexData(fbxNodePtr, submeshIndex);
+                uint submeshCorners = fbxNodePtr->mesh->material_parts[submeshIndex].num_triangles * 3;
+                Submesh& submesh = meshData.m_Submeshes[submeshIndex];
+                submesh.m_FirstVertex = numCorners;
+                submesh.m_FirstIndex = numCorners;
+                submesh.m_VertexCount = 0;
+                submesh.m_IndexCount = 0;
+                submesh.m_InstanceCount = m_InstanceCount;
+                numCorners += submeshCorners;
+                jobs.push_back({fbxNodePtr, submeshIndex});
             }
-            if (m_FbxNoBuiltInTangents) // at least one mesh did not have tangents
+            meshData.m_Vertices.resize(numCorners);
+            meshData.m_Indices.resize(numCorners);
+        }
+
+        Engine::m_Engine->m_PoolPrimary.ParallelFor(0, jobs.size(), 1 /*grain size*/,
+                                                    [&](uint firstJob, uint lastJob)
+                                                    {
+                                                        for (uint jobIndex = firstJob; jobIndex < lastJob; ++jobIndex)
+                                                        {
+                                                            SubmeshJob const& job = jobs[jobIndex];
+                                                            LoadVertexData(m_MeshData[job.m_Node->typed_id], job.m_Node,
+                                                                           job.m_SubmeshIndex);
+                                                        }
+                                                    });
+
+        // close the gaps left by the deduplicated vertices
+        for (MeshData& meshData : m_MeshData)
+        {
+            uint vertexOffset = 0;
+            for (Submesh& submesh : meshData.m_Submeshes)
             {
-                CalculateTangents();
+                auto first = meshData.m_Vertices.begin() + submesh.m_FirstVertex;
+                std::copy(first, first + submesh.m_VertexCount, meshData.m_Vertices.begin() + vertexOffset);
+                submesh.m_FirstVertex = vertexOffset;
+                vertexOffset += submesh.m_VertexCount;
             }
+            meshData.m_Vertices.resize(vertexOffset);
         }
+
+        MergeLodNodes();
+        Engine::m_Engine->m_PoolPrimary.ParallelFor(0, m_MeshData.size(), 1 /*grain size*/,
+                                                    [&](uint firstMesh, uint lastMesh)
+                                                    {
+                                                        for (uint meshIndex = firstMesh; meshIndex < lastMesh; ++meshIndex)
+                                                        {
+                                                            MeshData& meshData = m_MeshData[meshIndex];
+                                                            if (!meshData.m_IsLod)
+                                                            {
+                                                                LodGenerator::Generate(meshData.m_Vertices,
+                                                                                       meshData.m_Indices,
+                                                                                       meshData.m_Submeshes);
+                                                            }
+                                                        }
+                                                    });
     }
 
-    void UFbxBuilder::LoadVertexData(const ufbx_node* fbxNodePtr, uint const submeshIndex)
+    // DCC naming convention: the mesh nodes "<name>_LOD1", "<name>_LOD2", ... are the levels of detail
+    // of their sibling "<name>" or "<name>_LOD0", they must share its transform
+    // the submeshes of the levels are matched by material
+    void UFbxBuilder::MergeLodNodes()
+    {
+        struct LodNode
+        {
+            const ufbx_node* m_Base;
+            const ufbx_node* m_Lod;
+            int m_Level;
+        };
+        std::vector<LodNode> lodNodes;
+
+        auto isMesh = [](const ufbx_node* fbxNodePtr) { return fbxNodePtr->mesh && fbxNodePtr->mesh->num_triangles; };
+        for (const ufbx_node* fbxNodePtr : m_FbxScene->nodes)
+        {
+            if (!isMesh(fbxNodePtr) || !fbxNodePtr->parent)
+            {
+                continue;
+            }
+            std::string_view baseName;
+            int level = LodGenerator::ParseLodName({fbxNodePtr->name.data, fbxNodePtr->name.length}, baseName);
+            if (level < 1)
+            {
+                continue;
+            }
+            for (const ufbx_node* sibling : fbxNodePtr->parent->children)
+            {
+                std::string_view siblingName{sibling->name.data, sibling->name.length};
+                std::string_view siblingBaseName;
+                bool isLod0 = (LodGenerator::ParseLodName(siblingName, siblingBaseName) == 0);
+                bool isBase = (siblingName == baseName) || (isLod0 && (siblingBaseName == baseName));
+                if (isBase && isMesh(sibling))
+                {
+                    lodNodes.push_back({sibling, fbxNodePtr, level});
+                    break;
+                }
+            }
+        }
+        std::sort(lodNodes.begin(), lodNodes.end(),
+                  [](LodNode const& lhs, LodNode const& rhs)
+                  {
+                      return (lhs.m_Base->typed_id != rhs.m_Base->typed_id) ? (lhs.m_Base->typed_id < rhs.m_Base->typed_id)
+                                                                              : (lhs.m_Level < rhs.m_Level);
+                  });
+
+        auto getMaterial = [](const ufbx_node* fbxNodePtr, size_t submeshIndex) -> const ufbx_material*
+        {
+            ufbx_material_list const& materials = fbxNodePtr->mesh->materials;
+            return (submeshIndex < materials.count) ? materials.data[submeshIndex] : nullptr;
+        };
+        for (auto const& lodNode : lodNodes)
+        {
+            MeshData& meshData = m_MeshData[lodNode.m_Base->typed_id];
+            MeshData& lodMeshData = m_MeshData[lodNode.m_Lod->typed_id];
+            for (size_t submeshIndex = 0; submeshIndex < meshData.m_Submeshes.size(); ++submeshIndex)
+            {
+                size_t lodSubmeshIndex = submeshIndex;
+                for (size_t candidate = 0; candidate < lodMeshData.m_Submeshes.size(); ++candidate)
+                {
+                    if (getMaterial(lodNode.m_Lod, candidate) == getMaterial(lodNode.m_Base, submeshIndex))
+                    {
+                        lodSubmeshIndex = candidate;
+                        break;
+                    }
+                }
+                if (lodSubmeshIndex < lodMeshData.m_Submeshes.size())
+                {
+                    LodGenerator::AppendLevel(meshData.m_Vertices, meshData.m_Indices, meshData.m_Submeshes[submeshIndex],
+                                              lodMeshData.m_Vertices, lodMeshData.m_Indices,
+                                              lodMeshData.m_Submeshes[lodSubmeshIndex]);
+                }
+            }
+            lodMeshData.m_IsLod = true;
+        }
+    }
+
+    void UFbxBuilder::LoadVertexData(MeshData& meshData, const ufbx_node* fbxNodePtr, uint const submeshIndex)
     {
         ufbx_mesh& fbxMesh = *fbxNodePtr->mesh; // mesh for this node, contains submeshes
         const ufbx_mesh_part& fbxSubmesh = fbxNodePtr->mesh->material_parts[submeshIndex];
@@ -501,15 +718,10 @@ namespace GfxRenderEngine
             return;
         }
 
-        size_t numVerticesBefore = m_Vertices.size();
-        size_t numIndicesBefore = m_Indices.size();
-
-        Submesh& submesh = m_Submeshes[submeshIndex];
-        submesh.m_FirstVertex = numVerticesBefore;
-        submesh.m_FirstIndex = numIndicesBefore;
-        // submesh.m_VertexCount = 0;
-        submesh.m_IndexCount = 0;
-        submesh.m_InstanceCount = m_InstanceCount;
+        Submesh& submesh = meshData.m_Submeshes[submeshIndex];
+        uint numVerticesBefore = submesh.m_FirstVertex;
+        uint numIndicesBefore = submesh.m_FirstIndex;
+        uint vertexIndex = numVerticesBefore;
 
         glm::vec4 diffuseColor;
         {
@@ -529,7 +741,6 @@ namespace GfxRenderEngine
                 fbxSkin = fbxMesh.skin_deformers.data[0];
             }
 
-            m_FbxNoBuiltInTangents = m_FbxNoBuiltInTangents || (!hasTangents);
             for (size_t fbxFaceIndex = 0; fbxFaceIndex < numFaces; ++fbxFaceIndex)
             {
                 ufbx_face& fbxFace = fbxMesh.faces[fbxSubmesh.face_indices.data[fbxFaceIndex]];
@@ -566,7 +777,16 @@ namespace GfxRenderEngine
                         CORE_ASSERT(fbxTangentIndex < fbxMesh.vertex_tangent.values.count,
                                     "LoadVertexData: memory violation tangents");
                         ufbx_vec3& tangentFbx = fbxMesh.vertex_tangent.values.data[fbxTangentIndex];
-                        vertex.m_Tangent = glm::vec3(tangentFbx.x, tangentFbx.y, tangentFbx.z);
+                        glm::vec3 tangent{tangentFbx.x, tangentFbx.y, tangentFbx.z};
+                        // handedness in w, see TangentGenerator; right-handed without bitangents
+                        float sign = 1.0f;
+                        if (fbxMesh.vertex_bitangent.exists)
+                        {
+                            ufbx_vec3 bitangentFbx = ufbx_get_vertex_vec3(&fbxMesh.vertex_bitangent, vertexPerFaceIndex);
+                            glm::vec3 bitangent{bitangentFbx.x, bitangentFbx.y, bitangentFbx.z};
+                            sign = glm::dot(glm::cross(vertex.m_Normal, tangent), bitangent) < 0.0f ? -1.0f : 1.0f;
+                        }
+                        vertex.m_Tangent = glm::vec4(tangent, sign);
                     }
 
                     if (hasUVs) // uv coordinates
@@ -635,7 +855,7 @@ namespace GfxRenderEngine
                             }
                         }
                     }
-                    m_Vertices.push_back(vertex);
+                    meshData.m_Vertices[vertexIndex++] = vertex;
                 }
             }
         }
@@ -644,22 +864,20 @@ namespace GfxRenderEngine
         // A face has four vertices, while above loop generates at least six vertices for per face)
         {
             // get number of all vertices created from above (faces * trianglesPerFace * 3)
-            uint submeshAllVertices = m_Vertices.size() - numVerticesBefore;
+            uint submeshAllVertices = vertexIndex - numVerticesBefore;
 
             // create a ufbx vertex stream with data pointing to the first vertex of this submesh
-            // (m_vertices is for all submeshes)
+            // (meshData.m_Vertices is for all submeshes)
             ufbx_vertex_stream streams;
-            streams.data = &m_Vertices[numVerticesBefore];
+            streams.data = &meshData.m_Vertices[numVerticesBefore];
             streams.vertex_count = submeshAllVertices;
             streams.vertex_size = sizeof(Vertex);
 
-            // index buffer: add space for all new vertices from above
-            m_Indices.resize(numIndicesBefore + submeshAllVertices);
-
-            // ufbx_generate_indices() will rearrange m_Vertices (via streams.data) and fill m_Indices
+            // ufbx_generate_indices() will rearrange the vertices (via streams.data) and fill the index range
             ufbx_error ufbxError;
-            size_t numVertices = ufbx_generate_indices(&streams, 1 /*size_t num_streams*/, &m_Indices[numIndicesBefore],
-                                                       submeshAllVertices, nullptr, &ufbxError);
+            size_t numVertices =
+                ufbx_generate_indices(&streams, 1 /*size_t num_streams*/, &meshData.m_Indices[numIndicesBefore],
+                                      submeshAllVertices, nullptr, &ufbxError);
 
             // handle error
             if (ufbxError.type != UFBX_ERROR_NONE)
@@ -668,12 +886,19 @@ namespace GfxRenderEngine
                 ufbx_format_error(errorBuffer, sizeof(errorBuffer), &ufbxError);
                 LOG_CORE_CRITICAL("UFbxBuilder: creation of index buffer failed, file: {0}, error: {1},  node: {2}",
                                   m_Filepath, errorBuffer, fbxNodePtr->name.data);
+                return;
             }
 
-            // m_Vertices can be downsized now
-            m_Vertices.resize(numVerticesBefore + numVertices);
+            // the unused tail of the vertex range is removed in LoadVertexData()
             submesh.m_VertexCount = numVertices;
             submesh.m_IndexCount = submeshAllVertices;
+
+            // calculate tangents
+            if (!fbxMesh.vertex_tangent.exists)
+            {
+                TangentGenerator::Generate(meshData.m_Vertices.data() + numVerticesBefore, numVertices,
+                                           meshData.m_Indices.data() + numIndicesBefore, submeshAllVertices);
+            }
         }
     }
 
@@ -729,106 +954,6 @@ namespace GfxRenderEngine
         LOG_CORE_INFO("material assigned (ufbx): material index {0}", materialIndex);
     }
 
-    void UFbxBuilder::CalculateTangents()
-    {
-        if (m_Indices.size())
-        {
-            CalculateTangentsFromIndexBuffer(m_Indices);
-        }
-        else
-        {
-            uint vertexCount = m_Vertices.size();
-            if (vertexCount)
-            {
-                std::vector<uint> indices;
-                indices.resize(vertexCount);
-                for (uint i = 0; i < vertexCount; i++)
-                {
-                    indices[i] = i;
-                }
-                CalculateTangentsFromIndexBuffer(indices);
-            }
-        }
-    }
-
-    void UFbxBuilder::CalculateTangentsFromIndexBuffer(const std::vector<uint>& indices)
-    {
-        uint cnt = 0;
-        uint vertexIndex1 = 0;
-        uint vertexIndex2 = 0;
-        uint vertexIndex3 = 0;
-        glm::vec3 position1 = glm::vec3{0.0f};
-        glm::vec3 position2 = glm::vec3{0.0f};
-        glm::vec3 position3 = glm::vec3{0.0f};
-        glm::vec2 uv1 = glm::vec2{0.0f};
-        glm::vec2 uv2 = glm::vec2{0.0f};
-        glm::vec2 uv3 = glm::vec2{0.0f};
-
-        for (uint index : indices)
-        {
-            auto& vertex = m_Vertices[index];
-
-            switch (cnt)
-            {
-                case 0:
-                    position1 = vertex.m_Position;
-                    uv1 = vertex.m_UV;
-                    vertexIndex1 = index;
-                    break;
-                case 1:
-                    position2 = vertex.m_Position;
-                    uv2 = vertex.m_UV;
-                    vertexIndex2 = index;
-                    break;
-                case 2:
-                    position3 = vertex.m_Position;
-                    uv3 = vertex.m_UV;
-                    vertexIndex3 = index;
-
-                    glm::vec3 edge1 = position2 - position1;
-                    glm::vec3 edge2 = position3 - position1;
-                    glm::vec2 deltaUV1 = uv2 - uv1;
-                    glm::vec2 deltaUV2 = uv3 - uv1;
-
-                    float dU1 = deltaUV1.x;
-                    float dU2 = deltaUV2.x;
-                    float dV1 = deltaUV1.y;
-                    float dV2 = deltaUV2.y;
-                    float E1x = edge1.x;
-                    float E2x = edge2.x;
-                    float E1y = edge1.y;
-                    float E2y = edge2.y;
-                    float E1z = edge1.z;
-                    float E2z = edge2.z;
-
-                    float factor;
-                    if ((dU1 * dV2 - dU2 * dV1) > std::numeric_limits<float>::epsilon())
-                    {
-                        factor = 1.0f / (dU1 * dV2 - dU2 * dV1);
-                    }
-                    else
-                    {
-                        factor = 100000.0f;
-                    }
-
-                    glm::vec3 tangent;
-
-                    tangent.x = factor * (dV2 * E1x - dV1 * E2x);
-                    tangent.y = factor * (dV2 * E1y - dV1 * E2y);
-                    tangent.z = factor * (dV2 * E1z - dV1 * E2z);
-                    if (tangent.x == 0.0f && tangent.y == 0.0f && tangent.z == 0.0f)
-                        tangent = glm::vec3(1.0f, 0.0f, 0.0f);
-
-                    m_Vertices[vertexIndex1].m_Tangent = tangent;
-                    m_Vertices[vertexIndex2].m_Tangent = tangent;
-                    m_Vertices[vertexIndex3].m_Tangent = tangent;
-
-                    break;
-            }
-            cnt = (cnt + 1) % 3;
-        }
-    }
-
     void UFbxBuilder::SetDictionaryPrefix(std::string const& dictionaryPrefix) { m_DictionaryPrefix = dictionaryPrefix; }
 
     void UFbxBuilder::PrintProperties(const ufbx_material* fbxMaterial)
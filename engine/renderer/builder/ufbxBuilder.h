@@ -25,6 +25,7 @@
 #include "ufbx/ufbx.h"
 
 #include "renderer/model.h"
+#include "renderer/builder/texturePrefetcher.h"
 #include "scene/fbx.h"
 #include "scene/scene.h"
 
@@ -47,12 +48,25 @@ namespace GfxRenderEngine
         std::vector<Submesh> m_Submeshes{};
 
     private:
-        void LoadVertexData(const ufbx_node* fbxNodePtr);
-        void LoadVertexData(const ufbx_node* fbxNodePtr, uint const submeshIndex);
+        // vertex data of a mesh node, extracted for all nodes before the scene graph is built
+        struct MeshData
+        {
+            std::vector<Vertex> m_Vertices;
+            std::vector<uint> m_Indices;
+            std::vector<Submesh> m_Submeshes;
+            bool m_IsLod{false}; // a level of detail of a sibling, merged into its mesh data
+        };
+
+        void LoadVertexData();
+        void LoadVertexData(MeshData& meshData, const ufbx_node* fbxNodePtr, uint const submeshIndex);
+        void MergeLodNodes();
 
         void LoadMaterials();
         void LoadMaterial(const ufbx_material* fbxMaterial, ufbx_material_pbr_map materialProperty, int materialIndex);
-        std::shared_ptr<Texture> LoadTexture(ufbx_material_map const& materialMap, bool useSRGB);
+        void PrefetchTextures();
+        std::shared_ptr<Texture> LoadTexture(ufbx_material_map const& materialMap, bool useSRGB,
+                                             Texture::Usage usage = Texture::USAGE_COLOR);
+        static std::vector<std::string> GetTextureCandidates(ufbx_material_map const& materialMap);
 
         void AssignMaterial(Submesh& submesh, int const materialIndex);
         void LoadTransformationMatrix(const ufbx_node* fbxNodePtr, glm::vec3& scale, glm::quat& rotation,
@@ -63,9 +77,6 @@ namespace GfxRenderEngine
         void ProcessNode(const ufbx_node* fbxNodePtr, uint parentNode, uint& hasMeshIndex);
         uint CreateGameObject(const ufbx_node* fbxNodePtr, uint const parentNode);
 
-        void CalculateTangentsFromIndexBuffer(const std::vector<uint>& indices);
-        void CalculateTangents();
-
     private:
         std::string m_Filepath;
         std::string m_Basepath;
@@ -73,13 +84,14 @@ namespace GfxRenderEngine
         ufbx_scene* m_FbxScene;
         std::vector<Material> m_Materials;
         std::unordered_map<std::string, uint> m_MaterialNameToIndex;
-        bool m_FbxNoBuiltInTangents;
         std::shared_ptr<Model> m_Model;
         std::shared_ptr<InstanceBuffer> m_InstanceBuffer;
         std::vector<entt::entity> m_InstancedObjects;
         uint m_RenderObject;
         std::vector<std::shared_ptr<Texture>> m_Textures;
         std::vector<Material::MaterialTextures> m_MaterialTextures{};
+        TexturePrefetcher m_TexturePrefetcher;
+        std::vector<MeshData> m_MeshData; // indexed by ufbx_node::typed_id
 
         // scene graph
         uint m_InstanceCount;
@@ -20,6 +20,9 @@
    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
+#include <algorithm>
+#include <limits>
+
 #include "renderer/camera.h"
 #include "transform/matrix.h"
 
@@ -103,6 +106,28 @@ namespace GfxRenderEngine
         m_ViewProjectionMatrix = m_ProjectionMatrix * m_ViewMatrix;
     }
 
+    float Camera::GetScreenSize(glm::mat4 const& modelMatrix, float radius, float screenHeight) const
+    {
+        float scale = std::max({glm::length(glm::vec3(modelMatrix[0])), glm::length(glm::vec3(modelMatrix[1])),
+                                glm::length(glm::vec3(modelMatrix[2]))});
+        float worldRadius = radius * scale;
+
+        // diameter in NDC is 2 * r * p11 / distance, NDC spans 2 units across the screen height
+        float size = worldRadius * std::abs(m_ProjectionMatrix[1][1]) * screenHeight;
+        bool perspective = (m_ProjectionMatrix[2][3] != 0.0f);
+        if (perspective)
+        {
+            glm::vec3 center = glm::vec3(m_ViewMatrix * modelMatrix[3]);
+            float distance = glm::length(center);
+            if (distance <= worldRadius) // camera inside the bounding sphere
+            {
+                return std::numeric_limits<float>::max();
+            }
+            size /= distance;
+        }
+        return size;
+    }
+
     void Camera::SetViewYXZ(const glm::vec3& position, const glm::vec3& rotation)
     {
         m_Position = position;
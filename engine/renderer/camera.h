@@ -57,6 +57,9 @@ namespace GfxRenderEngine
         const glm::mat4& GetViewMatrix() const { return m_ViewMatrix; }
         const std::string& GetName() const { return m_Name; }
 
+        // projected diameter in pixels of a bounding sphere (model space, centered at the origin)
+        float GetScreenSize(glm::mat4 const& modelMatrix, float radius, float screenHeight) const;
+
     private:
         void RecalculateViewMatrix();
 
@@ -0,0 +1,647 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <string_view>
+
+#include "auxiliary/file.h"
+#include "renderer/compressedImage.h"
+
+namespace GfxRenderEngine
+{
+    namespace
+    {
+        // KTX2 stores a VkFormat, the numeric values are fixed by the Vulkan spec
+        struct VkFormatMapping
+        {
+            uint32_t m_VkFormat;
+            CompressedImage::Format m_Format;
+            bool m_sRGB;
+        };
+
+        constexpr VkFormatMapping VK_FORMAT_MAPPINGS[] = {
+            {37, CompressedImage::FORMAT_RGBA8, false},      {43, CompressedImage::FORMAT_RGBA8, true},
+            {131, CompressedImage::FORMAT_BC1, false},       {132, CompressedImage::FORMAT_BC1, true},
+            {133, CompressedImage::FORMAT_BC1, false},       {134, CompressedImage::FORMAT_BC1, true},
+            {137, CompressedImage::FORMAT_BC3, false},       {138, CompressedImage::FORMAT_BC3, true},
+            {139, CompressedImage::FORMAT_BC4, false},       {141, CompressedImage::FORMAT_BC5, false},
+            {145, CompressedImage::FORMAT_BC7, false},       {146, CompressedImage::FORMAT_BC7, true},
+            {147, CompressedImage::FORMAT_ETC2_RGB8, false}, {148, CompressedImage::FORMAT_ETC2_RGB8, true},
+            {151, CompressedImage::FORMAT_ETC2_RGBA8, false}, {152, CompressedImage::FORMAT_ETC2_RGBA8, true},
+            {157, CompressedImage::FORMAT_ASTC_4x4, false},  {158, CompressedImage::FORMAT_ASTC_4x4, true}};
+
+        constexpr uchar KTX2_IDENTIFIER[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+        struct KTX2Header
+        {
+            uchar m_Identifier[12];
+            uint32_t m_VkFormat;
+            uint32_t m_TypeSize;
+            uint32_t m_PixelWidth;
+            uint32_t m_PixelHeight;
+            uint32_t m_PixelDepth;
+            uint32_t m_LayerCount;
+            uint32_t m_FaceCount;
+            uint32_t m_LevelCount;
+            uint32_t m_SupercompressionScheme;
+            uint32_t m_DfdByteOffset;
+            uint32_t m_DfdByteLength;
+            uint32_t m_KvdByteOffset;
+            uint32_t m_KvdByteLength;
+            uint64_t m_SgdByteOffset;
+            uint64_t m_SgdByteLength;
+        };
+        static_assert(sizeof(KTX2Header) == 80);
+
+        struct KTX2LevelIndex
+        {
+            uint64_t m_ByteOffset;
+            uint64_t m_ByteLength;
+            uint64_t m_UncompressedByteLength;
+        };
+
+        // khr_df.h
+        constexpr uint32_t KHR_DF_MODEL_RGBSDA = 1;
+        constexpr uint32_t KHR_DF_MODEL_BC1A = 128;
+        constexpr uint32_t KHR_DF_MODEL_BC3 = 130;
+        constexpr uint32_t KHR_DF_MODEL_BC4 = 131;
+        constexpr uint32_t KHR_DF_MODEL_BC5 = 132;
+        constexpr uint32_t KHR_DF_MODEL_BC7 = 134;
+        constexpr uint32_t KHR_DF_MODEL_ETC2 = 161;
+        constexpr uint32_t KHR_DF_MODEL_ASTC = 162;
+        constexpr uint32_t KHR_DF_PRIMARIES_BT709 = 1;
+        constexpr uint32_t KHR_DF_TRANSFER_LINEAR = 1;
+        constexpr uint32_t KHR_DF_TRANSFER_SRGB = 2;
+
+        constexpr uint32_t MakeFourCC(char a, char b, char c, char d)
+        {
+            return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) | (static_cast<uint32_t>(c) << 16) |
+                   (static_cast<uint32_t>(d) << 24);
+        }
+
+        struct DDSPixelFormat
+        {
+            uint32_t m_Size;
+            uint32_t m_Flags;
+            uint32_t m_FourCC;
+            uint32_t m_RGBBitCount;
+            uint32_t m_RBitMask;
+            uint32_t m_GBitMask;
+            uint32_t m_BBitMask;
+            uint32_t m_ABitMask;
+        };
+
+        struct DDSHeader
+        {
+            uint32_t m_Size;
+            uint32_t m_Flags;
+            uint32_t m_Height;
+            uint32_t m_Width;
+            uint32_t m_PitchOrLinearSize;
+            uint32_t m_Depth;
+            uint32_t m_MipMapCount;
+            uint32_t m_Reserved1[11];
+            DDSPixelFormat m_PixelFormat;
+            uint32_t m_Caps;
+            uint32_t m_Caps2;
+            uint32_t m_Caps3;
+            uint32_t m_Caps4;
+            uint32_t m_Reserved2;
+        };
+        static_assert(sizeof(DDSHeader) == 124);
+
+        struct DDSHeaderDX10
+        {
+            uint32_t m_DxgiFormat;
+            uint32_t m_ResourceDimension;
+            uint32_t m_MiscFlag;
+            uint32_t m_ArraySize;
+            uint32_t m_MiscFlags2;
+        };
+
+        constexpr uint32_t DDPF_FOURCC = 0x4;
+        constexpr uint32_t DDPF_RGB = 0x40;
+        constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200;
+        constexpr uint32_t DDSCAPS2_VOLUME = 0x200000;
+
+        bool ReadFile(std::string const& filename, std::vector<uchar>& buffer)
+        {
+            std::ifstream file(filename, std::ios::binary | std::ios::ate);
+            if (!file.is_open())
+            {
+                return false;
+            }
+            size_t fileSize = static_cast<size_t>(file.tellg());
+            buffer.resize(fileSize);
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(buffer.data()), fileSize);
+            return static_cast<bool>(file);
+        }
+
+        template <typename T> bool Read(std::vector<uchar> const& buffer, size_t offset, T& value)
+        {
+            if (offset + sizeof(T) > buffer.size())
+            {
+                return false;
+            }
+            memcpy(&value, buffer.data() + offset, sizeof(T));
+            return true;
+        }
+
+        template <typename T> void Write(std::vector<uchar>& buffer, size_t offset, T const& value)
+        {
+            memcpy(buffer.data() + offset, &value, sizeof(T));
+        }
+
+        size_t AlignUp(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+    } // namespace
+
+    uint CompressedImage::GetBlockSize(Format format)
+    {
+        switch (format)
+        {
+            case FORMAT_RGBA8:
+                return 4;
+            case FORMAT_BC1:
+            case FORMAT_BC4:
+            case FORMAT_ETC2_RGB8:
+                return 8;
+            case FORMAT_BC3:
+            case FORMAT_BC5:
+            case FORMAT_BC7:
+            case FORMAT_ETC2_RGBA8:
+            case FORMAT_ASTC_4x4:
+                return 16;
+            default:
+                return 0;
+        }
+    }
+
+    size_t CompressedImage::GetLevelSize(Format format, uint width, uint height)
+    {
+        if (!IsBlockCompressed(format))
+        {
+            return static_cast<size_t>(width) * height * GetBlockSize(format);
+        }
+        size_t blocksX = std::max(1u, (width + 3) / 4);
+        size_t blocksY = std::max(1u, (height + 3) / 4);
+        return blocksX * blocksY * GetBlockSize(format);
+    }
+
+    bool CompressedImage::IsCompressedFile(std::string const& filename)
+    {
+        std::string extension = EngineCore::GetFileExtension(filename);
+        for (auto& character : extension)
+        {
+            character = static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+        }
+        return (extension == ".ktx2") || (extension == ".dds");
+    }
+
+    bool CompressedImage::Load(std::string const& filename)
+    {
+        std::string extension = EngineCore::GetFileExtension(filename);
+        for (auto& character : extension)
+        {
+            character = static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+        }
+        if (extension == ".ktx2")
+        {
+            return LoadKTX2(filename);
+        }
+        if (extension == ".dds")
+        {
+            return LoadDDS(filename);
+        }
+        LOG_CORE_ERROR("CompressedImage::Load: unsupported file type {0}", filename);
+        return false;
+    }
+
+    bool CompressedImage::LoadKTX2(std::string const& filename)
+    {
+        std::vector<uchar> buffer;
+        if (!ReadFile(filename, buffer))
+        {
+            LOG_CORE_ERROR("CompressedImage::LoadKTX2: couldn't read {0}", filename);
+            return false;
+        }
+
+        KTX2Header header;
+        if (!Read(buffer, 0, header) || memcmp(header.m_Identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)))
+        {
+            LOG_CORE_ERROR("CompressedImage::LoadKTX2: {0} is not a KTX2 file", filename);
+            return false;
+        }
+        if (header.m_SupercompressionScheme != 0)
+        {
+            LOG_CORE_ERROR("CompressedImage::LoadKTX2: supercompression (Basis Universal, zstd) not supported, {0}",
+                           filename);
+            return false;
+        }
+        if ((header.m_PixelDepth > 1) || (header.m_LayerCount > 1) || (header.m_FaceCount != 1))
+        {
+            LOG_CORE_ERROR("CompressedImage::LoadKTX2: only 2D textures are supported, {0}", filename);
+            return false;
+        }
+
+        m_Format = FORMAT_UNDEFINED;
+        for (auto& mapping : VK_FORMAT_MAPPINGS)
+        {
+            if (mapping.m_VkFormat == header.m_VkFormat)
+            {
+                m_Format = mapping.m_Format;
+                m_sRGB = mapping.m_sRGB;
+                break;
+            }
+        }
+        if (m_Format == FORMAT_UNDEFINED)
+        {
+            LOG_CORE_ERROR("CompressedImage::LoadKTX2: unsupported vkFormat {0} in {1}", header.m_VkFormat, filename);
+            return false;
+        }
+
+        m_Width = header.m_PixelWidth;
+        m_Height = header.m_PixelHeight;
+        uint levelCount = std::max(1u, header.m_LevelCount);
+
+        // level data is stored smallest first, the level index is ordered base level first
+        m_Levels.resize(levelCount);
+        size_t totalSize = 0;
+        for (uint level = 0; level < levelCount; ++level)
+        {
+            KTX2LevelIndex levelIndex;
+            if (!Read(buffer, sizeof(KTX2Header) + level * sizeof(KTX2LevelIndex), levelIndex) ||
+                (levelIndex.m_ByteOffset + levelIndex.m_ByteLength > buffer.size()))
+            {
+                LOG_CORE_ERROR("CompressedImage::LoadKTX2: corrupt level index in {0}", filename);
+                m_Format = FORMAT_UNDEFINED;
+                return false;
+            }
+            Level& mip = m_Levels[level];
+            mip.m_Width = std::max(1u, m_Width >> level);
+            mip.m_Height = std::max(1u, m_Height >> level);
+            mip.m_Offset = static_cast<size_t>(levelIndex.m_ByteOffset);
+            mip.m_Size = static_cast<size_t>(levelIndex.m_ByteLength);
+            if (mip.m_Size != GetLevelSize(m_Format, mip.m_Width, mip.m_Height))
+            {
+                LOG_CORE_ERROR("CompressedImage::LoadKTX2: unexpected size of level {0} in {1}", level, filename);
+                m_Format = FORMAT_UNDEFINED;
+                return false;
+            }
+            totalSize += mip.m_Size;
+        }
+
+        // key/value data: only KTXswizzle is of interest
+        size_t kvdOffset = header.m_KvdByteOffset;
+        size_t kvdEnd = std::min(buffer.size(), kvdOffset + header.m_KvdByteLength);
+        while (kvdOffset + sizeof(uint32_t) <= kvdEnd)
+        {
+            uint32_t keyAndValueByteLength = 0;
+            Read(buffer, kvdOffset, keyAndValueByteLength);
+            size_t entry = kvdOffset + sizeof(uint32_t);
+            if (entry + keyAndValueByteLength > kvdEnd)
+            {
+                break;
+            }
+            std::string_view keyAndValue(reinterpret_cast<const char*>(buffer.data() + entry), keyAndValueByteLength);
+            constexpr std::string_view swizzleKey("KTXswizzle\0", 11);
+            if (keyAndValue.starts_with(swizzleKey) && (keyAndValue.size() >= swizzleKey.size() + 4))
+            {
+                for (uint component = 0; component < 4; ++component)
+                {
+                    m_Swizzle[component] = keyAndValue[swizzleKey.size() + component];
+                }
+            }
+            kvdOffset = AlignUp(entry + keyAndValueByteLength, 4);
+        }
+
+        // repack base level first
+        m_Data.resize(totalSize);
+        size_t offset = 0;
+        for (auto& mip : m_Levels)
+        {
+            memcpy(m_Data.data() + offset, buffer.data() + mip.m_Offset, mip.m_Size);
+            mip.m_Offset = offset;
+            offset += mip.m_Size;
+        }
+        return true;
+    }
+
+    bool CompressedImage::LoadDDS(std::string const& filename)
+    {
+        std::vector<uchar> buffer;
+        if (!ReadFile(filename, buffer))
+        {
+            LOG_CORE_ERROR("CompressedImage::LoadDDS: couldn't read {0}", filename);
+            return false;
+        }
+
+        uint32_t magic = 0;
+        DDSHeader header;
+        if (!Read(buffer, 0, magic) || (magic != MakeFourCC('D', 'D', 'S', ' ')) || !Read(buffer, sizeof(uint32_t), header))
+        {
+            LOG_CORE_ERROR("CompressedImage::LoadDDS: {0} is not a DDS file", filename);
+            return false;
+        }
+        if (header.m_Caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME))
+        {
+            LOG_CORE_ERROR("CompressedImage::LoadDDS: only 2D textures are supported, {0}", filename);
+            return false;
+        }
+
+        size_t dataOffset = sizeof(uint32_t) + sizeof(DDSHeader);
+        m_Format = FORMAT_UNDEFINED;
+        m_sRGB = false;
+        DDSPixelFormat const& pixelFormat = header.m_PixelFormat;
+        if (pixelFormat.m_Flags & DDPF_FOURCC)
+        {
+            switch (pixelFormat.m_FourCC)
+            {
+                case MakeFourCC('D', 'X', 'T', '1'):
+                    m_Format = FORMAT_BC1;
+                    break;
+                case MakeFourCC('D', 'X', 'T', '5'):
+                    m_Format = FORMAT_BC3;
+                    break;
+                case MakeFourCC('A', 'T', 'I', '1'):
+                case MakeFourCC('B', 'C', '4', 'U'):
+                    m_Format = FORMAT_BC4;
+                    break;
+                case MakeFourCC('A', 'T', 'I', '2'):
+                case MakeFourCC('B', 'C', '5', 'U'):
+                    m_Format = FORMAT_BC5;
+                    break;
+                case MakeFourCC('D', 'X', '1', '0'):
+                {
+                    DDSHeaderDX10 headerDX10;
+                    if (!Read(buffer, dataOffset, headerDX10) || (headerDX10.m_ArraySize > 1))
+                    {
+                        LOG_CORE_ERROR("CompressedImage::LoadDDS: unsupported DX10 header in {0}", filename);
+                        return false;
+                    }
+                    dataOffset += sizeof(DDSHeaderDX10);
+                    switch (headerDX10.m_DxgiFormat) // DXGI_FORMAT
+                    {
+                        case 28: // R8G8B8A8_UNORM
+                            m_Format = FORMAT_RGBA8;
+                            break;
+                        case 29: // R8G8B8A8_UNORM_SRGB
+                            m_Format = FORMAT_RGBA8;
+                            m_sRGB = true;
+                            break;
+                        case 71: // BC1_UNORM
+                            m_Format = FORMAT_BC1;
+                            break;
+                        case 72: // BC1_UNORM_SRGB
+                            m_Format = FORMAT_BC1;
+                            m_sRGB = true;
+                            break;
+                        case 77: // BC3_UNORM
+                            m_Format = FORMAT_BC3;
+                            break;
+                        case 78: // BC3_UNORM_SRGB
+                            m_Format = FORMAT_BC3;
+                            m_sRGB = true;
+                            break;
+                        case 80: // BC4_UNORM
+                            m_Format = FORMAT_BC4;
+                            break;
+                        case 83: // BC5_UNORM
+                            m_Format = FORMAT_BC5;
+                            break;
+                        case 98: // BC7_UNORM
+                            m_Format = FORMAT_BC7;
+                            break;
+                        case 99: // BC7_UNORM_SRGB
+                            m_Format = FORMAT_BC7;
+                            m_sRGB = true;
+                            break;
+                    }
+                    break;
+                }
+            }
+        }
+        else if ((pixelFormat.m_Flags & DDPF_RGB) && (pixelFormat.m_RGBBitCount == 32) &&
+                 (pixelFormat.m_RBitMask == 0x000000ff) && (pixelFormat.m_GBitMask == 0x0000ff00) &&
+                 (pixelFormat.m_BBitMask == 0x00ff0000))
+        {
+            m_Format = FORMAT_RGBA8;
+        }
+
+        if (m_Format == FORMAT_UNDEFINED)
+        {
+            LOG_CORE_ERROR("CompressedImage::LoadDDS: unsupported pixel format in {0}", filename);
+            return false;
+        }
+
+        m_Width = header.m_Width;
+        m_Height = header.m_Height;
+        uint levelCount = std::max(1u, header.m_MipMapCount);
+
+        // mip levels follow each other, base level first
+        m_Levels.resize(levelCount);
+        size_t offset = 0;
+        for (uint level = 0; level < levelCount; ++level)
+        {
+            Level& mip = m_Levels[level];
+            mip.m_Width = std::max(1u, m_Width >> level);
+            mip.m_Height = std::max(1u, m_Height >> level);
+            mip.m_Offset = offset;
+            mip.m_Size = GetLevelSize(m_Format, mip.m_Width, mip.m_Height);
+            offset += mip.m_Size;
+        }
+        if (dataOffset + offset > buffer.size())
+        {
+            LOG_CORE_ERROR("CompressedImage::LoadDDS: file {0} too short", filename);
+            m_Format = FORMAT_UNDEFINED;
+            return false;
+        }
+        m_Data.assign(buffer.begin() + dataOffset, buffer.begin() + dataOffset + offset);
+        return true;
+    }
+
+    bool CompressedImage::SaveKTX2(std::string const& filename) const
+    {
+        if (!IsValid())
+        {
+            return false;
+        }
+
+        uint32_t vkFormat = 0;
+        for (auto& mapping : VK_FORMAT_MAPPINGS)
+        {
+            // BC1 is written as BC1_RGBA
+            if ((mapping.m_Format == m_Format) && (mapping.m_sRGB == m_sRGB) && (mapping.m_VkFormat != 131) &&
+                (mapping.m_VkFormat != 132))
+            {
+                vkFormat = mapping.m_VkFormat;
+                break;
+            }
+        }
+        if (!vkFormat)
+        {
+            return false;
+        }
+
+        // data format descriptor: one basic block, one sample per 64-bit plane
+        uint32_t colorModel = KHR_DF_MODEL_RGBSDA;
+        std::vector<uint32_t> channels; // channel IDs of the samples
+        switch (m_Format)
+        {
+            case FORMAT_BC1:
+                colorModel = KHR_DF_MODEL_BC1A;
+                channels = {0};
+                break;
+            case FORMAT_BC3:
+                colorModel = KHR_DF_MODEL_BC3;
+                channels = {15 /*alpha*/, 0 /*color*/};
+                break;
+            case FORMAT_BC4:
+                colorModel = KHR_DF_MODEL_BC4;
+                channels = {0};
+                break;
+            case FORMAT_BC5:
+                colorModel = KHR_DF_MODEL_BC5;
+                channels = {0 /*red*/, 1 /*green*/};
+                break;
+            case FORMAT_BC7:
+                colorModel = KHR_DF_MODEL_BC7;
+                channels = {0};
+                break;
+            case FORMAT_ETC2_RGB8:
+                colorModel = KHR_DF_MODEL_ETC2;
+                channels = {2};
+                break;
+            case FORMAT_ETC2_RGBA8:
+                colorModel = KHR_DF_MODEL_ETC2;
+                channels = {15, 2};
+                break;
+            case FORMAT_ASTC_4x4:
+                colorModel = KHR_DF_MODEL_ASTC;
+                channels = {0};
+                break;
+            default:
+                channels = {0, 1, 2, 15};
+                break;
+        }
+        bool blockCompressed = IsBlockCompressed(m_Format);
+        uint32_t blockBytes = blockCompressed ? GetBlockSize(m_Format) : 4;
+        uint32_t sampleBits = blockCompressed ? (blockBytes * 8 / static_cast<uint32_t>(channels.size())) : 8;
+
+        std::vector<uint32_t> dfd;
+        uint32_t basicBlockSize = 24 + 16 * static_cast<uint32_t>(channels.size());
+        dfd.push_back(4 + basicBlockSize);         // dfdTotalSize
+        dfd.push_back(0);                          // vendorId, descriptorType
+        dfd.push_back(2 | (basicBlockSize << 16)); // versionNumber, descriptorBlockSize
+        dfd.push_back(colorModel | (KHR_DF_PRIMARIES_BT709 << 8) |
+                      ((m_sRGB ? KHR_DF_TRANSFER_SRGB : KHR_DF_TRANSFER_LINEAR) << 16));
+        dfd.push_back(blockCompressed ? (3 | (3 << 8)) : 0); // texelBlockDimension - 1
+        dfd.push_back(blockBytes);                           // bytesPlane0
+        dfd.push_back(0);                                    // bytesPlane4..7
+        for (uint32_t sample = 0; sample < channels.size(); ++sample)
+        {
+            uint32_t channelType = channels[sample];
+            if (m_sRGB && (channelType == 15))
+            {
+                channelType |= 0x40; // KHR_DF_SAMPLE_DATATYPE_LINEAR: alpha is not sRGB encoded
+            }
+            dfd.push_back((sample * sampleBits) | ((sampleBits - 1) << 16) | (channelType << 24));
+            dfd.push_back(0);                                   // samplePosition
+            dfd.push_back(0);                                   // sampleLower
+            dfd.push_back(blockCompressed ? 0xffffffff : 0xff); // sampleUpper
+        }
+
+        // key/value data
+        std::vector<uchar> kvd;
+        auto addKeyValue = [&kvd](std::string_view key, std::string_view value)
+        {
+            uint32_t length = static_cast<uint32_t>(key.size() + 1 + value.size() + 1);
+            size_t offset = kvd.size();
+            kvd.resize(AlignUp(offset + sizeof(uint32_t) + length, 4), 0);
+            Write(kvd, offset, length);
+            memcpy(kvd.data() + offset + sizeof(uint32_t), key.data(), key.size());
+            memcpy(kvd.data() + offset + sizeof(uint32_t) + key.size() + 1, value.data(), value.size());
+        };
+        std::string swizzle(m_Swizzle.begin(), m_Swizzle.end());
+        if (swizzle != "rgba")
+        {
+            addKeyValue("KTXswizzle", swizzle);
+        }
+        addKeyValue("KTXwriter", "gfxRenderEngine");
+
+        // layout: header, level index, dfd, kvd, level data (smallest level first)
+        uint32_t levelCount = static_cast<uint32_t>(m_Levels.size());
+        size_t levelIndexOffset = sizeof(KTX2Header);
+        size_t dfdOffset = levelIndexOffset + levelCount * sizeof(KTX2LevelIndex);
+        size_t kvdOffset = dfdOffset + dfd.size() * sizeof(uint32_t);
+        size_t dataOffset = kvdOffset + kvd.size();
+        size_t alignment = std::lcm(static_cast<size_t>(blockBytes), static_cast<size_t>(4));
+
+        std::vector<size_t> levelOffsets(levelCount);
+        for (int level = static_cast<int>(levelCount) - 1; level >= 0; --level)
+        {
+            dataOffset = AlignUp(dataOffset, alignment);
+            levelOffsets[level] = dataOffset;
+            dataOffset += m_Levels[level].m_Size;
+        }
+
+        std::vector<uchar> file(dataOffset, 0);
+        KTX2Header header{};
+        memcpy(header.m_Identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+        header.m_VkFormat = vkFormat;
+        header.m_TypeSize = 1;
+        header.m_PixelWidth = m_Width;
+        header.m_PixelHeight = m_Height;
+        header.m_PixelDepth = 0;
+        header.m_LayerCount = 0;
+        header.m_FaceCount = 1;
+        header.m_LevelCount = levelCount;
+        header.m_SupercompressionScheme = 0;
+        header.m_DfdByteOffset = static_cast<uint32_t>(dfdOffset);
+        header.m_DfdByteLength = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t));
+        header.m_KvdByteOffset = static_cast<uint32_t>(kvdOffset);
+        header.m_KvdByteLength = static_cast<uint32_t>(kvd.size());
+        Write(file, 0, header);
+
+        for (uint32_t level = 0; level < levelCount; ++level)
+        {
+            KTX2LevelIndex levelIndex{levelOffsets[level], m_Levels[level].m_Size, m_Levels[level].m_Size};
+            Write(file, levelIndexOffset + level * sizeof(KTX2LevelIndex), levelIndex);
+            memcpy(file.data() + levelOffsets[level], m_Data.data() + m_Levels[level].m_Offset, m_Levels[level].m_Size);
+        }
+        memcpy(file.data() + dfdOffset, dfd.data(), dfd.size() * sizeof(uint32_t));
+        memcpy(file.data() + kvdOffset, kvd.data(), kvd.size());
+
+        std::ofstream outputFile(filename, std::ios::binary | std::ios::trunc);
+        if (!outputFile.is_open())
+        {
+            LOG_CORE_ERROR("CompressedImage::SaveKTX2: couldn't open {0}", filename);
+            return false;
+        }
+        outputFile.write(reinterpret_cast<const char*>(file.data()), file.size());
+        return static_cast<bool>(outputFile);
+    }
+} // namespace GfxRenderEngine
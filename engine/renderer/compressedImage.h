@@ -0,0 +1,84 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "engine.h"
+
+namespace GfxRenderEngine
+{
+    // CPU-side texture with a complete or partial mip chain,
+    // either block-compressed or plain RGBA8.
+    // Loaded from KTX2 or DDS files, or produced by the TextureTranscoder.
+    class CompressedImage
+    {
+    public:
+        enum Format
+        {
+            FORMAT_UNDEFINED = 0,
+            FORMAT_RGBA8,
+            FORMAT_BC1,       // rgb + 1-bit alpha, 8 bytes per 4x4 block
+            FORMAT_BC3,       // rgba, 16 bytes per block
+            FORMAT_BC4,       // r, 8 bytes per block
+            FORMAT_BC5,       // rg, 16 bytes per block
+            FORMAT_BC7,       // rgba, 16 bytes per block
+            FORMAT_ETC2_RGB8, // 8 bytes per block
+            FORMAT_ETC2_RGBA8,
+            FORMAT_ASTC_4x4
+        };
+
+        struct Level
+        {
+            size_t m_Offset{0}; // into m_Data
+            size_t m_Size{0};
+            uint m_Width{0};
+            uint m_Height{0};
+        };
+
+    public:
+        // load by file extension (.ktx2 or .dds)
+        bool Load(std::string const& filename);
+        bool LoadKTX2(std::string const& filename);
+        bool LoadDDS(std::string const& filename);
+        bool SaveKTX2(std::string const& filename) const;
+
+        bool IsValid() const { return (m_Format != FORMAT_UNDEFINED) && !m_Levels.empty(); }
+        static bool IsCompressedFile(std::string const& filename);
+        static bool IsBlockCompressed(Format format) { return format > FORMAT_RGBA8; }
+        static uint GetBlockSize(Format format); // bytes per 4x4 block, or per pixel for RGBA8
+        static size_t GetLevelSize(Format format, uint width, uint height);
+
+    public:
+        Format m_Format{FORMAT_UNDEFINED};
+        bool m_sRGB{false}; // as stored in the file, the caller decides how to interpret the data
+        uint m_Width{0};
+        uint m_Height{0};
+        std::vector<Level> m_Levels; // level 0: full resolution
+        std::vector<uchar> m_Data;
+        // component mapping r, g, b, a: one of 'r', 'g', 'b', 'a', '0', '1' (KTXswizzle)
+        std::array<char, 4> m_Swizzle{'r', 'g', 'b', 'a'};
+    };
+} // namespace GfxRenderEngine
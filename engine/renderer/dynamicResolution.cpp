@@ -0,0 +1,84 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "coreSettings.h"
+#include "renderer/dynamicResolution.h"
+
+namespace GfxRenderEngine
+{
+    DynamicResolution::DynamicResolution(uint latency) : m_Latency{latency} {}
+
+    float DynamicResolution::Update(RenderStatistics const& statistics)
+    {
+        if (!CoreSettings::m_DynamicResolution)
+        {
+            m_Scale = 1.0f;
+            m_FrameTimeMs = 0.0f;
+            m_FramesToSettle = 0;
+            return m_Scale;
+        }
+        if (!statistics.m_GpuTimingsValid)
+        {
+            return m_Scale;
+        }
+
+        // frames recorded before the last change still report the old scale
+        if (m_FramesToSettle > 0)
+        {
+            --m_FramesToSettle;
+            return m_Scale;
+        }
+
+        float frameTimeMs = std::accumulate(statistics.m_GpuTimeMs.begin(), statistics.m_GpuTimeMs.end(), 0.0f);
+        m_FrameTimeMs = (m_FrameTimeMs == 0.0f) ? frameTimeMs : m_FrameTimeMs + (frameTimeMs - m_FrameTimeMs) * SMOOTHING;
+        if (m_FrameTimeMs <= 0.0f)
+        {
+            return m_Scale;
+        }
+
+        float targetMs = static_cast<float>(std::max(CoreSettings::m_TargetFrameTimeMs, 1));
+        bool tooSlow = m_FrameTimeMs > targetMs;
+        bool headroom = m_FrameTimeMs < targetMs * RAISE_THRESHOLD;
+        if (!tooSlow && !headroom)
+        {
+            return m_Scale;
+        }
+
+        // the cost of the scaled passes grows with the number of pixels, the square of the scale;
+        // the passes at output resolution (shadows, gui) make this estimate err on the safe side
+        float scale = m_Scale * std::sqrt(targetMs * (tooSlow ? 1.0f : RAISE_THRESHOLD) / m_FrameTimeMs);
+        float minScale = std::clamp(CoreSettings::m_MinRenderScale, 10, 100) / 100.0f;
+        scale = std::clamp(scale, m_Scale - MAX_STEP_DOWN, m_Scale + MAX_STEP_UP);
+        scale = std::clamp(std::round(scale / SCALE_QUANTUM) * SCALE_QUANTUM, minScale, 1.0f);
+        if (scale != m_Scale)
+        {
+            m_Scale = scale;
+            m_FramesToSettle = m_Latency;
+            m_FrameTimeMs = 0.0f; // restart the average at the new scale
+        }
+        return m_Scale;
+    }
+} // namespace GfxRenderEngine
@@ -0,0 +1,58 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include "engine.h"
+#include "renderer/renderStatistics.h"
+
+namespace GfxRenderEngine
+{
+    // chooses the fraction of the output resolution the 3D pass renders at,
+    // from the GPU frame time of the timestamp queries against CoreSettings::m_TargetFrameTimeMs;
+    // the timings lag a few frames behind, a new scale is held until it shows up in them
+    class DynamicResolution
+    {
+
+    public:
+        DynamicResolution(uint latency); // frames from recording a frame to reading its GPU timings
+
+        // call once per frame after the GPU timings were copied into the statistics
+        float Update(RenderStatistics const& statistics);
+
+        float GetScale() const { return m_Scale; }
+        float GetFrameTimeMs() const { return m_FrameTimeMs; } // smoothed
+
+    private:
+        static constexpr float SMOOTHING = 0.2f;         // weight of a new frame in the average
+        static constexpr float RAISE_THRESHOLD = 0.85f;  // the scale grows when below this fraction of the target
+        static constexpr float MAX_STEP_UP = 0.05f;      // per change, the recovery from a spike is slow
+        static constexpr float MAX_STEP_DOWN = 0.2f;     // per change, a spike is answered quickly
+        static constexpr float SCALE_QUANTUM = 0.025f;   // smaller changes are ignored
+
+    private:
+        uint m_Latency;
+        uint m_FramesToSettle{0};
+        float m_Scale{1.0f};
+        float m_FrameTimeMs{0.0f};
+    };
+} // namespace GfxRenderEngine
@@ -36,9 +36,8 @@ namespace GfxRenderEngine
     public:
         virtual ~InstanceBuffer() = default;
 
-        virtual void SetInstanceData(uint index, glm::mat4 const& mat4Global, glm::mat4 const& normalMatrix) = 0;
+        virtual void SetInstanceData(uint index, glm::mat4 const& mat4Global) = 0;
         virtual const glm::mat4& GetModelMatrix(uint index) = 0;
-        virtual const glm::mat4& GetNormalMatrix(uint index) = 0;
         virtual std::shared_ptr<Buffer> GetBuffer() = 0;
 
         static std::shared_ptr<InstanceBuffer> Create(uint numInstances);
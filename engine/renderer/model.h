@@ -35,6 +35,7 @@
 #define GL_DOUBLE 0x140A         // 5130
 
 #include <memory>
+#include <unordered_set>
 
 #include "tinygltf/tiny_gltf.h"
 
@@ -48,6 +49,7 @@
 #include "renderer/materialDescriptor.h"
 #include "renderer/resourceDescriptor.h"
 #include "renderer/texture.h"
+#include "renderer/builder/lodGenerator.h"
 #include "renderer/cubemap.h"
 #include "sprite/sprite.h"
 #include "entt.hpp"
@@ -60,7 +62,7 @@ namespace GfxRenderEngine
         glm::vec4 m_Color;     // layout(location = 1)
         glm::vec3 m_Normal;    // layout(location = 2)
         glm::vec2 m_UV;        // layout(location = 3)
-        glm::vec3 m_Tangent;   // layout(location = 4)
+        glm::vec4 m_Tangent;   // layout(location = 4), w is the handedness of the bitangent
         glm::ivec4 m_JointIds; // layout(location = 5)
         glm::vec4 m_Weights;   // layout(location = 6)
     };
@@ -74,6 +76,17 @@ namespace GfxRenderEngine
         uint m_InstanceCount;
         Material m_Material;
         Resources m_Resources;
+        std::vector<SubmeshLod> m_Lods; // level 1 and coarser, level 0 is the submesh itself
+
+        // index range of a level, levels beyond the coarsest one use the coarsest one
+        SubmeshLod GetLod(uint lod) const
+        {
+            if (!lod || m_Lods.empty())
+            {
+                return {m_FirstIndex, m_FirstVertex, m_IndexCount, 0.0f};
+            }
+            return m_Lods[std::min(static_cast<size_t>(lod), m_Lods.size()) - 1];
+        }
     };
 
     class Model
@@ -89,6 +102,10 @@ namespace GfxRenderEngine
         virtual void CreateVertexBuffer(const std::vector<Vertex>& vertices) = 0;
         virtual void CreateIndexBuffer(const std::vector<uint>& indices) = 0;
 
+        // device memory of the buffers and textures of this model in bytes,
+        // resources already in 'counted' are skipped so that shared resources are counted once
+        virtual size_t GetMemorySize(std::unordered_set<void const*>& counted) const = 0;
+
         SkeletalAnimations& GetAnimations();
 
         static float m_NormalMapIntensity;
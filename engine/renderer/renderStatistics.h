@@ -0,0 +1,132 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+
+#include "engine.h"
+
+namespace GfxRenderEngine
+{
+    // per-frame counters of the renderer
+    // they are reset in BeginFrame() and remain valid until the next frame begins
+    // GPU times come from timestamp queries and lag a few frames behind
+    struct RenderStatistics
+    {
+        enum Pass
+        {
+            PASS_ANIMATION = 0,
+            PASS_SHADOW,
+            PASS_OCCLUSION,
+            PASS_GEOMETRY,
+            PASS_LIGHTING,
+            PASS_TRANSPARENCY,
+            PASS_BLOOM,
+            PASS_POST_PROCESSING,
+            PASS_GUI,
+            NUMBER_OF_PASSES
+        };
+
+        static constexpr const char* PASS_NAMES[NUMBER_OF_PASSES] = {
+            "animation", "shadow", "occlusion", "geometry", "lighting", "transparency", "bloom", "postprocessing", "gui"};
+
+        // measures the CPU time spent recording a pass
+        class CpuTimer
+        {
+        public:
+            CpuTimer(RenderStatistics& statistics, Pass pass)
+                : m_Statistics{statistics}, m_Pass{pass}, m_Start{std::chrono::high_resolution_clock::now()}
+            {
+            }
+            ~CpuTimer()
+            {
+                std::chrono::duration<float, std::milli> duration = std::chrono::high_resolution_clock::now() - m_Start;
+                m_Statistics.m_CpuTimeMs[m_Pass] += duration.count();
+            }
+
+        private:
+            RenderStatistics& m_Statistics;
+            Pass m_Pass;
+            std::chrono::time_point<std::chrono::high_resolution_clock> m_Start;
+        };
+
+        void Reset()
+        {
+            m_DrawCalls = 0;
+            m_Instances = 0;
+            m_Triangles = 0;
+            m_BindsSaved = 0;
+            m_MergedDraws = 0;
+            m_ImpostorInstances = 0;
+            m_SkinnedModels = 0;
+            m_SkinnedVertices = 0;
+            m_SkinningSkipped = 0;
+            m_CpuTimeMs.fill(0.0f);
+        }
+
+        void Draw(uint vertexOrIndexCount, uint instanceCount)
+        {
+            ++m_DrawCalls;
+            m_Instances += instanceCount;
+            m_Triangles += static_cast<uint64>(vertexOrIndexCount / 3) * instanceCount;
+        }
+
+        // indirect draws of the occlusion culling count their instances before culling
+        uint m_DrawCalls{0};
+        uint m_Instances{0};
+        uint64 m_Triangles{0};
+        uint m_BindsSaved{0};  // binds the render queue skipped because the state was already bound
+        uint m_MergedDraws{0}; // draws the render queue merged into the instanced draw before them
+        std::array<float, NUMBER_OF_PASSES> m_CpuTimeMs{};
+        std::array<float, NUMBER_OF_PASSES> m_GpuTimeMs{};
+        std::array<float, NUMBER_OF_PASSES> m_GpuTimeAverageMs{};
+        bool m_GpuTimingsValid{false};
+
+        // texture streaming, updated at the beginning of a frame
+        uint m_StreamedTextures{0};
+        uint m_StreamingJobs{0};
+        uint64 m_StreamingResidentBytes{0};
+        uint64 m_StreamingBudgetBytes{0};
+        uint64 m_StreamingUploadBytes{0};
+
+        // occlusion culling, read back when the frame slot comes around again
+        uint m_CullingObjects{0};   // bounding spheres tested, one per instance or grass chunk
+        uint m_FrustumCulled{0};
+        uint m_OcclusionCulled{0};  // hidden in both phases
+        uint m_OcclusionRescued{0}; // hidden in the previous frame's depth, drawn in the second phase
+
+        // impostors
+        uint m_ImpostorInstances{0}; // beyond the crossfade, drawn only as an impostor
+        uint m_ImpostorModels{0};    // baked so far, not reset per frame
+
+        // compute skinning, once per animated model before the shadow passes
+        uint m_SkinnedModels{0};
+        uint m_SkinnedVertices{0};
+        uint m_SkinningSkipped{0}; // animated models whose pose did not change
+
+        // dynamic resolution, not reset per frame
+        float m_RenderScale{1.0f};      // fraction of the output resolution the 3D pass renders at
+        float m_GpuFrameTimeMs{0.0f};   // smoothed, what the scale was chosen for
+    };
+} // namespace GfxRenderEngine
@@ -29,6 +29,7 @@
 #include "scene/sceneGraph.h"
 #include "scene/particleSystem.h"
 #include "renderer/camera.h"
+#include "renderer/renderStatistics.h"
 
 namespace GfxRenderEngine
 {
@@ -66,5 +67,6 @@ namespace GfxRenderEngine
         virtual void ShowDebugShadowMap(bool showDebugShadowMap) = 0;
         virtual void UpdateAnimations(Registry& registry, const Timestep& timestep) = 0;
         virtual std::shared_ptr<Texture> GetTextureAtlas() = 0;
+        virtual const RenderStatistics& GetRenderStatistics() const = 0;
     };
 } // namespace GfxRenderEngine
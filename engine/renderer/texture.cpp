@@ -45,4 +45,15 @@ namespace GfxRenderEngine
 
         return texture;
     }
+
+    bool Texture::IsFormatSupported(CompressedImage::Format format)
+    {
+        switch (RendererAPI::GetAPI())
+        {
+            case RendererAPI::VULKAN:
+                return VK_Texture::IsFormatSupported(format);
+            default:
+                return false;
+        }
+    }
 } // namespace GfxRenderEngine
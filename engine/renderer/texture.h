@@ -25,6 +25,7 @@
 #include <memory>
 
 #include "engine.h"
+#include "renderer/compressedImage.h"
 
 namespace GfxRenderEngine
 {
@@ -36,6 +37,15 @@ namespace GfxRenderEngine
         static constexpr bool USE_SRGB = true;
         static constexpr bool USE_UNORM = false;
 
+        // what a texture is sampled for, selects the block compression format when transcoding
+        enum Usage
+        {
+            USAGE_COLOR = 0,
+            USAGE_NORMAL_MAP,
+            USAGE_ROUGHNESS_METALLIC_MAP, // glTF layout: roughness in g, metallic in b
+            USAGE_GRAYSCALE_MAP           // e.g. separate roughness or metallic maps
+        };
+
     public:
         virtual ~Texture() = default;
 
@@ -43,13 +53,20 @@ namespace GfxRenderEngine
                           int magFilter) = 0;
         virtual bool Init(const std::string& fileName, bool sRGB, bool flip = true) = 0;
         virtual bool Init(const unsigned char* data, int length, bool sRGB) = 0;
+        // uploads all mip levels of the image as stored, no runtime mip generation
+        virtual bool Init(const CompressedImage& image, bool sRGB, int minFilter, int magFilter) = 0;
+        // uploads only the mip tail of the image, larger levels are streamed in from streamSource on demand
+        virtual bool InitStreamed(const CompressedImage& image, const std::string& streamSource, bool sRGB, int minFilter,
+                                  int magFilter) = 0;
         virtual int GetWidth() const = 0;
         virtual int GetHeight() const = 0;
         virtual void Resize(uint width, uint height) = 0;
         virtual void Blit(uint x, uint y, uint width, uint height, uint bpp, const void* data) = 0;
         virtual void Blit(uint x, uint y, uint width, uint height, int dataFormat, int type, const void* data) = 0;
         virtual void SetFilename(const std::string& filename) = 0;
+        virtual size_t GetMemorySize() const = 0; // device memory in bytes
 
         static std::shared_ptr<Texture> Create();
+        static bool IsFormatSupported(CompressedImage::Format format);
     };
 } // namespace GfxRenderEngine
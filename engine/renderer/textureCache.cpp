@@ -0,0 +1,192 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <filesystem>
+#include <string_view>
+
+#include "renderer/textureCache.h"
+#include "renderer/textureTranscoder.h"
+
+namespace GfxRenderEngine
+{
+    size_t TextureCache::KeyHash::operator()(Key const& key) const
+    {
+        uint64 hash = key.m_Hash;
+        hash ^= (static_cast<uint64>(key.m_sRGB) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2));
+        hash ^= (static_cast<uint64>(key.m_MinFilter + 1) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2));
+        hash ^= (static_cast<uint64>(key.m_MagFilter + 1) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2));
+        return static_cast<size_t>(hash);
+    }
+
+    TextureCache::Key TextureCache::MakeFileKey(std::string const& filename, bool sRGB, bool flip, Texture::Usage usage)
+    {
+        // the same file reached via different relative paths maps to one key
+        std::error_code errorCode;
+        std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(filename, errorCode);
+        std::string path = errorCode ? filename : canonicalPath.generic_string();
+
+        Key key;
+        key.m_Hash = std::hash<std::string_view>{}(path);
+        if (!flip)
+        {
+            key.m_Hash = ~key.m_Hash;
+        }
+        // the usage selects the compression format when transcoding
+        key.m_Hash += static_cast<uint64>(usage) * 0x9e3779b97f4a7c15ull;
+        key.m_sRGB = sRGB;
+        return key;
+    }
+
+    TextureCache::Key TextureCache::MakeContentKey(const void* data, size_t size, bool sRGB, int minFilter,
+                                                   int magFilter)
+    {
+        Key key;
+        key.m_Hash = std::hash<std::string_view>{}(std::string_view(static_cast<const char*>(data), size));
+        key.m_sRGB = sRGB;
+        key.m_MinFilter = minFilter;
+        key.m_MagFilter = magFilter;
+        return key;
+    }
+
+    std::shared_ptr<Texture> TextureCache::Get(Key const& key, Loader const& loader)
+    {
+        std::promise<std::shared_ptr<Texture>> promise;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            auto iterator = m_Entries.find(key);
+            if (iterator != m_Entries.end())
+            {
+                ++m_Statistics.m_Hits;
+                Entry& entry = iterator->second;
+                if (entry.m_Texture)
+                {
+                    m_LRU.splice(m_LRU.begin(), m_LRU, entry.m_LRUPosition);
+                    return entry.m_Texture;
+                }
+                // another thread is loading this texture, wait for it outside the lock
+                std::shared_future<std::shared_ptr<Texture>> future = entry.m_Future;
+                lock.unlock();
+                return future.get();
+            }
+            ++m_Statistics.m_Misses;
+            Entry entry;
+            entry.m_Future = promise.get_future().share();
+            m_Entries.emplace(key, std::move(entry));
+        }
+
+        std::shared_ptr<Texture> texture = loader();
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            auto iterator = m_Entries.find(key);
+            if (iterator != m_Entries.end()) // Clear() might have dropped the entry meanwhile
+            {
+                if (texture)
+                {
+                    Entry& entry = iterator->second;
+                    entry.m_Texture = texture;
+                    entry.m_Future = {}; // the shared state holds a reference, too
+                    entry.m_MemorySize = texture->GetMemorySize();
+                    m_LRU.push_front(key);
+                    entry.m_LRUPosition = m_LRU.begin();
+                    m_Statistics.m_MemoryBytes += entry.m_MemorySize;
+                    Evict();
+                }
+                else
+                {
+                    // failed loads are not cached, the next request tries again
+                    m_Entries.erase(iterator);
+                }
+            }
+        }
+        promise.set_value(texture);
+        return texture;
+    }
+
+    std::shared_ptr<Texture> TextureCache::LoadFile(std::string const& filename, bool sRGB, bool flip,
+                                                    Texture::Usage usage)
+    {
+        auto loader = [&]() -> std::shared_ptr<Texture>
+        {
+            auto compressed = TextureTranscoder::LoadCompressed(filename, usage, sRGB, flip, DEFAULT_FILTER, DEFAULT_FILTER);
+            if (compressed)
+            {
+                return compressed;
+            }
+            auto texture = Texture::Create();
+            if (!texture->Init(filename, sRGB, flip))
+            {
+                return nullptr;
+            }
+            return texture;
+        };
+        return Get(MakeFileKey(filename, sRGB, flip, usage), loader);
+    }
+
+    void TextureCache::Evict()
+    {
+        if (m_Statistics.m_BudgetBytes == UNLIMITED_BUDGET)
+        {
+            return;
+        }
+
+        // walk from the least recently used end, textures still referenced by a model stay resident
+        auto iterator = m_LRU.end();
+        while ((m_Statistics.m_MemoryBytes > m_Statistics.m_BudgetBytes) && (iterator != m_LRU.begin()))
+        {
+            --iterator;
+            auto entryIterator = m_Entries.find(*iterator);
+            CORE_ASSERT(entryIterator != m_Entries.end(), "TextureCache::Evict: LRU list out of sync");
+            Entry& entry = entryIterator->second;
+            if (entry.m_Texture.use_count() == 1)
+            {
+                m_Statistics.m_MemoryBytes -= entry.m_MemorySize;
+                ++m_Statistics.m_Evictions;
+                m_Entries.erase(entryIterator);
+                iterator = m_LRU.erase(iterator);
+            }
+        }
+    }
+
+    void TextureCache::SetBudget(size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Statistics.m_BudgetBytes = bytes;
+        Evict();
+    }
+
+    TextureCache::Statistics TextureCache::GetStatistics() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Statistics statistics = m_Statistics;
+        statistics.m_Entries = m_Entries.size();
+        return statistics;
+    }
+
+    void TextureCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Entries.clear();
+        m_LRU.clear();
+        m_Statistics.m_MemoryBytes = 0;
+    }
+} // namespace GfxRenderEngine
@@ -0,0 +1,117 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "engine.h"
+#include "renderer/texture.h"
+
+namespace GfxRenderEngine
+{
+    // Process-wide cache for textures shared by all model builders.
+    // Textures are keyed by canonical file path or by content hash, plus
+    // the color space and sampler settings they were created with.
+    // Concurrent requests for the same key wait for a single load.
+    // Textures no longer referenced outside the cache are evicted
+    // least-recently-used first once the memory budget is exceeded.
+    class TextureCache
+    {
+    public:
+        static constexpr int DEFAULT_FILTER = -1;
+        static constexpr size_t UNLIMITED_BUDGET = 0;
+
+        struct Key
+        {
+            uint64 m_Hash{0};
+            bool m_sRGB{false};
+            int m_MinFilter{DEFAULT_FILTER};
+            int m_MagFilter{DEFAULT_FILTER};
+
+            bool operator==(Key const& other) const = default;
+        };
+
+        struct Statistics
+        {
+            uint64 m_Hits{0};
+            uint64 m_Misses{0};
+            uint64 m_Evictions{0};
+            size_t m_Entries{0};
+            size_t m_MemoryBytes{0};
+            size_t m_BudgetBytes{UNLIMITED_BUDGET};
+        };
+
+        using Loader = std::function<std::shared_ptr<Texture>()>;
+
+    public:
+        TextureCache() = default;
+        ~TextureCache() = default;
+
+        TextureCache(TextureCache const&) = delete;
+        TextureCache& operator=(TextureCache const&) = delete;
+
+        static Key MakeFileKey(std::string const& filename, bool sRGB, bool flip = true,
+                               Texture::Usage usage = Texture::USAGE_COLOR);
+        static Key MakeContentKey(const void* data, size_t size, bool sRGB, int minFilter = DEFAULT_FILTER,
+                                  int magFilter = DEFAULT_FILTER);
+
+        // returns the cached texture or runs the loader; returns nullptr if the loader fails
+        std::shared_ptr<Texture> Get(Key const& key, Loader const& loader);
+        // loads a texture file through the cache; returns nullptr if the file cannot be loaded
+        // KTX2/DDS files and transcoded images are uploaded block-compressed (see TextureTranscoder)
+        std::shared_ptr<Texture> LoadFile(std::string const& filename, bool sRGB, bool flip = true,
+                                          Texture::Usage usage = Texture::USAGE_COLOR);
+
+        void SetBudget(size_t bytes);
+        Statistics GetStatistics() const;
+        void Clear();
+
+    private:
+        struct KeyHash
+        {
+            size_t operator()(Key const& key) const;
+        };
+
+        struct Entry
+        {
+            std::shared_future<std::shared_ptr<Texture>> m_Future;
+            std::shared_ptr<Texture> m_Texture; // nullptr while loading
+            size_t m_MemorySize{0};
+            std::list<Key>::iterator m_LRUPosition;
+        };
+
+        void Evict(); // caller holds m_Mutex
+
+    private:
+        mutable std::mutex m_Mutex;
+        std::unordered_map<Key, Entry, KeyHash> m_Entries;
+        std::list<Key> m_LRU; // front: most recently used
+        Statistics m_Statistics;
+    };
+} // namespace GfxRenderEngine
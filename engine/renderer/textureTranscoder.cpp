@@ -0,0 +1,582 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+
+#include "stb_image.h"
+
+#include "core.h"
+#include "auxiliary/file.h"
+#include "auxiliary/nameTable.h"
+#include "renderer/textureTranscoder.h"
+
+namespace GfxRenderEngine
+{
+    namespace
+    {
+        // bump when the encoder output changes to invalidate cached files
+        constexpr uint64 ENCODER_VERSION = 1;
+
+        struct SRGBTable
+        {
+            SRGBTable()
+            {
+                for (uint index = 0; index < 256; ++index)
+                {
+                    float value = static_cast<float>(index) / 255.0f;
+                    m_ToLinear[index] =
+                        (value <= 0.04045f) ? (value / 12.92f) : std::pow((value + 0.055f) / 1.055f, 2.4f);
+                }
+            }
+            std::array<float, 256> m_ToLinear;
+        };
+
+        float SRGBToLinear(uchar value)
+        {
+            static const SRGBTable table;
+            return table.m_ToLinear[value];
+        }
+
+        uchar LinearToSRGB(float value)
+        {
+            value = std::clamp(value, 0.0f, 1.0f);
+            float sRGB = (value <= 0.0031308f) ? (value * 12.92f) : (1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f);
+            return static_cast<uchar>(sRGB * 255.0f + 0.5f);
+        }
+
+        uchar ToByte(float value) { return static_cast<uchar>(std::clamp(value, 0.0f, 255.0f) + 0.5f); }
+
+        // 2x2 box filter, edge texels are repeated for odd sizes
+        void Downsample(const uchar* source, uint width, uint height, uchar* destination, uint destinationWidth,
+                        uint destinationHeight, Texture::Usage usage, bool sRGB)
+        {
+            for (uint y = 0; y < destinationHeight; ++y)
+            {
+                uint y0 = std::min(2 * y, height - 1);
+                uint y1 = std::min(2 * y + 1, height - 1);
+                for (uint x = 0; x < destinationWidth; ++x)
+                {
+                    uint x0 = std::min(2 * x, width - 1);
+                    uint x1 = std::min(2 * x + 1, width - 1);
+                    const uchar* texels[4] = {source + (y0 * width + x0) * 4, source + (y0 * width + x1) * 4,
+                                              source + (y1 * width + x0) * 4, source + (y1 * width + x1) * 4};
+                    uchar* output = destination + (y * destinationWidth + x) * 4;
+
+                    if (usage == Texture::USAGE_NORMAL_MAP)
+                    {
+                        // average the vectors and renormalize
+                        float normal[3] = {0.0f, 0.0f, 0.0f};
+                        for (auto texel : texels)
+                        {
+                            for (uint component = 0; component < 3; ++component)
+                            {
+                                normal[component] += static_cast<float>(texel[component]) / 127.5f - 1.0f;
+                            }
+                        }
+                        float length =
+                            std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+                        length = (length > 0.0f) ? length : 1.0f;
+                        for (uint component = 0; component < 3; ++component)
+                        {
+                            output[component] = ToByte((normal[component] / length + 1.0f) * 127.5f);
+                        }
+                        output[3] = 255;
+                    }
+                    else if (sRGB)
+                    {
+                        // filter color in linear space
+                        for (uint component = 0; component < 3; ++component)
+                        {
+                            float sum = 0.0f;
+                            for (auto texel : texels)
+                            {
+                                sum += SRGBToLinear(texel[component]);
+                            }
+                            output[component] = LinearToSRGB(sum * 0.25f);
+                        }
+                        output[3] = ToByte((texels[0][3] + texels[1][3] + texels[2][3] + texels[3][3]) * 0.25f);
+                    }
+                    else
+                    {
+                        for (uint component = 0; component < 4; ++component)
+                        {
+                            output[component] = ToByte((texels[0][component] + texels[1][component] +
+                                                        texels[2][component] + texels[3][component]) *
+                                                       0.25f);
+                        }
+                    }
+                }
+            }
+        }
+
+        // 4x4 texels, edge texels are repeated for partial blocks
+        void FetchBlock(const uchar* rgba, uint width, uint height, uint blockX, uint blockY, uchar block[64])
+        {
+            for (uint y = 0; y < 4; ++y)
+            {
+                uint sourceY = std::min(blockY * 4 + y, height - 1);
+                for (uint x = 0; x < 4; ++x)
+                {
+                    uint sourceX = std::min(blockX * 4 + x, width - 1);
+                    memcpy(block + (y * 4 + x) * 4, rgba + (sourceY * width + sourceX) * 4, 4);
+                }
+            }
+        }
+
+        // single channel: endpoints at min/max, 8-value mode
+        void EncodeBC4(const uchar values[16], uchar* output)
+        {
+            uchar minimum = 255;
+            uchar maximum = 0;
+            for (uint texel = 0; texel < 16; ++texel)
+            {
+                minimum = std::min(minimum, values[texel]);
+                maximum = std::max(maximum, values[texel]);
+            }
+            output[0] = maximum;
+            output[1] = minimum;
+
+            uint64 indices = 0;
+            if (maximum > minimum)
+            {
+                // palette index order: 0 = max, 1 = min, 2..7 = interpolated from max to min
+                static constexpr uint64 PALETTE_INDEX[8] = {1, 7, 6, 5, 4, 3, 2, 0};
+                float range = static_cast<float>(maximum - minimum);
+                for (uint texel = 0; texel < 16; ++texel)
+                {
+                    float position = static_cast<float>(values[texel] - minimum) / range; // 0 .. 1
+                    uint step = static_cast<uint>(position * 7.0f + 0.5f);                 // 0 = min, 7 = max
+                    indices |= PALETTE_INDEX[step] << (3 * texel);
+                }
+            }
+            for (uint byte = 0; byte < 6; ++byte)
+            {
+                output[2 + byte] = static_cast<uchar>(indices >> (8 * byte));
+            }
+        }
+
+        uint16_t PackRGB565(const float color[3])
+        {
+            uint red = static_cast<uint>(std::clamp(color[0], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+            uint green = static_cast<uint>(std::clamp(color[1], 0.0f, 255.0f) * 63.0f / 255.0f + 0.5f);
+            uint blue = static_cast<uint>(std::clamp(color[2], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+            return static_cast<uint16_t>((red << 11) | (green << 5) | blue);
+        }
+
+        void UnpackRGB565(uint16_t packed, int color[3])
+        {
+            int red = (packed >> 11) & 31;
+            int green = (packed >> 5) & 63;
+            int blue = packed & 31;
+            color[0] = (red << 3) | (red >> 2);
+            color[1] = (green << 2) | (green >> 4);
+            color[2] = (blue << 3) | (blue >> 2);
+        }
+
+        // rgb: endpoints along the principal axis of the block colors, 4-color mode
+        void EncodeBC1(const uchar block[64], uchar* output)
+        {
+            float mean[3] = {0.0f, 0.0f, 0.0f};
+            for (uint texel = 0; texel < 16; ++texel)
+            {
+                for (uint component = 0; component < 3; ++component)
+                {
+                    mean[component] += block[texel * 4 + component];
+                }
+            }
+            for (auto& value : mean)
+            {
+                value /= 16.0f;
+            }
+
+            float covariance[6] = {}; // rr, rg, rb, gg, gb, bb
+            for (uint texel = 0; texel < 16; ++texel)
+            {
+                float red = block[texel * 4 + 0] - mean[0];
+                float green = block[texel * 4 + 1] - mean[1];
+                float blue = block[texel * 4 + 2] - mean[2];
+                covariance[0] += red * red;
+                covariance[1] += red * green;
+                covariance[2] += red * blue;
+                covariance[3] += green * green;
+                covariance[4] += green * blue;
+                covariance[5] += blue * blue;
+            }
+
+            // power iteration
+            float axis[3] = {1.0f, 1.0f, 1.0f};
+            for (uint iteration = 0; iteration < 8; ++iteration)
+            {
+                float next[3] = {covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+                                 covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+                                 covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2]};
+                float length = std::max({std::abs(next[0]), std::abs(next[1]), std::abs(next[2])});
+                if (length < 1e-6f)
+                {
+                    break;
+                }
+                for (uint component = 0; component < 3; ++component)
+                {
+                    axis[component] = next[component] / length;
+                }
+            }
+
+            float minimumProjection = FLT_MAX;
+            float maximumProjection = -FLT_MAX;
+            for (uint texel = 0; texel < 16; ++texel)
+            {
+                float projection = 0.0f;
+                for (uint component = 0; component < 3; ++component)
+                {
+                    projection += (block[texel * 4 + component] - mean[component]) * axis[component];
+                }
+                minimumProjection = std::min(minimumProjection, projection);
+                maximumProjection = std::max(maximumProjection, projection);
+            }
+
+            // inset the endpoints slightly, the extremes are reached by the interpolated colors
+            float axisLengthSquared = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+            axisLengthSquared = (axisLengthSquared > 0.0f) ? axisLengthSquared : 1.0f;
+            float inset = (maximumProjection - minimumProjection) / 16.0f;
+            float endpoint0[3];
+            float endpoint1[3];
+            for (uint component = 0; component < 3; ++component)
+            {
+                endpoint0[component] =
+                    mean[component] + axis[component] * (maximumProjection - inset) / axisLengthSquared;
+                endpoint1[component] =
+                    mean[component] + axis[component] * (minimumProjection + inset) / axisLengthSquared;
+            }
+
+            uint16_t color0 = PackRGB565(endpoint0);
+            uint16_t color1 = PackRGB565(endpoint1);
+            if (color0 < color1)
+            {
+                std::swap(color0, color1);
+            }
+
+            uint32_t indices = 0;
+            if (color0 != color1)
+            {
+                int palette[4][3];
+                UnpackRGB565(color0, palette[0]);
+                UnpackRGB565(color1, palette[1]);
+                for (uint component = 0; component < 3; ++component)
+                {
+                    palette[2][component] = (2 * palette[0][component] + palette[1][component]) / 3;
+                    palette[3][component] = (palette[0][component] + 2 * palette[1][component]) / 3;
+                }
+                for (uint texel = 0; texel < 16; ++texel)
+                {
+                    uint bestIndex = 0;
+                    int bestDistance = INT_MAX;
+                    for (uint index = 0; index < 4; ++index)
+                    {
+                        int distance = 0;
+                        for (uint component = 0; component < 3; ++component)
+                        {
+                            int delta = block[texel * 4 + component] - palette[index][component];
+                            distance += delta * delta;
+                        }
+                        if (distance < bestDistance)
+                        {
+                            bestDistance = distance;
+                            bestIndex = index;
+                        }
+                    }
+                    indices |= bestIndex << (2 * texel);
+                }
+            }
+
+            output[0] = static_cast<uchar>(color0);
+            output[1] = static_cast<uchar>(color0 >> 8);
+            output[2] = static_cast<uchar>(color1);
+            output[3] = static_cast<uchar>(color1 >> 8);
+            for (uint byte = 0; byte < 4; ++byte)
+            {
+                output[4 + byte] = static_cast<uchar>(indices >> (8 * byte));
+            }
+        }
+
+        void EncodeBlock(const uchar block[64], CompressedImage::Format format, std::array<uint, 2> const& channels,
+                         uchar* output)
+        {
+            uchar values[16];
+            auto gather = [&](uint channel)
+            {
+                for (uint texel = 0; texel < 16; ++texel)
+                {
+                    values[texel] = block[texel * 4 + channel];
+                }
+            };
+
+            switch (format)
+            {
+                case CompressedImage::FORMAT_BC1:
+                {
+                    EncodeBC1(block, output);
+                    break;
+                }
+                case CompressedImage::FORMAT_BC3:
+                {
+                    gather(3);
+                    EncodeBC4(values, output);
+                    EncodeBC1(block, output + 8);
+                    break;
+                }
+                case CompressedImage::FORMAT_BC4:
+                {
+                    gather(channels[0]);
+                    EncodeBC4(values, output);
+                    break;
+                }
+                case CompressedImage::FORMAT_BC5:
+                {
+                    gather(channels[0]);
+                    EncodeBC4(values, output);
+                    gather(channels[1]);
+                    EncodeBC4(values, output + 8);
+                    break;
+                }
+                default:
+                {
+                    CORE_ASSERT(false, "TextureTranscoder: unsupported encoder format");
+                    break;
+                }
+            }
+        }
+    } // namespace
+
+    bool TextureTranscoder::Encode(const uchar* rgba, uint width, uint height, Texture::Usage usage, bool sRGB,
+                                   CompressedImage& image)
+    {
+        if (!rgba || !width || !height)
+        {
+            return false;
+        }
+
+        // source channels for the single- and dual-channel formats
+        std::array<uint, 2> channels{0, 1};
+        image.m_Swizzle = {'r', 'g', 'b', 'a'};
+        switch (usage)
+        {
+            case Texture::USAGE_NORMAL_MAP:
+            {
+                image.m_Format = CompressedImage::FORMAT_BC5;
+                break;
+            }
+            case Texture::USAGE_ROUGHNESS_METALLIC_MAP:
+            {
+                // roughness (g) and metallic (b) move to r and g, the image view swizzles them back
+                image.m_Format = CompressedImage::FORMAT_BC5;
+                channels = {1, 2};
+                image.m_Swizzle = {'0', 'r', 'g', '1'};
+                break;
+            }
+            case Texture::USAGE_GRAYSCALE_MAP:
+            {
+                image.m_Format = CompressedImage::FORMAT_BC4;
+                image.m_Swizzle = {'r', 'r', 'r', '1'};
+                break;
+            }
+            default:
+            {
+                bool opaque = true;
+                for (size_t pixel = 0; pixel < static_cast<size_t>(width) * height; ++pixel)
+                {
+                    if (rgba[pixel * 4 + 3] != 255)
+                    {
+                        opaque = false;
+                        break;
+                    }
+                }
+                image.m_Format = opaque ? CompressedImage::FORMAT_BC1 : CompressedImage::FORMAT_BC3;
+                break;
+            }
+        }
+        bool isColor = (image.m_Format == CompressedImage::FORMAT_BC1) || (image.m_Format == CompressedImage::FORMAT_BC3);
+        image.m_sRGB = sRGB && isColor;
+        image.m_Width = width;
+        image.m_Height = height;
+
+        uint levelCount = static_cast<uint>(std::floor(std::log2(std::max(width, height)))) + 1;
+        image.m_Levels.resize(levelCount);
+        size_t totalSize = 0;
+        for (uint level = 0; level < levelCount; ++level)
+        {
+            auto& mip = image.m_Levels[level];
+            mip.m_Width = std::max(1u, width >> level);
+            mip.m_Height = std::max(1u, height >> level);
+            mip.m_Offset = totalSize;
+            mip.m_Size = CompressedImage::GetLevelSize(image.m_Format, mip.m_Width, mip.m_Height);
+            totalSize += mip.m_Size;
+        }
+        image.m_Data.resize(totalSize);
+
+        uint blockSize = CompressedImage::GetBlockSize(image.m_Format);
+        std::vector<uchar> currentLevel(rgba, rgba + static_cast<size_t>(width) * height * 4);
+        std::vector<uchar> nextLevel;
+        for (uint level = 0; level < levelCount; ++level)
+        {
+            auto& mip = image.m_Levels[level];
+            uint blocksX = std::max(1u, (mip.m_Width + 3) / 4);
+            uint blocksY = std::max(1u, (mip.m_Height + 3) / 4);
+            uchar* output = image.m_Data.data() + mip.m_Offset;
+            uchar block[64];
+            for (uint blockY = 0; blockY < blocksY; ++blockY)
+            {
+                for (uint blockX = 0; blockX < blocksX; ++blockX)
+                {
+                    FetchBlock(currentLevel.data(), mip.m_Width, mip.m_Height, blockX, blockY, block);
+                    EncodeBlock(block, image.m_Format, channels, output);
+                    output += blockSize;
+                }
+            }
+
+            if (level + 1 < levelCount)
+            {
+                auto& nextMip = image.m_Levels[level + 1];
+                nextLevel.resize(static_cast<size_t>(nextMip.m_Width) * nextMip.m_Height * 4);
+                Downsample(currentLevel.data(), mip.m_Width, mip.m_Height, nextLevel.data(), nextMip.m_Width,
+                           nextMip.m_Height, usage, image.m_sRGB);
+                std::swap(currentLevel, nextLevel);
+            }
+        }
+        return true;
+    }
+
+    bool TextureTranscoder::Import(std::string const& filename, Texture::Usage usage, bool sRGB, bool flip,
+                                   CompressedImage& image, std::string& cacheFile)
+    {
+        // the cache file name encodes the source file, its modification time, and the encoder parameters
+        std::error_code errorCode;
+        std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(filename, errorCode);
+        std::string path = errorCode ? filename : canonicalPath.generic_string();
+        auto lastWriteTime = std::filesystem::last_write_time(filename, errorCode);
+        if (errorCode)
+        {
+            return false;
+        }
+        uint64 hash = HashName(path);
+        hash ^= static_cast<uint64>(lastWriteTime.time_since_epoch().count()) * 0x9e3779b97f4a7c15ull;
+        hash ^= (static_cast<uint64>(usage) << 1 | static_cast<uint64>(sRGB) << 8 | static_cast<uint64>(flip) << 9 |
+                 ENCODER_VERSION << 16) *
+                0xc2b2ae3d27d4eb4full;
+
+        char cacheFilename[32];
+        snprintf(cacheFilename, sizeof(cacheFilename), "%016llx.ktx2", static_cast<unsigned long long>(hash));
+        std::string cacheFilepath = std::string(CACHE_DIRECTORY) + cacheFilename;
+
+        if (EngineCore::FileExists(cacheFilepath) && image.LoadKTX2(cacheFilepath))
+        {
+            cacheFile = cacheFilepath;
+            return true;
+        }
+
+        int width = 0, height = 0, channelsInFile = 0;
+        stbi_set_flip_vertically_on_load_thread(flip);
+        uchar* rgba = stbi_load(filename.c_str(), &width, &height, &channelsInFile, 4 /*desired_channels*/);
+        if (!rgba)
+        {
+            return false;
+        }
+        bool ok = Encode(rgba, static_cast<uint>(width), static_cast<uint>(height), usage, sRGB, image);
+        stbi_image_free(rgba);
+        if (!ok)
+        {
+            return false;
+        }
+
+        // write to a temporary file first so a concurrent reader never sees a partial file
+        std::filesystem::create_directories(CACHE_DIRECTORY, errorCode);
+        std::string temporaryFilepath =
+            cacheFilepath + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        bool saved = image.SaveKTX2(temporaryFilepath);
+        if (saved)
+        {
+            std::filesystem::rename(temporaryFilepath, cacheFilepath, errorCode);
+        }
+        if (!saved || errorCode)
+        {
+            LOG_CORE_WARN("TextureTranscoder: couldn't write {0}", cacheFilepath);
+            std::filesystem::remove(temporaryFilepath, errorCode);
+        }
+        else
+        {
+            cacheFile = cacheFilepath;
+        }
+        return true;
+    }
+
+    std::shared_ptr<Texture> TextureTranscoder::LoadCompressed(std::string const& filename, Texture::Usage usage,
+                                                               bool sRGB, bool flip, int minFilter, int magFilter)
+    {
+        ZoneScopedN("TextureTranscoder::LoadCompressed");
+        CompressedImage image;
+        std::string streamSource; // file to stream larger mip levels from, if any
+        if (CompressedImage::IsCompressedFile(filename))
+        {
+            // precompressed files are uploaded as authored, flip does not apply
+            if (!image.Load(filename))
+            {
+                return nullptr;
+            }
+            streamSource = filename;
+        }
+        else
+        {
+            // BC1 to BC5 are all covered by the same device feature
+            if (!CoreSettings::m_TranscodeTextures || !Texture::IsFormatSupported(CompressedImage::FORMAT_BC5))
+            {
+                return nullptr;
+            }
+            if (!Import(filename, usage, sRGB, flip, image, streamSource))
+            {
+                return nullptr;
+            }
+        }
+
+        if (!Texture::IsFormatSupported(image.m_Format))
+        {
+            LOG_CORE_ERROR("TextureTranscoder: format of {0} not supported by the device", filename);
+            return nullptr;
+        }
+
+        auto texture = Texture::Create();
+        bool streamed = CoreSettings::m_TextureStreaming && !streamSource.empty();
+        bool ok = streamed ? texture->InitStreamed(image, streamSource, sRGB, minFilter, magFilter)
+                           : texture->Init(image, sRGB, minFilter, magFilter);
+        if (!ok)
+        {
+            return nullptr;
+        }
+        texture->SetFilename(filename);
+        return texture;
+    }
+} // namespace GfxRenderEngine
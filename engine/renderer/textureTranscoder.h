@@ -0,0 +1,59 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "engine.h"
+#include "renderer/compressedImage.h"
+#include "renderer/texture.h"
+
+namespace GfxRenderEngine
+{
+    // Block-compressed texture import.
+    // KTX2 and DDS files are uploaded with their stored mip chain.
+    // With CoreSettings::m_TranscodeTextures enabled, PNG/JPEG files are encoded once
+    // into a KTX2 file in CACHE_DIRECTORY with prefiltered mips, later runs load that file.
+    class TextureTranscoder
+    {
+    public:
+        static constexpr const char* CACHE_DIRECTORY = "bin-int/textures/";
+
+        // returns nullptr if the file is neither precompressed nor transcodable,
+        // the caller then falls back to an uncompressed RGBA8 texture
+        static std::shared_ptr<Texture> LoadCompressed(std::string const& filename, Texture::Usage usage, bool sRGB,
+                                                       bool flip, int minFilter, int magFilter);
+
+        // builds the mip chain and block-compresses it:
+        // color BC1 (opaque) or BC3, normal maps BC5 (z reconstructed in the shader),
+        // roughness-metallic maps BC5 with a swizzle, grayscale maps BC4
+        static bool Encode(const uchar* rgba, uint width, uint height, Texture::Usage usage, bool sRGB,
+                           CompressedImage& image);
+
+    private:
+        // cacheFile is set to the KTX2 file in CACHE_DIRECTORY if the image could be stored there
+        static bool Import(std::string const& filename, Texture::Usage usage, bool sRGB, bool flip,
+                           CompressedImage& image, std::string& cacheFile);
+    };
+} // namespace GfxRenderEngine
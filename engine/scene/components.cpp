@@ -38,13 +38,13 @@ namespace GfxRenderEngine
     uint MeshComponent::m_DefaultNameTagCounter = 0;
 
     MeshComponent::MeshComponent(std::string const& name, std::shared_ptr<Model> model, bool enabled)
-        : m_Name{name}, m_Model{model}, m_Enabled{enabled}
+        : m_Name{NameTable::Intern(name)}, m_Model{model}, m_Enabled{enabled}
     {
     }
 
     MeshComponent::MeshComponent(std::shared_ptr<Model> model, bool enabled) : m_Model{model}, m_Enabled{enabled}
     {
-        m_Name = "mesh component " + std::to_string(m_DefaultNameTagCounter++);
+        m_Name = NameTable::Intern("mesh component " + std::to_string(m_DefaultNameTagCounter++));
     }
 
     TransformComponent::TransformComponent()
@@ -207,9 +207,10 @@ namespace GfxRenderEngine
     {
         if (m_InstanceBuffer)
         {
+            // instanced shaders derive the normal matrix, it is kept for CPU users only
             auto mat4Global = parent * GetMat4Local();
-            auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(mat4Global)));
-            m_InstanceBuffer->SetInstanceData(m_InstanceIndex, mat4Global, normalMatrix);
+            m_NormalMatrix = glm::transpose(glm::inverse(glm::mat3(mat4Global)));
+            m_InstanceBuffer->SetInstanceData(m_InstanceIndex, mat4Global);
         }
         else
         {
@@ -237,17 +238,7 @@ namespace GfxRenderEngine
         }
     }
 
-    const glm::mat4& TransformComponent::GetNormalMatrix()
-    {
-        if (m_InstanceBuffer)
-        {
-            return m_InstanceBuffer->GetNormalMatrix(m_InstanceIndex);
-        }
-        else
-        {
-            return m_NormalMatrix;
-        }
-    }
+    const glm::mat4& TransformComponent::GetNormalMatrix() { return m_NormalMatrix; }
 
     const glm::mat4& TransformComponent::GetParent() { return m_Parent; }
 
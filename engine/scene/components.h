@@ -24,10 +24,12 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "entt.hpp"
 
 #include "engine.h"
+#include "auxiliary/nameTable.h"
 
 namespace GfxRenderEngine
 {
@@ -114,7 +116,7 @@ namespace GfxRenderEngine
         MeshComponent(std::string const& name, std::shared_ptr<Model> model, bool enabled = true);
         MeshComponent(std::shared_ptr<Model> model, bool enabled = true);
 
-        std::string m_Name;
+        NameID m_Name; // see NameTable
         std::shared_ptr<Model> m_Model;
         bool m_Enabled{false};
 
@@ -225,6 +227,17 @@ namespace GfxRenderEngine
 
     struct GrassTag
     {
+        // the blades of a square tile of the height map, occlusion culling tests one box per chunk
+        struct Chunk
+        {
+            uint m_FirstInstance;
+            uint m_InstanceCount;
+            glm::vec3 m_Min; // grass space: column, height, row
+            glm::vec3 m_Max;
+        };
+
         uint m_InstanceCount{0};
+        std::vector<Chunk> m_Chunks;
+        float m_BladeScale{1.0f}; // largest scale of a blade
     };
 } // namespace GfxRenderEngine
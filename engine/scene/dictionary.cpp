@@ -24,28 +24,35 @@
 
 namespace GfxRenderEngine
 {
-    void Dictionary::Insert(const std::string& key, entt::entity value)
+    void Dictionary::InsertLong(std::string_view key, entt::entity value)
     {
-        m_DictStr2GameObject[key] = value;
+        NameID nameID = NameTable::Intern(key);
+        m_GameObject2LongName[value] = nameID;
+        m_DictName2GameObject[nameID] = value;
     }
 
-    void Dictionary::InsertLong(const std::string& key, entt::entity value)
+    void Dictionary::InsertShort(std::string_view key, entt::entity value)
     {
-        m_GameObject2LongStr[value] = key;
-        Insert(key, value);
+        NameID nameID = NameTable::Intern(key);
+        m_GameObject2ShortName[value] = nameID;
+        m_DictName2GameObject[nameID] = value;
     }
 
-    void Dictionary::InsertShort(const std::string& key, entt::entity value)
+    // the names must be interned
+    void Dictionary::Insert(NameID shortName, NameID longName, entt::entity value)
     {
-        m_GameObject2ShortStr[value] = key;
-        Insert(key, value);
+        m_GameObject2ShortName[value] = shortName;
+        m_GameObject2LongName[value] = longName;
+        m_DictName2GameObject[shortName] = value;
+        m_DictName2GameObject[longName] = value;
     }
 
-    entt::entity Dictionary::Retrieve(const std::string& key)
+    entt::entity Dictionary::Retrieve(std::string_view key)
     {
-        if (m_DictStr2GameObject.find(key) != m_DictStr2GameObject.end())
+        auto iterator = m_DictName2GameObject.find(HashName(key));
+        if (iterator != m_DictName2GameObject.end())
         {
-            return m_DictStr2GameObject[key];
+            return iterator->second;
         }
         else
         {
@@ -54,24 +61,38 @@ namespace GfxRenderEngine
         }
     }
 
+    entt::entity Dictionary::Retrieve(NameID key)
+    {
+        auto iterator = m_DictName2GameObject.find(key);
+        if (iterator != m_DictName2GameObject.end())
+        {
+            return iterator->second;
+        }
+        else
+        {
+            LOG_CORE_WARN("Dictionary::Retrieve, game object with name ID {0:#x} not found", key);
+            return entt::null;
+        }
+    }
+
     void Dictionary::List() const
     {
         LOG_CORE_INFO("listing dictionary:");
-        for (auto& it: m_DictStr2GameObject)
+        for (auto& it: m_DictName2GameObject)
         {
-            LOG_CORE_INFO("key: `{0}`, value: `{1}`", it.first, it.second);
+            LOG_CORE_INFO("key: `{0}`, value: `{1}`", NameTable::GetString(it.first), it.second);
         }
     }
 
     const std::string& Dictionary::GetShortName(entt::entity gameObject)
     {
-        ASSERT(m_GameObject2ShortStr.find(gameObject) != m_GameObject2ShortStr.end());
-        return m_GameObject2ShortStr[gameObject];
+        ASSERT(m_GameObject2ShortName.find(gameObject) != m_GameObject2ShortName.end());
+        return NameTable::GetString(m_GameObject2ShortName[gameObject]);
     }
 
     const std::string& Dictionary::GetLongName(entt::entity gameObject)
     {
-        ASSERT(m_GameObject2LongStr.find(gameObject) != m_GameObject2LongStr.end());
-        return m_GameObject2LongStr[gameObject];
+        ASSERT(m_GameObject2LongName.find(gameObject) != m_GameObject2LongName.end());
+        return NameTable::GetString(m_GameObject2LongName[gameObject]);
     }
 }
@@ -23,23 +23,28 @@
 #pragma once
 
 #include <iostream>
-#include <unordered_map>
+#include <string_view>
 
 #include "engine.h"
 #include "entt.hpp"
+#include "auxiliary/nameTable.h"
 
 namespace GfxRenderEngine
 {
 
+    // maps interned names to game objects
+    // literals can be hashed at compile time: Retrieve("defaultCamera"_name)
     class Dictionary
     {
 
     public:
 
-        void InsertShort(const std::string& key, entt::entity value);
-        void InsertLong(const std::string& key, entt::entity value);
-        entt::entity Retrieve(const std::string& key);
-        size_t Size() const { return m_DictStr2GameObject.size(); }
+        void InsertShort(std::string_view key, entt::entity value);
+        void InsertLong(std::string_view key, entt::entity value);
+        void Insert(NameID shortName, NameID longName, entt::entity value);
+        entt::entity Retrieve(std::string_view key);
+        entt::entity Retrieve(NameID key);
+        size_t Size() const { return m_DictName2GameObject.size(); }
         void List() const;
 
         const std::string& GetShortName(entt::entity gameObject);
@@ -47,13 +52,9 @@ namespace GfxRenderEngine
 
     private:
 
-        void Insert(const std::string& key, entt::entity value);
-
-    private:
-
-        std::unordered_map<std::string, entt::entity> m_DictStr2GameObject;
-        std::unordered_map<entt::entity, std::string> m_GameObject2ShortStr;
-        std::unordered_map<entt::entity, std::string> m_GameObject2LongStr;
+        entt::dense_hash_map<NameID, entt::entity, NameIDHash> m_DictName2GameObject;
+        entt::dense_hash_map<entt::entity, NameID> m_GameObject2ShortName;
+        entt::dense_hash_map<entt::entity, NameID> m_GameObject2LongName;
 
     };
 
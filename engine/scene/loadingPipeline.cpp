@@ -0,0 +1,142 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <algorithm>
+
+#include "auxiliary/instrumentation.h"
+#include "scene/loadingPipeline.h"
+#include "scene/registry.h"
+
+namespace GfxRenderEngine
+{
+    float LoadingProgress::GetProgress() const
+    {
+        uint totalSteps = m_TotalSteps.load(std::memory_order_relaxed);
+        if (!totalSteps)
+        {
+            return 0.0f;
+        }
+        uint completedSteps = m_CompletedSteps.load(std::memory_order_relaxed);
+        return std::min(static_cast<float>(completedSteps) / static_cast<float>(totalSteps), 1.0f);
+    }
+
+    LoadingPipeline::LoadingPipeline() : m_MainThread{std::this_thread::get_id()} {}
+
+    bool LoadingPipeline::Integrate(Registry& registry, LoadingProgress const& progress)
+    {
+        if (progress.IsCancelled())
+        {
+            return false;
+        }
+        if (std::this_thread::get_id() == m_MainThread)
+        {
+            // scenes loaded synchronously on the main thread have no frame to spread the work over
+            registry.Flush();
+            return true;
+        }
+
+        auto request = std::make_shared<Request>();
+        request->m_Registry = &registry;
+        request->m_Progress = &progress;
+        std::future<bool> done = request->m_Done.get_future();
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_Shutdown)
+            {
+                return false;
+            }
+            m_Requests.push_back(request);
+        }
+        return done.get();
+    }
+
+    std::shared_ptr<LoadingPipeline::Request> LoadingPipeline::NextRequest() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (auto& request : m_Requests)
+        {
+            if (!request->m_Progress->IsLowPriority() || request->m_Progress->IsCancelled())
+            {
+                return request;
+            }
+        }
+        return m_Requests.empty() ? nullptr : m_Requests.front();
+    }
+
+    void LoadingPipeline::Update(float budgetMs)
+    {
+        ZoneScopedN("LoadingPipeline::Update");
+        auto toDuration = [](float milliseconds)
+        {
+            return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<float, std::milli>(milliseconds));
+        };
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = start + toDuration(budgetMs);
+        auto lowPriorityDeadline = start + toDuration(budgetMs * LOW_PRIORITY_SHARE);
+        while (true)
+        {
+            std::shared_ptr<Request> request = NextRequest();
+            if (!request)
+            {
+                return;
+            }
+
+            bool cancelled = request->m_Progress->IsCancelled();
+            bool lowPriority = request->m_Progress->IsLowPriority();
+            bool finished = cancelled || request->m_Registry->Flush(lowPriority ? lowPriorityDeadline : deadline);
+            if (!finished)
+            {
+                return; // budget used up, continue next frame
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Requests.erase(std::find(m_Requests.begin(), m_Requests.end(), request));
+            }
+            request->m_Done.set_value(!cancelled);
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                return;
+            }
+        }
+    }
+
+    void LoadingPipeline::Shutdown()
+    {
+        std::deque<std::shared_ptr<Request>> requests;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Shutdown = true;
+            requests.swap(m_Requests);
+        }
+        for (auto& request : requests)
+        {
+            request->m_Done.set_value(false);
+        }
+    }
+
+    size_t LoadingPipeline::GetPendingRequests() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Requests.size();
+    }
+} // namespace GfxRenderEngine
@@ -0,0 +1,106 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "engine.h"
+
+namespace GfxRenderEngine
+{
+    class Registry;
+
+    // progress and cancellation of one scene load
+    // the total grows while the scene description is parsed, so early values are estimates
+    class LoadingProgress
+    {
+    public:
+        void AddSteps(uint steps) { m_TotalSteps.fetch_add(steps, std::memory_order_relaxed); }
+        void CompleteStep() { m_CompletedSteps.fetch_add(1, std::memory_order_relaxed); }
+        float GetProgress() const; // 0.0f to 1.0f
+
+        void Cancel() { m_Cancelled.store(true, std::memory_order_relaxed); }
+        bool IsCancelled() const { return m_Cancelled.load(std::memory_order_relaxed); }
+
+        // preloads are merged only with a fraction of the frame budget and after all other loads
+        void SetLowPriority(bool lowPriority) { m_LowPriority.store(lowPriority, std::memory_order_relaxed); }
+        bool IsLowPriority() const { return m_LowPriority.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<uint> m_TotalSteps{0};
+        std::atomic<uint> m_CompletedSteps{0};
+        std::atomic<bool> m_Cancelled{false};
+        std::atomic<bool> m_LowPriority{false};
+    };
+
+    // Scenes are decoded on worker threads, while the structural changes they
+    // recorded in registry command buffers are merged on the main thread in
+    // time slices of a per-frame budget. This keeps the frame rate of the
+    // running scene steady while the next scene streams in.
+    class LoadingPipeline
+    {
+    public:
+        static constexpr float DEFAULT_BUDGET_MS = 2.0f;
+        static constexpr float LOW_PRIORITY_SHARE = 0.25f; // of the budget
+
+    public:
+        LoadingPipeline(); // must be constructed on the main thread
+        ~LoadingPipeline() = default;
+
+        LoadingPipeline(LoadingPipeline const&) = delete;
+        LoadingPipeline& operator=(LoadingPipeline const&) = delete;
+
+        // called by a loader thread: blocks until the main thread has merged all commands
+        // submitted to the registry; returns false if the load was cancelled or the pipeline shut down
+        bool Integrate(Registry& registry, LoadingProgress const& progress);
+
+        // called by the main thread once per frame
+        void Update(float budgetMs = DEFAULT_BUDGET_MS);
+        // releases all waiting loader threads, later loads are cancelled right away
+        void Shutdown();
+
+        size_t GetPendingRequests() const;
+
+    private:
+        struct Request
+        {
+            Registry* m_Registry;
+            LoadingProgress const* m_Progress;
+            std::promise<bool> m_Done;
+        };
+
+        std::shared_ptr<Request> NextRequest() const; // normal priority first, nullptr if idle
+
+    private:
+        std::thread::id m_MainThread;
+        mutable std::mutex m_Mutex;
+        std::deque<std::shared_ptr<Request>> m_Requests;
+        bool m_Shutdown{false};
+    };
+} // namespace GfxRenderEngine
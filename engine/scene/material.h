@@ -60,6 +60,10 @@ namespace GfxRenderEngine
             HAS_EMISSIVE_MAP = GLSL_HAS_EMISSIVE_MAP
         };
 
+        // the features pbr.frag branches on, pipelines are specialized for them
+        static constexpr uint SHADER_FEATURES = HAS_DIFFUSE_MAP | HAS_NORMAL_MAP | HAS_ROUGHNESS_MAP | HAS_METALLIC_MAP |
+                                                HAS_ROUGHNESS_METALLIC_MAP | HAS_EMISSIVE_MAP;
+
         struct PbrMaterial
         { // align data to blocks of 16 bytes
             // byte 0 to 15
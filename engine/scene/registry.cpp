@@ -20,17 +20,114 @@
    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
+#include <algorithm>
+
 #include "scene/registry.h"
 
 namespace GfxRenderEngine
 {
-    Registry::Registry() {}
+    thread_local Registry::CommandBuffer* Registry::m_ThreadCommandBuffer = nullptr;
+
+    Registry::Registry() : m_NextEntity{0} {}
 
     Registry::~Registry() {}
 
+    Registry::CommandBuffer::CommandBuffer(Registry& registry)
+        : m_Registry{registry}, m_Previous{m_ThreadCommandBuffer}, m_Recording{std::make_unique<Recording>()}
+    {
+        m_ThreadCommandBuffer = this;
+    }
+
+    Registry::CommandBuffer::~CommandBuffer()
+    {
+        m_ThreadCommandBuffer = m_Previous;
+        m_Registry.Submit(std::move(m_Recording));
+    }
+
+    bool Registry::CommandBuffer::Contains(const entt::entity entity) const { return m_Recording->m_Staging.valid(entity); }
+
+    Registry::CommandBuffer* Registry::GetCommandBuffer() const
+    {
+        CommandBuffer* commandBuffer = m_ThreadCommandBuffer;
+        return (commandBuffer && (&commandBuffer->m_Registry == this)) ? commandBuffer : nullptr;
+    }
+
+    entt::entity Registry::Reserve()
+    {
+        // entities are never destroyed, so all IDs come from this counter
+        return static_cast<entt::entity>(m_NextEntity.fetch_add(1, std::memory_order_relaxed));
+    }
+
     [[nodiscard]] entt::entity Registry::Create()
     {
-        std::lock_guard<std::mutex> guard(m_Mutex);
-        return m_Registry.create();
+        entt::entity entity = Reserve();
+        if (CommandBuffer* commandBuffer = GetCommandBuffer())
+        {
+            auto& recording = *commandBuffer->m_Recording;
+            recording.m_CreatedEntities.push_back(recording.m_Staging.create(entity));
+            return entity;
+        }
+        return m_Registry.create(entity);
+    }
+
+    void Registry::Submit(std::unique_ptr<CommandBuffer::Recording>&& recording)
+    {
+        if (recording->m_CreatedEntities.empty() && recording->m_Commands.empty())
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> guard(m_SubmitMutex);
+        m_Submitted.push_back(std::move(recording));
+    }
+
+    void Registry::Flush() { Flush(std::chrono::steady_clock::time_point::max()); }
+
+    bool Registry::Flush(std::chrono::steady_clock::time_point deadline)
+    {
+        ZoneScopedN("Registry::Flush");
+        {
+            std::lock_guard<std::mutex> guard(m_SubmitMutex);
+            for (auto& recording : m_Submitted)
+            {
+                m_Pending.push_back(std::move(recording));
+            }
+            m_Submitted.clear();
+        }
+
+        // reading the clock for every command would cost more than most commands
+        constexpr size_t COMMANDS_PER_DEADLINE_CHECK = 64;
+        while (!m_Pending.empty())
+        {
+            auto& recording = *m_Pending.front();
+
+            // highest ID first: lower reserved IDs then sit at the head of entt's free list
+            auto& createdEntities = recording.m_CreatedEntities;
+            std::sort(createdEntities.begin(), createdEntities.end(), std::greater<entt::entity>());
+            for (auto entity : createdEntities)
+            {
+                [[maybe_unused]] auto createdEntity = m_Registry.create(entity);
+                CORE_ASSERT(createdEntity == entity, "Registry::Flush: entity ID already in use");
+            }
+            createdEntities.clear(); // a resumed flush must not create them again
+
+            auto& commands = recording.m_Commands;
+            while (m_NextCommand < commands.size())
+            {
+                commands[m_NextCommand](recording.m_Staging, m_Registry);
+                ++m_NextCommand;
+                if (((m_NextCommand % COMMANDS_PER_DEADLINE_CHECK) == 0) &&
+                    (std::chrono::steady_clock::now() >= deadline))
+                {
+                    return false;
+                }
+            }
+            m_Pending.pop_front();
+            m_NextCommand = 0;
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                return m_Pending.empty();
+            }
+        }
+        return true;
     }
 } // namespace GfxRenderEngine
@@ -22,16 +22,60 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
 #include "entt.hpp"
 
 #include "engine.h"
+#include "auxiliary/threadPool.h"
 
 namespace GfxRenderEngine
 {
 
+    // Reads (get, view, all_of) do not lock. Structural changes (Create, emplace) are made
+    // by one thread at a time: the thread that loads or runs the scene.
+    // Worker threads that build parts of a scene open a CommandBuffer. While it is alive,
+    // Create, emplace, get and all_of of this thread are recorded in the command buffer,
+    // entity IDs are reserved lock-free. The command buffer is submitted when it goes
+    // out of scope and merged into the registry by Flush() at a sync point.
     class Registry
     {
 
+    public:
+        class CommandBuffer
+        {
+        public:
+            CommandBuffer(Registry& registry);
+            ~CommandBuffer();
+
+            CommandBuffer(const CommandBuffer&) = delete;
+            CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+        private:
+            friend class Registry;
+            using Command = std::function<void(entt::registry& staging, entt::registry& registry)>;
+
+            struct Recording
+            {
+                entt::registry m_Staging; // components of this command buffer
+                std::vector<entt::entity> m_CreatedEntities;
+                std::vector<Command> m_Commands;
+            };
+
+            bool Contains(const entt::entity entity) const;
+
+            Registry& m_Registry;
+            CommandBuffer* m_Previous;
+            std::unique_ptr<Recording> m_Recording;
+        };
+
     public:
         Registry();
         ~Registry();
@@ -41,31 +85,99 @@ namespace GfxRenderEngine
 
         template <typename Component, typename... Args> decltype(auto) emplace(const entt::entity entity, Args&&... args)
         {
-            std::lock_guard<std::mutex> guard(m_Mutex);
+            if (CommandBuffer* commandBuffer = GetCommandBuffer())
+            {
+                auto& recording = *commandBuffer->m_Recording;
+                if (!recording.m_Staging.valid(entity))
+                {
+                    // entity lives in the registry, stage its new components only
+                    [[maybe_unused]] auto stagingEntity = recording.m_Staging.create(entity);
+                }
+                recording.m_Commands.push_back(
+                    [entity](entt::registry& staging, entt::registry& registry)
+                    {
+                        if constexpr (std::is_empty_v<Component>)
+                        {
+                            registry.emplace<Component>(entity);
+                        }
+                        else
+                        {
+                            registry.emplace<Component>(entity, std::move(staging.get<Component>(entity)));
+                        }
+                    });
+                return recording.m_Staging.emplace<Component>(entity, std::forward<Args>(args)...);
+            }
             return m_Registry.emplace<Component>(entity, std::forward<Args>(args)...);
         }
 
         template <typename Component> [[nodiscard]] decltype(auto) get([[maybe_unused]] const entt::entity entity)
         {
-            std::lock_guard<std::mutex> guard(m_Mutex);
+            CommandBuffer* commandBuffer = GetCommandBuffer();
+            if (commandBuffer && commandBuffer->Contains(entity) &&
+                commandBuffer->m_Recording->m_Staging.all_of<Component>(entity))
+            {
+                return commandBuffer->m_Recording->m_Staging.get<Component>(entity);
+            }
             return m_Registry.get<Component>(entity);
         }
 
         template <typename Component, typename... Other, typename... Exclude>
         [[nodiscard]] auto view(entt::exclude_t<Exclude...> = {})
         {
-            std::lock_guard<std::mutex> guard(m_Mutex);
             return m_Registry.view<Component, Other...>();
         }
 
         template <typename... Component> [[nodiscard]] bool all_of(const entt::entity entity)
         {
-            std::lock_guard<std::mutex> guard(m_Mutex);
+            CommandBuffer* commandBuffer = GetCommandBuffer();
+            if (commandBuffer && commandBuffer->Contains(entity))
+            {
+                auto& staging = commandBuffer->m_Recording->m_Staging;
+                return ((staging.all_of<Component>(entity) || m_Registry.all_of<Component>(entity)) && ...);
+            }
             return m_Registry.all_of<Component...>(entity);
         }
 
+        // calls function(entity) for all entities of a view on the threads of a pool
+        // the function may read and modify components of its entity but not add or remove components
+        template <typename Component, typename... Other, typename Function>
+        void ParallelEach(ThreadPool& threadPool, uint grainSize, Function&& function)
+        {
+            auto view = m_Registry.view<Component, Other...>();
+            std::vector<entt::entity> entities(view.begin(), view.end());
+            threadPool.ParallelFor(0, static_cast<uint>(entities.size()), grainSize,
+                                   [&entities, &function](uint first, uint last)
+                                   {
+                                       for (uint index = first; index < last; ++index)
+                                       {
+                                           function(entities[index]);
+                                       }
+                                   });
+        }
+
+        // merges all submitted command buffers into the registry
+        // called by the thread that makes structural changes
+        void Flush();
+        // merges submitted command buffers until the deadline has passed, the next call continues
+        // where this one stopped; returns true when no commands are pending
+        bool Flush(std::chrono::steady_clock::time_point deadline);
+
     private:
-        std::mutex m_Mutex;
+        entt::entity Reserve();
+        CommandBuffer* GetCommandBuffer() const;
+        void Submit(std::unique_ptr<CommandBuffer::Recording>&& recording);
+
+    private:
+        static thread_local CommandBuffer* m_ThreadCommandBuffer;
+
         entt::registry m_Registry;
+        std::atomic<std::underlying_type_t<entt::entity>> m_NextEntity;
+
+        std::mutex m_SubmitMutex;
+        std::vector<std::unique_ptr<CommandBuffer::Recording>> m_Submitted;
+
+        // recordings taken over by Flush(), owned by the flushing thread
+        std::deque<std::unique_ptr<CommandBuffer::Recording>> m_Pending;
+        size_t m_NextCommand{0}; // first command of m_Pending.front() not yet merged
     };
 } // namespace GfxRenderEngine
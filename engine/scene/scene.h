@@ -31,6 +31,7 @@
 #include "scene/registry.h"
 #include "scene/sceneGraph.h"
 #include "scene/dictionary.h"
+#include "scene/loadingPipeline.h"
 #include "auxiliary/timestep.h"
 
 namespace GfxRenderEngine
@@ -72,6 +73,7 @@ namespace GfxRenderEngine
         TreeNode* GetTreeNode(entt::entity entity) { return &m_SceneGraph.GetNodeByGameObject(entity); }
         TreeNode& GetTreeNode(uint nodeIndex) { return m_SceneGraph.GetNode(nodeIndex); }
         uint GetTreeNodeIndex(entt::entity entity) { return m_SceneGraph.GetTreeNodeIndex(entity); }
+        LoadingProgress& GetLoadingProgress() { return m_LoadingProgress; }
 
     protected:
         std::string m_Name;
@@ -80,6 +82,7 @@ namespace GfxRenderEngine
         Registry m_Registry;
         Dictionary m_Dictionary;
         SceneGraph m_SceneGraph;
+        LoadingProgress m_LoadingProgress;
         bool m_IsRunning;
 
         // scene lights
@@ -24,13 +24,13 @@
 
 namespace GfxRenderEngine
 {
-    TreeNode::TreeNode(entt::entity gameObject, const std::string& name, const std::string& longName)
-        : m_GameObject(gameObject), m_LongName(longName), m_Name(name)
+    TreeNode::TreeNode(entt::entity gameObject, NameID name, NameID longName)
+        : m_GameObject(gameObject), m_Name(name), m_LongName(longName)
     {
     }
 
     TreeNode::TreeNode(GfxRenderEngine::TreeNode const& other)
-        : m_GameObject(other.m_GameObject), m_LongName(other.m_LongName), m_Name(other.m_Name), m_Children(other.m_Children)
+        : m_GameObject(other.m_GameObject), m_Name(other.m_Name), m_LongName(other.m_LongName), m_Children(other.m_Children)
     {
     }
 
@@ -38,9 +38,9 @@ namespace GfxRenderEngine
 
     entt::entity TreeNode::GetGameObject() const { return m_GameObject; }
 
-    const std::string& TreeNode::GetName() const { return m_Name; }
+    const std::string& TreeNode::GetName() const { return NameTable::GetString(m_Name); }
 
-    const std::string& TreeNode::GetLongName() const { return m_LongName; }
+    const std::string& TreeNode::GetLongName() const { return NameTable::GetString(m_LongName); }
 
     uint TreeNode::Children() const { return m_Children.size(); }
 
@@ -59,11 +59,14 @@ namespace GfxRenderEngine
     uint SceneGraph::CreateNode(entt::entity const gameObject, std::string const& name, std::string const& longName,
                                 Dictionary& dictionary)
     {
+        // intern outside of the scene graph lock
+        NameID nameID = NameTable::Intern(name);
+        NameID longNameID = NameTable::Intern(longName);
+
         std::lock_guard<std::mutex> guard(m_Mutex);
         uint nodeIndex = m_Nodes.size();
-        m_Nodes.push_back({gameObject, name, longName});
-        dictionary.InsertShort(name, gameObject);
-        dictionary.InsertLong(longName, gameObject);
+        m_Nodes.push_back({gameObject, nameID, longNameID});
+        dictionary.Insert(nameID, longNameID, gameObject);
         m_MapFromGameObjectToNode[gameObject] = nodeIndex;
         return nodeIndex;
     }
@@ -35,13 +35,15 @@ namespace GfxRenderEngine
     {
 
     public:
-        TreeNode(entt::entity gameObject, const std::string& name, const std::string& longName);
+        TreeNode(entt::entity gameObject, NameID name, NameID longName);
         TreeNode(GfxRenderEngine::TreeNode const& other);
         ~TreeNode();
 
         entt::entity GetGameObject() const;
         const std::string& GetName() const;
         const std::string& GetLongName() const;
+        NameID GetNameID() const { return m_Name; }
+        NameID GetLongNameID() const { return m_LongName; }
         uint Children() const;
         uint GetChild(uint const childIndex);
         uint AddChild(uint const nodeIndex);
@@ -50,8 +52,8 @@ namespace GfxRenderEngine
 
     private:
         entt::entity m_GameObject;
-        std::string m_Name;
-        std::string m_LongName;
+        NameID m_Name;
+        NameID m_LongName;
         std::mutex m_Mutex;
         std::vector<uint> m_Children;
     };
@@ -71,6 +73,7 @@ namespace GfxRenderEngine
         TreeNode& GetRoot();
 
         uint GetTreeNodeIndex(entt::entity const gameObject);
+        size_t Size() const { return m_Nodes.size(); }
         void TraverseLog(uint nodeIndex, uint indent = 0);
 
     private:
@@ -32,21 +32,40 @@ namespace GfxRenderEngine
 
     void SceneLoaderJSON::Deserialize(std::string& filepath, std::string& alternativeFilepath)
     {
+        std::string* sceneDescription;
         if (EngineCore::FileExists(filepath))
         {
-            LOG_CORE_INFO("Loading scene {0}", filepath);
-            Deserialize(filepath);
+            sceneDescription = &filepath;
         }
         else if (EngineCore::FileExists(alternativeFilepath))
         {
-            LOG_CORE_INFO("Loading scene {0}", alternativeFilepath);
-            Deserialize(alternativeFilepath);
+            sceneDescription = &alternativeFilepath;
         }
         else
         {
             LOG_CORE_CRITICAL("Scene loader could neither find file {0} nor file {1}", filepath, alternativeFilepath);
             return;
         }
+        LOG_CORE_INFO("Loading scene {0}", *sceneDescription);
+        Deserialize(*sceneDescription);
+
+        // a snapshot older than the scene description would undo the edits made to the description
+        std::error_code errorCode;
+        auto snapshotTime = std::filesystem::last_write_time(GetSnapshotFilepath(), errorCode);
+        if (!errorCode)
+        {
+            auto sceneDescriptionTime = std::filesystem::last_write_time(*sceneDescription, errorCode);
+            m_SnapshotIsNewer = !errorCode && (snapshotTime >= sceneDescriptionTime);
+        }
+    }
+
+    void SceneLoaderJSON::RestoreSnapshot()
+    {
+        if (!m_SnapshotIsNewer || m_Scene.m_LoadingProgress.IsCancelled())
+        {
+            return;
+        }
+        SceneSnapshot::Restore(m_Scene, GetAssetReferences(), GetSnapshotFilepath());
     }
 
     void SceneLoaderJSON::Deserialize(std::string& filepath)
@@ -149,7 +168,12 @@ namespace GfxRenderEngine
                             continue;
                         }
                         auto& loadFuture = gltfInfo.m_LoadFuture.value();
-                        if (!loadFuture.get())
+                        bool loaded = loadFuture.get();
+                        if (!Integrate())
+                        {
+                            continue;
+                        }
+                        if (!loaded)
                         {
                             LOG_CORE_CRITICAL("gltf file did not load properly: {0}", gltfInfo.m_GltfFile.m_Filename);
                             continue;
@@ -242,7 +266,12 @@ namespace GfxRenderEngine
                             continue;
                         }
                         auto& loadFuture = gltfInfo.m_LoadFuture.value();
-                        if (!loadFuture.get())
+                        bool loaded = loadFuture.get();
+                        if (!Integrate())
+                        {
+                            continue;
+                        }
+                        if (!loaded)
                         {
                             LOG_CORE_CRITICAL("gltf file did not load properly: {0}", gltfInfo.m_GltfFile.m_Filename);
                             continue;
@@ -392,25 +421,35 @@ namespace GfxRenderEngine
                 gltfInfo.m_InstanceCount = instanceCount;
                 instanceFieldFound = true;
 
+                if (m_Scene.m_LoadingProgress.IsCancelled())
+                {
+                    return;
+                }
                 if (fast)
                 {
                     auto loadGltf = [this, gltfFilename, instanceCount, sceneID]()
                     {
+                        // merged into the registry by Integrate() after the future is ready
+                        Registry::CommandBuffer commandBuffer(m_Scene.m_Registry);
                         FastgltfBuilder builder(gltfFilename, m_Scene);
                         builder.SetDictionaryPrefix("SL"); // scene loader
                         return builder.Load(instanceCount, sceneID);
                     };
                     gltfInfo.m_LoadFuture = Engine::m_Engine->m_PoolPrimary.SubmitTask(loadGltf);
+                    m_Scene.m_LoadingProgress.AddSteps(1);
                 }
                 else
                 {
                     auto loadGltf = [this, gltfFilename, instanceCount, sceneID]()
                     {
+                        // merged into the registry by Integrate() after the future is ready
+                        Registry::CommandBuffer commandBuffer(m_Scene.m_Registry);
                         GltfBuilder builder(gltfFilename, m_Scene);
                         builder.SetDictionaryPrefix("SL"); // scene loader
                         return builder.Load(instanceCount, sceneID);
                     };
                     gltfInfo.m_LoadFuture = Engine::m_Engine->m_PoolPrimary.SubmitTask(loadGltf);
+                    m_Scene.m_LoadingProgress.AddSteps(1);
                 }
 
                 gltfInfo.m_GltfFile = Gltf::GltfFile{gltfFilename};
@@ -486,6 +525,11 @@ namespace GfxRenderEngine
                 // get array of fbx file instances
                 ondemand::array instances = fbxFileObject.value();
                 int instanceCount = instances.count_elements();
+                if (m_Scene.m_LoadingProgress.IsCancelled())
+                {
+                    return;
+                }
+                m_Scene.m_LoadingProgress.AddSteps(1);
                 if (ufbx)
                 {
                     UFbxBuilder builder(fbxFilename, m_Scene);
@@ -498,6 +542,7 @@ namespace GfxRenderEngine
                     builder.SetDictionaryPrefix("SL"); // scene loader
                     loadSuccessful = builder.Load(instanceCount);
                 }
+                m_Scene.m_LoadingProgress.CompleteStep();
                 if (loadSuccessful)
                 {
                     Fbx::FbxFile fbxFile(fbxFilename);
@@ -708,14 +753,20 @@ namespace GfxRenderEngine
                     LOG_CORE_ERROR("no instances found (json file broken): {0}", filename);
                     return;
                 }
+                if (m_Scene.m_LoadingProgress.IsCancelled())
+                {
+                    return;
+                }
 
                 auto loadTerrain = [this, filename, instanceCount]()
                 {
+                    Registry::CommandBuffer commandBuffer(m_Scene.m_Registry);
                     TerrainLoaderJSON terrainLoaderJSON(m_Scene);
                     return terrainLoaderJSON.Deserialize(filename, instanceCount);
                 };
 
                 terrainInfo.m_LoadFuture = Engine::m_Engine->m_PoolPrimary.SubmitTask(loadTerrain);
+                m_Scene.m_LoadingProgress.AddSteps(1);
                 terrainInfo.m_Filename = filename;
                 terrainInfo.m_InstanceCount = instanceCount;
                 terrainInfo.m_InstanceTransforms.resize(instanceCount);
@@ -752,6 +803,20 @@ namespace GfxRenderEngine
         }
     }
 
+    bool SceneLoaderJSON::Integrate()
+    {
+        // the main thread merges the recorded structural changes in time slices
+        if (!Engine::m_Engine->m_LoadingPipeline.Integrate(m_Scene.m_Registry, m_Scene.m_LoadingProgress))
+        {
+            LOG_CORE_INFO("SceneLoaderJSON: loading of scene '{0}' cancelled", m_Scene.m_Name);
+            return false;
+        }
+        m_Scene.m_LoadingProgress.CompleteStep();
+        LOG_CORE_INFO("SceneLoaderJSON: scene '{0}' {1:.0f}% loaded", m_Scene.m_Name,
+                      100.0f * m_Scene.m_LoadingProgress.GetProgress());
+        return true;
+    }
+
     std::vector<Terrain::TerrainDescription>& SceneLoaderJSON::GetTerrainDescriptions()
     {
         return m_SceneDescriptionFile.m_TerrainDescriptions;
@@ -767,7 +832,12 @@ namespace GfxRenderEngine
                 continue;
             }
             auto& loadFuture = terrainInfo.m_LoadFuture.value();
-            if (!loadFuture.get())
+            bool loaded = loadFuture.get();
+            if (!Integrate())
+            {
+                continue;
+            }
+            if (!loaded)
             {
                 continue;
             }
@@ -30,6 +30,7 @@ using namespace simdjson;
 
 #include "engine.h"
 #include "scene/scene.h"
+#include "scene/sceneSnapshot.h"
 #include "scene/fbx.h"
 #include "scene/gltf.h"
 #include "scene/obj.h"
@@ -46,6 +47,9 @@ namespace GfxRenderEngine
 
         void Deserialize(std::string& filepath, std::string& alternativeFilepath);
         void Serialize();
+        // applies the binary snapshot written by Serialize() if it is newer than the scene description
+        // call after all models of the scene are loaded
+        void RestoreSnapshot();
         Gltf::GltfFiles& GetGltfFiles() { return m_SceneDescriptionFile.m_GltfFiles; }
         std::vector<Terrain::TerrainDescription>& GetTerrainDescriptions();
         Gltf::GltfFiles& GetFastgltfFiles() { return m_SceneDescriptionFile.m_FastgltfFiles; }
@@ -94,6 +98,9 @@ namespace GfxRenderEngine
                                      std::vector<Terrain::TerrainDescription>& terrainDescriptions,
                                      TerrainInfo& terrainInfo);
         void FinalizeTerrainDescriptions();
+        bool Integrate(); // returns false if the scene load was cancelled
+        std::string GetSnapshotFilepath() const;
+        std::vector<SceneSnapshot::AssetReference> GetAssetReferences() const;
 
         glm::vec3 ConvertToVec3(ondemand::array arrayJSON);
 
@@ -142,5 +149,6 @@ namespace GfxRenderEngine
         SceneDescriptionFile m_SceneDescriptionFile;
 
         std::vector<TerrainInfo> m_TerrainInfos;
+        bool m_SnapshotIsNewer{false};
     };
 } // namespace GfxRenderEngine
@@ -32,6 +32,41 @@ namespace GfxRenderEngine
         m_OutputFile.open(m_Scene.m_Filepath);
         SerializeScene(NO_INDENT);
         m_OutputFile.close();
+        SceneSnapshot::Write(m_Scene, GetAssetReferences(), GetSnapshotFilepath());
+    }
+
+    std::string SceneLoaderJSON::GetSnapshotFilepath() const
+    {
+        return std::filesystem::path(m_Scene.m_Filepath).replace_extension(".snapshot").string();
+    }
+
+    std::vector<SceneSnapshot::AssetReference> SceneLoaderJSON::GetAssetReferences() const
+    {
+        std::vector<SceneSnapshot::AssetReference> assets;
+        auto addGltfFiles = [&assets](Gltf::GltfFiles const& gltfFiles, SceneSnapshot::AssetType type)
+        {
+            for (auto& gltfFile : gltfFiles.m_GltfFilesFromScene)
+            {
+                assets.push_back({HashName(gltfFile.m_Filename), static_cast<uint>(gltfFile.m_Instances.size()), type});
+            }
+        };
+        auto addFbxFiles = [&assets](Fbx::FbxFiles const& fbxFiles, SceneSnapshot::AssetType type)
+        {
+            for (auto& fbxFile : fbxFiles.m_FbxFilesFromScene)
+            {
+                assets.push_back({HashName(fbxFile.m_Filename), static_cast<uint>(fbxFile.m_Instances.size()), type});
+            }
+        };
+        addGltfFiles(m_SceneDescriptionFile.m_GltfFiles, SceneSnapshot::ASSET_GLTF);
+        addGltfFiles(m_SceneDescriptionFile.m_FastgltfFiles, SceneSnapshot::ASSET_FASTGLTF);
+        addFbxFiles(m_SceneDescriptionFile.m_FbxFiles, SceneSnapshot::ASSET_FBX);
+        addFbxFiles(m_SceneDescriptionFile.m_UFbxFiles, SceneSnapshot::ASSET_UFBX);
+        for (auto& terrainDescription : m_SceneDescriptionFile.m_TerrainDescriptions)
+        {
+            assets.push_back({HashName(terrainDescription.m_Filename),
+                              static_cast<uint>(terrainDescription.m_Instances.size()), SceneSnapshot::ASSET_TERRAIN});
+        }
+        return assets;
     }
 
     void SceneLoaderJSON::SerializeScene(int indent)
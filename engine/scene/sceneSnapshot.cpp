@@ -0,0 +1,548 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "auxiliary/instrumentation.h"
+#include "auxiliary/mappedFile.h"
+#include "scene/components.h"
+#include "scene/scene.h"
+#include "scene/sceneSnapshot.h"
+
+namespace GfxRenderEngine
+{
+    namespace
+    {
+        enum SectionType : uint
+        {
+            SECTION_NAMES = 0,
+            SECTION_STRINGS,
+            SECTION_ASSETS,
+            SECTION_NODES,
+            SECTION_CHILDREN,
+            SECTION_TRANSFORMS,
+            SECTION_POINT_LIGHTS,
+            SECTION_DIRECTIONAL_LIGHTS,
+            SECTION_INSTANCES,
+            SECTION_INSTANCE_ENTITIES,
+            SECTION_SCRIPTS,
+            NUMBER_OF_SECTIONS
+        };
+
+        // all records have explicit padding, so files are byte-identical for identical scenes
+        struct FileHeader
+        {
+            uint m_Magic;
+            uint m_Version;
+            uint m_SectionCount;
+            uint m_Padding;
+        };
+
+        struct SectionHeader
+        {
+            uint m_Type;
+            uint m_RecordSize;
+            uint64 m_Count;
+            uint64 m_Offset; // from the beginning of the file, 8-byte aligned
+        };
+
+        struct NameRecord
+        {
+            NameID m_Name;
+            uint m_Offset; // into the string section
+            uint m_Length;
+        };
+
+        struct NodeRecord
+        {
+            NameID m_Name;
+            NameID m_LongName;
+            uint m_FirstChild; // into the children section
+            uint m_ChildCount;
+        };
+
+        struct TransformRecord
+        {
+            NameID m_Entity;
+            glm::vec3 m_Scale;
+            glm::vec3 m_Rotation;
+            glm::vec3 m_Translation;
+            uint m_Padding;
+        };
+
+        struct PointLightRecord
+        {
+            NameID m_Entity;
+            float m_LightIntensity;
+            float m_Radius;
+            glm::vec3 m_Color;
+            uint m_Padding;
+        };
+
+        struct DirectionalLightRecord
+        {
+            NameID m_Entity;
+            float m_LightIntensity;
+            glm::vec3 m_Color;
+            glm::vec3 m_Direction;
+            uint m_Padding;
+        };
+
+        struct InstanceRecord
+        {
+            NameID m_Entity;
+            uint m_FirstInstance; // into the instance entity section
+            uint m_InstanceCount;
+        };
+
+        struct ScriptRecord
+        {
+            NameID m_Entity;
+            NameID m_Filepath;
+        };
+
+        // NameID of an instance entity
+        using InstanceEntityRecord = NameID;
+
+        template <typename Record> void AddSection(std::vector<SectionHeader>& sections, SectionType type,
+                                                   std::vector<Record> const& records)
+        {
+            static_assert(std::is_trivially_copyable_v<Record>, "snapshot records are copied in bulk");
+            sections.push_back({type, static_cast<uint>(sizeof(Record)), records.size(), 0});
+        }
+
+        constexpr uint64 Align(uint64 offset) { return (offset + 7) & ~uint64(7); }
+
+        class SnapshotReader
+        {
+        public:
+            SnapshotReader(MappedFile const& file) : m_File{file} {}
+
+            bool Validate()
+            {
+                if (m_File.Size() < sizeof(FileHeader))
+                {
+                    return false;
+                }
+                auto header = reinterpret_cast<const FileHeader*>(m_File.Data());
+                if ((header->m_Magic != SceneSnapshot::MAGIC) || (header->m_Version != SceneSnapshot::VERSION) ||
+                    (header->m_SectionCount != NUMBER_OF_SECTIONS))
+                {
+                    return false;
+                }
+                uint64 sectionTableEnd = sizeof(FileHeader) + NUMBER_OF_SECTIONS * sizeof(SectionHeader);
+                if (m_File.Size() < sectionTableEnd)
+                {
+                    return false;
+                }
+                m_Sections = reinterpret_cast<const SectionHeader*>(m_File.Data() + sizeof(FileHeader));
+                for (uint index = 0; index < NUMBER_OF_SECTIONS; ++index)
+                {
+                    SectionHeader const& section = m_Sections[index];
+                    if ((section.m_Type != index) || (section.m_Offset % 8) || (section.m_Offset < sectionTableEnd) ||
+                        (section.m_Offset > m_File.Size()) || (section.m_RecordSize == 0))
+                    {
+                        return false;
+                    }
+                    // checked before multiplying, a crafted count must not overflow the section size
+                    uint64 remaining = m_File.Size() - section.m_Offset;
+                    if (section.m_Count > remaining / section.m_RecordSize)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            template <typename Record> std::span<const Record> Get(SectionType type) const
+            {
+                SectionHeader const& section = m_Sections[type];
+                if (section.m_RecordSize != sizeof(Record))
+                {
+                    return {};
+                }
+                auto records = reinterpret_cast<const Record*>(m_File.Data() + section.m_Offset);
+                return std::span<const Record>(records, static_cast<size_t>(section.m_Count));
+            }
+
+        private:
+            MappedFile const& m_File;
+            const SectionHeader* m_Sections{nullptr};
+        };
+    } // namespace
+
+    bool SceneSnapshot::Write(Scene& scene, std::vector<AssetReference> const& assets, std::string const& filename)
+    {
+        ZoneScopedN("SceneSnapshot::Write");
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        Registry& registry = scene.GetRegistry();
+        SceneGraph& sceneGraph = scene.GetSceneGraph();
+
+        std::unordered_set<NameID, NameIDHash> usedNames;
+        auto useName = [&usedNames](NameID name)
+        {
+            usedNames.insert(name);
+            return name;
+        };
+
+        // flattened scene graph, its long names identify entities in all other sections
+        std::vector<NodeRecord> nodes;
+        std::vector<uint> children;
+        std::unordered_map<entt::entity, NameID> entityNames;
+        size_t nodeCount = sceneGraph.Size();
+        nodes.reserve(nodeCount);
+        for (uint nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex)
+        {
+            TreeNode& node = sceneGraph.GetNode(nodeIndex);
+            NodeRecord record{};
+            record.m_Name = useName(node.GetNameID());
+            record.m_LongName = useName(node.GetLongNameID());
+            record.m_FirstChild = static_cast<uint>(children.size());
+            record.m_ChildCount = node.Children();
+            auto& nodeChildren = node.GetChildren();
+            children.insert(children.end(), nodeChildren.begin(), nodeChildren.end());
+            nodes.push_back(record);
+            entityNames[node.GetGameObject()] = record.m_LongName;
+        }
+        auto getEntityName = [&entityNames](entt::entity entity)
+        {
+            auto iterator = entityNames.find(entity);
+            return (iterator != entityNames.end()) ? iterator->second : NAME_ID_INVALID;
+        };
+
+        std::vector<TransformRecord> transforms;
+        {
+            auto view = registry.view<TransformComponent>();
+            for (auto entity : view)
+            {
+                NameID name = getEntityName(entity);
+                if (name == NAME_ID_INVALID)
+                {
+                    continue;
+                }
+                auto& transform = view.get<TransformComponent>(entity);
+                TransformRecord record{};
+                record.m_Entity = name;
+                record.m_Scale = transform.GetScale();
+                record.m_Rotation = transform.GetRotation();
+                record.m_Translation = transform.GetTranslation();
+                transforms.push_back(record);
+            }
+        }
+
+        std::vector<PointLightRecord> pointLights;
+        {
+            auto view = registry.view<PointLightComponent>();
+            for (auto entity : view)
+            {
+                NameID name = getEntityName(entity);
+                if (name == NAME_ID_INVALID)
+                {
+                    continue;
+                }
+                auto& pointLight = view.get<PointLightComponent>(entity);
+                PointLightRecord record{};
+                record.m_Entity = name;
+                record.m_LightIntensity = pointLight.m_LightIntensity;
+                record.m_Radius = pointLight.m_Radius;
+                record.m_Color = pointLight.m_Color;
+                pointLights.push_back(record);
+            }
+        }
+
+        std::vector<DirectionalLightRecord> directionalLights;
+        {
+            auto view = registry.view<DirectionalLightComponent>();
+            for (auto entity : view)
+            {
+                NameID name = getEntityName(entity);
+                if (name == NAME_ID_INVALID)
+                {
+                    continue;
+                }
+                auto& directionalLight = view.get<DirectionalLightComponent>(entity);
+                DirectionalLightRecord record{};
+                record.m_Entity = name;
+                record.m_LightIntensity = directionalLight.m_LightIntensity;
+                record.m_Color = directionalLight.m_Color;
+                record.m_Direction = directionalLight.m_Direction;
+                directionalLights.push_back(record);
+            }
+        }
+
+        std::vector<InstanceRecord> instances;
+        std::vector<InstanceEntityRecord> instanceEntities;
+        {
+            auto view = registry.view<InstanceTag>();
+            for (auto entity : view)
+            {
+                NameID name = getEntityName(entity);
+                if (name == NAME_ID_INVALID)
+                {
+                    continue;
+                }
+                auto& instanceTag = view.get<InstanceTag>(entity);
+                InstanceRecord record{};
+                record.m_Entity = name;
+                record.m_FirstInstance = static_cast<uint>(instanceEntities.size());
+                record.m_InstanceCount = static_cast<uint>(instanceTag.m_Instances.size());
+                for (auto instance : instanceTag.m_Instances)
+                {
+                    instanceEntities.push_back(getEntityName(instance));
+                }
+                instances.push_back(record);
+            }
+        }
+
+        std::vector<ScriptRecord> scripts;
+        {
+            auto view = registry.view<ScriptComponent>();
+            for (auto entity : view)
+            {
+                NameID name = getEntityName(entity);
+                if (name == NAME_ID_INVALID)
+                {
+                    continue;
+                }
+                auto& scriptComponent = view.get<ScriptComponent>(entity);
+                scripts.push_back({name, useName(NameTable::Intern(scriptComponent.m_Filepath))});
+            }
+        }
+
+        // strings of all names, so a snapshot can be restored before the names were interned;
+        // sorted by ID, the iteration order of the set is not stable between runs
+        std::vector<NameID> sortedNames(usedNames.begin(), usedNames.end());
+        std::sort(sortedNames.begin(), sortedNames.end());
+        std::vector<NameRecord> names;
+        std::vector<char> strings;
+        names.reserve(sortedNames.size());
+        for (NameID name : sortedNames)
+        {
+            std::string const& string = NameTable::GetString(name);
+            names.push_back({name, static_cast<uint>(strings.size()), static_cast<uint>(string.size())});
+            strings.insert(strings.end(), string.begin(), string.end());
+        }
+
+        std::vector<SectionHeader> sections;
+        AddSection(sections, SECTION_NAMES, names);
+        AddSection(sections, SECTION_STRINGS, strings);
+        AddSection(sections, SECTION_ASSETS, assets);
+        AddSection(sections, SECTION_NODES, nodes);
+        AddSection(sections, SECTION_CHILDREN, children);
+        AddSection(sections, SECTION_TRANSFORMS, transforms);
+        AddSection(sections, SECTION_POINT_LIGHTS, pointLights);
+        AddSection(sections, SECTION_DIRECTIONAL_LIGHTS, directionalLights);
+        AddSection(sections, SECTION_INSTANCES, instances);
+        AddSection(sections, SECTION_INSTANCE_ENTITIES, instanceEntities);
+        AddSection(sections, SECTION_SCRIPTS, scripts);
+        CORE_ASSERT(sections.size() == NUMBER_OF_SECTIONS, "SceneSnapshot::Write: section missing");
+
+        uint64 offset = sizeof(FileHeader) + sections.size() * sizeof(SectionHeader);
+        for (auto& section : sections)
+        {
+            offset = Align(offset);
+            section.m_Offset = offset;
+            offset += section.m_Count * section.m_RecordSize;
+        }
+
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            LOG_CORE_ERROR("SceneSnapshot::Write: could not open {0}", filename);
+            return false;
+        }
+        FileHeader header{MAGIC, VERSION, static_cast<uint>(sections.size()), 0};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+        file.write(reinterpret_cast<const char*>(sections.data()), sections.size() * sizeof(SectionHeader));
+
+        uint64 position = sizeof(FileHeader) + sections.size() * sizeof(SectionHeader);
+        auto writeSection = [&](SectionHeader const& section, const void* data)
+        {
+            static constexpr char zeros[8]{};
+            file.write(zeros, section.m_Offset - position);
+            uint64 size = section.m_Count * section.m_RecordSize;
+            if (size)
+            {
+                file.write(static_cast<const char*>(data), size);
+            }
+            position = section.m_Offset + size;
+        };
+        writeSection(sections[SECTION_NAMES], names.data());
+        writeSection(sections[SECTION_STRINGS], strings.data());
+        writeSection(sections[SECTION_ASSETS], assets.data());
+        writeSection(sections[SECTION_NODES], nodes.data());
+        writeSection(sections[SECTION_CHILDREN], children.data());
+        writeSection(sections[SECTION_TRANSFORMS], transforms.data());
+        writeSection(sections[SECTION_POINT_LIGHTS], pointLights.data());
+        writeSection(sections[SECTION_DIRECTIONAL_LIGHTS], directionalLights.data());
+        writeSection(sections[SECTION_INSTANCES], instances.data());
+        writeSection(sections[SECTION_INSTANCE_ENTITIES], instanceEntities.data());
+        writeSection(sections[SECTION_SCRIPTS], scripts.data());
+        if (!file)
+        {
+            LOG_CORE_ERROR("SceneSnapshot::Write: could not write {0}", filename);
+            return false;
+        }
+
+        std::chrono::duration<float, std::milli> duration = std::chrono::high_resolution_clock::now() - startTime;
+        LOG_CORE_INFO("SceneSnapshot: wrote {0} ({1} nodes, {2} bytes) in {3:.2f} ms", filename, nodes.size(), position,
+                      duration.count());
+        return true;
+    }
+
+    bool SceneSnapshot::Restore(Scene& scene, std::vector<AssetReference> const& assets, std::string const& filename)
+    {
+        ZoneScopedN("SceneSnapshot::Restore");
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        MappedFile file;
+        if (!file.Open(filename))
+        {
+            return false;
+        }
+        SnapshotReader reader(file);
+        if (!reader.Validate())
+        {
+            LOG_CORE_WARN("SceneSnapshot::Restore: {0} is not a valid snapshot (version {1})", filename, VERSION);
+            return false;
+        }
+
+        // a snapshot of another asset set would put transforms on the wrong objects
+        auto snapshotAssets = reader.Get<AssetReference>(SECTION_ASSETS);
+        if (!std::equal(snapshotAssets.begin(), snapshotAssets.end(), assets.begin(), assets.end()))
+        {
+            LOG_CORE_INFO("SceneSnapshot::Restore: {0} is out of date, the scene references other assets", filename);
+            return false;
+        }
+
+        auto names = reader.Get<NameRecord>(SECTION_NAMES);
+        auto strings = reader.Get<char>(SECTION_STRINGS);
+        for (auto const& name : names)
+        {
+            if ((static_cast<uint64>(name.m_Offset) + name.m_Length > strings.size()) ||
+                (NameTable::Intern(std::string_view(strings.data() + name.m_Offset, name.m_Length)) != name.m_Name))
+            {
+                LOG_CORE_WARN("SceneSnapshot::Restore: {0} has a broken name table", filename);
+                return false;
+            }
+        }
+
+        Registry& registry = scene.GetRegistry();
+        Dictionary& dictionary = scene.GetDictionary();
+        uint unresolved = 0;
+        auto resolve = [&dictionary, &unresolved](NameID name)
+        {
+            entt::entity entity = dictionary.Retrieve(name);
+            if (entity == entt::null)
+            {
+                ++unresolved;
+            }
+            return entity;
+        };
+
+        // instance layouts are created by the model builders, they are checked, not changed
+        auto instances = reader.Get<InstanceRecord>(SECTION_INSTANCES);
+        auto instanceEntities = reader.Get<InstanceEntityRecord>(SECTION_INSTANCE_ENTITIES);
+        for (auto const& record : instances)
+        {
+            entt::entity entity = dictionary.Retrieve(record.m_Entity);
+            if ((entity == entt::null) || !registry.all_of<InstanceTag>(entity))
+            {
+                continue;
+            }
+            auto& instanceTag = registry.get<InstanceTag>(entity);
+            bool layoutMatches = (record.m_InstanceCount == instanceTag.m_Instances.size()) &&
+                                 (static_cast<uint64>(record.m_FirstInstance) + record.m_InstanceCount <=
+                                  instanceEntities.size());
+            for (uint index = 0; layoutMatches && (index < record.m_InstanceCount); ++index)
+            {
+                layoutMatches = (dictionary.Retrieve(instanceEntities[record.m_FirstInstance + index]) ==
+                                 instanceTag.m_Instances[index]);
+            }
+            if (!layoutMatches)
+            {
+                LOG_CORE_INFO("SceneSnapshot::Restore: {0} is out of date, instance layout of {1} changed", filename,
+                              NameTable::GetString(record.m_Entity));
+                return false;
+            }
+        }
+
+        for (auto const& record : reader.Get<TransformRecord>(SECTION_TRANSFORMS))
+        {
+            entt::entity entity = resolve(record.m_Entity);
+            if ((entity != entt::null) && registry.all_of<TransformComponent>(entity))
+            {
+                auto& transform = registry.get<TransformComponent>(entity);
+                transform.SetScale(record.m_Scale);
+                transform.SetRotation(record.m_Rotation);
+                transform.SetTranslation(record.m_Translation);
+            }
+        }
+
+        for (auto const& record : reader.Get<PointLightRecord>(SECTION_POINT_LIGHTS))
+        {
+            entt::entity entity = resolve(record.m_Entity);
+            if ((entity != entt::null) && registry.all_of<PointLightComponent>(entity))
+            {
+                auto& pointLight = registry.get<PointLightComponent>(entity);
+                pointLight.m_LightIntensity = record.m_LightIntensity;
+                pointLight.m_Radius = record.m_Radius;
+                pointLight.m_Color = record.m_Color;
+            }
+        }
+
+        for (auto const& record : reader.Get<DirectionalLightRecord>(SECTION_DIRECTIONAL_LIGHTS))
+        {
+            entt::entity entity = resolve(record.m_Entity);
+            if ((entity != entt::null) && registry.all_of<DirectionalLightComponent>(entity))
+            {
+                auto& directionalLight = registry.get<DirectionalLightComponent>(entity);
+                directionalLight.m_LightIntensity = record.m_LightIntensity;
+                directionalLight.m_Color = record.m_Color;
+                directionalLight.m_Direction = record.m_Direction;
+            }
+        }
+
+        for (auto const& record : reader.Get<ScriptRecord>(SECTION_SCRIPTS))
+        {
+            entt::entity entity = resolve(record.m_Entity);
+            if ((entity != entt::null) && !registry.all_of<ScriptComponent>(entity))
+            {
+                ScriptComponent scriptComponent(NameTable::GetString(record.m_Filepath));
+                registry.emplace<ScriptComponent>(entity, scriptComponent);
+            }
+        }
+
+        std::chrono::duration<float, std::milli> duration = std::chrono::high_resolution_clock::now() - startTime;
+        LOG_CORE_INFO("SceneSnapshot: restored {0} in {1:.2f} ms (snapshot nodes: {2}, scene nodes: {3}, unresolved: {4})",
+                      filename, duration.count(), reader.Get<NodeRecord>(SECTION_NODES).size(),
+                      scene.GetSceneGraph().Size(), unresolved);
+        return true;
+    }
+} // namespace GfxRenderEngine
@@ -0,0 +1,72 @@
+/* Engine Copyright (c) 2024 Engine Development Team
+   https://github.com/beaumanvienna/vulkan
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "engine.h"
+#include "auxiliary/nameTable.h"
+
+namespace GfxRenderEngine
+{
+    class Scene;
+
+    // Binary snapshot of the editable state of a loaded scene:
+    // transforms, lights, instance layouts, script references, and the
+    // flattened scene graph with its dictionary names. Each section is an
+    // array of fixed-size records, written in bulk and read back from a
+    // memory-mapped file. Entities are referenced by the interned long
+    // names of their scene graph nodes, so snapshots survive the entity
+    // IDs changing between loads. Models are not stored, assets are
+    // referenced by the IDs of their file names and must match the scene.
+    class SceneSnapshot
+    {
+    public:
+        static constexpr uint MAGIC = 0x504e534c; // "LSNP"
+        static constexpr uint VERSION = 1;
+
+        enum AssetType : uint
+        {
+            ASSET_GLTF = 0,
+            ASSET_FASTGLTF,
+            ASSET_FBX,
+            ASSET_UFBX,
+            ASSET_TERRAIN
+        };
+
+        struct AssetReference
+        {
+            NameID m_Filename{NAME_ID_INVALID};
+            uint m_InstanceCount{0};
+            uint m_Type{ASSET_GLTF};
+
+            bool operator==(AssetReference const& other) const = default;
+        };
+
+    public:
+        static bool Write(Scene& scene, std::vector<AssetReference> const& assets, std::string const& filename);
+        // returns false if the file is missing, broken, of another version, or references other assets
+        static bool Restore(Scene& scene, std::vector<AssetReference> const& assets, std::string const& filename);
+    };
+} // namespace GfxRenderEngine
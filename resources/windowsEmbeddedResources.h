@@ -14,7 +14,6 @@
 #define IDR_SHADER_DR_FRAG                  113
 #define IDR_SHADER_NM_VERT                  114
 #define IDR_SHADER_NM_FRAG                  115
-#define IDR_SHADER_D_VERT                   116
 #define IDR_SHADER_SP2D_VERT                117
 #define IDR_SHADER_SP2D_FRAG                118
 #define IDR_SHADER_GUIS_VERT                119
@@ -27,8 +26,6 @@
 #define IDR_SHADER_SB_FRAG                  126
 #define IDR_SHADER_SHADOW_VERT              127
 #define IDR_SHADER_SHADOW_FRAG              128
-#define IDR_SHADER_SHADSA_VERT              129
-#define IDR_SHADER_SHADSA_FRAG              130
 #define IDR_SHADER_DEBUG_VERT               131
 #define IDR_SHADER_DEBUG_FRAG              132
 